@@ -34,11 +34,19 @@
 #include "core/io/image_loader.h"
 #include "core/io/resource_loader.h"
 #include "core/math/math_funcs.h"
+#include "core/os/os.h"
 #include "core/string/print_string.h"
 #include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/thread_work_pool.h"
 
 #include <stdio.h>
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define IMAGE_USE_SSE2
+#include <emmintrin.h>
+#endif
+
 const char *Image::format_names[Image::FORMAT_MAX] = {
 	"Lum8", //luminance
 	"LumAlpha8", //luminance-alpha
@@ -461,15 +469,159 @@ int Image::get_mipmap_count() const {
 	}
 }
 
+// Large images are split in bands of rows which are processed on a shared worker pool.
+// Kernels only write to the rows of their own band, so results are the same as when
+// processing the whole image on the calling thread.
+
+#define IMAGE_THREADING_MIN_PIXELS (512 * 512)
+#define IMAGE_THREADING_BAND_ROWS 32
+
+bool Image::threaded_processing = true;
+
+static ThreadWorkPool *image_work_pool = nullptr;
+static BinaryMutex image_work_pool_mutex;
+
+typedef void (*ImageRowsFunc)(const void *p_userdata, uint32_t p_from, uint32_t p_to);
+
+struct ImageRowsWork {
+	ImageRowsFunc func = nullptr;
+	const void *userdata = nullptr;
+	uint32_t count = 0;
+	uint32_t band = 0;
+
+	void process_band(uint32_t p_band, void *p_unused) {
+		uint32_t from = p_band * band;
+		func(userdata, from, MIN(from + band, count));
+	}
+};
+
+static void _process_bands(uint32_t p_count, uint32_t p_band, bool p_threaded, ImageRowsFunc p_func, const void *p_userdata) {
+#ifndef NO_THREADS
+	if (p_threaded && OS::get_singleton() && OS::get_singleton()->get_processor_count() > 1) {
+		// The pool runs one job at a time, images processed concurrently from other threads use the serial path.
+		if (image_work_pool_mutex.try_lock() == OK) {
+			if (!image_work_pool) {
+				image_work_pool = memnew(ThreadWorkPool);
+				image_work_pool->init();
+			}
+
+			ImageRowsWork work;
+			work.func = p_func;
+			work.userdata = p_userdata;
+			work.count = p_count;
+			work.band = p_band;
+			image_work_pool->do_work((p_count + p_band - 1) / p_band, &work, &ImageRowsWork::process_band, nullptr);
+
+			image_work_pool_mutex.unlock();
+			return;
+		}
+	}
+#endif
+	p_func(p_userdata, 0, p_count);
+}
+
+static void _process_rows(uint32_t p_rows, uint64_t p_pixels, ImageRowsFunc p_func, const void *p_userdata) {
+	bool threaded = Image::is_threaded_processing_enabled() && p_pixels >= IMAGE_THREADING_MIN_PIXELS && p_rows >= IMAGE_THREADING_BAND_ROWS * 2;
+	_process_bands(p_rows, IMAGE_THREADING_BAND_ROWS, threaded, p_func, p_userdata);
+}
+
+void Image::set_threaded_processing_enabled(bool p_enabled) {
+	threaded_processing = p_enabled;
+}
+
+bool Image::is_threaded_processing_enabled() {
+	return threaded_processing;
+}
+
+void Image::finish_work_pool() {
+	MutexLock lock(image_work_pool_mutex);
+	if (image_work_pool) {
+		image_work_pool->finish();
+		memdelete(image_work_pool);
+		image_work_pool = nullptr;
+	}
+}
+
+// Block compression jobs. Every mipmap level is split in strips of block rows and all
+// strips are queued at once, so the small levels don't serialize the end of the work.
+
+#define IMAGE_BLOCK_JOB_PIXELS (128 * 128)
+#define IMAGE_BLOCK_THREADING_MIN_PIXELS (128 * 128)
+
+struct ImageBlockJobsParams {
+	const Image::BlockJob *jobs = nullptr;
+	Image::BlockJobFunc func = nullptr;
+	const void *userdata = nullptr;
+};
+
+static void _process_block_jobs(const void *p_params, uint32_t p_from, uint32_t p_to) {
+	const ImageBlockJobsParams *params = (const ImageBlockJobsParams *)p_params;
+	for (uint32_t i = p_from; i < p_to; i++) {
+		params->func(params->jobs[i], params->userdata);
+	}
+}
+
+void Image::process_block_jobs(const uint8_t *p_src, Format p_src_format, uint8_t *p_dst, Format p_dst_format, int p_width, int p_height, bool p_mipmaps, BlockJobFunc p_func, const void *p_userdata) {
+	ERR_FAIL_COND(!p_func);
+	ERR_FAIL_COND(p_width <= 0 || p_height <= 0);
+
+	uint64_t start_time = OS::get_singleton()->get_ticks_usec();
+
+	Format block_format = p_src_format > FORMAT_RGBE9995 ? p_src_format : p_dst_format;
+	int mm_count = p_mipmaps ? get_image_required_mipmaps(p_width, p_height, block_format) : 0;
+
+	LocalVector<BlockJob> jobs;
+	uint64_t pixels = 0;
+
+	for (int i = 0; i <= mm_count; i++) {
+		BlockJob job;
+		job.src = p_src + get_image_mipmap_offset(p_width, p_height, p_src_format, i);
+		job.dst = p_dst + get_image_mipmap_offset(p_width, p_height, p_dst_format, i);
+		job.mipmap = i;
+		job.width = MAX(p_width >> i, 1);
+		job.height = MAX(p_height >> i, 1);
+
+		int strip_rows = MAX(4, (IMAGE_BLOCK_JOB_PIXELS / job.width + 3) & ~3);
+		for (int y = 0; y < job.height; y += strip_rows) {
+			job.y_start = y;
+			job.y_end = MIN(y + strip_rows, job.height);
+			jobs.push_back(job);
+		}
+
+		pixels += job.width * job.height;
+	}
+
+	ImageBlockJobsParams params;
+	params.jobs = jobs.ptr();
+	params.func = p_func;
+	params.userdata = p_userdata;
+	bool threaded = threaded_processing && pixels >= IMAGE_BLOCK_THREADING_MIN_PIXELS && jobs.size() > 1;
+	_process_bands(jobs.size(), 1, threaded, _process_block_jobs, &params);
+
+	double usec = MAX(OS::get_singleton()->get_ticks_usec() - start_time, (uint64_t)1);
+	print_verbose(vformat("Image: %s to %s, %s megapixels in %s ms (%s MP/s).", get_format_name(p_src_format), get_format_name(p_dst_format), rtos(pixels / 1000000.0), rtos(usec / 1000.0), rtos(pixels / usec)));
+}
+
+struct ImageConvertParams {
+	int width = 0;
+	const uint8_t *src = nullptr;
+	uint8_t *dst = nullptr;
+};
+
 //using template generates perfectly optimized code due to constant expression reduction and unused variable removal present in all compilers
 template <uint32_t read_bytes, bool read_alpha, uint32_t write_bytes, bool write_alpha, bool read_gray, bool write_gray>
-static void _convert(int p_width, int p_height, const uint8_t *p_src, uint8_t *p_dst) {
+static void _convert_rows(const void *p_params, uint32_t p_from, uint32_t p_to) {
+	const ImageConvertParams *params = (const ImageConvertParams *)p_params;
+	int width = params->width;
+	const uint8_t *src = params->src;
+	uint8_t *dst = params->dst;
+
 	uint32_t max_bytes = MAX(read_bytes, write_bytes);
 
-	for (int y = 0; y < p_height; y++) {
-		for (int x = 0; x < p_width; x++) {
-			const uint8_t *rofs = &p_src[((y * p_width) + x) * (read_bytes + (read_alpha ? 1 : 0))];
-			uint8_t *wofs = &p_dst[((y * p_width) + x) * (write_bytes + (write_alpha ? 1 : 0))];
+	for (int y = p_from; y < (int)p_to; y++) {
+		for (int x = 0; x < width; x++) {
+			const uint8_t *rofs = &src[((y * width) + x) * (read_bytes + (read_alpha ? 1 : 0))];
+			uint8_t *wofs = &dst[((y * width) + x) * (write_bytes + (write_alpha ? 1 : 0))];
 
 			uint8_t rgba[4];
 
@@ -503,6 +655,34 @@ static void _convert(int p_width, int p_height, const uint8_t *p_src, uint8_t *p
 	}
 }
 
+template <uint32_t read_bytes, bool read_alpha, uint32_t write_bytes, bool write_alpha, bool read_gray, bool write_gray>
+static void _convert(int p_width, int p_height, const uint8_t *p_src, uint8_t *p_dst) {
+	ImageConvertParams params;
+	params.width = p_width;
+	params.src = p_src;
+	params.dst = p_dst;
+	_process_rows(p_height, uint64_t(p_width) * p_height, _convert_rows<read_bytes, read_alpha, write_bytes, write_alpha, read_gray, write_gray>, &params);
+}
+
+struct ImageConvertColorsParams {
+	const Image *src_image = nullptr;
+	Image *dst_image = nullptr;
+	const uint8_t *src = nullptr;
+	uint8_t *dst = nullptr;
+	int width = 0;
+};
+
+void Image::_convert_colors_rows(const void *p_params, uint32_t p_from, uint32_t p_to) {
+	const ImageConvertColorsParams *params = (const ImageConvertColorsParams *)p_params;
+
+	for (uint32_t j = p_from; j < p_to; j++) {
+		for (int i = 0; i < params->width; i++) {
+			uint32_t ofs = j * params->width + i;
+			params->dst_image->_set_color_at_ofs(params->dst, ofs, params->src_image->_get_color_at_ofs(params->src, ofs));
+		}
+	}
+}
+
 void Image::convert(Format p_new_format) {
 	if (data.size() == 0) {
 		return;
@@ -519,11 +699,13 @@ void Image::convert(Format p_new_format) {
 		//use put/set pixel which is slower but works with non byte formats
 		Image new_img(width, height, false, p_new_format);
 
-		for (int i = 0; i < width; i++) {
-			for (int j = 0; j < height; j++) {
-				new_img.set_pixel(i, j, get_pixel(i, j));
-			}
-		}
+		ImageConvertColorsParams params;
+		params.src_image = this;
+		params.dst_image = &new_img;
+		params.src = data.ptr();
+		params.dst = new_img.data.ptrw();
+		params.width = width;
+		_process_rows(height, uint64_t(width) * height, _convert_colors_rows, &params);
 
 		if (has_mipmaps()) {
 			new_img.generate_mipmaps();
@@ -662,7 +844,7 @@ static double _bicubic_interp_kernel(double x) {
 }
 
 template <int CC, class T>
-static void _scale_cubic(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height) {
+static void _scale_cubic(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height, uint32_t p_from_row, uint32_t p_to_row) {
 	// get source image size
 	int width = p_src_width;
 	int height = p_src_height;
@@ -677,7 +859,7 @@ static void _scale_cubic(const uint8_t *__restrict p_src, uint8_t *__restrict p_
 	int xmax = width - 1;
 	// temporary pointer
 
-	for (uint32_t y = 0; y < p_dst_height; y++) {
+	for (uint32_t y = p_from_row; y < p_to_row; y++) {
 		// Y coordinates
 		oy = (double)y * yfac - 0.5f;
 		oy1 = (int)oy;
@@ -749,7 +931,7 @@ static void _scale_cubic(const uint8_t *__restrict p_src, uint8_t *__restrict p_
 }
 
 template <int CC, class T>
-static void _scale_bilinear(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height) {
+static void _scale_bilinear(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height, uint32_t p_from_row, uint32_t p_to_row) {
 	enum {
 		FRAC_BITS = 8,
 		FRAC_LEN = (1 << FRAC_BITS),
@@ -757,7 +939,7 @@ static void _scale_bilinear(const uint8_t *__restrict p_src, uint8_t *__restrict
 		FRAC_MASK = FRAC_LEN - 1
 	};
 
-	for (uint32_t i = 0; i < p_dst_height; i++) {
+	for (uint32_t i = p_from_row; i < p_to_row; i++) {
 		// Add 0.5 in order to interpolate based on pixel center
 		uint32_t src_yofs_up_fp = (i + 0.5) * p_src_height * FRAC_LEN / p_dst_height;
 		// Calculate nearest src pixel center above current, and truncate to get y index
@@ -839,8 +1021,8 @@ static void _scale_bilinear(const uint8_t *__restrict p_src, uint8_t *__restrict
 }
 
 template <int CC, class T>
-static void _scale_nearest(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height) {
-	for (uint32_t i = 0; i < p_dst_height; i++) {
+static void _scale_nearest(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height, uint32_t p_from_row, uint32_t p_to_row) {
+	for (uint32_t i = p_from_row; i < p_to_row; i++) {
 		uint32_t src_yofs = i * p_src_height / p_dst_height;
 		uint32_t y_ofs = src_yofs * p_src_width * CC;
 
@@ -859,125 +1041,186 @@ static void _scale_nearest(const uint8_t *__restrict p_src, uint8_t *__restrict
 	}
 }
 
+struct ImageScaleParams {
+	const uint8_t *src = nullptr;
+	uint8_t *dst = nullptr;
+	uint32_t src_width = 0;
+	uint32_t src_height = 0;
+	uint32_t dst_width = 0;
+	uint32_t dst_height = 0;
+};
+
+typedef void (*ImageScaleFunc)(const uint8_t *p_src, uint8_t *p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height, uint32_t p_from_row, uint32_t p_to_row);
+
+template <ImageScaleFunc scale_func>
+static void _scale_rows(const void *p_params, uint32_t p_from, uint32_t p_to) {
+	const ImageScaleParams *params = (const ImageScaleParams *)p_params;
+	scale_func(params->src, params->dst, params->src_width, params->src_height, params->dst_width, params->dst_height, p_from, p_to);
+}
+
+template <ImageScaleFunc scale_func>
+static void _scale_threaded(const uint8_t *p_src, uint8_t *p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height) {
+	ImageScaleParams params;
+	params.src = p_src;
+	params.dst = p_dst;
+	params.src_width = p_src_width;
+	params.src_height = p_src_height;
+	params.dst_width = p_dst_width;
+	params.dst_height = p_dst_height;
+	_process_rows(p_dst_height, uint64_t(p_dst_width) * p_dst_height, _scale_rows<scale_func>, &params);
+}
+
 #define LANCZOS_TYPE 3
 
 static float _lanczos(float p_x) {
 	return Math::abs(p_x) >= LANCZOS_TYPE ? 0 : Math::sincn(p_x) * Math::sincn(p_x / LANCZOS_TYPE);
 }
 
+struct ImageLanczosParams {
+	const uint8_t *src = nullptr;
+	uint8_t *dst = nullptr;
+	float *buffer = nullptr;
+	int32_t src_width = 0;
+	int32_t src_height = 0;
+	int32_t dst_width = 0;
+	int32_t dst_height = 0;
+};
+
 template <int CC, class T>
-static void _scale_lanczos(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height) {
-	int32_t src_width = p_src_width;
-	int32_t src_height = p_src_height;
-	int32_t dst_height = p_dst_height;
-	int32_t dst_width = p_dst_width;
+static void _scale_lanczos_horizontal(const void *p_params, uint32_t p_from, uint32_t p_to) {
+	const ImageLanczosParams *params = (const ImageLanczosParams *)p_params;
+	const uint8_t *__restrict src = params->src;
+	float *buffer = params->buffer;
+	int32_t src_width = params->src_width;
+	int32_t src_height = params->src_height;
+	int32_t dst_width = params->dst_width;
 
-	uint32_t buffer_size = src_height * dst_width * CC;
-	float *buffer = memnew_arr(float, buffer_size); // Store the first pass in a buffer
+	float x_scale = float(src_width) / float(dst_width);
 
-	{ // FIRST PASS (horizontal)
+	float scale_factor = MAX(x_scale, 1); // A larger kernel is required only when downscaling
+	int32_t half_kernel = LANCZOS_TYPE * scale_factor;
 
-		float x_scale = float(src_width) / float(dst_width);
+	float *kernel = memnew_arr(float, half_kernel * 2);
 
-		float scale_factor = MAX(x_scale, 1); // A larger kernel is required only when downscaling
-		int32_t half_kernel = LANCZOS_TYPE * scale_factor;
+	for (int32_t buffer_x = p_from; buffer_x < (int32_t)p_to; buffer_x++) {
+		// The corresponding point on the source image
+		float src_x = (buffer_x + 0.5f) * x_scale; // Offset by 0.5 so it uses the pixel's center
+		int32_t start_x = MAX(0, int32_t(src_x) - half_kernel + 1);
+		int32_t end_x = MIN(src_width - 1, int32_t(src_x) + half_kernel);
 
-		float *kernel = memnew_arr(float, half_kernel * 2);
+		// Create the kernel used by all the pixels of the column
+		for (int32_t target_x = start_x; target_x <= end_x; target_x++) {
+			kernel[target_x - start_x] = _lanczos((target_x + 0.5f - src_x) / scale_factor);
+		}
 
-		for (int32_t buffer_x = 0; buffer_x < dst_width; buffer_x++) {
-			// The corresponding point on the source image
-			float src_x = (buffer_x + 0.5f) * x_scale; // Offset by 0.5 so it uses the pixel's center
-			int32_t start_x = MAX(0, int32_t(src_x) - half_kernel + 1);
-			int32_t end_x = MIN(src_width - 1, int32_t(src_x) + half_kernel);
+		for (int32_t buffer_y = 0; buffer_y < src_height; buffer_y++) {
+			float pixel[CC] = { 0 };
+			float weight = 0;
 
-			// Create the kernel used by all the pixels of the column
 			for (int32_t target_x = start_x; target_x <= end_x; target_x++) {
-				kernel[target_x - start_x] = _lanczos((target_x + 0.5f - src_x) / scale_factor);
-			}
-
-			for (int32_t buffer_y = 0; buffer_y < src_height; buffer_y++) {
-				float pixel[CC] = { 0 };
-				float weight = 0;
+				float lanczos_val = kernel[target_x - start_x];
+				weight += lanczos_val;
 
-				for (int32_t target_x = start_x; target_x <= end_x; target_x++) {
-					float lanczos_val = kernel[target_x - start_x];
-					weight += lanczos_val;
+				const T *__restrict src_data = ((const T *)src) + (buffer_y * src_width + target_x) * CC;
 
-					const T *__restrict src_data = ((const T *)p_src) + (buffer_y * src_width + target_x) * CC;
-
-					for (uint32_t i = 0; i < CC; i++) {
-						if (sizeof(T) == 2) { //half float
-							pixel[i] += Math::half_to_float(src_data[i]) * lanczos_val;
-						} else {
-							pixel[i] += src_data[i] * lanczos_val;
-						}
+				for (uint32_t i = 0; i < CC; i++) {
+					if (sizeof(T) == 2) { //half float
+						pixel[i] += Math::half_to_float(src_data[i]) * lanczos_val;
+					} else {
+						pixel[i] += src_data[i] * lanczos_val;
 					}
 				}
+			}
 
-				float *dst_data = ((float *)buffer) + (buffer_y * dst_width + buffer_x) * CC;
+			float *dst_data = ((float *)buffer) + (buffer_y * dst_width + buffer_x) * CC;
 
-				for (uint32_t i = 0; i < CC; i++) {
-					dst_data[i] = pixel[i] / weight; // Normalize the sum of all the samples
-				}
+			for (uint32_t i = 0; i < CC; i++) {
+				dst_data[i] = pixel[i] / weight; // Normalize the sum of all the samples
 			}
 		}
+	}
 
-		memdelete_arr(kernel);
-	} // End of first pass
+	memdelete_arr(kernel);
+}
 
-	{ // SECOND PASS (vertical + result)
+template <int CC, class T>
+static void _scale_lanczos_vertical(const void *p_params, uint32_t p_from, uint32_t p_to) {
+	const ImageLanczosParams *params = (const ImageLanczosParams *)p_params;
+	uint8_t *__restrict dst = params->dst;
+	const float *buffer = params->buffer;
+	int32_t src_height = params->src_height;
+	int32_t dst_width = params->dst_width;
+	int32_t dst_height = params->dst_height;
 
-		float y_scale = float(src_height) / float(dst_height);
+	float y_scale = float(src_height) / float(dst_height);
 
-		float scale_factor = MAX(y_scale, 1);
-		int32_t half_kernel = LANCZOS_TYPE * scale_factor;
+	float scale_factor = MAX(y_scale, 1);
+	int32_t half_kernel = LANCZOS_TYPE * scale_factor;
 
-		float *kernel = memnew_arr(float, half_kernel * 2);
+	float *kernel = memnew_arr(float, half_kernel * 2);
 
-		for (int32_t dst_y = 0; dst_y < dst_height; dst_y++) {
-			float buffer_y = (dst_y + 0.5f) * y_scale;
-			int32_t start_y = MAX(0, int32_t(buffer_y) - half_kernel + 1);
-			int32_t end_y = MIN(src_height - 1, int32_t(buffer_y) + half_kernel);
+	for (int32_t dst_y = p_from; dst_y < (int32_t)p_to; dst_y++) {
+		float buffer_y = (dst_y + 0.5f) * y_scale;
+		int32_t start_y = MAX(0, int32_t(buffer_y) - half_kernel + 1);
+		int32_t end_y = MIN(src_height - 1, int32_t(buffer_y) + half_kernel);
 
-			for (int32_t target_y = start_y; target_y <= end_y; target_y++) {
-				kernel[target_y - start_y] = _lanczos((target_y + 0.5f - buffer_y) / scale_factor);
-			}
+		for (int32_t target_y = start_y; target_y <= end_y; target_y++) {
+			kernel[target_y - start_y] = _lanczos((target_y + 0.5f - buffer_y) / scale_factor);
+		}
 
-			for (int32_t dst_x = 0; dst_x < dst_width; dst_x++) {
-				float pixel[CC] = { 0 };
-				float weight = 0;
+		for (int32_t dst_x = 0; dst_x < dst_width; dst_x++) {
+			float pixel[CC] = { 0 };
+			float weight = 0;
 
-				for (int32_t target_y = start_y; target_y <= end_y; target_y++) {
-					float lanczos_val = kernel[target_y - start_y];
-					weight += lanczos_val;
+			for (int32_t target_y = start_y; target_y <= end_y; target_y++) {
+				float lanczos_val = kernel[target_y - start_y];
+				weight += lanczos_val;
 
-					float *buffer_data = ((float *)buffer) + (target_y * dst_width + dst_x) * CC;
+				const float *buffer_data = buffer + (target_y * dst_width + dst_x) * CC;
 
-					for (uint32_t i = 0; i < CC; i++) {
-						pixel[i] += buffer_data[i] * lanczos_val;
-					}
+				for (uint32_t i = 0; i < CC; i++) {
+					pixel[i] += buffer_data[i] * lanczos_val;
 				}
+			}
 
-				T *dst_data = ((T *)p_dst) + (dst_y * dst_width + dst_x) * CC;
+			T *dst_data = ((T *)dst) + (dst_y * dst_width + dst_x) * CC;
 
-				for (uint32_t i = 0; i < CC; i++) {
-					pixel[i] /= weight;
-
-					if (sizeof(T) == 1) { //byte
-						dst_data[i] = CLAMP(Math::fast_ftoi(pixel[i]), 0, 255);
-					} else if (sizeof(T) == 2) { //half float
-						dst_data[i] = Math::make_half_float(pixel[i]);
-					} else { // float
-						dst_data[i] = pixel[i];
-					}
+			for (uint32_t i = 0; i < CC; i++) {
+				pixel[i] /= weight;
+
+				if (sizeof(T) == 1) { //byte
+					dst_data[i] = CLAMP(Math::fast_ftoi(pixel[i]), 0, 255);
+				} else if (sizeof(T) == 2) { //half float
+					dst_data[i] = Math::make_half_float(pixel[i]);
+				} else { // float
+					dst_data[i] = pixel[i];
 				}
 			}
 		}
+	}
 
-		memdelete_arr(kernel);
-	} // End of second pass
+	memdelete_arr(kernel);
+}
 
-	memdelete_arr(buffer);
+template <int CC, class T>
+static void _scale_lanczos(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, uint32_t p_src_width, uint32_t p_src_height, uint32_t p_dst_width, uint32_t p_dst_height) {
+	ImageLanczosParams params;
+	params.src = p_src;
+	params.dst = p_dst;
+	params.src_width = p_src_width;
+	params.src_height = p_src_height;
+	params.dst_width = p_dst_width;
+	params.dst_height = p_dst_height;
+
+	uint32_t buffer_size = p_src_height * p_dst_width * CC;
+	params.buffer = memnew_arr(float, buffer_size); // Store the first pass in a buffer
+
+	// First pass (horizontal), split by buffer columns.
+	_process_rows(p_dst_width, uint64_t(p_src_height) * p_dst_width, _scale_lanczos_horizontal<CC, T>, &params);
+	// Second pass (vertical + result), split by destination rows.
+	_process_rows(p_dst_height, uint64_t(p_dst_width) * p_dst_height, _scale_lanczos_vertical<CC, T>, &params);
+
+	memdelete_arr(params.buffer);
 }
 
 static void _overlay(const uint8_t *__restrict p_src, uint8_t *__restrict p_dst, float p_alpha, uint32_t p_width, uint32_t p_height, uint32_t p_pixel_size) {
@@ -1066,47 +1309,47 @@ void Image::resize(int p_width, int p_height, Interpolation p_interpolation) {
 			if (format >= FORMAT_L8 && format <= FORMAT_RGBA8) {
 				switch (get_format_pixel_size(format)) {
 					case 1:
-						_scale_nearest<1, uint8_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale_threaded<_scale_nearest<1, uint8_t>>(r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 2:
-						_scale_nearest<2, uint8_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale_threaded<_scale_nearest<2, uint8_t>>(r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 3:
-						_scale_nearest<3, uint8_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale_threaded<_scale_nearest<3, uint8_t>>(r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 4:
-						_scale_nearest<4, uint8_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale_threaded<_scale_nearest<4, uint8_t>>(r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 				}
 			} else if (format >= FORMAT_RF && format <= FORMAT_RGBAF) {
 				switch (get_format_pixel_size(format)) {
 					case 4:
-						_scale_nearest<1, float>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale_threaded<_scale_nearest<1, float>>(r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 8:
-						_scale_nearest<2, float>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale_threaded<_scale_nearest<2, float>>(r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 12:
-						_scale_nearest<3, float>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale_threaded<_scale_nearest<3, float>>(r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 16:
-						_scale_nearest<4, float>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale_threaded<_scale_nearest<4, float>>(r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 				}
 
 			} else if (format >= FORMAT_RH && format <= FORMAT_RGBAH) {
 				switch (get_format_pixel_size(format)) {
 					case 2:
-						_scale_nearest<1, uint16_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale_threaded<_scale_nearest<1, uint16_t>>(r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 4:
-						_scale_nearest<2, uint16_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale_threaded<_scale_nearest<2, uint16_t>>(r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 6:
-						_scale_nearest<3, uint16_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale_threaded<_scale_nearest<3, uint16_t>>(r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 8:
-						_scale_nearest<4, uint16_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale_threaded<_scale_nearest<4, uint16_t>>(r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 				}
 			}
@@ -1153,46 +1396,46 @@ void Image::resize(int p_width, int p_height, Interpolation p_interpolation) {
 				if (format >= FORMAT_L8 && format <= FORMAT_RGBA8) {
 					switch (get_format_pixel_size(format)) {
 						case 1:
-							_scale_bilinear<1, uint8_t>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
+							_scale_threaded<_scale_bilinear<1, uint8_t>>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
 							break;
 						case 2:
-							_scale_bilinear<2, uint8_t>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
+							_scale_threaded<_scale_bilinear<2, uint8_t>>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
 							break;
 						case 3:
-							_scale_bilinear<3, uint8_t>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
+							_scale_threaded<_scale_bilinear<3, uint8_t>>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
 							break;
 						case 4:
-							_scale_bilinear<4, uint8_t>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
+							_scale_threaded<_scale_bilinear<4, uint8_t>>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
 							break;
 					}
 				} else if (format >= FORMAT_RF && format <= FORMAT_RGBAF) {
 					switch (get_format_pixel_size(format)) {
 						case 4:
-							_scale_bilinear<1, float>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
+							_scale_threaded<_scale_bilinear<1, float>>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
 							break;
 						case 8:
-							_scale_bilinear<2, float>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
+							_scale_threaded<_scale_bilinear<2, float>>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
 							break;
 						case 12:
-							_scale_bilinear<3, float>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
+							_scale_threaded<_scale_bilinear<3, float>>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
 							break;
 						case 16:
-							_scale_bilinear<4, float>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
+							_scale_threaded<_scale_bilinear<4, float>>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
 							break;
 					}
 				} else if (format >= FORMAT_RH && format <= FORMAT_RGBAH) {
 					switch (get_format_pixel_size(format)) {
 						case 2:
-							_scale_bilinear<1, uint16_t>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
+							_scale_threaded<_scale_bilinear<1, uint16_t>>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
 							break;
 						case 4:
-							_scale_bilinear<2, uint16_t>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
+							_scale_threaded<_scale_bilinear<2, uint16_t>>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
 							break;
 						case 6:
-							_scale_bilinear<3, uint16_t>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
+							_scale_threaded<_scale_bilinear<3, uint16_t>>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
 							break;
 						case 8:
-							_scale_bilinear<4, uint16_t>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
+							_scale_threaded<_scale_bilinear<4, uint16_t>>(src_ptr, w_ptr, src_width, src_height, p_width, p_height);
 							break;
 					}
 				}
@@ -1209,46 +1452,46 @@ void Image::resize(int p_width, int p_height, Interpolation p_interpolation) {
 			if (format >= FORMAT_L8 && format <= FORMAT_RGBA8) {
 				switch (get_format_pixel_size(format)) {
 					case 1:
-						_scale_cubic<1, uint8_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale_threaded<_scale_cubic<1, uint8_t>>(r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 2:
-						_scale_cubic<2, uint8_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale_threaded<_scale_cubic<2, uint8_t>>(r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 3:
-						_scale_cubic<3, uint8_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale_threaded<_scale_cubic<3, uint8_t>>(r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 4:
-						_scale_cubic<4, uint8_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale_threaded<_scale_cubic<4, uint8_t>>(r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 				}
 			} else if (format >= FORMAT_RF && format <= FORMAT_RGBAF) {
 				switch (get_format_pixel_size(format)) {
 					case 4:
-						_scale_cubic<1, float>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale_threaded<_scale_cubic<1, float>>(r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 8:
-						_scale_cubic<2, float>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale_threaded<_scale_cubic<2, float>>(r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 12:
-						_scale_cubic<3, float>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale_threaded<_scale_cubic<3, float>>(r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 16:
-						_scale_cubic<4, float>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale_threaded<_scale_cubic<4, float>>(r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 				}
 			} else if (format >= FORMAT_RH && format <= FORMAT_RGBAH) {
 				switch (get_format_pixel_size(format)) {
 					case 2:
-						_scale_cubic<1, uint16_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale_threaded<_scale_cubic<1, uint16_t>>(r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 4:
-						_scale_cubic<2, uint16_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale_threaded<_scale_cubic<2, uint16_t>>(r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 6:
-						_scale_cubic<3, uint16_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale_threaded<_scale_cubic<3, uint16_t>>(r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 					case 8:
-						_scale_cubic<4, uint16_t>(r_ptr, w_ptr, width, height, p_width, p_height);
+						_scale_threaded<_scale_cubic<4, uint16_t>>(r_ptr, w_ptr, width, height, p_width, p_height);
 						break;
 				}
 			}
@@ -1485,23 +1728,100 @@ bool Image::_can_modify(Format p_format) const {
 	return p_format <= FORMAT_RGBE9995;
 }
 
+// Averages a row of 2x2 pixel blocks using SIMD where available. Returns the amount of
+// destination pixels written, the remaining ones are averaged by the scalar loop.
+// Rounding matches average_4_uint8() and average_4_float(), so results are bit-exact.
+template <class Component, int CC>
+static _FORCE_INLINE_ uint32_t _average_row_simd(const Component *p_up, const Component *p_down, Component *p_dst, uint32_t p_count) {
+	return 0;
+}
+
+#ifdef IMAGE_USE_SSE2
+template <>
+_FORCE_INLINE_ uint32_t _average_row_simd<uint8_t, 4>(const uint8_t *p_up, const uint8_t *p_down, uint8_t *p_dst, uint32_t p_count) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i two = _mm_set1_epi16(2);
+
+	uint32_t i = 0;
+	for (; i + 4 <= p_count; i += 4) {
+		__m128i up0 = _mm_loadu_si128((const __m128i *)(p_up + i * 8));
+		__m128i up1 = _mm_loadu_si128((const __m128i *)(p_up + i * 8 + 16));
+		__m128i down0 = _mm_loadu_si128((const __m128i *)(p_down + i * 8));
+		__m128i down1 = _mm_loadu_si128((const __m128i *)(p_down + i * 8 + 16));
+
+		// Vertical sums, widened to 16 bits. Each register holds two source pixels.
+		__m128i s01 = _mm_add_epi16(_mm_unpacklo_epi8(up0, zero), _mm_unpacklo_epi8(down0, zero));
+		__m128i s23 = _mm_add_epi16(_mm_unpackhi_epi8(up0, zero), _mm_unpackhi_epi8(down0, zero));
+		__m128i s45 = _mm_add_epi16(_mm_unpacklo_epi8(up1, zero), _mm_unpacklo_epi8(down1, zero));
+		__m128i s67 = _mm_add_epi16(_mm_unpackhi_epi8(up1, zero), _mm_unpackhi_epi8(down1, zero));
+
+		// Horizontal sums, the low half of each register ends up with one destination pixel.
+		s01 = _mm_add_epi16(s01, _mm_srli_si128(s01, 8));
+		s23 = _mm_add_epi16(s23, _mm_srli_si128(s23, 8));
+		s45 = _mm_add_epi16(s45, _mm_srli_si128(s45, 8));
+		s67 = _mm_add_epi16(s67, _mm_srli_si128(s67, 8));
+
+		__m128i lo = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(s01, s23), two), 2);
+		__m128i hi = _mm_srli_epi16(_mm_add_epi16(_mm_unpacklo_epi64(s45, s67), two), 2);
+		_mm_storeu_si128((__m128i *)(p_dst + i * 4), _mm_packus_epi16(lo, hi));
+	}
+
+	return i;
+}
+
+template <>
+_FORCE_INLINE_ uint32_t _average_row_simd<float, 4>(const float *p_up, const float *p_down, float *p_dst, uint32_t p_count) {
+	const __m128 quarter = _mm_set1_ps(0.25f);
+
+	for (uint32_t i = 0; i < p_count; i++) {
+		__m128 a = _mm_loadu_ps(p_up + i * 8);
+		__m128 b = _mm_loadu_ps(p_up + i * 8 + 4);
+		__m128 c = _mm_loadu_ps(p_down + i * 8);
+		__m128 d = _mm_loadu_ps(p_down + i * 8 + 4);
+		_mm_storeu_ps(p_dst + i * 4, _mm_mul_ps(_mm_add_ps(_mm_add_ps(_mm_add_ps(a, b), c), d), quarter));
+	}
+
+	return p_count;
+}
+#endif
+
+template <class Component>
+struct ImageMipmapParams {
+	const Component *src = nullptr;
+	Component *dst = nullptr;
+	uint32_t width = 0;
+	uint32_t height = 0;
+};
+
 template <class Component, int CC, bool renormalize,
 		void (*average_func)(Component &, const Component &, const Component &, const Component &, const Component &),
 		void (*renormalize_func)(Component *)>
-static void _generate_po2_mipmap(const Component *p_src, Component *p_dst, uint32_t p_width, uint32_t p_height) {
-	//fast power of 2 mipmap generation
-	uint32_t dst_w = MAX(p_width >> 1, 1);
-	uint32_t dst_h = MAX(p_height >> 1, 1);
+static void _generate_po2_mipmap_rows(const void *p_params, uint32_t p_from, uint32_t p_to) {
+	const ImageMipmapParams<Component> *params = (const ImageMipmapParams<Component> *)p_params;
+	const Component *src = params->src;
+	Component *dst = params->dst;
+	uint32_t width = params->width;
+	uint32_t height = params->height;
 
-	int right_step = (p_width == 1) ? 0 : CC;
-	int down_step = (p_height == 1) ? 0 : (p_width * CC);
+	uint32_t dst_w = MAX(width >> 1, 1);
 
-	for (uint32_t i = 0; i < dst_h; i++) {
-		const Component *rup_ptr = &p_src[i * 2 * down_step];
+	int right_step = (width == 1) ? 0 : CC;
+	int down_step = (height == 1) ? 0 : (width * CC);
+
+	for (uint32_t i = p_from; i < p_to; i++) {
+		const Component *rup_ptr = &src[i * 2 * down_step];
 		const Component *rdown_ptr = rup_ptr + down_step;
-		Component *dst_ptr = &p_dst[i * dst_w * CC];
+		Component *dst_ptr = &dst[i * dst_w * CC];
 		uint32_t count = dst_w;
 
+		if (!renormalize && right_step == CC) {
+			uint32_t done = _average_row_simd<Component, CC>(rup_ptr, rdown_ptr, dst_ptr, count);
+			count -= done;
+			dst_ptr += done * CC;
+			rup_ptr += done * CC * 2;
+			rdown_ptr += done * CC * 2;
+		}
+
 		while (count) {
 			count--;
 			for (int j = 0; j < CC; j++) {
@@ -1519,6 +1839,19 @@ static void _generate_po2_mipmap(const Component *p_src, Component *p_dst, uint3
 	}
 }
 
+template <class Component, int CC, bool renormalize,
+		void (*average_func)(Component &, const Component &, const Component &, const Component &, const Component &),
+		void (*renormalize_func)(Component *)>
+static void _generate_po2_mipmap(const Component *p_src, Component *p_dst, uint32_t p_width, uint32_t p_height) {
+	//fast power of 2 mipmap generation
+	ImageMipmapParams<Component> params;
+	params.src = p_src;
+	params.dst = p_dst;
+	params.width = p_width;
+	params.height = p_height;
+	_process_rows(MAX(p_height >> 1, 1), uint64_t(p_width) * p_height, _generate_po2_mipmap_rows<Component, CC, renormalize, average_func, renormalize_func>, &params);
+}
+
 void Image::shrink_x2() {
 	ERR_FAIL_COND(data.size() == 0);
 
@@ -206,6 +206,9 @@ private:
 	static void renormalize_half(uint16_t *p_rgb);
 	static void renormalize_rgbe9995(uint32_t *p_rgb);
 
+	static bool threaded_processing;
+	static void _convert_colors_rows(const void *p_params, uint32_t p_from, uint32_t p_to);
+
 public:
 	int get_width() const; ///< Get image width
 	int get_height() const; ///< Get image height
@@ -394,6 +397,25 @@ public:
 
 	void set_as_black();
 
+	// Used by the block compression modules. Calls p_func for every strip of block rows
+	// of every mipmap level, spreading the strips over the image worker pool.
+	struct BlockJob {
+		const uint8_t *src = nullptr; // Start of the mipmap level in the source data.
+		uint8_t *dst = nullptr; // Start of the mipmap level in the destination data.
+		int mipmap = 0;
+		int width = 0; // Size of the mipmap level, in pixels.
+		int height = 0;
+		int y_start = 0; // Pixel rows of the strip, y_start is a multiple of 4.
+		int y_end = 0;
+	};
+	typedef void (*BlockJobFunc)(const BlockJob &p_job, const void *p_userdata);
+
+	static void process_block_jobs(const uint8_t *p_src, Format p_src_format, uint8_t *p_dst, Format p_dst_format, int p_width, int p_height, bool p_mipmaps, BlockJobFunc p_func, const void *p_userdata);
+
+	static void set_threaded_processing_enabled(bool p_enabled);
+	static bool is_threaded_processing_enabled();
+	static void finish_work_pool();
+
 	void copy_internals_from(const Ref<Image> &p_image) {
 		ERR_FAIL_COND_MSG(p_image.is_null(), "It's not a reference to a valid Image object.");
 		format = p_image->format;
@@ -30,8 +30,18 @@
 
 #include "json.h"
 
+#include "core/os/file_access.h"
 #include "core/string/print_string.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JSON_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
 const char *JSON::tk_name[TK_MAX] = {
 	"'{'",
 	"'}'",
@@ -510,6 +520,711 @@ Error JSON::parse(const String &p_json, Variant &r_ret, String &r_err_str, int &
 	return err;
 }
 
+// Files are parsed in chunks of this many bytes.
+#define JSON_FILE_CHUNK_SIZE 65536
+
+struct JSON::UTF8Input {
+	const uint8_t *ptr = nullptr;
+	const uint8_t *end = nullptr;
+	FileAccess *file = nullptr;
+	LocalVector<uint8_t> chunk;
+	// Strings with escapes or crossing a chunk boundary are gathered here.
+	LocalVector<uint8_t> scratch;
+	int line = 0;
+
+	bool fill() {
+		if (!file) {
+			return false;
+		}
+		int read = file->get_buffer(chunk.ptr(), chunk.size());
+		if (read <= 0) {
+			return false;
+		}
+		ptr = chunk.ptr();
+		end = ptr + read;
+		return true;
+	}
+
+	// Returns 0 at the end of the input, like the NUL terminator of a String.
+	_FORCE_INLINE_ uint8_t peek() {
+		if (unlikely(ptr == end) && !fill()) {
+			return 0;
+		}
+		return *ptr;
+	}
+
+	_FORCE_INLINE_ uint8_t next() {
+		uint8_t c = peek();
+		if (c) {
+			ptr++;
+		}
+		return c;
+	}
+};
+
+static _FORCE_INLINE_ uint32_t _json_first_bit(uint32_t p_mask) {
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward(&index, p_mask);
+	return index;
+#else
+	return __builtin_ctz(p_mask);
+#endif
+}
+
+static _FORCE_INLINE_ uint32_t _json_popcount(uint32_t p_mask) {
+#if defined(_MSC_VER)
+	return __popcnt(p_mask);
+#else
+	return __builtin_popcount(p_mask);
+#endif
+}
+
+// Finds the first byte ending a plain run of string characters.
+static _FORCE_INLINE_ const uint8_t *_json_find_string_special(const uint8_t *p_from, const uint8_t *p_end) {
+#ifdef JSON_USE_SSE2
+	const __m128i quote = _mm_set1_epi8('"');
+	const __m128i backslash = _mm_set1_epi8('\\');
+	const __m128i newline = _mm_set1_epi8('\n');
+	const __m128i zero = _mm_setzero_si128();
+	while (p_end - p_from >= 16) {
+		__m128i v = _mm_loadu_si128((const __m128i *)p_from);
+		__m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)), _mm_or_si128(_mm_cmpeq_epi8(v, newline), _mm_cmpeq_epi8(v, zero)));
+		uint32_t mask = _mm_movemask_epi8(special);
+		if (mask) {
+			return p_from + _json_first_bit(mask);
+		}
+		p_from += 16;
+	}
+#endif
+	while (p_from < p_end && *p_from != '"' && *p_from != '\\' && *p_from != '\n' && *p_from != 0) {
+		p_from++;
+	}
+	return p_from;
+}
+
+// Skips control characters and spaces, counting lines, up to the next token.
+static _FORCE_INLINE_ const uint8_t *_json_skip_whitespace(const uint8_t *p_from, const uint8_t *p_end, int &r_line) {
+#ifdef JSON_USE_SSE2
+	const __m128i space = _mm_set1_epi8(32);
+	const __m128i newline = _mm_set1_epi8('\n');
+	const __m128i zero = _mm_setzero_si128();
+	while (p_end - p_from >= 16) {
+		__m128i v = _mm_loadu_si128((const __m128i *)p_from);
+		// Bytes from 1 to 32.
+		__m128i blank = _mm_andnot_si128(_mm_cmpeq_epi8(v, zero), _mm_cmpeq_epi8(_mm_max_epu8(v, space), space));
+		uint32_t token = ~(uint32_t)_mm_movemask_epi8(blank) & 0xFFFF;
+		uint32_t newlines = _mm_movemask_epi8(_mm_cmpeq_epi8(v, newline));
+		if (token) {
+			uint32_t skip = _json_first_bit(token);
+			r_line += _json_popcount(newlines & ((1u << skip) - 1));
+			return p_from + skip;
+		}
+		r_line += _json_popcount(newlines);
+		p_from += 16;
+	}
+#endif
+	while (p_from < p_end && *p_from && *p_from <= 32) {
+		if (*p_from == '\n') {
+			r_line++;
+		}
+		p_from++;
+	}
+	return p_from;
+}
+
+static _FORCE_INLINE_ void _json_append(LocalVector<uint8_t> &r_buffer, const char *p_str, uint32_t p_len) {
+	uint32_t at = r_buffer.size();
+	r_buffer.resize(at + p_len);
+	memcpy(r_buffer.ptr() + at, p_str, p_len);
+}
+
+static void _json_append_char_utf8(LocalVector<uint8_t> &r_buffer, char32_t p_char) {
+	if (p_char < 0x80) {
+		r_buffer.push_back(p_char);
+	} else if (p_char < 0x800) {
+		r_buffer.push_back(0xC0 | (p_char >> 6));
+		r_buffer.push_back(0x80 | (p_char & 0x3F));
+	} else if (p_char < 0x10000) {
+		r_buffer.push_back(0xE0 | (p_char >> 12));
+		r_buffer.push_back(0x80 | ((p_char >> 6) & 0x3F));
+		r_buffer.push_back(0x80 | (p_char & 0x3F));
+	} else {
+		r_buffer.push_back(0xF0 | ((p_char >> 18) & 0x07));
+		r_buffer.push_back(0x80 | ((p_char >> 12) & 0x3F));
+		r_buffer.push_back(0x80 | ((p_char >> 6) & 0x3F));
+		r_buffer.push_back(0x80 | (p_char & 0x3F));
+	}
+}
+
+Error JSON::_parse_hex4_utf8(UTF8Input &p_in, char32_t &r_value, String &r_err_str) {
+	for (int j = 0; j < 4; j++) {
+		char32_t c = p_in.next();
+		if (c == 0) {
+			r_err_str = "Unterminated String";
+			return ERR_PARSE_ERROR;
+		}
+		char32_t v;
+		if (c >= '0' && c <= '9') {
+			v = c - '0';
+		} else if (c >= 'a' && c <= 'f') {
+			v = c - 'a' + 10;
+		} else if (c >= 'A' && c <= 'F') {
+			v = c - 'A' + 10;
+		} else {
+			r_err_str = "Malformed hex constant in string";
+			return ERR_PARSE_ERROR;
+		}
+		r_value = (r_value << 4) | v;
+	}
+	return OK;
+}
+
+Error JSON::_parse_string_utf8(UTF8Input &p_in, String &r_str, String &r_err_str) {
+	p_in.scratch.clear();
+
+	while (true) {
+		const uint8_t *run = p_in.ptr;
+		const uint8_t *stop = _json_find_string_special(run, p_in.end);
+
+		if (stop != p_in.end && *stop == '"' && p_in.scratch.size() == 0) {
+			// The whole string is in the chunk, decode it in place.
+			r_str.parse_utf8((const char *)run, stop - run);
+			p_in.ptr = stop + 1;
+			return OK;
+		}
+
+		if (stop != run) {
+			_json_append(p_in.scratch, (const char *)run, stop - run);
+		}
+		p_in.ptr = stop;
+
+		uint8_t c = p_in.peek();
+		if (c == 0) {
+			r_err_str = "Unterminated String";
+			return ERR_PARSE_ERROR;
+		} else if (c == '"') {
+			p_in.ptr++;
+			break;
+		} else if (c == '\n') {
+			p_in.line++;
+			p_in.scratch.push_back(c);
+			p_in.ptr++;
+		} else if (c == '\\') {
+			//escaped characters...
+			p_in.ptr++;
+			uint8_t next = p_in.next();
+			if (next == 0) {
+				r_err_str = "Unterminated String";
+				return ERR_PARSE_ERROR;
+			}
+			char32_t res = 0;
+
+			switch (next) {
+				case 'b':
+					res = 8;
+					break;
+				case 't':
+					res = 9;
+					break;
+				case 'n':
+					res = 10;
+					break;
+				case 'f':
+					res = 12;
+					break;
+				case 'r':
+					res = 13;
+					break;
+				case 'u': {
+					Error err = _parse_hex4_utf8(p_in, res, r_err_str);
+					if (err) {
+						return err;
+					}
+
+					if ((res & 0xfffffc00) == 0xd800) {
+						if (p_in.next() != '\\' || p_in.next() != 'u') {
+							r_err_str = "Invalid UTF-16 sequence in string, unpaired lead surrogate";
+							return ERR_PARSE_ERROR;
+						}
+						char32_t trail = 0;
+						err = _parse_hex4_utf8(p_in, trail, r_err_str);
+						if (err) {
+							return err;
+						}
+						if ((trail & 0xfffffc00) == 0xdc00) {
+							res = (res << 10UL) + trail - ((0xd800 << 10UL) + 0xdc00 - 0x10000);
+						} else {
+							r_err_str = "Invalid UTF-16 sequence in string, unpaired lead surrogate";
+							return ERR_PARSE_ERROR;
+						}
+					} else if ((res & 0xfffffc00) == 0xdc00) {
+						r_err_str = "Invalid UTF-16 sequence in string, unpaired trail surrogate";
+						return ERR_PARSE_ERROR;
+					}
+				} break;
+				default: {
+					res = next;
+				} break;
+			}
+
+			_json_append_char_utf8(p_in.scratch, res);
+		}
+	}
+
+	r_str.parse_utf8((const char *)p_in.scratch.ptr(), p_in.scratch.size());
+	return OK;
+}
+
+Error JSON::_get_token_utf8(UTF8Input &p_in, Token &r_token, String &r_err_str) {
+	while (true) {
+		p_in.ptr = _json_skip_whitespace(p_in.ptr, p_in.end, p_in.line);
+		uint8_t c = p_in.peek();
+
+		switch (c) {
+			case 0: {
+				r_token.type = TK_EOF;
+				return OK;
+			}
+			case '{': {
+				r_token.type = TK_CURLY_BRACKET_OPEN;
+				p_in.ptr++;
+				return OK;
+			}
+			case '}': {
+				r_token.type = TK_CURLY_BRACKET_CLOSE;
+				p_in.ptr++;
+				return OK;
+			}
+			case '[': {
+				r_token.type = TK_BRACKET_OPEN;
+				p_in.ptr++;
+				return OK;
+			}
+			case ']': {
+				r_token.type = TK_BRACKET_CLOSE;
+				p_in.ptr++;
+				return OK;
+			}
+			case ':': {
+				r_token.type = TK_COLON;
+				p_in.ptr++;
+				return OK;
+			}
+			case ',': {
+				r_token.type = TK_COMMA;
+				p_in.ptr++;
+				return OK;
+			}
+			case '"': {
+				p_in.ptr++;
+				String str;
+				Error err = _parse_string_utf8(p_in, str, r_err_str);
+				if (err) {
+					return err;
+				}
+				r_token.type = TK_STRING;
+				r_token.value = str;
+				return OK;
+			}
+			default: {
+				if (c <= 32) {
+					// Whitespace at the end of a chunk.
+					p_in.ptr++;
+					if (c == '\n') {
+						p_in.line++;
+					}
+					break;
+				}
+
+				if (c == '-' || (c >= '0' && c <= '9')) {
+					//a number
+					LocalVector<uint8_t> &number = p_in.scratch;
+					number.clear();
+					bool dot = false;
+					bool exponent = false;
+					while (true) {
+						c = p_in.peek();
+						if (c == '.' && !dot && !exponent) {
+							dot = true;
+						} else if ((c == 'e' || c == 'E') && !exponent && number.size() > 0) {
+							exponent = true;
+						} else if (c == '-' || c == '+') {
+							// Signs only lead the mantissa or the exponent.
+							if (number.size() > 0 && number[number.size() - 1] != 'e' && number[number.size() - 1] != 'E') {
+								break;
+							}
+						} else if (c < '0' || c > '9') {
+							break;
+						}
+						number.push_back(c);
+						p_in.ptr++;
+					}
+					number.push_back(0);
+					r_token.type = TK_NUMBER;
+					r_token.value = String::to_float((const char *)number.ptr());
+					return OK;
+
+				} else if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z')) {
+					LocalVector<uint8_t> &id = p_in.scratch;
+					id.clear();
+					while ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z')) {
+						id.push_back(c);
+						p_in.ptr++;
+						c = p_in.peek();
+					}
+					id.push_back(0);
+
+					r_token.type = TK_IDENTIFIER;
+					r_token.value = String((const char *)id.ptr());
+					return OK;
+				} else {
+					r_err_str = "Unexpected character.";
+					return ERR_PARSE_ERROR;
+				}
+			}
+		}
+	}
+}
+
+Error JSON::_parse_value_utf8(Variant &value, Token &token, UTF8Input &p_in, String &r_err_str) {
+	if (token.type == TK_CURLY_BRACKET_OPEN) {
+		Dictionary d;
+		Error err = _parse_object_utf8(d, p_in, r_err_str);
+		if (err) {
+			return err;
+		}
+		value = d;
+	} else if (token.type == TK_BRACKET_OPEN) {
+		Array a;
+		Error err = _parse_array_utf8(a, p_in, r_err_str);
+		if (err) {
+			return err;
+		}
+		value = a;
+	} else if (token.type == TK_IDENTIFIER) {
+		String id = token.value;
+		if (id == "true") {
+			value = true;
+		} else if (id == "false") {
+			value = false;
+		} else if (id == "null") {
+			value = Variant();
+		} else {
+			r_err_str = "Expected 'true','false' or 'null', got '" + id + "'.";
+			return ERR_PARSE_ERROR;
+		}
+	} else if (token.type == TK_NUMBER) {
+		value = token.value;
+	} else if (token.type == TK_STRING) {
+		value = token.value;
+	} else {
+		r_err_str = "Expected value, got " + String(tk_name[token.type]) + ".";
+		return ERR_PARSE_ERROR;
+	}
+
+	return OK;
+}
+
+Error JSON::_parse_array_utf8(Array &array, UTF8Input &p_in, String &r_err_str) {
+	Token token;
+	bool need_comma = false;
+
+	while (true) {
+		Error err = _get_token_utf8(p_in, token, r_err_str);
+		if (err != OK) {
+			return err;
+		}
+
+		if (token.type == TK_BRACKET_CLOSE) {
+			return OK;
+		}
+		if (token.type == TK_EOF) {
+			break;
+		}
+
+		if (need_comma) {
+			if (token.type != TK_COMMA) {
+				r_err_str = "Expected ','";
+				return ERR_PARSE_ERROR;
+			} else {
+				need_comma = false;
+				continue;
+			}
+		}
+
+		Variant v;
+		err = _parse_value_utf8(v, token, p_in, r_err_str);
+		if (err) {
+			return err;
+		}
+
+		array.push_back(v);
+		need_comma = true;
+	}
+
+	r_err_str = "Expected ']'";
+	return ERR_PARSE_ERROR;
+}
+
+Error JSON::_parse_object_utf8(Dictionary &object, UTF8Input &p_in, String &r_err_str) {
+	String key;
+	Token token;
+	bool need_comma = false;
+
+	while (true) {
+		Error err = _get_token_utf8(p_in, token, r_err_str);
+		if (err != OK) {
+			return err;
+		}
+
+		if (token.type == TK_CURLY_BRACKET_CLOSE) {
+			return OK;
+		}
+		if (token.type == TK_EOF) {
+			break;
+		}
+
+		if (need_comma) {
+			if (token.type != TK_COMMA) {
+				r_err_str = "Expected '}' or ','";
+				return ERR_PARSE_ERROR;
+			} else {
+				need_comma = false;
+				continue;
+			}
+		}
+
+		if (token.type != TK_STRING) {
+			r_err_str = "Expected key";
+			return ERR_PARSE_ERROR;
+		}
+
+		key = token.value;
+		err = _get_token_utf8(p_in, token, r_err_str);
+		if (err != OK) {
+			return err;
+		}
+		if (token.type != TK_COLON) {
+			r_err_str = "Expected ':'";
+			return ERR_PARSE_ERROR;
+		}
+
+		err = _get_token_utf8(p_in, token, r_err_str);
+		if (err != OK) {
+			return err;
+		}
+
+		Variant v;
+		err = _parse_value_utf8(v, token, p_in, r_err_str);
+		if (err) {
+			return err;
+		}
+		object[key] = v;
+		need_comma = true;
+	}
+
+	r_err_str = "Expected '}'";
+	return ERR_PARSE_ERROR;
+}
+
+Error JSON::_parse_utf8(UTF8Input &p_in, Variant &r_ret, String &r_err_str, int &r_err_line) {
+	// Skip the byte order mark, as String::parse_utf8() does.
+	if (p_in.peek() == 0xEF && p_in.end - p_in.ptr >= 3 && p_in.ptr[1] == 0xBB && p_in.ptr[2] == 0xBF) {
+		p_in.ptr += 3;
+	}
+
+	Token token;
+	Error err = _get_token_utf8(p_in, token, r_err_str);
+	if (err == OK) {
+		err = _parse_value_utf8(r_ret, token, p_in, r_err_str);
+	}
+
+	// Check if EOF is reached
+	// or it's a type of the next token.
+	if (err == OK) {
+		err = _get_token_utf8(p_in, token, r_err_str);
+
+		if (err || token.type != TK_EOF) {
+			r_err_str = "Expected 'EOF'";
+			// Reset return value to empty `Variant`
+			r_ret = Variant();
+			err = ERR_PARSE_ERROR;
+		}
+	}
+
+	r_err_line = p_in.line;
+	return err;
+}
+
+Error JSON::parse_utf8(const uint8_t *p_utf8, int p_len, Variant &r_ret, String &r_err_str, int &r_err_line) {
+	UTF8Input in;
+	in.ptr = p_utf8;
+	in.end = p_utf8 + p_len;
+	return _parse_utf8(in, r_ret, r_err_str, r_err_line);
+}
+
+Error JSON::parse_file(FileAccess *p_file, Variant &r_ret, String &r_err_str, int &r_err_line) {
+	ERR_FAIL_COND_V(!p_file, ERR_INVALID_PARAMETER);
+
+	UTF8Input in;
+	in.file = p_file;
+	in.chunk.resize(JSON_FILE_CHUNK_SIZE);
+	in.fill();
+	return _parse_utf8(in, r_ret, r_err_str, r_err_line);
+}
+
+static void _json_append_string(LocalVector<uint8_t> &r_buffer, const String &p_str) {
+	r_buffer.push_back('"');
+
+	const char32_t *src = p_str.ptr();
+	int len = p_str.length();
+	for (int i = 0; i < len; i++) {
+		char32_t c = src[i];
+		switch (c) {
+			case '\\':
+				_json_append(r_buffer, "\\\\", 2);
+				break;
+			case '\b':
+				_json_append(r_buffer, "\\b", 2);
+				break;
+			case '\f':
+				_json_append(r_buffer, "\\f", 2);
+				break;
+			case '\n':
+				_json_append(r_buffer, "\\n", 2);
+				break;
+			case '\r':
+				_json_append(r_buffer, "\\r", 2);
+				break;
+			case '\t':
+				_json_append(r_buffer, "\\t", 2);
+				break;
+			case '\v':
+				_json_append(r_buffer, "\\v", 2);
+				break;
+			case '"':
+				_json_append(r_buffer, "\\\"", 2);
+				break;
+			default:
+				_json_append_char_utf8(r_buffer, c);
+		}
+	}
+
+	r_buffer.push_back('"');
+}
+
+static void _json_append_indent(LocalVector<uint8_t> &r_buffer, const CharString &p_indent, int p_size) {
+	for (int i = 0; i < p_size; i++) {
+		_json_append(r_buffer, p_indent.get_data(), p_indent.length());
+	}
+}
+
+static void _json_print_var_utf8(const Variant &p_var, LocalVector<uint8_t> &r_buffer, const CharString &p_indent, int p_cur_indent, bool p_sort_keys) {
+	const bool pretty = p_indent.length() > 0;
+
+	switch (p_var.get_type()) {
+		case Variant::NIL:
+			_json_append(r_buffer, "null", 4);
+			break;
+		case Variant::BOOL:
+			if (p_var.operator bool()) {
+				_json_append(r_buffer, "true", 4);
+			} else {
+				_json_append(r_buffer, "false", 5);
+			}
+			break;
+		case Variant::INT: {
+			int64_t value = p_var;
+			uint64_t magnitude = value < 0 ? -(uint64_t)value : (uint64_t)value;
+			char digits[24];
+			int at = sizeof(digits);
+			do {
+				digits[--at] = '0' + magnitude % 10;
+				magnitude /= 10;
+			} while (magnitude);
+			if (value < 0) {
+				digits[--at] = '-';
+			}
+			_json_append(r_buffer, digits + at, sizeof(digits) - at);
+		} break;
+		case Variant::FLOAT: {
+			String number = rtos(p_var);
+			for (int i = 0; i < number.length(); i++) {
+				r_buffer.push_back(number[i]);
+			}
+		} break;
+		case Variant::PACKED_INT32_ARRAY:
+		case Variant::PACKED_INT64_ARRAY:
+		case Variant::PACKED_FLOAT32_ARRAY:
+		case Variant::PACKED_FLOAT64_ARRAY:
+		case Variant::PACKED_STRING_ARRAY:
+		case Variant::ARRAY: {
+			r_buffer.push_back('[');
+			if (pretty) {
+				r_buffer.push_back('\n');
+			}
+			Array a = p_var;
+			for (int i = 0; i < a.size(); i++) {
+				if (i > 0) {
+					r_buffer.push_back(',');
+					if (pretty) {
+						r_buffer.push_back('\n');
+					}
+				}
+				_json_append_indent(r_buffer, p_indent, p_cur_indent + 1);
+				_json_print_var_utf8(a[i], r_buffer, p_indent, p_cur_indent + 1, p_sort_keys);
+			}
+			if (pretty) {
+				r_buffer.push_back('\n');
+			}
+			_json_append_indent(r_buffer, p_indent, p_cur_indent);
+			r_buffer.push_back(']');
+		} break;
+		case Variant::DICTIONARY: {
+			r_buffer.push_back('{');
+			if (pretty) {
+				r_buffer.push_back('\n');
+			}
+			Dictionary d = p_var;
+			List<Variant> keys;
+			d.get_key_list(&keys);
+
+			if (p_sort_keys) {
+				keys.sort();
+			}
+
+			for (List<Variant>::Element *E = keys.front(); E; E = E->next()) {
+				if (E != keys.front()) {
+					r_buffer.push_back(',');
+					if (pretty) {
+						r_buffer.push_back('\n');
+					}
+				}
+				_json_append_indent(r_buffer, p_indent, p_cur_indent + 1);
+				_json_append_string(r_buffer, String(E->get()));
+				r_buffer.push_back(':');
+				if (pretty) {
+					r_buffer.push_back(' ');
+				}
+				_json_print_var_utf8(d[E->get()], r_buffer, p_indent, p_cur_indent + 1, p_sort_keys);
+			}
+
+			if (pretty) {
+				r_buffer.push_back('\n');
+			}
+			_json_append_indent(r_buffer, p_indent, p_cur_indent);
+			r_buffer.push_back('}');
+		} break;
+		default:
+			_json_append_string(r_buffer, String(p_var));
+	}
+}
+
+void JSON::print_utf8(const Variant &p_var, LocalVector<uint8_t> &r_buffer, const String &p_indent, bool p_sort_keys) {
+	_json_print_var_utf8(p_var, r_buffer, p_indent.utf8(), 0, p_sort_keys);
+}
+
 Error JSONParser::parse_string(const String &p_json_string) {
 	return JSON::parse(p_json_string, data, err_text, err_line);
 }
@@ -32,7 +32,11 @@
 #define JSON_H
 
 #include "core/object/reference.h"
+#include "core/templates/local_vector.h"
 #include "core/variant/variant.h"
+
+class FileAccess;
+
 class JSON {
 	enum TokenType {
 		TK_CURLY_BRACKET_OPEN,
@@ -69,9 +73,27 @@ class JSON {
 	static Error _parse_array(Array &array, const char32_t *p_str, int &index, int p_len, int &line, String &r_err_str);
 	static Error _parse_object(Dictionary &object, const char32_t *p_str, int &index, int p_len, int &line, String &r_err_str);
 
+	// UTF-8 input, either a whole buffer or a file read in chunks.
+	struct UTF8Input;
+
+	static Error _get_token_utf8(UTF8Input &p_in, Token &r_token, String &r_err_str);
+	static Error _parse_hex4_utf8(UTF8Input &p_in, char32_t &r_value, String &r_err_str);
+	static Error _parse_string_utf8(UTF8Input &p_in, String &r_str, String &r_err_str);
+	static Error _parse_value_utf8(Variant &value, Token &token, UTF8Input &p_in, String &r_err_str);
+	static Error _parse_array_utf8(Array &array, UTF8Input &p_in, String &r_err_str);
+	static Error _parse_object_utf8(Dictionary &object, UTF8Input &p_in, String &r_err_str);
+	static Error _parse_utf8(UTF8Input &p_in, Variant &r_ret, String &r_err_str, int &r_err_line);
+
 public:
 	static String print(const Variant &p_var, const String &p_indent = "", bool p_sort_keys = true);
 	static Error parse(const String &p_json, Variant &r_ret, String &r_err_str, int &r_err_line);
+
+	// Same as print() and parse(), working on UTF-8 bytes without converting
+	// the whole document to a String.
+	static void print_utf8(const Variant &p_var, LocalVector<uint8_t> &r_buffer, const String &p_indent = "", bool p_sort_keys = true);
+	static Error parse_utf8(const uint8_t *p_utf8, int p_len, Variant &r_ret, String &r_err_str, int &r_err_line);
+	// Parses from the current position to the end of the file.
+	static Error parse_file(FileAccess *p_file, Variant &r_ret, String &r_err_str, int &r_err_line);
 };
 
 class JSONParser : public Reference {
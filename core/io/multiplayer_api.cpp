@@ -136,6 +136,14 @@ void MultiplayerAPI::clear() {
 	path_send_cache.clear();
 	packet_cache.clear();
 	last_send_cache_id = 1;
+
+	replication_peers.clear();
+	replication_received.clear();
+	for (int i = 0; i < REPLICATION_HISTORY_SIZE; i++) {
+		replication_history[i].sequence = 0;
+		replication_history[i].entities.clear();
+	}
+	replication_sequence = 0;
 }
 
 void MultiplayerAPI::set_root_node(Node *p_node) {
@@ -314,6 +322,14 @@ void MultiplayerAPI::_process_packet(int p_from, const uint8_t *p_packet, int p_
 		case NETWORK_COMMAND_RAW: {
 			_process_raw(p_from, p_packet, p_packet_len);
 		} break;
+
+		case NETWORK_COMMAND_REPLICATE: {
+			_process_replicate(p_from, p_packet, p_packet_len);
+		} break;
+
+		case NETWORK_COMMAND_REPLICATE_ACK: {
+			_process_replicate_ack(p_from, p_packet, p_packet_len);
+		} break;
 	}
 }
 
@@ -975,6 +991,7 @@ void MultiplayerAPI::_send_rpc(Node *p_from, int p_to, bool p_unreliable, bool p
 void MultiplayerAPI::_add_peer(int p_id) {
 	connected_peers.insert(p_id);
 	path_get_cache.insert(p_id, PathGetCache());
+	replication_peers.insert(p_id, ReplicationPeer());
 	emit_signal("network_peer_connected", p_id);
 }
 
@@ -982,6 +999,8 @@ void MultiplayerAPI::_del_peer(int p_id) {
 	connected_peers.erase(p_id);
 	// Cleanup get cache.
 	path_get_cache.erase(p_id);
+	replication_peers.erase(p_id);
+	replication_received.erase(p_id);
 	// Cleanup sent cache.
 	// Some refactoring is needed to make this faster and do paths GC.
 	List<NodePath> keys;
@@ -1204,6 +1223,611 @@ bool MultiplayerAPI::is_object_decoding_allowed() const {
 	return allow_object_decoding;
 }
 
+// Replication packets start with a byte aligned header (command, sequence and
+// baseline sequence), followed by a bit stream written least significant bit
+// first. Each entity is prefixed by a continuation bit and its path cache id,
+// and each of its properties by a bit telling whether it changed since the
+// baseline. The ids the peer should forget follow the same scheme.
+class ReplicationBitWriter {
+	LocalVector<uint8_t> &buffer;
+	uint32_t bits;
+
+public:
+	void write_bits(uint32_t p_value, int p_count) {
+		while (p_count > 0) {
+			const int offset = bits & 7;
+			if (offset == 0) {
+				buffer.push_back(0);
+			}
+			const int count = MIN(8 - offset, p_count);
+			buffer[bits >> 3] |= (p_value & ((1 << count) - 1)) << offset;
+			p_value >>= count;
+			p_count -= count;
+			bits += count;
+		}
+	}
+
+	void write_uint(uint32_t p_value) {
+		int count = 0;
+		while (count < 32 && (p_value >> count)) {
+			count++;
+		}
+		write_bits(count, 6);
+		write_bits(p_value, count);
+	}
+
+	void write_int(int32_t p_value) {
+		write_uint(((uint32_t)p_value << 1) ^ (uint32_t)(p_value >> 31));
+	}
+
+	uint8_t *write_bytes(int p_count) {
+		const uint32_t offset = buffer.size();
+		buffer.resize(offset + p_count);
+		bits = buffer.size() * 8;
+		return buffer.ptr() + offset;
+	}
+
+	ReplicationBitWriter(LocalVector<uint8_t> &r_buffer) :
+			buffer(r_buffer) {
+		bits = buffer.size() * 8;
+	}
+};
+
+class ReplicationBitReader {
+	const uint8_t *buffer;
+	uint32_t size;
+	uint32_t bits;
+	bool error = false;
+
+public:
+	uint32_t read_bits(int p_count) {
+		if (bits + p_count > size * 8) {
+			error = true;
+			return 0;
+		}
+		uint32_t value = 0;
+		int shift = 0;
+		while (p_count > 0) {
+			const int offset = bits & 7;
+			const int count = MIN(8 - offset, p_count);
+			value |= (uint32_t)((buffer[bits >> 3] >> offset) & ((1 << count) - 1)) << shift;
+			shift += count;
+			p_count -= count;
+			bits += count;
+		}
+		return value;
+	}
+
+	uint32_t read_uint() {
+		const uint32_t count = read_bits(6);
+		if (count > 32) {
+			error = true;
+			return 0;
+		}
+		return read_bits(count);
+	}
+
+	int32_t read_int() {
+		const uint32_t value = read_uint();
+		return (int32_t)(value >> 1) ^ -(int32_t)(value & 1);
+	}
+
+	void align() {
+		bits = MIN((bits + 7) & ~7, size * 8);
+	}
+
+	const uint8_t *get_data() const { return buffer + (bits >> 3); }
+	int get_remaining() const { return size - (bits >> 3); }
+	void skip_bytes(int p_count) {
+		if ((bits >> 3) + p_count > size) {
+			error = true;
+			return;
+		}
+		bits += p_count * 8;
+	}
+	bool has_error() const { return error; }
+
+	ReplicationBitReader(const uint8_t *p_buffer, uint32_t p_size, uint32_t p_offset) {
+		buffer = p_buffer;
+		size = p_size;
+		bits = p_offset * 8;
+	}
+};
+
+static _FORCE_INLINE_ int32_t _replication_quantize_real(real_t p_value, real_t p_step) {
+	return (int32_t)CLAMP(Math::round(p_value / p_step), (real_t)-1073741823, (real_t)1073741823);
+}
+
+// Drops the largest component, which is rebuilt from the unit length. The
+// other three lie in [-1/sqrt(2), 1/sqrt(2)] and get 10 bits each.
+static uint32_t _replication_pack_quat(const Quat &p_quat) {
+	const Quat q = p_quat.length_squared() > CMP_EPSILON ? p_quat.normalized() : Quat();
+	const real_t c[4] = { q.x, q.y, q.z, q.w };
+	int largest = 0;
+	for (int i = 1; i < 4; i++) {
+		if (Math::abs(c[i]) > Math::abs(c[largest])) {
+			largest = i;
+		}
+	}
+	const real_t sign = c[largest] < 0 ? -1 : 1;
+	uint32_t packed = largest;
+	int shift = 2;
+	for (int i = 0; i < 4; i++) {
+		if (i == largest) {
+			continue;
+		}
+		const real_t v = CLAMP(c[i] * sign * (real_t)Math_SQRT2, (real_t)-1, (real_t)1);
+		packed |= (uint32_t)Math::round((v + 1) * (real_t)0.5 * 1023) << shift;
+		shift += 10;
+	}
+	return packed;
+}
+
+static Quat _replication_unpack_quat(uint32_t p_packed) {
+	const int largest = p_packed & 3;
+	real_t c[4];
+	real_t sum = 0;
+	int shift = 2;
+	for (int i = 0; i < 4; i++) {
+		if (i == largest) {
+			continue;
+		}
+		c[i] = ((real_t)((p_packed >> shift) & 1023) * ((real_t)2 / 1023) - 1) * (real_t)Math_SQRT12;
+		sum += c[i] * c[i];
+		shift += 10;
+	}
+	c[largest] = Math::sqrt(MAX((real_t)0, 1 - sum));
+	return Quat(c[0], c[1], c[2], c[3]);
+}
+
+Variant MultiplayerAPI::_replication_quantize(const ReplicationProperty &p_property, const Variant &p_value) const {
+	switch (p_property.hint) {
+		case REPLICATION_HINT_VECTOR3: {
+			const Vector3 v = p_value;
+			const real_t step = p_property.step;
+			return Vector3(_replication_quantize_real(v.x, step) * step, _replication_quantize_real(v.y, step) * step, _replication_quantize_real(v.z, step) * step);
+		} break;
+		case REPLICATION_HINT_QUAT: {
+			return _replication_unpack_quat(_replication_pack_quat(p_value));
+		} break;
+		default: {
+			return p_value;
+		}
+	}
+}
+
+bool MultiplayerAPI::_replication_has_changed(const ReplicationProperty &p_property, const Variant &p_value, const Variant *p_base) const {
+	if (!p_base) {
+		return true;
+	}
+	switch (p_property.hint) {
+		case REPLICATION_HINT_VECTOR3: {
+			const Vector3 v = p_value;
+			const Vector3 base = *p_base;
+			const real_t step = p_property.step;
+			return _replication_quantize_real(v.x, step) != _replication_quantize_real(base.x, step) ||
+				   _replication_quantize_real(v.y, step) != _replication_quantize_real(base.y, step) ||
+				   _replication_quantize_real(v.z, step) != _replication_quantize_real(base.z, step);
+		} break;
+		case REPLICATION_HINT_QUAT: {
+			return _replication_pack_quat(p_value) != _replication_pack_quat(*p_base);
+		} break;
+		default: {
+			return p_value != *p_base;
+		}
+	}
+}
+
+void MultiplayerAPI::_replication_send_peer(int p_peer, ReplicationPeer &p_state, const LocalVector<ReplicationSource> &p_sources) {
+	const uint32_t sequence = replication_sequence;
+	const uint32_t slot = sequence % REPLICATION_HISTORY_SIZE;
+
+	// Delta against the last acknowledged state, as long as it is still in the history.
+	uint32_t baseline = p_state.acked;
+	const uint32_t base_slot = baseline % REPLICATION_HISTORY_SIZE;
+	if (baseline == 0 || sequence - baseline >= REPLICATION_HISTORY_SIZE || p_state.sequences[base_slot] != baseline || replication_history[base_slot].sequence != baseline) {
+		baseline = 0;
+	}
+	const LocalVector<uint32_t> *base_sent = baseline ? &p_state.sent[base_slot] : nullptr;
+	const LocalVector<ReplicationEntity> *base_entities = baseline ? &replication_history[base_slot].entities : nullptr;
+	uint32_t base_index = 0;
+	uint32_t base_entity = 0;
+	LocalVector<uint32_t> removed;
+
+	LocalVector<uint32_t> &sent = p_state.sent[slot];
+	sent.clear();
+	p_state.sequences[slot] = sequence;
+
+	replication_buffer.resize(9);
+	replication_buffer[0] = NETWORK_COMMAND_REPLICATE;
+	encode_uint32(sequence, &replication_buffer[1]);
+	encode_uint32(baseline, &replication_buffer[5]);
+	ReplicationBitWriter writer(replication_buffer);
+
+	for (uint32_t i = 0; i < p_sources.size(); i++) {
+		const ReplicationSource &source = p_sources[i];
+
+		// The peer must know the path before it can receive the node state.
+		Map<int, bool>::Element *C = source.cache->confirmed_peers.find(p_peer);
+		if (!C) {
+			_send_confirm_path(source.node, source.replication->path, source.cache, p_peer);
+			continue;
+		}
+		if (!C->get()) {
+			continue;
+		}
+
+		const Map<int, bool>::Element *V = source.replication->visibility.find(p_peer);
+		if (V) {
+			if (!V->get()) {
+				continue;
+			}
+		} else if (p_state.interest_radius > 0 && source.has_origin && source.origin.distance_squared_to(p_state.interest_origin) > p_state.interest_radius * p_state.interest_radius) {
+			continue;
+		}
+
+		sent.push_back(source.id);
+
+		const Vector<ReplicationProperty> &properties = source.replication->properties;
+		const Variant *values = source.values.ptr();
+		const Variant *base_values = nullptr;
+		if (base_sent) {
+			while (base_index < base_sent->size() && (*base_sent)[base_index] < source.id) {
+				removed.push_back((*base_sent)[base_index++]);
+			}
+			if (base_index < base_sent->size() && (*base_sent)[base_index] == source.id) {
+				base_index++;
+				while (base_entity < base_entities->size() && (*base_entities)[base_entity].id < source.id) {
+					base_entity++;
+				}
+				if (base_entity < base_entities->size() && (*base_entities)[base_entity].id == source.id && (*base_entities)[base_entity].values.size() == properties.size()) {
+					base_values = (*base_entities)[base_entity].values.ptr();
+				}
+			}
+		}
+
+		bool changed = false;
+		for (int j = 0; j < properties.size() && !changed; j++) {
+			changed = _replication_has_changed(properties[j], values[j], base_values ? &base_values[j] : nullptr);
+		}
+		if (!changed) {
+			continue;
+		}
+
+		// The properties go in a sized block, so a peer that can't resolve the node can skip it.
+		replication_entity_buffer.clear();
+		ReplicationBitWriter entity_writer(replication_entity_buffer);
+		for (int j = 0; j < properties.size(); j++) {
+			const ReplicationProperty &property = properties[j];
+			const Variant *base = base_values ? &base_values[j] : nullptr;
+			if (!_replication_has_changed(property, values[j], base)) {
+				entity_writer.write_bits(0, 1);
+				continue;
+			}
+			entity_writer.write_bits(1, 1);
+
+			switch (property.hint) {
+				case REPLICATION_HINT_VECTOR3: {
+					const Vector3 v = values[j];
+					const Vector3 b = base ? (Vector3)*base : Vector3();
+					for (int k = 0; k < 3; k++) {
+						entity_writer.write_int(_replication_quantize_real(v[k], property.step) - _replication_quantize_real(b[k], property.step));
+					}
+				} break;
+				case REPLICATION_HINT_QUAT: {
+					entity_writer.write_bits(_replication_pack_quat(values[j]), 32);
+				} break;
+				default: {
+					int len = 0;
+					Error err = _encode_and_compress_variant(values[j], nullptr, len);
+					ERR_FAIL_COND_MSG(err != OK, "Unable to encode replicated property: " + String(property.name) + ".");
+					_encode_and_compress_variant(values[j], entity_writer.write_bytes(len), len);
+				}
+			}
+		}
+
+		writer.write_bits(1, 1);
+		writer.write_uint(source.id);
+		writer.write_uint(replication_entity_buffer.size());
+		memcpy(writer.write_bytes(replication_entity_buffer.size()), replication_entity_buffer.ptr(), replication_entity_buffer.size());
+	}
+	writer.write_bits(0, 1);
+
+	if (base_sent) {
+		while (base_index < base_sent->size()) {
+			removed.push_back((*base_sent)[base_index++]);
+		}
+	}
+	for (uint32_t i = 0; i < removed.size(); i++) {
+		writer.write_bits(1, 1);
+		writer.write_uint(removed[i]);
+	}
+	writer.write_bits(0, 1);
+
+	// Packets are sent even when empty, so the peer keeps acknowledging newer baselines.
+	network_peer->set_target_peer(p_peer);
+	network_peer->set_transfer_mode(NetworkedMultiplayerPeer::TRANSFER_MODE_UNRELIABLE);
+	network_peer->put_packet(replication_buffer.ptr(), replication_buffer.size());
+
+#ifdef DEBUG_ENABLED
+	_profile_bandwidth_data("out", replication_buffer.size());
+#endif
+}
+
+Node *MultiplayerAPI::_replication_get_node(int p_from, uint32_t p_id) {
+	Map<int, PathGetCache>::Element *E = path_get_cache.find(p_from);
+	if (!E) {
+		return nullptr;
+	}
+	Map<int, PathGetCache::NodeInfo>::Element *F = E->get().nodes.find(p_id);
+	if (!F) {
+		return nullptr;
+	}
+
+	PathGetCache::NodeInfo &info = F->get();
+	Node *node = Object::cast_to<Node>(ObjectDB::get_instance(info.instance));
+	if (!node) {
+		node = root_node->get_node_or_null(info.path);
+		if (node) {
+			info.instance = node->get_instance_id();
+		}
+	}
+	return node;
+}
+
+void MultiplayerAPI::_process_replicate(int p_from, const uint8_t *p_packet, int p_packet_len) {
+	ERR_FAIL_COND_MSG(p_packet_len < 10, "Invalid packet received. Size too small.");
+
+	Map<int, ReplicationReceived>::Element *R = replication_received.find(p_from);
+	if (!R) {
+		R = replication_received.insert(p_from, ReplicationReceived());
+	}
+	ReplicationReceived &received = R->get();
+
+	const uint32_t sequence = decode_uint32(&p_packet[1]);
+	const uint32_t baseline = decode_uint32(&p_packet[5]);
+	if (sequence <= received.last_applied) {
+		return; // Late or duplicated.
+	}
+
+	HashMap<uint32_t, Vector<Variant>> state;
+	if (baseline) {
+		const uint32_t base_slot = baseline % REPLICATION_HISTORY_SIZE;
+		if (received.sequences[base_slot] != baseline) {
+			return; // The baseline is gone, the sender will fall back to a newer one.
+		}
+		state = received.states[base_slot];
+	}
+
+	struct Update {
+		Node *node;
+		StringName property;
+		Variant value;
+	};
+	LocalVector<Update> updates;
+	LocalVector<uint32_t> skipped;
+
+	// Decode the whole packet before applying anything.
+	ReplicationBitReader reader(p_packet, p_packet_len, 9);
+	while (reader.read_bits(1)) {
+		const uint32_t id = reader.read_uint();
+		const uint32_t size = reader.read_uint();
+		reader.align();
+		ERR_FAIL_COND_MSG(reader.has_error() || size > (uint32_t)reader.get_remaining(), "Invalid packet received. Size smaller than declared.");
+		ReplicationBitReader entity_reader(reader.get_data(), size, 0);
+		reader.skip_bytes(size);
+
+		// A node that is gone or not replicated here doesn't stop the others. The acknowledgement
+		// lists it, so the sender sends its full state next time instead of a delta against nothing.
+		Node *node = _replication_get_node(p_from, id);
+		const Map<ObjectID, ReplicationNode>::Element *N = node ? replication_nodes.find(node->get_instance_id()) : nullptr;
+		if (!N) {
+			state.erase(id);
+			skipped.push_back(id);
+			continue;
+		}
+
+		const Vector<ReplicationProperty> &properties = N->get().properties;
+		Vector<Variant> *values = state.getptr(id);
+		if (!values || values->size() != properties.size()) {
+			state[id] = Vector<Variant>();
+			values = state.getptr(id);
+			values->resize(properties.size());
+		}
+		const bool authorized = node->get_network_master() == p_from;
+
+		Variant *w = values->ptrw();
+		for (int i = 0; i < properties.size(); i++) {
+			const ReplicationProperty &property = properties[i];
+			if (!entity_reader.read_bits(1)) {
+				continue;
+			}
+
+			switch (property.hint) {
+				case REPLICATION_HINT_VECTOR3: {
+					const Vector3 base = w[i];
+					Vector3 v;
+					for (int k = 0; k < 3; k++) {
+						v[k] = ((int64_t)_replication_quantize_real(base[k], property.step) + entity_reader.read_int()) * property.step;
+					}
+					w[i] = v;
+				} break;
+				case REPLICATION_HINT_QUAT: {
+					w[i] = _replication_unpack_quat(entity_reader.read_bits(32));
+				} break;
+				default: {
+					entity_reader.align();
+					int len = 0;
+					Error err = _decode_and_decompress_variant(w[i], entity_reader.get_data(), entity_reader.get_remaining(), &len);
+					ERR_FAIL_COND_MSG(err != OK, "Invalid packet received. Unable to decode replicated property.");
+					entity_reader.skip_bytes(len);
+				}
+			}
+			ERR_FAIL_COND_MSG(entity_reader.has_error(), "Invalid packet received. Size smaller than declared.");
+
+			if (authorized) {
+				Update update;
+				update.node = node;
+				update.property = property.name;
+				update.value = w[i];
+				updates.push_back(update);
+			}
+		}
+	}
+	while (reader.read_bits(1)) {
+		state.erase(reader.read_uint());
+	}
+	ERR_FAIL_COND_MSG(reader.has_error(), "Invalid packet received. Size smaller than declared.");
+
+	const uint32_t slot = sequence % REPLICATION_HISTORY_SIZE;
+	received.last_applied = sequence;
+	received.sequences[slot] = sequence;
+	received.states[slot] = state;
+
+	LocalVector<uint8_t> ack;
+	ack.resize(5 + skipped.size() * 4);
+	ack[0] = NETWORK_COMMAND_REPLICATE_ACK;
+	encode_uint32(sequence, &ack[1]);
+	for (uint32_t i = 0; i < skipped.size(); i++) {
+		encode_uint32(skipped[i], &ack[5 + i * 4]);
+	}
+	network_peer->set_target_peer(p_from);
+	network_peer->set_transfer_mode(NetworkedMultiplayerPeer::TRANSFER_MODE_UNRELIABLE);
+	network_peer->put_packet(ack.ptr(), ack.size());
+
+	for (uint32_t i = 0; i < updates.size(); i++) {
+		updates[i].node->set(updates[i].property, updates[i].value);
+	}
+}
+
+void MultiplayerAPI::_process_replicate_ack(int p_from, const uint8_t *p_packet, int p_packet_len) {
+	ERR_FAIL_COND_MSG(p_packet_len < 5 || (p_packet_len - 5) % 4, "Invalid packet received. Wrong size.");
+
+	Map<int, ReplicationPeer>::Element *E = replication_peers.find(p_from);
+	if (!E) {
+		return;
+	}
+	ReplicationPeer &peer = E->get();
+	const uint32_t sequence = decode_uint32(&p_packet[1]);
+	if (sequence <= peer.acked || sequence > replication_sequence) {
+		return;
+	}
+
+	// The peer skipped these entities, so they are not part of the baseline it acknowledges.
+	const uint32_t slot = sequence % REPLICATION_HISTORY_SIZE;
+	if (peer.sequences[slot] == sequence) {
+		for (int i = 5; i < p_packet_len; i += 4) {
+			peer.sent[slot].erase(decode_uint32(&p_packet[i]));
+		}
+	}
+	peer.acked = sequence;
+}
+
+Error MultiplayerAPI::replication_add_property(Node *p_node, const StringName &p_property, ReplicationHint p_hint, real_t p_step) {
+	ERR_FAIL_NULL_V(p_node, ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V_MSG(p_hint == REPLICATION_HINT_VECTOR3 && p_step <= 0, ERR_INVALID_PARAMETER, "The quantization step must be greater than zero.");
+
+	ReplicationNode &replication = replication_nodes[p_node->get_instance_id()];
+	for (int i = 0; i < replication.properties.size(); i++) {
+		ERR_FAIL_COND_V_MSG(replication.properties[i].name == p_property, ERR_ALREADY_EXISTS, "Property '" + String(p_property) + "' is already replicated.");
+	}
+
+	ReplicationProperty property;
+	property.name = p_property;
+	property.hint = p_hint;
+	property.step = p_step;
+	replication.properties.push_back(property);
+	return OK;
+}
+
+void MultiplayerAPI::replication_remove_node(Node *p_node) {
+	ERR_FAIL_NULL(p_node);
+	replication_nodes.erase(p_node->get_instance_id());
+}
+
+void MultiplayerAPI::replication_set_visibility(Node *p_node, int p_peer, bool p_visible) {
+	ERR_FAIL_NULL(p_node);
+	Map<ObjectID, ReplicationNode>::Element *E = replication_nodes.find(p_node->get_instance_id());
+	ERR_FAIL_COND_MSG(!E, "Node '" + String(p_node->get_name()) + "' has no replicated properties.");
+	E->get().visibility[p_peer] = p_visible;
+}
+
+void MultiplayerAPI::replication_set_peer_interest(int p_peer, const Vector3 &p_origin, real_t p_radius) {
+	Map<int, ReplicationPeer>::Element *E = replication_peers.find(p_peer);
+	ERR_FAIL_COND_MSG(!E, "Peer " + itos(p_peer) + " is not connected.");
+	E->get().interest_origin = p_origin;
+	E->get().interest_radius = p_radius;
+}
+
+void MultiplayerAPI::replication_send() {
+	ERR_FAIL_COND_MSG(!network_peer.is_valid(), "Trying to replicate state while no network peer is active.");
+	ERR_FAIL_COND_MSG(root_node == nullptr, "Multiplayer root node was not initialized.");
+	if (network_peer->get_connection_status() != NetworkedMultiplayerPeer::CONNECTION_CONNECTED) {
+		return;
+	}
+	const int unique_id = network_peer->get_unique_id();
+
+	// Gather and quantize the state of the nodes we are master of.
+	LocalVector<ReplicationSource> sources;
+	List<ObjectID> freed;
+	for (Map<ObjectID, ReplicationNode>::Element *E = replication_nodes.front(); E; E = E->next()) {
+		Node *node = Object::cast_to<Node>(ObjectDB::get_instance(E->key()));
+		if (!node) {
+			freed.push_back(E->key());
+			continue;
+		}
+		if (node->get_network_master() != unique_id) {
+			continue;
+		}
+
+		ReplicationNode &replication = E->get();
+		if (replication.path.is_empty() || root_node->get_node_or_null(replication.path) != node) {
+			replication.path = root_node->get_path_to(node);
+			ERR_CONTINUE(replication.path.is_empty());
+		}
+
+		PathSentCache *psc = path_send_cache.getptr(replication.path);
+		if (!psc) {
+			path_send_cache[replication.path] = PathSentCache();
+			psc = path_send_cache.getptr(replication.path);
+			psc->id = last_send_cache_id++;
+		}
+
+		sources.resize(sources.size() + 1);
+		ReplicationSource &source = sources[sources.size() - 1];
+		source.id = psc->id;
+		source.node = node;
+		source.replication = &replication;
+		source.cache = psc;
+		source.values.resize(replication.properties.size());
+		for (int i = 0; i < replication.properties.size(); i++) {
+			const Variant value = _replication_quantize(replication.properties[i], node->get(replication.properties[i].name));
+			if (!source.has_origin && value.get_type() == Variant::VECTOR3) {
+				source.origin = value;
+				source.has_origin = true;
+			}
+			source.values.write[i] = value;
+		}
+	}
+	for (List<ObjectID>::Element *E = freed.front(); E; E = E->next()) {
+		replication_nodes.erase(E->get());
+	}
+	sources.sort();
+
+	replication_sequence++;
+	ReplicationSnapshot &snapshot = replication_history[replication_sequence % REPLICATION_HISTORY_SIZE];
+	snapshot.sequence = replication_sequence;
+	snapshot.entities.resize(sources.size());
+	for (uint32_t i = 0; i < sources.size(); i++) {
+		snapshot.entities[i].id = sources[i].id;
+		snapshot.entities[i].values = sources[i].values;
+	}
+
+	for (Map<int, ReplicationPeer>::Element *E = replication_peers.front(); E; E = E->next()) {
+		_replication_send_peer(E->key(), E->get(), sources);
+	}
+}
+
 void MultiplayerAPI::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_root_node", "node"), &MultiplayerAPI::set_root_node);
 	ClassDB::bind_method(D_METHOD("get_root_node"), &MultiplayerAPI::get_root_node);
@@ -1222,6 +1846,11 @@ void MultiplayerAPI::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("is_refusing_new_network_connections"), &MultiplayerAPI::is_refusing_new_network_connections);
 	ClassDB::bind_method(D_METHOD("set_allow_object_decoding", "enable"), &MultiplayerAPI::set_allow_object_decoding);
 	ClassDB::bind_method(D_METHOD("is_object_decoding_allowed"), &MultiplayerAPI::is_object_decoding_allowed);
+	ClassDB::bind_method(D_METHOD("replication_add_property", "node", "property", "hint", "step"), &MultiplayerAPI::replication_add_property, DEFVAL(REPLICATION_HINT_NONE), DEFVAL(0.001));
+	ClassDB::bind_method(D_METHOD("replication_remove_node", "node"), &MultiplayerAPI::replication_remove_node);
+	ClassDB::bind_method(D_METHOD("replication_set_visibility", "node", "peer", "visible"), &MultiplayerAPI::replication_set_visibility);
+	ClassDB::bind_method(D_METHOD("replication_set_peer_interest", "peer", "origin", "radius"), &MultiplayerAPI::replication_set_peer_interest);
+	ClassDB::bind_method(D_METHOD("replication_send"), &MultiplayerAPI::replication_send);
 
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "allow_object_decoding"), "set_allow_object_decoding", "is_object_decoding_allowed");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "refuse_new_network_connections"), "set_refuse_new_network_connections", "is_refusing_new_network_connections");
@@ -1243,6 +1872,10 @@ void MultiplayerAPI::_bind_methods() {
 	BIND_ENUM_CONSTANT(RPC_MODE_REMOTESYNC);
 	BIND_ENUM_CONSTANT(RPC_MODE_MASTERSYNC);
 	BIND_ENUM_CONSTANT(RPC_MODE_PUPPETSYNC);
+
+	BIND_ENUM_CONSTANT(REPLICATION_HINT_NONE);
+	BIND_ENUM_CONSTANT(REPLICATION_HINT_VECTOR3);
+	BIND_ENUM_CONSTANT(REPLICATION_HINT_QUAT);
 }
 
 MultiplayerAPI::MultiplayerAPI() {
@@ -33,10 +33,20 @@
 
 #include "core/io/networked_multiplayer_peer.h"
 #include "core/object/reference.h"
+#include "core/templates/local_vector.h"
+
+#define REPLICATION_HISTORY_SIZE 32
 
 class MultiplayerAPI : public Reference {
 	GDCLASS(MultiplayerAPI, Reference);
 
+public:
+	enum ReplicationHint {
+		REPLICATION_HINT_NONE, // Sent as a compressed variant whenever it changes.
+		REPLICATION_HINT_VECTOR3, // Quantized to a fixed step, delta against the baseline.
+		REPLICATION_HINT_QUAT, // Smallest three components, packed in 32 bits.
+	};
+
 private:
 	//path sent caches
 	struct PathSentCache {
@@ -64,6 +74,73 @@ private:
 	Node *root_node = nullptr;
 	bool allow_object_decoding = false;
 
+	// State replication.
+	struct ReplicationProperty {
+		StringName name;
+		ReplicationHint hint = REPLICATION_HINT_NONE;
+		real_t step = 0.001;
+	};
+
+	struct ReplicationNode {
+		Vector<ReplicationProperty> properties;
+		Map<int, bool> visibility; // Per peer override of the interest radius.
+		NodePath path; // Cached path relative to the root node.
+	};
+
+	struct ReplicationEntity {
+		uint32_t id = 0;
+		Vector<Variant> values;
+	};
+
+	struct ReplicationSnapshot {
+		uint32_t sequence = 0;
+		LocalVector<ReplicationEntity> entities; // Sorted by id.
+	};
+
+	// Sender state for each remote peer.
+	struct ReplicationPeer {
+		uint32_t acked = 0;
+		Vector3 interest_origin;
+		real_t interest_radius = 0;
+		uint32_t sequences[REPLICATION_HISTORY_SIZE] = {};
+		LocalVector<uint32_t> sent[REPLICATION_HISTORY_SIZE]; // Sorted ids known by the peer at each sequence.
+	};
+
+	// Receiver state for each remote sender.
+	struct ReplicationReceived {
+		uint32_t last_applied = 0;
+		uint32_t sequences[REPLICATION_HISTORY_SIZE] = {};
+		HashMap<uint32_t, Vector<Variant>> states[REPLICATION_HISTORY_SIZE];
+	};
+
+	// A node gathered for sending this tick.
+	struct ReplicationSource {
+		uint32_t id = 0;
+		Node *node = nullptr;
+		const ReplicationNode *replication = nullptr;
+		PathSentCache *cache = nullptr;
+		Vector3 origin;
+		bool has_origin = false;
+		Vector<Variant> values;
+
+		bool operator<(const ReplicationSource &p_other) const { return id < p_other.id; }
+	};
+
+	Map<ObjectID, ReplicationNode> replication_nodes;
+	Map<int, ReplicationPeer> replication_peers;
+	Map<int, ReplicationReceived> replication_received;
+	ReplicationSnapshot replication_history[REPLICATION_HISTORY_SIZE];
+	uint32_t replication_sequence = 0;
+	LocalVector<uint8_t> replication_buffer;
+	LocalVector<uint8_t> replication_entity_buffer;
+
+	Variant _replication_quantize(const ReplicationProperty &p_property, const Variant &p_value) const;
+	bool _replication_has_changed(const ReplicationProperty &p_property, const Variant &p_value, const Variant *p_base) const;
+	void _replication_send_peer(int p_peer, ReplicationPeer &p_state, const LocalVector<ReplicationSource> &p_sources);
+	Node *_replication_get_node(int p_from, uint32_t p_id);
+	void _process_replicate(int p_from, const uint8_t *p_packet, int p_packet_len);
+	void _process_replicate_ack(int p_from, const uint8_t *p_packet, int p_packet_len);
+
 protected:
 	static void _bind_methods();
 
@@ -88,6 +165,8 @@ public:
 		NETWORK_COMMAND_SIMPLIFY_PATH,
 		NETWORK_COMMAND_CONFIRM_PATH,
 		NETWORK_COMMAND_RAW,
+		NETWORK_COMMAND_REPLICATE,
+		NETWORK_COMMAND_REPLICATE_ACK,
 	};
 
 	enum NetworkNodeIdCompression {
@@ -141,10 +220,17 @@ public:
 	void set_allow_object_decoding(bool p_enable);
 	bool is_object_decoding_allowed() const;
 
+	Error replication_add_property(Node *p_node, const StringName &p_property, ReplicationHint p_hint = REPLICATION_HINT_NONE, real_t p_step = 0.001);
+	void replication_remove_node(Node *p_node);
+	void replication_set_visibility(Node *p_node, int p_peer, bool p_visible);
+	void replication_set_peer_interest(int p_peer, const Vector3 &p_origin, real_t p_radius);
+	void replication_send();
+
 	MultiplayerAPI();
 	~MultiplayerAPI();
 };
 
 VARIANT_ENUM_CAST(MultiplayerAPI::RPCMode);
+VARIANT_ENUM_CAST(MultiplayerAPI::ReplicationHint);
 
 #endif // MULTIPLAYER_API_H
@@ -0,0 +1,55 @@
+/*************************************************************************/
+/*  net_socket_reactor.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef NET_SOCKET_REACTOR_H
+#define NET_SOCKET_REACTOR_H
+
+#include "core/io/net_socket.h"
+#include "core/templates/local_vector.h"
+
+// Waits on many sockets at once, so servers with thousands of connections only
+// service the ones that are ready. Readiness is edge triggered: a socket is
+// only reported again once it has been read (or written) until it would block.
+class NetSocketReactor : public Reference {
+protected:
+	static NetSocketReactor *(*_create)();
+
+public:
+	// Returns nullptr if the platform has no reactor, poll each socket instead.
+	static NetSocketReactor *create();
+
+	virtual Error add_socket(const Ref<NetSocket> &p_sock, uint64_t p_id) = 0;
+	virtual void remove_socket(const Ref<NetSocket> &p_sock) = 0;
+	// Waits up to p_timeout msec (-1 for no limit), then appends the id of every
+	// socket which became readable or writable, or was closed, to r_ready.
+	virtual Error wait(int p_timeout, LocalVector<uint64_t> &r_ready) = 0;
+};
+
+#endif // NET_SOCKET_REACTOR_H
@@ -412,7 +412,7 @@ Resource::~Resource() {
 	}
 }
 
-HashMap<String, Resource *> ResourceCache::resources;
+FlatHashMap<String, Resource *> ResourceCache::resources;
 #ifdef TOOLS_ENABLED
 HashMap<String, HashMap<String, int>> ResourceCache::resource_path_cache;
 #endif
@@ -451,15 +451,13 @@ bool ResourceCache::has(const String &p_path) {
 Resource *ResourceCache::get(const String &p_path) {
 	lock.read_lock();
 
+	// Read the pointer under the lock, inserting may move the map's entries.
 	Resource **res = resources.getptr(p_path);
+	Resource *r = res ? *res : nullptr;
 
 	lock.read_unlock();
 
-	if (!res) {
-		return nullptr;
-	}
-
-	return *res;
+	return r;
 }
 
 void ResourceCache::get_cached_resources(List<Ref<Resource>> *p_resources) {
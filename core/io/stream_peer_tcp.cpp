@@ -292,6 +292,18 @@ Error StreamPeerTCP::poll(NetSocket::PollType p_type, int timeout) {
 	return _sock->poll(p_type, timeout);
 }
 
+Error StreamPeerTCP::add_to_reactor(Ref<NetSocketReactor> p_reactor, uint64_t p_id) {
+	ERR_FAIL_COND_V(p_reactor.is_null(), ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V(_sock.is_null() || !_sock->is_open(), ERR_UNAVAILABLE);
+	return p_reactor->add_socket(_sock, p_id);
+}
+
+void StreamPeerTCP::remove_from_reactor(Ref<NetSocketReactor> p_reactor) {
+	ERR_FAIL_COND(p_reactor.is_null());
+	ERR_FAIL_COND(_sock.is_null());
+	p_reactor->remove_socket(_sock);
+}
+
 Error StreamPeerTCP::put_data(const uint8_t *p_data, int p_bytes) {
 	int total;
 	return write(p_data, p_bytes, total, true);
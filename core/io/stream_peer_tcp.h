@@ -34,6 +34,7 @@
 #include "core/io/ip.h"
 #include "core/io/ip_address.h"
 #include "core/io/net_socket.h"
+#include "core/io/net_socket_reactor.h"
 #include "core/io/stream_peer.h"
 
 class StreamPeerTCP : public StreamPeer {
@@ -81,6 +82,11 @@ public:
 	// Poll functions (wait or check for writable, readable)
 	Error poll(NetSocket::PollType p_type, int timeout = 0);
 
+	// The reactor reports p_id when the connection is readable, writable or closed.
+	// Read (or write) until no more data is available before waiting again.
+	Error add_to_reactor(Ref<NetSocketReactor> p_reactor, uint64_t p_id);
+	void remove_from_reactor(Ref<NetSocketReactor> p_reactor);
+
 	// Read/Write from StreamPeer
 	Error put_data(const uint8_t *p_data, int p_bytes) override;
 	Error put_partial_data(const uint8_t *p_data, int p_bytes, int &r_sent) override;
@@ -118,6 +118,18 @@ Ref<StreamPeerTCP> TCPServer::take_connection() {
 	return conn;
 }
 
+Error TCPServer::add_to_reactor(Ref<NetSocketReactor> p_reactor, uint64_t p_id) {
+	ERR_FAIL_COND_V(p_reactor.is_null(), ERR_INVALID_PARAMETER);
+	ERR_FAIL_COND_V(!is_listening(), ERR_UNCONFIGURED);
+	return p_reactor->add_socket(_sock, p_id);
+}
+
+void TCPServer::remove_from_reactor(Ref<NetSocketReactor> p_reactor) {
+	ERR_FAIL_COND(p_reactor.is_null());
+	ERR_FAIL_COND(!_sock.is_valid());
+	p_reactor->remove_socket(_sock);
+}
+
 void TCPServer::stop() {
 	if (_sock.is_valid()) {
 		_sock->close();
@@ -33,6 +33,7 @@
 
 #include "core/io/ip.h"
 #include "core/io/net_socket.h"
+#include "core/io/net_socket_reactor.h"
 #include "core/io/stream_peer.h"
 #include "core/io/stream_peer_tcp.h"
 
@@ -54,6 +55,10 @@ public:
 	bool is_connection_available() const;
 	Ref<StreamPeerTCP> take_connection();
 
+	// The reactor reports p_id when connections are pending, take them until none is available.
+	Error add_to_reactor(Ref<NetSocketReactor> p_reactor, uint64_t p_id);
+	void remove_from_reactor(Ref<NetSocketReactor> p_reactor);
+
 	void stop(); // Stop listening
 
 	TCPServer();
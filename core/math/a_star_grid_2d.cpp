@@ -0,0 +1,780 @@
+/*************************************************************************/
+/*  a_star_grid_2d.cpp                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "a_star_grid_2d.h"
+
+#include "core/os/mutex.h"
+#include "core/templates/sort_array.h"
+#include "core/templates/thread_work_pool.h"
+
+static const int32_t grid_straight_directions[4][2] = { { 0, -1 }, { 1, 0 }, { 0, 1 }, { -1, 0 } };
+static const int32_t grid_diagonal_directions[4][2] = { { 1, -1 }, { 1, 1 }, { -1, 1 }, { -1, -1 } };
+
+void AStarGrid2D::set_size(const Vector2i &p_size) {
+	ERR_FAIL_COND(p_size.x < 0 || p_size.y < 0);
+	ERR_FAIL_COND_MSG((int64_t)p_size.x * (int64_t)p_size.y > INT32_MAX, "Grid is too large, the number of cells must fit in 32 bits.");
+
+	size = p_size;
+	uint32_t cell_count = size.x * size.y;
+
+	solid.resize(cell_count);
+	weight_scale.resize(cell_count);
+	clear();
+
+	// Search states are sized to the grid, let them reallocate on the next query.
+	search_states.reset();
+}
+
+Vector2i AStarGrid2D::get_size() const {
+	return size;
+}
+
+void AStarGrid2D::set_offset(const Vector2 &p_offset) {
+	offset = p_offset;
+}
+
+Vector2 AStarGrid2D::get_offset() const {
+	return offset;
+}
+
+void AStarGrid2D::set_cell_size(const Vector2 &p_cell_size) {
+	cell_size = p_cell_size;
+}
+
+Vector2 AStarGrid2D::get_cell_size() const {
+	return cell_size;
+}
+
+void AStarGrid2D::set_jumping_enabled(bool p_enabled) {
+	jumping_enabled = p_enabled;
+}
+
+bool AStarGrid2D::is_jumping_enabled() const {
+	return jumping_enabled;
+}
+
+void AStarGrid2D::set_diagonal_mode(DiagonalMode p_diagonal_mode) {
+	ERR_FAIL_INDEX((int)p_diagonal_mode, (int)DIAGONAL_MODE_MAX);
+	diagonal_mode = p_diagonal_mode;
+}
+
+AStarGrid2D::DiagonalMode AStarGrid2D::get_diagonal_mode() const {
+	return diagonal_mode;
+}
+
+void AStarGrid2D::set_default_heuristic(Heuristic p_heuristic) {
+	ERR_FAIL_INDEX((int)p_heuristic, (int)HEURISTIC_MAX);
+	default_heuristic = p_heuristic;
+}
+
+AStarGrid2D::Heuristic AStarGrid2D::get_default_heuristic() const {
+	return default_heuristic;
+}
+
+bool AStarGrid2D::is_in_bounds(int p_x, int p_y) const {
+	return p_x >= 0 && p_y >= 0 && p_x < size.x && p_y < size.y;
+}
+
+bool AStarGrid2D::is_in_boundsv(const Vector2i &p_id) const {
+	return is_in_bounds(p_id.x, p_id.y);
+}
+
+void AStarGrid2D::set_point_solid(const Vector2i &p_id, bool p_solid) {
+	ERR_FAIL_COND_MSG(!is_in_boundsv(p_id), vformat("Can't set if point is solid. Point out of bounds (%s/%s, %s/%s).", p_id.x, size.x, p_id.y, size.y));
+	solid[_get_cell(p_id.x, p_id.y)] = p_solid;
+}
+
+bool AStarGrid2D::is_point_solid(const Vector2i &p_id) const {
+	ERR_FAIL_COND_V_MSG(!is_in_boundsv(p_id), false, vformat("Can't get if point is solid. Point out of bounds (%s/%s, %s/%s).", p_id.x, size.x, p_id.y, size.y));
+	return solid[_get_cell(p_id.x, p_id.y)];
+}
+
+void AStarGrid2D::set_point_weight_scale(const Vector2i &p_id, real_t p_weight_scale) {
+	ERR_FAIL_COND_MSG(!is_in_boundsv(p_id), vformat("Can't set point's weight scale. Point out of bounds (%s/%s, %s/%s).", p_id.x, size.x, p_id.y, size.y));
+	ERR_FAIL_COND(p_weight_scale < 1);
+	weight_scale[_get_cell(p_id.x, p_id.y)] = p_weight_scale;
+}
+
+real_t AStarGrid2D::get_point_weight_scale(const Vector2i &p_id) const {
+	ERR_FAIL_COND_V_MSG(!is_in_boundsv(p_id), 0, vformat("Can't get point's weight scale. Point out of bounds (%s/%s, %s/%s).", p_id.x, size.x, p_id.y, size.y));
+	return weight_scale[_get_cell(p_id.x, p_id.y)];
+}
+
+void AStarGrid2D::fill_solid_region(const Rect2i &p_region, bool p_solid) {
+	Rect2i region = Rect2i(Point2i(), size).intersection(p_region);
+
+	for (int y = region.position.y; y < region.position.y + region.size.y; y++) {
+		uint8_t *row = solid.ptr() + _get_cell(region.position.x, y);
+		for (int x = 0; x < region.size.x; x++) {
+			row[x] = p_solid;
+		}
+	}
+}
+
+void AStarGrid2D::fill_weight_scale_region(const Rect2i &p_region, real_t p_weight_scale) {
+	ERR_FAIL_COND(p_weight_scale < 1);
+	Rect2i region = Rect2i(Point2i(), size).intersection(p_region);
+
+	for (int y = region.position.y; y < region.position.y + region.size.y; y++) {
+		real_t *row = weight_scale.ptr() + _get_cell(region.position.x, y);
+		for (int x = 0; x < region.size.x; x++) {
+			row[x] = p_weight_scale;
+		}
+	}
+}
+
+void AStarGrid2D::clear() {
+	for (uint32_t i = 0; i < solid.size(); i++) {
+		solid[i] = false;
+		weight_scale[i] = 1;
+	}
+}
+
+Vector2 AStarGrid2D::get_point_position(const Vector2i &p_id) const {
+	ERR_FAIL_COND_V_MSG(!is_in_boundsv(p_id), Vector2(), vformat("Can't get point's position. Point out of bounds (%s/%s, %s/%s).", p_id.x, size.x, p_id.y, size.y));
+	return offset + Vector2(p_id) * cell_size;
+}
+
+real_t AStarGrid2D::_estimate_cost(int32_t p_from, int32_t p_to) const {
+	real_t dx = ABS(p_to % size.x - p_from % size.x);
+	real_t dy = ABS(p_to / size.x - p_from / size.x);
+
+	switch (default_heuristic) {
+		case HEURISTIC_EUCLIDEAN: {
+			return Math::sqrt(dx * dx + dy * dy);
+		} break;
+		case HEURISTIC_MANHATTAN: {
+			return dx + dy;
+		} break;
+		case HEURISTIC_OCTILE: {
+			real_t f = Math_SQRT2 - 1;
+			return (dx < dy) ? f * dx + dy : f * dy + dx;
+		} break;
+		case HEURISTIC_CHEBYSHEV: {
+			return MAX(dx, dy);
+		} break;
+		default: {
+		} break;
+	}
+	return 0;
+}
+
+bool AStarGrid2D::_can_move_diagonally(int p_x, int p_y, int p_dx, int p_dy) const {
+	if (!_is_walkable(p_x + p_dx, p_y + p_dy)) {
+		return false;
+	}
+
+	switch (diagonal_mode) {
+		case DIAGONAL_MODE_ALWAYS: {
+			return true;
+		} break;
+		case DIAGONAL_MODE_AT_LEAST_ONE_WALKABLE: {
+			return _is_walkable(p_x + p_dx, p_y) || _is_walkable(p_x, p_y + p_dy);
+		} break;
+		case DIAGONAL_MODE_ONLY_IF_NO_OBSTACLES: {
+			return _is_walkable(p_x + p_dx, p_y) && _is_walkable(p_x, p_y + p_dy);
+		} break;
+		default: {
+		} break;
+	}
+	return false;
+}
+
+int AStarGrid2D::_get_neighbours(int32_t p_cell, int32_t *r_cells) const {
+	int x = p_cell % size.x;
+	int y = p_cell / size.x;
+	int count = 0;
+
+	for (int i = 0; i < 4; i++) {
+		int nx = x + grid_straight_directions[i][0];
+		int ny = y + grid_straight_directions[i][1];
+		if (_is_walkable(nx, ny)) {
+			r_cells[count++] = _get_cell(nx, ny);
+		}
+	}
+
+	if (diagonal_mode != DIAGONAL_MODE_NEVER) {
+		for (int i = 0; i < 4; i++) {
+			int dx = grid_diagonal_directions[i][0];
+			int dy = grid_diagonal_directions[i][1];
+			if (_can_move_diagonally(x, y, dx, dy)) {
+				r_cells[count++] = _get_cell(x + dx, y + dy);
+			}
+		}
+	}
+
+	return count;
+}
+
+// Neighbour pruning for jump point search. Only the walkable cells which can't be
+// reached more cheaply through the parent are kept, the rest is covered by the
+// parent's own jumps.
+int AStarGrid2D::_get_pruned_neighbours(int32_t p_cell, int32_t p_prev_cell, int32_t *r_cells) const {
+	if (p_prev_cell < 0) {
+		return _get_neighbours(p_cell, r_cells);
+	}
+
+	int x = p_cell % size.x;
+	int y = p_cell / size.x;
+	int dx = SGN(x - p_prev_cell % size.x);
+	int dy = SGN(y - p_prev_cell / size.x);
+	int count = 0;
+
+#define PUSH_NEIGHBOUR(m_x, m_y)                \
+	if (_is_walkable(m_x, m_y)) {               \
+		r_cells[count++] = _get_cell(m_x, m_y); \
+	}
+
+	switch (diagonal_mode) {
+		case DIAGONAL_MODE_ALWAYS: {
+			if (dx != 0 && dy != 0) {
+				PUSH_NEIGHBOUR(x, y + dy);
+				PUSH_NEIGHBOUR(x + dx, y);
+				PUSH_NEIGHBOUR(x + dx, y + dy);
+				if (!_is_walkable(x - dx, y)) {
+					PUSH_NEIGHBOUR(x - dx, y + dy);
+				}
+				if (!_is_walkable(x, y - dy)) {
+					PUSH_NEIGHBOUR(x + dx, y - dy);
+				}
+			} else if (dx == 0) {
+				PUSH_NEIGHBOUR(x, y + dy);
+				if (!_is_walkable(x + 1, y)) {
+					PUSH_NEIGHBOUR(x + 1, y + dy);
+				}
+				if (!_is_walkable(x - 1, y)) {
+					PUSH_NEIGHBOUR(x - 1, y + dy);
+				}
+			} else {
+				PUSH_NEIGHBOUR(x + dx, y);
+				if (!_is_walkable(x, y + 1)) {
+					PUSH_NEIGHBOUR(x + dx, y + 1);
+				}
+				if (!_is_walkable(x, y - 1)) {
+					PUSH_NEIGHBOUR(x + dx, y - 1);
+				}
+			}
+		} break;
+		case DIAGONAL_MODE_AT_LEAST_ONE_WALKABLE: {
+			if (dx != 0 && dy != 0) {
+				bool walk_x = _is_walkable(x + dx, y);
+				bool walk_y = _is_walkable(x, y + dy);
+				PUSH_NEIGHBOUR(x, y + dy);
+				PUSH_NEIGHBOUR(x + dx, y);
+				if (walk_x || walk_y) {
+					PUSH_NEIGHBOUR(x + dx, y + dy);
+				}
+				if (!_is_walkable(x - dx, y) && walk_y) {
+					PUSH_NEIGHBOUR(x - dx, y + dy);
+				}
+				if (!_is_walkable(x, y - dy) && walk_x) {
+					PUSH_NEIGHBOUR(x + dx, y - dy);
+				}
+			} else if (dx == 0) {
+				if (_is_walkable(x, y + dy)) {
+					PUSH_NEIGHBOUR(x, y + dy);
+					if (!_is_walkable(x + 1, y)) {
+						PUSH_NEIGHBOUR(x + 1, y + dy);
+					}
+					if (!_is_walkable(x - 1, y)) {
+						PUSH_NEIGHBOUR(x - 1, y + dy);
+					}
+				}
+			} else {
+				if (_is_walkable(x + dx, y)) {
+					PUSH_NEIGHBOUR(x + dx, y);
+					if (!_is_walkable(x, y + 1)) {
+						PUSH_NEIGHBOUR(x + dx, y + 1);
+					}
+					if (!_is_walkable(x, y - 1)) {
+						PUSH_NEIGHBOUR(x + dx, y - 1);
+					}
+				}
+			}
+		} break;
+		case DIAGONAL_MODE_ONLY_IF_NO_OBSTACLES: {
+			if (dx != 0 && dy != 0) {
+				bool walk_x = _is_walkable(x + dx, y);
+				bool walk_y = _is_walkable(x, y + dy);
+				PUSH_NEIGHBOUR(x, y + dy);
+				PUSH_NEIGHBOUR(x + dx, y);
+				if (walk_x && walk_y) {
+					PUSH_NEIGHBOUR(x + dx, y + dy);
+				}
+			} else if (dx == 0) {
+				bool walk_next = _is_walkable(x, y + dy);
+				bool walk_right = _is_walkable(x + 1, y);
+				bool walk_left = _is_walkable(x - 1, y);
+				if (walk_next) {
+					PUSH_NEIGHBOUR(x, y + dy);
+					if (walk_right) {
+						PUSH_NEIGHBOUR(x + 1, y + dy);
+					}
+					if (walk_left) {
+						PUSH_NEIGHBOUR(x - 1, y + dy);
+					}
+				}
+				PUSH_NEIGHBOUR(x + 1, y);
+				PUSH_NEIGHBOUR(x - 1, y);
+			} else {
+				bool walk_next = _is_walkable(x + dx, y);
+				bool walk_top = _is_walkable(x, y - 1);
+				bool walk_bottom = _is_walkable(x, y + 1);
+				if (walk_next) {
+					PUSH_NEIGHBOUR(x + dx, y);
+					if (walk_top) {
+						PUSH_NEIGHBOUR(x + dx, y - 1);
+					}
+					if (walk_bottom) {
+						PUSH_NEIGHBOUR(x + dx, y + 1);
+					}
+				}
+				PUSH_NEIGHBOUR(x, y - 1);
+				PUSH_NEIGHBOUR(x, y + 1);
+			}
+		} break;
+		case DIAGONAL_MODE_NEVER: {
+			if (dx != 0) {
+				PUSH_NEIGHBOUR(x, y - 1);
+				PUSH_NEIGHBOUR(x, y + 1);
+				PUSH_NEIGHBOUR(x + dx, y);
+			} else {
+				PUSH_NEIGHBOUR(x - 1, y);
+				PUSH_NEIGHBOUR(x + 1, y);
+				PUSH_NEIGHBOUR(x, y + dy);
+			}
+		} break;
+		default: {
+		} break;
+	}
+
+#undef PUSH_NEIGHBOUR
+
+	return count;
+}
+
+// Walks from (p_x, p_y) in the given direction and returns the first cell which has
+// a forced neighbour (or is the end cell), or -1 if the walk runs into an obstacle.
+int32_t AStarGrid2D::_jump(int p_x, int p_y, int p_dx, int p_dy, int32_t p_end) const {
+	int x = p_x;
+	int y = p_y;
+	bool corner_cutting = diagonal_mode == DIAGONAL_MODE_ALWAYS || diagonal_mode == DIAGONAL_MODE_AT_LEAST_ONE_WALKABLE;
+
+	while (true) {
+		if (!_is_walkable(x, y)) {
+			return -1;
+		}
+
+		int32_t cell = _get_cell(x, y);
+		if (cell == p_end) {
+			return cell;
+		}
+
+		if (p_dx != 0 && p_dy != 0) {
+			if (corner_cutting) {
+				if ((_is_walkable(x - p_dx, y + p_dy) && !_is_walkable(x - p_dx, y)) || (_is_walkable(x + p_dx, y - p_dy) && !_is_walkable(x, y - p_dy))) {
+					return cell;
+				}
+			}
+			// Moving diagonally, look for jump points along both straight directions.
+			if (_jump(x + p_dx, y, p_dx, 0, p_end) >= 0 || _jump(x, y + p_dy, 0, p_dy, p_end) >= 0) {
+				return cell;
+			}
+			if (diagonal_mode == DIAGONAL_MODE_AT_LEAST_ONE_WALKABLE && !_is_walkable(x + p_dx, y) && !_is_walkable(x, y + p_dy)) {
+				return -1;
+			}
+			if (diagonal_mode == DIAGONAL_MODE_ONLY_IF_NO_OBSTACLES && (!_is_walkable(x + p_dx, y) || !_is_walkable(x, y + p_dy))) {
+				return -1;
+			}
+		} else if (p_dx != 0) {
+			if (corner_cutting) {
+				if ((_is_walkable(x + p_dx, y + 1) && !_is_walkable(x, y + 1)) || (_is_walkable(x + p_dx, y - 1) && !_is_walkable(x, y - 1))) {
+					return cell;
+				}
+			} else if ((_is_walkable(x, y - 1) && !_is_walkable(x - p_dx, y - 1)) || (_is_walkable(x, y + 1) && !_is_walkable(x - p_dx, y + 1))) {
+				return cell;
+			}
+		} else {
+			if (corner_cutting) {
+				if ((_is_walkable(x + 1, y + p_dy) && !_is_walkable(x + 1, y)) || (_is_walkable(x - 1, y + p_dy) && !_is_walkable(x - 1, y))) {
+					return cell;
+				}
+			} else {
+				if ((_is_walkable(x - 1, y) && !_is_walkable(x - 1, y - p_dy)) || (_is_walkable(x + 1, y) && !_is_walkable(x + 1, y - p_dy))) {
+					return cell;
+				}
+				if (diagonal_mode == DIAGONAL_MODE_NEVER) {
+					// Without diagonals, vertical walks must also look for horizontal jump points.
+					if (_jump(x + 1, y, 1, 0, p_end) >= 0 || _jump(x - 1, y, -1, 0, p_end) >= 0) {
+						return cell;
+					}
+				}
+			}
+		}
+
+		x += p_dx;
+		y += p_dy;
+	}
+}
+
+void AStarGrid2D::_prepare_search_state(SearchState &r_state) const {
+	uint32_t cell_count = solid.size();
+
+	if (r_state.g_score.size() != cell_count) {
+		r_state.g_score.resize(cell_count);
+		r_state.prev_cell.resize(cell_count);
+		r_state.pass_stamp.resize(cell_count);
+		r_state.pass = 0;
+	}
+
+	r_state.pass++;
+	if (r_state.pass == 1 || r_state.pass > (UINT32_MAX >> 1)) {
+		// First use or the stamps are about to wrap around, start over.
+		for (uint32_t i = 0; i < cell_count; i++) {
+			r_state.pass_stamp[i] = 0;
+		}
+		r_state.pass = 1;
+	}
+}
+
+bool AStarGrid2D::_solve(SearchState &r_state, int32_t p_from, int32_t p_to) const {
+	_prepare_search_state(r_state);
+
+	if (solid[p_to]) {
+		return false;
+	}
+
+	const uint32_t open_stamp = r_state.pass << 1;
+	real_t *g_score = r_state.g_score.ptr();
+	int32_t *prev_cell = r_state.prev_cell.ptr();
+	uint32_t *pass_stamp = r_state.pass_stamp.ptr();
+	LocalVector<OpenEntry> &open_list = r_state.open_list;
+	SortArray<OpenEntry, SortOpenEntries> sorter;
+
+	open_list.clear();
+
+	g_score[p_from] = 0;
+	prev_cell[p_from] = -1;
+	pass_stamp[p_from] = open_stamp;
+
+	OpenEntry begin;
+	begin.f_score = _estimate_cost(p_from, p_to);
+	begin.cell = p_from;
+	open_list.push_back(begin);
+
+	int32_t neighbours[8];
+
+	while (!open_list.is_empty()) {
+		OpenEntry e = open_list[0]; // The currently processed entry.
+
+		sorter.pop_heap(0, open_list.size(), open_list.ptr()); // Remove the current entry from the open list.
+		open_list.resize(open_list.size() - 1);
+
+		if (pass_stamp[e.cell] & 1) {
+			continue; // Stale entry, the cell was already closed through a cheaper one.
+		}
+		if (e.cell == p_to) {
+			return true;
+		}
+		pass_stamp[e.cell] |= 1; // Mark the cell as closed.
+
+		int x = e.cell % size.x;
+		int y = e.cell / size.x;
+		int count = jumping_enabled ? _get_pruned_neighbours(e.cell, prev_cell[e.cell], neighbours) : _get_neighbours(e.cell, neighbours);
+
+		for (int i = 0; i < count; i++) {
+			int nx = neighbours[i] % size.x;
+			int ny = neighbours[i] / size.x;
+			int dx = nx - x;
+			int dy = ny - y;
+			real_t step = (dx != 0 && dy != 0) ? Math_SQRT2 : 1.0;
+
+			int32_t next;
+			real_t cost;
+			if (jumping_enabled) {
+				next = _jump(nx, ny, dx, dy, p_to);
+				if (next < 0) {
+					continue;
+				}
+				cost = step * MAX(ABS(next % size.x - x), ABS(next / size.x - y));
+			} else {
+				next = neighbours[i];
+				cost = step * weight_scale[next];
+			}
+
+			real_t tentative_g_score = e.g_score + cost;
+
+			if ((pass_stamp[next] >> 1) == r_state.pass) {
+				if ((pass_stamp[next] & 1) || tentative_g_score >= g_score[next]) {
+					continue; // Closed, or the new path is worse than the previous.
+				}
+			} else {
+				pass_stamp[next] = open_stamp;
+			}
+
+			g_score[next] = tentative_g_score;
+			prev_cell[next] = e.cell;
+
+			// The old entry of an improved cell is left in the heap and skipped once closed.
+			OpenEntry n;
+			n.f_score = tentative_g_score + _estimate_cost(next, p_to);
+			n.g_score = tentative_g_score;
+			n.cell = next;
+			open_list.push_back(n);
+			sorter.push_heap(0, open_list.size() - 1, 0, n, open_list.ptr());
+		}
+	}
+
+	return false;
+}
+
+void AStarGrid2D::_find_path(SearchState &r_state, const Vector2i &p_from, const Vector2i &p_to, Vector<Vector2i> &r_path) const {
+	r_path.clear();
+
+	ERR_FAIL_COND_MSG(!is_in_boundsv(p_from), vformat("Can't get id path. Point out of bounds (%s/%s, %s/%s).", p_from.x, size.x, p_from.y, size.y));
+	ERR_FAIL_COND_MSG(!is_in_boundsv(p_to), vformat("Can't get id path. Point out of bounds (%s/%s, %s/%s).", p_to.x, size.x, p_to.y, size.y));
+
+	int32_t from_cell = _get_cell(p_from.x, p_from.y);
+	int32_t to_cell = _get_cell(p_to.x, p_to.y);
+
+	if (from_cell == to_cell) {
+		r_path.push_back(p_from);
+		return;
+	}
+
+	if (!_solve(r_state, from_cell, to_cell)) {
+		return;
+	}
+
+	const int32_t *prev_cell = r_state.prev_cell.ptr();
+
+	// Consecutive cells in the chain may be a jump apart, count the cells in between too.
+	int pc = 1;
+	for (int32_t c = to_cell; prev_cell[c] >= 0; c = prev_cell[c]) {
+		int32_t p = prev_cell[c];
+		pc += MAX(ABS(c % size.x - p % size.x), ABS(c / size.x - p / size.x));
+	}
+
+	r_path.resize(pc);
+	Vector2i *w = r_path.ptrw();
+	int idx = pc - 1;
+
+	Vector2i pos = p_to;
+	w[idx] = pos;
+	for (int32_t c = to_cell; prev_cell[c] >= 0; c = prev_cell[c]) {
+		int32_t p = prev_cell[c];
+		Vector2i prev_pos = Vector2i(p % size.x, p / size.x);
+		Vector2i step = Vector2i(SGN(prev_pos.x - pos.x), SGN(prev_pos.y - pos.y));
+		while (pos != prev_pos) {
+			pos += step;
+			w[--idx] = pos;
+		}
+	}
+}
+
+void AStarGrid2D::_find_paths_work(uint32_t p_index, BatchQuery *p_query) {
+	SearchState &state = search_states[p_index];
+
+	while (true) {
+		uint32_t i = p_query->next.fetch_add(1, std::memory_order_relaxed);
+		if (i >= p_query->count) {
+			break;
+		}
+		_find_path(state, p_query->from[i], p_query->to[i], p_query->paths[i]);
+	}
+}
+
+Vector<Vector2i> AStarGrid2D::find_path(const Vector2i &p_from_id, const Vector2i &p_to_id) {
+	if (search_states.is_empty()) {
+		search_states.resize(1);
+	}
+
+	Vector<Vector2i> path;
+	_find_path(search_states[0], p_from_id, p_to_id, path);
+	return path;
+}
+
+static ThreadWorkPool *a_star_grid_2d_work_pool = nullptr;
+static BinaryMutex a_star_grid_2d_work_pool_mutex;
+
+void AStarGrid2D::finish_work_pool() {
+	MutexLock lock(a_star_grid_2d_work_pool_mutex);
+	if (a_star_grid_2d_work_pool) {
+		a_star_grid_2d_work_pool->finish();
+		memdelete(a_star_grid_2d_work_pool);
+		a_star_grid_2d_work_pool = nullptr;
+	}
+}
+
+void AStarGrid2D::find_paths(const Vector<Vector2i> &p_from_ids, const Vector<Vector2i> &p_to_ids, Vector<Vector<Vector2i>> &r_paths) {
+	ERR_FAIL_COND_MSG(p_from_ids.size() != p_to_ids.size(), "The number of start and end points must be the same.");
+
+	r_paths.resize(p_from_ids.size());
+	if (r_paths.is_empty()) {
+		return;
+	}
+
+	BatchQuery query;
+	query.from = p_from_ids.ptr();
+	query.to = p_to_ids.ptr();
+	query.paths = r_paths.ptrw();
+	query.count = r_paths.size();
+	query.next.store(0);
+
+	if (search_states.is_empty()) {
+		search_states.resize(1);
+	}
+
+#ifndef NO_THREADS
+	// Another batch may hold the pool, this one then runs on the calling thread.
+	if (r_paths.size() > 1 && a_star_grid_2d_work_pool_mutex.try_lock() == OK) {
+		if (!a_star_grid_2d_work_pool) {
+			a_star_grid_2d_work_pool = memnew(ThreadWorkPool);
+			a_star_grid_2d_work_pool->init();
+		}
+
+		// One search state per worker, the queries themselves are handed out one at a time.
+		uint32_t state_count = MIN((uint32_t)r_paths.size(), (uint32_t)MAX(a_star_grid_2d_work_pool->get_thread_count(), 1));
+		if (state_count > 1) {
+			search_states.resize(state_count);
+			a_star_grid_2d_work_pool->do_work(state_count, this, &AStarGrid2D::_find_paths_work, &query);
+		}
+		a_star_grid_2d_work_pool_mutex.unlock();
+
+		// The extra states are as large as the grid, don't hold on to them.
+		search_states.resize(1);
+	}
+#endif
+
+	// Runs the batch when the pool wasn't used, there is nothing left otherwise.
+	_find_paths_work(0, &query);
+}
+
+TypedArray<Vector2i> AStarGrid2D::get_id_path(const Vector2i &p_from_id, const Vector2i &p_to_id) {
+	Vector<Vector2i> path = find_path(p_from_id, p_to_id);
+
+	TypedArray<Vector2i> ret;
+	ret.resize(path.size());
+	for (int i = 0; i < path.size(); i++) {
+		ret[i] = path[i];
+	}
+	return ret;
+}
+
+Vector<Vector2> AStarGrid2D::get_point_path(const Vector2i &p_from_id, const Vector2i &p_to_id) {
+	Vector<Vector2i> path = find_path(p_from_id, p_to_id);
+
+	Vector<Vector2> ret;
+	ret.resize(path.size());
+	Vector2 *w = ret.ptrw();
+	for (int i = 0; i < path.size(); i++) {
+		w[i] = offset + Vector2(path[i]) * cell_size;
+	}
+	return ret;
+}
+
+Array AStarGrid2D::get_point_paths(const TypedArray<Vector2i> &p_from_ids, const TypedArray<Vector2i> &p_to_ids) {
+	ERR_FAIL_COND_V_MSG(p_from_ids.size() != p_to_ids.size(), Array(), "The number of start and end points must be the same.");
+
+	Vector<Vector2i> from_ids;
+	Vector<Vector2i> to_ids;
+	from_ids.resize(p_from_ids.size());
+	to_ids.resize(p_to_ids.size());
+	for (int i = 0; i < p_from_ids.size(); i++) {
+		from_ids.write[i] = p_from_ids[i];
+		to_ids.write[i] = p_to_ids[i];
+	}
+
+	Vector<Vector<Vector2i>> paths;
+	find_paths(from_ids, to_ids, paths);
+
+	Array ret;
+	ret.resize(paths.size());
+	for (int i = 0; i < paths.size(); i++) {
+		const Vector<Vector2i> &path = paths[i];
+		Vector<Vector2> points;
+		points.resize(path.size());
+		Vector2 *w = points.ptrw();
+		for (int j = 0; j < path.size(); j++) {
+			w[j] = offset + Vector2(path[j]) * cell_size;
+		}
+		ret[i] = points;
+	}
+	return ret;
+}
+
+void AStarGrid2D::_bind_methods() {
+	ClassDB::bind_method(D_METHOD("set_size", "size"), &AStarGrid2D::set_size);
+	ClassDB::bind_method(D_METHOD("get_size"), &AStarGrid2D::get_size);
+	ClassDB::bind_method(D_METHOD("set_offset", "offset"), &AStarGrid2D::set_offset);
+	ClassDB::bind_method(D_METHOD("get_offset"), &AStarGrid2D::get_offset);
+	ClassDB::bind_method(D_METHOD("set_cell_size", "cell_size"), &AStarGrid2D::set_cell_size);
+	ClassDB::bind_method(D_METHOD("get_cell_size"), &AStarGrid2D::get_cell_size);
+	ClassDB::bind_method(D_METHOD("set_jumping_enabled", "enabled"), &AStarGrid2D::set_jumping_enabled);
+	ClassDB::bind_method(D_METHOD("is_jumping_enabled"), &AStarGrid2D::is_jumping_enabled);
+	ClassDB::bind_method(D_METHOD("set_diagonal_mode", "mode"), &AStarGrid2D::set_diagonal_mode);
+	ClassDB::bind_method(D_METHOD("get_diagonal_mode"), &AStarGrid2D::get_diagonal_mode);
+	ClassDB::bind_method(D_METHOD("set_default_heuristic", "heuristic"), &AStarGrid2D::set_default_heuristic);
+	ClassDB::bind_method(D_METHOD("get_default_heuristic"), &AStarGrid2D::get_default_heuristic);
+
+	ClassDB::bind_method(D_METHOD("is_in_bounds", "x", "y"), &AStarGrid2D::is_in_bounds);
+	ClassDB::bind_method(D_METHOD("is_in_boundsv", "id"), &AStarGrid2D::is_in_boundsv);
+	ClassDB::bind_method(D_METHOD("set_point_solid", "id", "solid"), &AStarGrid2D::set_point_solid, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("is_point_solid", "id"), &AStarGrid2D::is_point_solid);
+	ClassDB::bind_method(D_METHOD("set_point_weight_scale", "id", "weight_scale"), &AStarGrid2D::set_point_weight_scale);
+	ClassDB::bind_method(D_METHOD("get_point_weight_scale", "id"), &AStarGrid2D::get_point_weight_scale);
+	ClassDB::bind_method(D_METHOD("fill_solid_region", "region", "solid"), &AStarGrid2D::fill_solid_region, DEFVAL(true));
+	ClassDB::bind_method(D_METHOD("fill_weight_scale_region", "region", "weight_scale"), &AStarGrid2D::fill_weight_scale_region);
+	ClassDB::bind_method(D_METHOD("clear"), &AStarGrid2D::clear);
+
+	ClassDB::bind_method(D_METHOD("get_point_position", "id"), &AStarGrid2D::get_point_position);
+	ClassDB::bind_method(D_METHOD("get_id_path", "from_id", "to_id"), &AStarGrid2D::get_id_path);
+	ClassDB::bind_method(D_METHOD("get_point_path", "from_id", "to_id"), &AStarGrid2D::get_point_path);
+	ClassDB::bind_method(D_METHOD("get_point_paths", "from_ids", "to_ids"), &AStarGrid2D::get_point_paths);
+
+	ADD_PROPERTY(PropertyInfo(Variant::VECTOR2I, "size"), "set_size", "get_size");
+	ADD_PROPERTY(PropertyInfo(Variant::VECTOR2, "offset"), "set_offset", "get_offset");
+	ADD_PROPERTY(PropertyInfo(Variant::VECTOR2, "cell_size"), "set_cell_size", "get_cell_size");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "jumping_enabled"), "set_jumping_enabled", "is_jumping_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "diagonal_mode", PROPERTY_HINT_ENUM, "Always,Never,At Least One Walkable,Only If No Obstacles"), "set_diagonal_mode", "get_diagonal_mode");
+	ADD_PROPERTY(PropertyInfo(Variant::INT, "default_heuristic", PROPERTY_HINT_ENUM, "Euclidean,Manhattan,Octile,Chebyshev"), "set_default_heuristic", "get_default_heuristic");
+
+	BIND_ENUM_CONSTANT(HEURISTIC_EUCLIDEAN);
+	BIND_ENUM_CONSTANT(HEURISTIC_MANHATTAN);
+	BIND_ENUM_CONSTANT(HEURISTIC_OCTILE);
+	BIND_ENUM_CONSTANT(HEURISTIC_CHEBYSHEV);
+	BIND_ENUM_CONSTANT(HEURISTIC_MAX);
+
+	BIND_ENUM_CONSTANT(DIAGONAL_MODE_ALWAYS);
+	BIND_ENUM_CONSTANT(DIAGONAL_MODE_NEVER);
+	BIND_ENUM_CONSTANT(DIAGONAL_MODE_AT_LEAST_ONE_WALKABLE);
+	BIND_ENUM_CONSTANT(DIAGONAL_MODE_ONLY_IF_NO_OBSTACLES);
+	BIND_ENUM_CONSTANT(DIAGONAL_MODE_MAX);
+}
@@ -0,0 +1,187 @@
+/*************************************************************************/
+/*  a_star_grid_2d.h                                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef A_STAR_GRID_2D_H
+#define A_STAR_GRID_2D_H
+
+#include "core/math/rect2.h"
+#include "core/object/reference.h"
+#include "core/templates/local_vector.h"
+#include "core/variant/typed_array.h"
+
+/**
+	A* pathfinding on a dense grid of cells.
+
+	Passability and weights are kept in flat arrays indexed by cell, and the
+	per-query bookkeeping lives in reusable search states, so no per-point
+	allocations happen while building or querying the grid.
+*/
+
+class AStarGrid2D : public Reference {
+	GDCLASS(AStarGrid2D, Reference);
+
+public:
+	enum Heuristic {
+		HEURISTIC_EUCLIDEAN,
+		HEURISTIC_MANHATTAN,
+		HEURISTIC_OCTILE,
+		HEURISTIC_CHEBYSHEV,
+		HEURISTIC_MAX,
+	};
+
+	enum DiagonalMode {
+		DIAGONAL_MODE_ALWAYS,
+		DIAGONAL_MODE_NEVER,
+		DIAGONAL_MODE_AT_LEAST_ONE_WALKABLE,
+		DIAGONAL_MODE_ONLY_IF_NO_OBSTACLES,
+		DIAGONAL_MODE_MAX,
+	};
+
+private:
+	struct OpenEntry {
+		real_t f_score = 0;
+		real_t g_score = 0;
+		int32_t cell = 0;
+	};
+
+	struct SortOpenEntries {
+		_FORCE_INLINE_ bool operator()(const OpenEntry &A, const OpenEntry &B) const { // Returns true when the entry A is worse than entry B.
+			if (A.f_score > B.f_score) {
+				return true;
+			} else if (A.f_score < B.f_score) {
+				return false;
+			} else {
+				return A.g_score < B.g_score; // If the f_costs are the same then prioritize the cells that are further away from the start.
+			}
+		}
+	};
+
+	// Scratch data for one query at a time, sized to the grid.
+	struct SearchState {
+		LocalVector<real_t> g_score;
+		LocalVector<int32_t> prev_cell;
+		LocalVector<uint32_t> pass_stamp; // (pass << 1) | closed.
+		LocalVector<OpenEntry> open_list;
+		uint32_t pass = 0;
+	};
+
+	struct BatchQuery {
+		const Vector2i *from = nullptr;
+		const Vector2i *to = nullptr;
+		Vector<Vector2i> *paths = nullptr;
+		uint32_t count = 0;
+		std::atomic<uint32_t> next;
+	};
+
+	Vector2i size;
+	Vector2 offset;
+	Vector2 cell_size = Vector2(1, 1);
+	bool jumping_enabled = false;
+	DiagonalMode diagonal_mode = DIAGONAL_MODE_ALWAYS;
+	Heuristic default_heuristic = HEURISTIC_EUCLIDEAN;
+
+	LocalVector<uint8_t> solid;
+	LocalVector<real_t> weight_scale;
+
+	// The first state is kept for the next queries, the others only live for
+	// the batch they were made for.
+	LocalVector<SearchState> search_states;
+
+	_FORCE_INLINE_ int32_t _get_cell(int p_x, int p_y) const { return p_y * size.x + p_x; }
+	_FORCE_INLINE_ bool _is_walkable(int p_x, int p_y) const {
+		return p_x >= 0 && p_y >= 0 && p_x < size.x && p_y < size.y && !solid[_get_cell(p_x, p_y)];
+	}
+	_FORCE_INLINE_ bool _can_move_diagonally(int p_x, int p_y, int p_dx, int p_dy) const;
+
+	real_t _estimate_cost(int32_t p_from, int32_t p_to) const;
+	int32_t _jump(int p_x, int p_y, int p_dx, int p_dy, int32_t p_end) const;
+	int _get_neighbours(int32_t p_cell, int32_t *r_cells) const;
+	int _get_pruned_neighbours(int32_t p_cell, int32_t p_prev_cell, int32_t *r_cells) const;
+
+	void _prepare_search_state(SearchState &r_state) const;
+	bool _solve(SearchState &r_state, int32_t p_from, int32_t p_to) const;
+	void _find_path(SearchState &r_state, const Vector2i &p_from, const Vector2i &p_to, Vector<Vector2i> &r_path) const;
+	void _find_paths_work(uint32_t p_index, BatchQuery *p_query);
+
+protected:
+	static void _bind_methods();
+
+public:
+	void set_size(const Vector2i &p_size);
+	Vector2i get_size() const;
+
+	void set_offset(const Vector2 &p_offset);
+	Vector2 get_offset() const;
+
+	void set_cell_size(const Vector2 &p_cell_size);
+	Vector2 get_cell_size() const;
+
+	void set_jumping_enabled(bool p_enabled);
+	bool is_jumping_enabled() const;
+
+	void set_diagonal_mode(DiagonalMode p_diagonal_mode);
+	DiagonalMode get_diagonal_mode() const;
+
+	void set_default_heuristic(Heuristic p_heuristic);
+	Heuristic get_default_heuristic() const;
+
+	bool is_in_bounds(int p_x, int p_y) const;
+	bool is_in_boundsv(const Vector2i &p_id) const;
+
+	void set_point_solid(const Vector2i &p_id, bool p_solid = true);
+	bool is_point_solid(const Vector2i &p_id) const;
+
+	void set_point_weight_scale(const Vector2i &p_id, real_t p_weight_scale);
+	real_t get_point_weight_scale(const Vector2i &p_id) const;
+
+	void fill_solid_region(const Rect2i &p_region, bool p_solid = true);
+	void fill_weight_scale_region(const Rect2i &p_region, real_t p_weight_scale);
+
+	void clear();
+
+	Vector2 get_point_position(const Vector2i &p_id) const;
+
+	Vector<Vector2i> find_path(const Vector2i &p_from_id, const Vector2i &p_to_id);
+	void find_paths(const Vector<Vector2i> &p_from_ids, const Vector<Vector2i> &p_to_ids, Vector<Vector<Vector2i>> &r_paths);
+
+	TypedArray<Vector2i> get_id_path(const Vector2i &p_from_id, const Vector2i &p_to_id);
+	Vector<Vector2> get_point_path(const Vector2i &p_from_id, const Vector2i &p_to_id);
+	Array get_point_paths(const TypedArray<Vector2i> &p_from_ids, const TypedArray<Vector2i> &p_to_ids);
+
+	static void finish_work_pool();
+
+	AStarGrid2D() {}
+	~AStarGrid2D() {}
+};
+
+VARIANT_ENUM_CAST(AStarGrid2D::Heuristic);
+VARIANT_ENUM_CAST(AStarGrid2D::DiagonalMode);
+
+#endif // A_STAR_GRID_2D_H
@@ -35,6 +35,7 @@
 #include "core/object/class_db.h"
 #include "core/object/reference.h"
 #include "core/os/os.h"
+#include "core/variant/variant_internal.h"
 #include "core/variant/variant_parser.h"
 
 static bool _is_number(char32_t c) {
@@ -1381,7 +1382,419 @@ bool Expression::_execute(const Array &p_inputs, Object *p_instance, Expression:
 	return false;
 }
 
+int Expression::_compile_node(ENode *p_node, int p_slot) {
+	switch (p_node->type) {
+		case ENode::TYPE_INPUT: {
+			const InputNode *in = static_cast<const InputNode *>(p_node);
+			return (ADDRESS_INPUT << ADDRESS_BITS) | in->index;
+		}
+		case ENode::TYPE_CONSTANT: {
+			const ConstantNode *c = static_cast<const ConstantNode *>(p_node);
+			program_constants.push_back(c->value);
+			return (ADDRESS_CONSTANT << ADDRESS_BITS) | (program_constants.size() - 1);
+		}
+		default: {
+		}
+	}
+
+	Instruction instruction;
+	instruction.target = p_slot;
+	LocalVector<ENode *> children;
+
+	switch (p_node->type) {
+		case ENode::TYPE_SELF: {
+			instruction.opcode = OPCODE_SELF;
+		} break;
+		case ENode::TYPE_OPERATOR: {
+			const OperatorNode *op = static_cast<const OperatorNode *>(p_node);
+			instruction.opcode = OPCODE_OPERATOR;
+			instruction.op = op->op;
+			children.push_back(op->nodes[0]);
+			if (op->nodes[1]) {
+				children.push_back(op->nodes[1]);
+			}
+		} break;
+		case ENode::TYPE_INDEX: {
+			const IndexNode *index = static_cast<const IndexNode *>(p_node);
+			instruction.opcode = OPCODE_INDEX;
+			children.push_back(index->base);
+			children.push_back(index->index);
+		} break;
+		case ENode::TYPE_NAMED_INDEX: {
+			const NamedIndexNode *index = static_cast<const NamedIndexNode *>(p_node);
+			instruction.opcode = OPCODE_NAMED_INDEX;
+			instruction.name = index->name;
+			children.push_back(index->base);
+		} break;
+		case ENode::TYPE_ARRAY: {
+			const ArrayNode *array = static_cast<const ArrayNode *>(p_node);
+			instruction.opcode = OPCODE_ARRAY;
+			for (int i = 0; i < array->array.size(); i++) {
+				children.push_back(array->array[i]);
+			}
+		} break;
+		case ENode::TYPE_DICTIONARY: {
+			const DictionaryNode *dictionary = static_cast<const DictionaryNode *>(p_node);
+			instruction.opcode = OPCODE_DICTIONARY;
+			for (int i = 0; i < dictionary->dict.size(); i++) {
+				children.push_back(dictionary->dict[i]);
+			}
+		} break;
+		case ENode::TYPE_CONSTRUCTOR: {
+			const ConstructorNode *constructor = static_cast<const ConstructorNode *>(p_node);
+			instruction.opcode = OPCODE_CONSTRUCT;
+			instruction.type = constructor->data_type;
+			for (int i = 0; i < constructor->arguments.size(); i++) {
+				children.push_back(constructor->arguments[i]);
+			}
+		} break;
+		case ENode::TYPE_BUILTIN_FUNC: {
+			const BuiltinFuncNode *bifunc = static_cast<const BuiltinFuncNode *>(p_node);
+			instruction.opcode = OPCODE_CALL_UTILITY;
+			instruction.name = bifunc->func;
+			for (int i = 0; i < bifunc->arguments.size(); i++) {
+				children.push_back(bifunc->arguments[i]);
+			}
+		} break;
+		case ENode::TYPE_CALL: {
+			const CallNode *call = static_cast<const CallNode *>(p_node);
+			instruction.opcode = OPCODE_CALL;
+			instruction.name = call->method;
+			children.push_back(call->base);
+			for (int i = 0; i < call->arguments.size(); i++) {
+				children.push_back(call->arguments[i]);
+			}
+		} break;
+		default: {
+		}
+	}
+
+	// Each operand is evaluated into the slot after the previous one, its own
+	// temporaries go above it and are dead once it is computed.
+	LocalVector<int> operands;
+	for (uint32_t i = 0; i < children.size(); i++) {
+		int address = _compile_node(children[i], p_slot + 1 + i);
+
+		if (i == 0 && instruction.opcode == OPCODE_CALL && (address >> ADDRESS_BITS) != ADDRESS_STACK) {
+			// Methods may modify their base, copy constants and inputs to a temporary first.
+			Instruction assign;
+			assign.opcode = OPCODE_ASSIGN;
+			assign.target = p_slot + 1;
+			assign.operand_from = program_operands.size();
+			assign.operand_count = 1;
+			program_operands.push_back(address);
+			program_operand_types.push_back(Variant::VARIANT_MAX);
+			program.push_back(assign);
+			address = p_slot + 1;
+			if (program_stack.size() < (uint32_t)p_slot + 2) {
+				program_stack.resize(p_slot + 2);
+			}
+		}
+
+		operands.push_back(address);
+	}
+
+	instruction.operand_from = program_operands.size();
+	instruction.operand_count = operands.size();
+	for (uint32_t i = 0; i < operands.size(); i++) {
+		program_operands.push_back(operands[i]);
+		program_operand_types.push_back(Variant::VARIANT_MAX);
+	}
+	if (program_arguments.size() < operands.size()) {
+		program_arguments.resize(operands.size());
+	}
+	if (program_stack.size() < (uint32_t)p_slot + 1) {
+		program_stack.resize(p_slot + 1);
+	}
+
+	program.push_back(instruction);
+	return (ADDRESS_STACK << ADDRESS_BITS) | p_slot;
+}
+
+void Expression::_compile_program() {
+	program.clear();
+	program_operands.clear();
+	program_operand_types.clear();
+	program_constants.clear();
+	program_stack.clear();
+	program_arguments.clear();
+	program_result = 0;
+
+	if (root) {
+		program_result = _compile_node(root, 0);
+	}
+}
+
+void Expression::_update_cache(Instruction &p_instruction, const Variant **p_operands) {
+	Variant::Type *types = &program_operand_types[p_instruction.operand_from];
+	if (p_instruction.cached) {
+		bool hit = true;
+		for (int i = 0; i < p_instruction.operand_count; i++) {
+			if (p_operands[i]->get_type() != types[i]) {
+				hit = false;
+				break;
+			}
+		}
+		if (hit) {
+			return;
+		}
+	}
+
+	for (int i = 0; i < p_instruction.operand_count; i++) {
+		types[i] = p_operands[i]->get_type();
+	}
+	p_instruction.cached = true;
+
+	switch (p_instruction.opcode) {
+		case OPCODE_OPERATOR: {
+			Variant::Type type_a = types[0];
+			Variant::Type type_b = p_instruction.operand_count > 1 ? types[1] : Variant::NIL;
+			p_instruction.validated_operator = nullptr;
+
+			// Division, modulo and shifts only report invalid operands (such as a
+			// division by zero) through the checked evaluator.
+			switch (p_instruction.op) {
+				case Variant::OP_DIVIDE:
+				case Variant::OP_MODULE:
+				case Variant::OP_SHIFT_LEFT:
+				case Variant::OP_SHIFT_RIGHT:
+					return;
+				default: {
+				}
+			}
+			if (type_a != Variant::OBJECT && type_b != Variant::OBJECT) {
+				p_instruction.validated_operator = Variant::get_validated_operator_evaluator(p_instruction.op, type_a, type_b);
+			}
+		} break;
+		case OPCODE_NAMED_INDEX: {
+			p_instruction.validated_getter = nullptr;
+			if (types[0] != Variant::OBJECT) {
+				p_instruction.validated_getter = Variant::get_member_validated_getter(types[0], p_instruction.name);
+			}
+		} break;
+		case OPCODE_CALL_UTILITY: {
+			p_instruction.validated_utility = nullptr;
+			const StringName &name = p_instruction.name;
+			if (!Variant::has_utility_function(name) || Variant::is_utility_function_vararg(name) || Variant::get_utility_function_argument_count(name) != p_instruction.operand_count) {
+				return;
+			}
+			for (int i = 0; i < p_instruction.operand_count; i++) {
+				Variant::Type arg_type = Variant::get_utility_function_argument_type(name, i);
+				if (arg_type != Variant::NIL && arg_type != types[i]) {
+					return;
+				}
+			}
+			p_instruction.validated_utility = Variant::get_validated_utility_function(name);
+			p_instruction.cached_has_return = Variant::has_utility_function_return_value(name);
+		} break;
+		case OPCODE_CALL: {
+			p_instruction.validated_method = nullptr;
+			const StringName &name = p_instruction.name;
+			Variant::Type base_type = types[0];
+			int argc = p_instruction.operand_count - 1;
+			if (base_type == Variant::NIL || base_type == Variant::OBJECT || !Variant::has_builtin_method(base_type, name)) {
+				return;
+			}
+			if (Variant::is_builtin_method_vararg(base_type, name) || Variant::is_builtin_method_static(base_type, name) || Variant::get_builtin_method_argument_count(base_type, name) != argc) {
+				return;
+			}
+			for (int i = 0; i < argc; i++) {
+				Variant::Type arg_type = Variant::get_builtin_method_argument_type(base_type, name, i);
+				if (arg_type != Variant::NIL && arg_type != types[i + 1]) {
+					return;
+				}
+			}
+			Variant::Type return_type = Variant::get_builtin_method_return_type(base_type, name);
+			if (return_type == Variant::OBJECT) {
+				return;
+			}
+			p_instruction.validated_method = Variant::get_validated_builtin_method(base_type, name);
+			p_instruction.cached_has_return = Variant::has_builtin_method_return_value(base_type, name);
+			p_instruction.cached_return_type = return_type;
+		} break;
+		default: {
+		}
+	}
+}
+
+const Variant *Expression::_get_operand(int p_address, const Variant *p_inputs, int p_input_count, String &r_error_str) {
+	int index = p_address & ADDRESS_MASK;
+	switch (p_address >> ADDRESS_BITS) {
+		case ADDRESS_STACK:
+			return &program_stack[index];
+		case ADDRESS_CONSTANT:
+			return &program_constants[index];
+		default: {
+			if (index >= p_input_count) {
+				r_error_str = vformat(RTR("Invalid input %i (not passed) in expression"), index);
+				return nullptr;
+			}
+			return &p_inputs[index];
+		}
+	}
+}
+
+bool Expression::_execute_program(const Variant *p_inputs, int p_input_count, Object *p_instance, Variant &r_ret, String &r_error_str) {
+	const int *addresses = program_operands.ptr();
+	const Variant **operands = program_arguments.ptr();
+	const Variant nil;
+	bool failed = false;
+
+	for (uint32_t ip = 0; ip < program.size() && !failed; ip++) {
+		Instruction &instruction = program[ip];
+
+		for (int i = 0; i < instruction.operand_count; i++) {
+			operands[i] = _get_operand(addresses[instruction.operand_from + i], p_inputs, p_input_count, r_error_str);
+			if (!operands[i]) {
+				failed = true;
+				break;
+			}
+		}
+		if (failed) {
+			break;
+		}
+
+		Variant &dst = program_stack[instruction.target];
+
+		switch (instruction.opcode) {
+			case OPCODE_ASSIGN: {
+				dst = *operands[0];
+			} break;
+			case OPCODE_SELF: {
+				if (!p_instance) {
+					r_error_str = RTR("self can't be used because instance is null (not passed)");
+					failed = true;
+					break;
+				}
+				dst = p_instance;
+			} break;
+			case OPCODE_OPERATOR: {
+				_update_cache(instruction, operands);
+				const Variant *b = instruction.operand_count > 1 ? operands[1] : &nil;
+				if (instruction.validated_operator) {
+					instruction.validated_operator(operands[0], b, &dst);
+					break;
+				}
+
+				bool valid = true;
+				Variant::evaluate(instruction.op, *operands[0], *b, dst, valid);
+				if (!valid) {
+					r_error_str = vformat(RTR("Invalid operands to operator %s, %s and %s."), Variant::get_operator_name(instruction.op), Variant::get_type_name(operands[0]->get_type()), Variant::get_type_name(b->get_type()));
+					failed = true;
+				}
+			} break;
+			case OPCODE_INDEX: {
+				bool valid;
+				dst = operands[0]->get(*operands[1], &valid);
+				if (!valid) {
+					r_error_str = vformat(RTR("Invalid index of type %s for base type %s"), Variant::get_type_name(operands[1]->get_type()), Variant::get_type_name(operands[0]->get_type()));
+					failed = true;
+				}
+			} break;
+			case OPCODE_NAMED_INDEX: {
+				_update_cache(instruction, operands);
+				if (instruction.validated_getter) {
+					instruction.validated_getter(operands[0], &dst);
+					break;
+				}
+
+				bool valid;
+				dst = operands[0]->get_named(instruction.name, valid);
+				if (!valid) {
+					r_error_str = vformat(RTR("Invalid named index '%s' for base type %s"), String(instruction.name), Variant::get_type_name(operands[0]->get_type()));
+					failed = true;
+				}
+			} break;
+			case OPCODE_ARRAY: {
+				Array arr;
+				arr.resize(instruction.operand_count);
+				for (int i = 0; i < instruction.operand_count; i++) {
+					arr[i] = *operands[i];
+				}
+				dst = arr;
+			} break;
+			case OPCODE_DICTIONARY: {
+				Dictionary d;
+				for (int i = 0; i < instruction.operand_count; i += 2) {
+					d[*operands[i + 0]] = *operands[i + 1];
+				}
+				dst = d;
+			} break;
+			case OPCODE_CONSTRUCT: {
+				Callable::CallError ce;
+				Variant::construct(instruction.type, dst, operands, instruction.operand_count, ce);
+				if (ce.error != Callable::CallError::CALL_OK) {
+					r_error_str = vformat(RTR("Invalid arguments to construct '%s'"), Variant::get_type_name(instruction.type));
+					failed = true;
+				}
+			} break;
+			case OPCODE_CALL_UTILITY: {
+				_update_cache(instruction, operands);
+				if (instruction.validated_utility) {
+					if (!instruction.cached_has_return) {
+						dst = Variant();
+					}
+					instruction.validated_utility(&dst, operands, instruction.operand_count);
+					break;
+				}
+
+				dst = Variant(); //may not return anything
+				Callable::CallError ce;
+				Variant::call_utility_function(instruction.name, &dst, operands, instruction.operand_count, ce);
+				if (ce.error != Callable::CallError::CALL_OK) {
+					r_error_str = "Builtin Call Failed. " + Variant::get_call_error_text(instruction.name, operands, instruction.operand_count, ce);
+					failed = true;
+				}
+			} break;
+			case OPCODE_CALL: {
+				_update_cache(instruction, operands);
+				// The base is always a temporary, see _compile_node().
+				Variant *base = &program_stack[addresses[instruction.operand_from] & ADDRESS_MASK];
+				int argc = instruction.operand_count - 1;
+				if (instruction.validated_method) {
+					if (!instruction.cached_has_return) {
+						dst = Variant();
+					} else if (instruction.cached_return_type != Variant::NIL && dst.get_type() != instruction.cached_return_type) {
+						VariantInternal::initialize(&dst, instruction.cached_return_type);
+					}
+					instruction.validated_method(base, operands + 1, argc, &dst);
+					break;
+				}
+
+				Callable::CallError ce;
+				base->call(instruction.name, operands + 1, argc, dst, ce);
+				if (ce.error != Callable::CallError::CALL_OK) {
+					r_error_str = vformat(RTR("On call to '%s':"), String(instruction.name));
+					failed = true;
+				}
+			} break;
+		}
+	}
+
+	if (!failed) {
+		const Variant *result = _get_operand(program_result, p_inputs, p_input_count, r_error_str);
+		if (result) {
+			r_ret = *result;
+		} else {
+			failed = true;
+		}
+	}
+
+	// Don't keep references to the values computed, such as the base instance.
+	for (uint32_t i = 0; i < program_stack.size(); i++) {
+		program_stack[i] = Variant();
+	}
+
+	return failed;
+}
+
 Error Expression::parse(const String &p_expression, const Vector<String> &p_input_names) {
+	if (root && !error_set && p_expression == expression && p_input_names == input_names) {
+		// Same expression as the last successful parse, keep the compiled program.
+		error_str = String();
+		return OK;
+	}
+
 	if (nodes) {
 		memdelete(nodes);
 		nodes = nullptr;
@@ -1402,15 +1815,22 @@ Error Expression::parse(const String &p_expression, const Vector<String> &p_inpu
 			memdelete(nodes);
 		}
 		nodes = nullptr;
+		_compile_program();
 		return ERR_INVALID_PARAMETER;
 	}
 
+	_compile_program();
 	return OK;
 }
 
 Variant Expression::execute(Array p_inputs, Object *p_base, bool p_show_error) {
 	ERR_FAIL_COND_V_MSG(error_set, Variant(), "There was previously a parse error: " + error_str + ".");
 
+	if (use_bytecode && !program_running) {
+		const Array &inputs = p_inputs;
+		return execute_ptr(inputs.is_empty() ? nullptr : &inputs[0], inputs.size(), p_base, p_show_error);
+	}
+
 	execution_error = false;
 	Variant output;
 	String error_txt;
@@ -1424,6 +1844,35 @@ Variant Expression::execute(Array p_inputs, Object *p_base, bool p_show_error) {
 	return output;
 }
 
+Variant Expression::execute_ptr(const Variant *p_inputs, int p_input_count, Object *p_base, bool p_show_error) {
+	ERR_FAIL_COND_V_MSG(error_set, Variant(), "There was previously a parse error: " + error_str + ".");
+
+	if (!use_bytecode || program_running) {
+		// The program's temporaries are in use when a call re-enters this
+		// expression, walk the tree instead.
+		Array inputs;
+		inputs.resize(p_input_count);
+		for (int i = 0; i < p_input_count; i++) {
+			inputs[i] = p_inputs[i];
+		}
+		return execute(inputs, p_base, p_show_error);
+	}
+
+	execution_error = false;
+	Variant output;
+	String error_txt;
+	program_running = true;
+	bool err = _execute_program(p_inputs, p_input_count, p_base, output, error_txt);
+	program_running = false;
+	if (err) {
+		execution_error = true;
+		error_str = error_txt;
+		ERR_FAIL_COND_V_MSG(p_show_error, Variant(), error_str);
+	}
+
+	return output;
+}
+
 bool Expression::has_execute_failed() const {
 	return execution_error;
 }
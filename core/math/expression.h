@@ -32,6 +32,7 @@
 #define EXPRESSION_H
 
 #include "core/object/reference.h"
+#include "core/templates/local_vector.h"
 
 class Expression : public Reference {
 	GDCLASS(Expression, Reference);
@@ -258,15 +259,80 @@ private:
 	bool execution_error = false;
 	bool _execute(const Array &p_inputs, Object *p_instance, Expression::ENode *p_node, Variant &r_ret, String &r_error_str);
 
+	// The parsed tree is compiled into a flat list of instructions writing
+	// into a stack of temporaries. Operands address temporaries, constants or
+	// inputs directly. Operators, named indices and calls cache the validated
+	// function matching the operand types they last saw.
+	enum Opcode {
+		OPCODE_ASSIGN,
+		OPCODE_SELF,
+		OPCODE_OPERATOR,
+		OPCODE_INDEX,
+		OPCODE_NAMED_INDEX,
+		OPCODE_ARRAY,
+		OPCODE_DICTIONARY,
+		OPCODE_CONSTRUCT,
+		OPCODE_CALL_UTILITY,
+		OPCODE_CALL,
+	};
+
+	enum {
+		ADDRESS_BITS = 28,
+		ADDRESS_MASK = (1 << ADDRESS_BITS) - 1,
+		ADDRESS_STACK = 0,
+		ADDRESS_CONSTANT = 1,
+		ADDRESS_INPUT = 2,
+	};
+
+	struct Instruction {
+		Opcode opcode = OPCODE_ASSIGN;
+		Variant::Operator op = Variant::OP_ADD;
+		Variant::Type type = Variant::NIL;
+		int target = 0;
+		int operand_from = 0;
+		int operand_count = 0;
+		StringName name;
+
+		bool cached = false;
+		bool cached_has_return = false;
+		Variant::Type cached_return_type = Variant::NIL;
+		Variant::ValidatedOperatorEvaluator validated_operator = nullptr;
+		Variant::ValidatedGetter validated_getter = nullptr;
+		Variant::ValidatedUtilityFunction validated_utility = nullptr;
+		Variant::ValidatedBuiltInMethod validated_method = nullptr;
+	};
+
+	LocalVector<Instruction> program;
+	LocalVector<int> program_operands;
+	LocalVector<Variant::Type> program_operand_types;
+	LocalVector<Variant> program_constants;
+	LocalVector<Variant> program_stack;
+	LocalVector<const Variant *> program_arguments;
+	int program_result = 0;
+	bool program_running = false;
+	bool use_bytecode = true;
+
+	int _compile_node(ENode *p_node, int p_slot);
+	void _compile_program();
+	void _update_cache(Instruction &p_instruction, const Variant **p_operands);
+	bool _execute_program(const Variant *p_inputs, int p_input_count, Object *p_instance, Variant &r_ret, String &r_error_str);
+	const Variant *_get_operand(int p_address, const Variant *p_inputs, int p_input_count, String &r_error_str);
+
 protected:
 	static void _bind_methods();
 
 public:
 	Error parse(const String &p_expression, const Vector<String> &p_input_names = Vector<String>());
 	Variant execute(Array p_inputs = Array(), Object *p_base = nullptr, bool p_show_error = true);
+	Variant execute_ptr(const Variant *p_inputs, int p_input_count, Object *p_base = nullptr, bool p_show_error = true);
 	bool has_execute_failed() const;
 	String get_error_text() const;
 
+	// Executes by walking the parsed tree instead of the compiled program,
+	// kept for comparison in tests and benchmarks.
+	void set_use_bytecode(bool p_enable) { use_bytecode = p_enable; }
+	bool is_using_bytecode() const { return use_bytecode; }
+
 	Expression() {}
 	~Expression();
 };
@@ -0,0 +1,60 @@
+/*************************************************************************/
+/*  interpolated_transform.h                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef INTERPOLATED_TRANSFORM_H
+#define INTERPOLATED_TRANSFORM_H
+
+#include "core/math/math_defs.h"
+#include "core/typedefs.h"
+
+// The transforms of an object at the last two physics ticks, for physics interpolation.
+// T is Transform or Transform2D, what gets drawn is a blend of both by the fraction of the current tick.
+template <class T>
+struct InterpolatedTransform {
+	T prev;
+	T curr;
+
+	// Starts over from p_transform, without blending from an older transform.
+	_FORCE_INLINE_ void reset(const T &p_transform) {
+		prev = p_transform;
+		curr = p_transform;
+	}
+
+	// The transform of the last tick becomes the start of the next blend.
+	_FORCE_INLINE_ void tick() {
+		prev = curr;
+	}
+
+	_FORCE_INLINE_ T interpolate(real_t p_fraction) const {
+		return prev.interpolate_with(curr, p_fraction);
+	}
+};
+
+#endif // INTERPOLATED_TRANSFORM_H
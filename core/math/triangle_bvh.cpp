@@ -0,0 +1,552 @@
+/*************************************************************************/
+/*  triangle_bvh.cpp                                                     */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#include "triangle_bvh.h"
+
+#include "core/os/mutex.h"
+#include "core/templates/sort_array.h"
+#include "core/templates/thread_work_pool.h"
+
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define TRIANGLE_BVH_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+// Meshes with fewer triangles than this are always built on the calling thread.
+#define TRIANGLE_BVH_THREADED_BUILD_MIN 65536
+// Threaded builds split the top of the tree into roughly this many subtrees.
+#define TRIANGLE_BVH_THREADED_BUILD_TASKS 64
+// Widens the ray interval a little to absorb the rounding of the slab test.
+#define TRIANGLE_BVH_RAY_TMAX_SCALE 1.0001f
+
+struct _TriangleBVHCenterCompare {
+	const Vector3 *centers = nullptr;
+	int axis = 0;
+
+	_FORCE_INLINE_ bool operator()(uint32_t p_a, uint32_t p_b) const {
+		return centers[p_a][axis] < centers[p_b][axis];
+	}
+};
+
+#ifdef TRIANGLE_BVH_USE_SSE2
+
+static _FORCE_INLINE_ __m128 _triangle_bvh_load_bounds(const uint8_t *p_bounds) {
+	int32_t packed;
+	memcpy(&packed, p_bounds, sizeof(int32_t));
+	__m128i zero = _mm_setzero_si128();
+	__m128i v = _mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), zero);
+	v = _mm_unpacklo_epi16(v, zero);
+	return _mm_cvtepi32_ps(v);
+}
+
+static _FORCE_INLINE_ uint32_t _triangle_bvh_test_aabb(const TriangleBVH::Node &p_node, const float *p_min, const float *p_max) {
+	__m128 hit = _mm_castsi128_ps(_mm_set1_epi32(-1));
+	for (int i = 0; i < 3; i++) {
+		__m128 origin = _mm_set1_ps(p_node.origin[i]);
+		__m128 scale = _mm_set1_ps(p_node.scale[i]);
+		__m128 lo = _mm_add_ps(origin, _mm_mul_ps(_triangle_bvh_load_bounds(p_node.bounds[i]), scale));
+		__m128 hi = _mm_add_ps(origin, _mm_mul_ps(_triangle_bvh_load_bounds(p_node.bounds[i + 3]), scale));
+		hit = _mm_and_ps(hit, _mm_cmple_ps(lo, _mm_set1_ps(p_max[i])));
+		hit = _mm_and_ps(hit, _mm_cmpge_ps(hi, _mm_set1_ps(p_min[i])));
+	}
+	return _mm_movemask_ps(hit);
+}
+
+static _FORCE_INLINE_ uint32_t _triangle_bvh_test_ray(const TriangleBVH::Node &p_node, const float *p_from, const float *p_inv_dir, float p_max_t, float *r_min_t) {
+	__m128 min_t = _mm_setzero_ps();
+	__m128 max_t = _mm_set1_ps(p_max_t);
+	for (int i = 0; i < 3; i++) {
+		// Fold the node origin and scale into the slab distances, so each child costs a multiply-add per plane.
+		__m128 offset = _mm_set1_ps((p_node.origin[i] - p_from[i]) * p_inv_dir[i]);
+		__m128 scale = _mm_set1_ps(p_node.scale[i] * p_inv_dir[i]);
+		__m128 t0 = _mm_add_ps(offset, _mm_mul_ps(_triangle_bvh_load_bounds(p_node.bounds[i]), scale));
+		__m128 t1 = _mm_add_ps(offset, _mm_mul_ps(_triangle_bvh_load_bounds(p_node.bounds[i + 3]), scale));
+		min_t = _mm_max_ps(min_t, _mm_min_ps(t0, t1));
+		max_t = _mm_min_ps(max_t, _mm_max_ps(t0, t1));
+	}
+	max_t = _mm_mul_ps(max_t, _mm_set1_ps(TRIANGLE_BVH_RAY_TMAX_SCALE));
+	_mm_storeu_ps(r_min_t, min_t);
+	return _mm_movemask_ps(_mm_cmple_ps(min_t, max_t));
+}
+
+#else
+
+static _FORCE_INLINE_ uint32_t _triangle_bvh_test_aabb(const TriangleBVH::Node &p_node, const float *p_min, const float *p_max) {
+	uint32_t mask = 0;
+	for (int j = 0; j < 4; j++) {
+		bool hit = true;
+		for (int i = 0; i < 3; i++) {
+			float lo = p_node.origin[i] + float(p_node.bounds[i][j]) * p_node.scale[i];
+			float hi = p_node.origin[i] + float(p_node.bounds[i + 3][j]) * p_node.scale[i];
+			hit = hit && lo <= p_max[i] && hi >= p_min[i];
+		}
+		mask |= uint32_t(hit) << j;
+	}
+	return mask;
+}
+
+static _FORCE_INLINE_ uint32_t _triangle_bvh_test_ray(const TriangleBVH::Node &p_node, const float *p_from, const float *p_inv_dir, float p_max_t, float *r_min_t) {
+	uint32_t mask = 0;
+	for (int j = 0; j < 4; j++) {
+		float min_t = 0.0;
+		float max_t = p_max_t;
+		for (int i = 0; i < 3; i++) {
+			float offset = (p_node.origin[i] - p_from[i]) * p_inv_dir[i];
+			float scale = p_node.scale[i] * p_inv_dir[i];
+			float t0 = offset + float(p_node.bounds[i][j]) * scale;
+			float t1 = offset + float(p_node.bounds[i + 3][j]) * scale;
+			min_t = MAX(min_t, MIN(t0, t1));
+			max_t = MIN(max_t, MAX(t0, t1));
+		}
+		r_min_t[j] = min_t;
+		mask |= uint32_t(min_t <= max_t * TRIANGLE_BVH_RAY_TMAX_SCALE) << j;
+	}
+	return mask;
+}
+
+#endif
+
+AABB TriangleBVH::_get_range_aabb(const BuildContext &p_context, uint32_t p_from, uint32_t p_count) {
+	AABB range_aabb = p_context.aabbs[p_context.indices[p_from]];
+	for (uint32_t i = 1; i < p_count; i++) {
+		range_aabb.merge_with(p_context.aabbs[p_context.indices[p_from + i]]);
+	}
+	return range_aabb;
+}
+
+uint32_t TriangleBVH::_split_range(const BuildContext &p_context, uint32_t p_from, uint32_t p_count) {
+	AABB center_aabb(p_context.centers[p_context.indices[p_from]], Vector3());
+	for (uint32_t i = 1; i < p_count; i++) {
+		center_aabb.expand_to(p_context.centers[p_context.indices[p_from + i]]);
+	}
+
+	SortArray<uint32_t, _TriangleBVHCenterCompare> sorter;
+	sorter.compare.centers = p_context.centers;
+	sorter.compare.axis = center_aabb.get_longest_axis_index();
+
+	uint32_t mid = p_from + p_count / 2;
+	sorter.nth_element(p_from, p_from + p_count, mid, p_context.indices);
+	return mid;
+}
+
+void TriangleBVH::_quantize_node(Node &r_node, const AABB *p_child_aabbs, int p_child_count) {
+	AABB node_aabb = p_child_aabbs[0];
+	for (int i = 1; i < p_child_count; i++) {
+		node_aabb.merge_with(p_child_aabbs[i]);
+	}
+
+	for (int i = 0; i < 3; i++) {
+		// Round the frame outwards, then each child bound outwards within it,
+		// checking against the exact expression the queries evaluate.
+		real_t lo = node_aabb.position[i];
+		real_t hi = lo + node_aabb.size[i];
+		float origin = lo;
+		if (origin > lo) {
+			origin = nextafterf(origin, -Math_INF);
+		}
+		float scale = (hi - origin) / 255.0;
+		while (origin + 255.0f * scale < hi) {
+			scale = nextafterf(scale, Math_INF);
+		}
+		float inv_scale = scale > 0.0f ? 1.0f / scale : 0.0f;
+
+		r_node.origin[i] = origin;
+		r_node.scale[i] = scale;
+
+		for (int j = 0; j < 4; j++) {
+			if (j >= p_child_count) {
+				r_node.bounds[i][j] = 255;
+				r_node.bounds[i + 3][j] = 0;
+				continue;
+			}
+
+			real_t child_lo = p_child_aabbs[j].position[i];
+			real_t child_hi = child_lo + p_child_aabbs[j].size[i];
+
+			int q_lo = CLAMP(int(Math::floor((child_lo - origin) * inv_scale)), 0, 255);
+			while (q_lo > 0 && origin + float(q_lo) * scale > child_lo) {
+				q_lo--;
+			}
+			int q_hi = CLAMP(int(Math::ceil((child_hi - origin) * inv_scale)), 0, 255);
+			while (q_hi < 255 && origin + float(q_hi) * scale < child_hi) {
+				q_hi++;
+			}
+
+			r_node.bounds[i][j] = q_lo;
+			r_node.bounds[i + 3][j] = q_hi;
+		}
+	}
+}
+
+uint32_t TriangleBVH::_build_node(BuildContext &p_context, LocalVector<Node> &r_nodes, uint32_t p_from, uint32_t p_count, uint32_t p_depth, uint32_t &r_max_depth, bool p_make_tasks) {
+	r_max_depth = MAX(r_max_depth, p_depth);
+
+	// Split into up to four ranges, always splitting the largest one.
+	uint32_t range_from[4] = { p_from };
+	uint32_t range_count[4] = { p_count };
+	int ranges = 1;
+	while (ranges < 4) {
+		int largest = -1;
+		for (int i = 0; i < ranges; i++) {
+			if (range_count[i] > MAX_LEAF_TRIANGLES && (largest == -1 || range_count[i] > range_count[largest])) {
+				largest = i;
+			}
+		}
+		if (largest == -1) {
+			break;
+		}
+
+		uint32_t mid = _split_range(p_context, range_from[largest], range_count[largest]);
+		range_from[ranges] = mid;
+		range_count[ranges] = range_from[largest] + range_count[largest] - mid;
+		range_count[largest] = mid - range_from[largest];
+		ranges++;
+	}
+
+	AABB child_aabbs[4];
+	for (int i = 0; i < ranges; i++) {
+		child_aabbs[i] = _get_range_aabb(p_context, range_from[i], range_count[i]);
+	}
+
+	uint32_t index = r_nodes.size();
+	r_nodes.resize(index + 1);
+	_quantize_node(r_nodes[index], child_aabbs, ranges);
+
+	for (int i = 0; i < 4; i++) {
+		uint32_t child = CHILD_EMPTY;
+		if (i >= ranges) {
+			// Empty slot.
+		} else if (range_count[i] <= MAX_LEAF_TRIANGLES) {
+			child = CHILD_LEAF_BIT | ((range_count[i] - 1) << CHILD_LEAF_COUNT_SHIFT) | range_from[i];
+		} else if (p_make_tasks && range_count[i] <= p_context.task_size) {
+			// Built on the work pool, linked in afterwards.
+			uint32_t task_index = p_context.tasks.size();
+			p_context.tasks.resize(task_index + 1);
+			BuildTask &task = p_context.tasks[task_index];
+			task.from = range_from[i];
+			task.count = range_count[i];
+			task.parent = index;
+			task.slot = i;
+			task.depth = p_depth + 1;
+		} else {
+			child = _build_node(p_context, r_nodes, range_from[i], range_count[i], p_depth + 1, r_max_depth, p_make_tasks);
+		}
+		r_nodes[index].children[i] = child;
+	}
+
+	return index;
+}
+
+void TriangleBVH::_build_task(uint32_t p_index, BuildContext *p_context) {
+	BuildTask &task = p_context->tasks[p_index];
+	_build_node(*p_context, task.nodes, task.from, task.count, task.depth, task.max_depth, false);
+}
+
+AABB TriangleBVH::_get_child_aabb(const Node &p_node, int p_child) {
+	AABB child_aabb;
+	for (int i = 0; i < 3; i++) {
+		float lo = p_node.origin[i] + float(p_node.bounds[i][p_child]) * p_node.scale[i];
+		float hi = p_node.origin[i] + float(p_node.bounds[i + 3][p_child]) * p_node.scale[i];
+		child_aabb.position[i] = lo;
+		child_aabb.size[i] = hi - lo;
+	}
+	return child_aabb;
+}
+
+static ThreadWorkPool *triangle_bvh_work_pool = nullptr;
+static BinaryMutex triangle_bvh_work_pool_mutex;
+
+void TriangleBVH::finish_work_pool() {
+	MutexLock lock(triangle_bvh_work_pool_mutex);
+	if (triangle_bvh_work_pool) {
+		triangle_bvh_work_pool->finish();
+		memdelete(triangle_bvh_work_pool);
+		triangle_bvh_work_pool = nullptr;
+	}
+}
+
+void TriangleBVH::_build_tasks(BuildContext &p_context) {
+#ifndef NO_THREADS
+	// Another build may hold the pool, this one then builds its subtrees on the calling thread.
+	if (triangle_bvh_work_pool_mutex.try_lock() == OK) {
+		if (!triangle_bvh_work_pool) {
+			triangle_bvh_work_pool = memnew(ThreadWorkPool);
+			triangle_bvh_work_pool->init();
+		}
+		triangle_bvh_work_pool->do_work(p_context.tasks.size(), this, &TriangleBVH::_build_task, &p_context);
+		triangle_bvh_work_pool_mutex.unlock();
+		return;
+	}
+#endif
+	for (uint32_t i = 0; i < p_context.tasks.size(); i++) {
+		_build_task(i, &p_context);
+	}
+}
+
+void TriangleBVH::build(const AABB *p_triangle_aabbs, uint32_t p_count, bool p_use_threads) {
+	clear();
+	if (p_count == 0) {
+		return;
+	}
+	ERR_FAIL_COND_MSG(p_count > CHILD_LEAF_START_MASK, "Too many triangles for a single TriangleBVH.");
+
+	LocalVector<Vector3> centers;
+	centers.resize(p_count);
+	triangle_indices.resize(p_count);
+	aabb = p_triangle_aabbs[0];
+	for (uint32_t i = 0; i < p_count; i++) {
+		centers[i] = p_triangle_aabbs[i].position + p_triangle_aabbs[i].size * 0.5;
+		triangle_indices[i] = i;
+		aabb.merge_with(p_triangle_aabbs[i]);
+	}
+
+	BuildContext context;
+	context.aabbs = p_triangle_aabbs;
+	context.centers = centers.ptr();
+	context.indices = triangle_indices.ptr();
+
+	bool threaded = p_use_threads && p_count >= TRIANGLE_BVH_THREADED_BUILD_MIN;
+	if (threaded) {
+		context.task_size = p_count / TRIANGLE_BVH_THREADED_BUILD_TASKS;
+	}
+
+	uint32_t max_depth = 0;
+	_build_node(context, nodes, 0, p_count, 1, max_depth, threaded);
+
+	if (!context.tasks.is_empty()) {
+		_build_tasks(context);
+	}
+
+	for (uint32_t i = 0; i < context.tasks.size(); i++) {
+		const BuildTask &task = context.tasks[i];
+		max_depth = MAX(max_depth, task.max_depth);
+		uint32_t offset = nodes.size();
+		nodes.resize(offset + task.nodes.size());
+		for (uint32_t j = 0; j < task.nodes.size(); j++) {
+			Node &node = nodes[offset + j];
+			node = task.nodes[j];
+			for (int k = 0; k < 4; k++) {
+				if (!_is_leaf(node.children[k])) {
+					node.children[k] += offset;
+				}
+			}
+		}
+		nodes[task.parent].children[task.slot] = offset;
+	}
+
+	// Traversal pops a node and pushes up to four children, leaving at most three siblings behind on every level.
+	if (max_depth * 3 + 1 > STACK_SIZE) {
+		clear();
+		ERR_FAIL_MSG("TriangleBVH is too deep for its traversal stack.");
+	}
+}
+
+void TriangleBVH::clear() {
+	nodes.clear();
+	triangle_indices.clear();
+	aabb = AABB();
+}
+
+size_t TriangleBVH::get_memory_usage() const {
+	return nodes.size() * sizeof(Node) + triangle_indices.size() * sizeof(uint32_t);
+}
+
+bool TriangleBVH::cull_aabb(const AABB &p_aabb, TriangleCallback p_callback, void *p_userdata) const {
+	if (nodes.is_empty()) {
+		return false;
+	}
+
+	float min[3];
+	float max[3];
+	for (int i = 0; i < 3; i++) {
+		min[i] = p_aabb.position[i];
+		max[i] = p_aabb.position[i] + p_aabb.size[i];
+	}
+
+	// Each node pushes at most four children, build() makes sure the deepest path fits the stack.
+	uint32_t stack[STACK_SIZE];
+	int stack_size = 0;
+	stack[stack_size++] = 0;
+
+	while (stack_size) {
+		const Node &node = nodes[stack[--stack_size]];
+		uint32_t mask = _triangle_bvh_test_aabb(node, min, max);
+
+		for (int i = 0; i < 4; i++) {
+			uint32_t child = node.children[i];
+			if (child == CHILD_EMPTY) {
+				break;
+			}
+			if (!(mask & (1 << i))) {
+				continue;
+			}
+
+			if (_is_leaf(child)) {
+				const uint32_t *triangles = &triangle_indices[_get_leaf_start(child)];
+				uint32_t count = _get_leaf_count(child);
+				for (uint32_t j = 0; j < count; j++) {
+					if (p_callback(p_userdata, triangles[j])) {
+						return true;
+					}
+				}
+			} else {
+				stack[stack_size++] = child;
+			}
+		}
+	}
+
+	return false;
+}
+
+bool TriangleBVH::cull_ray(const Vector3 &p_from, const Vector3 &p_dir, real_t p_max_t, RayCallback p_callback, void *p_userdata) const {
+	if (nodes.is_empty()) {
+		return false;
+	}
+
+	float from[3];
+	float inv_dir[3];
+	for (int i = 0; i < 3; i++) {
+		from[i] = p_from[i];
+		// A large finite value keeps parallel slabs free of NaNs.
+		inv_dir[i] = p_dir[i] != 0 ? float(1.0 / p_dir[i]) : 1e20f;
+	}
+
+	real_t max_t = p_max_t;
+
+	struct Entry {
+		uint32_t child;
+		float min_t;
+	};
+
+	Entry stack[STACK_SIZE];
+	int stack_size = 0;
+	stack[stack_size++] = { 0, 0.0f };
+
+	while (stack_size) {
+		Entry entry = stack[--stack_size];
+		if (entry.min_t > max_t) {
+			continue; // A closer hit was found since this was pushed.
+		}
+
+		if (_is_leaf(entry.child)) {
+			const uint32_t *triangles = &triangle_indices[_get_leaf_start(entry.child)];
+			uint32_t count = _get_leaf_count(entry.child);
+			for (uint32_t j = 0; j < count; j++) {
+				if (p_callback(p_userdata, triangles[j], max_t)) {
+					return true;
+				}
+			}
+			continue;
+		}
+
+		const Node &node = nodes[entry.child];
+		float min_t[4];
+		uint32_t mask = _triangle_bvh_test_ray(node, from, inv_dir, max_t, min_t);
+
+		// Push hits far to near, so the nearest child is visited first.
+		Entry hits[4];
+		int hit_count = 0;
+		for (int i = 0; i < 4; i++) {
+			uint32_t child = node.children[i];
+			if (child == CHILD_EMPTY) {
+				break;
+			}
+			if (!(mask & (1 << i))) {
+				continue;
+			}
+			int j = hit_count++;
+			while (j > 0 && hits[j - 1].min_t < min_t[i]) {
+				hits[j] = hits[j - 1];
+				j--;
+			}
+			hits[j] = { child, min_t[i] };
+		}
+
+		for (int i = 0; i < hit_count; i++) {
+			stack[stack_size++] = hits[i];
+		}
+	}
+
+	return false;
+}
+
+bool TriangleBVH::cull_custom(AABBTestCallback p_test, TriangleCallback p_callback, void *p_userdata) const {
+	if (nodes.is_empty()) {
+		return false;
+	}
+
+	switch (p_test(p_userdata, aabb)) {
+		case AABB_TEST_MISS:
+			return false;
+		case AABB_TEST_STOP:
+			return true;
+		case AABB_TEST_HIT:
+			break;
+	}
+
+	uint32_t stack[STACK_SIZE];
+	int stack_size = 0;
+	stack[stack_size++] = 0;
+
+	while (stack_size) {
+		const Node &node = nodes[stack[--stack_size]];
+
+		for (int i = 0; i < 4; i++) {
+			uint32_t child = node.children[i];
+			if (child == CHILD_EMPTY) {
+				break;
+			}
+
+			AABBTestResult result = p_test(p_userdata, _get_child_aabb(node, i));
+			if (result == AABB_TEST_STOP) {
+				return true;
+			} else if (result == AABB_TEST_MISS) {
+				continue;
+			}
+
+			if (_is_leaf(child)) {
+				const uint32_t *triangles = &triangle_indices[_get_leaf_start(child)];
+				uint32_t count = _get_leaf_count(child);
+				for (uint32_t j = 0; j < count; j++) {
+					if (p_callback(p_userdata, triangles[j])) {
+						return true;
+					}
+				}
+			} else {
+				stack[stack_size++] = child;
+			}
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,136 @@
+/*************************************************************************/
+/*  triangle_bvh.h                                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#ifndef TRIANGLE_BVH_H
+#define TRIANGLE_BVH_H
+
+#include "core/math/aabb.h"
+#include "core/templates/local_vector.h"
+
+// Static 4-wide bounding volume hierarchy over triangles, shared by
+// TriangleMesh and ConcavePolygonShape3DSW.
+// Each node stores the bounds of its four children quantized to 8 bits
+// relative to the node's own bounds, so a node fits in one cache line and
+// all four children are tested at once. Quantization always rounds
+// outwards, so the tree never misses a triangle; leaves may still report
+// triangles a little outside the query, callers do their exact test.
+
+class TriangleBVH {
+public:
+	enum {
+		MAX_LEAF_TRIANGLES = 4,
+	};
+
+	enum AABBTestResult {
+		AABB_TEST_MISS, // Skip this subtree.
+		AABB_TEST_HIT, // Visit this subtree.
+		AABB_TEST_STOP, // Stop the whole query.
+	};
+
+	// Return true from a callback to stop the query.
+	typedef bool (*TriangleCallback)(void *p_userdata, uint32_t p_triangle);
+	// Ray callbacks may shorten r_max_t (in units of the ray direction) after a hit, to prune farther nodes.
+	typedef bool (*RayCallback)(void *p_userdata, uint32_t p_triangle, real_t &r_max_t);
+	typedef AABBTestResult (*AABBTestCallback)(void *p_userdata, const AABB &p_aabb);
+
+	struct Node {
+		float origin[3];
+		float scale[3];
+		// Quantized min x, y, z and max x, y, z, for each of the four children.
+		uint8_t bounds[6][4];
+		uint32_t children[4];
+	};
+
+private:
+	enum {
+		CHILD_EMPTY = 0xFFFFFFFF,
+		CHILD_LEAF_BIT = 0x80000000,
+		CHILD_LEAF_COUNT_SHIFT = 27,
+		CHILD_LEAF_START_MASK = (1 << CHILD_LEAF_COUNT_SHIFT) - 1,
+		STACK_SIZE = 128, // Enough for trees up to 42 levels deep, which build() checks.
+	};
+
+	struct BuildTask {
+		uint32_t from = 0;
+		uint32_t count = 0;
+		uint32_t parent = 0;
+		uint32_t slot = 0;
+		uint32_t depth = 0;
+		uint32_t max_depth = 0;
+		LocalVector<Node> nodes;
+	};
+
+	struct BuildContext {
+		const AABB *aabbs = nullptr;
+		const Vector3 *centers = nullptr;
+		uint32_t *indices = nullptr;
+		uint32_t task_size = 0;
+		LocalVector<BuildTask> tasks;
+	};
+
+	LocalVector<Node> nodes;
+	LocalVector<uint32_t> triangle_indices;
+	AABB aabb;
+
+	static AABB _get_range_aabb(const BuildContext &p_context, uint32_t p_from, uint32_t p_count);
+	static uint32_t _split_range(const BuildContext &p_context, uint32_t p_from, uint32_t p_count);
+	static void _quantize_node(Node &r_node, const AABB *p_child_aabbs, int p_child_count);
+	static uint32_t _build_node(BuildContext &p_context, LocalVector<Node> &r_nodes, uint32_t p_from, uint32_t p_count, uint32_t p_depth, uint32_t &r_max_depth, bool p_make_tasks);
+	void _build_task(uint32_t p_index, BuildContext *p_context);
+	void _build_tasks(BuildContext &p_context);
+
+	_FORCE_INLINE_ static bool _is_leaf(uint32_t p_child) { return p_child & CHILD_LEAF_BIT; }
+	_FORCE_INLINE_ static uint32_t _get_leaf_start(uint32_t p_child) { return p_child & CHILD_LEAF_START_MASK; }
+	_FORCE_INLINE_ static uint32_t _get_leaf_count(uint32_t p_child) { return ((p_child & ~CHILD_LEAF_BIT) >> CHILD_LEAF_COUNT_SHIFT) + 1; }
+	static AABB _get_child_aabb(const Node &p_node, int p_child);
+
+public:
+	void build(const AABB *p_triangle_aabbs, uint32_t p_count, bool p_use_threads = true);
+	void clear();
+	static void finish_work_pool();
+
+	_FORCE_INLINE_ bool is_empty() const { return nodes.is_empty(); }
+	_FORCE_INLINE_ const AABB &get_aabb() const { return aabb; }
+	_FORCE_INLINE_ uint32_t get_node_count() const { return nodes.size(); }
+	_FORCE_INLINE_ uint32_t get_triangle_count() const { return triangle_indices.size(); }
+	size_t get_memory_usage() const;
+
+	// All queries return true if a callback stopped them.
+	bool cull_aabb(const AABB &p_aabb, TriangleCallback p_callback, void *p_userdata) const;
+	// Visits leaves front to back; p_max_t is in units of p_dir.
+	bool cull_ray(const Vector3 &p_from, const Vector3 &p_dir, real_t p_max_t, RayCallback p_callback, void *p_userdata) const;
+	_FORCE_INLINE_ bool cull_segment(const Vector3 &p_from, const Vector3 &p_to, RayCallback p_callback, void *p_userdata) const {
+		return cull_ray(p_from, p_to - p_from, 1.0, p_callback, p_userdata);
+	}
+	bool cull_custom(AABBTestCallback p_test, TriangleCallback p_callback, void *p_userdata) const;
+};
+
+#endif // TRIANGLE_BVH_H
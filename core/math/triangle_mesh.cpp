@@ -30,59 +30,7 @@
 
 #include "triangle_mesh.h"
 
-#include "core/templates/sort_array.h"
-
-int TriangleMesh::_create_bvh(BVH *p_bvh, BVH **p_bb, int p_from, int p_size, int p_depth, int &max_depth, int &max_alloc) {
-	if (p_depth > max_depth) {
-		max_depth = p_depth;
-	}
-
-	if (p_size == 1) {
-		return p_bb[p_from] - p_bvh;
-	} else if (p_size == 0) {
-		return -1;
-	}
-
-	AABB aabb;
-	aabb = p_bb[p_from]->aabb;
-	for (int i = 1; i < p_size; i++) {
-		aabb.merge_with(p_bb[p_from + i]->aabb);
-	}
-
-	int li = aabb.get_longest_axis_index();
-
-	switch (li) {
-		case Vector3::AXIS_X: {
-			SortArray<BVH *, BVHCmpX> sort_x;
-			sort_x.nth_element(0, p_size, p_size / 2, &p_bb[p_from]);
-			//sort_x.sort(&p_bb[p_from],p_size);
-		} break;
-		case Vector3::AXIS_Y: {
-			SortArray<BVH *, BVHCmpY> sort_y;
-			sort_y.nth_element(0, p_size, p_size / 2, &p_bb[p_from]);
-			//sort_y.sort(&p_bb[p_from],p_size);
-		} break;
-		case Vector3::AXIS_Z: {
-			SortArray<BVH *, BVHCmpZ> sort_z;
-			sort_z.nth_element(0, p_size, p_size / 2, &p_bb[p_from]);
-			//sort_z.sort(&p_bb[p_from],p_size);
-
-		} break;
-	}
-
-	int left = _create_bvh(p_bvh, p_bb, p_from, p_size / 2, p_depth + 1, max_depth, max_alloc);
-	int right = _create_bvh(p_bvh, p_bb, p_from + p_size / 2, p_size - p_size / 2, p_depth + 1, max_depth, max_alloc);
-
-	int index = max_alloc++;
-	BVH *_new = &p_bvh[index];
-	_new->aabb = aabb;
-	_new->center = aabb.position + aabb.size * 0.5;
-	_new->face_index = -1;
-	_new->left = left;
-	_new->right = right;
-
-	return index;
-}
+#include "core/templates/local_vector.h"
 
 void TriangleMesh::get_indices(Vector<int> *r_triangles_indices) const {
 	if (!valid) {
@@ -112,8 +60,8 @@ void TriangleMesh::create(const Vector<Vector3> &p_faces) {
 	fc /= 3;
 	triangles.resize(fc);
 
-	bvh.resize(fc * 3); //will never be larger than this (todo make better)
-	BVH *bw = bvh.ptrw();
+	LocalVector<AABB> triangle_aabbs;
+	triangle_aabbs.resize(fc);
 
 	{
 		//create faces and indices and base bvh
@@ -141,18 +89,13 @@ void TriangleMesh::create(const Vector<Vector3> &p_faces) {
 
 				f.indices[j] = vidx;
 				if (j == 0) {
-					bw[i].aabb.position = vs;
+					triangle_aabbs[i] = AABB(vs, Vector3());
 				} else {
-					bw[i].aabb.expand_to(vs);
+					triangle_aabbs[i].expand_to(vs);
 				}
 			}
 
 			f.normal = Face3(r[i * 3 + 0], r[i * 3 + 1], r[i * 3 + 2]).get_plane().get_normal();
-
-			bw[i].left = -1;
-			bw[i].right = -1;
-			bw[i].face_index = i;
-			bw[i].center = bw[i].aabb.position + bw[i].aabb.size * 0.5;
 		}
 
 		vertices.resize(db.size());
@@ -162,418 +105,191 @@ void TriangleMesh::create(const Vector<Vector3> &p_faces) {
 		}
 	}
 
-	Vector<BVH *> bwptrs;
-	bwptrs.resize(fc);
-	BVH **bwp = bwptrs.ptrw();
-	for (int i = 0; i < fc; i++) {
-		bwp[i] = &bw[i];
-	}
-
-	max_depth = 0;
-	int max_alloc = fc;
-	_create_bvh(bw, bwp, 0, fc, 1, max_depth, max_alloc);
-
-	bvh.resize(max_alloc); //resize back
+	bvh.build(triangle_aabbs.ptr(), fc);
 
 	valid = true;
 }
 
-Vector3 TriangleMesh::get_area_normal(const AABB &p_aabb) const {
-	uint32_t *stack = (uint32_t *)alloca(sizeof(int) * max_depth);
-
-	enum {
-		TEST_AABB_BIT = 0,
-		VISIT_LEFT_BIT = 1,
-		VISIT_RIGHT_BIT = 2,
-		VISIT_DONE_BIT = 3,
-		VISITED_BIT_SHIFT = 29,
-		NODE_IDX_MASK = (1 << VISITED_BIT_SHIFT) - 1,
-		VISITED_BIT_MASK = ~NODE_IDX_MASK,
-
-	};
-
-	int n_count = 0;
-	Vector3 n;
+bool TriangleMesh::_area_normal_callback(void *p_userdata, uint32_t p_triangle) {
+	_AreaNormalParams *params = (_AreaNormalParams *)p_userdata;
+	const Triangle &s = params->triangles[p_triangle];
 
-	int level = 0;
-
-	const Triangle *triangleptr = triangles.ptr();
-	//	const Vector3 *verticesr = vertices.ptr();
-	const BVH *bvhptr = bvh.ptr();
+	AABB triangle_aabb(params->vertices[s.indices[0]], Vector3());
+	triangle_aabb.expand_to(params->vertices[s.indices[1]]);
+	triangle_aabb.expand_to(params->vertices[s.indices[2]]);
+	if (triangle_aabb.intersects(params->aabb)) {
+		params->normal += s.normal;
+		params->count++;
+	}
 
-	int pos = bvh.size() - 1;
+	return false;
+}
 
-	stack[0] = pos;
-	while (true) {
-		uint32_t node = stack[level] & NODE_IDX_MASK;
-		const BVH &b = bvhptr[node];
-		bool done = false;
+Vector3 TriangleMesh::get_area_normal(const AABB &p_aabb) const {
+	_AreaNormalParams params;
+	params.triangles = triangles.ptr();
+	params.vertices = vertices.ptr();
+	params.aabb = p_aabb;
 
-		switch (stack[level] >> VISITED_BIT_SHIFT) {
-			case TEST_AABB_BIT: {
-				bool valid = b.aabb.intersects(p_aabb);
-				if (!valid) {
-					stack[level] = (VISIT_DONE_BIT << VISITED_BIT_SHIFT) | node;
+	bvh.cull_aabb(p_aabb, _area_normal_callback, &params);
 
-				} else {
-					if (b.face_index >= 0) {
-						const Triangle &s = triangleptr[b.face_index];
-						n += s.normal;
-						n_count++;
+	if (params.count > 0) {
+		params.normal /= params.count;
+	}
 
-						stack[level] = (VISIT_DONE_BIT << VISITED_BIT_SHIFT) | node;
+	return params.normal;
+}
 
-					} else {
-						stack[level] = (VISIT_LEFT_BIT << VISITED_BIT_SHIFT) | node;
-					}
-				}
-				continue;
-			}
-			case VISIT_LEFT_BIT: {
-				stack[level] = (VISIT_RIGHT_BIT << VISITED_BIT_SHIFT) | node;
-				stack[level + 1] = b.left | TEST_AABB_BIT;
-				level++;
-				continue;
-			}
-			case VISIT_RIGHT_BIT: {
-				stack[level] = (VISIT_DONE_BIT << VISITED_BIT_SHIFT) | node;
-				stack[level + 1] = b.right | TEST_AABB_BIT;
-				level++;
-				continue;
-			}
-			case VISIT_DONE_BIT: {
-				if (level == 0) {
-					done = true;
-					break;
-				} else {
-					level--;
-				}
-				continue;
-			}
-		}
+bool TriangleMesh::_ray_callback(void *p_userdata, uint32_t p_triangle, real_t &r_max_t) {
+	_RayParams *params = (_RayParams *)p_userdata;
+	const Triangle &s = params->triangles[p_triangle];
+	Face3 f3(params->vertices[s.indices[0]], params->vertices[s.indices[1]], params->vertices[s.indices[2]]);
 
-		if (done) {
-			break;
+	Vector3 res;
+	bool inters = params->segment ? f3.intersects_segment(params->from, params->to, &res) : f3.intersects_ray(params->from, params->dir, &res);
+	if (inters) {
+		real_t t = params->dir.dot(res - params->from) / params->dir.length_squared();
+		if (t < params->min_t) {
+			params->min_t = t;
+			params->point = res;
+			params->normal = f3.get_plane().get_normal();
+			params->hit = true;
+			r_max_t = t;
 		}
 	}
 
-	if (n_count > 0) {
-		n /= n_count;
-	}
-
-	return n;
+	return false;
 }
 
 bool TriangleMesh::intersect_segment(const Vector3 &p_begin, const Vector3 &p_end, Vector3 &r_point, Vector3 &r_normal) const {
-	uint32_t *stack = (uint32_t *)alloca(sizeof(int) * max_depth);
-
-	enum {
-		TEST_AABB_BIT = 0,
-		VISIT_LEFT_BIT = 1,
-		VISIT_RIGHT_BIT = 2,
-		VISIT_DONE_BIT = 3,
-		VISITED_BIT_SHIFT = 29,
-		NODE_IDX_MASK = (1 << VISITED_BIT_SHIFT) - 1,
-		VISITED_BIT_MASK = ~NODE_IDX_MASK,
-
-	};
-
-	Vector3 n = (p_end - p_begin).normalized();
-	real_t d = 1e10;
-	bool inters = false;
-
-	int level = 0;
-
-	const Triangle *triangleptr = triangles.ptr();
-	const Vector3 *vertexptr = vertices.ptr();
-	const BVH *bvhptr = bvh.ptr();
-
-	int pos = bvh.size() - 1;
-
-	stack[0] = pos;
-	while (true) {
-		uint32_t node = stack[level] & NODE_IDX_MASK;
-		const BVH &b = bvhptr[node];
-		bool done = false;
-
-		switch (stack[level] >> VISITED_BIT_SHIFT) {
-			case TEST_AABB_BIT: {
-				bool valid = b.aabb.intersects_segment(p_begin, p_end);
-				//bool valid = b.aabb.intersects(ray_aabb);
-
-				if (!valid) {
-					stack[level] = (VISIT_DONE_BIT << VISITED_BIT_SHIFT) | node;
-
-				} else {
-					if (b.face_index >= 0) {
-						const Triangle &s = triangleptr[b.face_index];
-						Face3 f3(vertexptr[s.indices[0]], vertexptr[s.indices[1]], vertexptr[s.indices[2]]);
-
-						Vector3 res;
-
-						if (f3.intersects_segment(p_begin, p_end, &res)) {
-							real_t nd = n.dot(res);
-							if (nd < d) {
-								d = nd;
-								r_point = res;
-								r_normal = f3.get_plane().get_normal();
-								inters = true;
-							}
-						}
-
-						stack[level] = (VISIT_DONE_BIT << VISITED_BIT_SHIFT) | node;
-
-					} else {
-						stack[level] = (VISIT_LEFT_BIT << VISITED_BIT_SHIFT) | node;
-					}
-				}
-				continue;
-			}
-			case VISIT_LEFT_BIT: {
-				stack[level] = (VISIT_RIGHT_BIT << VISITED_BIT_SHIFT) | node;
-				stack[level + 1] = b.left | TEST_AABB_BIT;
-				level++;
-				continue;
-			}
-			case VISIT_RIGHT_BIT: {
-				stack[level] = (VISIT_DONE_BIT << VISITED_BIT_SHIFT) | node;
-				stack[level + 1] = b.right | TEST_AABB_BIT;
-				level++;
-				continue;
-			}
-			case VISIT_DONE_BIT: {
-				if (level == 0) {
-					done = true;
-					break;
-				} else {
-					level--;
-				}
-				continue;
-			}
-		}
-
-		if (done) {
-			break;
-		}
-	}
-
-	if (inters) {
-		if (n.dot(r_normal) > 0) {
+	_RayParams params;
+	params.triangles = triangles.ptr();
+	params.vertices = vertices.ptr();
+	params.from = p_begin;
+	params.to = p_end;
+	params.dir = p_end - p_begin;
+	params.segment = true;
+
+	bvh.cull_segment(p_begin, p_end, _ray_callback, &params);
+
+	if (params.hit) {
+		r_point = params.point;
+		r_normal = params.normal;
+		if (params.dir.dot(r_normal) > 0) {
 			r_normal = -r_normal;
 		}
 	}
 
-	return inters;
+	return params.hit;
 }
 
 bool TriangleMesh::intersect_ray(const Vector3 &p_begin, const Vector3 &p_dir, Vector3 &r_point, Vector3 &r_normal) const {
-	uint32_t *stack = (uint32_t *)alloca(sizeof(int) * max_depth);
-
-	enum {
-		TEST_AABB_BIT = 0,
-		VISIT_LEFT_BIT = 1,
-		VISIT_RIGHT_BIT = 2,
-		VISIT_DONE_BIT = 3,
-		VISITED_BIT_SHIFT = 29,
-		NODE_IDX_MASK = (1 << VISITED_BIT_SHIFT) - 1,
-		VISITED_BIT_MASK = ~NODE_IDX_MASK,
-
-	};
-
-	Vector3 n = p_dir;
-	real_t d = 1e20;
-	bool inters = false;
-
-	int level = 0;
-
-	const Triangle *triangleptr = triangles.ptr();
-	const Vector3 *vertexptr = vertices.ptr();
-	const BVH *bvhptr = bvh.ptr();
-
-	int pos = bvh.size() - 1;
+	_RayParams params;
+	params.triangles = triangles.ptr();
+	params.vertices = vertices.ptr();
+	params.from = p_begin;
+	params.dir = p_dir;
+
+	bvh.cull_ray(p_begin, p_dir, 1e20, _ray_callback, &params);
+
+	if (params.hit) {
+		r_point = params.point;
+		r_normal = params.normal;
+		if (p_dir.dot(r_normal) > 0) {
+			r_normal = -r_normal;
+		}
+	}
 
-	stack[0] = pos;
-	while (true) {
-		uint32_t node = stack[level] & NODE_IDX_MASK;
-		const BVH &b = bvhptr[node];
-		bool done = false;
+	return params.hit;
+}
 
-		switch (stack[level] >> VISITED_BIT_SHIFT) {
-			case TEST_AABB_BIT: {
-				bool valid = b.aabb.intersects_ray(p_begin, p_dir);
-				if (!valid) {
-					stack[level] = (VISIT_DONE_BIT << VISITED_BIT_SHIFT) | node;
+TriangleBVH::AABBTestResult TriangleMesh::_intersect_convex_aabb_test(void *p_userdata, const AABB &p_aabb) {
+	_ConvexParams *params = (_ConvexParams *)p_userdata;
+	if (p_aabb.intersects_convex_shape(params->planes, params->plane_count, params->points, params->point_count)) {
+		return TriangleBVH::AABB_TEST_HIT;
+	}
+	return TriangleBVH::AABB_TEST_MISS;
+}
 
-				} else {
-					if (b.face_index >= 0) {
-						const Triangle &s = triangleptr[b.face_index];
-						Face3 f3(vertexptr[s.indices[0]], vertexptr[s.indices[1]], vertexptr[s.indices[2]]);
-
-						Vector3 res;
-
-						if (f3.intersects_ray(p_begin, p_dir, &res)) {
-							real_t nd = n.dot(res);
-							if (nd < d) {
-								d = nd;
-								r_point = res;
-								r_normal = f3.get_plane().get_normal();
-								inters = true;
-							}
-						}
-
-						stack[level] = (VISIT_DONE_BIT << VISITED_BIT_SHIFT) | node;
-
-					} else {
-						stack[level] = (VISIT_LEFT_BIT << VISITED_BIT_SHIFT) | node;
+bool TriangleMesh::_intersect_convex_callback(void *p_userdata, uint32_t p_triangle) {
+	_ConvexParams *params = (_ConvexParams *)p_userdata;
+	const Triangle &s = params->triangles[p_triangle];
+	const Plane *p_planes = params->planes;
+	int p_plane_count = params->plane_count;
+
+	for (int j = 0; j < 3; ++j) {
+		const Vector3 &point = params->vertices[s.indices[j]];
+		const Vector3 &next_point = params->vertices[s.indices[(j + 1) % 3]];
+		Vector3 res;
+		bool over = true;
+		for (int i = 0; i < p_plane_count; i++) {
+			const Plane &p = p_planes[i];
+
+			if (p.intersects_segment(point, next_point, &res)) {
+				bool inisde = true;
+				for (int k = 0; k < p_plane_count; k++) {
+					if (k == i) {
+						continue;
+					}
+					const Plane &pp = p_planes[k];
+					if (pp.is_point_over(res)) {
+						inisde = false;
+						break;
 					}
 				}
-				continue;
-			}
-			case VISIT_LEFT_BIT: {
-				stack[level] = (VISIT_RIGHT_BIT << VISITED_BIT_SHIFT) | node;
-				stack[level + 1] = b.left | TEST_AABB_BIT;
-				level++;
-				continue;
-			}
-			case VISIT_RIGHT_BIT: {
-				stack[level] = (VISIT_DONE_BIT << VISITED_BIT_SHIFT) | node;
-				stack[level + 1] = b.right | TEST_AABB_BIT;
-				level++;
-				continue;
-			}
-			case VISIT_DONE_BIT: {
-				if (level == 0) {
-					done = true;
-					break;
-				} else {
-					level--;
+				if (inisde) {
+					return true;
 				}
-				continue;
 			}
-		}
 
-		if (done) {
-			break;
+			if (p.is_point_over(point)) {
+				over = false;
+				break;
+			}
 		}
-	}
-
-	if (inters) {
-		if (n.dot(r_normal) > 0) {
-			r_normal = -r_normal;
+		if (over) {
+			return true;
 		}
 	}
 
-	return inters;
+	return false;
 }
 
 bool TriangleMesh::intersect_convex_shape(const Plane *p_planes, int p_plane_count, const Vector3 *p_points, int p_point_count) const {
-	uint32_t *stack = (uint32_t *)alloca(sizeof(int) * max_depth);
-
-	//p_fully_inside = true;
-
-	enum {
-		TEST_AABB_BIT = 0,
-		VISIT_LEFT_BIT = 1,
-		VISIT_RIGHT_BIT = 2,
-		VISIT_DONE_BIT = 3,
-		VISITED_BIT_SHIFT = 29,
-		NODE_IDX_MASK = (1 << VISITED_BIT_SHIFT) - 1,
-		VISITED_BIT_MASK = ~NODE_IDX_MASK,
-
-	};
-
-	int level = 0;
-
-	const Triangle *triangleptr = triangles.ptr();
-	const Vector3 *vertexptr = vertices.ptr();
-	const BVH *bvhptr = bvh.ptr();
+	_ConvexParams params;
+	params.triangles = triangles.ptr();
+	params.vertices = vertices.ptr();
+	params.planes = p_planes;
+	params.plane_count = p_plane_count;
+	params.points = p_points;
+	params.point_count = p_point_count;
+
+	return bvh.cull_custom(_intersect_convex_aabb_test, _intersect_convex_callback, &params);
+}
 
-	int pos = bvh.size() - 1;
+TriangleBVH::AABBTestResult TriangleMesh::_inside_convex_aabb_test(void *p_userdata, const AABB &p_aabb) {
+	_ConvexParams *params = (_ConvexParams *)p_userdata;
+	AABB aabb = params->scale.xform(p_aabb);
 
-	stack[0] = pos;
-	while (true) {
-		uint32_t node = stack[level] & NODE_IDX_MASK;
-		const BVH &b = bvhptr[node];
-		bool done = false;
+	if (!aabb.intersects_convex_shape(params->planes, params->plane_count, params->points, params->point_count)) {
+		return TriangleBVH::AABB_TEST_STOP;
+	}
+	if (aabb.inside_convex_shape(params->planes, params->plane_count)) {
+		return TriangleBVH::AABB_TEST_MISS;
+	}
+	return TriangleBVH::AABB_TEST_HIT;
+}
 
-		switch (stack[level] >> VISITED_BIT_SHIFT) {
-			case TEST_AABB_BIT: {
-				bool valid = b.aabb.intersects_convex_shape(p_planes, p_plane_count, p_points, p_point_count);
-				if (!valid) {
-					stack[level] = (VISIT_DONE_BIT << VISITED_BIT_SHIFT) | node;
+bool TriangleMesh::_inside_convex_callback(void *p_userdata, uint32_t p_triangle) {
+	_ConvexParams *params = (_ConvexParams *)p_userdata;
+	const Triangle &s = params->triangles[p_triangle];
 
-				} else {
-					if (b.face_index >= 0) {
-						const Triangle &s = triangleptr[b.face_index];
-
-						for (int j = 0; j < 3; ++j) {
-							const Vector3 &point = vertexptr[s.indices[j]];
-							const Vector3 &next_point = vertexptr[s.indices[(j + 1) % 3]];
-							Vector3 res;
-							bool over = true;
-							for (int i = 0; i < p_plane_count; i++) {
-								const Plane &p = p_planes[i];
-
-								if (p.intersects_segment(point, next_point, &res)) {
-									bool inisde = true;
-									for (int k = 0; k < p_plane_count; k++) {
-										if (k == i) {
-											continue;
-										}
-										const Plane &pp = p_planes[k];
-										if (pp.is_point_over(res)) {
-											inisde = false;
-											break;
-										}
-									}
-									if (inisde) {
-										return true;
-									}
-								}
-
-								if (p.is_point_over(point)) {
-									over = false;
-									break;
-								}
-							}
-							if (over) {
-								return true;
-							}
-						}
-
-						stack[level] = (VISIT_DONE_BIT << VISITED_BIT_SHIFT) | node;
-
-					} else {
-						stack[level] = (VISIT_LEFT_BIT << VISITED_BIT_SHIFT) | node;
-					}
-				}
-				continue;
-			}
-			case VISIT_LEFT_BIT: {
-				stack[level] = (VISIT_RIGHT_BIT << VISITED_BIT_SHIFT) | node;
-				stack[level + 1] = b.left | TEST_AABB_BIT;
-				level++;
-				continue;
-			}
-			case VISIT_RIGHT_BIT: {
-				stack[level] = (VISIT_DONE_BIT << VISITED_BIT_SHIFT) | node;
-				stack[level + 1] = b.right | TEST_AABB_BIT;
-				level++;
-				continue;
+	for (int j = 0; j < 3; ++j) {
+		Vector3 point = params->scale.xform(params->vertices[s.indices[j]]);
+		for (int i = 0; i < params->plane_count; i++) {
+			if (params->planes[i].is_point_over(point)) {
+				return true;
 			}
-			case VISIT_DONE_BIT: {
-				if (level == 0) {
-					done = true;
-					break;
-				} else {
-					level--;
-				}
-				continue;
-			}
-		}
-
-		if (done) {
-			break;
 		}
 	}
 
@@ -581,96 +297,17 @@ bool TriangleMesh::intersect_convex_shape(const Plane *p_planes, int p_plane_cou
 }
 
 bool TriangleMesh::inside_convex_shape(const Plane *p_planes, int p_plane_count, const Vector3 *p_points, int p_point_count, Vector3 p_scale) const {
-	uint32_t *stack = (uint32_t *)alloca(sizeof(int) * max_depth);
-
-	enum {
-		TEST_AABB_BIT = 0,
-		VISIT_LEFT_BIT = 1,
-		VISIT_RIGHT_BIT = 2,
-		VISIT_DONE_BIT = 3,
-		VISITED_BIT_SHIFT = 29,
-		NODE_IDX_MASK = (1 << VISITED_BIT_SHIFT) - 1,
-		VISITED_BIT_MASK = ~NODE_IDX_MASK,
-
-	};
-
-	int level = 0;
-
-	const Triangle *triangleptr = triangles.ptr();
-	const Vector3 *vertexptr = vertices.ptr();
-	const BVH *bvhptr = bvh.ptr();
-
-	Transform scale(Basis().scaled(p_scale));
-
-	int pos = bvh.size() - 1;
-
-	stack[0] = pos;
-	while (true) {
-		uint32_t node = stack[level] & NODE_IDX_MASK;
-		const BVH &b = bvhptr[node];
-		bool done = false;
-
-		switch (stack[level] >> VISITED_BIT_SHIFT) {
-			case TEST_AABB_BIT: {
-				bool intersects = scale.xform(b.aabb).intersects_convex_shape(p_planes, p_plane_count, p_points, p_point_count);
-				if (!intersects) {
-					return false;
-				}
-
-				bool inside = scale.xform(b.aabb).inside_convex_shape(p_planes, p_plane_count);
-				if (inside) {
-					stack[level] = (VISIT_DONE_BIT << VISITED_BIT_SHIFT) | node;
-
-				} else {
-					if (b.face_index >= 0) {
-						const Triangle &s = triangleptr[b.face_index];
-						for (int j = 0; j < 3; ++j) {
-							Vector3 point = scale.xform(vertexptr[s.indices[j]]);
-							for (int i = 0; i < p_plane_count; i++) {
-								const Plane &p = p_planes[i];
-								if (p.is_point_over(point)) {
-									return false;
-								}
-							}
-						}
-
-						stack[level] = (VISIT_DONE_BIT << VISITED_BIT_SHIFT) | node;
-
-					} else {
-						stack[level] = (VISIT_LEFT_BIT << VISITED_BIT_SHIFT) | node;
-					}
-				}
-				continue;
-			}
-			case VISIT_LEFT_BIT: {
-				stack[level] = (VISIT_RIGHT_BIT << VISITED_BIT_SHIFT) | node;
-				stack[level + 1] = b.left | TEST_AABB_BIT;
-				level++;
-				continue;
-			}
-			case VISIT_RIGHT_BIT: {
-				stack[level] = (VISIT_DONE_BIT << VISITED_BIT_SHIFT) | node;
-				stack[level + 1] = b.right | TEST_AABB_BIT;
-				level++;
-				continue;
-			}
-			case VISIT_DONE_BIT: {
-				if (level == 0) {
-					done = true;
-					break;
-				} else {
-					level--;
-				}
-				continue;
-			}
-		}
-
-		if (done) {
-			break;
-		}
-	}
-
-	return true;
+	_ConvexParams params;
+	params.triangles = triangles.ptr();
+	params.vertices = vertices.ptr();
+	params.planes = p_planes;
+	params.plane_count = p_plane_count;
+	params.points = p_points;
+	params.point_count = p_point_count;
+	params.scale = Transform(Basis().scaled(p_scale));
+
+	// Stopping means part of the mesh lies outside.
+	return !bvh.cull_custom(_inside_convex_aabb_test, _inside_convex_callback, &params);
 }
 
 bool TriangleMesh::is_valid() const {
@@ -701,5 +338,4 @@ Vector<Face3> TriangleMesh::get_faces() const {
 
 TriangleMesh::TriangleMesh() {
 	valid = false;
-	max_depth = 0;
 }
@@ -32,6 +32,8 @@
 #define TRIANGLE_MESH_H
 
 #include "core/math/face3.h"
+#include "core/math/transform.h"
+#include "core/math/triangle_bvh.h"
 #include "core/object/reference.h"
 
 class TriangleMesh : public Reference {
@@ -45,37 +47,48 @@ class TriangleMesh : public Reference {
 	Vector<Triangle> triangles;
 	Vector<Vector3> vertices;
 
-	struct BVH {
-		AABB aabb;
-		Vector3 center; //used for sorting
-		int left;
-		int right;
+	TriangleBVH bvh;
+	bool valid;
 
-		int face_index;
-	};
+	struct _RayParams {
+		const Triangle *triangles = nullptr;
+		const Vector3 *vertices = nullptr;
+		Vector3 from;
+		Vector3 to;
+		Vector3 dir;
+		bool segment = false;
 
-	struct BVHCmpX {
-		bool operator()(const BVH *p_left, const BVH *p_right) const {
-			return p_left->center.x < p_right->center.x;
-		}
+		Vector3 point;
+		Vector3 normal;
+		real_t min_t = 1e20;
+		bool hit = false;
 	};
 
-	struct BVHCmpY {
-		bool operator()(const BVH *p_left, const BVH *p_right) const {
-			return p_left->center.y < p_right->center.y;
-		}
-	};
-	struct BVHCmpZ {
-		bool operator()(const BVH *p_left, const BVH *p_right) const {
-			return p_left->center.z < p_right->center.z;
-		}
+	struct _AreaNormalParams {
+		const Triangle *triangles = nullptr;
+		const Vector3 *vertices = nullptr;
+		AABB aabb;
+
+		Vector3 normal;
+		int count = 0;
 	};
 
-	int _create_bvh(BVH *p_bvh, BVH **p_bb, int p_from, int p_size, int p_depth, int &max_depth, int &max_alloc);
+	struct _ConvexParams {
+		const Triangle *triangles = nullptr;
+		const Vector3 *vertices = nullptr;
+		const Plane *planes = nullptr;
+		int plane_count = 0;
+		const Vector3 *points = nullptr;
+		int point_count = 0;
+		Transform scale;
+	};
 
-	Vector<BVH> bvh;
-	int max_depth;
-	bool valid;
+	static bool _ray_callback(void *p_userdata, uint32_t p_triangle, real_t &r_max_t);
+	static bool _area_normal_callback(void *p_userdata, uint32_t p_triangle);
+	static TriangleBVH::AABBTestResult _intersect_convex_aabb_test(void *p_userdata, const AABB &p_aabb);
+	static bool _intersect_convex_callback(void *p_userdata, uint32_t p_triangle);
+	static TriangleBVH::AABBTestResult _inside_convex_aabb_test(void *p_userdata, const AABB &p_aabb);
+	static bool _inside_convex_callback(void *p_userdata, uint32_t p_triangle);
 
 public:
 	bool is_valid() const;
@@ -54,6 +54,11 @@
 #define snprintf _snprintf_s
 #endif
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define USTRING_USE_SSE2
+#include <emmintrin.h>
+#endif
+
 #define MAX_DIGITS 6
 #define UPPERCASE(m_c) (((m_c) >= 'a' && (m_c) <= 'z') ? ((m_c) - ('a' - 'A')) : (m_c))
 #define LOWERCASE(m_c) (((m_c) >= 'A' && (m_c) <= 'Z') ? ((m_c) + ('a' - 'A')) : (m_c))
@@ -1759,6 +1764,301 @@ CharString String::ascii(bool p_allow_extended) const {
 	return cs;
 }
 
+/*
+ * Transcoding helpers. They only handle the common case quickly (ASCII runs
+ * 16 characters at a time, BMP runs 8 at a time) and stop at anything else,
+ * leaving it to the per code point loops, so errors are reported as before.
+ */
+
+#ifdef USTRING_USE_SSE2
+static _FORCE_INLINE_ int _first_set_bit(uint32_t p_mask) {
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward(&index, p_mask);
+	return index;
+#else
+	return __builtin_ctz(p_mask);
+#endif
+}
+#endif
+
+// Counts the bytes before the first NUL and the UTF-8 lead bytes among them,
+// which is the character count of valid input.
+static int _utf8_count_chars(const uint8_t *p_utf8, int p_len, int &r_len) {
+	int count = 0;
+	int i = 0;
+#ifdef USTRING_USE_SSE2
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i one = _mm_set1_epi8(1);
+	const __m128i last_continuation = _mm_set1_epi8(int8_t(0xbf));
+	__m128i leads = zero;
+	for (; i + 16 <= p_len; i += 16) {
+		__m128i v = _mm_loadu_si128((const __m128i *)(p_utf8 + i));
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(v, zero))) {
+			break;
+		}
+		// Continuation bytes are 0x80 to 0xBF, the smallest signed values.
+		__m128i lead = _mm_and_si128(_mm_cmpgt_epi8(v, last_continuation), one);
+		leads = _mm_add_epi64(leads, _mm_sad_epu8(lead, zero));
+	}
+	count = _mm_cvtsi128_si32(leads) + _mm_cvtsi128_si32(_mm_unpackhi_epi64(leads, leads));
+#endif
+	for (; i < p_len && p_utf8[i]; i++) {
+		count += (p_utf8[i] & 0xc0) != 0x80;
+	}
+	r_len = i;
+	return count;
+}
+
+// Decodes exactly p_count characters of UTF-8 accepted by the validating
+// decoder in String::parse_utf8(). Returns false on anything else.
+static bool _utf8_decode(const uint8_t *p_utf8, int p_len, char32_t *p_dst, int p_count) {
+	const uint8_t *src = p_utf8;
+	const uint8_t *src_end = p_utf8 + p_len;
+	char32_t *dst = p_dst;
+	char32_t *dst_end = p_dst + p_count;
+
+	while (src < src_end) {
+		uint8_t c = *src;
+		if (c < 0x80) {
+#ifdef USTRING_USE_SSE2
+			if (src_end - src >= 16 && dst_end - dst >= 16) {
+				// Widen all 16 bytes, but only keep the leading ASCII run.
+				const __m128i zero = _mm_setzero_si128();
+				__m128i v = _mm_loadu_si128((const __m128i *)src);
+				__m128i lo = _mm_unpacklo_epi8(v, zero);
+				__m128i hi = _mm_unpackhi_epi8(v, zero);
+				_mm_storeu_si128((__m128i *)dst, _mm_unpacklo_epi16(lo, zero));
+				_mm_storeu_si128((__m128i *)(dst + 4), _mm_unpackhi_epi16(lo, zero));
+				_mm_storeu_si128((__m128i *)(dst + 8), _mm_unpacklo_epi16(hi, zero));
+				_mm_storeu_si128((__m128i *)(dst + 12), _mm_unpackhi_epi16(hi, zero));
+				uint32_t non_ascii = _mm_movemask_epi8(v);
+				int ascii = non_ascii ? _first_set_bit(non_ascii) : 16;
+				src += ascii;
+				dst += ascii;
+				continue;
+			}
+#endif
+			if (dst == dst_end) {
+				return false;
+			}
+			*(dst++) = c;
+			src++;
+			continue;
+		}
+
+		int len;
+		uint32_t unichar;
+		if ((c & 0xe0) == 0xc0) {
+			if ((c & 0x1e) == 0) {
+				return false; // Overlong.
+			}
+			len = 2;
+			unichar = c & 0x1f;
+		} else if ((c & 0xf0) == 0xe0) {
+			len = 3;
+			unichar = c & 0x0f;
+		} else if ((c & 0xf8) == 0xf0) {
+			len = 4;
+			unichar = c & 0x07;
+		} else {
+			return false;
+		}
+
+		if (src_end - src < len || dst == dst_end) {
+			return false;
+		}
+		for (int i = 1; i < len; i++) {
+			if ((src[i] & 0xc0) != 0x80) {
+				return false;
+			}
+			if (unichar == 0 && i == 2 && ((src[i] & 0x7f) >> (7 - len)) == 0) {
+				return false; // Overlong.
+			}
+			unichar = (unichar << 6) | (src[i] & 0x3f);
+		}
+		if (unichar >= 0xd800 && unichar <= 0xdfff) {
+			return false;
+		}
+
+		*(dst++) = unichar;
+		src += len;
+	}
+
+	return dst == dst_end;
+}
+
+#ifdef USTRING_USE_SSE2
+// Returns a mask of the code points which can't be encoded: surrogates and
+// values above 0x10FFFF.
+static _FORCE_INLINE_ __m128i _invalid_code_points(__m128i p_v) {
+	const __m128i sign = _mm_set1_epi32(int32_t(0x80000000));
+	__m128i above_max = _mm_cmpgt_epi32(_mm_xor_si128(p_v, sign), _mm_set1_epi32(int32_t(0x8010ffff)));
+	__m128i surrogate = _mm_cmpeq_epi32(_mm_and_si128(p_v, _mm_set1_epi32(int32_t(0xfffff800))), _mm_set1_epi32(0xd800));
+	return _mm_or_si128(above_max, surrogate);
+}
+
+static _FORCE_INLINE_ int _sum_epi32(__m128i p_v) {
+	p_v = _mm_add_epi32(p_v, _mm_shuffle_epi32(p_v, _MM_SHUFFLE(1, 0, 3, 2)));
+	p_v = _mm_add_epi32(p_v, _mm_shuffle_epi32(p_v, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(p_v);
+}
+#endif
+
+// Adds up the UTF-8 length of valid code points, 4 at a time, and sets r_pos
+// to where it stopped.
+static int _utf8_count_bytes(const char32_t *p_str, int p_len, int &r_pos) {
+	int i = 0;
+	int bytes = 0;
+#ifdef USTRING_USE_SSE2
+	__m128i extra = _mm_setzero_si128();
+	for (; i + 4 <= p_len; i += 4) {
+		__m128i v = _mm_loadu_si128((const __m128i *)(p_str + i));
+		if (_mm_movemask_epi8(_invalid_code_points(v))) {
+			break;
+		}
+		// Valid code points are positive, so signed comparisons work. They
+		// give -1 for every byte past the first.
+		extra = _mm_add_epi32(extra, _mm_cmpgt_epi32(v, _mm_set1_epi32(0x7f)));
+		extra = _mm_add_epi32(extra, _mm_cmpgt_epi32(v, _mm_set1_epi32(0x7ff)));
+		extra = _mm_add_epi32(extra, _mm_cmpgt_epi32(v, _mm_set1_epi32(0xffff)));
+	}
+	bytes = i - _sum_epi32(extra);
+#endif
+	r_pos = i;
+	return bytes;
+}
+
+#ifdef USTRING_USE_SSE2
+// Returns a mask of the lanes of p_v0 to p_v3 with bits of p_bits set, one
+// bit per lane.
+static _FORCE_INLINE_ uint32_t _lanes_with_bits(__m128i p_v0, __m128i p_v1, __m128i p_v2, __m128i p_v3, __m128i p_bits) {
+	const __m128i zero = _mm_setzero_si128();
+	__m128i m0 = _mm_cmpeq_epi32(_mm_and_si128(p_v0, p_bits), zero);
+	__m128i m1 = _mm_cmpeq_epi32(_mm_and_si128(p_v1, p_bits), zero);
+	__m128i m2 = _mm_cmpeq_epi32(_mm_and_si128(p_v2, p_bits), zero);
+	__m128i m3 = _mm_cmpeq_epi32(_mm_and_si128(p_v3, p_bits), zero);
+	return ~_mm_movemask_epi8(_mm_packs_epi16(_mm_packs_epi32(m0, m1), _mm_packs_epi32(m2, m3))) & 0xffff;
+}
+#endif
+
+// Encodes a run of ASCII, 16 characters at a time. Returns the number of
+// characters encoded.
+static int _utf8_encode_ascii(const char32_t *p_str, int p_len, uint8_t *p_dst) {
+	int i = 0;
+#ifdef USTRING_USE_SSE2
+	const __m128i non_ascii = _mm_set1_epi32(int32_t(0xffffff80));
+	for (; i + 16 <= p_len; i += 16) {
+		__m128i v0 = _mm_loadu_si128((const __m128i *)(p_str + i));
+		__m128i v1 = _mm_loadu_si128((const __m128i *)(p_str + i + 4));
+		__m128i v2 = _mm_loadu_si128((const __m128i *)(p_str + i + 8));
+		__m128i v3 = _mm_loadu_si128((const __m128i *)(p_str + i + 12));
+		// Each of the 16 characters takes at least a byte, so there is room to
+		// store all of them and only keep the leading ASCII run.
+		__m128i bytes = _mm_packus_epi16(_mm_packs_epi32(v0, v1), _mm_packs_epi32(v2, v3));
+		_mm_storeu_si128((__m128i *)(p_dst + i), bytes);
+		uint32_t mask = _lanes_with_bits(v0, v1, v2, v3, non_ascii);
+		if (mask) {
+			return i + _first_set_bit(mask);
+		}
+	}
+#endif
+	return i;
+}
+
+// Adds up the UTF-16 length of valid code points, 4 at a time, and sets r_pos
+// to where it stopped.
+static int _utf16_count_units(const char32_t *p_str, int p_len, int &r_pos) {
+	int i = 0;
+	int units = 0;
+#ifdef USTRING_USE_SSE2
+	__m128i extra = _mm_setzero_si128();
+	for (; i + 4 <= p_len; i += 4) {
+		__m128i v = _mm_loadu_si128((const __m128i *)(p_str + i));
+		if (_mm_movemask_epi8(_invalid_code_points(v))) {
+			break;
+		}
+		extra = _mm_add_epi32(extra, _mm_cmpgt_epi32(v, _mm_set1_epi32(0xffff)));
+	}
+	units = i - _sum_epi32(extra);
+#endif
+	r_pos = i;
+	return units;
+}
+
+// Encodes a run of BMP characters, 8 at a time. Returns the number of
+// characters encoded. Surrogates must have been rejected already, and there
+// must be room for 8 units past the end of the run.
+static int _utf16_encode_bmp(const char32_t *p_str, int p_len, uint16_t *p_dst) {
+	int i = 0;
+#ifdef USTRING_USE_SSE2
+	const __m128i non_bmp = _mm_set1_epi32(int32_t(0xffff0000));
+	const __m128i bias32 = _mm_set1_epi32(0x8000);
+	const __m128i bias16 = _mm_set1_epi16(int16_t(0x8000));
+	for (; i + 8 <= p_len; i += 8) {
+		__m128i v0 = _mm_loadu_si128((const __m128i *)(p_str + i));
+		__m128i v1 = _mm_loadu_si128((const __m128i *)(p_str + i + 4));
+		// There is no unsigned 32 to 16 bit pack in SSE2, so shift the range
+		// to signed and back. Only the leading BMP run is kept.
+		__m128i units = _mm_packs_epi32(_mm_sub_epi32(v0, bias32), _mm_sub_epi32(v1, bias32));
+		_mm_storeu_si128((__m128i *)(p_dst + i), _mm_add_epi16(units, bias16));
+		uint32_t mask = _lanes_with_bits(v0, v1, _mm_setzero_si128(), _mm_setzero_si128(), non_bmp);
+		if (mask) {
+			return i + _first_set_bit(mask);
+		}
+	}
+#endif
+	return i;
+}
+
+#ifdef USTRING_USE_SSE2
+static _FORCE_INLINE_ __m128i _load_utf16(const char16_t *p_src, bool p_byteswap) {
+	__m128i v = _mm_loadu_si128((const __m128i *)p_src);
+	if (p_byteswap) {
+		v = _mm_or_si128(_mm_slli_epi16(v, 8), _mm_srli_epi16(v, 8));
+	}
+	return v;
+}
+
+// Returns a mask with two bits for each surrogate unit.
+static _FORCE_INLINE_ uint32_t _surrogates(__m128i p_v) {
+	return _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(p_v, _mm_set1_epi16(int16_t(0xf800))), _mm_set1_epi16(int16_t(0xd800))));
+}
+#endif
+
+// Counts a run of UTF-16 units without surrogates or NULs, 8 at a time.
+static int _utf16_count_bmp(const char16_t *p_utf16, int p_len, bool p_byteswap) {
+	int i = 0;
+#ifdef USTRING_USE_SSE2
+	for (; i + 8 <= p_len; i += 8) {
+		__m128i v = _load_utf16(p_utf16 + i, p_byteswap);
+		uint32_t mask = _surrogates(v) | _mm_movemask_epi8(_mm_cmpeq_epi16(v, _mm_setzero_si128()));
+		if (mask) {
+			return i + _first_set_bit(mask) / 2;
+		}
+	}
+#endif
+	return i;
+}
+
+// Decodes a run of UTF-16 units without surrogates, 8 at a time, into at
+// most p_dst_len characters. Returns the number of units decoded.
+static int _utf16_decode_bmp(const char16_t *p_utf16, int p_len, bool p_byteswap, char32_t *p_dst, int p_dst_len) {
+	int i = 0;
+#ifdef USTRING_USE_SSE2
+	for (; i + 8 <= p_len && i + 8 <= p_dst_len; i += 8) {
+		__m128i v = _load_utf16(p_utf16 + i, p_byteswap);
+		_mm_storeu_si128((__m128i *)(p_dst + i), _mm_unpacklo_epi16(v, _mm_setzero_si128()));
+		_mm_storeu_si128((__m128i *)(p_dst + i + 4), _mm_unpackhi_epi16(v, _mm_setzero_si128()));
+		uint32_t mask = _surrogates(v);
+		if (mask) {
+			return i + _first_set_bit(mask) / 2;
+		}
+	}
+#endif
+	return i;
+}
+
 String String::utf8(const char *p_utf8, int p_len) {
 	String ret;
 	ret.parse_utf8(p_utf8, p_len);
@@ -1778,18 +2078,36 @@ bool String::parse_utf8(const char *p_utf8, int p_len) {
 	int cstr_size = 0;
 	int str_size = 0;
 
+	if (p_len < 0) {
+		p_len = strlen(p_utf8);
+	}
+
 	/* HANDLE BOM (Byte Order Mark) */
-	if (p_len < 0 || p_len >= 3) {
+	if (p_len >= 3) {
 		bool has_bom = uint8_t(p_utf8[0]) == 0xef && uint8_t(p_utf8[1]) == 0xbb && uint8_t(p_utf8[2]) == 0xbf;
 		if (has_bom) {
 			//8-bit encoding, byte order has no meaning in UTF-8, just skip it
-			if (p_len >= 0) {
-				p_len -= 3;
-			}
+			p_len -= 3;
 			p_utf8 += 3;
 		}
 	}
 
+	{
+		// Valid input is counted and decoded in one go, anything else goes
+		// through the checks below to report the error.
+		int valid_len = 0;
+		int valid_size = _utf8_count_chars((const uint8_t *)p_utf8, p_len, valid_len);
+		if (valid_size > 0) {
+			aux.resize(valid_size + 1);
+			char32_t *dst = aux.ptrw();
+			if (_utf8_decode((const uint8_t *)p_utf8, valid_len, dst, valid_size)) {
+				dst[valid_size] = 0;
+				*this = aux;
+				return false;
+			}
+		}
+	}
+
 	{
 		const char *ptrtmp = p_utf8;
 		const char *ptrtmp_limit = &p_utf8[p_len];
@@ -1911,8 +2229,9 @@ CharString String::utf8() const {
 	}
 
 	const char32_t *d = &operator[](0);
-	int fl = 0;
-	for (int i = 0; i < l; i++) {
+	int i = 0;
+	int fl = _utf8_count_bytes(d, l, i);
+	for (; i < l; i++) {
 		uint32_t c = d[i];
 		if (c <= 0x7f) { // 7 bits.
 			fl += 1;
@@ -1942,10 +2261,16 @@ CharString String::utf8() const {
 
 #define APPEND_CHAR(m_c) *(cdst++) = m_c
 
-	for (int i = 0; i < l; i++) {
+	for (i = 0; i < l; i++) {
 		uint32_t c = d[i];
 
 		if (c <= 0x7f) { // 7 bits.
+			int ascii = _utf8_encode_ascii(d + i, l - i, cdst);
+			if (ascii) {
+				cdst += ascii;
+				i += ascii - 1;
+				continue;
+			}
 			APPEND_CHAR(c);
 		} else if (c <= 0x7ff) { // 11 bits
 			APPEND_CHAR(uint32_t(0xc0 | ((c >> 6) & 0x1f))); // Top 5 bits.
@@ -2010,6 +2335,15 @@ bool String::parse_utf16(const char16_t *p_utf16, int p_len) {
 		const char16_t *ptrtmp_limit = &p_utf16[p_len];
 		int skip = 0;
 		while (ptrtmp != ptrtmp_limit && *ptrtmp) {
+			if (skip == 0 && p_len >= 0) {
+				int bmp = _utf16_count_bmp(ptrtmp, ptrtmp_limit - ptrtmp, byteswap);
+				if (bmp) {
+					str_size += bmp;
+					cstr_size += bmp;
+					ptrtmp += bmp;
+					continue;
+				}
+			}
 			uint32_t c = (byteswap) ? BSWAP16(*ptrtmp) : *ptrtmp;
 			if (skip == 0) {
 				if ((c & 0xfffffc00) == 0xd800) {
@@ -2049,7 +2383,16 @@ bool String::parse_utf16(const char16_t *p_utf16, int p_len) {
 	char32_t *dst = ptrw();
 	dst[str_size] = 0;
 
+	char32_t *dst_end = dst + str_size;
 	while (cstr_size) {
+		int bmp = _utf16_decode_bmp(p_utf16, cstr_size, byteswap, dst, dst_end - dst);
+		if (bmp) {
+			dst += bmp;
+			cstr_size -= bmp;
+			p_utf16 += bmp;
+			continue;
+		}
+
 		int len = 0;
 		uint32_t c = (byteswap) ? BSWAP16(*p_utf16) : *p_utf16;
 
@@ -2088,8 +2431,9 @@ Char16String String::utf16() const {
 	}
 
 	const char32_t *d = &operator[](0);
-	int fl = 0;
-	for (int i = 0; i < l; i++) {
+	int i = 0;
+	int fl = _utf16_count_units(d, l, i);
+	for (; i < l; i++) {
 		uint32_t c = d[i];
 		if (c <= 0xffff) { // 16 bits.
 			fl += 1;
@@ -2115,10 +2459,16 @@ Char16String String::utf16() const {
 
 #define APPEND_CHAR(m_c) *(cdst++) = m_c
 
-	for (int i = 0; i < l; i++) {
+	for (i = 0; i < l; i++) {
 		uint32_t c = d[i];
 
 		if (c <= 0xffff) { // 16 bits.
+			int bmp = _utf16_encode_bmp(d + i, l - i, cdst);
+			if (bmp) {
+				cdst += bmp;
+				i += bmp - 1;
+				continue;
+			}
 			APPEND_CHAR(c);
 		} else { // 32 bits.
 			APPEND_CHAR(uint32_t((c >> 10) + 0xd7c0)); // lead surrogate.
@@ -33,72 +33,97 @@
 #include "core/config/project_settings.h"
 #include "core/os/os.h"
 
-void CommandQueueMT::lock() {
-	mutex.lock();
-}
-
-void CommandQueueMT::unlock() {
-	mutex.unlock();
-}
-
 void CommandQueueMT::wait_for_flush() {
 	// wait one millisecond for a flush to happen
 	OS::get_singleton()->delay_usec(1000);
 }
 
 CommandQueueMT::SyncSemaphore *CommandQueueMT::_alloc_sync_sem() {
-	int idx = -1;
-
-	while (true) {
-		lock();
-		for (int i = 0; i < SYNC_SEMAPHORES; i++) {
-			if (!sync_sems[i].in_use) {
-				sync_sems[i].in_use = true;
-				idx = i;
-				break;
-			}
-		}
-		unlock();
-
-		if (idx == -1) {
-			wait_for_flush();
-		} else {
-			break;
-		}
+	SyncSemaphore *ss;
+	lock();
+	if (sync_sem_pool.size()) {
+		ss = sync_sem_pool[sync_sem_pool.size() - 1];
+		sync_sem_pool.resize(sync_sem_pool.size() - 1);
+	} else {
+		ss = memnew(SyncSemaphore);
 	}
-
-	return &sync_sems[idx];
+	unlock();
+	return ss;
 }
 
-bool CommandQueueMT::dealloc_one() {
-tryagain:
-	if (dealloc_ptr == (write_ptr_and_epoch >> 1)) {
-		// The queue is empty
-		return false;
-	}
+void CommandQueueMT::_free_sync_sem(SyncSemaphore *p_sem) {
+	lock();
+	sync_sem_pool.push_back(p_sem);
+	unlock();
+}
 
-	uint32_t size = *(uint32_t *)&command_mem[dealloc_ptr];
+CommandQueueMT::Chunk *CommandQueueMT::_alloc_chunk(uint32_t p_size) {
+	Chunk *chunk = memnew(Chunk);
+	chunk->size = p_size;
+	chunk->mem = (uint8_t *)memalloc(p_size);
+	memset(chunk->mem, 0, p_size);
+	command_mem_size += p_size;
+	return chunk;
+}
 
-	if (size == 0) {
-		// End of command buffer wrap down
-		dealloc_ptr = 0;
-		goto tryagain;
-	}
+bool CommandQueueMT::_advance_chunk(uint32_t p_needed) {
+	// Chunks are only ever written from the start, so the next one can be
+	// reused once the consumer has moved past it.
+	Chunk *next = write_chunk->next;
+	bool next_free = next != read_chunk_shared.load(std::memory_order_acquire);
 
-	if (size & 1) {
-		// Still used, nothing can be deallocated
-		return false;
+	if (!next_free || next->size < p_needed) {
+		uint32_t new_size = MAX(write_chunk->size * 2, p_needed);
+		if (command_mem_size + new_size > command_mem_max_size) {
+			new_size = command_mem_max_size > command_mem_size ? command_mem_max_size - command_mem_size : 0;
+		}
+		if (new_size >= p_needed) {
+			// Linked in front of the chunk being read, which keeps the command order.
+			next = _alloc_chunk(new_size);
+			next->next = write_chunk->next;
+			write_chunk->next = next;
+		} else if (!next_free) {
+			// Queue is at its maximum size, wait for the consumer.
+			uint32_t largest = 0;
+			Chunk *chunk = write_chunk;
+			do {
+				largest = MAX(largest, chunk->size);
+				chunk = chunk->next;
+			} while (chunk != write_chunk);
+			// A command that can never fit would wait forever.
+			ERR_FAIL_COND_V_MSG(p_needed > largest, false, "Command does not fit in the command queue, increase its maximum size.");
+			return false;
+		}
+		// Otherwise the next chunk is free but too small; it is skipped by the
+		// next allocation attempt.
 	}
 
-	dealloc_ptr += (size >> 1) + 8;
+	_header(next, 0)->store(0, std::memory_order_relaxed);
+	_header(write_chunk, write_offset)->store(COMMAND_CHUNK_END, std::memory_order_release);
+	write_chunk = next;
+	write_offset = 0;
 	return true;
 }
 
 CommandQueueMT::CommandQueueMT(bool p_sync) {
-	command_mem_size = GLOBAL_DEF_RST("memory/limits/command_queue/multithreading_queue_size_kb", DEFAULT_COMMAND_MEM_SIZE_KB);
+	uint32_t initial_size = GLOBAL_DEF_RST("memory/limits/command_queue/multithreading_queue_size_kb", DEFAULT_COMMAND_MEM_SIZE_KB);
 	ProjectSettings::get_singleton()->set_custom_property_info("memory/limits/command_queue/multithreading_queue_size_kb", PropertyInfo(Variant::INT, "memory/limits/command_queue/multithreading_queue_size_kb", PROPERTY_HINT_RANGE, "1,4096,1,or_greater"));
-	command_mem_size *= 1024;
-	command_mem = (uint8_t *)memalloc(command_mem_size);
+	command_mem_max_size = GLOBAL_DEF_RST("memory/limits/command_queue/multithreading_queue_max_size_kb", DEFAULT_COMMAND_MEM_MAX_SIZE_KB);
+	ProjectSettings::get_singleton()->set_custom_property_info("memory/limits/command_queue/multithreading_queue_max_size_kb", PropertyInfo(Variant::INT, "memory/limits/command_queue/multithreading_queue_max_size_kb", PROPERTY_HINT_RANGE, "1,65536,1,or_greater"));
+	initial_size *= 1024;
+	command_mem_max_size = MAX(command_mem_max_size * 1024, initial_size);
+
+	// Two chunks at least, so the producer always has one to move to.
+	Chunk *first = _alloc_chunk(initial_size / 2);
+	Chunk *second = _alloc_chunk(initial_size - initial_size / 2);
+	first->next = second;
+	second->next = first;
+
+	write_chunk = first;
+	read_chunk = first;
+	read_chunk_shared.store(first);
+	consumer_sleeping.store(false);
+
 	if (p_sync) {
 		sync = memnew(Semaphore);
 	}
@@ -108,5 +133,16 @@ CommandQueueMT::~CommandQueueMT() {
 	if (sync) {
 		memdelete(sync);
 	}
-	memfree(command_mem);
+
+	Chunk *chunk = write_chunk;
+	do {
+		Chunk *next = chunk->next;
+		memfree(chunk->mem);
+		memdelete(chunk);
+		chunk = next;
+	} while (chunk != write_chunk);
+
+	for (uint32_t i = 0; i < sync_sem_pool.size(); i++) {
+		memdelete(sync_sem_pool[i]);
+	}
 }
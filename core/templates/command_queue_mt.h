@@ -34,6 +34,8 @@
 #include "core/os/memory.h"
 #include "core/os/mutex.h"
 #include "core/os/semaphore.h"
+#include "core/os/spin_lock.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/simple_type.h"
 #include "core/typedefs.h"
 
@@ -252,9 +254,7 @@
 		cmd->instance = p_instance;                                          \
 		cmd->method = p_method;                                              \
 		SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                 \
-		unlock();                                                            \
-		if (sync)                                                            \
-			sync->post();                                                    \
+		commit_and_unlock();                                                 \
 	}
 
 #define CMD_RET_TYPE(N) CommandRet##N<T, M, COMMA_SEP_LIST(TYPE_ARG, N) COMMA(N) R>
@@ -269,11 +269,9 @@
 		SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                                   \
 		cmd->ret = r_ret;                                                                      \
 		cmd->sync_sem = ss;                                                                    \
-		unlock();                                                                              \
-		if (sync)                                                                              \
-			sync->post();                                                                      \
+		commit_and_unlock();                                                                   \
 		ss->sem.wait();                                                                        \
-		ss->in_use = false;                                                                    \
+		_free_sync_sem(ss);                                                                    \
 	}
 
 #define CMD_SYNC_TYPE(N) CommandSync##N<T, M COMMA(N) COMMA_SEP_LIST(TYPE_ARG, N)>
@@ -287,11 +285,9 @@
 		cmd->method = p_method;                                                       \
 		SEMIC_SEP_LIST(CMD_ASSIGN_PARAM, N);                                          \
 		cmd->sync_sem = ss;                                                           \
-		unlock();                                                                     \
-		if (sync)                                                                     \
-			sync->post();                                                             \
+		commit_and_unlock();                                                          \
 		ss->sem.wait();                                                               \
-		ss->in_use = false;                                                           \
+		_free_sync_sem(ss);                                                           \
 	}
 
 #define MAX_CMD_PARAMS 15
@@ -299,7 +295,6 @@
 class CommandQueueMT {
 	struct SyncSemaphore {
 		Semaphore sem;
-		bool in_use = false;
 	};
 
 	struct CommandBase {
@@ -329,81 +324,72 @@ class CommandQueueMT {
 
 	/***** BASE *******/
 
+	// Commands are written into a circular list of chunks. Each command is
+	// preceded by an 8 byte header holding its size, which is published last,
+	// so the consumer never needs a lock: a zero header means the queue is
+	// empty, and COMMAND_CHUNK_END means the rest of the chunk is unused.
+	// When the next chunk is still being read, a new (larger) chunk is linked
+	// in instead of waiting, until the configured maximum size is reached.
+
 	enum {
 		DEFAULT_COMMAND_MEM_SIZE_KB = 256,
-		SYNC_SEMAPHORES = 8
+		DEFAULT_COMMAND_MEM_MAX_SIZE_KB = 16384,
+		COMMAND_HEADER_SIZE = 8,
+	};
+
+	static constexpr uint32_t COMMAND_CHUNK_END = 0xFFFFFFFF;
+
+	struct Chunk {
+		uint8_t *mem = nullptr;
+		uint32_t size = 0;
+		Chunk *next = nullptr;
 	};
 
-	uint8_t *command_mem = nullptr;
-	uint32_t read_ptr_and_epoch = 0;
-	uint32_t write_ptr_and_epoch = 0;
-	uint32_t dealloc_ptr = 0;
+	// Producer side, guarded by write_lock. Servers accept calls from any
+	// thread, so producers still serialize among themselves.
+	SpinLock write_lock;
+	Chunk *write_chunk = nullptr;
+	uint32_t write_offset = 0;
 	uint32_t command_mem_size = 0;
-	SyncSemaphore sync_sems[SYNC_SEMAPHORES];
-	Mutex mutex;
+	uint32_t command_mem_max_size = 0;
+	std::atomic<uint32_t> *pending_header = nullptr;
+	uint32_t pending_size = 0;
+	LocalVector<SyncSemaphore *> sync_sem_pool;
+
+	// Consumer side, only touched by the thread flushing the queue.
+	Chunk *read_chunk = nullptr;
+	uint32_t read_offset = 0;
+	uint32_t flush_depth = 0;
+
+	// Shared between both sides.
+	std::atomic<Chunk *> read_chunk_shared;
+	std::atomic_bool consumer_sleeping;
 	Semaphore *sync = nullptr;
 
-	template <class T>
-	T *allocate() {
-		// alloc size is size+T+safeguard
-		uint32_t alloc_size = ((sizeof(T) + 8 - 1) & ~(8 - 1)) + 8;
+	static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t));
 
-		// Assert that the buffer is big enough to hold at least two messages.
-		ERR_FAIL_COND_V(alloc_size * 2 + sizeof(uint32_t) > command_mem_size, nullptr);
+	_FORCE_INLINE_ static std::atomic<uint32_t> *_header(Chunk *p_chunk, uint32_t p_offset) {
+		return reinterpret_cast<std::atomic<uint32_t> *>(&p_chunk->mem[p_offset]);
+	}
 
-	tryagain:
-		uint32_t write_ptr = write_ptr_and_epoch >> 1;
+	template <class T>
+	T *allocate() {
+		uint32_t size = (sizeof(T) + 8 - 1) & ~(8 - 1);
+		// Every chunk keeps room for one more header, used by the end marker.
+		uint32_t alloc_size = size + COMMAND_HEADER_SIZE * 2;
 
-		if (write_ptr < dealloc_ptr) {
-			// behind dealloc_ptr, check that there is room
-			if ((dealloc_ptr - write_ptr) <= alloc_size) {
-				// There is no more room, try to deallocate something
-				if (dealloc_one()) {
-					goto tryagain;
-				}
+		while (write_offset + alloc_size > write_chunk->size) {
+			if (!_advance_chunk(alloc_size)) {
 				return nullptr;
 			}
-		} else {
-			// ahead of dealloc_ptr, check that there is room
-
-			if ((command_mem_size - write_ptr) < alloc_size + sizeof(uint32_t)) {
-				// no room at the end, wrap down;
-
-				if (dealloc_ptr == 0) { // don't want write_ptr to become dealloc_ptr
-
-					// There is no more room, try to deallocate something
-					if (dealloc_one()) {
-						goto tryagain;
-					}
-					return nullptr;
-				}
-
-				// if this happens, it's a bug
-				ERR_FAIL_COND_V((command_mem_size - write_ptr) < 8, nullptr);
-				// zero means, wrap to beginning
-
-				uint32_t *p = (uint32_t *)&command_mem[write_ptr];
-				*p = 1;
-				write_ptr_and_epoch = 0 | (1 & ~write_ptr_and_epoch); // Invert epoch.
-				// See if we can get the thread to run and clear up some more space while we wait.
-				// This is required if alloc_size * 2 + 4 > COMMAND_MEM_SIZE
-				if (sync) {
-					sync->post();
-				}
-				goto tryagain;
-			}
 		}
-		// Allocate the size and the 'in use' bit.
-		// First bit used to mark if command is still in use (1)
-		// or if it has been destroyed and can be deallocated (0).
-		uint32_t size = (sizeof(T) + 8 - 1) & ~(8 - 1);
-		uint32_t *p = (uint32_t *)&command_mem[write_ptr];
-		*p = (size << 1) | 1;
-		write_ptr += 8;
-		// allocate the command
-		T *cmd = memnew_placement(&command_mem[write_ptr], T);
-		write_ptr += size;
-		write_ptr_and_epoch = (write_ptr << 1) | (write_ptr_and_epoch & 1);
+
+		pending_header = _header(write_chunk, write_offset);
+		pending_size = size;
+		T *cmd = memnew_placement(&write_chunk->mem[write_offset + COMMAND_HEADER_SIZE], T);
+		write_offset += size + COMMAND_HEADER_SIZE;
+		// The next slot must read as empty before this command is published.
+		_header(write_chunk, write_offset)->store(0, std::memory_order_relaxed);
 		return cmd;
 	}
 
@@ -422,62 +408,73 @@ class CommandQueueMT {
 		return ret;
 	}
 
-	bool flush_one(bool p_lock = true) {
-		if (p_lock) {
-			lock();
-		}
-	tryagain:
+	_FORCE_INLINE_ void commit_and_unlock() {
+		pending_header->store(pending_size, std::memory_order_release);
+		unlock();
+		_wake_consumer();
+	}
 
-		// tried to read an empty queue
-		if (read_ptr_and_epoch == write_ptr_and_epoch) {
-			if (p_lock) {
-				unlock();
-			}
-			return false;
+	_FORCE_INLINE_ void _wake_consumer() {
+		if (!sync) {
+			return;
 		}
-
-		uint32_t read_ptr = read_ptr_and_epoch >> 1;
-		uint32_t size_ptr = read_ptr;
-		uint32_t size = *(uint32_t *)&command_mem[read_ptr] >> 1;
-
-		if (size == 0) {
-			*(uint32_t *)&command_mem[read_ptr] = 0; // clear in-use bit.
-			//end of ringbuffer, wrap
-			read_ptr_and_epoch = 0 | (1 & ~read_ptr_and_epoch); // Invert epoch.
-			goto tryagain;
+		// Only post when the consumer went to sleep, so a burst of commands
+		// costs a single wakeup.
+		std::atomic_thread_fence(std::memory_order_seq_cst);
+		if (consumer_sleeping.load(std::memory_order_relaxed) && consumer_sleeping.exchange(false)) {
+			sync->post();
 		}
+	}
 
-		read_ptr += 8;
+	_FORCE_INLINE_ bool _is_pending() const {
+		return _header(read_chunk, read_offset)->load(std::memory_order_acquire) != 0;
+	}
 
-		CommandBase *cmd = reinterpret_cast<CommandBase *>(&command_mem[read_ptr]);
+	bool flush_one() {
+		while (true) {
+			uint32_t size = _header(read_chunk, read_offset)->load(std::memory_order_acquire);
 
-		read_ptr += size;
+			if (size == 0) {
+				// tried to read an empty queue
+				return false;
+			}
 
-		read_ptr_and_epoch = (read_ptr << 1) | (read_ptr_and_epoch & 1);
+			if (size == COMMAND_CHUNK_END) {
+				if (flush_depth > 0) {
+					// Flushing from inside a command, which still lives in this chunk.
+					return false;
+				}
+				read_chunk = read_chunk->next;
+				read_offset = 0;
+				// Hands the previous chunk back to the producer.
+				read_chunk_shared.store(read_chunk, std::memory_order_release);
+				continue;
+			}
 
-		if (p_lock) {
-			unlock();
-		}
-		cmd->call();
-		if (p_lock) {
-			lock();
-		}
+			CommandBase *cmd = reinterpret_cast<CommandBase *>(&read_chunk->mem[read_offset + COMMAND_HEADER_SIZE]);
+			read_offset += size + COMMAND_HEADER_SIZE;
 
-		cmd->post();
-		cmd->~CommandBase();
-		*(uint32_t *)&command_mem[size_ptr] &= ~1;
+			flush_depth++;
+			cmd->call();
+			flush_depth--;
 
-		if (p_lock) {
-			unlock();
+			cmd->post();
+			cmd->~CommandBase();
+			return true;
 		}
-		return true;
 	}
 
-	void lock();
-	void unlock();
+	_FORCE_INLINE_ void lock() {
+		write_lock.lock();
+	}
+	_FORCE_INLINE_ void unlock() {
+		write_lock.unlock();
+	}
 	void wait_for_flush();
 	SyncSemaphore *_alloc_sync_sem();
-	bool dealloc_one();
+	void _free_sync_sem(SyncSemaphore *p_sem);
+	Chunk *_alloc_chunk(uint32_t p_size);
+	bool _advance_chunk(uint32_t p_needed);
 
 public:
 	/* NORMAL PUSH COMMANDS */
@@ -494,21 +491,28 @@ public:
 
 	void wait_and_flush_one() {
 		ERR_FAIL_COND(!sync);
-		sync->wait();
-		flush_one();
+		while (!flush_one()) {
+			consumer_sleeping.store(true);
+			std::atomic_thread_fence(std::memory_order_seq_cst);
+			if (_is_pending() && consumer_sleeping.exchange(false)) {
+				// A command arrived before the producer saw us sleeping.
+				continue;
+			}
+			// Either nothing is pending, or a producer already claimed the
+			// wakeup and will post; consume it to keep the count balanced.
+			sync->wait();
+		}
 	}
 
 	_FORCE_INLINE_ void flush_if_pending() {
-		if (unlikely(read_ptr_and_epoch != write_ptr_and_epoch)) {
+		if (unlikely(_is_pending())) {
 			flush_all();
 		}
 	}
 	void flush_all() {
 		//ERR_FAIL_COND(sync);
-		lock();
-		while (flush_one(false)) {
+		while (flush_one()) {
 		}
-		unlock();
 	}
 
 	CommandQueueMT(bool p_sync);
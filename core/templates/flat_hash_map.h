@@ -0,0 +1,466 @@
+/*************************************************************************/
+/*  flat_hash_map.h                                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef FLAT_HASH_MAP_H
+#define FLAT_HASH_MAP_H
+
+#include "core/error/error_macros.h"
+#include "core/os/memory.h"
+#include "core/templates/hashfuncs.h"
+#include "core/templates/list.h"
+
+#include <string.h>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FLAT_HASH_MAP_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/**
+ * A HashMap implementation that uses open addressing with SwissTable-style
+ * probing. Each slot has a one byte control value holding 7 bits of its hash,
+ * and lookups compare a whole group of control bytes at once (16 with SSE2,
+ * 8 otherwise), so only slots whose hash bits match have their key compared.
+ * Keys and values are stored inline in one array, without a heap allocation
+ * per element.
+ *
+ * It has the same interface as HashMap, so it can replace it, but unlike
+ * HashMap, growing the map moves the elements: pointers returned by getptr(),
+ * operator[] or next() are only valid until the next insertion.
+ */
+template <class TKey, class TData,
+		class Hasher = HashMapHasherDefault,
+		class Comparator = HashMapComparatorDefault<TKey>>
+class FlatHashMap {
+public:
+	struct Pair {
+		TKey key;
+		TData data;
+
+		Pair() {}
+		Pair(const TKey &p_key, const TData &p_data) :
+				key(p_key),
+				data(p_data) {
+		}
+	};
+
+private:
+#ifdef FLAT_HASH_MAP_USE_SSE2
+	static const uint32_t GROUP_WIDTH = 16;
+#else
+	static const uint32_t GROUP_WIDTH = 8;
+#endif
+	static const uint32_t MIN_CAPACITY = 8;
+
+	// Control byte values. Used slots store the low 7 bits of their hash.
+	static const uint8_t CTRL_EMPTY = 0x80;
+	static const uint8_t CTRL_DELETED = 0xFE;
+
+	// capacity + GROUP_WIDTH bytes, the tail mirrors the first bytes so a group
+	// can always be loaded without wrapping.
+	uint8_t *ctrl = nullptr;
+	Pair *slots = nullptr;
+	uint32_t capacity = 0;
+	uint32_t elements = 0;
+	uint32_t deleted = 0;
+
+	struct Group {
+#ifdef FLAT_HASH_MAP_USE_SSE2
+		__m128i ctrl;
+
+		_FORCE_INLINE_ explicit Group(const uint8_t *p_ctrl) {
+			ctrl = _mm_loadu_si128((const __m128i *)p_ctrl);
+		}
+		_FORCE_INLINE_ uint32_t match(uint8_t p_h2) const {
+			return _mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char)p_h2)));
+		}
+		_FORCE_INLINE_ uint32_t match_empty() const {
+			return _mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8((char)CTRL_EMPTY)));
+		}
+		_FORCE_INLINE_ uint32_t match_empty_or_deleted() const {
+			return _mm_movemask_epi8(ctrl);
+		}
+		static _FORCE_INLINE_ uint32_t bit_to_index(uint32_t p_bit) {
+			return p_bit;
+		}
+#else
+		// Compares the 8 control bytes of a word at once. Match results have
+		// the high bit of each matching byte set.
+		uint64_t ctrl;
+
+		_FORCE_INLINE_ explicit Group(const uint8_t *p_ctrl) {
+			memcpy(&ctrl, p_ctrl, sizeof(uint64_t));
+#ifdef BIG_ENDIAN_ENABLED
+			ctrl = BSWAP64(ctrl);
+#endif
+		}
+		_FORCE_INLINE_ uint64_t match(uint8_t p_h2) const {
+			// May report a false positive next to a real match, which the key
+			// comparison rejects.
+			uint64_t x = ctrl ^ (0x0101010101010101ULL * p_h2);
+			return (x - 0x0101010101010101ULL) & ~x & 0x8080808080808080ULL;
+		}
+		_FORCE_INLINE_ uint64_t match_empty() const {
+			return ctrl & (~ctrl << 6) & 0x8080808080808080ULL;
+		}
+		_FORCE_INLINE_ uint64_t match_empty_or_deleted() const {
+			return ctrl & (~ctrl << 7) & 0x8080808080808080ULL;
+		}
+		static _FORCE_INLINE_ uint32_t bit_to_index(uint32_t p_bit) {
+			return p_bit >> 3;
+		}
+#endif
+	};
+
+	static _FORCE_INLINE_ uint32_t _first_bit(uint64_t p_mask) {
+#if defined(_MSC_VER)
+		unsigned long index;
+#if defined(_WIN64)
+		_BitScanForward64(&index, p_mask);
+#else
+		if (!_BitScanForward(&index, (uint32_t)p_mask)) {
+			_BitScanForward(&index, (uint32_t)(p_mask >> 32));
+			index += 32;
+		}
+#endif
+		return index;
+#else
+		return __builtin_ctzll(p_mask);
+#endif
+	}
+
+	static _FORCE_INLINE_ uint32_t _last_bit(uint64_t p_mask) {
+#if defined(_MSC_VER)
+		unsigned long index;
+#if defined(_WIN64)
+		_BitScanReverse64(&index, p_mask);
+#else
+		if (_BitScanReverse(&index, (uint32_t)(p_mask >> 32))) {
+			index += 32;
+		} else {
+			_BitScanReverse(&index, (uint32_t)p_mask);
+		}
+#endif
+		return index;
+#else
+		return 63 - __builtin_clzll(p_mask);
+#endif
+	}
+
+	static _FORCE_INLINE_ uint32_t _hash(const TKey &p_key) {
+		// Many hashers return their input for integer keys, mix so both the
+		// slot index and the 7 control bits are well distributed.
+		return hash_fmix32(Hasher::hash(p_key));
+	}
+
+	_FORCE_INLINE_ void _set_ctrl(uint32_t p_index, uint8_t p_value) {
+		ctrl[p_index] = p_value;
+		for (uint32_t i = p_index + capacity; i < capacity + GROUP_WIDTH; i += capacity) {
+			ctrl[i] = p_value;
+		}
+	}
+
+	_FORCE_INLINE_ int32_t _find_slot(const TKey &p_key, uint32_t p_hash) const {
+		if (unlikely(!capacity)) {
+			return -1;
+		}
+
+		const uint32_t mask = capacity - 1;
+		const uint8_t h2 = p_hash & 0x7F;
+		uint32_t pos = (p_hash >> 7) & mask;
+		uint32_t step = 0;
+
+		while (true) {
+			Group group(&ctrl[pos]);
+			for (auto bits = group.match(h2); bits; bits &= bits - 1) {
+				uint32_t index = (pos + Group::bit_to_index(_first_bit(bits))) & mask;
+				if (likely(Comparator::compare(slots[index].key, p_key))) {
+					return index;
+				}
+			}
+			if (group.match_empty()) {
+				return -1;
+			}
+			step += GROUP_WIDTH;
+			pos = (pos + step) & mask;
+		}
+	}
+
+	uint32_t _find_insert_slot(uint32_t p_hash) const {
+		const uint32_t mask = capacity - 1;
+		uint32_t pos = (p_hash >> 7) & mask;
+		uint32_t step = 0;
+
+		while (true) {
+			Group group(&ctrl[pos]);
+			auto bits = group.match_empty_or_deleted();
+			if (bits) {
+				return (pos + Group::bit_to_index(_first_bit(bits))) & mask;
+			}
+			step += GROUP_WIDTH;
+			pos = (pos + step) & mask;
+		}
+	}
+
+	void _allocate(uint32_t p_capacity) {
+		capacity = p_capacity;
+		ctrl = (uint8_t *)memalloc(capacity + GROUP_WIDTH);
+		memset(ctrl, CTRL_EMPTY, capacity + GROUP_WIDTH);
+		slots = (Pair *)memalloc(sizeof(Pair) * capacity);
+		elements = 0;
+		deleted = 0;
+	}
+
+	void _resize(uint32_t p_capacity) {
+		uint8_t *old_ctrl = ctrl;
+		Pair *old_slots = slots;
+		uint32_t old_capacity = capacity;
+
+		_allocate(p_capacity);
+
+		for (uint32_t i = 0; i < old_capacity; i++) {
+			if (old_ctrl[i] & 0x80) {
+				continue;
+			}
+			uint32_t hash = _hash(old_slots[i].key);
+			uint32_t index = _find_insert_slot(hash);
+			_set_ctrl(index, hash & 0x7F);
+			memnew_placement(&slots[index], Pair(old_slots[i]));
+			old_slots[i].~Pair();
+			elements++;
+		}
+
+		if (old_ctrl) {
+			memfree(old_ctrl);
+			memfree(old_slots);
+		}
+	}
+
+	uint32_t _insert(const TKey &p_key, const TData &p_data, uint32_t p_hash) {
+		// Keep at least one slot in eight empty, so probing always terminates.
+		if (unlikely(!capacity)) {
+			_allocate(MIN_CAPACITY);
+		} else if (unlikely((elements + deleted + 1) * 8 > capacity * 7)) {
+			// Mostly tombstones are cleaned up in place, otherwise the table grows.
+			_resize(elements * 2 + 2 > capacity ? capacity * 2 : capacity);
+		}
+
+		uint32_t index = _find_insert_slot(p_hash);
+		if (ctrl[index] == CTRL_DELETED) {
+			deleted--;
+		}
+		_set_ctrl(index, p_hash & 0x7F);
+		memnew_placement(&slots[index], Pair(p_key, p_data));
+		elements++;
+		return index;
+	}
+
+	void _copy_from(const FlatHashMap &p_map) {
+		if (p_map.elements == 0) {
+			return;
+		}
+		_allocate(p_map.capacity);
+		memcpy(ctrl, p_map.ctrl, capacity + GROUP_WIDTH);
+		for (uint32_t i = 0; i < capacity; i++) {
+			if (!(ctrl[i] & 0x80)) {
+				memnew_placement(&slots[i], Pair(p_map.slots[i]));
+			}
+		}
+		elements = p_map.elements;
+		deleted = p_map.deleted;
+	}
+
+public:
+	void set(const TKey &p_key, const TData &p_data) {
+		uint32_t hash = _hash(p_key);
+		int32_t index = _find_slot(p_key, hash);
+		if (index >= 0) {
+			slots[index].data = p_data;
+		} else {
+			_insert(p_key, p_data, hash);
+		}
+	}
+
+	bool has(const TKey &p_key) const {
+		return _find_slot(p_key, _hash(p_key)) >= 0;
+	}
+
+	const TData &get(const TKey &p_key) const {
+		const TData *res = getptr(p_key);
+		CRASH_COND_MSG(!res, "Map key not found.");
+		return *res;
+	}
+
+	TData &get(const TKey &p_key) {
+		TData *res = getptr(p_key);
+		CRASH_COND_MSG(!res, "Map key not found.");
+		return *res;
+	}
+
+	_FORCE_INLINE_ TData *getptr(const TKey &p_key) {
+		int32_t index = _find_slot(p_key, _hash(p_key));
+		return index >= 0 ? &slots[index].data : nullptr;
+	}
+
+	_FORCE_INLINE_ const TData *getptr(const TKey &p_key) const {
+		int32_t index = _find_slot(p_key, _hash(p_key));
+		return index >= 0 ? &slots[index].data : nullptr;
+	}
+
+	bool erase(const TKey &p_key) {
+		int32_t index = _find_slot(p_key, _hash(p_key));
+		if (index < 0) {
+			return false;
+		}
+
+		slots[index].~Pair();
+		elements--;
+
+		// The slot can become empty again unless it sits in a run of
+		// GROUP_WIDTH used slots, which a probe may have walked past.
+		const uint32_t mask = capacity - 1;
+		auto empty_before = Group(&ctrl[(index - GROUP_WIDTH) & mask]).match_empty();
+		auto empty_after = Group(&ctrl[index]).match_empty();
+		uint32_t used_before = empty_before ? GROUP_WIDTH - 1 - Group::bit_to_index(_last_bit(empty_before)) : GROUP_WIDTH;
+		uint32_t used_after = empty_after ? Group::bit_to_index(_first_bit(empty_after)) : GROUP_WIDTH;
+		if (capacity >= GROUP_WIDTH && used_before + used_after < GROUP_WIDTH) {
+			_set_ctrl(index, CTRL_EMPTY);
+		} else {
+			_set_ctrl(index, CTRL_DELETED);
+			deleted++;
+		}
+
+		if (elements == 0) {
+			clear();
+		}
+		return true;
+	}
+
+	inline const TData &operator[](const TKey &p_key) const { //constref
+		return get(p_key);
+	}
+
+	inline TData &operator[](const TKey &p_key) { //assignment
+		uint32_t hash = _hash(p_key);
+		int32_t index = _find_slot(p_key, hash);
+		if (index < 0) {
+			index = _insert(p_key, TData(), hash);
+		}
+		return slots[index].data;
+	}
+
+	/**
+	 * Get the next key to p_key, and the first key if p_key is null.
+	 * Returns a pointer to the next key if found, nullptr otherwise.
+	 * Same as in HashMap, don't add or remove elements while iterating.
+	 */
+	const TKey *next(const TKey *p_key) const {
+		uint32_t from = 0;
+		if (p_key) {
+			// Keys are the first member of their slot.
+			from = reinterpret_cast<const Pair *>(p_key) - slots + 1;
+		}
+		for (uint32_t i = from; i < capacity; i++) {
+			if (!(ctrl[i] & 0x80)) {
+				return &slots[i].key;
+			}
+		}
+		return nullptr;
+	}
+
+	inline unsigned int size() const {
+		return elements;
+	}
+
+	inline bool is_empty() const {
+		return elements == 0;
+	}
+
+	/** Reserves room for at least p_elements without growing. */
+	void reserve(uint32_t p_elements) {
+		uint32_t new_capacity = MIN_CAPACITY;
+		while (new_capacity * 7 < (p_elements + 1) * 8) {
+			new_capacity *= 2;
+		}
+		if (new_capacity > capacity) {
+			_resize(new_capacity);
+		}
+	}
+
+	void clear() {
+		if (!ctrl) {
+			return;
+		}
+		for (uint32_t i = 0; i < capacity; i++) {
+			if (!(ctrl[i] & 0x80)) {
+				slots[i].~Pair();
+			}
+		}
+		memfree(ctrl);
+		memfree(slots);
+		ctrl = nullptr;
+		slots = nullptr;
+		capacity = 0;
+		elements = 0;
+		deleted = 0;
+	}
+
+	void get_key_list(List<TKey> *r_keys) const {
+		for (uint32_t i = 0; i < capacity; i++) {
+			if (!(ctrl[i] & 0x80)) {
+				r_keys->push_back(slots[i].key);
+			}
+		}
+	}
+
+	void operator=(const FlatHashMap &p_map) {
+		if (this == &p_map) {
+			return;
+		}
+		clear();
+		_copy_from(p_map);
+	}
+
+	FlatHashMap() {}
+
+	FlatHashMap(const FlatHashMap &p_map) {
+		_copy_from(p_map);
+	}
+
+	~FlatHashMap() {
+		clear();
+	}
+};
+
+#endif // FLAT_HASH_MAP_H
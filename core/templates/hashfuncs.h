@@ -39,6 +39,9 @@
 #include "core/string/ustring.h"
 #include "core/templates/rid.h"
 #include "core/typedefs.h"
+
+#include <string.h>
+
 /**
  * Hashing functions
  */
@@ -74,6 +77,71 @@ static inline uint32_t hash_djb2_one_32(uint32_t p_in, uint32_t p_prev = 5381) {
 	return ((p_prev << 5) + p_prev) + p_in;
 }
 
+/**
+ * MurmurHash3 (32 bits) finalizer, spreads every input bit over the whole result.
+ */
+static inline uint32_t hash_fmix32(uint32_t h) {
+	h ^= h >> 16;
+	h *= 0x85ebca6b;
+	h ^= h >> 13;
+	h *= 0xc2b2ae35;
+	h ^= h >> 16;
+
+	return h;
+}
+
+static inline uint32_t hash_murmur3_one_32(uint32_t p_in, uint32_t p_seed = 0x7F07C65) {
+	p_in *= 0xcc9e2d51;
+	p_in = (p_in << 15) | (p_in >> 17);
+	p_in *= 0x1b873593;
+
+	p_seed ^= p_in;
+	p_seed = (p_seed << 13) | (p_seed >> 19);
+	p_seed = p_seed * 5 + 0xe6546b64;
+
+	return p_seed;
+}
+
+/**
+ * MurmurHash3 (32 bits) of a buffer, reading four bytes at a time instead of
+ * one like hash_djb2_buffer.
+ * @return 32-bits hashcode
+ */
+static inline uint32_t hash_murmur3_buffer(const void *p_buff, int p_len, uint32_t p_seed = 0x7F07C65) {
+	const uint8_t *data = (const uint8_t *)p_buff;
+	const int blocks = p_len / 4;
+	uint32_t h = p_seed;
+
+	for (int i = 0; i < blocks; i++) {
+		uint32_t k;
+		memcpy(&k, data + i * 4, sizeof(uint32_t));
+#ifdef BIG_ENDIAN_ENABLED
+		k = BSWAP32(k);
+#endif
+		h = hash_murmur3_one_32(k, h);
+	}
+
+	const uint8_t *tail = data + blocks * 4;
+	uint32_t k = 0;
+	switch (p_len & 3) {
+		case 3:
+			k ^= tail[2] << 16;
+			[[fallthrough]];
+		case 2:
+			k ^= tail[1] << 8;
+			[[fallthrough]];
+		case 1:
+			k ^= tail[0];
+			k *= 0xcc9e2d51;
+			k = (k << 15) | (k >> 17);
+			k *= 0x1b873593;
+			h ^= k;
+	}
+
+	h ^= (uint32_t)p_len;
+	return hash_fmix32(h);
+}
+
 static inline uint32_t hash_one_uint64(const uint64_t p_int) {
 	uint64_t v = p_int;
 	v = (~v) + (v << 18); // v = (v << 18) - v - 1;
@@ -150,7 +218,7 @@ static inline uint64_t make_uint64_t(T p_in) {
 
 struct HashMapHasherDefault {
 	static _FORCE_INLINE_ uint32_t hash(const String &p_string) { return p_string.hash(); }
-	static _FORCE_INLINE_ uint32_t hash(const char *p_cstr) { return hash_djb2(p_cstr); }
+	static _FORCE_INLINE_ uint32_t hash(const char *p_cstr) { return hash_murmur3_buffer(p_cstr, strlen(p_cstr)); }
 	static _FORCE_INLINE_ uint32_t hash(const uint64_t p_int) { return hash_one_uint64(p_int); }
 	static _FORCE_INLINE_ uint32_t hash(const ObjectID &p_id) { return hash_one_uint64(p_id); }
 
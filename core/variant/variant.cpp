@@ -2990,7 +2990,7 @@ uint32_t Variant::hash() const {
 			int len = arr.size();
 			if (likely(len)) {
 				const uint8_t *r = arr.ptr();
-				return hash_djb2_buffer((uint8_t *)&r[0], len);
+				return hash_murmur3_buffer(r, len);
 			} else {
 				return hash_djb2_one_64(0);
 			}
@@ -3001,7 +3001,7 @@ uint32_t Variant::hash() const {
 			int len = arr.size();
 			if (likely(len)) {
 				const int32_t *r = arr.ptr();
-				return hash_djb2_buffer((uint8_t *)&r[0], len * sizeof(int32_t));
+				return hash_murmur3_buffer(r, len * sizeof(int32_t));
 			} else {
 				return hash_djb2_one_64(0);
 			}
@@ -3012,7 +3012,7 @@ uint32_t Variant::hash() const {
 			int len = arr.size();
 			if (likely(len)) {
 				const int64_t *r = arr.ptr();
-				return hash_djb2_buffer((uint8_t *)&r[0], len * sizeof(int64_t));
+				return hash_murmur3_buffer(r, len * sizeof(int64_t));
 			} else {
 				return hash_djb2_one_64(0);
 			}
@@ -3024,7 +3024,7 @@ uint32_t Variant::hash() const {
 
 			if (likely(len)) {
 				const float *r = arr.ptr();
-				return hash_djb2_buffer((uint8_t *)&r[0], len * sizeof(float));
+				return hash_murmur3_buffer(r, len * sizeof(float));
 			} else {
 				return hash_djb2_one_float(0.0);
 			}
@@ -3036,7 +3036,7 @@ uint32_t Variant::hash() const {
 
 			if (likely(len)) {
 				const double *r = arr.ptr();
-				return hash_djb2_buffer((uint8_t *)&r[0], len * sizeof(double));
+				return hash_murmur3_buffer(r, len * sizeof(double));
 			} else {
 				return hash_djb2_one_float(0.0);
 			}
@@ -100,6 +100,8 @@ public:
 	virtual Error join_multicast_group(const IPAddress &p_multi_address, String p_if_name);
 	virtual Error leave_multicast_group(const IPAddress &p_multi_address, String p_if_name);
 
+	SOCKET_TYPE get_socket() const { return _sock; }
+
 	NetSocketPosix();
 	~NetSocketPosix();
 };
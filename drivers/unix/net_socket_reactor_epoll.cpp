@@ -0,0 +1,115 @@
+/*************************************************************************/
+/*  net_socket_reactor_epoll.cpp                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "net_socket_reactor_epoll.h"
+
+#ifdef EPOLL_ENABLED
+
+#include "drivers/unix/net_socket_posix.h"
+
+#include <errno.h>
+#include <sys/epoll.h>
+#include <unistd.h>
+
+// Events fetched per epoll_wait() call, more calls are made while it fills up.
+#define EPOLL_EVENTS_PER_WAIT 256
+
+NetSocketReactor *NetSocketReactorEpoll::_create_func() {
+	return memnew(NetSocketReactorEpoll);
+}
+
+void NetSocketReactorEpoll::make_default() {
+	_create = _create_func;
+}
+
+Error NetSocketReactorEpoll::add_socket(const Ref<NetSocket> &p_sock, uint64_t p_id) {
+	ERR_FAIL_COND_V(_epoll_fd < 0, ERR_UNCONFIGURED);
+	ERR_FAIL_COND_V(p_sock.is_null() || !p_sock->is_open(), ERR_INVALID_PARAMETER);
+
+	// Sockets are always created by NetSocketPosix on this platform.
+	const int fd = static_cast<const NetSocketPosix *>(p_sock.ptr())->get_socket();
+
+	struct epoll_event ev = {};
+	ev.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+	ev.data.u64 = p_id;
+	if (epoll_ctl(_epoll_fd, EPOLL_CTL_ADD, fd, &ev) != 0) {
+		// Already added, update the id.
+		ERR_FAIL_COND_V_MSG(errno != EEXIST, FAILED, "Unable to add socket to epoll.");
+		ERR_FAIL_COND_V_MSG(epoll_ctl(_epoll_fd, EPOLL_CTL_MOD, fd, &ev) != 0, FAILED, "Unable to modify socket in epoll.");
+	}
+	return OK;
+}
+
+void NetSocketReactorEpoll::remove_socket(const Ref<NetSocket> &p_sock) {
+	ERR_FAIL_COND(_epoll_fd < 0);
+	ERR_FAIL_COND(p_sock.is_null());
+
+	// Closed sockets are removed by the kernel.
+	if (p_sock->is_open()) {
+		epoll_ctl(_epoll_fd, EPOLL_CTL_DEL, static_cast<const NetSocketPosix *>(p_sock.ptr())->get_socket(), nullptr);
+	}
+}
+
+Error NetSocketReactorEpoll::wait(int p_timeout, LocalVector<uint64_t> &r_ready) {
+	ERR_FAIL_COND_V(_epoll_fd < 0, ERR_UNCONFIGURED);
+
+	struct epoll_event events[EPOLL_EVENTS_PER_WAIT];
+	int timeout = p_timeout;
+	while (true) {
+		const int count = epoll_wait(_epoll_fd, events, EPOLL_EVENTS_PER_WAIT, timeout);
+		if (count < 0) {
+			if (errno == EINTR) {
+				return OK;
+			}
+			ERR_FAIL_V_MSG(FAILED, "Error when waiting on epoll.");
+		}
+
+		for (int i = 0; i < count; i++) {
+			r_ready.push_back(events[i].data.u64);
+		}
+		if (count < EPOLL_EVENTS_PER_WAIT) {
+			return OK;
+		}
+		timeout = 0;
+	}
+}
+
+NetSocketReactorEpoll::NetSocketReactorEpoll() {
+	_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+	ERR_FAIL_COND_MSG(_epoll_fd < 0, "Unable to create epoll instance.");
+}
+
+NetSocketReactorEpoll::~NetSocketReactorEpoll() {
+	if (_epoll_fd >= 0) {
+		::close(_epoll_fd);
+	}
+}
+
+#endif // EPOLL_ENABLED
@@ -0,0 +1,59 @@
+/*************************************************************************/
+/*  net_socket_reactor_epoll.h                                           */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef NET_SOCKET_REACTOR_EPOLL_H
+#define NET_SOCKET_REACTOR_EPOLL_H
+
+#include "core/io/net_socket_reactor.h"
+
+#if defined(UNIX_ENABLED) && defined(__linux__) && !defined(JAVASCRIPT_ENABLED) && !defined(UNIX_SOCKET_UNAVAILABLE)
+#define EPOLL_ENABLED
+
+class NetSocketReactorEpoll : public NetSocketReactor {
+private:
+	int _epoll_fd = -1;
+
+protected:
+	static NetSocketReactor *_create_func();
+
+public:
+	static void make_default();
+
+	virtual Error add_socket(const Ref<NetSocket> &p_sock, uint64_t p_id);
+	virtual void remove_socket(const Ref<NetSocket> &p_sock);
+	virtual Error wait(int p_timeout, LocalVector<uint64_t> &r_ready);
+
+	NetSocketReactorEpoll();
+	~NetSocketReactorEpoll();
+};
+
+#endif
+
+#endif // NET_SOCKET_REACTOR_EPOLL_H
@@ -38,6 +38,7 @@
 #include "drivers/unix/dir_access_unix.h"
 #include "drivers/unix/file_access_unix.h"
 #include "drivers/unix/net_socket_posix.h"
+#include "drivers/unix/net_socket_reactor_epoll.h"
 #include "drivers/unix/thread_posix.h"
 #include "servers/rendering_server.h"
 
@@ -129,6 +130,9 @@ void OS_Unix::initialize_core() {
 
 #ifndef NO_NETWORK
 	NetSocketPosix::make_default();
+#ifdef EPOLL_ENABLED
+	NetSocketReactorEpoll::make_default();
+#endif
 	IPUnix::make_default();
 #endif
 
@@ -83,7 +83,9 @@ static Vector<uint8_t> basis_universal_packer(const Ref<Image> &p_image, Image::
 		basisu::basis_compressor_params params;
 		params.m_max_endpoint_clusters = 512;
 		params.m_max_selector_clusters = 512;
-		params.m_multithreading = true;
+		// Basis builds global codebooks for the whole image, so it can't be split in block jobs.
+		// It keeps its own job pool, but follows the engine setting for threaded image processing.
+		params.m_multithreading = Image::is_threaded_processing_enabled();
 		//params.m_no_hybrid_sel_cb = true; //fixme, default on this causes crashes //seems fixed?
 		params.m_pSel_codebook = sel_codebook;
 		//params.m_quality_level = 0;
@@ -91,7 +93,7 @@ static Vector<uint8_t> basis_universal_packer(const Ref<Image> &p_image, Image::
 		//params.m_no_selector_rdo = true;
 		params.m_auto_global_sel_pal = false;
 
-		basisu::job_pool jpool(OS::get_singleton()->get_processor_count());
+		basisu::job_pool jpool(params.m_multithreading ? OS::get_singleton()->get_processor_count() : 1);
 		params.m_pJob_pool = &jpool;
 
 		params.m_mip_gen = false; //sorry, please some day support provided mipmaps.
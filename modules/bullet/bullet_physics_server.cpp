@@ -231,6 +231,20 @@ int BulletPhysicsServer3D::space_get_contact_count(RID p_space) const {
 	return space->get_debug_contact_count();
 }
 
+int BulletPhysicsServer3D::space_get_moved_body_states(RID p_space, BodyStates &r_states) const {
+	SpaceBullet *space = space_owner.getornull(p_space);
+	ERR_FAIL_COND_V(!space, 0);
+
+	return space->get_moved_body_states(r_states);
+}
+
+void BulletPhysicsServer3D::space_set_body_states_callback(RID p_space, const Callable &p_callable) {
+	SpaceBullet *space = space_owner.getornull(p_space);
+	ERR_FAIL_COND(!space);
+
+	space->set_body_states_callback(p_callable);
+}
+
 RID BulletPhysicsServer3D::area_create() {
 	AreaBullet *area = bulletnew(AreaBullet);
 	area->set_collision_layer(1);
@@ -118,6 +118,9 @@ public:
 	virtual Vector<Vector3> space_get_contacts(RID p_space) const override;
 	virtual int space_get_contact_count(RID p_space) const override;
 
+	virtual int space_get_moved_body_states(RID p_space, BodyStates &r_states) const override;
+	virtual void space_set_body_states_callback(RID p_space, const Callable &p_callable) override;
+
 	/* AREA API */
 
 	/// Bullet Physics Engine not support "Area", this must be handled by the game developer in another way.
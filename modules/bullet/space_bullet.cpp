@@ -36,6 +36,7 @@
 #include "constraint_bullet.h"
 #include "core/config/project_settings.h"
 #include "core/string/ustring.h"
+#include "core/templates/local_vector.h"
 #include "godot_collision_configuration.h"
 #include "godot_collision_dispatcher.h"
 #include "rigid_body_bullet.h"
@@ -351,11 +352,83 @@ SpaceBullet::~SpaceBullet() {
 	destroy_world();
 }
 
+// Bullet doesn't keep a list of moved bodies, the active ones are reported as dispatch_callbacks() does.
+static _FORCE_INLINE_ RigidBodyBullet *_get_moved_rigid_body(const btCollisionObject *p_object) {
+	if (p_object->getUserIndex() != CollisionObjectBullet::TYPE_RIGID_BODY) {
+		return nullptr;
+	}
+	RigidBodyBullet *body = static_cast<RigidBodyBullet *>(p_object->getUserPointer());
+	if (body->get_bt_rigid_body()->isActive() || body->get_bt_rigid_body()->isKinematicObject()) {
+		return body;
+	}
+	return nullptr;
+}
+
 void SpaceBullet::flush_queries() {
 	const btCollisionObjectArray &colObjArray = dynamicsWorld->getCollisionObjectArray();
 	for (int i = colObjArray.size() - 1; 0 <= i; --i) {
 		static_cast<CollisionObjectBullet *>(colObjArray[i]->getUserPointer())->dispatch_callbacks();
 	}
+
+	if (!body_states_callback.is_null()) {
+		// Only call back when get_moved_body_states() has something to report.
+		for (int i = 0; i < colObjArray.size(); ++i) {
+			if (_get_moved_rigid_body(colObjArray[i])) {
+				Callable::CallError ce;
+				Variant rv;
+				body_states_callback.call(nullptr, 0, rv, ce);
+				break;
+			}
+		}
+	}
+}
+
+int SpaceBullet::get_moved_body_states(PhysicsServer3D::BodyStates &r_states) const {
+	LocalVector<RigidBodyBullet *> moved_bodies;
+	const btCollisionObjectArray &colObjArray = dynamicsWorld->getCollisionObjectArray();
+	for (int i = 0; i < colObjArray.size(); ++i) {
+		RigidBodyBullet *body = _get_moved_rigid_body(colObjArray[i]);
+		if (body) {
+			moved_bodies.push_back(body);
+		}
+	}
+
+	int count = moved_bodies.size();
+	r_states.bodies.resize(count);
+	r_states.instance_ids.resize(count);
+	r_states.transforms.resize(count * 12);
+	r_states.linear_velocities.resize(count);
+	r_states.angular_velocities.resize(count);
+	r_states.sleeping.resize(count);
+
+	float *transforms = r_states.transforms.ptrw();
+	for (int i = 0; i < count; i++) {
+		const RigidBodyBullet *body = moved_bodies[i];
+		Transform xform = body->get_transform();
+
+		r_states.bodies.write[i] = body->get_self();
+		r_states.instance_ids.write[i] = body->get_instance_id();
+
+		float *dataptr = &transforms[i * 12];
+		dataptr[0] = xform.basis.elements[0][0];
+		dataptr[1] = xform.basis.elements[0][1];
+		dataptr[2] = xform.basis.elements[0][2];
+		dataptr[3] = xform.origin.x;
+		dataptr[4] = xform.basis.elements[1][0];
+		dataptr[5] = xform.basis.elements[1][1];
+		dataptr[6] = xform.basis.elements[1][2];
+		dataptr[7] = xform.origin.y;
+		dataptr[8] = xform.basis.elements[2][0];
+		dataptr[9] = xform.basis.elements[2][1];
+		dataptr[10] = xform.basis.elements[2][2];
+		dataptr[11] = xform.origin.z;
+
+		r_states.linear_velocities.write[i] = body->get_linear_velocity();
+		r_states.angular_velocities.write[i] = body->get_angular_velocity();
+		r_states.sleeping.write[i] = !body->is_active();
+	}
+
+	return count;
 }
 
 void SpaceBullet::step(real_t p_delta_time) {
@@ -116,11 +116,15 @@ class SpaceBullet : public RIDBullet {
 	int contactDebugCount = 0;
 	real_t delta_time = 0.;
 
+	Callable body_states_callback;
+
 public:
 	SpaceBullet();
 	virtual ~SpaceBullet();
 
 	void flush_queries();
+	int get_moved_body_states(PhysicsServer3D::BodyStates &r_states) const;
+	void set_body_states_callback(const Callable &p_callable) { body_states_callback = p_callable; }
 	real_t get_delta_time() { return delta_time; }
 	void step(real_t p_delta_time);
 
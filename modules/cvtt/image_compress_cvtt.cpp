@@ -31,9 +31,7 @@
 #include "image_compress_cvtt.h"
 
 #include "core/os/os.h"
-#include "core/os/thread.h"
 #include "core/string/print_string.h"
-#include "core/templates/safe_refcount.h"
 
 #include <ConvectionKernels.h>
 
@@ -53,13 +51,6 @@ struct CVTTCompressionRowTask {
 	int height = 0;
 };
 
-struct CVTTCompressionJobQueue {
-	CVTTCompressionJobParams job_params;
-	const CVTTCompressionRowTask *job_tasks;
-	uint32_t num_tasks = 0;
-	SafeNumeric<uint32_t> current_task;
-};
-
 static void _digest_row_task(const CVTTCompressionJobParams &p_job_params, const CVTTCompressionRowTask &p_row_task) {
 	const uint8_t *in_bytes = p_row_task.in_mm_bytes;
 	uint8_t *out_bytes = p_row_task.out_mm_bytes;
@@ -129,11 +120,19 @@ static void _digest_row_task(const CVTTCompressionJobParams &p_job_params, const
 	}
 }
 
-static void _digest_job_queue(void *p_job_queue) {
-	CVTTCompressionJobQueue *job_queue = static_cast<CVTTCompressionJobQueue *>(p_job_queue);
+static void _digest_block_job(const Image::BlockJob &p_job, const void *p_job_params) {
+	const CVTTCompressionJobParams *job_params = static_cast<const CVTTCompressionJobParams *>(p_job_params);
+	int blocks_per_row = (p_job.width + 3) / 4;
+
+	for (int y_start = p_job.y_start; y_start < p_job.y_end; y_start += 4) {
+		CVTTCompressionRowTask row_task;
+		row_task.width = p_job.width;
+		row_task.height = p_job.height;
+		row_task.y_start = y_start;
+		row_task.in_mm_bytes = p_job.src;
+		row_task.out_mm_bytes = p_job.dst + (y_start / 4) * blocks_per_row * 16;
 
-	for (uint32_t next_task = job_queue->current_task.increment(); next_task <= job_queue->num_tasks; next_task = job_queue->current_task.increment()) {
-		_digest_row_task(job_queue->job_params, job_queue->job_tasks[next_task - 1]);
+		_digest_row_task(*job_params, row_task);
 	}
 }
 
@@ -202,84 +201,97 @@ void image_compress_cvtt(Image *p_image, float p_lossy_quality, Image::UsedChann
 
 	Vector<uint8_t> data;
 	int target_size = Image::get_image_data_size(w, h, target_format, p_image->has_mipmaps());
-	int mm_count = p_image->has_mipmaps() ? Image::get_image_required_mipmaps(w, h, target_format) : 0;
 	data.resize(target_size);
-	int shift = Image::get_format_pixel_rshift(target_format);
 
 	uint8_t *wb = data.ptrw();
 
-	int dst_ofs = 0;
+	CVTTCompressionJobParams job_params;
+	job_params.is_hdr = is_hdr;
+	job_params.is_signed = is_signed;
+	job_params.options = options;
+	job_params.bytes_per_pixel = is_hdr ? 6 : 4;
 
-	CVTTCompressionJobQueue job_queue;
-	job_queue.job_params.is_hdr = is_hdr;
-	job_queue.job_params.is_signed = is_signed;
-	job_queue.job_params.options = options;
-	job_queue.job_params.bytes_per_pixel = is_hdr ? 6 : 4;
+	Image::process_block_jobs(rb, p_image->get_format(), wb, target_format, w, h, p_image->has_mipmaps(), _digest_block_job, &job_params);
 
-#ifdef NO_THREADS
-	int num_job_threads = 0;
-#else
-	int num_job_threads = OS::get_singleton()->can_use_threads() ? (OS::get_singleton()->get_processor_count() - 1) : 0;
-#endif
+	p_image->create(p_image->get_width(), p_image->get_height(), p_image->has_mipmaps(), target_format, data);
+}
 
-	Vector<CVTTCompressionRowTask> tasks;
+struct CVTTDecompressionJobParams {
+	bool is_hdr = false;
+	bool is_signed = false;
+	int bytes_per_pixel = 0;
+};
 
-	for (int i = 0; i <= mm_count; i++) {
-		int bw = w % 4 != 0 ? w + (4 - w % 4) : w;
-		int bh = h % 4 != 0 ? h + (4 - h % 4) : h;
+static void _decompress_block_job(const Image::BlockJob &p_job, const void *p_job_params) {
+	const CVTTDecompressionJobParams *job_params = static_cast<const CVTTDecompressionJobParams *>(p_job_params);
+	int w = p_job.width;
+	int h = p_job.height;
 
-		int src_ofs = p_image->get_mipmap_offset(i);
+	bool is_hdr = job_params->is_hdr;
+	bool is_signed = job_params->is_signed;
+	int bytes_per_pixel = job_params->bytes_per_pixel;
 
-		const uint8_t *in_bytes = &rb[src_ofs];
-		uint8_t *out_bytes = &wb[dst_ofs];
+	const uint8_t *in_bytes = p_job.src + (p_job.y_start / 4) * ((w + 3) / 4) * 16;
+	uint8_t *out_bytes = p_job.dst;
 
-		for (int y_start = 0; y_start < h; y_start += 4) {
-			CVTTCompressionRowTask row_task;
-			row_task.width = w;
-			row_task.height = h;
-			row_task.y_start = y_start;
-			row_task.in_mm_bytes = in_bytes;
-			row_task.out_mm_bytes = out_bytes;
+	cvtt::PixelBlockU8 output_blocks_ldr[cvtt::NumParallelBlocks];
+	cvtt::PixelBlockF16 output_blocks_hdr[cvtt::NumParallelBlocks];
 
-			if (num_job_threads > 0) {
-				tasks.push_back(row_task);
-			} else {
-				_digest_row_task(job_queue.job_params, row_task);
-			}
+	for (int y_start = p_job.y_start; y_start < p_job.y_end; y_start += 4) {
+		int y_end = y_start + 4;
 
-			out_bytes += 16 * (bw / 4);
-		}
+		for (int x_start = 0; x_start < w; x_start += 4 * cvtt::NumParallelBlocks) {
+			int x_end = x_start + 4 * cvtt::NumParallelBlocks;
 
-		dst_ofs += (MAX(4, bw) * MAX(4, bh)) >> shift;
-		w = MAX(w / 2, 1);
-		h = MAX(h / 2, 1);
-	}
+			uint8_t input_blocks[16 * cvtt::NumParallelBlocks];
+			memset(input_blocks, 0, sizeof(input_blocks));
 
-	if (num_job_threads > 0) {
-		Vector<Thread *> threads;
-		threads.resize(num_job_threads);
+			unsigned int num_real_blocks = ((w - x_start) + 3) / 4;
+			if (num_real_blocks > cvtt::NumParallelBlocks) {
+				num_real_blocks = cvtt::NumParallelBlocks;
+			}
 
-		Thread **threads_wb = threads.ptrw();
+			memcpy(input_blocks, in_bytes, 16 * num_real_blocks);
+			in_bytes += 16 * num_real_blocks;
 
-		const CVTTCompressionRowTask *tasks_rb = tasks.ptr();
+			if (is_hdr) {
+				if (is_signed) {
+					cvtt::Kernels::DecodeBC6HS(output_blocks_hdr, input_blocks);
+				} else {
+					cvtt::Kernels::DecodeBC6HU(output_blocks_hdr, input_blocks);
+				}
+			} else {
+				cvtt::Kernels::DecodeBC7(output_blocks_ldr, input_blocks);
+			}
 
-		job_queue.job_tasks = &tasks_rb[0];
-		job_queue.current_task.set(0);
-		job_queue.num_tasks = static_cast<uint32_t>(tasks.size());
+			for (int y = y_start; y < y_end; y++) {
+				int first_input_element = (y - y_start) * 4;
+				uint8_t *row_start;
+				if (y >= h) {
+					row_start = out_bytes + (h - 1) * (w * bytes_per_pixel);
+				} else {
+					row_start = out_bytes + y * (w * bytes_per_pixel);
+				}
 
-		for (int i = 0; i < num_job_threads; i++) {
-			threads_wb[i] = memnew(Thread);
-			threads_wb[i]->start(_digest_job_queue, &job_queue);
-		}
-		_digest_job_queue(&job_queue);
+				for (int x = x_start; x < x_end; x++) {
+					uint8_t *pixel_start;
+					if (x >= w) {
+						pixel_start = row_start + (w - 1) * bytes_per_pixel;
+					} else {
+						pixel_start = row_start + x * bytes_per_pixel;
+					}
 
-		for (int i = 0; i < num_job_threads; i++) {
-			threads_wb[i]->wait_to_finish();
-			memdelete(threads_wb[i]);
+					int block_index = (x - x_start) / 4;
+					int block_element = (x - x_start) % 4 + first_input_element;
+					if (is_hdr) {
+						memcpy(pixel_start, output_blocks_hdr[block_index].m_pixels[block_element], bytes_per_pixel);
+					} else {
+						memcpy(pixel_start, output_blocks_ldr[block_index].m_pixels[block_element], bytes_per_pixel);
+					}
+				}
+			}
 		}
 	}
-
-	p_image->create(p_image->get_width(), p_image->get_height(), p_image->has_mipmaps(), target_format, data);
 }
 
 void image_decompress_cvtt(Image *p_image) {
@@ -310,84 +322,16 @@ void image_decompress_cvtt(Image *p_image) {
 
 	Vector<uint8_t> data;
 	int target_size = Image::get_image_data_size(w, h, target_format, p_image->has_mipmaps());
-	int mm_count = p_image->get_mipmap_count();
 	data.resize(target_size);
 
 	uint8_t *wb = data.ptrw();
 
-	int bytes_per_pixel = is_hdr ? 6 : 4;
-
-	int dst_ofs = 0;
-
-	for (int i = 0; i <= mm_count; i++) {
-		int src_ofs = p_image->get_mipmap_offset(i);
-
-		const uint8_t *in_bytes = &rb[src_ofs];
-		uint8_t *out_bytes = &wb[dst_ofs];
-
-		cvtt::PixelBlockU8 output_blocks_ldr[cvtt::NumParallelBlocks];
-		cvtt::PixelBlockF16 output_blocks_hdr[cvtt::NumParallelBlocks];
-
-		for (int y_start = 0; y_start < h; y_start += 4) {
-			int y_end = y_start + 4;
-
-			for (int x_start = 0; x_start < w; x_start += 4 * cvtt::NumParallelBlocks) {
-				int x_end = x_start + 4 * cvtt::NumParallelBlocks;
-
-				uint8_t input_blocks[16 * cvtt::NumParallelBlocks];
-				memset(input_blocks, 0, sizeof(input_blocks));
-
-				unsigned int num_real_blocks = ((w - x_start) + 3) / 4;
-				if (num_real_blocks > cvtt::NumParallelBlocks) {
-					num_real_blocks = cvtt::NumParallelBlocks;
-				}
-
-				memcpy(input_blocks, in_bytes, 16 * num_real_blocks);
-				in_bytes += 16 * num_real_blocks;
-
-				if (is_hdr) {
-					if (is_signed) {
-						cvtt::Kernels::DecodeBC6HS(output_blocks_hdr, input_blocks);
-					} else {
-						cvtt::Kernels::DecodeBC6HU(output_blocks_hdr, input_blocks);
-					}
-				} else {
-					cvtt::Kernels::DecodeBC7(output_blocks_ldr, input_blocks);
-				}
-
-				for (int y = y_start; y < y_end; y++) {
-					int first_input_element = (y - y_start) * 4;
-					uint8_t *row_start;
-					if (y >= h) {
-						row_start = out_bytes + (h - 1) * (w * bytes_per_pixel);
-					} else {
-						row_start = out_bytes + y * (w * bytes_per_pixel);
-					}
+	CVTTDecompressionJobParams job_params;
+	job_params.is_hdr = is_hdr;
+	job_params.is_signed = is_signed;
+	job_params.bytes_per_pixel = is_hdr ? 6 : 4;
 
-					for (int x = x_start; x < x_end; x++) {
-						uint8_t *pixel_start;
-						if (x >= w) {
-							pixel_start = row_start + (w - 1) * bytes_per_pixel;
-						} else {
-							pixel_start = row_start + x * bytes_per_pixel;
-						}
-
-						int block_index = (x - x_start) / 4;
-						int block_element = (x - x_start) % 4 + first_input_element;
-						if (is_hdr) {
-							memcpy(pixel_start, output_blocks_hdr[block_index].m_pixels[block_element], bytes_per_pixel);
-						} else {
-							memcpy(pixel_start, output_blocks_ldr[block_index].m_pixels[block_element], bytes_per_pixel);
-						}
-					}
-				}
-			}
-		}
-
-		dst_ofs += w * h * bytes_per_pixel;
-		w >>= 1;
-		h >>= 1;
-	}
+	Image::process_block_jobs(rb, input_format, wb, target_format, w, h, p_image->has_mipmaps(), _decompress_block_job, &job_params);
 
 	p_image->create(p_image->get_width(), p_image->get_height(), p_image->has_mipmaps(), target_format, data);
 }
@@ -88,6 +88,49 @@ void _compress_bc(Image *r_img, float p_lossy_quality, Image::UsedChannels p_cha
 	_compress_etcpak(type, r_img, p_lossy_quality);
 }
 
+struct EtcpakJobParams {
+	EtcpakType type = EtcpakType::ETCPAK_TYPE_ETC1;
+	Image::Format target_format = Image::FORMAT_ETC;
+};
+
+static void _compress_etcpak_block_job(const Image::BlockJob &p_job, const void *p_job_params) {
+	const EtcpakJobParams *job_params = static_cast<const EtcpakJobParams *>(p_job_params);
+
+	// Block size. Align stride to multiple of 4 (RGBA8).
+	const int mip_w = (p_job.width + 3) & ~3;
+	const int strip_h = ((p_job.y_end - p_job.y_start) + 3) & ~3;
+	const uint32_t blocks = mip_w * strip_h / 16;
+
+	// Etcpak expects uint64_t pointers, block rows are a multiple of 8 bytes.
+	const int block_row_size = Image::get_image_data_size(mip_w, 4, job_params->target_format);
+	uint64_t *dest_mip_write = (uint64_t *)(p_job.dst + (p_job.y_start / 4) * block_row_size);
+	ERR_FAIL_COND(((uintptr_t)dest_mip_write) % 8 != 0);
+
+	const uint32_t *src_mip_read = (const uint32_t *)p_job.src + p_job.y_start * mip_w;
+
+	switch (job_params->type) {
+		case EtcpakType::ETCPAK_TYPE_ETC1:
+			CompressEtc1RgbDither(src_mip_read, dest_mip_write, blocks, mip_w);
+			break;
+		case EtcpakType::ETCPAK_TYPE_ETC2:
+		case EtcpakType::ETCPAK_TYPE_ETC2_RA_AS_RG:
+			CompressEtc2Rgb(src_mip_read, dest_mip_write, blocks, mip_w);
+			break;
+		case EtcpakType::ETCPAK_TYPE_ETC2_ALPHA:
+			CompressEtc2Rgba(src_mip_read, dest_mip_write, blocks, mip_w);
+			break;
+		case EtcpakType::ETCPAK_TYPE_DXT1:
+			CompressDxt1Dither(src_mip_read, dest_mip_write, blocks, mip_w);
+			break;
+		case EtcpakType::ETCPAK_TYPE_DXT5:
+		case EtcpakType::ETCPAK_TYPE_DXT5_RA_AS_RG:
+			CompressDxt5(src_mip_read, dest_mip_write, blocks, mip_w);
+			break;
+		default:
+			ERR_FAIL_MSG("Invalid or unsupported Etcpak compression format.");
+	}
+}
+
 void _compress_etcpak(EtcpakType p_compresstype, Image *r_img, float p_lossy_quality) {
 	uint64_t start_time = OS::get_singleton()->get_ticks_msec();
 
@@ -143,39 +186,11 @@ void _compress_etcpak(EtcpakType p_compresstype, Image *r_img, float p_lossy_qua
 	dest_data.resize(dest_size);
 	uint8_t *dest_write = dest_data.ptrw();
 
-	int mip_count = mipmaps ? Image::get_image_required_mipmaps(width, height, target_format) : 0;
-
-	for (int i = 0; i < mip_count + 1; i++) {
-		// Get write mip metrics for target image.
-		int mip_w, mip_h;
-		int mip_ofs = Image::get_image_mipmap_offset_and_dimensions(width, height, target_format, i, mip_w, mip_h);
-		// Ensure that mip offset is a multiple of 8 (etcpak expects uint64_t pointer).
-		ERR_FAIL_COND(mip_ofs % 8 != 0);
-		uint64_t *dest_mip_write = (uint64_t *)&dest_write[mip_ofs];
+	EtcpakJobParams job_params;
+	job_params.type = p_compresstype;
+	job_params.target_format = target_format;
 
-		// Block size. Align stride to multiple of 4 (RGBA8).
-		mip_w = (mip_w + 3) & ~3;
-		mip_h = (mip_h + 3) & ~3;
-		const uint32_t blocks = mip_w * mip_h / 16;
-
-		// Get mip data from source image for reading.
-		int src_mip_ofs = r_img->get_mipmap_offset(i);
-		const uint32_t *src_mip_read = (const uint32_t *)&src_read[src_mip_ofs];
-
-		if (p_compresstype == EtcpakType::ETCPAK_TYPE_ETC1) {
-			CompressEtc1RgbDither(src_mip_read, dest_mip_write, blocks, mip_w);
-		} else if (p_compresstype == EtcpakType::ETCPAK_TYPE_ETC2 || p_compresstype == EtcpakType::ETCPAK_TYPE_ETC2_RA_AS_RG) {
-			CompressEtc2Rgb(src_mip_read, dest_mip_write, blocks, mip_w);
-		} else if (p_compresstype == EtcpakType::ETCPAK_TYPE_ETC2_ALPHA) {
-			CompressEtc2Rgba(src_mip_read, dest_mip_write, blocks, mip_w);
-		} else if (p_compresstype == EtcpakType::ETCPAK_TYPE_DXT1) {
-			CompressDxt1Dither(src_mip_read, dest_mip_write, blocks, mip_w);
-		} else if (p_compresstype == EtcpakType::ETCPAK_TYPE_DXT5 || p_compresstype == EtcpakType::ETCPAK_TYPE_DXT5_RA_AS_RG) {
-			CompressDxt5(src_mip_read, dest_mip_write, blocks, mip_w);
-		} else {
-			ERR_FAIL_MSG("Invalid or unsupported Etcpak compression format.");
-		}
-	}
+	Image::process_block_jobs(src_read, Image::FORMAT_RGBA8, dest_write, target_format, width, height, mipmaps, _compress_etcpak_block_job, &job_params);
 
 	// Replace original image with compressed one.
 	r_img->create(width, height, mipmaps, target_format, dest_data);
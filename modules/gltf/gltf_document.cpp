@@ -232,16 +232,10 @@ Error GLTFDocument::_parse_json(const String &p_path, Ref<GLTFState> state) {
 		return err;
 	}
 
-	Vector<uint8_t> array;
-	array.resize(f->get_len());
-	f->get_buffer(array.ptrw(), array.size());
-	String text;
-	text.parse_utf8((const char *)array.ptr(), array.size());
-
 	String err_txt;
 	int err_line;
 	Variant v;
-	err = JSON::parse(text, v, err_txt, err_line);
+	err = JSON::parse_file(f, v, err_txt, err_line);
 	if (err != OK) {
 		_err_print_error("", p_path.utf8().get_data(), err_line, err_txt.utf8().get_data(), ERR_HANDLER_SCRIPT);
 		return err;
@@ -296,13 +290,10 @@ Error GLTFDocument::_parse_glb(const String &p_path, Ref<GLTFState> state) {
 	uint32_t len = f->get_buffer(json_data.ptrw(), chunk_length);
 	ERR_FAIL_COND_V(len != chunk_length, ERR_FILE_CORRUPT);
 
-	String text;
-	text.parse_utf8((const char *)json_data.ptr(), json_data.size());
-
 	String err_txt;
 	int err_line;
 	Variant v;
-	err = JSON::parse(text, v, err_txt, err_line);
+	err = JSON::parse_utf8(json_data.ptr(), json_data.size(), v, err_txt, err_line);
 	if (err != OK) {
 		_err_print_error("", p_path.utf8().get_data(), err_line, err_txt.utf8().get_data(), ERR_HANDLER_SCRIPT);
 		return err;
@@ -6578,17 +6569,17 @@ Error GLTFDocument::_serialize_file(Ref<GLTFState> state, const String p_path) {
 		FileAccessRef f = FileAccess::open(p_path, FileAccess::WRITE, &err);
 		ERR_FAIL_COND_V(!f, FAILED);
 
-		String json = JSON::print(state->json);
+		LocalVector<uint8_t> json;
+		JSON::print_utf8(state->json, json);
 
 		const uint32_t magic = 0x46546C67; // GLTF
 		const int32_t header_size = 12;
 		const int32_t chunk_header_size = 8;
 
-		for (int32_t pad_i = 0; pad_i < (chunk_header_size + json.utf8().length()) % 4; pad_i++) {
-			json += " ";
+		while ((chunk_header_size + json.size()) % 4) {
+			json.push_back(' ');
 		}
-		CharString cs = json.utf8();
-		const uint32_t text_chunk_length = cs.length();
+		const uint32_t text_chunk_length = json.size();
 
 		const uint32_t text_chunk_type = 0x4E4F534A; //JSON
 		int32_t binary_data_length = 0;
@@ -6604,7 +6595,7 @@ Error GLTFDocument::_serialize_file(Ref<GLTFState> state, const String p_path) {
 		f->store_32(header_size + chunk_header_size + text_chunk_length + chunk_header_size + binary_data_length); // length
 		f->store_32(text_chunk_length);
 		f->store_32(text_chunk_type);
-		f->store_buffer((uint8_t *)&cs[0], cs.length());
+		f->store_buffer(json.ptr(), json.size());
 		if (binary_chunk_length) {
 			f->store_32(binary_chunk_length);
 			f->store_32(binary_chunk_type);
@@ -6619,8 +6610,9 @@ Error GLTFDocument::_serialize_file(Ref<GLTFState> state, const String p_path) {
 		ERR_FAIL_COND_V(!f, FAILED);
 
 		f->create(FileAccess::ACCESS_RESOURCES);
-		String json = JSON::print(state->json);
-		f->store_string(json);
+		LocalVector<uint8_t> json;
+		JSON::print_utf8(state->json, json);
+		f->store_buffer(json.ptr(), json.size());
 		f->close();
 	}
 	return err;
@@ -32,6 +32,15 @@
 
 #include <squish.h>
 
+static void _decompress_squish_block_job(const Image::BlockJob &p_job, const void *p_squish_flags) {
+	int squish_flags = *static_cast<const int *>(p_squish_flags);
+	int block_row_size = squish::GetStorageRequirements(p_job.width, 4, squish_flags);
+
+	const uint8_t *src = p_job.src + (p_job.y_start / 4) * block_row_size;
+	uint8_t *dst = p_job.dst + p_job.y_start * p_job.width * 4;
+	squish::DecompressImage(dst, p_job.width, p_job.y_end - p_job.y_start, src, squish_flags);
+}
+
 void image_decompress_squish(Image *p_image) {
 	int w = p_image->get_width();
 	int h = p_image->get_height();
@@ -39,7 +48,6 @@ void image_decompress_squish(Image *p_image) {
 	Image::Format target_format = Image::FORMAT_RGBA8;
 	Vector<uint8_t> data;
 	int target_size = Image::get_image_data_size(w, h, target_format, p_image->has_mipmaps());
-	int mm_count = p_image->get_mipmap_count();
 	data.resize(target_size);
 
 	const uint8_t *rb = p_image->get_data().ptr();
@@ -61,14 +69,7 @@ void image_decompress_squish(Image *p_image) {
 		return;
 	}
 
-	for (int i = 0; i <= mm_count; i++) {
-		int src_ofs = 0, mipmap_size = 0, mipmap_w = 0, mipmap_h = 0;
-		p_image->get_mipmap_offset_size_and_dimensions(i, src_ofs, mipmap_size, mipmap_w, mipmap_h);
-		int dst_ofs = Image::get_image_mipmap_offset(p_image->get_width(), p_image->get_height(), target_format, i);
-		squish::DecompressImage(&wb[dst_ofs], w, h, &rb[src_ofs], squish_flags);
-		w >>= 1;
-		h >>= 1;
-	}
+	Image::process_block_jobs(rb, p_image->get_format(), wb, target_format, w, h, p_image->has_mipmaps(), _decompress_squish_block_job, &squish_flags);
 
 	p_image->create(p_image->get_width(), p_image->get_height(), p_image->has_mipmaps(), target_format, data);
 
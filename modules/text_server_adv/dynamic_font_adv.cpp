@@ -35,6 +35,13 @@
 #include FT_STROKER_H
 #include FT_ADVANCES_H
 #include FT_MULTIPLE_MASTERS_H
+#include FT_OUTLINE_H
+
+// Distance field glyphs cheaper than this (pixels * outline segments) are generated on the calling thread.
+#define SDF_THREADING_THRESHOLD 65536
+
+ThreadWorkPool *DynamicFontDataAdvanced::sdf_work_pool = nullptr;
+Mutex DynamicFontDataAdvanced::sdf_work_mutex;
 
 DynamicFontDataAdvanced::DataAtSize *DynamicFontDataAdvanced::get_data_for_size(int p_size, int p_outline_size) {
 	ERR_FAIL_COND_V(!valid, nullptr);
@@ -446,6 +453,61 @@ DynamicFontDataAdvanced::Character DynamicFontDataAdvanced::bitmap_to_character(
 	return chr;
 }
 
+DynamicFontDataAdvanced::Character DynamicFontDataAdvanced::sdf_to_character(DynamicFontDataAdvanced::DataAtSize *p_data, const Vector<uint8_t> &p_sdf, int p_width, int p_height, const Vector2 &p_align) {
+	int margin = rect_margin;
+	int mw = p_width + margin * 2;
+	int mh = p_height + margin * 2;
+
+	ERR_FAIL_COND_V(mw > 4096, Character::not_found());
+	ERR_FAIL_COND_V(mh > 4096, Character::not_found());
+
+	TexturePosition tex_pos = find_texture_pos_for_glyph(p_data, 2, Image::FORMAT_LA8, mw, mh);
+	ERR_FAIL_COND_V(tex_pos.index < 0, Character::not_found());
+
+	CharTexture &tex = p_data->textures.write[tex_pos.index];
+
+	{
+		uint8_t *wr = tex.imgdata.ptrw();
+		const uint8_t *rd = p_sdf.ptr();
+
+		// The margin is written as well, filtering across the glyph border must read "outside" distances.
+		for (int i = 0; i < mh; i++) {
+			for (int j = 0; j < mw; j++) {
+				int ofs = ((i + tex_pos.y) * tex.texture_size + j + tex_pos.x) * 2;
+				ERR_FAIL_COND_V(ofs >= tex.imgdata.size(), Character::not_found());
+				int si = i - margin;
+				int sj = j - margin;
+				uint8_t d = (si >= 0 && si < p_height && sj >= 0 && sj < p_width) ? rd[si * p_width + sj] : 0;
+				wr[ofs + 0] = d;
+				wr[ofs + 1] = d;
+			}
+		}
+	}
+
+	if (RenderingServer::get_singleton() != nullptr) {
+		Ref<Image> img = memnew(Image(tex.texture_size, tex.texture_size, 0, Image::FORMAT_LA8, tex.imgdata));
+
+		if (tex.texture.is_null()) {
+			tex.texture.instance();
+			tex.texture->create_from_image(img);
+		} else {
+			tex.texture->update(img);
+		}
+	}
+
+	for (int k = tex_pos.x; k < tex_pos.x + mw; k++) {
+		tex.offsets.write[k] = tex_pos.y + mh;
+	}
+
+	Character chr;
+	chr.align = p_align;
+	chr.texture_idx = tex_pos.index;
+	chr.found = true;
+	chr.rect_uv = Rect2(tex_pos.x + margin, tex_pos.y + margin, p_width, p_height);
+	chr.rect = Rect2(Vector2(), Vector2(p_width, p_height));
+	return chr;
+}
+
 void DynamicFontDataAdvanced::update_glyph(int p_size, uint32_t p_index) {
 	DataAtSize *fds = get_data_for_size(p_size, false);
 	ERR_FAIL_COND(fds == nullptr);
@@ -479,6 +541,15 @@ void DynamicFontDataAdvanced::update_glyph(int p_size, uint32_t p_index) {
 	FT_Get_Advance(fds->face, p_index, FT_HAS_COLOR(fds->face) ? FT_LOAD_COLOR : FT_LOAD_DEFAULT | (force_autohinter ? FT_LOAD_FORCE_AUTOHINT : 0) | ft_hinting, &h);
 	FT_Get_Advance(fds->face, p_index, FT_HAS_COLOR(fds->face) ? FT_LOAD_COLOR : FT_LOAD_DEFAULT | (force_autohinter ? FT_LOAD_FORCE_AUTOHINT : 0) | ft_hinting | FT_LOAD_VERTICAL_LAYOUT, &v);
 
+	if (msdf && !FT_HAS_COLOR(fds->face)) {
+		// Only the advance depends on the size, the image is taken from the distance field atlas.
+		character.found = true;
+		character.texture_idx = -1;
+		character.advance = (Vector2((h + (1 << 9)) >> 10, (v + (1 << 9)) >> 10) / 64.0 * fds->scale_color_font / oversampling).round();
+		fds->glyph_map[p_index] = character;
+		return;
+	}
+
 	int error = FT_Load_Glyph(fds->face, p_index, FT_HAS_COLOR(fds->face) ? FT_LOAD_COLOR : FT_LOAD_DEFAULT | (force_autohinter ? FT_LOAD_FORCE_AUTOHINT : 0) | ft_hinting);
 	if (error) {
 		fds->glyph_map[p_index] = character;
@@ -544,6 +615,189 @@ cleanup_stroker:
 	fds->glyph_map[p_index] = character;
 }
 
+struct SDFOutlineContext {
+	LocalVector<Vector2> *segments = nullptr;
+	Vector2 last;
+	float scale = 1.f;
+};
+
+static int _sdf_move_to(const FT_Vector *p_to, void *p_user) {
+	SDFOutlineContext *ctx = (SDFOutlineContext *)p_user;
+	ctx->last = Vector2(p_to->x, p_to->y) * ctx->scale;
+	return 0;
+}
+
+static int _sdf_line_to(const FT_Vector *p_to, void *p_user) {
+	SDFOutlineContext *ctx = (SDFOutlineContext *)p_user;
+	Vector2 to = Vector2(p_to->x, p_to->y) * ctx->scale;
+	ctx->segments->push_back(ctx->last);
+	ctx->segments->push_back(to);
+	ctx->last = to;
+	return 0;
+}
+
+static int _sdf_conic_to(const FT_Vector *p_control, const FT_Vector *p_to, void *p_user) {
+	SDFOutlineContext *ctx = (SDFOutlineContext *)p_user;
+	Vector2 from = ctx->last;
+	Vector2 control = Vector2(p_control->x, p_control->y) * ctx->scale;
+	Vector2 to = Vector2(p_to->x, p_to->y) * ctx->scale;
+	const int steps = 8;
+	for (int i = 1; i <= steps; i++) {
+		float t = float(i) / steps;
+		Vector2 p = from.lerp(control, t).lerp(control.lerp(to, t), t);
+		ctx->segments->push_back(ctx->last);
+		ctx->segments->push_back(p);
+		ctx->last = p;
+	}
+	return 0;
+}
+
+static int _sdf_cubic_to(const FT_Vector *p_control1, const FT_Vector *p_control2, const FT_Vector *p_to, void *p_user) {
+	SDFOutlineContext *ctx = (SDFOutlineContext *)p_user;
+	Vector2 from = ctx->last;
+	Vector2 control1 = Vector2(p_control1->x, p_control1->y) * ctx->scale;
+	Vector2 control2 = Vector2(p_control2->x, p_control2->y) * ctx->scale;
+	Vector2 to = Vector2(p_to->x, p_to->y) * ctx->scale;
+	const int steps = 12;
+	for (int i = 1; i <= steps; i++) {
+		float t = float(i) / steps;
+		Vector2 p = from * ((1 - t) * (1 - t) * (1 - t)) + control1 * (3 * (1 - t) * (1 - t) * t) + control2 * (3 * (1 - t) * t * t) + to * (t * t * t);
+		ctx->segments->push_back(ctx->last);
+		ctx->segments->push_back(p);
+		ctx->last = p;
+	}
+	return 0;
+}
+
+void DynamicFontDataAdvanced::_generate_sdf_row(uint32_t p_row, SDFParams *p_params) {
+	const Vector2 *seg = p_params->segments.ptr();
+	uint32_t seg_count = p_params->segments.size() / 2;
+	uint8_t *dst = p_params->dst + p_row * p_params->width;
+
+	for (int x = 0; x < p_params->width; x++) {
+		Vector2 p = Vector2(p_params->origin.x + x, p_params->origin.y - p_row);
+		real_t min_dist_sq = 1e20;
+		int winding = 0;
+		for (uint32_t i = 0; i < seg_count; i++) {
+			const Vector2 &a = seg[i * 2 + 0];
+			const Vector2 &b = seg[i * 2 + 1];
+			Vector2 ab = b - a;
+			Vector2 ap = p - a;
+
+			real_t len_sq = ab.length_squared();
+			real_t t = (len_sq > 0) ? CLAMP(ap.dot(ab) / len_sq, 0, 1) : 0;
+			min_dist_sq = MIN(min_dist_sq, (ap - ab * t).length_squared());
+
+			// Non-zero winding rule.
+			if (a.y <= p.y) {
+				if (b.y > p.y && ab.cross(ap) > 0) {
+					winding++;
+				}
+			} else if (b.y <= p.y && ab.cross(ap) < 0) {
+				winding--;
+			}
+		}
+		real_t dist = Math::sqrt(min_dist_sq);
+		if (winding == 0) {
+			dist = -dist;
+		}
+		dst[x] = (uint8_t)CLAMP(Math::round((0.5 + dist / p_params->range) * 255.0), 0, 255);
+	}
+}
+
+void DynamicFontDataAdvanced::update_glyph_sdf(uint32_t p_index) {
+	if (msdf_atlas == nullptr) {
+		msdf_atlas = memnew(DataAtSize);
+		msdf_atlas->size = msdf_size;
+	}
+
+	if (msdf_atlas->glyph_map.has(p_index)) {
+		return;
+	}
+
+	Character character = Character::not_found();
+	DataAtSize *fds = get_data_for_size(base_size);
+	if (fds == nullptr || p_index == 0) {
+		msdf_atlas->glyph_map[p_index] = character;
+		return;
+	}
+
+	// Unscaled outline, the atlas does not depend on the font size or oversampling.
+	int error = FT_Load_Glyph(fds->face, p_index, FT_LOAD_NO_SCALE | FT_LOAD_NO_BITMAP);
+	if (error || fds->face->glyph->format != FT_GLYPH_FORMAT_OUTLINE) {
+		msdf_atlas->glyph_map[p_index] = character;
+		return;
+	}
+
+	SDFParams params;
+
+	SDFOutlineContext ctx;
+	ctx.segments = &params.segments;
+	ctx.scale = float(msdf_size) / fds->face->units_per_EM;
+
+	FT_Outline_Funcs funcs;
+	funcs.move_to = _sdf_move_to;
+	funcs.line_to = _sdf_line_to;
+	funcs.conic_to = _sdf_conic_to;
+	funcs.cubic_to = _sdf_cubic_to;
+	funcs.shift = 0;
+	funcs.delta = 0;
+	FT_Outline_Decompose(&fds->face->glyph->outline, &funcs, &ctx);
+
+	if (params.segments.is_empty()) {
+		// Empty glyph (e.g. space), nothing to draw.
+		character.found = true;
+		character.texture_idx = -1;
+		msdf_atlas->glyph_map[p_index] = character;
+		return;
+	}
+
+	Vector2 min = params.segments[0];
+	Vector2 max = params.segments[0];
+	for (uint32_t i = 1; i < params.segments.size(); i++) {
+		min = Vector2(MIN(min.x, params.segments[i].x), MIN(min.y, params.segments[i].y));
+		max = Vector2(MAX(max.x, params.segments[i].x), MAX(max.y, params.segments[i].y));
+	}
+
+	int pad = msdf_range / 2;
+	int x0 = (int)Math::floor(min.x) - pad;
+	int y1 = (int)Math::ceil(max.y) + pad;
+	params.width = (int)Math::ceil(max.x) + pad - x0;
+	params.height = y1 - ((int)Math::floor(min.y) - pad);
+	params.origin = Vector2(x0 + 0.5, y1 - 0.5);
+	params.range = msdf_range;
+
+	Vector<uint8_t> sdf;
+	sdf.resize(params.width * params.height);
+	params.dst = sdf.ptrw();
+
+	uint64_t cost = (uint64_t)params.width * params.height * (params.segments.size() / 2);
+	if (cost > SDF_THREADING_THRESHOLD) {
+		MutexLock lock(sdf_work_mutex);
+		if (sdf_work_pool == nullptr) {
+			sdf_work_pool = memnew(ThreadWorkPool);
+			sdf_work_pool->init();
+		}
+		sdf_work_pool->do_work(params.height, this, &DynamicFontDataAdvanced::_generate_sdf_row, &params);
+	} else {
+		for (int i = 0; i < params.height; i++) {
+			_generate_sdf_row(i, &params);
+		}
+	}
+
+	character = sdf_to_character(msdf_atlas, sdf, params.width, params.height, Vector2(x0, -y1));
+	msdf_atlas->glyph_map[p_index] = character;
+}
+
+void DynamicFontDataAdvanced::finish_sdf_work_pool() {
+	MutexLock lock(sdf_work_mutex);
+	if (sdf_work_pool != nullptr) {
+		sdf_work_pool->finish();
+		memdelete(sdf_work_pool);
+		sdf_work_pool = nullptr;
+	}
+}
+
 void DynamicFontDataAdvanced::clear_cache() {
 	_THREAD_SAFE_METHOD_
 	for (Map<CacheID, DataAtSize *>::Element *E = size_cache.front(); E; E = E->next()) {
@@ -554,6 +808,10 @@ void DynamicFontDataAdvanced::clear_cache() {
 		memdelete(E->get());
 	}
 	size_cache_outline.clear();
+	if (msdf_atlas != nullptr) {
+		memdelete(msdf_atlas);
+		msdf_atlas = nullptr;
+	}
 }
 
 Error DynamicFontDataAdvanced::load_from_file(const String &p_filename, int p_base_size) {
@@ -848,6 +1106,17 @@ TextServer::Hinting DynamicFontDataAdvanced::get_hinting() const {
 	return hinting;
 }
 
+void DynamicFontDataAdvanced::set_distance_field_hint(bool p_distance_field) {
+	if (msdf != p_distance_field) {
+		clear_cache();
+		msdf = p_distance_field;
+	}
+}
+
+bool DynamicFontDataAdvanced::get_distance_field_hint() const {
+	return msdf;
+}
+
 bool DynamicFontDataAdvanced::has_outline() const {
 	return true;
 }
@@ -935,11 +1204,42 @@ Vector2 DynamicFontDataAdvanced::get_kerning(uint32_t p_char, uint32_t p_next, i
 	return Vector2(delta.x, delta.y);
 }
 
+Vector2 DynamicFontDataAdvanced::_draw_glyph_sdf(RID p_canvas, int p_size, int p_outline_size, const Vector2 &p_pos, uint32_t p_index, const Color &p_color) const {
+	DataAtSize *fds = const_cast<DynamicFontDataAdvanced *>(this)->get_data_for_size(p_size);
+	ERR_FAIL_COND_V(fds == nullptr, Vector2());
+
+	const_cast<DynamicFontDataAdvanced *>(this)->update_glyph(p_size, p_index);
+	const_cast<DynamicFontDataAdvanced *>(this)->update_glyph_sdf(p_index);
+	Character ch = fds->glyph_map[p_index];
+	Character sdf = msdf_atlas->glyph_map[p_index];
+
+	if (sdf.found) {
+		ERR_FAIL_COND_V(sdf.texture_idx < -1 || sdf.texture_idx >= msdf_atlas->textures.size(), Vector2());
+
+		if (sdf.texture_idx != -1 && RenderingServer::get_singleton() != nullptr) {
+			float scale = float(p_size) / msdf_size;
+			if (p_outline_size / scale > msdf_range / 2) {
+				// The distance field only extends half its range outside the glyph, the shader clamps wider outlines.
+				WARN_PRINT_ONCE(vformat("Outline size %d is too large for a distance field font at size %d, it is limited to %d pixels.", p_outline_size, p_size, int(msdf_range / 2 * scale)));
+			}
+			RID texture = msdf_atlas->textures[sdf.texture_idx].texture->get_rid();
+			RenderingServer::get_singleton()->canvas_item_add_msdf_texture_rect_region(p_canvas, Rect2(p_pos + sdf.align * scale, sdf.rect.size * scale), texture, sdf.rect_uv, p_color, p_outline_size / scale, msdf_range);
+		}
+	}
+
+	// Outlines advance the pen by the glyph advance, same as the rasterized path.
+	return ch.advance;
+}
+
 Vector2 DynamicFontDataAdvanced::draw_glyph(RID p_canvas, int p_size, const Vector2 &p_pos, uint32_t p_index, const Color &p_color) const {
 	_THREAD_SAFE_METHOD_
 	DataAtSize *fds = const_cast<DynamicFontDataAdvanced *>(this)->get_data_for_size(p_size);
 	ERR_FAIL_COND_V(fds == nullptr, Vector2());
 
+	if (msdf && !FT_HAS_COLOR(fds->face)) {
+		return _draw_glyph_sdf(p_canvas, p_size, 0, p_pos, p_index, p_color);
+	}
+
 	const_cast<DynamicFontDataAdvanced *>(this)->update_glyph(p_size, p_index);
 	Character ch = fds->glyph_map[p_index];
 
@@ -968,6 +1268,14 @@ Vector2 DynamicFontDataAdvanced::draw_glyph(RID p_canvas, int p_size, const Vect
 
 Vector2 DynamicFontDataAdvanced::draw_glyph_outline(RID p_canvas, int p_size, int p_outline_size, const Vector2 &p_pos, uint32_t p_index, const Color &p_color) const {
 	_THREAD_SAFE_METHOD_
+	if (msdf) {
+		DataAtSize *base_fds = const_cast<DynamicFontDataAdvanced *>(this)->get_data_for_size(p_size);
+		ERR_FAIL_COND_V(base_fds == nullptr, Vector2());
+		if (!FT_HAS_COLOR(base_fds->face)) {
+			return _draw_glyph_sdf(p_canvas, p_size, p_outline_size, p_pos, p_index, p_color);
+		}
+	}
+
 	DataAtSize *fds = const_cast<DynamicFontDataAdvanced *>(this)->get_data_for_size(p_size, p_outline_size);
 	ERR_FAIL_COND_V(fds == nullptr, Vector2());
 
@@ -1020,6 +1328,27 @@ bool DynamicFontDataAdvanced::get_glyph_contours(int p_size, uint32_t p_index, V
 	return true;
 }
 
+uint64_t DynamicFontDataAdvanced::get_glyph_cache_memory() const {
+	_THREAD_SAFE_METHOD_
+	uint64_t size = 0;
+	for (const Map<CacheID, DataAtSize *>::Element *E = size_cache.front(); E; E = E->next()) {
+		for (int i = 0; i < E->get()->textures.size(); i++) {
+			size += E->get()->textures[i].imgdata.size();
+		}
+	}
+	for (const Map<CacheID, DataAtSize *>::Element *E = size_cache_outline.front(); E; E = E->next()) {
+		for (int i = 0; i < E->get()->textures.size(); i++) {
+			size += E->get()->textures[i].imgdata.size();
+		}
+	}
+	if (msdf_atlas != nullptr) {
+		for (int i = 0; i < msdf_atlas->textures.size(); i++) {
+			size += msdf_atlas->textures[i].imgdata.size();
+		}
+	}
+	return size;
+}
+
 DynamicFontDataAdvanced::~DynamicFontDataAdvanced() {
 	clear_cache();
 	if (library != nullptr) {
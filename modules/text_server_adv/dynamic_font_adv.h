@@ -33,6 +33,8 @@
 
 #include "font_adv.h"
 
+#include "core/templates/local_vector.h"
+#include "core/templates/thread_work_pool.h"
 #include "modules/modules_enabled.gen.h"
 
 #ifdef MODULE_FREETYPE_ENABLED
@@ -131,12 +133,36 @@ private:
 	Map<CacheID, DataAtSize *> size_cache;
 	Map<CacheID, DataAtSize *> size_cache_outline;
 
+	// Distance field mode: glyphs are generated once from the outlines into a size-independent
+	// atlas and scaled by the canvas renderer, per-size caches only keep the advances.
+	bool msdf = false;
+	int msdf_size = 48; // Reference size of the atlas glyphs in pixels.
+	int msdf_range = 8; // Distance range encoded in the atlas, in pixels at the reference size.
+	DataAtSize *msdf_atlas = nullptr;
+
+	struct SDFParams {
+		LocalVector<Vector2> segments; // Flattened outline, pairs of points.
+		Vector2 origin; // Glyph space position of the top-left pixel center.
+		int width = 0;
+		int height = 0;
+		float range = 0.f;
+		uint8_t *dst = nullptr;
+	};
+
+	static ThreadWorkPool *sdf_work_pool;
+	static Mutex sdf_work_mutex;
+
+	void _generate_sdf_row(uint32_t p_row, SDFParams *p_params);
+
 	DataAtSize *get_data_for_size(int p_size, int p_outline_size = 0);
 
 	TexturePosition find_texture_pos_for_glyph(DataAtSize *p_data, int p_color_size, Image::Format p_image_format, int p_width, int p_height);
 	Character bitmap_to_character(DataAtSize *p_data, FT_Bitmap bitmap, int yofs, int xofs, const Vector2 &advance);
+	Character sdf_to_character(DataAtSize *p_data, const Vector<uint8_t> &p_sdf, int p_width, int p_height, const Vector2 &p_align);
 	_FORCE_INLINE_ void update_glyph(int p_size, uint32_t p_index);
 	_FORCE_INLINE_ void update_glyph_outline(int p_size, int p_outline_size, uint32_t p_index);
+	_FORCE_INLINE_ void update_glyph_sdf(uint32_t p_index);
+	Vector2 _draw_glyph_sdf(RID p_canvas, int p_size, int p_outline_size, const Vector2 &p_pos, uint32_t p_index, const Color &p_color) const;
 
 public:
 	virtual void clear_cache() override;
@@ -166,8 +192,8 @@ public:
 	virtual void set_force_autohinter(bool p_enabled) override;
 	virtual bool get_force_autohinter() const override;
 
-	virtual void set_distance_field_hint(bool p_distance_field) override{};
-	virtual bool get_distance_field_hint() const override { return false; };
+	virtual void set_distance_field_hint(bool p_distance_field) override;
+	virtual bool get_distance_field_hint() const override;
 
 	virtual bool has_outline() const override;
 	virtual float get_base_size() const override;
@@ -188,6 +214,10 @@ public:
 
 	virtual bool get_glyph_contours(int p_size, uint32_t p_index, Vector<Vector3> &r_points, Vector<int32_t> &r_contours, bool &r_orientation) const override;
 
+	virtual uint64_t get_glyph_cache_memory() const override;
+
+	static void finish_sdf_work_pool();
+
 	virtual ~DynamicFontDataAdvanced() override;
 };
 
@@ -109,6 +109,8 @@ struct FontDataAdvanced {
 
 	virtual bool get_glyph_contours(int p_size, uint32_t p_index, Vector<Vector3> &r_points, Vector<int32_t> &r_contours, bool &r_orientation) const { return false; };
 
+	virtual uint64_t get_glyph_cache_memory() const { return 0; };
+
 	virtual ~FontDataAdvanced(){};
 };
 
@@ -148,6 +148,7 @@ void TextServerAdvanced::free(RID p_rid) {
 		FontDataAdvanced *fd = font_owner.getornull(p_rid);
 		font_owner.free(p_rid);
 		memdelete(fd);
+		shaping_cache.clear();
 	} else if (shaped_owner.owns(p_rid)) {
 		ShapedTextDataAdvanced *sd = shaped_owner.getornull(p_rid);
 		shaped_owner.free(p_rid);
@@ -586,6 +587,7 @@ void TextServerAdvanced::font_bitmap_add_texture(RID p_font, const Ref<Texture>
 	_THREAD_SAFE_METHOD_
 	FontDataAdvanced *fd = font_owner.getornull(p_font);
 	ERR_FAIL_COND(!fd);
+	shaping_cache.clear();
 	fd->bitmap_add_texture(p_texture);
 }
 
@@ -593,6 +595,7 @@ void TextServerAdvanced::font_bitmap_add_char(RID p_font, char32_t p_char, int p
 	_THREAD_SAFE_METHOD_
 	FontDataAdvanced *fd = font_owner.getornull(p_font);
 	ERR_FAIL_COND(!fd);
+	shaping_cache.clear();
 	fd->bitmap_add_char(p_char, p_texture_idx, p_rect, p_align, p_advance);
 }
 
@@ -600,6 +603,7 @@ void TextServerAdvanced::font_bitmap_add_kerning_pair(RID p_font, char32_t p_A,
 	_THREAD_SAFE_METHOD_
 	FontDataAdvanced *fd = font_owner.getornull(p_font);
 	ERR_FAIL_COND(!fd);
+	shaping_cache.clear();
 	fd->bitmap_add_kerning_pair(p_A, p_B, p_kerning);
 }
 
@@ -649,6 +653,7 @@ void TextServerAdvanced::font_set_spacing_space(RID p_font, int p_value) {
 	_THREAD_SAFE_METHOD_
 	FontDataAdvanced *fd = font_owner.getornull(p_font);
 	ERR_FAIL_COND(!fd);
+	shaping_cache.clear();
 	fd->set_spacing_space(p_value);
 }
 
@@ -663,6 +668,7 @@ void TextServerAdvanced::font_set_spacing_glyph(RID p_font, int p_value) {
 	_THREAD_SAFE_METHOD_
 	FontDataAdvanced *fd = font_owner.getornull(p_font);
 	ERR_FAIL_COND(!fd);
+	shaping_cache.clear();
 	fd->set_spacing_glyph(p_value);
 }
 
@@ -670,6 +676,7 @@ void TextServerAdvanced::font_set_antialiased(RID p_font, bool p_antialiased) {
 	_THREAD_SAFE_METHOD_
 	FontDataAdvanced *fd = font_owner.getornull(p_font);
 	ERR_FAIL_COND(!fd);
+	shaping_cache.clear();
 	fd->set_antialiased(p_antialiased);
 }
 
@@ -698,6 +705,7 @@ void TextServerAdvanced::font_set_variation(RID p_font, const String &p_name, do
 	_THREAD_SAFE_METHOD_
 	FontDataAdvanced *fd = font_owner.getornull(p_font);
 	ERR_FAIL_COND(!fd);
+	shaping_cache.clear();
 	fd->set_variation(p_name, p_value);
 }
 
@@ -712,6 +720,7 @@ void TextServerAdvanced::font_set_distance_field_hint(RID p_font, bool p_distanc
 	_THREAD_SAFE_METHOD_
 	FontDataAdvanced *fd = font_owner.getornull(p_font);
 	ERR_FAIL_COND(!fd);
+	shaping_cache.clear();
 	fd->set_distance_field_hint(p_distance_field);
 }
 
@@ -726,6 +735,7 @@ void TextServerAdvanced::font_set_hinting(RID p_font, TextServer::Hinting p_hint
 	_THREAD_SAFE_METHOD_
 	FontDataAdvanced *fd = font_owner.getornull(p_font);
 	ERR_FAIL_COND(!fd);
+	shaping_cache.clear();
 	fd->set_hinting(p_hinting);
 }
 
@@ -740,6 +750,7 @@ void TextServerAdvanced::font_set_force_autohinter(RID p_font, bool p_enabeld) {
 	_THREAD_SAFE_METHOD_
 	FontDataAdvanced *fd = font_owner.getornull(p_font);
 	ERR_FAIL_COND(!fd);
+	shaping_cache.clear();
 	fd->set_force_autohinter(p_enabeld);
 }
 
@@ -799,6 +810,7 @@ void TextServerAdvanced::font_set_language_support_override(RID p_font, const St
 	_THREAD_SAFE_METHOD_
 	FontDataAdvanced *fd = font_owner.getornull(p_font);
 	ERR_FAIL_COND(!fd);
+	shaping_cache.clear();
 	fd->lang_support_overrides[p_language] = p_supported;
 }
 
@@ -813,6 +825,7 @@ void TextServerAdvanced::font_remove_language_support_override(RID p_font, const
 	_THREAD_SAFE_METHOD_
 	FontDataAdvanced *fd = font_owner.getornull(p_font);
 	ERR_FAIL_COND(!fd);
+	shaping_cache.clear();
 	fd->lang_support_overrides.erase(p_language);
 }
 
@@ -843,6 +856,7 @@ void TextServerAdvanced::font_set_script_support_override(RID p_font, const Stri
 	_THREAD_SAFE_METHOD_
 	FontDataAdvanced *fd = font_owner.getornull(p_font);
 	ERR_FAIL_COND(!fd);
+	shaping_cache.clear();
 	fd->script_support_overrides[p_script] = p_supported;
 }
 
@@ -857,6 +871,7 @@ void TextServerAdvanced::font_remove_script_support_override(RID p_font, const S
 	_THREAD_SAFE_METHOD_
 	FontDataAdvanced *fd = font_owner.getornull(p_font);
 	ERR_FAIL_COND(!fd);
+	shaping_cache.clear();
 	fd->script_support_overrides.erase(p_script);
 }
 
@@ -906,6 +921,13 @@ Vector2 TextServerAdvanced::font_draw_glyph_outline(RID p_font, RID p_canvas, in
 	return fd->draw_glyph_outline(p_canvas, p_size, p_outline_size, p_pos, p_index, p_color);
 }
 
+uint64_t TextServerAdvanced::font_get_glyph_cache_memory(RID p_font) const {
+	_THREAD_SAFE_METHOD_
+	const FontDataAdvanced *fd = font_owner.getornull(p_font);
+	ERR_FAIL_COND_V(!fd, 0);
+	return fd->get_glyph_cache_memory();
+}
+
 bool TextServerAdvanced::font_get_glyph_contours(RID p_font, int p_size, uint32_t p_index, Vector<Vector3> &r_points, Vector<int32_t> &r_contours, bool &r_orientation) const {
 	_THREAD_SAFE_METHOD_
 	const FontDataAdvanced *fd = font_owner.getornull(p_font);
@@ -926,6 +948,7 @@ void TextServerAdvanced::font_set_oversampling(float p_oversampling) {
 		for (List<RID>::Element *E = fonts.front(); E; E = E->next()) {
 			font_owner.getornull(E->get())->clear_cache();
 		}
+		shaping_cache.clear();
 
 		List<RID> text_bufs;
 		shaped_owner.get_owned_list(&text_bufs);
@@ -939,6 +962,110 @@ Vector<String> TextServerAdvanced::get_system_fonts() const {
 	return Vector<String>();
 }
 
+/*************************************************************************/
+/* Shaping cache                                                         */
+/*************************************************************************/
+
+bool TextServerAdvanced::ShapingCacheKey::operator==(const ShapingCacheKey &p_key) const {
+	if (hash_value != p_key.hash_value || direction != p_key.direction || orientation != p_key.orientation || preserve_invalid != p_key.preserve_invalid || preserve_control != p_key.preserve_control) {
+		return false;
+	}
+	if (text != p_key.text || bidi_override != p_key.bidi_override || spans.size() != p_key.spans.size()) {
+		return false;
+	}
+	for (int i = 0; i < spans.size(); i++) {
+		const Span &a = spans[i];
+		const Span &b = p_key.spans[i];
+		if (a.start != b.start || a.end != b.end || a.font_size != b.font_size || a.language != b.language || a.fonts != b.fonts) {
+			return false;
+		}
+		if (a.features.size() != b.features.size()) {
+			return false;
+		}
+		Array keys = a.features.keys();
+		for (int j = 0; j < keys.size(); j++) {
+			if (!b.features.has(keys[j]) || !a.features[keys[j]].hash_compare(b.features[keys[j]])) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+void TextServerAdvanced::_shaping_cache_make_key(const ShapedTextDataAdvanced *p_sd, ShapingCacheKey &r_key) const {
+	r_key.text = p_sd->text;
+	r_key.direction = p_sd->direction;
+	r_key.orientation = p_sd->orientation;
+	r_key.preserve_invalid = p_sd->preserve_invalid;
+	r_key.preserve_control = p_sd->preserve_control;
+	r_key.bidi_override = p_sd->bidi_override;
+
+	uint32_t h = p_sd->text.hash();
+	h = hash_djb2_one_32(p_sd->direction, h);
+	h = hash_djb2_one_32(p_sd->orientation, h);
+	h = hash_djb2_one_32((p_sd->preserve_invalid ? 1 : 0) | (p_sd->preserve_control ? 2 : 0), h);
+	for (int i = 0; i < p_sd->bidi_override.size(); i++) {
+		h = hash_djb2_one_32(p_sd->bidi_override[i].x, h);
+		h = hash_djb2_one_32(p_sd->bidi_override[i].y, h);
+	}
+
+	r_key.spans.resize(p_sd->spans.size());
+	ShapingCacheKey::Span *spans_w = r_key.spans.ptrw();
+	for (int i = 0; i < p_sd->spans.size(); i++) {
+		const ShapedTextDataAdvanced::Span &span = p_sd->spans[i];
+		spans_w[i].start = span.start;
+		spans_w[i].end = span.end;
+		spans_w[i].fonts = span.fonts;
+		spans_w[i].font_size = span.font_size;
+		spans_w[i].language = span.language;
+		spans_w[i].features = span.features;
+
+		h = hash_djb2_one_32(span.start, h);
+		h = hash_djb2_one_32(span.end, h);
+		h = hash_djb2_one_32(span.font_size, h);
+		h = hash_djb2_one_32(span.language.hash(), h);
+		for (int j = 0; j < span.fonts.size(); j++) {
+			h = hash_djb2_one_32(hash_one_uint64(span.fonts[j].get_id()), h);
+		}
+		if (!span.features.is_empty()) {
+			h = hash_djb2_one_32(span.features.hash(), h);
+		}
+	}
+	r_key.hash_value = h;
+}
+
+void TextServerAdvanced::shaped_text_cache_set_capacity(int p_capacity) {
+	_THREAD_SAFE_METHOD_
+	ERR_FAIL_COND(p_capacity < 0);
+	if (p_capacity == 0) {
+		shaping_cache.clear();
+	} else {
+		shaping_cache.set_capacity(p_capacity);
+	}
+	shaping_cache_capacity = p_capacity;
+}
+
+int TextServerAdvanced::shaped_text_cache_get_capacity() const {
+	return shaping_cache_capacity;
+}
+
+void TextServerAdvanced::shaped_text_cache_clear() {
+	_THREAD_SAFE_METHOD_
+	shaping_cache.clear();
+	shaping_cache_hits = 0;
+	shaping_cache_misses = 0;
+}
+
+Dictionary TextServerAdvanced::shaped_text_cache_get_stats() const {
+	_THREAD_SAFE_METHOD_
+	Dictionary stats;
+	stats["size"] = (int64_t)shaping_cache.get_size();
+	stats["capacity"] = shaping_cache_capacity;
+	stats["hits"] = shaping_cache_hits;
+	stats["misses"] = shaping_cache_misses;
+	return stats;
+}
+
 /*************************************************************************/
 /* Shaped text buffer interface                                          */
 /*************************************************************************/
@@ -2209,6 +2336,20 @@ bool TextServerAdvanced::shaped_text_shape(RID p_shaped) {
 		return true;
 	}
 
+	// Embedded object rects depend on the buffer, only plain text is shared through the cache.
+	ShapingCacheKey cache_key;
+	const ShapingCacheEntry *cached = nullptr;
+	bool cacheable = (shaping_cache_capacity > 0) && sd->objects.is_empty();
+	if (cacheable) {
+		_shaping_cache_make_key(sd, cache_key);
+		cached = shaping_cache.getptr(cache_key);
+		if (cached) {
+			shaping_cache_hits++;
+		} else {
+			shaping_cache_misses++;
+		}
+	}
+
 	sd->utf16 = sd->text.utf16();
 	const UChar *data = sd->utf16.ptr();
 
@@ -2255,6 +2396,11 @@ bool TextServerAdvanced::shaped_text_shape(RID p_shaped) {
 		ERR_FAIL_COND_V_MSG(U_FAILURE(err), false, u_errorName(err));
 		sd->bidi_iter.push_back(bidi_iter);
 
+		if (cached) {
+			// Glyphs come from the cache, BiDi iterators are still required for line breaking and substrings.
+			continue;
+		}
+
 		err = U_ZERO_ERROR;
 		int bidi_run_count = ubidi_countRuns(bidi_iter, &err);
 		ERR_FAIL_COND_V_MSG(U_FAILURE(err), false, u_errorName(err));
@@ -2378,6 +2524,18 @@ bool TextServerAdvanced::shaped_text_shape(RID p_shaped) {
 		}
 	}
 
+	if (cached) {
+		sd->para_direction = cached->para_direction;
+		sd->ascent = cached->ascent;
+		sd->descent = cached->descent;
+		sd->width = cached->width;
+		sd->upos = cached->upos;
+		sd->uthk = cached->uthk;
+		sd->glyphs = cached->glyphs;
+		sd->valid = true;
+		return true;
+	}
+
 	// Align embedded objects to baseline.
 	for (Map<Variant, ShapedTextData::EmbeddedObject>::Element *E = sd->objects.front(); E; E = E->next()) {
 		if (sd->orientation == ORIENTATION_HORIZONTAL) {
@@ -2407,6 +2565,18 @@ bool TextServerAdvanced::shaped_text_shape(RID p_shaped) {
 		}
 	}
 
+	if (cacheable) {
+		ShapingCacheEntry entry;
+		entry.para_direction = sd->para_direction;
+		entry.ascent = sd->ascent;
+		entry.descent = sd->descent;
+		entry.width = sd->width;
+		entry.upos = sd->upos;
+		entry.uthk = sd->uthk;
+		entry.glyphs = sd->glyphs;
+		shaping_cache.insert(cache_key, entry);
+	}
+
 	sd->valid = true;
 	return sd->valid;
 }
@@ -2643,9 +2813,13 @@ void TextServerAdvanced::register_server() {
 
 TextServerAdvanced::TextServerAdvanced() {
 	hb_bmp_create_font_funcs();
+	shaping_cache.set_capacity(shaping_cache_capacity);
 }
 
 TextServerAdvanced::~TextServerAdvanced() {
+#ifdef MODULE_FREETYPE_ENABLED
+	DynamicFontDataAdvanced::finish_sdf_work_pool();
+#endif
 	hb_bmp_free_font_funcs();
 	u_cleanup();
 #ifndef ICU_STATIC_DATA
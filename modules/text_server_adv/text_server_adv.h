@@ -38,6 +38,7 @@
 
 #include "servers/text_server.h"
 
+#include "core/templates/lru.h"
 #include "core/templates/rid_owner.h"
 #include "scene/resources/texture.h"
 #include "script_iterator.h"
@@ -88,6 +89,51 @@ class TextServerAdvanced : public TextServer {
 		}
 	};
 
+	/* Shaping cache */
+
+	// Shaping results are content-addressed, identical strings in different buffers share one HarfBuzz pass.
+	struct ShapingCacheKey {
+		struct Span {
+			int start = -1;
+			int end = -1;
+			Vector<RID> fonts;
+			int font_size = 0;
+			String language;
+			Dictionary features;
+		};
+
+		String text;
+		TextServer::Direction direction = DIRECTION_AUTO;
+		TextServer::Orientation orientation = ORIENTATION_HORIZONTAL;
+		bool preserve_invalid = true;
+		bool preserve_control = false;
+		Vector<Vector2i> bidi_override;
+		Vector<Span> spans;
+
+		uint32_t hash_value = 0;
+
+		bool operator==(const ShapingCacheKey &p_key) const;
+
+		static _FORCE_INLINE_ uint32_t hash(const ShapingCacheKey &p_key) { return p_key.hash_value; }
+	};
+
+	struct ShapingCacheEntry {
+		TextServer::Direction para_direction = DIRECTION_LTR;
+		float ascent = 0.f;
+		float descent = 0.f;
+		float width = 0.f;
+		float upos = 0.f;
+		float uthk = 0.f;
+		Vector<TextServer::Glyph> glyphs;
+	};
+
+	LRUCache<ShapingCacheKey, ShapingCacheEntry, ShapingCacheKey> shaping_cache;
+	int shaping_cache_capacity = 4096;
+	uint64_t shaping_cache_hits = 0;
+	uint64_t shaping_cache_misses = 0;
+
+	void _shaping_cache_make_key(const ShapedTextDataAdvanced *p_sd, ShapingCacheKey &r_key) const;
+
 	float oversampling = 1.f;
 	mutable RID_PtrOwner<FontDataAdvanced> font_owner;
 	mutable RID_PtrOwner<ShapedTextDataAdvanced> shaped_owner;
@@ -188,6 +234,8 @@ public:
 	virtual Vector2 font_draw_glyph(RID p_font, RID p_canvas, int p_size, const Vector2 &p_pos, uint32_t p_index, const Color &p_color = Color(1, 1, 1)) const override;
 	virtual Vector2 font_draw_glyph_outline(RID p_font, RID p_canvas, int p_size, int p_outline_size, const Vector2 &p_pos, uint32_t p_index, const Color &p_color = Color(1, 1, 1)) const override;
 
+	virtual uint64_t font_get_glyph_cache_memory(RID p_font) const override;
+
 	virtual bool font_get_glyph_contours(RID p_font, int p_size, uint32_t p_index, Vector<Vector3> &r_points, Vector<int32_t> &r_contours, bool &r_orientation) const override;
 
 	virtual float font_get_oversampling() const override;
@@ -195,6 +243,11 @@ public:
 
 	virtual Vector<String> get_system_fonts() const override;
 
+	virtual void shaped_text_cache_set_capacity(int p_capacity) override;
+	virtual int shaped_text_cache_get_capacity() const override;
+	virtual void shaped_text_cache_clear() override;
+	virtual Dictionary shaped_text_cache_get_stats() const override;
+
 	/* Shaped text buffer interface */
 
 	virtual RID create_shaped_text(Direction p_direction = DIRECTION_AUTO, Orientation p_orientation = ORIENTATION_HORIZONTAL) override;
@@ -34,6 +34,9 @@
 #include "core/config/project_settings.h"
 #include "core/os/os.h"
 
+// Reactor id of the listening socket, peer ids are never 0.
+#define WSL_SERVER_LISTEN_ID 0
+
 bool WSLServer::PendingPeer::_parse_request(const Vector<String> p_protocols) {
 	Vector<String> psa = String((char *)req_buf).split("\r\n");
 	int len = psa.size();
@@ -167,14 +170,44 @@ Error WSLServer::listen(int p_port, const Vector<String> p_protocols, bool gd_mp
 	for (int i = 0; i < p_protocols.size(); i++) {
 		pw[i] = p_protocols[i].strip_edges();
 	}
-	return _server->listen(p_port, bind_ip);
+	Error err = _server->listen(p_port, bind_ip);
+	if (err == OK && _reactor.is_valid() && _server->add_to_reactor(_reactor, WSL_SERVER_LISTEN_ID) != OK) {
+		_reactor.unref(); // Fall back to polling every peer.
+	}
+	return err;
 }
 
 void WSLServer::poll() {
+	bool accept = true;
+	if (_reactor.is_valid()) {
+		_ready.clear();
+		_reactor->wait(0, _ready);
+		accept = false;
+		for (uint32_t i = 0; i < _ready.size(); i++) {
+			if (_ready[i] == WSL_SERVER_LISTEN_ID) {
+				accept = true;
+				continue;
+			}
+			Map<int, Ref<WebSocketPeer>>::Element *E = _peer_map.find((int)_ready[i]);
+			if (E) {
+				static_cast<WSLPeer *>(E->get().ptr())->poll();
+			}
+		}
+		for (Set<int>::Element *E = _polled_peers.front(); E; E = E->next()) {
+			Map<int, Ref<WebSocketPeer>>::Element *F = _peer_map.find(E->get());
+			if (F) {
+				static_cast<WSLPeer *>(F->get().ptr())->poll();
+			}
+		}
+	}
+
 	List<int> remove_ids;
 	for (Map<int, Ref<WebSocketPeer>>::Element *E = _peer_map.front(); E; E = E->next()) {
-		Ref<WSLPeer> peer = (WSLPeer *)E->get().ptr();
-		peer->poll();
+		WSLPeer *peer = static_cast<WSLPeer *>(E->get().ptr());
+		if (_reactor.is_null()) {
+			peer->poll();
+		}
+		// Doesn't touch the socket, so it's cheap for idle peers.
 		if (!peer->is_connected_to_host()) {
 			_on_disconnect(E->key(), peer->close_code != -1);
 			remove_ids.push_back(E->key());
@@ -182,6 +215,7 @@ void WSLServer::poll() {
 	}
 	for (List<int>::Element *E = remove_ids.front(); E; E = E->next()) {
 		_peer_map.erase(E->get());
+		_polled_peers.erase(E->get());
 	}
 	remove_ids.clear();
 
@@ -210,6 +244,9 @@ void WSLServer::poll() {
 		ws_peer->set_no_delay(true);
 
 		_peer_map[id] = ws_peer;
+		if (_reactor.is_valid() && (ppeer->use_ssl || ppeer->tcp->add_to_reactor(_reactor, id) != OK)) {
+			_polled_peers.insert(id);
+		}
 		remove_peers.push_back(ppeer);
 		_on_connect(id, ppeer->protocol);
 	}
@@ -218,7 +255,7 @@ void WSLServer::poll() {
 	}
 	remove_peers.clear();
 
-	if (!_server->is_listening()) {
+	if (!_server->is_listening() || !accept) {
 		return;
 	}
 
@@ -260,6 +297,7 @@ void WSLServer::stop() {
 	}
 	_pending.clear();
 	_peer_map.clear();
+	_polled_peers.clear();
 	_protocols.clear();
 }
 
@@ -302,6 +340,7 @@ Error WSLServer::set_buffers(int p_in_buffer, int p_in_packets, int p_out_buffer
 
 WSLServer::WSLServer() {
 	_server.instance();
+	_reactor = Ref<NetSocketReactor>(NetSocketReactor::create());
 }
 
 WSLServer::~WSLServer() {
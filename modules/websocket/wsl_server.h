@@ -76,6 +76,12 @@ private:
 	Ref<TCPServer> _server;
 	Vector<String> _protocols;
 
+	// When the platform has a reactor, only the peers with ready sockets are
+	// polled, except SSL ones which may buffer data and are always polled.
+	Ref<NetSocketReactor> _reactor;
+	LocalVector<uint64_t> _ready;
+	Set<int> _polled_peers;
+
 public:
 	Error set_buffers(int p_in_buffer, int p_in_packets, int p_out_buffer, int p_out_packets);
 	Error listen(int p_port, const Vector<String> p_protocols = Vector<String>(), bool gd_mp_api = false);
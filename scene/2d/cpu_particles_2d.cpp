@@ -610,8 +610,14 @@ void CPUParticles2D::_particles_process(float p_delta) {
 
 	float system_phase = time / lifetime;
 
+	particle_steps.resize(pcount);
+	particle_deltas.resize(pcount);
+	uint8_t *steps = particle_steps.ptr();
+	float *deltas = particle_deltas.ptr();
+
 	for (int i = 0; i < pcount; i++) {
 		Particle &p = parray[i];
+		steps[i] = PARTICLE_STEP_SKIP;
 
 		if (!emitting && !p.active) {
 			continue;
@@ -676,6 +682,7 @@ void CPUParticles2D::_particles_process(float p_delta) {
 				continue;
 			}
 			p.active = true;
+			steps[i] = PARTICLE_STEP_RESTARTED;
 
 			/*real_t tex_linear_velocity = 0;
 			if (curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY].is_valid()) {
@@ -764,8 +771,53 @@ void CPUParticles2D::_particles_process(float p_delta) {
 			continue;
 		} else if (p.time > p.lifetime) {
 			p.active = false;
-			tv = 1.0;
+			steps[i] = PARTICLE_STEP_EXPIRED;
 		} else {
+			steps[i] = PARTICLE_STEP_ADVANCE;
+		}
+
+		deltas[i] = local_delta;
+	}
+
+	ProcessStep step;
+	step.particles = parray;
+	step.count = pcount;
+	step.emission_xform = emission_xform;
+	for (int i = 0; i < PARAM_MAX; i++) {
+		step.curves[i] = curve_parameters[i].ptr();
+	}
+	if (color_ramp.is_valid()) {
+		// Sorts the ramp points now, so workers only read them.
+		color_ramp->get_color_at_offset(0.0);
+		step.color_ramp = color_ramp.ptr();
+	}
+
+	ThreadWorkPool *pool = _get_work_pool(pcount);
+	if (pool) {
+		pool->do_work((pcount + PROCESS_CHUNK_SIZE - 1) / PROCESS_CHUNK_SIZE, this, &CPUParticles2D::_particles_process_chunk, &step);
+	} else {
+		_particles_process_range(0, pcount, step);
+	}
+}
+
+void CPUParticles2D::_particles_process_range(uint32_t p_from, uint32_t p_to, const ProcessStep &p_step) {
+	const uint8_t *steps = particle_steps.ptr();
+	const float *deltas = particle_deltas.ptr();
+	const Curve *const *curves = p_step.curves;
+	Gradient *ramp = p_step.color_ramp;
+
+	for (uint32_t i = p_from; i < p_to; i++) {
+		if (steps[i] == PARTICLE_STEP_SKIP) {
+			continue;
+		}
+
+		Particle &p = p_step.particles[i];
+		float local_delta = deltas[i];
+		real_t tv = 0.0;
+
+		if (steps[i] == PARTICLE_STEP_EXPIRED) {
+			tv = 1.0;
+		} else if (steps[i] == PARTICLE_STEP_ADVANCE) {
 			uint32_t alt_seed = p.seed;
 
 			p.time += local_delta;
@@ -773,52 +825,52 @@ void CPUParticles2D::_particles_process(float p_delta) {
 			tv = p.time / p.lifetime;
 
 			real_t tex_linear_velocity = 0.0;
-			if (curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY].is_valid()) {
-				tex_linear_velocity = curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY]->interpolate(tv);
+			if (curves[PARAM_INITIAL_LINEAR_VELOCITY]) {
+				tex_linear_velocity = curves[PARAM_INITIAL_LINEAR_VELOCITY]->interpolate(tv);
 			}
 
 			real_t tex_orbit_velocity = 0.0;
-			if (curve_parameters[PARAM_ORBIT_VELOCITY].is_valid()) {
-				tex_orbit_velocity = curve_parameters[PARAM_ORBIT_VELOCITY]->interpolate(tv);
+			if (curves[PARAM_ORBIT_VELOCITY]) {
+				tex_orbit_velocity = curves[PARAM_ORBIT_VELOCITY]->interpolate(tv);
 			}
 
 			real_t tex_angular_velocity = 0.0;
-			if (curve_parameters[PARAM_ANGULAR_VELOCITY].is_valid()) {
-				tex_angular_velocity = curve_parameters[PARAM_ANGULAR_VELOCITY]->interpolate(tv);
+			if (curves[PARAM_ANGULAR_VELOCITY]) {
+				tex_angular_velocity = curves[PARAM_ANGULAR_VELOCITY]->interpolate(tv);
 			}
 
 			real_t tex_linear_accel = 0.0;
-			if (curve_parameters[PARAM_LINEAR_ACCEL].is_valid()) {
-				tex_linear_accel = curve_parameters[PARAM_LINEAR_ACCEL]->interpolate(tv);
+			if (curves[PARAM_LINEAR_ACCEL]) {
+				tex_linear_accel = curves[PARAM_LINEAR_ACCEL]->interpolate(tv);
 			}
 
 			real_t tex_tangential_accel = 0.0;
-			if (curve_parameters[PARAM_TANGENTIAL_ACCEL].is_valid()) {
-				tex_tangential_accel = curve_parameters[PARAM_TANGENTIAL_ACCEL]->interpolate(tv);
+			if (curves[PARAM_TANGENTIAL_ACCEL]) {
+				tex_tangential_accel = curves[PARAM_TANGENTIAL_ACCEL]->interpolate(tv);
 			}
 
 			real_t tex_radial_accel = 0.0;
-			if (curve_parameters[PARAM_RADIAL_ACCEL].is_valid()) {
-				tex_radial_accel = curve_parameters[PARAM_RADIAL_ACCEL]->interpolate(tv);
+			if (curves[PARAM_RADIAL_ACCEL]) {
+				tex_radial_accel = curves[PARAM_RADIAL_ACCEL]->interpolate(tv);
 			}
 
 			real_t tex_damping = 0.0;
-			if (curve_parameters[PARAM_DAMPING].is_valid()) {
-				tex_damping = curve_parameters[PARAM_DAMPING]->interpolate(tv);
+			if (curves[PARAM_DAMPING]) {
+				tex_damping = curves[PARAM_DAMPING]->interpolate(tv);
 			}
 
 			real_t tex_angle = 0.0;
-			if (curve_parameters[PARAM_ANGLE].is_valid()) {
-				tex_angle = curve_parameters[PARAM_ANGLE]->interpolate(tv);
+			if (curves[PARAM_ANGLE]) {
+				tex_angle = curves[PARAM_ANGLE]->interpolate(tv);
 			}
 			real_t tex_anim_speed = 0.0;
-			if (curve_parameters[PARAM_ANIM_SPEED].is_valid()) {
-				tex_anim_speed = curve_parameters[PARAM_ANIM_SPEED]->interpolate(tv);
+			if (curves[PARAM_ANIM_SPEED]) {
+				tex_anim_speed = curves[PARAM_ANIM_SPEED]->interpolate(tv);
 			}
 
 			real_t tex_anim_offset = 0.0;
-			if (curve_parameters[PARAM_ANIM_OFFSET].is_valid()) {
-				tex_anim_offset = curve_parameters[PARAM_ANIM_OFFSET]->interpolate(tv);
+			if (curves[PARAM_ANIM_OFFSET]) {
+				tex_anim_offset = curves[PARAM_ANIM_OFFSET]->interpolate(tv);
 			}
 
 			Vector2 force = gravity;
@@ -827,7 +879,7 @@ void CPUParticles2D::_particles_process(float p_delta) {
 			//apply linear acceleration
 			force += p.velocity.length() > 0.0 ? p.velocity.normalized() * (parameters[PARAM_LINEAR_ACCEL] + tex_linear_accel) * Math::lerp((real_t)1.0, rand_from_seed(alt_seed), randomness[PARAM_LINEAR_ACCEL]) : Vector2();
 			//apply radial acceleration
-			Vector2 org = emission_xform[2];
+			Vector2 org = p_step.emission_xform[2];
 			Vector2 diff = pos - org;
 			force += diff.length() > 0.0 ? diff.normalized() * (parameters[PARAM_RADIAL_ACCEL] + tex_radial_accel) * Math::lerp((real_t)1.0, rand_from_seed(alt_seed), randomness[PARAM_RADIAL_ACCEL]) : Vector2();
 			//apply tangential acceleration;
@@ -845,7 +897,7 @@ void CPUParticles2D::_particles_process(float p_delta) {
 				p.transform[2] -= diff;
 				p.transform[2] += rot.basis_xform(diff);
 			}
-			if (curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY].is_valid()) {
+			if (curves[PARAM_INITIAL_LINEAR_VELOCITY]) {
 				p.velocity = p.velocity.normalized() * tex_linear_velocity;
 			}
 
@@ -869,13 +921,13 @@ void CPUParticles2D::_particles_process(float p_delta) {
 		//apply hue rotation
 
 		real_t tex_scale = 1.0;
-		if (curve_parameters[PARAM_SCALE].is_valid()) {
-			tex_scale = curve_parameters[PARAM_SCALE]->interpolate(tv);
+		if (curves[PARAM_SCALE]) {
+			tex_scale = curves[PARAM_SCALE]->interpolate(tv);
 		}
 
 		real_t tex_hue_variation = 0.0;
-		if (curve_parameters[PARAM_HUE_VARIATION].is_valid()) {
-			tex_hue_variation = curve_parameters[PARAM_HUE_VARIATION]->interpolate(tv);
+		if (curves[PARAM_HUE_VARIATION]) {
+			tex_hue_variation = curves[PARAM_HUE_VARIATION]->interpolate(tv);
 		}
 
 		real_t hue_rot_angle = (parameters[PARAM_HUE_VARIATION] + tex_hue_variation) * Math_TAU * Math::lerp(1.0f, p.hue_rot_rand * 2.0f - 1.0f, randomness[PARAM_HUE_VARIATION]);
@@ -884,17 +936,17 @@ void CPUParticles2D::_particles_process(float p_delta) {
 
 		Basis hue_rot_mat;
 		{
-			Basis mat1(0.299, 0.587, 0.114, 0.299, 0.587, 0.114, 0.299, 0.587, 0.114);
-			Basis mat2(0.701, -0.587, -0.114, -0.299, 0.413, -0.114, -0.300, -0.588, 0.886);
-			Basis mat3(0.168, 0.330, -0.497, -0.328, 0.035, 0.292, 1.250, -1.050, -0.203);
+			static const Basis mat1(0.299, 0.587, 0.114, 0.299, 0.587, 0.114, 0.299, 0.587, 0.114);
+			static const Basis mat2(0.701, -0.587, -0.114, -0.299, 0.413, -0.114, -0.300, -0.588, 0.886);
+			static const Basis mat3(0.168, 0.330, -0.497, -0.328, 0.035, 0.292, 1.250, -1.050, -0.203);
 
 			for (int j = 0; j < 3; j++) {
 				hue_rot_mat[j] = mat1[j] + mat2[j] * hue_rot_c + mat3[j] * hue_rot_s;
 			}
 		}
 
-		if (color_ramp.is_valid()) {
-			p.color = color_ramp->get_color_at_offset(tv) * color;
+		if (ramp) {
+			p.color = ramp->get_color_at_offset(tv) * color;
 		} else {
 			p.color = color;
 		}
@@ -930,6 +982,18 @@ void CPUParticles2D::_particles_process(float p_delta) {
 	}
 }
 
+void CPUParticles2D::_particles_process_chunk(uint32_t p_chunk, ProcessStep *p_step) {
+	uint32_t from = p_chunk * PROCESS_CHUNK_SIZE;
+	_particles_process_range(from, MIN(from + PROCESS_CHUNK_SIZE, p_step->count), *p_step);
+}
+
+ThreadWorkPool *CPUParticles2D::_get_work_pool(int p_particle_count) {
+	if (!is_inside_tree()) {
+		return nullptr;
+	}
+	return get_tree()->get_cpu_particles_work_pool(p_particle_count);
+}
+
 void CPUParticles2D::_update_particle_data_buffer() {
 	MutexLock lock(update_mutex);
 
@@ -940,7 +1004,6 @@ void CPUParticles2D::_update_particle_data_buffer() {
 
 	float *w = particle_data.ptrw();
 	const Particle *r = particles.ptr();
-	float *ptr = w;
 
 	if (draw_order != DRAW_ORDER_INDEX) {
 		ow = particle_order.ptrw();
@@ -956,8 +1019,26 @@ void CPUParticles2D::_update_particle_data_buffer() {
 		}
 	}
 
-	for (int i = 0; i < pc; i++) {
-		int idx = order ? order[i] : i;
+	BufferStep step;
+	step.particles = r;
+	step.order = order;
+	step.data = w;
+	step.count = pc;
+
+	ThreadWorkPool *pool = _get_work_pool(pc);
+	if (pool) {
+		pool->do_work((pc + PROCESS_CHUNK_SIZE - 1) / PROCESS_CHUNK_SIZE, this, &CPUParticles2D::_update_particle_data_chunk, &step);
+	} else {
+		_update_particle_data_range(0, pc, step);
+	}
+}
+
+void CPUParticles2D::_update_particle_data_range(uint32_t p_from, uint32_t p_to, const BufferStep &p_step) {
+	const Particle *r = p_step.particles;
+	float *ptr = p_step.data + p_from * 16;
+
+	for (uint32_t i = p_from; i < p_to; i++) {
+		int idx = p_step.order ? p_step.order[i] : i;
 
 		Transform2D t = r[idx].transform;
 
@@ -995,6 +1076,11 @@ void CPUParticles2D::_update_particle_data_buffer() {
 	}
 }
 
+void CPUParticles2D::_update_particle_data_chunk(uint32_t p_chunk, BufferStep *p_step) {
+	uint32_t from = p_chunk * PROCESS_CHUNK_SIZE;
+	_update_particle_data_range(from, MIN(from + PROCESS_CHUNK_SIZE, p_step->count), *p_step);
+}
+
 void CPUParticles2D::_set_redraw(bool p_redraw) {
 	if (redraw == p_redraw) {
 		return;
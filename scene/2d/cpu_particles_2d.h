@@ -31,7 +31,9 @@
 #ifndef CPU_PARTICLES_2D_H
 #define CPU_PARTICLES_2D_H
 
+#include "core/templates/local_vector.h"
 #include "core/templates/rid.h"
+#include "core/templates/thread_work_pool.h"
 #include "scene/2d/node_2d.h"
 #include "scene/resources/texture.h"
 
@@ -111,6 +113,37 @@ private:
 	Vector<float> particle_data;
 	Vector<int> particle_order;
 
+	// See CPUParticles3D, emission runs serially and the simulation and
+	// instance buffer writes run over chunks of particles.
+	enum {
+		PROCESS_CHUNK_SIZE = 256
+	};
+
+	enum ParticleStep : uint8_t {
+		PARTICLE_STEP_SKIP,
+		PARTICLE_STEP_RESTARTED,
+		PARTICLE_STEP_EXPIRED,
+		PARTICLE_STEP_ADVANCE,
+	};
+
+	LocalVector<uint8_t> particle_steps;
+	LocalVector<float> particle_deltas;
+
+	struct ProcessStep {
+		Particle *particles = nullptr;
+		uint32_t count = 0;
+		Transform2D emission_xform;
+		const Curve *curves[PARAM_MAX] = {};
+		Gradient *color_ramp = nullptr;
+	};
+
+	struct BufferStep {
+		const Particle *particles = nullptr;
+		const int *order = nullptr;
+		float *data = nullptr;
+		uint32_t count = 0;
+	};
+
 	struct SortLifetime {
 		const Particle *particles = nullptr;
 
@@ -173,7 +206,12 @@ private:
 
 	void _update_internal();
 	void _particles_process(float p_delta);
+	void _particles_process_range(uint32_t p_from, uint32_t p_to, const ProcessStep &p_step);
+	void _particles_process_chunk(uint32_t p_chunk, ProcessStep *p_step);
 	void _update_particle_data_buffer();
+	void _update_particle_data_range(uint32_t p_from, uint32_t p_to, const BufferStep &p_step);
+	void _update_particle_data_chunk(uint32_t p_chunk, BufferStep *p_step);
+	ThreadWorkPool *_get_work_pool(int p_particle_count);
 
 	Mutex update_mutex;
 
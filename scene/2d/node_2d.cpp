@@ -391,6 +391,27 @@ Point2 Node2D::to_global(Point2 p_local) const {
 	return get_global_transform().xform(p_local);
 }
 
+void Node2D::_physics_interpolated_changed() {
+	RenderingServer::get_singleton()->canvas_item_set_interpolated(get_canvas_item(), is_physics_interpolated_and_enabled());
+}
+
+void Node2D::_notification(int p_what) {
+	switch (p_what) {
+		case NOTIFICATION_ENTER_TREE: {
+			// Start interpolating from where the node entered, not from the last place it was in.
+			RenderingServer::get_singleton()->canvas_item_set_interpolated(get_canvas_item(), is_physics_interpolated_and_enabled());
+			RenderingServer::get_singleton()->canvas_item_set_transform(get_canvas_item(), _mat);
+			RenderingServer::get_singleton()->canvas_item_reset_physics_interpolation(get_canvas_item());
+		} break;
+		case NOTIFICATION_RESET_PHYSICS_INTERPOLATION: {
+			if (is_physics_interpolated_and_enabled()) {
+				RenderingServer::get_singleton()->canvas_item_set_transform(get_canvas_item(), _mat);
+				RenderingServer::get_singleton()->canvas_item_reset_physics_interpolation(get_canvas_item());
+			}
+		} break;
+	}
+}
+
 void Node2D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_position", "position"), &Node2D::set_position);
 	ClassDB::bind_method(D_METHOD("set_rotation", "radians"), &Node2D::set_rotation);
@@ -52,6 +52,9 @@ class Node2D : public CanvasItem {
 	void _update_xform_values();
 
 protected:
+	virtual void _physics_interpolated_changed() override;
+
+	void _notification(int p_what);
 	static void _bind_methods();
 
 public:
@@ -33,6 +33,128 @@
 #include "core/io/marshalls.h"
 #include "core/math/geometry_2d.h"
 #include "core/os/os.h"
+#include "core/templates/thread_work_pool.h"
+
+TileMapCell &TileMapCellStorage::insert(const Vector2i &p_coords, const TileMapCell &p_cell) {
+	Vector2i chunk_coords = _get_chunk_coords(p_coords);
+	Chunk *chunk = _get_chunk_cached(chunk_coords);
+	if (!chunk) {
+		chunk = memnew(Chunk);
+		chunks[chunk_coords] = chunk;
+		last_chunk_coords = chunk_coords;
+		last_chunk = chunk;
+	}
+
+	uint32_t &row_mask = chunk->used_mask[p_coords.y & CHUNK_MASK];
+	uint32_t bit = 1u << (p_coords.x & CHUNK_MASK);
+	if (!(row_mask & bit)) {
+		row_mask |= bit;
+		chunk->used++;
+		cell_count++;
+	}
+
+	TileMapCell &cell = chunk->cells[((p_coords.y & CHUNK_MASK) << CHUNK_SHIFT) | (p_coords.x & CHUNK_MASK)];
+	cell = p_cell;
+	return cell;
+}
+
+void TileMapCellStorage::erase(const Vector2i &p_coords) {
+	Vector2i chunk_coords = _get_chunk_coords(p_coords);
+	Chunk *chunk = _get_chunk_cached(chunk_coords);
+	if (!chunk) {
+		return;
+	}
+
+	uint32_t &row_mask = chunk->used_mask[p_coords.y & CHUNK_MASK];
+	uint32_t bit = 1u << (p_coords.x & CHUNK_MASK);
+	if (!(row_mask & bit)) {
+		return;
+	}
+	row_mask &= ~bit;
+	chunk->cells[((p_coords.y & CHUNK_MASK) << CHUNK_SHIFT) | (p_coords.x & CHUNK_MASK)] = TileMapCell();
+	cell_count--;
+
+	if (--chunk->used == 0) {
+		chunks.erase(chunk_coords);
+		memdelete(chunk);
+		last_chunk = nullptr;
+	}
+}
+
+void TileMapCellStorage::clear() {
+	const Vector2i *key = nullptr;
+	while ((key = chunks.next(key))) {
+		memdelete(chunks[*key]);
+	}
+	chunks.clear();
+	cell_count = 0;
+	last_chunk = nullptr;
+}
+
+void TileMapCellStorage::get_used_coords(LocalVector<Vector2i> &r_coords) const {
+	r_coords.clear();
+	r_coords.reserve(cell_count);
+
+	const Vector2i *key = nullptr;
+	while ((key = chunks.next(key))) {
+		const Chunk *chunk = chunks[*key];
+		Vector2i origin = *key * CHUNK_SIZE;
+		for (int y = 0; y < CHUNK_SIZE; y++) {
+			uint32_t row_mask = chunk->used_mask[y];
+			for (int x = 0; row_mask; x++, row_mask >>= 1) {
+				if (row_mask & 1) {
+					r_coords.push_back(origin + Vector2i(x, y));
+				}
+			}
+		}
+	}
+
+	r_coords.sort();
+}
+
+Rect2i TileMapCellStorage::get_used_rect() const {
+	if (cell_count == 0) {
+		return Rect2i();
+	}
+
+	Vector2i begin = Vector2i(INT32_MAX, INT32_MAX);
+	Vector2i end = Vector2i(INT32_MIN, INT32_MIN);
+
+	const Vector2i *key = nullptr;
+	while ((key = chunks.next(key))) {
+		const Chunk *chunk = chunks[*key];
+		Vector2i origin = *key * CHUNK_SIZE;
+
+		// Merge the rows, then the bounds of the chunk are the first and last used row and column.
+		uint32_t columns_mask = 0;
+		int first_row = -1;
+		int last_row = -1;
+		for (int y = 0; y < CHUNK_SIZE; y++) {
+			if (chunk->used_mask[y]) {
+				columns_mask |= chunk->used_mask[y];
+				first_row = first_row < 0 ? y : first_row;
+				last_row = y;
+			}
+		}
+		int first_column = 0;
+		while (!(columns_mask & (1u << first_column))) {
+			first_column++;
+		}
+		int last_column = CHUNK_SIZE - 1;
+		while (!(columns_mask & (1u << last_column))) {
+			last_column--;
+		}
+
+		begin = begin.min(origin + Vector2i(first_column, first_row));
+		end = end.max(origin + Vector2i(last_column + 1, last_row + 1));
+	}
+
+	return Rect2i(begin, end - begin);
+}
+
+TileMapCellStorage::~TileMapCellStorage() {
+	clear();
+}
 
 void TileMapPattern::set_cell(const Vector2i &p_coords, int p_source_id, const Vector2i p_atlas_coords, int p_alternative_tile) {
 	ERR_FAIL_COND_MSG(p_coords.x < 0 || p_coords.y < 0, vformat("Cannot set cell with negative coords in a TileMapPattern. Wrong coords: %s", p_coords));
@@ -347,6 +469,83 @@ void TileMap::_fix_cell_transform(Transform2D &xform, const TileMapCell &p_cell,
 	xform.elements[2] += offset;
 }
 
+// Below this amount of dirty cells, the quadrants are prepared on the calling thread.
+#define TILE_MAP_THREADING_MIN_CELLS 4096
+
+static ThreadWorkPool *tile_map_work_pool = nullptr;
+static BinaryMutex tile_map_work_pool_mutex;
+
+void TileMap::finish_work_pool() {
+	MutexLock lock(tile_map_work_pool_mutex);
+	if (tile_map_work_pool) {
+		tile_map_work_pool->finish();
+		memdelete(tile_map_work_pool);
+		tile_map_work_pool = nullptr;
+	}
+}
+
+void TileMap::_prepare_quadrant(uint32_t p_index, QuadrantPreparation *p_preparation) {
+	TileMapQuadrant *q = p_preparation->quadrants[p_index];
+
+	// Update the coords cache.
+	q->map_to_world.clear();
+	q->world_to_map.clear();
+	for (Set<Vector2i>::Element *E = q->cells.front(); E; E = E->next()) {
+		Vector2i pk = E->get();
+		Vector2i pk_world_coords = map_to_world(pk);
+		q->map_to_world[pk] = pk_world_coords;
+		q->world_to_map[pk_world_coords] = pk;
+	}
+
+	for (int i = 0; i < p_preparation->plugin_count; i++) {
+		p_preparation->plugins[i]->prepare_quadrant(this, q);
+	}
+}
+
+void TileMap::prepare_quadrants(TileMapQuadrant **p_quadrants, uint32_t p_count, bool p_allow_threads) {
+	ERR_FAIL_COND(!tile_set.is_valid());
+
+	Vector<TileSetPlugin *> plugins = tile_set->get_tile_set_atlas_plugins();
+	QuadrantPreparation preparation;
+	preparation.quadrants = p_quadrants;
+	preparation.plugins = plugins.ptr();
+	preparation.plugin_count = plugins.size();
+
+	// A quadrant listed twice would be prepared by two threads at once.
+	LocalVector<TileMapQuadrant *> sorted_quadrants;
+	sorted_quadrants.resize(p_count);
+	for (uint32_t i = 0; i < p_count; i++) {
+		sorted_quadrants[i] = p_quadrants[i];
+	}
+	sorted_quadrants.sort();
+	for (uint32_t i = 1; i < p_count; i++) {
+		ERR_FAIL_COND_MSG(sorted_quadrants[i] == sorted_quadrants[i - 1], "A quadrant can't be prepared twice at once.");
+	}
+
+	uint32_t cell_count = 0;
+	for (uint32_t i = 0; i < p_count; i++) {
+		cell_count += p_quadrants[i]->cells.size();
+	}
+
+#ifndef NO_THREADS
+	if (p_allow_threads && p_count > 1 && cell_count >= TILE_MAP_THREADING_MIN_CELLS && OS::get_singleton()->get_processor_count() > 1) {
+		// Quadrants only write to their own caches and prepared data, so they can be prepared in parallel.
+		if (tile_map_work_pool_mutex.try_lock() == OK) {
+			if (!tile_map_work_pool) {
+				tile_map_work_pool = memnew(ThreadWorkPool);
+				tile_map_work_pool->init();
+			}
+			tile_map_work_pool->do_work(p_count, this, &TileMap::_prepare_quadrant, &preparation);
+			tile_map_work_pool_mutex.unlock();
+			return;
+		}
+	}
+#endif
+	for (uint32_t i = 0; i < p_count; i++) {
+		_prepare_quadrant(i, &preparation);
+	}
+}
+
 void TileMap::update_dirty_quadrants() {
 	if (!pending_update) {
 		return;
@@ -356,19 +555,14 @@ void TileMap::update_dirty_quadrants() {
 		return;
 	}
 
-	// Update the coords cache.
+	// Build the rendering and physics data of all dirty quadrants, on worker threads if there are enough cells.
+	LocalVector<TileMapQuadrant *> dirty_quadrants;
 	for (SelfList<TileMapQuadrant> *q = dirty_quadrant_list.first(); q; q = q->next()) {
-		q->self()->map_to_world.clear();
-		q->self()->world_to_map.clear();
-		for (Set<Vector2i>::Element *E = q->self()->cells.front(); E; E = E->next()) {
-			Vector2i pk = E->get();
-			Vector2i pk_world_coords = map_to_world(pk);
-			q->self()->map_to_world[pk] = pk_world_coords;
-			q->self()->world_to_map[pk_world_coords] = pk;
-		}
+		dirty_quadrants.push_back(q->self());
 	}
+	prepare_quadrants(dirty_quadrants.ptr(), dirty_quadrants.size());
 
-	// Call the update_dirty_quadrant method on plugins.
+	// Then let the plugins commit it to the servers, on this thread.
 	for (int i = 0; i < tile_set->get_tile_set_atlas_plugins().size(); i++) {
 		tile_set->get_tile_set_atlas_plugins()[i]->update_dirty_quadrants(this, dirty_quadrant_list);
 	}
@@ -514,7 +708,7 @@ void TileMap::_make_quadrant_dirty(Map<Vector2i, TileMapQuadrant>::Element *Q, b
 void TileMap::set_cell(const Vector2i &p_coords, int p_source_id, const Vector2i p_atlas_coords, int p_alternative_tile) {
 	// Set the current cell tile (using integer position).
 	Vector2i pk(p_coords);
-	Map<Vector2i, TileMapCell>::Element *E = tile_map.find(pk);
+	TileMapCell *E = tile_map.getptr(pk);
 
 	int source_id = p_source_id;
 	Vector2i atlas_coords = p_atlas_coords;
@@ -532,15 +726,38 @@ void TileMap::set_cell(const Vector2i &p_coords, int p_source_id, const Vector2i
 		return; // Nothing to do, the tile is already empty.
 	}
 
+	if (source_id == -1) {
+		// Erase existing cell in the tile map.
+		tile_map.erase(pk);
+		used_size_cache_dirty = true;
+	} else {
+		if (!E) {
+			// Insert a new cell in the tile map.
+			E = &tile_map.insert(pk, TileMapCell());
+		} else if (E->source_id == source_id && E->get_atlas_coords() == atlas_coords && E->alternative_tile == alternative_tile) {
+			return; // Nothing changed.
+		}
+
+		TileMapCell &c = *E;
+
+		c.source_id = source_id;
+		c.set_atlas_coords(atlas_coords);
+		c.alternative_tile = alternative_tile;
+
+		used_size_cache_dirty = true;
+	}
+
+	// Quadrants only exist inside the tree, they are all recreated when entering it.
+	if (!is_inside_tree()) {
+		return;
+	}
+
 	// Get the quadrant
 	Vector2i qk = _coords_to_quadrant_coords(pk);
 
 	Map<Vector2i, TileMapQuadrant>::Element *Q = quadrant_map.find(qk);
 
 	if (source_id == -1) {
-		// Erase existing cell in the tile map.
-		tile_map.erase(pk);
-
 		// Erase existing cell in the quadrant.
 		ERR_FAIL_COND(!Q);
 		TileMapQuadrant &q = Q->get();
@@ -553,70 +770,48 @@ void TileMap::set_cell(const Vector2i &p_coords, int p_source_id, const Vector2i
 		} else {
 			_make_quadrant_dirty(Q);
 		}
-
-		used_size_cache_dirty = true;
 	} else {
-		if (!E) {
-			// Insert a new cell in the tile map.
-			E = tile_map.insert(pk, TileMapCell());
-
-			// Create a new quadrant if needed, then insert the cell if needed.
-			if (!Q) {
-				Q = _create_quadrant(qk);
-			}
-			TileMapQuadrant &q = Q->get();
-			q.cells.insert(pk);
-
-		} else {
-			ERR_FAIL_COND(!Q); // TileMapQuadrant should exist...
-
-			if (E->get().source_id == source_id && E->get().get_atlas_coords() == atlas_coords && E->get().alternative_tile == alternative_tile) {
-				return; // Nothing changed.
-			}
+		// Create a new quadrant if needed, then insert the cell if needed.
+		if (!Q) {
+			Q = _create_quadrant(qk);
 		}
-
-		TileMapCell &c = E->get();
-
-		c.source_id = source_id;
-		c.set_atlas_coords(atlas_coords);
-		c.alternative_tile = alternative_tile;
+		Q->get().cells.insert(pk);
 
 		_make_quadrant_dirty(Q);
-		used_size_cache_dirty = true;
 	}
 }
 
 int TileMap::get_cell_source_id(const Vector2i &p_coords) const {
 	// Get a cell source id from position
-	const Map<Vector2i, TileMapCell>::Element *E = tile_map.find(p_coords);
+	const TileMapCell *E = tile_map.getptr(p_coords);
 
 	if (!E) {
 		return -1;
 	}
 
-	return E->get().source_id;
+	return E->source_id;
 }
 
 Vector2i TileMap::get_cell_atlas_coords(const Vector2i &p_coords) const {
 	// Get a cell source id from position
-	const Map<Vector2i, TileMapCell>::Element *E = tile_map.find(p_coords);
+	const TileMapCell *E = tile_map.getptr(p_coords);
 
 	if (!E) {
 		return TileSetAtlasSource::INVALID_ATLAS_COORDS;
 	}
 
-	return E->get().get_atlas_coords();
+	return E->get_atlas_coords();
 }
 
 int TileMap::get_cell_alternative_tile(const Vector2i &p_coords) const {
 	// Get a cell source id from position
-	const Map<Vector2i, TileMapCell>::Element *E = tile_map.find(p_coords);
+	const TileMapCell *E = tile_map.getptr(p_coords);
 
 	if (!E) {
 		return TileSetAtlasSource::INVALID_TILE_ALTERNATIVE;
 	}
 
-	return E->get().alternative_tile;
+	return E->alternative_tile;
 }
 
 TileMapPattern *TileMap::get_pattern(TypedArray<Vector2i> p_coords_array) {
@@ -705,10 +900,11 @@ void TileMap::set_pattern(Vector2i p_position, const TileMapPattern *p_pattern)
 }
 
 TileMapCell TileMap::get_cell(const Vector2i &p_coords) const {
-	if (!tile_map.has(p_coords)) {
+	const TileMapCell *E = tile_map.getptr(p_coords);
+	if (!E) {
 		return TileMapCell();
 	} else {
-		return tile_map.find(p_coords)->get();
+		return *E;
 	}
 }
 
@@ -718,10 +914,13 @@ Map<Vector2i, TileMapQuadrant> &TileMap::get_quadrant_map() {
 
 void TileMap::fix_invalid_tiles() {
 	ERR_FAIL_COND_MSG(tile_set.is_null(), "Cannot fix invalid tiles if Tileset is not open.");
-	for (Map<Vector2i, TileMapCell>::Element *E = tile_map.front(); E; E = E->next()) {
-		TileSetSource *source = *tile_set->get_source(E->get().source_id);
-		if (!source || !source->has_tile(E->get().get_atlas_coords()) || !source->has_alternative_tile(E->get().get_atlas_coords(), E->get().alternative_tile)) {
-			set_cell(E->key(), -1, TileSetAtlasSource::INVALID_ATLAS_COORDS, TileSetAtlasSource::INVALID_TILE_ALTERNATIVE);
+	LocalVector<Vector2i> coords;
+	tile_map.get_used_coords(coords);
+	for (uint32_t i = 0; i < coords.size(); i++) {
+		const TileMapCell &c = *tile_map.getptr(coords[i]);
+		TileSetSource *source = *tile_set->get_source(c.source_id);
+		if (!source || !source->has_tile(c.get_atlas_coords()) || !source->has_alternative_tile(c.get_atlas_coords(), c.alternative_tile)) {
+			set_cell(coords[i], -1, TileSetAtlasSource::INVALID_ATLAS_COORDS, TileSetAtlasSource::INVALID_TILE_ALTERNATIVE);
 		}
 	}
 }
@@ -730,8 +929,15 @@ void TileMap::_recreate_quadrants() {
 	// Clear then recreate all quadrants.
 	_clear_quadrants();
 
-	for (Map<Vector2i, TileMapCell>::Element *E = tile_map.front(); E; E = E->next()) {
-		Vector2i qk = _coords_to_quadrant_coords(Vector2i(E->key().x, E->key().y));
+	if (!is_inside_tree()) {
+		return;
+	}
+
+	LocalVector<Vector2i> coords;
+	tile_map.get_used_coords(coords);
+	for (uint32_t i = 0; i < coords.size(); i++) {
+		Vector2i pk = coords[i];
+		Vector2i qk = _coords_to_quadrant_coords(pk);
 
 		Map<Vector2i, TileMapQuadrant>::Element *Q = quadrant_map.find(qk);
 		if (!Q) {
@@ -739,7 +945,6 @@ void TileMap::_recreate_quadrants() {
 			dirty_quadrant_list.add(&Q->get().dirty_list_element);
 		}
 
-		Vector2i pk = E->key();
 		Q->get().cells.insert(pk);
 
 		_make_quadrant_dirty(Q, false);
@@ -840,15 +1045,19 @@ Vector<int> TileMap::_get_tile_data() const {
 
 	// Save in highest format
 
+	LocalVector<Vector2i> coords;
+	tile_map.get_used_coords(coords);
+
 	int idx = 0;
-	for (const Map<Vector2i, TileMapCell>::Element *E = tile_map.front(); E; E = E->next()) {
+	for (uint32_t i = 0; i < coords.size(); i++) {
+		const TileMapCell &c = *tile_map.getptr(coords[i]);
 		uint8_t *ptr = (uint8_t *)&w[idx];
-		encode_uint16((int16_t)(E->key().x), &ptr[0]);
-		encode_uint16((int16_t)(E->key().y), &ptr[2]);
-		encode_uint16(E->get().source_id, &ptr[4]);
-		encode_uint16(E->get().coord_x, &ptr[6]);
-		encode_uint16(E->get().coord_y, &ptr[8]);
-		encode_uint16(E->get().alternative_tile, &ptr[10]);
+		encode_uint16((int16_t)(coords[i].x), &ptr[0]);
+		encode_uint16((int16_t)(coords[i].y), &ptr[2]);
+		encode_uint16(c.source_id, &ptr[4]);
+		encode_uint16(c.coord_x, &ptr[6]);
+		encode_uint16(c.coord_y, &ptr[8]);
+		encode_uint16(c.alternative_tile, &ptr[10]);
 		idx += 3;
 	}
 
@@ -1524,12 +1733,13 @@ Vector2i TileMap::get_neighbor_cell(const Vector2i &p_coords, TileSet::CellNeigh
 
 TypedArray<Vector2i> TileMap::get_used_cells() const {
 	// Returns the cells used in the tilemap.
+	LocalVector<Vector2i> coords;
+	tile_map.get_used_coords(coords);
+
 	TypedArray<Vector2i> a;
-	a.resize(tile_map.size());
-	int i = 0;
-	for (Map<Vector2i, TileMapCell>::Element *E = tile_map.front(); E; E = E->next()) {
-		Vector2i p(E->key().x, E->key().y);
-		a[i++] = p;
+	a.resize(coords.size());
+	for (uint32_t i = 0; i < coords.size(); i++) {
+		a[i] = coords[i];
 	}
 
 	return a;
@@ -1538,17 +1748,7 @@ TypedArray<Vector2i> TileMap::get_used_cells() const {
 Rect2 TileMap::get_used_rect() { // Not const because of cache
 	// Return the rect of the currently used area
 	if (used_size_cache_dirty) {
-		if (tile_map.size() > 0) {
-			used_size_cache = Rect2(tile_map.front()->key().x, tile_map.front()->key().y, 0, 0);
-
-			for (Map<Vector2i, TileMapCell>::Element *E = tile_map.front(); E; E = E->next()) {
-				used_size_cache.expand_to(Vector2(E->key().x, E->key().y));
-			}
-
-			used_size_cache.size += Vector2(1, 1);
-		} else {
-			used_size_cache = Rect2();
-		}
+		used_size_cache = tile_map.get_used_rect();
 
 		used_size_cache_dirty = false;
 	}
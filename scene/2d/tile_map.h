@@ -31,6 +31,8 @@
 #ifndef TILE_MAP_H
 #define TILE_MAP_H
 
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
 #include "core/templates/self_list.h"
 #include "core/templates/vset.h"
 #include "scene/2d/node_2d.h"
@@ -84,6 +86,97 @@ union TileMapCell {
 	}
 };
 
+// Sparse storage for the cells of a TileMap. Cells are grouped in dense square chunks,
+// so lookups are a hash of the chunk coords plus an array index.
+class TileMapCellStorage {
+public:
+	enum {
+		CHUNK_SHIFT = 5,
+		CHUNK_SIZE = 1 << CHUNK_SHIFT,
+		CHUNK_MASK = CHUNK_SIZE - 1,
+	};
+
+private:
+	struct Chunk {
+		TileMapCell cells[CHUNK_SIZE * CHUNK_SIZE];
+		uint32_t used_mask[CHUNK_SIZE] = {}; // One bit per cell, one word per row.
+		int used = 0;
+	};
+
+	struct ChunkCoordsHasher {
+		static _FORCE_INLINE_ uint32_t hash(const Vector2i &p_coords) { return hash_djb2_one_32(uint32_t(p_coords.y), hash_djb2_one_32(uint32_t(p_coords.x))); }
+	};
+
+	HashMap<Vector2i, Chunk *, ChunkCoordsHasher> chunks;
+	int cell_count = 0;
+
+	// Edits usually come in runs over neighboring cells, so the last chunk is cached.
+	// Only the non-const accessors update the cache, so const lookups are safe to do
+	// from several threads as long as the storage isn't modified.
+	Vector2i last_chunk_coords;
+	Chunk *last_chunk = nullptr;
+
+	_FORCE_INLINE_ static Vector2i _get_chunk_coords(const Vector2i &p_coords) {
+		return Vector2i(p_coords.x >> CHUNK_SHIFT, p_coords.y >> CHUNK_SHIFT);
+	}
+
+	_FORCE_INLINE_ Chunk *_get_chunk(const Vector2i &p_chunk_coords) const {
+		if (last_chunk && last_chunk_coords == p_chunk_coords) {
+			return last_chunk;
+		}
+		Chunk *const *chunk = chunks.getptr(p_chunk_coords);
+		return chunk ? *chunk : nullptr;
+	}
+
+	_FORCE_INLINE_ Chunk *_get_chunk_cached(const Vector2i &p_chunk_coords) {
+		Chunk *chunk = _get_chunk(p_chunk_coords);
+		if (chunk) {
+			last_chunk_coords = p_chunk_coords;
+			last_chunk = chunk;
+		}
+		return chunk;
+	}
+
+	_FORCE_INLINE_ static TileMapCell *_get_cell_in_chunk(Chunk *p_chunk, const Vector2i &p_coords) {
+		if (!p_chunk || !(p_chunk->used_mask[p_coords.y & CHUNK_MASK] & (1u << (p_coords.x & CHUNK_MASK)))) {
+			return nullptr;
+		}
+		return &p_chunk->cells[((p_coords.y & CHUNK_MASK) << CHUNK_SHIFT) | (p_coords.x & CHUNK_MASK)];
+	}
+
+	TileMapCellStorage(const TileMapCellStorage &) = delete;
+	void operator=(const TileMapCellStorage &) = delete;
+
+public:
+	_FORCE_INLINE_ const TileMapCell *getptr(const Vector2i &p_coords) const {
+		return _get_cell_in_chunk(_get_chunk(_get_chunk_coords(p_coords)), p_coords);
+	}
+
+	_FORCE_INLINE_ TileMapCell *getptr(const Vector2i &p_coords) {
+		return _get_cell_in_chunk(_get_chunk_cached(_get_chunk_coords(p_coords)), p_coords);
+	}
+
+	_FORCE_INLINE_ bool has(const Vector2i &p_coords) const {
+		return getptr(p_coords) != nullptr;
+	}
+
+	_FORCE_INLINE_ int size() const {
+		return cell_count;
+	}
+
+	TileMapCell &insert(const Vector2i &p_coords, const TileMapCell &p_cell);
+	void erase(const Vector2i &p_coords);
+	void clear();
+
+	// Fills the coords of all cells, sorted like a Map<Vector2i> would iterate them.
+	void get_used_coords(LocalVector<Vector2i> &r_coords) const;
+	// Bounds of the used cells, computed from the chunk occupancy masks.
+	Rect2i get_used_rect() const;
+
+	TileMapCellStorage() {}
+	~TileMapCellStorage();
+};
+
 struct TileMapQuadrant {
 	struct CoordsWorldComparator {
 		_ALWAYS_INLINE_ bool operator()(const Vector2i &p_a, const Vector2i &p_b) const {
@@ -122,6 +215,43 @@ struct TileMapQuadrant {
 	// Navigation
 	Map<Vector2i, Vector<RID>> navigation_regions;
 
+	// Built by the plugins in TileSetPlugin::prepare_quadrant() without touching the servers,
+	// possibly on worker threads, then committed in TileSetPlugin::update_dirty_quadrants().
+	struct PreparedTile {
+		const Texture2D *texture = nullptr;
+		Rect2 dest_rect;
+		Rect2 source_rect;
+		Color modulate;
+		bool transpose = false;
+	};
+
+	struct PreparedCanvasItem {
+		const ShaderMaterial *material = nullptr;
+		int z_index = 0;
+		uint32_t tile_count = 0;
+	};
+
+	struct PreparedOccluder {
+		Vector2 position;
+		RID polygon;
+		int light_mask = 0;
+	};
+
+	struct PreparedShape {
+		int body_index = 0;
+		int shape_index = 0;
+		RID shape;
+		Vector2 position;
+		Vector2i coords;
+		bool one_way_collision = false;
+		float one_way_collision_margin = 0;
+	};
+
+	LocalVector<PreparedCanvasItem> prepared_canvas_items;
+	LocalVector<PreparedTile> prepared_tiles;
+	LocalVector<PreparedOccluder> prepared_occluders;
+	LocalVector<PreparedShape> prepared_shapes;
+
 	void operator=(const TileMapQuadrant &q) {
 		coords = q.coords;
 		debug_canvas_item = q.debug_canvas_item;
@@ -190,7 +320,7 @@ private:
 	Transform2D custom_transform;
 
 	// Map of cells
-	Map<Vector2i, TileMapCell> tile_map;
+	TileMapCellStorage tile_map;
 
 	Vector2i _coords_to_quadrant_coords(const Vector2i &p_coords) const;
 
@@ -217,6 +347,12 @@ private:
 	void _recompute_rect_cache();
 
 	void _update_all_items_material_state();
+	struct QuadrantPreparation {
+		TileMapQuadrant **quadrants = nullptr;
+		TileSetPlugin *const *plugins = nullptr;
+		int plugin_count = 0;
+	};
+	void _prepare_quadrant(uint32_t p_index, QuadrantPreparation *p_preparation);
 
 	void _set_tile_data(const Vector<int> &p_data);
 	Vector<int> _get_tile_data() const;
@@ -261,8 +397,11 @@ public:
 	TileMapCell get_cell(const Vector2i &p_coords) const;
 	Map<Vector2i, TileMapQuadrant> &get_quadrant_map();
 	int get_effective_quadrant_size() const;
+	// Runs the server independent part of the quadrant updates, on worker threads when there are enough cells.
+	void prepare_quadrants(TileMapQuadrant **p_quadrants, uint32_t p_count, bool p_allow_threads = true);
 
 	void update_dirty_quadrants();
+	static void finish_work_pool();
 
 	Vector2 map_to_world(const Vector2i &p_pos) const;
 	Vector2i world_to_map(const Vector2 &p_pos) const;
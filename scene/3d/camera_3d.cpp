@@ -99,6 +99,10 @@ void Camera3D::_update_camera() {
 	}
 }
 
+void Camera3D::_physics_interpolated_changed() {
+	RenderingServer::get_singleton()->camera_set_interpolated(camera, is_physics_interpolated_and_enabled());
+}
+
 void Camera3D::_notification(int p_what) {
 	switch (p_what) {
 		case NOTIFICATION_ENTER_WORLD: {
@@ -113,6 +117,10 @@ void Camera3D::_notification(int p_what) {
 				viewport->_camera_set(this);
 			}
 
+			RenderingServer::get_singleton()->camera_set_interpolated(camera, is_physics_interpolated_and_enabled());
+			RenderingServer::get_singleton()->camera_set_transform(camera, get_camera_transform());
+			RenderingServer::get_singleton()->camera_reset_physics_interpolation(camera);
+
 		} break;
 		case NOTIFICATION_TRANSFORM_CHANGED: {
 			_request_camera_update();
@@ -137,6 +145,12 @@ void Camera3D::_notification(int p_what) {
 			}
 
 		} break;
+		case NOTIFICATION_RESET_PHYSICS_INTERPOLATION: {
+			if (is_physics_interpolated_and_enabled()) {
+				RenderingServer::get_singleton()->camera_set_transform(camera, get_camera_transform());
+				RenderingServer::get_singleton()->camera_reset_physics_interpolation(camera);
+			}
+		} break;
 		case NOTIFICATION_BECAME_CURRENT: {
 			if (viewport) {
 				viewport->find_world_3d()->_register_camera(this);
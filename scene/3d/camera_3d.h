@@ -95,6 +95,7 @@ protected:
 	void _update_camera();
 	virtual void _request_camera_update();
 	void _update_camera_mode();
+	virtual void _physics_interpolated_changed() override;
 
 	void _notification(int p_what);
 	virtual void _validate_property(PropertyInfo &p_property) const override;
@@ -583,8 +583,14 @@ void CPUParticles3D::_particles_process(float p_delta) {
 
 	float system_phase = time / lifetime;
 
+	particle_steps.resize(pcount);
+	particle_deltas.resize(pcount);
+	uint8_t *steps = particle_steps.ptr();
+	float *deltas = particle_deltas.ptr();
+
 	for (int i = 0; i < pcount; i++) {
 		Particle &p = parray[i];
+		steps[i] = PARTICLE_STEP_SKIP;
 
 		if (!emitting && !p.active) {
 			continue;
@@ -649,6 +655,7 @@ void CPUParticles3D::_particles_process(float p_delta) {
 				continue;
 			}
 			p.active = true;
+			steps[i] = PARTICLE_STEP_RESTARTED;
 
 			/*float tex_linear_velocity = 0;
 			if (curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY].is_valid()) {
@@ -769,8 +776,53 @@ void CPUParticles3D::_particles_process(float p_delta) {
 			continue;
 		} else if (p.time > p.lifetime) {
 			p.active = false;
-			tv = 1.0;
+			steps[i] = PARTICLE_STEP_EXPIRED;
 		} else {
+			steps[i] = PARTICLE_STEP_ADVANCE;
+		}
+
+		deltas[i] = local_delta;
+	}
+
+	ProcessStep step;
+	step.particles = parray;
+	step.count = pcount;
+	step.emission_xform = emission_xform;
+	for (int i = 0; i < PARAM_MAX; i++) {
+		step.curves[i] = curve_parameters[i].ptr();
+	}
+	if (color_ramp.is_valid()) {
+		// Sorts the ramp points now, so workers only read them.
+		color_ramp->get_color_at_offset(0.0);
+		step.color_ramp = color_ramp.ptr();
+	}
+
+	ThreadWorkPool *pool = _get_work_pool(pcount);
+	if (pool) {
+		pool->do_work((pcount + PROCESS_CHUNK_SIZE - 1) / PROCESS_CHUNK_SIZE, this, &CPUParticles3D::_particles_process_chunk, &step);
+	} else {
+		_particles_process_range(0, pcount, step);
+	}
+}
+
+void CPUParticles3D::_particles_process_range(uint32_t p_from, uint32_t p_to, const ProcessStep &p_step) {
+	const uint8_t *steps = particle_steps.ptr();
+	const float *deltas = particle_deltas.ptr();
+	const Curve *const *curves = p_step.curves;
+	Gradient *ramp = p_step.color_ramp;
+
+	for (uint32_t i = p_from; i < p_to; i++) {
+		if (steps[i] == PARTICLE_STEP_SKIP) {
+			continue;
+		}
+
+		Particle &p = p_step.particles[i];
+		float local_delta = deltas[i];
+		float tv = 0.0;
+
+		if (steps[i] == PARTICLE_STEP_EXPIRED) {
+			tv = 1.0;
+		} else if (steps[i] == PARTICLE_STEP_ADVANCE) {
 			uint32_t alt_seed = p.seed;
 
 			p.time += local_delta;
@@ -778,54 +830,54 @@ void CPUParticles3D::_particles_process(float p_delta) {
 			tv = p.time / p.lifetime;
 
 			float tex_linear_velocity = 0.0;
-			if (curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY].is_valid()) {
-				tex_linear_velocity = curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY]->interpolate(tv);
+			if (curves[PARAM_INITIAL_LINEAR_VELOCITY]) {
+				tex_linear_velocity = curves[PARAM_INITIAL_LINEAR_VELOCITY]->interpolate(tv);
 			}
 
 			float tex_orbit_velocity = 0.0;
 			if (particle_flags[PARTICLE_FLAG_DISABLE_Z]) {
-				if (curve_parameters[PARAM_ORBIT_VELOCITY].is_valid()) {
-					tex_orbit_velocity = curve_parameters[PARAM_ORBIT_VELOCITY]->interpolate(tv);
+				if (curves[PARAM_ORBIT_VELOCITY]) {
+					tex_orbit_velocity = curves[PARAM_ORBIT_VELOCITY]->interpolate(tv);
 				}
 			}
 
 			float tex_angular_velocity = 0.0;
-			if (curve_parameters[PARAM_ANGULAR_VELOCITY].is_valid()) {
-				tex_angular_velocity = curve_parameters[PARAM_ANGULAR_VELOCITY]->interpolate(tv);
+			if (curves[PARAM_ANGULAR_VELOCITY]) {
+				tex_angular_velocity = curves[PARAM_ANGULAR_VELOCITY]->interpolate(tv);
 			}
 
 			float tex_linear_accel = 0.0;
-			if (curve_parameters[PARAM_LINEAR_ACCEL].is_valid()) {
-				tex_linear_accel = curve_parameters[PARAM_LINEAR_ACCEL]->interpolate(tv);
+			if (curves[PARAM_LINEAR_ACCEL]) {
+				tex_linear_accel = curves[PARAM_LINEAR_ACCEL]->interpolate(tv);
 			}
 
 			float tex_tangential_accel = 0.0;
-			if (curve_parameters[PARAM_TANGENTIAL_ACCEL].is_valid()) {
-				tex_tangential_accel = curve_parameters[PARAM_TANGENTIAL_ACCEL]->interpolate(tv);
+			if (curves[PARAM_TANGENTIAL_ACCEL]) {
+				tex_tangential_accel = curves[PARAM_TANGENTIAL_ACCEL]->interpolate(tv);
 			}
 
 			float tex_radial_accel = 0.0;
-			if (curve_parameters[PARAM_RADIAL_ACCEL].is_valid()) {
-				tex_radial_accel = curve_parameters[PARAM_RADIAL_ACCEL]->interpolate(tv);
+			if (curves[PARAM_RADIAL_ACCEL]) {
+				tex_radial_accel = curves[PARAM_RADIAL_ACCEL]->interpolate(tv);
 			}
 
 			float tex_damping = 0.0;
-			if (curve_parameters[PARAM_DAMPING].is_valid()) {
-				tex_damping = curve_parameters[PARAM_DAMPING]->interpolate(tv);
+			if (curves[PARAM_DAMPING]) {
+				tex_damping = curves[PARAM_DAMPING]->interpolate(tv);
 			}
 
 			float tex_angle = 0.0;
-			if (curve_parameters[PARAM_ANGLE].is_valid()) {
-				tex_angle = curve_parameters[PARAM_ANGLE]->interpolate(tv);
+			if (curves[PARAM_ANGLE]) {
+				tex_angle = curves[PARAM_ANGLE]->interpolate(tv);
 			}
 			float tex_anim_speed = 0.0;
-			if (curve_parameters[PARAM_ANIM_SPEED].is_valid()) {
-				tex_anim_speed = curve_parameters[PARAM_ANIM_SPEED]->interpolate(tv);
+			if (curves[PARAM_ANIM_SPEED]) {
+				tex_anim_speed = curves[PARAM_ANIM_SPEED]->interpolate(tv);
 			}
 
 			float tex_anim_offset = 0.0;
-			if (curve_parameters[PARAM_ANIM_OFFSET].is_valid()) {
-				tex_anim_offset = curve_parameters[PARAM_ANIM_OFFSET]->interpolate(tv);
+			if (curves[PARAM_ANIM_OFFSET]) {
+				tex_anim_offset = curves[PARAM_ANIM_OFFSET]->interpolate(tv);
 			}
 
 			Vector3 force = gravity;
@@ -836,7 +888,7 @@ void CPUParticles3D::_particles_process(float p_delta) {
 			//apply linear acceleration
 			force += p.velocity.length() > 0.0 ? p.velocity.normalized() * (parameters[PARAM_LINEAR_ACCEL] + tex_linear_accel) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_LINEAR_ACCEL]) : Vector3();
 			//apply radial acceleration
-			Vector3 org = emission_xform.origin;
+			Vector3 org = p_step.emission_xform.origin;
 			Vector3 diff = position - org;
 			force += diff.length() > 0.0 ? diff.normalized() * (parameters[PARAM_RADIAL_ACCEL] + tex_radial_accel) * Math::lerp(1.0f, rand_from_seed(alt_seed), randomness[PARAM_RADIAL_ACCEL]) : Vector3();
 			//apply tangential acceleration;
@@ -864,7 +916,7 @@ void CPUParticles3D::_particles_process(float p_delta) {
 					p.transform.origin += Vector3(rotv.x, rotv.y, 0);
 				}
 			}
-			if (curve_parameters[PARAM_INITIAL_LINEAR_VELOCITY].is_valid()) {
+			if (curves[PARAM_INITIAL_LINEAR_VELOCITY]) {
 				p.velocity = p.velocity.normalized() * tex_linear_velocity;
 			}
 			if (parameters[PARAM_DAMPING] + tex_damping > 0.0) {
@@ -886,13 +938,13 @@ void CPUParticles3D::_particles_process(float p_delta) {
 		//apply hue rotation
 
 		float tex_scale = 1.0;
-		if (curve_parameters[PARAM_SCALE].is_valid()) {
-			tex_scale = curve_parameters[PARAM_SCALE]->interpolate(tv);
+		if (curves[PARAM_SCALE]) {
+			tex_scale = curves[PARAM_SCALE]->interpolate(tv);
 		}
 
 		float tex_hue_variation = 0.0;
-		if (curve_parameters[PARAM_HUE_VARIATION].is_valid()) {
-			tex_hue_variation = curve_parameters[PARAM_HUE_VARIATION]->interpolate(tv);
+		if (curves[PARAM_HUE_VARIATION]) {
+			tex_hue_variation = curves[PARAM_HUE_VARIATION]->interpolate(tv);
 		}
 
 		float hue_rot_angle = (parameters[PARAM_HUE_VARIATION] + tex_hue_variation) * Math_TAU * Math::lerp(1.0f, p.hue_rot_rand * 2.0f - 1.0f, randomness[PARAM_HUE_VARIATION]);
@@ -901,17 +953,17 @@ void CPUParticles3D::_particles_process(float p_delta) {
 
 		Basis hue_rot_mat;
 		{
-			Basis mat1(0.299, 0.587, 0.114, 0.299, 0.587, 0.114, 0.299, 0.587, 0.114);
-			Basis mat2(0.701, -0.587, -0.114, -0.299, 0.413, -0.114, -0.300, -0.588, 0.886);
-			Basis mat3(0.168, 0.330, -0.497, -0.328, 0.035, 0.292, 1.250, -1.050, -0.203);
+			static const Basis mat1(0.299, 0.587, 0.114, 0.299, 0.587, 0.114, 0.299, 0.587, 0.114);
+			static const Basis mat2(0.701, -0.587, -0.114, -0.299, 0.413, -0.114, -0.300, -0.588, 0.886);
+			static const Basis mat3(0.168, 0.330, -0.497, -0.328, 0.035, 0.292, 1.250, -1.050, -0.203);
 
 			for (int j = 0; j < 3; j++) {
 				hue_rot_mat[j] = mat1[j] + mat2[j] * hue_rot_c + mat3[j] * hue_rot_s;
 			}
 		}
 
-		if (color_ramp.is_valid()) {
-			p.color = color_ramp->get_color_at_offset(tv) * color;
+		if (ramp) {
+			p.color = ramp->get_color_at_offset(tv) * color;
 		} else {
 			p.color = color;
 		}
@@ -982,6 +1034,18 @@ void CPUParticles3D::_particles_process(float p_delta) {
 	}
 }
 
+void CPUParticles3D::_particles_process_chunk(uint32_t p_chunk, ProcessStep *p_step) {
+	uint32_t from = p_chunk * PROCESS_CHUNK_SIZE;
+	_particles_process_range(from, MIN(from + PROCESS_CHUNK_SIZE, p_step->count), *p_step);
+}
+
+ThreadWorkPool *CPUParticles3D::_get_work_pool(int p_particle_count) {
+	if (!is_inside_tree()) {
+		return nullptr;
+	}
+	return get_tree()->get_cpu_particles_work_pool(p_particle_count);
+}
+
 void CPUParticles3D::_update_particle_data_buffer() {
 	MutexLock lock(update_mutex);
 
@@ -992,7 +1056,6 @@ void CPUParticles3D::_update_particle_data_buffer() {
 
 	float *w = particle_data.ptrw();
 	const Particle *r = particles.ptr();
-	float *ptr = w;
 
 	if (draw_order != DRAW_ORDER_INDEX) {
 		ow = particle_order.ptrw();
@@ -1027,8 +1090,28 @@ void CPUParticles3D::_update_particle_data_buffer() {
 		}
 	}
 
-	for (int i = 0; i < pc; i++) {
-		int idx = order ? order[i] : i;
+	BufferStep step;
+	step.particles = r;
+	step.order = order;
+	step.data = w;
+	step.count = pc;
+
+	ThreadWorkPool *pool = _get_work_pool(pc);
+	if (pool) {
+		pool->do_work((pc + PROCESS_CHUNK_SIZE - 1) / PROCESS_CHUNK_SIZE, this, &CPUParticles3D::_update_particle_data_chunk, &step);
+	} else {
+		_update_particle_data_range(0, pc, step);
+	}
+
+	can_update.set();
+}
+
+void CPUParticles3D::_update_particle_data_range(uint32_t p_from, uint32_t p_to, const BufferStep &p_step) {
+	const Particle *r = p_step.particles;
+	float *ptr = p_step.data + p_from * 20;
+
+	for (uint32_t i = p_from; i < p_to; i++) {
+		int idx = p_step.order ? p_step.order[i] : i;
 
 		Transform t = r[idx].transform;
 
@@ -1067,8 +1150,11 @@ void CPUParticles3D::_update_particle_data_buffer() {
 
 		ptr += 20;
 	}
+}
 
-	can_update.set();
+void CPUParticles3D::_update_particle_data_chunk(uint32_t p_chunk, BufferStep *p_step) {
+	uint32_t from = p_chunk * PROCESS_CHUNK_SIZE;
+	_update_particle_data_range(from, MIN(from + PROCESS_CHUNK_SIZE, p_step->count), *p_step);
 }
 
 void CPUParticles3D::_set_redraw(bool p_redraw) {
@@ -40,7 +40,7 @@
 
  possible algorithms:
 
- Algorithm 1: (current)
+ Algorithm 1: (no longer current)
 
  definition of invalidation: global is invalid
 
@@ -66,7 +66,14 @@
 
 --
 
-future: no idea
+ Algorithm 3: (current)
+
+ definition of invalidation: global is invalid, stored per slot in TransformHierarchy3D
+
+ 1) If a node sets a LOCAL, its subtree is marked dirty by walking the slot links
+    a) If a node is already dirty and listed as changed this frame, its subtree is too, so stop there
+ 2) Dirty globals are computed lazily when read, or all at once in depth order before
+    transform notifications are flushed
 
  */
 
@@ -84,6 +91,18 @@ void Node3D::_notify_dirty() {
 	}
 }
 
+void Node3D::_update_notify_flag() {
+	if (data.hierarchy_slot == TransformHierarchy3D::INVALID_SLOT) {
+		return;
+	}
+#ifdef TOOLS_ENABLED
+	bool notify = data.gizmo.is_valid() || data.notify_transform;
+#else
+	bool notify = data.notify_transform;
+#endif
+	get_tree()->transform_hierarchy_3d.set_flag(data.hierarchy_slot, TransformHierarchy3D::FLAG_NOTIFY, notify);
+}
+
 void Node3D::_update_local_transform() const {
 	data.local_transform.basis.set_euler_scale(data.rotation, data.scale);
 
@@ -91,33 +110,23 @@ void Node3D::_update_local_transform() const {
 }
 
 void Node3D::_propagate_transform_changed(Node3D *p_origin) {
-	if (!is_inside_tree()) {
+	if (data.hierarchy_slot == TransformHierarchy3D::INVALID_SLOT) {
 		return;
 	}
 
-	/*
-	if (data.dirty&DIRTY_GLOBAL)
-		return; //already dirty
-	*/
-
-	data.children_lock++;
+	TransformHierarchy3D &hierarchy = get_tree()->transform_hierarchy_3d;
+	uint32_t from = hierarchy.get_changed_count();
+	hierarchy.invalidate(data.hierarchy_slot);
 
-	for (List<Node3D *>::Element *E = data.children.front(); E; E = E->next()) {
-		if (E->get()->data.top_level_active) {
-			continue; //don't propagate to a top_level
+	// Only nodes that just became dirty are visited, the others had their
+	// notification queued when they were first invalidated this frame.
+	for (uint32_t i = from; i < hierarchy.get_changed_count(); i++) {
+		uint32_t slot = hierarchy.get_changed(i);
+		if (hierarchy.has_flag(slot, TransformHierarchy3D::FLAG_NOTIFY)) {
+			hierarchy.get_owner(slot)->_notify_dirty();
 		}
-		E->get()->_propagate_transform_changed(p_origin);
 	}
-#ifdef TOOLS_ENABLED
-	if ((data.gizmo.is_valid() || data.notify_transform) && !data.ignore_notification && !xform_change.in_list()) {
-#else
-	if (data.notify_transform && !data.ignore_notification && !xform_change.in_list()) {
-#endif
-		get_tree()->xform_change_list.add(&xform_change);
-	}
-	data.dirty |= DIRTY_GLOBAL;
-
-	data.children_lock--;
+	_notify_dirty();
 }
 
 void Node3D::_notification(int p_what) {
@@ -144,7 +153,19 @@ void Node3D::_notification(int p_what) {
 				data.top_level_active = true;
 			}
 
-			data.dirty |= DIRTY_GLOBAL; //global is always dirty upon entering a scene
+			{
+				uint32_t parent_slot = data.parent ? data.parent->data.hierarchy_slot : TransformHierarchy3D::INVALID_SLOT;
+				uint32_t flags = 0;
+				if (data.top_level_active) {
+					flags |= TransformHierarchy3D::FLAG_TOP_LEVEL;
+				}
+				if (data.disable_scale) {
+					flags |= TransformHierarchy3D::FLAG_DISABLE_SCALE;
+				}
+				//global is always dirty upon entering a scene
+				data.hierarchy_slot = get_tree()->transform_hierarchy_3d.insert(this, parent_slot, get_transform(), flags);
+			}
+			_update_notify_flag();
 			_notify_dirty();
 
 			notification(NOTIFICATION_ENTER_WORLD);
@@ -155,6 +176,8 @@ void Node3D::_notification(int p_what) {
 			if (xform_change.in_list()) {
 				get_tree()->xform_change_list.remove(&xform_change);
 			}
+			get_tree()->transform_hierarchy_3d.remove(data.hierarchy_slot);
+			data.hierarchy_slot = TransformHierarchy3D::INVALID_SLOT;
 			if (data.C) {
 				data.parent->data.children.erase(data.C);
 			}
@@ -251,26 +274,9 @@ Transform Node3D::get_transform() const {
 
 Transform Node3D::get_global_transform() const {
 	ERR_FAIL_COND_V(!is_inside_tree(), Transform());
+	ERR_FAIL_COND_V(data.hierarchy_slot == TransformHierarchy3D::INVALID_SLOT, Transform());
 
-	if (data.dirty & DIRTY_GLOBAL) {
-		if (data.dirty & DIRTY_LOCAL) {
-			_update_local_transform();
-		}
-
-		if (data.parent && !data.top_level_active) {
-			data.global_transform = data.parent->get_global_transform() * data.local_transform;
-		} else {
-			data.global_transform = data.local_transform;
-		}
-
-		if (data.disable_scale) {
-			data.global_transform.basis.orthonormalize();
-		}
-
-		data.dirty &= ~DIRTY_GLOBAL;
-	}
-
-	return data.global_transform;
+	return get_tree()->transform_hierarchy_3d.get_global(data.hierarchy_slot);
 }
 
 #ifdef TOOLS_ENABLED
@@ -400,6 +406,7 @@ void Node3D::set_gizmo(const Ref<Node3DGizmo> &p_gizmo) {
 		data.gizmo->free();
 	}
 	data.gizmo = p_gizmo;
+	_update_notify_flag();
 	if (data.gizmo.is_valid() && is_inside_world()) {
 		data.gizmo->create();
 		if (is_visible_in_tree()) {
@@ -442,6 +449,7 @@ void Node3D::set_disable_gizmo(bool p_enabled) {
 	data.gizmo_disabled = p_enabled;
 	if (!p_enabled && data.gizmo.is_valid()) {
 		data.gizmo = Ref<Node3DGizmo>();
+		_update_notify_flag();
 	}
 }
 
@@ -449,6 +457,9 @@ void Node3D::set_disable_gizmo(bool p_enabled) {
 
 void Node3D::set_disable_scale(bool p_enabled) {
 	data.disable_scale = p_enabled;
+	if (data.hierarchy_slot != TransformHierarchy3D::INVALID_SLOT) {
+		get_tree()->transform_hierarchy_3d.set_flag(data.hierarchy_slot, TransformHierarchy3D::FLAG_DISABLE_SCALE, p_enabled);
+	}
 }
 
 bool Node3D::is_scale_disabled() const {
@@ -468,6 +479,7 @@ void Node3D::set_as_top_level(bool p_enabled) {
 
 		data.top_level = p_enabled;
 		data.top_level_active = p_enabled;
+		get_tree()->transform_hierarchy_3d.set_flag(data.hierarchy_slot, TransformHierarchy3D::FLAG_TOP_LEVEL, p_enabled);
 
 	} else {
 		data.top_level = p_enabled;
@@ -668,6 +680,7 @@ Vector3 Node3D::to_global(Vector3 p_local) const {
 
 void Node3D::set_notify_transform(bool p_enable) {
 	data.notify_transform = p_enable;
+	_update_notify_flag();
 }
 
 bool Node3D::is_transform_notification_enabled() const {
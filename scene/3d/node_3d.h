@@ -55,14 +55,12 @@ class Node3D : public Node {
 	enum TransformDirty {
 		DIRTY_NONE = 0,
 		DIRTY_VECTORS = 1,
-		DIRTY_LOCAL = 2,
-		DIRTY_GLOBAL = 4
+		DIRTY_LOCAL = 2
 	};
 
 	mutable SelfList<Node> xform_change;
 
 	struct Data {
-		mutable Transform global_transform;
 		mutable Transform local_transform;
 		mutable Vector3 rotation;
 		mutable Vector3 scale = Vector3(1, 1, 1);
@@ -75,7 +73,8 @@ class Node3D : public Node {
 		bool top_level = false;
 		bool inside_world = false;
 
-		int children_lock = 0;
+		uint32_t hierarchy_slot = TransformHierarchy3D::INVALID_SLOT;
+
 		Node3D *parent = nullptr;
 		List<Node3D *> children;
 		List<Node3D *>::Element *C = nullptr;
@@ -97,6 +96,7 @@ class Node3D : public Node {
 
 	void _update_gizmo();
 	void _notify_dirty();
+	void _update_notify_flag();
 	void _propagate_transform_changed(Node3D *p_origin);
 
 	void _propagate_visibility_changed();
@@ -372,7 +372,32 @@ void RigidBody3D::_direct_state_changed(Object *p_state) {
 	state = nullptr;
 }
 
+void RigidBody3D::_bulk_state_changed(const Transform &p_transform, const Vector3 &p_linear_velocity, const Vector3 &p_angular_velocity, bool p_sleeping) {
+	set_ignore_transform_notification(true);
+	set_global_transform(p_transform);
+	linear_velocity = p_linear_velocity;
+	angular_velocity = p_angular_velocity;
+	if (sleeping != p_sleeping) {
+		sleeping = p_sleeping;
+		emit_signal(SceneStringNames::get_singleton()->sleeping_state_changed);
+	}
+	set_ignore_transform_notification(false);
+	_on_transform_changed();
+}
+
 void RigidBody3D::_notification(int p_what) {
+	if (p_what == NOTIFICATION_ENTER_WORLD) {
+		if (bulk_state_sync) {
+			get_world_3d()->_register_bulk_state_body();
+		}
+	}
+
+	if (p_what == NOTIFICATION_EXIT_WORLD) {
+		if (bulk_state_sync) {
+			get_world_3d()->_remove_bulk_state_body();
+		}
+	}
+
 #ifdef TOOLS_ENABLED
 	if (p_what == NOTIFICATION_ENTER_TREE) {
 		if (Engine::get_singleton()->is_editor_hint()) {
@@ -555,6 +580,32 @@ int RigidBody3D::get_max_contacts_reported() const {
 	return max_contacts_reported;
 }
 
+void RigidBody3D::set_bulk_state_sync(bool p_enabled) {
+	if (p_enabled == bulk_state_sync) {
+		return;
+	}
+
+	bulk_state_sync = p_enabled;
+
+	if (bulk_state_sync) {
+		PhysicsServer3D::get_singleton()->body_set_force_integration_callback(get_rid(), Callable());
+	} else {
+		PhysicsServer3D::get_singleton()->body_set_force_integration_callback(get_rid(), callable_mp(this, &RigidBody3D::_direct_state_changed));
+	}
+
+	if (is_inside_world()) {
+		if (bulk_state_sync) {
+			get_world_3d()->_register_bulk_state_body();
+		} else {
+			get_world_3d()->_remove_bulk_state_body();
+		}
+	}
+}
+
+bool RigidBody3D::is_bulk_state_sync_enabled() const {
+	return bulk_state_sync;
+}
+
 void RigidBody3D::add_central_force(const Vector3 &p_force) {
 	PhysicsServer3D::get_singleton()->body_add_central_force(get_rid(), p_force);
 }
@@ -695,6 +746,9 @@ void RigidBody3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_contact_monitor", "enabled"), &RigidBody3D::set_contact_monitor);
 	ClassDB::bind_method(D_METHOD("is_contact_monitor_enabled"), &RigidBody3D::is_contact_monitor_enabled);
 
+	ClassDB::bind_method(D_METHOD("set_bulk_state_sync", "enabled"), &RigidBody3D::set_bulk_state_sync);
+	ClassDB::bind_method(D_METHOD("is_bulk_state_sync_enabled"), &RigidBody3D::is_bulk_state_sync_enabled);
+
 	ClassDB::bind_method(D_METHOD("set_use_continuous_collision_detection", "enable"), &RigidBody3D::set_use_continuous_collision_detection);
 	ClassDB::bind_method(D_METHOD("is_using_continuous_collision_detection"), &RigidBody3D::is_using_continuous_collision_detection);
 
@@ -729,6 +783,7 @@ void RigidBody3D::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "continuous_cd"), "set_use_continuous_collision_detection", "is_using_continuous_collision_detection");
 	ADD_PROPERTY(PropertyInfo(Variant::INT, "contacts_reported", PROPERTY_HINT_RANGE, "0,64,1,or_greater"), "set_max_contacts_reported", "get_max_contacts_reported");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "contact_monitor"), "set_contact_monitor", "is_contact_monitor_enabled");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "bulk_state_sync"), "set_bulk_state_sync", "is_bulk_state_sync_enabled");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "sleeping"), "set_sleeping", "is_sleeping");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "can_sleep"), "set_can_sleep", "is_able_to_sleep");
 	ADD_GROUP("Axis Lock", "axis_lock_");
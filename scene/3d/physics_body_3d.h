@@ -116,6 +116,7 @@ protected:
 	int max_contacts_reported = 0;
 
 	bool custom_integrator = false;
+	bool bulk_state_sync = false;
 
 	struct ShapePair {
 		int body_shape = 0;
@@ -158,6 +159,9 @@ protected:
 	void _body_inout(int p_status, ObjectID p_instance, int p_body_shape, int p_local_shape);
 	virtual void _direct_state_changed(Object *p_state);
 
+	friend class World3D;
+	void _bulk_state_changed(const Transform &p_transform, const Vector3 &p_linear_velocity, const Vector3 &p_angular_velocity, bool p_sleeping);
+
 	void _notification(int p_what);
 	static void _bind_methods();
 
@@ -207,6 +211,9 @@ public:
 	void set_max_contacts_reported(int p_amount);
 	int get_max_contacts_reported() const;
 
+	void set_bulk_state_sync(bool p_enabled);
+	bool is_bulk_state_sync_enabled() const;
+
 	void set_use_continuous_collision_detection(bool p_enable);
 	bool is_using_continuous_collision_detection() const;
 
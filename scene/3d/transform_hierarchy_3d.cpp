@@ -0,0 +1,242 @@
+/*************************************************************************/
+/*  transform_hierarchy_3d.cpp                                           */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "transform_hierarchy_3d.h"
+
+#include "scene/3d/node_3d.h"
+
+// Depth levels with fewer dirty nodes than this are updated on the calling
+// thread, as dispatching them costs more than the matrix products.
+static const uint32_t THREADED_UPDATE_MIN_LEVEL_SIZE = 1024;
+
+uint32_t TransformHierarchy3D::insert(Node3D *p_owner, uint32_t p_parent, const Transform &p_local, uint32_t p_flags) {
+	uint32_t slot;
+	if (free_slots.size()) {
+		slot = free_slots[free_slots.size() - 1];
+		free_slots.resize(free_slots.size() - 1);
+	} else {
+		slot = owner.size();
+		local.push_back(Transform());
+		global.push_back(Transform());
+		parent.push_back(INVALID_SLOT);
+		first_child.push_back(INVALID_SLOT);
+		next_sibling.push_back(INVALID_SLOT);
+		prev_sibling.push_back(INVALID_SLOT);
+		depth.push_back(0);
+		flags.push_back(0);
+		owner.push_back(nullptr);
+	}
+
+	local[slot] = p_local;
+	parent[slot] = p_parent;
+	first_child[slot] = INVALID_SLOT;
+	prev_sibling[slot] = INVALID_SLOT;
+	if (p_parent != INVALID_SLOT) {
+		next_sibling[slot] = first_child[p_parent];
+		if (first_child[p_parent] != INVALID_SLOT) {
+			prev_sibling[first_child[p_parent]] = slot;
+		}
+		first_child[p_parent] = slot;
+		depth[slot] = depth[p_parent] + 1;
+	} else {
+		next_sibling[slot] = INVALID_SLOT;
+		depth[slot] = 0;
+	}
+	owner[slot] = p_owner;
+	flags[slot] = p_flags & (FLAG_TOP_LEVEL | FLAG_DISABLE_SCALE | FLAG_NOTIFY);
+
+	_mark_changed(slot);
+	return slot;
+}
+
+void TransformHierarchy3D::remove(uint32_t p_slot) {
+	ERR_FAIL_UNSIGNED_INDEX(p_slot, owner.size());
+	ERR_FAIL_COND(!owner[p_slot]);
+
+	// Children leave the tree before their parent, so this is only a safety net.
+	uint32_t child = first_child[p_slot];
+	while (child != INVALID_SLOT) {
+		uint32_t next = next_sibling[child];
+		parent[child] = INVALID_SLOT;
+		prev_sibling[child] = INVALID_SLOT;
+		next_sibling[child] = INVALID_SLOT;
+		child = next;
+	}
+
+	uint32_t prev = prev_sibling[p_slot];
+	uint32_t next = next_sibling[p_slot];
+	if (prev != INVALID_SLOT) {
+		next_sibling[prev] = next;
+	} else if (parent[p_slot] != INVALID_SLOT) {
+		first_child[parent[p_slot]] = next;
+	}
+	if (next != INVALID_SLOT) {
+		prev_sibling[next] = prev;
+	}
+
+	parent[p_slot] = INVALID_SLOT;
+	first_child[p_slot] = INVALID_SLOT;
+	next_sibling[p_slot] = INVALID_SLOT;
+	prev_sibling[p_slot] = INVALID_SLOT;
+	owner[p_slot] = nullptr;
+	// Clearing FLAG_CHANGED makes update() skip the stale changed entry.
+	flags[p_slot] = 0;
+
+	free_slots.push_back(p_slot);
+}
+
+void TransformHierarchy3D::invalidate(uint32_t p_slot) {
+	uint8_t f = flags[p_slot];
+	flags[p_slot] = f | FLAG_LOCAL_DIRTY;
+	if ((f & (FLAG_DIRTY | FLAG_CHANGED)) == (FLAG_DIRTY | FLAG_CHANGED)) {
+		// A slot is only cleaned after its parent, so the whole subtree is
+		// still dirty and already in the changed list.
+		return;
+	}
+
+	_mark_changed(p_slot);
+
+	mark_stack.clear();
+	if (first_child[p_slot] != INVALID_SLOT) {
+		mark_stack.push_back(first_child[p_slot]);
+	}
+
+	while (mark_stack.size()) {
+		uint32_t slot = mark_stack[mark_stack.size() - 1];
+		mark_stack.resize(mark_stack.size() - 1);
+
+		if (next_sibling[slot] != INVALID_SLOT) {
+			mark_stack.push_back(next_sibling[slot]);
+		}
+
+		f = flags[slot];
+		if (f & FLAG_TOP_LEVEL) {
+			continue; // Don't propagate to a top level branch.
+		}
+		if ((f & (FLAG_DIRTY | FLAG_CHANGED)) == (FLAG_DIRTY | FLAG_CHANGED)) {
+			continue;
+		}
+
+		_mark_changed(slot);
+		if (first_child[slot] != INVALID_SLOT) {
+			mark_stack.push_back(first_child[slot]);
+		}
+	}
+}
+
+void TransformHierarchy3D::_update_global(uint32_t p_slot) {
+	uint8_t f = flags[p_slot];
+	if (f & FLAG_LOCAL_DIRTY) {
+		local[p_slot] = owner[p_slot]->get_transform();
+	}
+
+	uint32_t p = parent[p_slot];
+	if (p != INVALID_SLOT && !(f & FLAG_TOP_LEVEL)) {
+		if (flags[p] & FLAG_DIRTY) {
+			_update_global(p);
+		}
+		global[p_slot] = global[p] * local[p_slot];
+	} else {
+		global[p_slot] = local[p_slot];
+	}
+
+	if (f & FLAG_DISABLE_SCALE) {
+		global[p_slot].basis.orthonormalize();
+	}
+
+	flags[p_slot] &= ~(FLAG_DIRTY | FLAG_LOCAL_DIRTY);
+}
+
+void TransformHierarchy3D::_update_global_work(uint32_t p_index, const uint64_t *p_order) {
+	_update_global(uint32_t(p_order[p_index]));
+}
+
+void TransformHierarchy3D::update() {
+	if (!changed.size()) {
+		return;
+	}
+
+	// Sort by depth so every parent is clean before its children are updated.
+	update_order.clear();
+	for (uint32_t i = 0; i < changed.size(); i++) {
+		uint32_t slot = changed[i];
+		uint8_t f = flags[slot];
+		if (!(f & FLAG_CHANGED)) {
+			continue; // Removed, or listed twice after being reused.
+		}
+		flags[slot] = f & ~FLAG_CHANGED;
+		if (f & FLAG_DIRTY) {
+			update_order.push_back((uint64_t(depth[slot]) << 32) | slot);
+		}
+	}
+	changed.clear();
+	update_order.sort();
+
+	const uint32_t count = update_order.size();
+	const uint64_t *order = update_order.ptr();
+
+	if (!use_threads || count < THREADED_UPDATE_MIN_LEVEL_SIZE) {
+		for (uint32_t i = 0; i < count; i++) {
+			_update_global(uint32_t(order[i]));
+		}
+		return;
+	}
+
+	if (!thread_pool_initialized) {
+		thread_pool.init();
+		thread_pool_initialized = true;
+	}
+
+	// Nodes of the same depth only read the (already clean) level above,
+	// so each level can be split across threads.
+	uint32_t from = 0;
+	while (from < count) {
+		uint32_t level = uint32_t(order[from] >> 32);
+		uint32_t to = from + 1;
+		while (to < count && uint32_t(order[to] >> 32) == level) {
+			to++;
+		}
+
+		if (to - from >= THREADED_UPDATE_MIN_LEVEL_SIZE) {
+			thread_pool.do_work(to - from, this, &TransformHierarchy3D::_update_global_work, order + from);
+		} else {
+			for (uint32_t i = from; i < to; i++) {
+				_update_global(uint32_t(order[i]));
+			}
+		}
+		from = to;
+	}
+}
+
+TransformHierarchy3D::~TransformHierarchy3D() {
+	if (thread_pool_initialized) {
+		thread_pool.finish();
+	}
+}
@@ -0,0 +1,130 @@
+/*************************************************************************/
+/*  transform_hierarchy_3d.h                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TRANSFORM_HIERARCHY_3D_H
+#define TRANSFORM_HIERARCHY_3D_H
+
+#include "core/math/transform.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/thread_work_pool.h"
+
+class Node3D;
+
+// Transforms of the Node3Ds inside a SceneTree, kept in parallel arrays
+// indexed by slot. Invalidating a node marks its subtree dirty by walking
+// the slot links, and global transforms are recomputed either lazily when
+// read, or in one depth-ordered pass before transform notifications are
+// flushed.
+class TransformHierarchy3D {
+public:
+	enum {
+		INVALID_SLOT = 0xFFFFFFFF,
+	};
+
+	enum Flags {
+		FLAG_DIRTY = 1, // Global transform must be recomputed.
+		FLAG_CHANGED = 2, // In the changed list since the last update.
+		FLAG_LOCAL_DIRTY = 4, // Local transform must be fetched from the owner.
+		FLAG_TOP_LEVEL = 8,
+		FLAG_DISABLE_SCALE = 16,
+		FLAG_NOTIFY = 32, // Owner wants NOTIFICATION_TRANSFORM_CHANGED.
+	};
+
+private:
+	LocalVector<Transform> local;
+	LocalVector<Transform> global;
+	LocalVector<uint32_t> parent;
+	LocalVector<uint32_t> first_child;
+	LocalVector<uint32_t> next_sibling;
+	LocalVector<uint32_t> prev_sibling;
+	LocalVector<uint32_t> depth;
+	LocalVector<uint8_t> flags;
+	LocalVector<Node3D *> owner;
+
+	LocalVector<uint32_t> free_slots;
+	LocalVector<uint32_t> changed;
+	LocalVector<uint32_t> mark_stack;
+	LocalVector<uint64_t> update_order;
+
+	bool use_threads = false;
+	ThreadWorkPool thread_pool;
+	bool thread_pool_initialized = false;
+
+	// Also lists slots that are already changed but were read (and possibly
+	// notified) since, so the owner gets notified of the new transform too.
+	// update() skips the second entry.
+	_FORCE_INLINE_ void _mark_changed(uint32_t p_slot) {
+		changed.push_back(p_slot);
+		flags[p_slot] |= FLAG_DIRTY | FLAG_CHANGED;
+	}
+
+	void _update_global(uint32_t p_slot);
+	void _update_global_work(uint32_t p_index, const uint64_t *p_order);
+
+public:
+	uint32_t insert(Node3D *p_owner, uint32_t p_parent, const Transform &p_local, uint32_t p_flags);
+	void remove(uint32_t p_slot);
+
+	// Marks the local transform of the slot as changed, and the global
+	// transforms of its subtree (except top level branches) as dirty.
+	void invalidate(uint32_t p_slot);
+
+	_FORCE_INLINE_ void set_flag(uint32_t p_slot, Flags p_flag, bool p_enabled) {
+		if (p_enabled) {
+			flags[p_slot] |= p_flag;
+		} else {
+			flags[p_slot] &= ~p_flag;
+		}
+	}
+	_FORCE_INLINE_ bool has_flag(uint32_t p_slot, Flags p_flag) const { return flags[p_slot] & p_flag; }
+	_FORCE_INLINE_ Node3D *get_owner(uint32_t p_slot) const { return owner[p_slot]; }
+
+	// Slots invalidated since the last update, in invalidation order. A slot
+	// invalidated again after being read is listed again.
+	_FORCE_INLINE_ uint32_t get_changed_count() const { return changed.size(); }
+	_FORCE_INLINE_ uint32_t get_changed(uint32_t p_index) const { return changed[p_index]; }
+
+	_FORCE_INLINE_ const Transform &get_global(uint32_t p_slot) {
+		if (flags[p_slot] & FLAG_DIRTY) {
+			_update_global(p_slot);
+		}
+		return global[p_slot];
+	}
+
+	// Recomputes all dirty global transforms, parents before children.
+	void update();
+
+	void set_use_threads(bool p_enabled) { use_threads = p_enabled; }
+	bool is_using_threads() const { return use_threads; }
+
+	~TransformHierarchy3D();
+};
+
+#endif // TRANSFORM_HIERARCHY_3D_H
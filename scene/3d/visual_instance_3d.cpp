@@ -59,6 +59,11 @@ void VisualInstance3D::_notification(int p_what) {
 			RenderingServer::get_singleton()->instance_set_scenario(instance, get_world_3d()->get_scenario());
 			_update_visibility();
 
+			// Start interpolating from where the node entered, not from the origin.
+			RenderingServer::get_singleton()->instance_set_interpolated(instance, is_physics_interpolated_and_enabled());
+			RenderingServer::get_singleton()->instance_set_transform(instance, get_global_transform());
+			RenderingServer::get_singleton()->instance_reset_physics_interpolation(instance);
+
 		} break;
 		case NOTIFICATION_TRANSFORM_CHANGED: {
 			Transform gt = get_global_transform();
@@ -73,9 +78,19 @@ void VisualInstance3D::_notification(int p_what) {
 		case NOTIFICATION_VISIBILITY_CHANGED: {
 			_update_visibility();
 		} break;
+		case NOTIFICATION_RESET_PHYSICS_INTERPOLATION: {
+			if (is_physics_interpolated_and_enabled()) {
+				RenderingServer::get_singleton()->instance_set_transform(instance, get_global_transform());
+				RenderingServer::get_singleton()->instance_reset_physics_interpolation(instance);
+			}
+		} break;
 	}
 }
 
+void VisualInstance3D::_physics_interpolated_changed() {
+	RenderingServer::get_singleton()->instance_set_interpolated(instance, is_physics_interpolated_and_enabled());
+}
+
 RID VisualInstance3D::get_instance() const {
 	return instance;
 }
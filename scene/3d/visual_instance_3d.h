@@ -48,6 +48,7 @@ class VisualInstance3D : public Node3D {
 
 protected:
 	void _update_visibility();
+	virtual void _physics_interpolated_changed() override;
 
 	void _notification(int p_what);
 	static void _bind_methods();
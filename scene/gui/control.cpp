@@ -464,13 +464,18 @@ void Control::_clear_size_warning() {
 
 void Control::add_child_notify(Node *p_child) {
 	Control *child_c = Object::cast_to<Control>(p_child);
+	Window *child_w = Object::cast_to<Window>(p_child);
+
+	if ((child_c && child_c->data.theme.is_valid()) || (child_w && child_w->theme.is_valid())) {
+		// Not propagated, but items missing from the child's theme now
+		// resolve through this node.
+		_invalidate_theme_cache(p_child);
+	}
 
 	if (child_c && child_c->data.theme.is_null() && (data.theme_owner || data.theme_owner_window)) {
 		_propagate_theme_changed(child_c, data.theme_owner, data.theme_owner_window); //need to propagate here, since many controls may require setting up stuff
 	}
 
-	Window *child_w = Object::cast_to<Window>(p_child);
-
 	if (child_w && child_w->theme.is_null() && (data.theme_owner || data.theme_owner_window)) {
 		_propagate_theme_changed(child_w, data.theme_owner, data.theme_owner_window); //need to propagate here, since many controls may require setting up stuff
 	}
@@ -478,13 +483,16 @@ void Control::add_child_notify(Node *p_child) {
 
 void Control::remove_child_notify(Node *p_child) {
 	Control *child_c = Object::cast_to<Control>(p_child);
+	Window *child_w = Object::cast_to<Window>(p_child);
+
+	if ((child_c && child_c->data.theme.is_valid()) || (child_w && child_w->theme.is_valid())) {
+		_invalidate_theme_cache(p_child);
+	}
 
 	if (child_c && (child_c->data.theme_owner || child_c->data.theme_owner_window) && child_c->data.theme.is_null()) {
 		_propagate_theme_changed(child_c, nullptr, nullptr);
 	}
 
-	Window *child_w = Object::cast_to<Window>(p_child);
-
 	if (child_w && (child_w->theme_owner || child_w->theme_owner_window) && child_w->theme.is_null()) {
 		_propagate_theme_changed(child_w, nullptr, nullptr);
 	}
@@ -513,6 +521,8 @@ void Control::_notification(int p_notification) {
 		} break;
 
 		case NOTIFICATION_ENTER_CANVAS: {
+			// Items resolved outside the tree may come from other theme owners.
+			_clear_theme_cache();
 			data.parent = Object::cast_to<Control>(get_parent());
 
 			Node *parent = this; //meh
@@ -859,7 +869,15 @@ Ref<Texture2D> Control::get_theme_icon(const StringName &p_name, const StringNam
 
 	StringName type = p_node_type ? p_node_type : get_class_name();
 
-	return get_icons(data.theme_owner, data.theme_owner_window, p_name, type);
+	ThemeItemKey key = { p_name, type };
+	const Ref<Texture2D> *cached = data.icon_cache.getptr(key);
+	if (cached) {
+		return *cached;
+	}
+
+	Ref<Texture2D> tex = get_icons(data.theme_owner, data.theme_owner_window, p_name, type);
+	data.icon_cache.set(key, tex);
+	return tex;
 }
 
 Ref<Texture2D> Control::get_icons(Control *p_theme_owner, Window *p_theme_owner_window, const StringName &p_name, const StringName &p_node_type) {
@@ -888,7 +906,15 @@ Ref<StyleBox> Control::get_theme_stylebox(const StringName &p_name, const String
 
 	StringName type = p_node_type ? p_node_type : get_class_name();
 
-	return get_styleboxs(data.theme_owner, data.theme_owner_window, p_name, type);
+	ThemeItemKey key = { p_name, type };
+	const Ref<StyleBox> *cached = data.style_cache.getptr(key);
+	if (cached) {
+		return *cached;
+	}
+
+	Ref<StyleBox> style = get_styleboxs(data.theme_owner, data.theme_owner_window, p_name, type);
+	data.style_cache.set(key, style);
+	return style;
 }
 
 Ref<StyleBox> Control::get_styleboxs(Control *p_theme_owner, Window *p_theme_owner_window, const StringName &p_name, const StringName &p_node_type) {
@@ -917,7 +943,15 @@ Ref<Font> Control::get_theme_font(const StringName &p_name, const StringName &p_
 
 	StringName type = p_node_type ? p_node_type : get_class_name();
 
-	return get_fonts(data.theme_owner, data.theme_owner_window, p_name, type);
+	ThemeItemKey key = { p_name, type };
+	const Ref<Font> *cached = data.font_cache.getptr(key);
+	if (cached) {
+		return *cached;
+	}
+
+	Ref<Font> font = get_fonts(data.theme_owner, data.theme_owner_window, p_name, type);
+	data.font_cache.set(key, font);
+	return font;
 }
 
 int Control::get_theme_font_size(const StringName &p_name, const StringName &p_node_type) const {
@@ -930,7 +964,15 @@ int Control::get_theme_font_size(const StringName &p_name, const StringName &p_n
 
 	StringName type = p_node_type ? p_node_type : get_class_name();
 
-	return get_font_sizes(data.theme_owner, data.theme_owner_window, p_name, type);
+	ThemeItemKey key = { p_name, type };
+	const int *cached = data.font_size_cache.getptr(key);
+	if (cached) {
+		return *cached;
+	}
+
+	int font_size = get_font_sizes(data.theme_owner, data.theme_owner_window, p_name, type);
+	data.font_size_cache.set(key, font_size);
+	return font_size;
 }
 
 Ref<Font> Control::get_fonts(Control *p_theme_owner, Window *p_theme_owner_window, const StringName &p_name, const StringName &p_node_type) {
@@ -975,7 +1017,15 @@ Color Control::get_theme_color(const StringName &p_name, const StringName &p_nod
 
 	StringName type = p_node_type ? p_node_type : get_class_name();
 
-	return get_colors(data.theme_owner, data.theme_owner_window, p_name, type);
+	ThemeItemKey key = { p_name, type };
+	const Color *cached = data.color_cache.getptr(key);
+	if (cached) {
+		return *cached;
+	}
+
+	Color color = get_colors(data.theme_owner, data.theme_owner_window, p_name, type);
+	data.color_cache.set(key, color);
+	return color;
 }
 
 Color Control::get_colors(Control *p_theme_owner, Window *p_theme_owner_window, const StringName &p_name, const StringName &p_node_type) {
@@ -1003,7 +1053,15 @@ int Control::get_theme_constant(const StringName &p_name, const StringName &p_no
 
 	StringName type = p_node_type ? p_node_type : get_class_name();
 
-	return get_constants(data.theme_owner, data.theme_owner_window, p_name, type);
+	ThemeItemKey key = { p_name, type };
+	const int *cached = data.constant_cache.getptr(key);
+	if (cached) {
+		return *cached;
+	}
+
+	int constant = get_constants(data.theme_owner, data.theme_owner_window, p_name, type);
+	data.constant_cache.set(key, constant);
+	return constant;
 }
 
 int Control::get_constants(Control *p_theme_owner, Window *p_theme_owner_window, const StringName &p_name, const StringName &p_node_type) {
@@ -2093,12 +2151,14 @@ void Control::_propagate_theme_changed(Node *p_at, Control *p_owner, Window *p_o
 	Control *c = Object::cast_to<Control>(p_at);
 
 	if (c && c != p_owner && c->data.theme.is_valid()) { // has a theme, this can't be propagated
+		_invalidate_theme_cache(c); // but items missing from it resolve through the owners above
 		return;
 	}
 
 	Window *w = c == nullptr ? Object::cast_to<Window>(p_at) : nullptr;
 
 	if (w && w != p_owner_window && w->theme.is_valid()) { // has a theme, this can't be propagated
+		_invalidate_theme_cache(w);
 		return;
 	}
 
@@ -2119,6 +2179,7 @@ void Control::_propagate_theme_changed(Node *p_at, Control *p_owner, Window *p_o
 			c->data.theme_owner = p_owner;
 			c->data.theme_owner_window = p_owner_window;
 		}
+		c->_clear_theme_cache();
 		c->notification(Control::NOTIFICATION_THEME_CHANGED);
 		c->emit_signal(SceneStringNames::get_singleton()->theme_changed);
 	}
@@ -2134,9 +2195,43 @@ void Control::_propagate_theme_changed(Node *p_at, Control *p_owner, Window *p_o
 }
 
 void Control::_theme_changed() {
+	// Lookups must see the edit right away, but editing a theme emits "changed"
+	// once per item, so the subtree is notified once, later.
+	_invalidate_theme_cache(this);
+	if (!data.theme_changed_queued) {
+		data.theme_changed_queued = true;
+		MessageQueue::get_singleton()->push_callable(callable_mp(this, &Control::_propagate_queued_theme_change));
+	}
+}
+
+void Control::_propagate_queued_theme_change() {
+	data.theme_changed_queued = false;
 	_propagate_theme_changed(this, this, nullptr, false);
 }
 
+void Control::_clear_theme_cache() {
+	data.icon_cache.clear();
+	data.style_cache.clear();
+	data.font_cache.clear();
+	data.font_size_cache.clear();
+	data.color_cache.clear();
+	data.constant_cache.clear();
+}
+
+void Control::_invalidate_theme_cache(Node *p_at) {
+	Control *c = Object::cast_to<Control>(p_at);
+	if (c) {
+		c->_clear_theme_cache();
+	}
+
+	for (int i = 0; i < p_at->get_child_count(); i++) {
+		Node *child = p_at->get_child(i);
+		if (Object::cast_to<CanvasItem>(child) || Object::cast_to<Window>(child)) {
+			_invalidate_theme_cache(child);
+		}
+	}
+}
+
 void Control::set_theme(const Ref<Theme> &p_theme) {
 	if (data.theme == p_theme) {
 		return;
@@ -2167,7 +2262,7 @@ void Control::set_theme(const Ref<Theme> &p_theme) {
 	}
 
 	if (data.theme.is_valid()) {
-		data.theme->connect("changed", callable_mp(this, &Control::_theme_changed), varray(), CONNECT_DEFERRED);
+		data.theme->connect("changed", callable_mp(this, &Control::_theme_changed));
 	}
 }
 
@@ -32,6 +32,7 @@
 #define CONTROL_H
 
 #include "core/math/transform_2d.h"
+#include "core/templates/flat_hash_map.h"
 #include "core/templates/rid.h"
 #include "scene/gui/shortcut.h"
 #include "scene/main/canvas_item.h"
@@ -162,6 +163,19 @@ private:
 		}
 	};
 
+	struct ThemeItemKey {
+		StringName name;
+		StringName node_type;
+
+		bool operator==(const ThemeItemKey &p_key) const {
+			return name == p_key.name && node_type == p_key.node_type;
+		}
+	};
+
+	struct ThemeItemKeyHasher {
+		static _FORCE_INLINE_ uint32_t hash(const ThemeItemKey &p_key) { return hash_djb2_one_32(p_key.name.hash(), p_key.node_type.hash()); }
+	};
+
 	struct Data {
 		Point2 pos_cache;
 		Size2 size_cache;
@@ -219,6 +233,16 @@ private:
 		HashMap<StringName, Color> color_override;
 		HashMap<StringName, int> constant_override;
 
+		// Theme items resolved through the theme owners. Cleared for a whole
+		// subtree when its theme owners or their themes change.
+		mutable FlatHashMap<ThemeItemKey, Ref<Texture2D>, ThemeItemKeyHasher> icon_cache;
+		mutable FlatHashMap<ThemeItemKey, Ref<StyleBox>, ThemeItemKeyHasher> style_cache;
+		mutable FlatHashMap<ThemeItemKey, Ref<Font>, ThemeItemKeyHasher> font_cache;
+		mutable FlatHashMap<ThemeItemKey, int, ThemeItemKeyHasher> font_size_cache;
+		mutable FlatHashMap<ThemeItemKey, Color, ThemeItemKeyHasher> color_cache;
+		mutable FlatHashMap<ThemeItemKey, int, ThemeItemKeyHasher> constant_cache;
+		bool theme_changed_queued = false;
+
 	} data;
 
 	// used internally
@@ -233,6 +257,8 @@ private:
 	void _set_size(const Size2 &p_size);
 
 	void _theme_changed();
+	void _propagate_queued_theme_change();
+	void _clear_theme_cache();
 
 	void _update_minimum_size();
 
@@ -255,7 +281,9 @@ private:
 
 	void _update_minimum_size_cache();
 	friend class Window;
+	friend class Theme;
 	static void _propagate_theme_changed(Node *p_at, Control *p_owner, Window *p_owner_window, bool p_assign = true);
+	static void _invalidate_theme_cache(Node *p_at);
 
 	template <class T>
 	_FORCE_INLINE_ static bool _find_theme_item(Control *p_theme_owner, Window *p_theme_owner_window, T &, T (Theme::*get_func)(const StringName &, const StringName &) const, bool (Theme::*has_func)(const StringName &, const StringName &) const, const StringName &p_name, const StringName &p_node_type);
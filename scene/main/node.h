@@ -54,6 +54,12 @@ public:
 		PROCESS_MODE_DISABLED, // never process
 	};
 
+	enum PhysicsInterpolationMode {
+		PHYSICS_INTERPOLATION_MODE_INHERIT, // same as parent node
+		PHYSICS_INTERPOLATION_MODE_OFF,
+		PHYSICS_INTERPOLATION_MODE_ON,
+	};
+
 	enum DuplicateFlags {
 		DUPLICATE_SIGNALS = 1,
 		DUPLICATE_GROUPS = 2,
@@ -115,6 +121,9 @@ private:
 		ProcessMode process_mode = PROCESS_MODE_INHERIT;
 		Node *process_owner = nullptr;
 
+		PhysicsInterpolationMode physics_interpolation_mode = PHYSICS_INTERPOLATION_MODE_INHERIT;
+		bool physics_interpolated = true; // Resolved from the mode and the parent when entering the tree.
+
 		int network_master = 1; // Server by default.
 		Vector<NetData> rpc_methods;
 		Vector<NetData> rpc_properties;
@@ -170,6 +179,8 @@ private:
 	void _propagate_validate_owner();
 	void _print_stray_nodes();
 	void _propagate_process_owner(Node *p_owner, int p_notification);
+	void _propagate_physics_interpolated(bool p_interpolated);
+	void _propagate_physics_interpolation_enabled();
 	Array _get_node_and_resource(const NodePath &p_path);
 
 	void _duplicate_signals(const Node *p_original, Node *p_copy) const;
@@ -200,6 +211,9 @@ protected:
 	virtual void remove_child_notify(Node *p_child);
 	virtual void move_child_notify(Node *p_child);
 
+	// Called when is_physics_interpolated_and_enabled() may have changed.
+	virtual void _physics_interpolated_changed() {}
+
 	void _propagate_replace_owner(Node *p_owner, Node *p_by_owner);
 
 	static void _bind_methods();
@@ -232,6 +246,7 @@ public:
 		NOTIFICATION_INTERNAL_PROCESS = 25,
 		NOTIFICATION_INTERNAL_PHYSICS_PROCESS = 26,
 		NOTIFICATION_POST_ENTER_TREE = 27,
+		NOTIFICATION_RESET_PHYSICS_INTERPOLATION = 28,
 		//keep these linked to node
 
 		NOTIFICATION_WM_MOUSE_ENTER = 1002,
@@ -385,6 +400,12 @@ public:
 	bool can_process() const;
 	bool can_process_notification(int p_what) const;
 
+	void set_physics_interpolation_mode(PhysicsInterpolationMode p_mode);
+	PhysicsInterpolationMode get_physics_interpolation_mode() const;
+	_FORCE_INLINE_ bool is_physics_interpolated() const { return data.physics_interpolated; }
+	_FORCE_INLINE_ bool is_physics_interpolated_and_enabled() const { return data.physics_interpolated && is_inside_tree() && get_tree()->is_physics_interpolation_enabled(); }
+	void reset_physics_interpolation();
+
 	void request_ready();
 
 	static void print_stray_nodes();
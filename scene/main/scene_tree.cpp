@@ -42,6 +42,7 @@
 #include "core/string/print_string.h"
 #include "node.h"
 #include "scene/debugger/scene_debugger.h"
+#include "scene/main/timer.h"
 #include "scene/resources/font.h"
 #include "scene/resources/material.h"
 #include "scene/resources/mesh.h"
@@ -67,14 +68,29 @@ void SceneTreeTimer::_bind_methods() {
 
 void SceneTreeTimer::set_time_left(float p_time) {
 	time_left = p_time;
+	if (tree) {
+		tree->_schedule_timer(this);
+	}
 }
 
 float SceneTreeTimer::get_time_left() const {
+	if (wheel_entry != TimerWheel::INVALID_ENTRY) {
+		return tree->_get_timer_wheel(process_always).get_time_left(wheel_entry);
+	}
 	return time_left;
 }
 
 void SceneTreeTimer::set_process_always(bool p_process_always) {
-	process_always = p_process_always;
+	if (process_always == p_process_always) {
+		return;
+	}
+	if (tree) {
+		tree->_unschedule_timer(this);
+		process_always = p_process_always;
+		tree->_schedule_timer(this);
+	} else {
+		process_always = p_process_always;
+	}
 }
 
 bool SceneTreeTimer::is_process_always() {
@@ -147,6 +163,8 @@ void SceneTree::make_group_changed(const StringName &p_group) {
 }
 
 void SceneTree::flush_transform_notifications() {
+	transform_hierarchy_3d.update();
+
 	SelfList<Node> *n = xform_change_list.first();
 	while (n) {
 		Node *node = n->self();
@@ -407,6 +425,7 @@ bool SceneTree::physics_process(float p_time) {
 
 	emit_signal("physics_frame");
 
+	_process_node_timers(physics_timer_wheel, p_time);
 	_notify_group_pause("physics_process_internal", Node::NOTIFICATION_INTERNAL_PHYSICS_PROCESS);
 	call_group_flags(GROUP_CALL_REALTIME, "_viewports", "_process_picking");
 	_notify_group_pause("physics_process", Node::NOTIFICATION_PHYSICS_PROCESS);
@@ -439,6 +458,7 @@ bool SceneTree::process(float p_time) {
 
 	flush_transform_notifications();
 
+	_process_node_timers(idle_timer_wheel, p_time);
 	_notify_group_pause("process_internal", Node::NOTIFICATION_INTERNAL_PROCESS);
 	_notify_group_pause("process", Node::NOTIFICATION_PROCESS);
 
@@ -453,29 +473,9 @@ bool SceneTree::process(float p_time) {
 
 	//go through timers
 
-	List<Ref<SceneTreeTimer>>::Element *L = timers.back(); //last element
-
-	for (List<Ref<SceneTreeTimer>>::Element *E = timers.front(); E;) {
-		List<Ref<SceneTreeTimer>>::Element *N = E->next();
-		if (paused && !E->get()->is_process_always()) {
-			if (E == L) {
-				break; //break on last, so if new timers were added during list traversal, ignore them.
-			}
-			E = N;
-			continue;
-		}
-		float time_left = E->get()->get_time_left();
-		time_left -= p_time;
-		E->get()->set_time_left(time_left);
-
-		if (time_left < 0) {
-			E->get()->emit_signal("timeout");
-			timers.erase(E);
-		}
-		if (E == L) {
-			break; //break on last, so if new timers were added during list traversal, ignore them.
-		}
-		E = N;
+	_process_timers(timer_wheel, p_time);
+	if (!paused) {
+		_process_timers(pausable_timer_wheel, p_time);
 	}
 
 	flush_transform_notifications(); //additional transforms after timers update
@@ -531,8 +531,13 @@ void SceneTree::finalize() {
 	// cleanup timers
 	for (List<Ref<SceneTreeTimer>>::Element *E = timers.front(); E; E = E->next()) {
 		E->get()->release_connections();
+		E->get()->tree = nullptr;
+		E->get()->timer_element = nullptr;
+		E->get()->wheel_entry = TimerWheel::INVALID_ENTRY;
 	}
 	timers.clear();
+	timer_wheel.clear();
+	pausable_timer_wheel.clear();
 }
 
 void SceneTree::quit(int p_exit_code) {
@@ -597,6 +602,31 @@ bool SceneTree::is_node_being_edited(const Node *p_node) const {
 }
 #endif
 
+void SceneTree::set_physics_interpolation_enabled(bool p_enabled) {
+	// Interpolation is never used while editing, the editor doesn't run physics ticks.
+	if (Engine::get_singleton()->is_editor_hint()) {
+		p_enabled = false;
+	}
+
+	if (physics_interpolation_enabled == p_enabled) {
+		return;
+	}
+
+	physics_interpolation_enabled = p_enabled;
+
+	// Interpolation already smooths the ticks, snapping them to the frames would make it stutter.
+	if (p_enabled) {
+		physics_jitter_fix_without_interpolation = Engine::get_singleton()->get_physics_jitter_fix();
+		Engine::get_singleton()->set_physics_jitter_fix(0);
+	} else {
+		Engine::get_singleton()->set_physics_jitter_fix(physics_jitter_fix_without_interpolation);
+	}
+
+	if (root) {
+		root->_propagate_physics_interpolation_enabled();
+	}
+}
+
 #ifdef DEBUG_ENABLED
 void SceneTree::set_debug_collisions_hint(bool p_enabled) {
 	debug_collisions_hint = p_enabled;
@@ -1087,10 +1117,89 @@ Ref<SceneTreeTimer> SceneTree::create_timer(float p_delay_sec, bool p_process_al
 	stt.instance();
 	stt->set_process_always(p_process_always);
 	stt->set_time_left(p_delay_sec);
-	timers.push_back(stt);
+	stt->tree = this;
+	stt->timer_element = timers.push_back(stt);
+	_schedule_timer(stt.ptr());
 	return stt;
 }
 
+void SceneTree::_schedule_timer(SceneTreeTimer *p_timer) {
+	TimerWheel &wheel = _get_timer_wheel(p_timer->process_always);
+	if (p_timer->wheel_entry != TimerWheel::INVALID_ENTRY) {
+		wheel.cancel(p_timer->wheel_entry);
+	}
+	p_timer->wheel_entry = wheel.schedule(p_timer->time_left, (uint64_t)(uintptr_t)p_timer);
+	p_timer->timeout_pending = false;
+}
+
+void SceneTree::_unschedule_timer(SceneTreeTimer *p_timer) {
+	if (p_timer->wheel_entry == TimerWheel::INVALID_ENTRY) {
+		return;
+	}
+	TimerWheel &wheel = _get_timer_wheel(p_timer->process_always);
+	p_timer->time_left = wheel.get_time_left(p_timer->wheel_entry);
+	wheel.cancel(p_timer->wheel_entry);
+	p_timer->wheel_entry = TimerWheel::INVALID_ENTRY;
+}
+
+void SceneTree::_process_timers(TimerWheel &p_wheel, float p_time) {
+	p_wheel.advance(p_time, expired_timers);
+	if (!expired_timers.size()) {
+		return;
+	}
+
+	// Pending timers are kept alive by the timers list, so the wheel can
+	// hold plain pointers. All are marked before emitting, as a timeout
+	// may reschedule a timer that expired in the same frame.
+	const LocalVector<TimerWheel::Expired> &expired = expired_timers;
+	for (uint32_t i = 0; i < expired.size(); i++) {
+		SceneTreeTimer *timer = (SceneTreeTimer *)(uintptr_t)expired[i].userdata;
+		timer->wheel_entry = TimerWheel::INVALID_ENTRY;
+		timer->time_left = expired[i].time_left;
+		timer->timeout_pending = true;
+	}
+
+	for (uint32_t i = 0; i < expired.size(); i++) {
+		SceneTreeTimer *timer = (SceneTreeTimer *)(uintptr_t)expired[i].userdata;
+		if (!timer->timeout_pending) {
+			continue;
+		}
+		Ref<SceneTreeTimer> ref = timer;
+		timer->timeout_pending = false;
+		timer->tree = nullptr;
+		timers.erase(timer->timer_element);
+		timer->timer_element = nullptr;
+		timer->emit_signal("timeout");
+	}
+}
+
+void SceneTree::_process_node_timers(TimerWheel &p_wheel, float p_time) {
+	p_wheel.advance(p_time, expired_timers);
+	if (!expired_timers.size()) {
+		return;
+	}
+
+	// Timer nodes can be freed by an earlier timeout, so look them up by ID.
+	const LocalVector<TimerWheel::Expired> &expired = expired_timers;
+	for (uint32_t i = 0; i < expired.size(); i++) {
+		Timer *timer = Object::cast_to<Timer>(ObjectDB::get_instance(ObjectID(expired[i].userdata)));
+		if (timer) {
+			timer->wheel_entry = TimerWheel::INVALID_ENTRY;
+			timer->scheduled_wheel = nullptr;
+			timer->time_left = expired[i].time_left;
+			timer->timeout_pending = true;
+		}
+	}
+
+	for (uint32_t i = 0; i < expired.size(); i++) {
+		Timer *timer = Object::cast_to<Timer>(ObjectDB::get_instance(ObjectID(expired[i].userdata)));
+		if (timer && timer->timeout_pending) {
+			timer->timeout_pending = false;
+			timer->_timeout();
+		}
+	}
+}
+
 void SceneTree::_network_peer_connected(int p_id) {
 	emit_signal("network_peer_connected", p_id);
 }
@@ -1187,6 +1296,9 @@ void SceneTree::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("set_auto_accept_quit", "enabled"), &SceneTree::set_auto_accept_quit);
 	ClassDB::bind_method(D_METHOD("set_quit_on_go_back", "enabled"), &SceneTree::set_quit_on_go_back);
 
+	ClassDB::bind_method(D_METHOD("set_physics_interpolation_enabled", "enabled"), &SceneTree::set_physics_interpolation_enabled);
+	ClassDB::bind_method(D_METHOD("is_physics_interpolation_enabled"), &SceneTree::is_physics_interpolation_enabled);
+
 	ClassDB::bind_method(D_METHOD("set_debug_collisions_hint", "enable"), &SceneTree::set_debug_collisions_hint);
 	ClassDB::bind_method(D_METHOD("is_debugging_collisions_hint"), &SceneTree::is_debugging_collisions_hint);
 	ClassDB::bind_method(D_METHOD("set_debug_navigation_hint", "enable"), &SceneTree::set_debug_navigation_hint);
@@ -1257,6 +1369,7 @@ void SceneTree::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "debug_collisions_hint"), "set_debug_collisions_hint", "is_debugging_collisions_hint");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "debug_navigation_hint"), "set_debug_navigation_hint", "is_debugging_navigation_hint");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "paused"), "set_pause", "is_paused");
+	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "physics_interpolation"), "set_physics_interpolation_enabled", "is_physics_interpolation_enabled");
 	ADD_PROPERTY(PropertyInfo(Variant::BOOL, "refuse_new_network_connections"), "set_refuse_new_network_connections", "is_refusing_new_network_connections");
 	ADD_PROPERTY_DEFAULT("refuse_new_network_connections", false);
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "edited_scene_root", PROPERTY_HINT_RESOURCE_TYPE, "Node", 0), "set_edited_scene_root", "get_edited_scene_root");
@@ -1336,6 +1449,16 @@ void SceneTree::get_argument_options(const StringName &p_function, int p_idx, Li
 	}
 }
 
+ThreadWorkPool *SceneTree::get_cpu_particles_work_pool(int p_particle_count) {
+	if (cpu_particles_threaded_minimum <= 0 || p_particle_count < cpu_particles_threaded_minimum) {
+		return nullptr;
+	}
+	if (cpu_particles_work_pool.get_thread_count() == 0) {
+		cpu_particles_work_pool.init();
+	}
+	return &cpu_particles_work_pool;
+}
+
 SceneTree::SceneTree() {
 	if (singleton == nullptr) {
 		singleton = this;
@@ -1349,6 +1472,13 @@ SceneTree::SceneTree() {
 
 	GLOBAL_DEF("debug/shapes/collision/draw_2d_outlines", true);
 
+	set_physics_interpolation_enabled(GLOBAL_DEF("physics/common/physics_interpolation", false));
+
+	transform_hierarchy_3d.set_use_threads(GLOBAL_DEF("rendering/limits/transform_hierarchy/use_threads", false));
+
+	cpu_particles_threaded_minimum = GLOBAL_DEF("rendering/limits/cpu_particles/threaded_process_minimum_particles", 2048);
+	ProjectSettings::get_singleton()->set_custom_property_info("rendering/limits/cpu_particles/threaded_process_minimum_particles", PropertyInfo(Variant::INT, "rendering/limits/cpu_particles/threaded_process_minimum_particles", PROPERTY_HINT_RANGE, "0,65536,1,or_greater"));
+
 	Math::randomize();
 
 	// Create with mainloop.
@@ -1469,6 +1599,12 @@ SceneTree::~SceneTree() {
 		memdelete(root);
 	}
 
+	for (List<Ref<SceneTreeTimer>>::Element *E = timers.front(); E; E = E->next()) {
+		E->get()->tree = nullptr;
+		E->get()->timer_element = nullptr;
+		E->get()->wheel_entry = TimerWheel::INVALID_ENTRY;
+	}
+
 	if (singleton == this) {
 		singleton = nullptr;
 	}
@@ -35,6 +35,9 @@
 #include "core/os/main_loop.h"
 #include "core/os/thread_safe.h"
 #include "core/templates/self_list.h"
+#include "core/templates/thread_work_pool.h"
+#include "scene/3d/transform_hierarchy_3d.h"
+#include "scene/main/timer_wheel.h"
 #include "scene/resources/mesh.h"
 #include "scene/resources/world_2d.h"
 #include "scene/resources/world_3d.h"
@@ -47,6 +50,7 @@ class Window;
 class Material;
 class Mesh;
 class SceneDebugger;
+class SceneTree;
 
 class SceneTreeTimer : public Reference {
 	GDCLASS(SceneTreeTimer, Reference);
@@ -54,6 +58,14 @@ class SceneTreeTimer : public Reference {
 	float time_left = 0.0;
 	bool process_always = true;
 
+	// Only set while the timer is pending in a SceneTree.
+	SceneTree *tree = nullptr;
+	List<Ref<SceneTreeTimer>>::Element *timer_element = nullptr;
+	uint32_t wheel_entry = TimerWheel::INVALID_ENTRY;
+	bool timeout_pending = false;
+
+	friend class SceneTree;
+
 protected:
 	static void _bind_methods();
 
@@ -96,6 +108,8 @@ private:
 	bool debug_navigation_hint = false;
 #endif
 	bool paused = false;
+	bool physics_interpolation_enabled = false;
+	float physics_jitter_fix_without_interpolation = 0.5;
 	int root_lock = 0;
 
 	Map<StringName, Group> group_map;
@@ -151,6 +165,11 @@ private:
 	//void _call_group(uint32_t p_call_flags,const StringName& p_group,const StringName& p_function,const Variant& p_arg1,const Variant& p_arg2);
 
 	List<Ref<SceneTreeTimer>> timers;
+	TimerWheel timer_wheel; // SceneTreeTimers processed even when paused.
+	TimerWheel pausable_timer_wheel;
+	TimerWheel idle_timer_wheel; // Timer nodes, see Timer::_update_schedule().
+	TimerWheel physics_timer_wheel;
+	LocalVector<TimerWheel::Expired> expired_timers;
 
 	///network///
 
@@ -181,12 +200,24 @@ private:
 	Variant _call_group(const Variant **p_args, int p_argcount, Callable::CallError &r_error);
 
 	void _flush_delete_queue();
+
+	TimerWheel &_get_timer_wheel(bool p_process_always) { return p_process_always ? timer_wheel : pausable_timer_wheel; }
+	void _schedule_timer(SceneTreeTimer *p_timer);
+	void _unschedule_timer(SceneTreeTimer *p_timer);
+	void _process_timers(TimerWheel &p_wheel, float p_time);
+	void _process_node_timers(TimerWheel &p_wheel, float p_time);
 	// Optimization.
 	friend class CanvasItem;
 	friend class Node3D;
 	friend class Viewport;
+	friend class Timer;
+	friend class SceneTreeTimer;
 
 	SelfList<Node>::List xform_change_list;
+	TransformHierarchy3D transform_hierarchy_3d;
+
+	int cpu_particles_threaded_minimum = 2048;
+	ThreadWorkPool cpu_particles_work_pool;
 
 #ifdef DEBUG_ENABLED // No live editor in release build.
 	friend class LiveEditor;
@@ -259,6 +290,9 @@ public:
 	void set_pause(bool p_enabled);
 	bool is_paused() const;
 
+	void set_physics_interpolation_enabled(bool p_enabled);
+	bool is_physics_interpolation_enabled() const { return physics_interpolation_enabled; }
+
 	void set_camera(const RID &p_camera);
 	RID get_camera() const;
 
@@ -324,6 +358,10 @@ public:
 
 	static SceneTree *get_singleton() { return singleton; }
 
+	// Shared by CPU particle emitters to split their simulation in chunks,
+	// returns null when the emitter is too small to be worth dispatching.
+	ThreadWorkPool *get_cpu_particles_work_pool(int p_particle_count);
+
 	void get_argument_options(const StringName &p_function, int p_idx, List<String> *r_options) const override;
 
 	//network API
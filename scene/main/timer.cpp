@@ -31,6 +31,7 @@
 #include "timer.h"
 
 #include "core/config/engine.h"
+#include "scene/main/scene_tree.h"
 
 void Timer::_notification(int p_what) {
 	switch (p_what) {
@@ -45,42 +46,28 @@ void Timer::_notification(int p_what) {
 				autostart = false;
 			}
 		} break;
-		case NOTIFICATION_INTERNAL_PROCESS: {
-			if (!processing || timer_process_callback == TIMER_PROCESS_PHYSICS || !is_processing_internal()) {
-				return;
-			}
-			time_left -= get_process_delta_time();
-
-			if (time_left < 0) {
-				if (!one_shot) {
-					time_left += wait_time;
-				} else {
-					stop();
-				}
-
-				emit_signal("timeout");
-			}
-
+		case NOTIFICATION_ENTER_TREE:
+		case NOTIFICATION_PAUSED:
+		case NOTIFICATION_UNPAUSED: {
+			_update_schedule();
 		} break;
-		case NOTIFICATION_INTERNAL_PHYSICS_PROCESS: {
-			if (!processing || timer_process_callback == TIMER_PROCESS_IDLE || !is_physics_processing_internal()) {
-				return;
-			}
-			time_left -= get_physics_process_delta_time();
-
-			if (time_left < 0) {
-				if (!one_shot) {
-					time_left += wait_time;
-				} else {
-					stop();
-				}
-				emit_signal("timeout");
-			}
-
+		case NOTIFICATION_EXIT_TREE: {
+			_unschedule();
 		} break;
 	}
 }
 
+void Timer::_timeout() {
+	if (!one_shot) {
+		time_left += wait_time;
+		_update_schedule();
+	} else {
+		stop();
+	}
+
+	emit_signal("timeout");
+}
+
 void Timer::set_wait_time(float p_time) {
 	ERR_FAIL_COND_MSG(p_time <= 0, "Time should be greater than zero.");
 	wait_time = p_time;
@@ -113,12 +100,14 @@ void Timer::start(float p_time) {
 		set_wait_time(p_time);
 	}
 	time_left = wait_time;
-	_set_process(true);
+	processing = true;
+	_update_schedule();
 }
 
 void Timer::stop() {
+	_unschedule();
 	time_left = -1;
-	_set_process(false);
+	processing = false;
 	autostart = false;
 }
 
@@ -128,7 +117,7 @@ void Timer::set_paused(bool p_paused) {
 	}
 
 	paused = p_paused;
-	_set_process(processing);
+	_update_schedule();
 }
 
 bool Timer::is_paused() const {
@@ -140,7 +129,8 @@ bool Timer::is_stopped() const {
 }
 
 float Timer::get_time_left() const {
-	return time_left > 0 ? time_left : 0;
+	double left = wheel_entry != TimerWheel::INVALID_ENTRY ? scheduled_wheel->get_time_left(wheel_entry) : time_left;
+	return left > 0 ? left : 0;
 }
 
 void Timer::set_timer_process_callback(TimerProcessCallback p_callback) {
@@ -148,37 +138,40 @@ void Timer::set_timer_process_callback(TimerProcessCallback p_callback) {
 		return;
 	}
 
-	switch (timer_process_callback) {
-		case TIMER_PROCESS_PHYSICS:
-			if (is_physics_processing_internal()) {
-				set_physics_process_internal(false);
-				set_process_internal(true);
-			}
-			break;
-		case TIMER_PROCESS_IDLE:
-			if (is_processing_internal()) {
-				set_process_internal(false);
-				set_physics_process_internal(true);
-			}
-			break;
-	}
 	timer_process_callback = p_callback;
+	_update_schedule();
 }
 
 Timer::TimerProcessCallback Timer::get_timer_process_callback() const {
 	return timer_process_callback;
 }
 
-void Timer::_set_process(bool p_process, bool p_force) {
-	switch (timer_process_callback) {
-		case TIMER_PROCESS_PHYSICS:
-			set_physics_process_internal(p_process && !paused);
-			break;
-		case TIMER_PROCESS_IDLE:
-			set_process_internal(p_process && !paused);
-			break;
+// Instead of being processed every frame, a running timer is scheduled in
+// the SceneTree wheel matching its process callback. It is taken out while
+// it can't process (paused, outside the tree, or its process mode stops it),
+// so the wheel clocks never need to know about pausing.
+void Timer::_update_schedule() {
+	_unschedule();
+
+	if (!processing || paused || !is_inside_tree() || !can_process()) {
+		return;
 	}
-	processing = p_process;
+
+	SceneTree *tree = get_tree();
+	scheduled_wheel = timer_process_callback == TIMER_PROCESS_PHYSICS ? &tree->physics_timer_wheel : &tree->idle_timer_wheel;
+	wheel_entry = scheduled_wheel->schedule(time_left, get_instance_id());
+}
+
+void Timer::_unschedule() {
+	timeout_pending = false;
+	if (wheel_entry == TimerWheel::INVALID_ENTRY) {
+		return;
+	}
+
+	time_left = scheduled_wheel->get_time_left(wheel_entry);
+	scheduled_wheel->cancel(wheel_entry);
+	scheduled_wheel = nullptr;
+	wheel_entry = TimerWheel::INVALID_ENTRY;
 }
 
 void Timer::_bind_methods() {
@@ -32,6 +32,7 @@
 #define TIMER_H
 
 #include "scene/main/node.h"
+#include "scene/main/timer_wheel.h"
 
 class Timer : public Node {
 	GDCLASS(Timer, Node);
@@ -44,6 +45,13 @@ class Timer : public Node {
 
 	double time_left = -1.0;
 
+	// Set while the timer counts down in one of the SceneTree wheels.
+	TimerWheel *scheduled_wheel = nullptr;
+	uint32_t wheel_entry = TimerWheel::INVALID_ENTRY;
+	bool timeout_pending = false;
+
+	friend class SceneTree;
+
 protected:
 	void _notification(int p_what);
 	static void _bind_methods();
@@ -79,7 +87,9 @@ public:
 
 private:
 	TimerProcessCallback timer_process_callback = TIMER_PROCESS_IDLE;
-	void _set_process(bool p_process, bool p_force = false);
+	void _update_schedule();
+	void _unschedule();
+	void _timeout();
 };
 
 VARIANT_ENUM_CAST(Timer::TimerProcessCallback);
@@ -0,0 +1,229 @@
+/*************************************************************************/
+/*  timer_wheel.cpp                                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "timer_wheel.h"
+
+#include "core/error/error_macros.h"
+
+static _FORCE_INLINE_ uint32_t _lowest_bit(uint64_t p_mask) {
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctzll(p_mask);
+#else
+	uint32_t bit = 0;
+	while (!(p_mask & 1)) {
+		p_mask >>= 1;
+		bit++;
+	}
+	return bit;
+#endif
+}
+
+void TimerWheel::_link(uint32_t p_entry) {
+	Entry &e = entries[p_entry];
+
+	if (e.tick <= current_tick) {
+		e.bucket = BUCKET_PENDING;
+	} else {
+		uint64_t tick = e.tick;
+		uint64_t delta = tick - current_tick;
+		if (delta >> (SLOT_BITS * LEVEL_COUNT)) {
+			// Beyond the last level, park it in the furthest slot. It will be
+			// placed again with its real tick when that slot is cascaded.
+			tick = current_tick + (uint64_t(1) << (SLOT_BITS * LEVEL_COUNT)) - 1;
+			delta = tick - current_tick;
+		}
+
+		uint32_t level = 0;
+		while (level < LEVEL_COUNT - 1 && (delta >> (SLOT_BITS * (level + 1)))) {
+			level++;
+		}
+		uint32_t slot = (tick >> (SLOT_BITS * level)) & SLOT_MASK;
+		e.bucket = level * SLOT_COUNT + slot;
+		occupied[level] |= uint64_t(1) << slot;
+	}
+
+	e.prev = INVALID_ENTRY;
+	e.next = buckets[e.bucket];
+	if (e.next != INVALID_ENTRY) {
+		entries[e.next].prev = p_entry;
+	}
+	buckets[e.bucket] = p_entry;
+}
+
+void TimerWheel::_unlink(uint32_t p_entry) {
+	Entry &e = entries[p_entry];
+
+	if (e.prev != INVALID_ENTRY) {
+		entries[e.prev].next = e.next;
+	} else {
+		buckets[e.bucket] = e.next;
+		if (e.next == INVALID_ENTRY && e.bucket < BUCKET_PENDING) {
+			occupied[e.bucket / SLOT_COUNT] &= ~(uint64_t(1) << (e.bucket & SLOT_MASK));
+		}
+	}
+	if (e.next != INVALID_ENTRY) {
+		entries[e.next].prev = e.prev;
+	}
+	e.prev = INVALID_ENTRY;
+	e.next = INVALID_ENTRY;
+}
+
+void TimerWheel::_free(uint32_t p_entry) {
+	Entry &e = entries[p_entry];
+	e.bucket = BUCKET_FREE;
+	e.next = free_entries;
+	free_entries = p_entry;
+	count--;
+}
+
+void TimerWheel::_move_bucket(uint32_t p_bucket) {
+	uint32_t entry = buckets[p_bucket];
+	buckets[p_bucket] = INVALID_ENTRY;
+	if (p_bucket < BUCKET_PENDING) {
+		occupied[p_bucket / SLOT_COUNT] &= ~(uint64_t(1) << (p_bucket & SLOT_MASK));
+	}
+
+	while (entry != INVALID_ENTRY) {
+		uint32_t next = entries[entry].next;
+		_link(entry);
+		entry = next;
+	}
+}
+
+uint32_t TimerWheel::schedule(double p_time_left, uint64_t p_userdata) {
+	uint32_t entry;
+	if (free_entries != INVALID_ENTRY) {
+		entry = free_entries;
+		free_entries = entries[entry].next;
+	} else {
+		entry = entries.size();
+		entries.push_back(Entry());
+	}
+
+	Entry &e = entries[entry];
+	e.deadline = time + p_time_left;
+	e.tick = _get_tick(e.deadline);
+	e.sequence = next_sequence++;
+	e.userdata = p_userdata;
+	_link(entry);
+
+	count++;
+	return entry;
+}
+
+void TimerWheel::cancel(uint32_t p_entry) {
+	ERR_FAIL_UNSIGNED_INDEX(p_entry, entries.size());
+	ERR_FAIL_COND(entries[p_entry].bucket == BUCKET_FREE);
+
+	_unlink(p_entry);
+	_free(p_entry);
+}
+
+double TimerWheel::get_time_left(uint32_t p_entry) const {
+	ERR_FAIL_UNSIGNED_INDEX_V(p_entry, entries.size(), 0.0);
+	ERR_FAIL_COND_V(entries[p_entry].bucket == BUCKET_FREE, 0.0);
+
+	return entries[p_entry].deadline - time;
+}
+
+void TimerWheel::advance(double p_delta, LocalVector<Expired> &r_expired) {
+	r_expired.clear();
+	if (p_delta > 0.0) {
+		time += p_delta;
+	}
+
+	// Walk the ticks up to the current time, stopping only at occupied
+	// level 0 slots and at block boundaries, where upper levels cascade.
+	const uint64_t target = _get_tick(time);
+	while (current_tick < target) {
+		uint64_t tick = current_tick + 1;
+
+		if (!(tick & SLOT_MASK)) {
+			current_tick = tick;
+			for (uint32_t level = LEVEL_COUNT - 1; level > 0; level--) {
+				if (!(tick & ((uint64_t(1) << (SLOT_BITS * level)) - 1))) {
+					_move_bucket(level * SLOT_COUNT + ((tick >> (SLOT_BITS * level)) & SLOT_MASK));
+				}
+			}
+			_move_bucket(tick & SLOT_MASK);
+			continue;
+		}
+
+		const uint64_t block_last = tick | SLOT_MASK;
+		const uint64_t mask = occupied[0] & (~uint64_t(0) << (tick & SLOT_MASK));
+		if (!mask || (tick & ~uint64_t(SLOT_MASK)) + _lowest_bit(mask) > target) {
+			current_tick = MIN(target, block_last);
+			continue;
+		}
+
+		current_tick = (tick & ~uint64_t(SLOT_MASK)) + _lowest_bit(mask);
+		_move_bucket(current_tick & SLOT_MASK);
+	}
+
+	uint32_t entry = buckets[BUCKET_PENDING];
+	while (entry != INVALID_ENTRY) {
+		uint32_t next = entries[entry].next;
+		const Entry &e = entries[entry];
+		if (e.deadline < time) {
+			Expired expired;
+			expired.userdata = e.userdata;
+			expired.time_left = e.deadline - time;
+			expired.sequence = e.sequence;
+			r_expired.push_back(expired);
+
+			_unlink(entry);
+			_free(entry);
+		}
+		entry = next;
+	}
+
+	if (r_expired.size() > 1) {
+		r_expired.sort_custom<ExpiredSort>();
+	}
+}
+
+void TimerWheel::clear() {
+	entries.clear();
+	free_entries = INVALID_ENTRY;
+	for (uint32_t i = 0; i < BUCKET_COUNT; i++) {
+		buckets[i] = INVALID_ENTRY;
+	}
+	for (uint32_t i = 0; i < LEVEL_COUNT; i++) {
+		occupied[i] = 0;
+	}
+	time = 0.0;
+	current_tick = 0;
+	next_sequence = 0;
+	count = 0;
+}
+
+TimerWheel::TimerWheel() {
+	clear();
+}
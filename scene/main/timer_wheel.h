@@ -0,0 +1,127 @@
+/*************************************************************************/
+/*  timer_wheel.h                                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+#include "core/templates/local_vector.h"
+
+// Hierarchical timing wheel. Each wheel has its own clock, which only moves
+// when advance() is called, and scheduling, cancelling and advancing cost
+// does not depend on how many timers are pending, only on how many expire.
+class TimerWheel {
+public:
+	enum {
+		INVALID_ENTRY = 0xFFFFFFFF,
+	};
+
+	struct Expired {
+		uint64_t userdata = 0;
+		double time_left = 0.0; // Negative, by how much the deadline was passed.
+		uint64_t sequence = 0;
+	};
+
+private:
+	enum {
+		TICKS_PER_SECOND = 256,
+		SLOT_BITS = 6,
+		SLOT_COUNT = 1 << SLOT_BITS,
+		SLOT_MASK = SLOT_COUNT - 1,
+		LEVEL_COUNT = 4,
+		// Entries whose tick was reached, but not their exact deadline.
+		BUCKET_PENDING = LEVEL_COUNT * SLOT_COUNT,
+		BUCKET_COUNT,
+		BUCKET_FREE = BUCKET_COUNT,
+	};
+
+	struct Entry {
+		double deadline = 0.0;
+		uint64_t tick = 0;
+		uint64_t sequence = 0;
+		uint64_t userdata = 0;
+		uint32_t prev = INVALID_ENTRY;
+		uint32_t next = INVALID_ENTRY;
+		uint32_t bucket = BUCKET_FREE;
+	};
+
+	struct ExpiredSort {
+		_FORCE_INLINE_ bool operator()(const Expired &p_a, const Expired &p_b) const {
+			if (p_a.time_left != p_b.time_left) {
+				return p_a.time_left < p_b.time_left;
+			}
+			return p_a.sequence < p_b.sequence;
+		}
+	};
+
+	LocalVector<Entry> entries;
+	uint32_t free_entries = INVALID_ENTRY;
+	uint32_t buckets[BUCKET_COUNT];
+	uint64_t occupied[LEVEL_COUNT];
+
+	double time = 0.0;
+	uint64_t current_tick = 0;
+	uint64_t next_sequence = 0;
+	uint32_t count = 0;
+
+	// Converting a time beyond the range of uint64_t (or infinite) is
+	// undefined, so it is clamped to a tick that is never reached.
+	_FORCE_INLINE_ static uint64_t _get_tick(double p_time) {
+		const uint64_t max_tick = uint64_t(1) << 52;
+		if (!(p_time > 0.0)) {
+			return 0;
+		}
+		const double tick = p_time * TICKS_PER_SECOND;
+		return tick < double(max_tick) ? uint64_t(tick) : max_tick;
+	}
+
+	void _link(uint32_t p_entry);
+	void _unlink(uint32_t p_entry);
+	void _free(uint32_t p_entry);
+	void _move_bucket(uint32_t p_bucket);
+
+public:
+	// Returns a handle to cancel the timer, valid until it expires.
+	uint32_t schedule(double p_time_left, uint64_t p_userdata);
+	void cancel(uint32_t p_entry);
+	double get_time_left(uint32_t p_entry) const;
+
+	// Moves the clock forward, and fills r_expired with the timers whose
+	// deadline is now in the past, earliest first. Their handles are freed.
+	void advance(double p_delta, LocalVector<Expired> &r_expired);
+
+	_FORCE_INLINE_ double get_time() const { return time; }
+	_FORCE_INLINE_ uint32_t get_count() const { return count; }
+
+	void clear();
+
+	TimerWheel();
+};
+
+#endif // TIMER_WHEEL_H
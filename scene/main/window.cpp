@@ -1105,13 +1105,18 @@ Rect2i Window::get_usable_parent_rect() const {
 
 void Window::add_child_notify(Node *p_child) {
 	Control *child_c = Object::cast_to<Control>(p_child);
+	Window *child_w = Object::cast_to<Window>(p_child);
+
+	if ((child_c && child_c->data.theme.is_valid()) || (child_w && child_w->theme.is_valid())) {
+		// Not propagated, but items missing from the child's theme now
+		// resolve through this node.
+		Control::_invalidate_theme_cache(p_child);
+	}
 
 	if (child_c && child_c->data.theme.is_null() && (theme_owner || theme_owner_window)) {
 		Control::_propagate_theme_changed(child_c, theme_owner, theme_owner_window); //need to propagate here, since many controls may require setting up stuff
 	}
 
-	Window *child_w = Object::cast_to<Window>(p_child);
-
 	if (child_w && child_w->theme.is_null() && (theme_owner || theme_owner_window)) {
 		Control::_propagate_theme_changed(child_w, theme_owner, theme_owner_window); //need to propagate here, since many controls may require setting up stuff
 	}
@@ -1123,13 +1128,16 @@ void Window::add_child_notify(Node *p_child) {
 
 void Window::remove_child_notify(Node *p_child) {
 	Control *child_c = Object::cast_to<Control>(p_child);
+	Window *child_w = Object::cast_to<Window>(p_child);
+
+	if ((child_c && child_c->data.theme.is_valid()) || (child_w && child_w->theme.is_valid())) {
+		Control::_invalidate_theme_cache(p_child);
+	}
 
 	if (child_c && (child_c->data.theme_owner || child_c->data.theme_owner_window) && child_c->data.theme.is_null()) {
 		Control::_propagate_theme_changed(child_c, nullptr, nullptr);
 	}
 
-	Window *child_w = Object::cast_to<Window>(p_child);
-
 	if (child_w && (child_w->theme_owner || child_w->theme_owner_window) && child_w->theme.is_null()) {
 		Control::_propagate_theme_changed(child_w, nullptr, nullptr);
 	}
@@ -1144,6 +1152,10 @@ void Window::set_theme(const Ref<Theme> &p_theme) {
 		return;
 	}
 
+	if (theme.is_valid()) {
+		theme->disconnect("changed", callable_mp(this, &Window::_theme_changed));
+	}
+
 	theme = p_theme;
 
 	if (!p_theme.is_null()) {
@@ -1163,6 +1175,15 @@ void Window::set_theme(const Ref<Theme> &p_theme) {
 			}
 		}
 	}
+
+	if (theme.is_valid()) {
+		theme->connect("changed", callable_mp(this, &Window::_theme_changed));
+	}
+}
+
+void Window::_theme_changed() {
+	// Controls below resolve their items through this theme.
+	Control::_invalidate_theme_cache(this);
 }
 
 Ref<Theme> Window::get_theme() const {
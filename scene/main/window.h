@@ -122,6 +122,7 @@ private:
 
 	void _clear_transient();
 	void _make_transient();
+	void _theme_changed();
 	Window *transient_parent = nullptr;
 	Window *exclusive_child = nullptr;
 	Set<Window *> transient_children;
@@ -1037,5 +1037,6 @@ void unregister_scene_types() {
 	ParticlesMaterial::finish_shaders();
 	CanvasItemMaterial::finish_shaders();
 	ColorPicker::finish_shaders();
+	TileMap::finish_work_pool();
 	SceneStringNames::free();
 }
@@ -93,16 +93,16 @@ bool SurfaceTool::Vertex::operator==(const Vertex &p_vertex) const {
 }
 
 uint32_t SurfaceTool::VertexHasher::hash(const Vertex &p_vtx) {
-	uint32_t h = hash_djb2_buffer((const uint8_t *)&p_vtx.vertex, sizeof(real_t) * 3);
-	h = hash_djb2_buffer((const uint8_t *)&p_vtx.normal, sizeof(real_t) * 3, h);
-	h = hash_djb2_buffer((const uint8_t *)&p_vtx.binormal, sizeof(real_t) * 3, h);
-	h = hash_djb2_buffer((const uint8_t *)&p_vtx.tangent, sizeof(real_t) * 3, h);
-	h = hash_djb2_buffer((const uint8_t *)&p_vtx.uv, sizeof(real_t) * 2, h);
-	h = hash_djb2_buffer((const uint8_t *)&p_vtx.uv2, sizeof(real_t) * 2, h);
-	h = hash_djb2_buffer((const uint8_t *)&p_vtx.color, sizeof(real_t) * 4, h);
-	h = hash_djb2_buffer((const uint8_t *)p_vtx.bones.ptr(), p_vtx.bones.size() * sizeof(int), h);
-	h = hash_djb2_buffer((const uint8_t *)p_vtx.weights.ptr(), p_vtx.weights.size() * sizeof(float), h);
-	h = hash_djb2_buffer((const uint8_t *)&p_vtx.custom[0], sizeof(Color) * RS::ARRAY_CUSTOM_COUNT, h);
+	uint32_t h = hash_murmur3_buffer((const uint8_t *)&p_vtx.vertex, sizeof(real_t) * 3);
+	h = hash_murmur3_buffer((const uint8_t *)&p_vtx.normal, sizeof(real_t) * 3, h);
+	h = hash_murmur3_buffer((const uint8_t *)&p_vtx.binormal, sizeof(real_t) * 3, h);
+	h = hash_murmur3_buffer((const uint8_t *)&p_vtx.tangent, sizeof(real_t) * 3, h);
+	h = hash_murmur3_buffer((const uint8_t *)&p_vtx.uv, sizeof(real_t) * 2, h);
+	h = hash_murmur3_buffer((const uint8_t *)&p_vtx.uv2, sizeof(real_t) * 2, h);
+	h = hash_murmur3_buffer((const uint8_t *)&p_vtx.color, sizeof(real_t) * 4, h);
+	h = hash_murmur3_buffer((const uint8_t *)p_vtx.bones.ptr(), p_vtx.bones.size() * sizeof(int), h);
+	h = hash_murmur3_buffer((const uint8_t *)p_vtx.weights.ptr(), p_vtx.weights.size() * sizeof(float), h);
+	h = hash_murmur3_buffer((const uint8_t *)&p_vtx.custom[0], sizeof(Color) * RS::ARRAY_CUSTOM_COUNT, h);
 	h = hash_djb2_one_32(p_vtx.smooth_group, h);
 	return h;
 }
@@ -31,11 +31,26 @@
 #include "theme.h"
 #include "core/os/file_access.h"
 #include "core/string/print_string.h"
+#include "scene/gui/control.h"
+#include "scene/main/scene_tree.h"
+#include "scene/main/window.h"
 
 void Theme::_emit_theme_changed() {
 	emit_changed();
 }
 
+void Theme::_invalidate_scene_theme_caches() {
+	// Controls also cache the items they resolved through the default themes and values.
+	SceneTree *tree = SceneTree::get_singleton();
+	if (tree && tree->get_root()) {
+		Control::_invalidate_theme_cache(tree->get_root());
+	}
+}
+
+void Theme::_default_theme_changed() {
+	_invalidate_scene_theme_caches();
+}
+
 Vector<String> Theme::_get_icon_list(const String &p_node_type) const {
 	Vector<String> ilret;
 	List<StringName> il;
@@ -450,7 +465,20 @@ Ref<Theme> Theme::get_default() {
 }
 
 void Theme::set_default(const Ref<Theme> &p_default) {
+	if (default_theme == p_default) {
+		return;
+	}
+
+	if (default_theme.is_valid()) {
+		default_theme->disconnect("changed", callable_mp(default_theme.ptr(), &Theme::_default_theme_changed));
+	}
+
 	default_theme = p_default;
+
+	if (default_theme.is_valid()) {
+		default_theme->connect("changed", callable_mp(default_theme.ptr(), &Theme::_default_theme_changed), varray(), CONNECT_REFERENCE_COUNTED);
+	}
+	_invalidate_scene_theme_caches();
 }
 
 Ref<Theme> Theme::get_project_default() {
@@ -458,23 +486,40 @@ Ref<Theme> Theme::get_project_default() {
 }
 
 void Theme::set_project_default(const Ref<Theme> &p_project_default) {
+	if (project_default_theme == p_project_default) {
+		return;
+	}
+
+	if (project_default_theme.is_valid()) {
+		project_default_theme->disconnect("changed", callable_mp(project_default_theme.ptr(), &Theme::_default_theme_changed));
+	}
+
 	project_default_theme = p_project_default;
+
+	if (project_default_theme.is_valid()) {
+		project_default_theme->connect("changed", callable_mp(project_default_theme.ptr(), &Theme::_default_theme_changed), varray(), CONNECT_REFERENCE_COUNTED);
+	}
+	_invalidate_scene_theme_caches();
 }
 
 void Theme::set_default_icon(const Ref<Texture2D> &p_icon) {
 	default_icon = p_icon;
+	_invalidate_scene_theme_caches();
 }
 
 void Theme::set_default_style(const Ref<StyleBox> &p_style) {
 	default_style = p_style;
+	_invalidate_scene_theme_caches();
 }
 
 void Theme::set_default_font(const Ref<Font> &p_font) {
 	default_font = p_font;
+	_invalidate_scene_theme_caches();
 }
 
 void Theme::set_default_font_size(int p_font_size) {
 	default_font_size = p_font_size;
+	_invalidate_scene_theme_caches();
 }
 
 void Theme::set_icon(const StringName &p_name, const StringName &p_node_type, const Ref<Texture2D> &p_icon) {
@@ -492,8 +537,8 @@ void Theme::set_icon(const StringName &p_name, const StringName &p_node_type, co
 
 	if (new_value) {
 		notify_property_list_changed();
-		emit_changed();
 	}
+	emit_changed();
 }
 
 Ref<Texture2D> Theme::get_icon(const StringName &p_name, const StringName &p_node_type) const {
@@ -668,8 +713,8 @@ void Theme::set_font(const StringName &p_name, const StringName &p_node_type, co
 
 	if (new_value) {
 		notify_property_list_changed();
-		emit_changed();
 	}
+	emit_changed();
 }
 
 Ref<Font> Theme::get_font(const StringName &p_name, const StringName &p_node_type) const {
@@ -749,8 +794,8 @@ void Theme::set_font_size(const StringName &p_name, const StringName &p_node_typ
 
 	if (new_value) {
 		notify_property_list_changed();
-		emit_changed();
 	}
+	emit_changed();
 }
 
 int Theme::get_font_size(const StringName &p_name, const StringName &p_node_type) const {
@@ -826,8 +871,8 @@ void Theme::set_color(const StringName &p_name, const StringName &p_node_type, c
 
 	if (new_value) {
 		notify_property_list_changed();
-		emit_changed();
 	}
+	emit_changed();
 }
 
 Color Theme::get_color(const StringName &p_name, const StringName &p_node_type) const {
@@ -900,8 +945,8 @@ void Theme::set_constant(const StringName &p_name, const StringName &p_node_type
 
 	if (new_value) {
 		notify_property_list_changed();
-		emit_changed();
 	}
+	emit_changed();
 }
 
 int Theme::get_constant(const StringName &p_name, const StringName &p_node_type) const {
@@ -55,6 +55,9 @@ public:
 private:
 	void _emit_theme_changed();
 
+	static void _invalidate_scene_theme_caches();
+	void _default_theme_changed();
+
 	HashMap<StringName, HashMap<StringName, Ref<Texture2D>>> icon_map;
 	HashMap<StringName, HashMap<StringName, Ref<StyleBox>>> style_map;
 	HashMap<StringName, HashMap<StringName, Ref<Font>>> font_map;
@@ -3672,6 +3672,56 @@ void TileSetAtlasPluginRendering::tilemap_notification(TileMap *p_tile_map, int
 	}
 }
 
+static constexpr float fp_adjust = 0.00001;
+
+static bool _prepare_tile(TileMapQuadrant::PreparedTile &r_tile, Vector2i p_position, const TileSetAtlasSource *p_atlas_source, Vector2i p_atlas_coords, int p_alternative_tile, Color p_modulation) {
+	// Get the texture.
+	Ref<Texture2D> tex = p_atlas_source->get_texture();
+	if (!tex.is_valid()) {
+		return false;
+	}
+
+	// Get tile data.
+	TileData *tile_data = Object::cast_to<TileData>(p_atlas_source->get_tile_data(p_atlas_coords, p_alternative_tile));
+
+	// Compute the offset
+	Rect2i source_rect = p_atlas_source->get_tile_texture_region(p_atlas_coords);
+	Vector2i tile_offset = p_atlas_source->get_tile_effective_texture_offset(p_atlas_coords, p_alternative_tile);
+
+	// Compute the destination rectangle in the CanvasItem.
+	Rect2 dest_rect;
+	dest_rect.size = source_rect.size;
+	dest_rect.size.x += fp_adjust;
+	dest_rect.size.y += fp_adjust;
+
+	bool transpose = tile_data->get_transpose();
+	if (transpose) {
+		dest_rect.position = (p_position - Vector2(dest_rect.size.y, dest_rect.size.x) / 2 - tile_offset);
+	} else {
+		dest_rect.position = (p_position - dest_rect.size / 2 - tile_offset);
+	}
+
+	if (tile_data->get_flip_h()) {
+		dest_rect.size.x = -dest_rect.size.x;
+	}
+
+	if (tile_data->get_flip_v()) {
+		dest_rect.size.y = -dest_rect.size.y;
+	}
+
+	// Get the tile modulation.
+	Color modulate = tile_data->get_modulate();
+	modulate = Color(modulate.r * p_modulation.r, modulate.g * p_modulation.g, modulate.b * p_modulation.b, modulate.a * p_modulation.a);
+
+	// The atlas source keeps a reference to the texture.
+	r_tile.texture = tex.ptr();
+	r_tile.dest_rect = dest_rect;
+	r_tile.source_rect = source_rect;
+	r_tile.modulate = modulate;
+	r_tile.transpose = transpose;
+	return true;
+}
+
 void TileSetAtlasPluginRendering::draw_tile(RID p_canvas_item, Vector2i p_position, const Ref<TileSet> p_tile_set, int p_atlas_source_id, Vector2i p_atlas_coords, int p_alternative_tile, Color p_modulation) {
 	ERR_FAIL_COND(!p_tile_set.is_valid());
 	ERR_FAIL_COND(!p_tile_set->has_source(p_atlas_source_id));
@@ -3681,46 +3731,73 @@ void TileSetAtlasPluginRendering::draw_tile(RID p_canvas_item, Vector2i p_positi
 	TileSetSource *source = *p_tile_set->get_source(p_atlas_source_id);
 	TileSetAtlasSource *atlas_source = Object::cast_to<TileSetAtlasSource>(source);
 	if (atlas_source) {
-		// Get the texture.
-		Ref<Texture2D> tex = atlas_source->get_texture();
-		if (!tex.is_valid()) {
-			return;
+		TileMapQuadrant::PreparedTile tile;
+		if (_prepare_tile(tile, p_position, atlas_source, p_atlas_coords, p_alternative_tile, p_modulation)) {
+			// Draw the tile.
+			tile.texture->draw_rect_region(p_canvas_item, tile.dest_rect, tile.source_rect, tile.modulate, tile.transpose, p_tile_set->is_uv_clipping());
 		}
+	}
+}
 
-		// Get tile data.
-		TileData *tile_data = Object::cast_to<TileData>(atlas_source->get_tile_data(p_atlas_coords, p_alternative_tile));
+void TileSetAtlasPluginRendering::prepare_quadrant(TileMap *p_tile_map, TileMapQuadrant *p_quadrant) {
+	Ref<TileSet> tile_set = p_tile_map->get_tileset();
+	ERR_FAIL_COND(!tile_set.is_valid());
 
-		// Compute the offset
-		Rect2i source_rect = atlas_source->get_tile_texture_region(p_atlas_coords);
-		Vector2i tile_offset = atlas_source->get_tile_effective_texture_offset(p_atlas_coords, p_alternative_tile);
+	TileMapQuadrant &q = *p_quadrant;
+	q.prepared_canvas_items.clear();
+	q.prepared_tiles.clear();
+	q.prepared_occluders.clear();
 
-		// Compute the destination rectangle in the CanvasItem.
-		Rect2 dest_rect;
-		dest_rect.size = source_rect.size;
-		dest_rect.size.x += fp_adjust;
-		dest_rect.size.y += fp_adjust;
+	// Quandrant pos.
+	Vector2 position = p_tile_map->map_to_world(q.coords * p_tile_map->get_effective_quadrant_size()) - tile_set->get_tile_size() / 2;
+	Color self_modulate = p_tile_map->get_self_modulate();
 
-		bool transpose = tile_data->get_transpose();
-		if (transpose) {
-			dest_rect.position = (p_position - Vector2(dest_rect.size.y, dest_rect.size.x) / 2 - tile_offset);
-		} else {
-			dest_rect.position = (p_position - dest_rect.size / 2 - tile_offset);
+	// Iterate over the cells of the quadrant.
+	for (Map<Vector2i, Vector2i, TileMapQuadrant::CoordsWorldComparator>::Element *E_cell = q.world_to_map.front(); E_cell; E_cell = E_cell->next()) {
+		TileMapCell c = p_tile_map->get_cell(E_cell->value());
+
+		if (!tile_set->has_source(c.source_id)) {
+			continue;
+		}
+		TileSetSource *source = *tile_set->get_source(c.source_id);
+		if (!source->has_tile(c.get_atlas_coords()) || !source->has_alternative_tile(c.get_atlas_coords(), c.alternative_tile)) {
+			continue;
 		}
 
-		if (tile_data->get_flip_h()) {
-			dest_rect.size.x = -dest_rect.size.x;
+		TileSetAtlasSource *atlas_source = Object::cast_to<TileSetAtlasSource>(source);
+		if (!atlas_source) {
+			continue;
 		}
 
-		if (tile_data->get_flip_v()) {
-			dest_rect.size.y = -dest_rect.size.y;
+		// Get the tile data.
+		TileData *tile_data = Object::cast_to<TileData>(atlas_source->get_tile_data(c.get_atlas_coords(), c.alternative_tile));
+		const ShaderMaterial *material = tile_data->tile_get_material().ptr();
+		int z_index = tile_data->get_z_index();
+
+		// Group cells per material and z-index, a new canvas item starts whenever one of them changes.
+		if (q.prepared_canvas_items.is_empty() || q.prepared_canvas_items[q.prepared_canvas_items.size() - 1].material != material || q.prepared_canvas_items[q.prepared_canvas_items.size() - 1].z_index != z_index) {
+			TileMapQuadrant::PreparedCanvasItem canvas_item;
+			canvas_item.material = material;
+			canvas_item.z_index = z_index;
+			q.prepared_canvas_items.push_back(canvas_item);
 		}
 
-		// Get the tile modulation.
-		Color modulate = tile_data->get_modulate();
-		modulate = Color(modulate.r * p_modulation.r, modulate.g * p_modulation.g, modulate.b * p_modulation.b, modulate.a * p_modulation.a);
+		TileMapQuadrant::PreparedTile tile;
+		if (_prepare_tile(tile, E_cell->key() - position, atlas_source, c.get_atlas_coords(), c.alternative_tile, self_modulate)) {
+			q.prepared_tiles.push_back(tile);
+			q.prepared_canvas_items[q.prepared_canvas_items.size() - 1].tile_count++;
+		}
 
-		// Draw the tile.
-		tex->draw_rect_region(p_canvas_item, dest_rect, source_rect, modulate, transpose, p_tile_set->is_uv_clipping());
+		// --- Occluders ---
+		for (int i = 0; i < tile_set->get_occlusion_layers_count(); i++) {
+			if (tile_data->get_occluder(i).is_valid()) {
+				TileMapQuadrant::PreparedOccluder occluder;
+				occluder.position = E_cell->key();
+				occluder.polygon = tile_data->get_occluder(i)->get_rid();
+				occluder.light_mask = tile_set->get_occlusion_layer_light_mask(i);
+				q.prepared_occluders.push_back(occluder);
+			}
+		}
 	}
 }
 
@@ -3731,17 +3808,20 @@ void TileSetAtlasPluginRendering::update_dirty_quadrants(TileMap *p_tile_map, Se
 	ERR_FAIL_COND(!tile_set.is_valid());
 
 	bool visible = p_tile_map->is_visible_in_tree();
+	bool use_parent_material = p_tile_map->get_use_parent_material() || p_tile_map->get_material().is_valid();
+	bool uv_clipping = tile_set->is_uv_clipping();
+	Transform2D global_transform = p_tile_map->get_global_transform();
+	RenderingServer *rs = RenderingServer::get_singleton();
 
+	// The cells were grouped into canvas items by prepare_quadrant(), only the server calls are left.
 	SelfList<TileMapQuadrant> *q_list_element = r_dirty_quadrant_list.first();
 	while (q_list_element) {
 		TileMapQuadrant &q = *q_list_element->self();
 
-		RenderingServer *rs = RenderingServer::get_singleton();
-
-		// Free the canvas items.
-		for (List<RID>::Element *E = q.canvas_items.front(); E; E = E->next()) {
-			rs->free(E->get());
-		}
+		// Keep the previous canvas items, they are cleared and reused in order below.
+		// As long as the quadrant needs as many canvas items as before, their draw index stays valid.
+		List<RID> previous_canvas_items = q.canvas_items;
+		List<RID>::Element *E_reused_canvas_item = previous_canvas_items.front();
 		q.canvas_items.clear();
 
 		// Free the occluders.
@@ -3750,88 +3830,69 @@ void TileSetAtlasPluginRendering::update_dirty_quadrants(TileMap *p_tile_map, Se
 		}
 		q.occluders.clear();
 
-		// Those allow to group cell per material or z-index.
-		Ref<ShaderMaterial> prev_material;
-		int prev_z_index = 0;
-		RID prev_canvas_item;
-
-		// Iterate over the cells of the quadrant.
-		for (Map<Vector2i, Vector2i, TileMapQuadrant::CoordsWorldComparator>::Element *E_cell = q.world_to_map.front(); E_cell; E_cell = E_cell->next()) {
-			TileMapCell c = p_tile_map->get_cell(E_cell->value());
-
-			TileSetSource *source;
-			if (tile_set->has_source(c.source_id)) {
-				source = *tile_set->get_source(c.source_id);
-
-				if (!source->has_tile(c.get_atlas_coords()) || !source->has_alternative_tile(c.get_atlas_coords(), c.alternative_tile)) {
-					continue;
-				}
-
-				TileSetAtlasSource *atlas_source = Object::cast_to<TileSetAtlasSource>(source);
-				if (atlas_source) {
-					// Get the tile data.
-					TileData *tile_data = Object::cast_to<TileData>(atlas_source->get_tile_data(c.get_atlas_coords(), c.alternative_tile));
-					Ref<ShaderMaterial> mat = tile_data->tile_get_material();
-					int z_index = tile_data->get_z_index();
-
-					// Quandrant pos.
-					Vector2 position = p_tile_map->map_to_world(q.coords * p_tile_map->get_effective_quadrant_size()) - tile_set->get_tile_size() / 2;
+		// Quandrant pos.
+		Vector2 position = p_tile_map->map_to_world(q.coords * p_tile_map->get_effective_quadrant_size()) - tile_set->get_tile_size() / 2;
+		Transform2D xform;
+		xform.set_origin(position);
 
-					// --- CanvasItems ---
-					// Create two canvas items, for rendering and debug.
-					RID canvas_item;
+		const TileMapQuadrant::PreparedTile *tile = q.prepared_tiles.ptr();
+		for (uint32_t i = 0; i < q.prepared_canvas_items.size(); i++) {
+			const TileMapQuadrant::PreparedCanvasItem &prepared = q.prepared_canvas_items[i];
 
-					// Check if the material or the z_index changed.
-					if (prev_canvas_item == RID() || prev_material != mat || prev_z_index != z_index) {
-						canvas_item = rs->canvas_item_create();
-						if (mat.is_valid()) {
-							rs->canvas_item_set_material(canvas_item, mat->get_rid());
-						}
-						rs->canvas_item_set_parent(canvas_item, p_tile_map->get_canvas_item());
-						rs->canvas_item_set_use_parent_material(canvas_item, p_tile_map->get_use_parent_material() || p_tile_map->get_material().is_valid());
-						Transform2D xform;
-						xform.set_origin(position);
+			RID canvas_item;
+			if (E_reused_canvas_item) {
+				canvas_item = E_reused_canvas_item->get();
+				E_reused_canvas_item = E_reused_canvas_item->next();
+				rs->canvas_item_clear(canvas_item);
+			} else {
+				canvas_item = rs->canvas_item_create();
+			}
+			rs->canvas_item_set_material(canvas_item, prepared.material ? prepared.material->get_rid() : RID());
+			rs->canvas_item_set_parent(canvas_item, p_tile_map->get_canvas_item());
+			rs->canvas_item_set_use_parent_material(canvas_item, use_parent_material);
+			rs->canvas_item_set_transform(canvas_item, xform);
+			rs->canvas_item_set_light_mask(canvas_item, p_tile_map->get_light_mask());
+			rs->canvas_item_set_z_index(canvas_item, prepared.z_index);
 
-						rs->canvas_item_set_transform(canvas_item, xform);
-						rs->canvas_item_set_light_mask(canvas_item, p_tile_map->get_light_mask());
-						rs->canvas_item_set_z_index(canvas_item, z_index);
+			rs->canvas_item_set_default_texture_filter(canvas_item, RS::CanvasItemTextureFilter(p_tile_map->CanvasItem::get_texture_filter()));
+			rs->canvas_item_set_default_texture_repeat(canvas_item, RS::CanvasItemTextureRepeat(p_tile_map->CanvasItem::get_texture_repeat()));
 
-						rs->canvas_item_set_default_texture_filter(canvas_item, RS::CanvasItemTextureFilter(p_tile_map->CanvasItem::get_texture_filter()));
-						rs->canvas_item_set_default_texture_repeat(canvas_item, RS::CanvasItemTextureRepeat(p_tile_map->CanvasItem::get_texture_repeat()));
+			q.canvas_items.push_back(canvas_item);
 
-						q.canvas_items.push_back(canvas_item);
+			// Draw the tiles in the canvas item.
+			for (uint32_t j = 0; j < prepared.tile_count; j++, tile++) {
+				tile->texture->draw_rect_region(canvas_item, tile->dest_rect, tile->source_rect, tile->modulate, tile->transpose, uv_clipping);
+			}
+		}
 
-						prev_canvas_item = canvas_item;
-						prev_material = mat;
-						prev_z_index = z_index;
+		// --- Occluders ---
+		for (uint32_t i = 0; i < q.prepared_occluders.size(); i++) {
+			const TileMapQuadrant::PreparedOccluder &prepared = q.prepared_occluders[i];
+			Transform2D occluder_xform;
+			occluder_xform.set_origin(prepared.position);
+
+			RID occluder_id = rs->canvas_light_occluder_create();
+			rs->canvas_light_occluder_set_enabled(occluder_id, visible);
+			rs->canvas_light_occluder_set_transform(occluder_id, global_transform * occluder_xform);
+			rs->canvas_light_occluder_set_polygon(occluder_id, prepared.polygon);
+			rs->canvas_light_occluder_attach_to_canvas(occluder_id, p_tile_map->get_canvas());
+			rs->canvas_light_occluder_set_light_mask(occluder_id, prepared.light_mask);
+			q.occluders.push_back(occluder_id);
+		}
 
-					} else {
-						// Keep the same canvas_item to draw on.
-						canvas_item = prev_canvas_item;
-					}
+		// The prepared data is only needed until it is committed.
+		q.prepared_canvas_items.clear();
+		q.prepared_tiles.clear();
+		q.prepared_occluders.clear();
 
-					// Drawing the tile in the canvas item.
-					draw_tile(canvas_item, E_cell->key() - position, tile_set, c.source_id, c.get_atlas_coords(), c.alternative_tile, p_tile_map->get_self_modulate());
-
-					// --- Occluders ---
-					for (int i = 0; i < tile_set->get_occlusion_layers_count(); i++) {
-						Transform2D xform;
-						xform.set_origin(E_cell->key());
-						if (tile_data->get_occluder(i).is_valid()) {
-							RID occluder_id = rs->canvas_light_occluder_create();
-							rs->canvas_light_occluder_set_enabled(occluder_id, visible);
-							rs->canvas_light_occluder_set_transform(occluder_id, p_tile_map->get_global_transform() * xform);
-							rs->canvas_light_occluder_set_polygon(occluder_id, tile_data->get_occluder(i)->get_rid());
-							rs->canvas_light_occluder_attach_to_canvas(occluder_id, p_tile_map->get_canvas());
-							rs->canvas_light_occluder_set_light_mask(occluder_id, tile_set->get_occlusion_layer_light_mask(i));
-							q.occluders.push_back(occluder_id);
-						}
-					}
-				}
-			}
+		// Free the canvas items that were not reused.
+		for (List<RID>::Element *E = E_reused_canvas_item; E; E = E->next()) {
+			rs->free(E->get());
 		}
 
-		quadrant_order_dirty = true;
+		if (q.canvas_items.size() != previous_canvas_items.size()) {
+			quadrant_order_dirty = true;
+		}
 		q_list_element = q_list_element->next();
 	}
 
@@ -3841,7 +3902,7 @@ void TileSetAtlasPluginRendering::update_dirty_quadrants(TileMap *p_tile_map, Se
 
 		// Sort the quadrants coords per world coordinates
 		Map<Vector2i, Vector2i, TileMapQuadrant::CoordsWorldComparator> world_to_map;
-		Map<Vector2i, TileMapQuadrant> quadrant_map = p_tile_map->get_quadrant_map();
+		Map<Vector2i, TileMapQuadrant> &quadrant_map = p_tile_map->get_quadrant_map();
 		for (Map<Vector2i, TileMapQuadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
 			world_to_map[p_tile_map->map_to_world(E->key())] = E->key();
 		}
@@ -3886,7 +3947,7 @@ void TileSetAtlasPluginPhysics::tilemap_notification(TileMap *p_tile_map, int p_
 		case CanvasItem::NOTIFICATION_TRANSFORM_CHANGED: {
 			// Update the bodies transforms.
 			if (p_tile_map->is_inside_tree()) {
-				Map<Vector2i, TileMapQuadrant> quadrant_map = p_tile_map->get_quadrant_map();
+				Map<Vector2i, TileMapQuadrant> &quadrant_map = p_tile_map->get_quadrant_map();
 				Transform2D global_transform = p_tile_map->get_global_transform();
 
 				for (Map<Vector2i, TileMapQuadrant>::Element *E = quadrant_map.front(); E; E = E->next()) {
@@ -3905,6 +3966,51 @@ void TileSetAtlasPluginPhysics::tilemap_notification(TileMap *p_tile_map, int p_
 	}
 }
 
+void TileSetAtlasPluginPhysics::prepare_quadrant(TileMap *p_tile_map, TileMapQuadrant *p_quadrant) {
+	Ref<TileSet> tile_set = p_tile_map->get_tileset();
+	ERR_FAIL_COND(!tile_set.is_valid());
+
+	TileMapQuadrant &q = *p_quadrant;
+	q.prepared_shapes.clear();
+
+	Vector2 quadrant_pos = p_tile_map->map_to_world(q.coords * p_tile_map->get_effective_quadrant_size());
+
+	for (Set<Vector2i>::Element *E_cell = q.cells.front(); E_cell; E_cell = E_cell->next()) {
+		TileMapCell c = p_tile_map->get_cell(E_cell->get());
+
+		if (!tile_set->has_source(c.source_id)) {
+			continue;
+		}
+		TileSetSource *source = *tile_set->get_source(c.source_id);
+		if (!source->has_tile(c.get_atlas_coords()) || !source->has_alternative_tile(c.get_atlas_coords(), c.alternative_tile)) {
+			continue;
+		}
+
+		TileSetAtlasSource *atlas_source = Object::cast_to<TileSetAtlasSource>(source);
+		if (!atlas_source) {
+			continue;
+		}
+
+		TileData *tile_data = Object::cast_to<TileData>(atlas_source->get_tile_data(c.get_atlas_coords(), c.alternative_tile));
+		for (int body_index = 0; body_index < q.bodies.size(); body_index++) {
+			for (int shape_index = 0; shape_index < tile_data->get_collision_shapes_count(body_index); shape_index++) {
+				Ref<Shape2D> shape = tile_data->get_collision_shape_shape(body_index, shape_index);
+				if (shape.is_valid()) {
+					TileMapQuadrant::PreparedShape prepared;
+					prepared.body_index = body_index;
+					prepared.shape_index = shape_index;
+					prepared.shape = shape->get_rid();
+					prepared.position = p_tile_map->map_to_world(E_cell->get()) - quadrant_pos;
+					prepared.coords = E_cell->get();
+					prepared.one_way_collision = tile_data->is_collision_shape_one_way(body_index, shape_index);
+					prepared.one_way_collision_margin = tile_data->get_collision_shape_one_way_margin(body_index, shape_index);
+					q.prepared_shapes.push_back(prepared);
+				}
+			}
+		}
+	}
+}
+
 void TileSetAtlasPluginPhysics::update_dirty_quadrants(TileMap *p_tile_map, SelfList<TileMapQuadrant>::List &r_dirty_quadrant_list) {
 	ERR_FAIL_COND(!p_tile_map);
 	ERR_FAIL_COND(!p_tile_map->is_inside_tree());
@@ -3914,6 +4020,7 @@ void TileSetAtlasPluginPhysics::update_dirty_quadrants(TileMap *p_tile_map, Self
 	Transform2D global_transform = p_tile_map->get_global_transform();
 	PhysicsServer2D *ps = PhysicsServer2D::get_singleton();
 
+	// The shapes were collected by prepare_quadrant(), only the server calls are left.
 	SelfList<TileMapQuadrant> *q_list_element = r_dirty_quadrant_list.first();
 	while (q_list_element) {
 		TileMapQuadrant &q = *q_list_element->self();
@@ -3931,41 +4038,19 @@ void TileSetAtlasPluginPhysics::update_dirty_quadrants(TileMap *p_tile_map, Self
 			ps->body_set_state(q.bodies[body_index], PhysicsServer2D::BODY_STATE_TRANSFORM, xform);
 		}
 
-		for (Set<Vector2i>::Element *E_cell = q.cells.front(); E_cell; E_cell = E_cell->next()) {
-			TileMapCell c = p_tile_map->get_cell(E_cell->get());
+		// Add the shapes again.
+		for (uint32_t i = 0; i < q.prepared_shapes.size(); i++) {
+			const TileMapQuadrant::PreparedShape &prepared = q.prepared_shapes[i];
+			RID body = q.bodies[prepared.body_index];
 
-			TileSetSource *source;
-			if (tile_set->has_source(c.source_id)) {
-				source = *tile_set->get_source(c.source_id);
-
-				if (!source->has_tile(c.get_atlas_coords()) || !source->has_alternative_tile(c.get_atlas_coords(), c.alternative_tile)) {
-					continue;
-				}
-
-				TileSetAtlasSource *atlas_source = Object::cast_to<TileSetAtlasSource>(source);
-				if (atlas_source) {
-					TileData *tile_data = Object::cast_to<TileData>(atlas_source->get_tile_data(c.get_atlas_coords(), c.alternative_tile));
+			Transform2D xform;
+			xform.set_origin(prepared.position);
 
-					for (int body_index = 0; body_index < q.bodies.size(); body_index++) {
-						// Add the shapes again.
-						for (int shape_index = 0; shape_index < tile_data->get_collision_shapes_count(body_index); shape_index++) {
-							bool one_way_collision = tile_data->is_collision_shape_one_way(body_index, shape_index);
-							float one_way_collision_margin = tile_data->get_collision_shape_one_way_margin(body_index, shape_index);
-							Ref<Shape2D> shape = tile_data->get_collision_shape_shape(body_index, shape_index);
-							if (shape.is_valid()) {
-								Transform2D xform = Transform2D();
-								xform.set_origin(p_tile_map->map_to_world(E_cell->get()) - quadrant_pos);
-
-								// Add decomposed convex shapes.
-								ps->body_add_shape(q.bodies[body_index], shape->get_rid(), xform);
-								ps->body_set_shape_metadata(q.bodies[body_index], shape_index, E_cell->get());
-								ps->body_set_shape_as_one_way_collision(q.bodies[body_index], shape_index, one_way_collision, one_way_collision_margin);
-							}
-						}
-					}
-				}
-			}
+			ps->body_add_shape(body, prepared.shape, xform);
+			ps->body_set_shape_metadata(body, prepared.shape_index, prepared.coords);
+			ps->body_set_shape_as_one_way_collision(body, prepared.shape_index, prepared.one_way_collision, prepared.one_way_collision_margin);
 		}
+		q.prepared_shapes.clear();
 
 		q_list_element = q_list_element->next();
 	}
@@ -4077,7 +4162,7 @@ void TileSetAtlasPluginNavigation::tilemap_notification(TileMap *p_tile_map, int
 	switch (p_what) {
 		case CanvasItem::NOTIFICATION_TRANSFORM_CHANGED: {
 			if (p_tile_map->is_inside_tree()) {
-				Map<Vector2i, TileMapQuadrant> quadrant_map = p_tile_map->get_quadrant_map();
+				Map<Vector2i, TileMapQuadrant> &quadrant_map = p_tile_map->get_quadrant_map();
 				Transform2D tilemap_xform = p_tile_map->get_global_transform();
 				for (Map<Vector2i, TileMapQuadrant>::Element *E_quadrant = quadrant_map.front(); E_quadrant; E_quadrant = E_quadrant->next()) {
 					TileMapQuadrant &q = E_quadrant->get();
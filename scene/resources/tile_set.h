@@ -565,6 +565,9 @@ class TileSetPlugin : public Object {
 public:
 	// Tilemap updates.
 	virtual void tilemap_notification(TileMap *p_tile_map, int p_what){};
+	// Called on each dirty quadrant before update_dirty_quadrants(). It may run on worker
+	// threads, so it must only read the tile map and tile set, and not call the servers.
+	virtual void prepare_quadrant(TileMap *p_tile_map, TileMapQuadrant *p_quadrant){};
 	virtual void update_dirty_quadrants(TileMap *p_tile_map, SelfList<TileMapQuadrant>::List &r_dirty_quadrant_list){};
 	virtual void create_quadrant(TileMap *p_tile_map, TileMapQuadrant *p_quadrant){};
 	virtual void cleanup_quadrant(TileMap *p_tile_map, TileMapQuadrant *p_quadrant){};
@@ -576,12 +579,12 @@ class TileSetAtlasPluginRendering : public TileSetPlugin {
 	GDCLASS(TileSetAtlasPluginRendering, TileSetPlugin);
 
 private:
-	static constexpr float fp_adjust = 0.00001;
 	bool quadrant_order_dirty = false;
 
 public:
 	// Tilemap updates
 	virtual void tilemap_notification(TileMap *p_tile_map, int p_what) override;
+	virtual void prepare_quadrant(TileMap *p_tile_map, TileMapQuadrant *p_quadrant) override;
 	virtual void update_dirty_quadrants(TileMap *p_tile_map, SelfList<TileMapQuadrant>::List &r_dirty_quadrant_list) override;
 	virtual void create_quadrant(TileMap *p_tile_map, TileMapQuadrant *p_quadrant) override;
 	virtual void cleanup_quadrant(TileMap *p_tile_map, TileMapQuadrant *p_quadrant) override;
@@ -618,6 +621,7 @@ class TileSetAtlasPluginPhysics : public TileSetPlugin {
 public:
 	// Tilemap updates
 	virtual void tilemap_notification(TileMap *p_tile_map, int p_what) override;
+	virtual void prepare_quadrant(TileMap *p_tile_map, TileMapQuadrant *p_quadrant) override;
 	virtual void update_dirty_quadrants(TileMap *p_tile_map, SelfList<TileMapQuadrant>::List &r_dirty_quadrant_list) override;
 	virtual void create_quadrant(TileMap *p_tile_map, TileMapQuadrant *p_quadrant) override;
 	virtual void cleanup_quadrant(TileMap *p_tile_map, TileMapQuadrant *p_quadrant) override;
@@ -33,6 +33,7 @@
 #include "core/math/camera_matrix.h"
 #include "core/math/octree.h"
 #include "scene/3d/camera_3d.h"
+#include "scene/3d/physics_body_3d.h"
 #include "scene/3d/visibility_notifier_3d.h"
 #include "scene/scene_string_names.h"
 #include "servers/navigation_server_3d.h"
@@ -333,6 +334,43 @@ void World3D::_bind_methods() {
 	ADD_PROPERTY(PropertyInfo(Variant::OBJECT, "direct_space_state", PROPERTY_HINT_RESOURCE_TYPE, "PhysicsDirectSpaceState3D", 0), "", "get_direct_space_state");
 }
 
+void World3D::_register_bulk_state_body() {
+	if (bulk_state_body_count == 0) {
+		PhysicsServer3D::get_singleton()->space_set_body_states_callback(space, callable_mp(this, &World3D::_body_states_changed));
+	}
+	bulk_state_body_count++;
+}
+
+void World3D::_remove_bulk_state_body() {
+	ERR_FAIL_COND(bulk_state_body_count == 0);
+	bulk_state_body_count--;
+	if (bulk_state_body_count == 0) {
+		PhysicsServer3D::get_singleton()->space_set_body_states_callback(space, Callable());
+	}
+}
+
+void World3D::_body_states_changed() {
+	PhysicsServer3D::BodyStates states;
+	int count = PhysicsServer3D::get_singleton()->space_get_moved_body_states(space, states);
+
+	const ObjectID *instance_ids = states.instance_ids.ptr();
+	const float *transforms = states.transforms.ptr();
+	const Vector3 *linear_velocities = states.linear_velocities.ptr();
+	const Vector3 *angular_velocities = states.angular_velocities.ptr();
+	const uint8_t *sleeping = states.sleeping.ptr();
+
+	for (int i = 0; i < count; i++) {
+		RigidBody3D *body = Object::cast_to<RigidBody3D>(ObjectDB::get_instance(instance_ids[i]));
+		if (!body || !body->bulk_state_sync) {
+			continue;
+		}
+
+		const float *dataptr = &transforms[i * 12];
+		Transform xform(dataptr[0], dataptr[1], dataptr[2], dataptr[4], dataptr[5], dataptr[6], dataptr[8], dataptr[9], dataptr[10], dataptr[3], dataptr[7], dataptr[11]);
+		body->_bulk_state_changed(xform, linear_velocities[i], angular_velocities[i], sleeping[i]);
+	}
+}
+
 World3D::World3D() {
 	space = PhysicsServer3D::get_singleton()->space_create();
 	scenario = RenderingServer::get_singleton()->scenario_create();
@@ -53,6 +53,9 @@ private:
 	Ref<Environment> fallback_environment;
 	Ref<CameraEffects> camera_effects;
 
+	int bulk_state_body_count = 0;
+	void _body_states_changed();
+
 protected:
 	static void _bind_methods();
 
@@ -69,6 +72,10 @@ protected:
 	friend class Viewport;
 	void _update(uint64_t p_frame);
 
+	friend class RigidBody3D;
+	void _register_bulk_state_body();
+	void _remove_bulk_state_body();
+
 public:
 	RID get_space() const;
 	RID get_navigation_map() const;
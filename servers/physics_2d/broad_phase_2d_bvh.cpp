@@ -99,7 +99,7 @@ void BroadPhase2DBVH::set_unpair_callback(UnpairCallback p_unpair_callback, void
 	unpair_userdata = p_userdata;
 }
 
-void BroadPhase2DBVH::update() {
+void BroadPhase2DBVH::update(ThreadWorkPool *p_work_pool) {
 	bvh.update();
 }
 
@@ -64,7 +64,7 @@ public:
 	virtual void set_pair_callback(PairCallback p_pair_callback, void *p_userdata);
 	virtual void set_unpair_callback(UnpairCallback p_unpair_callback, void *p_userdata);
 
-	virtual void update();
+	virtual void update(ThreadWorkPool *p_work_pool = nullptr);
 
 	static BroadPhase2DSW *_create();
 	BroadPhase2DBVH();
@@ -0,0 +1,476 @@
+/*************************************************************************/
+/*  broad_phase_2d_hash_grid.cpp                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#include "broad_phase_2d_hash_grid.h"
+
+#include "collision_object_2d_sw.h"
+#include "core/config/project_settings.h"
+#include "core/templates/thread_work_pool.h"
+
+// Below this many moved objects the pair search isn't worth dispatching to the work pool.
+#define HASH_GRID_THREADING_MIN 512
+#define HASH_GRID_CHUNK_SIZE 128
+
+bool BroadPhase2DHashGrid::_get_cell_range(const Rect2 &p_aabb, Point2i &r_from, Point2i &r_to) const {
+	// Huge objects (and positions too far away to fit the cell coordinates) are kept out of the grid.
+	const real_t max_coord = cell_size * real_t(1 << 30);
+	if (Math::abs(p_aabb.position.x) > max_coord || Math::abs(p_aabb.position.y) > max_coord) {
+		return false;
+	}
+	const Vector2 end = p_aabb.position + p_aabb.size;
+	if (Math::abs(end.x) > max_coord || Math::abs(end.y) > max_coord) {
+		return false;
+	}
+
+	r_from = Point2i(Math::floor(p_aabb.position.x / cell_size), Math::floor(p_aabb.position.y / cell_size));
+	r_to = Point2i(Math::floor(end.x / cell_size), Math::floor(end.y / cell_size));
+
+	return real_t(r_to.x - r_from.x + 1) * real_t(r_to.y - r_from.y + 1) <= large_object_min_surface;
+}
+
+void BroadPhase2DHashGrid::_grid_add(ID p_id, Element &p_element) {
+	p_element.large = !_get_cell_range(p_element.aabb, p_element.cell_from, p_element.cell_to);
+	if (p_element.large) {
+		large_elements.push_back(p_id);
+		return;
+	}
+
+	for (int y = p_element.cell_from.y; y <= p_element.cell_to.y; y++) {
+		for (int x = p_element.cell_from.x; x <= p_element.cell_to.x; x++) {
+			cells[_cell_key(x, y)].push_back(p_id);
+		}
+	}
+}
+
+void BroadPhase2DHashGrid::_grid_remove(ID p_id, Element &p_element) {
+	if (p_element.large) {
+		int64_t idx = large_elements.find(p_id);
+		ERR_FAIL_COND(idx < 0);
+		large_elements.remove_unordered(idx);
+		return;
+	}
+
+	for (int y = p_element.cell_from.y; y <= p_element.cell_to.y; y++) {
+		for (int x = p_element.cell_from.x; x <= p_element.cell_to.x; x++) {
+			const uint64_t key = _cell_key(x, y);
+			LocalVector<ID> *cell = cells.getptr(key);
+			ERR_CONTINUE(!cell);
+			int64_t idx = cell->find(p_id);
+			ERR_CONTINUE(idx < 0);
+			cell->remove_unordered(idx);
+			if (cell->is_empty()) {
+				cells.erase(key);
+			}
+		}
+	}
+}
+
+void BroadPhase2DHashGrid::_mark_moved(ID p_id) {
+	Element &e = elements[p_id - 1];
+	if (!e.moved) {
+		e.moved = true;
+		moved.push_back(p_id);
+	}
+}
+
+BroadPhase2DSW::ID BroadPhase2DHashGrid::create(CollisionObject2DSW *p_object, int p_subindex, const Rect2 &p_aabb, bool p_static) {
+	ID id;
+	if (free_ids.size()) {
+		id = free_ids[free_ids.size() - 1];
+		free_ids.resize(free_ids.size() - 1);
+	} else {
+		elements.resize(elements.size() + 1);
+		id = elements.size();
+	}
+
+	Element &e = elements[id - 1];
+	e.owner = p_object;
+	e.subindex = p_subindex;
+	e.aabb = p_aabb;
+	e._static = p_static;
+	e.moved = false;
+	e.pairs.clear();
+
+	_grid_add(id, e);
+	_mark_moved(id);
+
+	return id;
+}
+
+void BroadPhase2DHashGrid::move(ID p_id, const Rect2 &p_aabb) {
+	ERR_FAIL_UNSIGNED_INDEX(p_id - 1, elements.size());
+	Element &e = elements[p_id - 1];
+	ERR_FAIL_COND(!e.owner);
+
+	if (e.aabb == p_aabb) {
+		return;
+	}
+
+	Point2i from, to;
+	bool large = !_get_cell_range(p_aabb, from, to);
+	if (large != e.large || (!large && (from != e.cell_from || to != e.cell_to))) {
+		_grid_remove(p_id, e);
+		e.aabb = p_aabb;
+		_grid_add(p_id, e);
+	} else {
+		e.aabb = p_aabb;
+	}
+
+	_mark_moved(p_id);
+}
+
+void BroadPhase2DHashGrid::set_static(ID p_id, bool p_static) {
+	ERR_FAIL_UNSIGNED_INDEX(p_id - 1, elements.size());
+	Element &e = elements[p_id - 1];
+	ERR_FAIL_COND(!e.owner);
+
+	if (e._static == p_static) {
+		return;
+	}
+
+	e._static = p_static;
+	_mark_moved(p_id);
+}
+
+void BroadPhase2DHashGrid::remove(ID p_id) {
+	ERR_FAIL_UNSIGNED_INDEX(p_id - 1, elements.size());
+	Element &e = elements[p_id - 1];
+	ERR_FAIL_COND(!e.owner);
+
+	// Pairs must go away immediately, the owner may be freed right after this.
+	while (e.pairs.size()) {
+		_unpair(p_id, e.pairs[e.pairs.size() - 1].other);
+	}
+
+	_grid_remove(p_id, e);
+	e.owner = nullptr;
+	pending_free_ids.push_back(p_id);
+}
+
+CollisionObject2DSW *BroadPhase2DHashGrid::get_object(ID p_id) const {
+	ERR_FAIL_UNSIGNED_INDEX_V(p_id - 1, elements.size(), nullptr);
+	const Element &e = elements[p_id - 1];
+	ERR_FAIL_COND_V(!e.owner, nullptr);
+	return e.owner;
+}
+
+bool BroadPhase2DHashGrid::is_static(ID p_id) const {
+	ERR_FAIL_UNSIGNED_INDEX_V(p_id - 1, elements.size(), false);
+	return elements[p_id - 1]._static;
+}
+
+int BroadPhase2DHashGrid::get_subindex(ID p_id) const {
+	ERR_FAIL_UNSIGNED_INDEX_V(p_id - 1, elements.size(), -1);
+	return elements[p_id - 1].subindex;
+}
+
+template <class T>
+int BroadPhase2DHashGrid::_cull(const Rect2 &p_bounds, const T &p_test, CollisionObject2DSW **p_results, int p_max_results, int *p_result_indices) const {
+	int count = 0;
+
+	Point2i from, to;
+	bool brute_force = !_get_cell_range(p_bounds, from, to) || real_t(to.x - from.x + 1) * real_t(to.y - from.y + 1) > real_t(elements.size());
+
+	if (brute_force) {
+		for (uint32_t i = 0; i < elements.size() && count < p_max_results; i++) {
+			const Element &e = elements[i];
+			if (!e.owner || !p_test(e.aabb)) {
+				continue;
+			}
+			p_results[count] = e.owner;
+			if (p_result_indices) {
+				p_result_indices[count] = e.subindex;
+			}
+			count++;
+		}
+		return count;
+	}
+
+	for (int y = from.y; y <= to.y; y++) {
+		for (int x = from.x; x <= to.x; x++) {
+			const LocalVector<ID> *cell = cells.getptr(_cell_key(x, y));
+			if (!cell) {
+				continue;
+			}
+
+			for (uint32_t i = 0; i < cell->size(); i++) {
+				const Element &e = elements[(*cell)[i] - 1];
+				// Objects spanning several cells are only reported from the first cell they share with the query.
+				if (x != MAX(from.x, e.cell_from.x) || y != MAX(from.y, e.cell_from.y)) {
+					continue;
+				}
+				if (!p_test(e.aabb)) {
+					continue;
+				}
+				if (count >= p_max_results) {
+					return count;
+				}
+				p_results[count] = e.owner;
+				if (p_result_indices) {
+					p_result_indices[count] = e.subindex;
+				}
+				count++;
+			}
+		}
+	}
+
+	for (uint32_t i = 0; i < large_elements.size() && count < p_max_results; i++) {
+		const Element &e = elements[large_elements[i] - 1];
+		if (!p_test(e.aabb)) {
+			continue;
+		}
+		p_results[count] = e.owner;
+		if (p_result_indices) {
+			p_result_indices[count] = e.subindex;
+		}
+		count++;
+	}
+
+	return count;
+}
+
+int BroadPhase2DHashGrid::cull_segment(const Vector2 &p_from, const Vector2 &p_to, CollisionObject2DSW **p_results, int p_max_results, int *p_result_indices) {
+	struct SegmentTest {
+		Vector2 from;
+		Vector2 to;
+		_FORCE_INLINE_ bool operator()(const Rect2 &p_aabb) const { return p_aabb.intersects_segment(from, to); }
+	};
+
+	SegmentTest test;
+	test.from = p_from;
+	test.to = p_to;
+	Rect2 bounds(p_from, Vector2());
+	bounds.expand_to(p_to);
+
+	return _cull(bounds, test, p_results, p_max_results, p_result_indices);
+}
+
+int BroadPhase2DHashGrid::cull_aabb(const Rect2 &p_aabb, CollisionObject2DSW **p_results, int p_max_results, int *p_result_indices) {
+	struct AABBTest {
+		Rect2 aabb;
+		_FORCE_INLINE_ bool operator()(const Rect2 &p_aabb) const { return aabb.intersects(p_aabb); }
+	};
+
+	AABBTest test;
+	test.aabb = p_aabb;
+
+	return _cull(p_aabb, test, p_results, p_max_results, p_result_indices);
+}
+
+void BroadPhase2DHashGrid::_check_new_pair(ID p_id, const Element &p_element, ID p_other_id, PairChunk &r_chunk) const {
+	if (p_other_id == p_id) {
+		return;
+	}
+
+	const Element &other = elements[p_other_id - 1];
+	// When both moved, both find the pair, only the lower ID reports it.
+	if (other.moved && p_other_id < p_id) {
+		return;
+	}
+	if (!_should_pair(p_element, other)) {
+		return;
+	}
+
+	const LocalVector<PairData> &pairs = p_element.pairs.size() <= other.pairs.size() ? p_element.pairs : other.pairs;
+	const ID search = p_element.pairs.size() <= other.pairs.size() ? p_other_id : p_id;
+	for (uint32_t i = 0; i < pairs.size(); i++) {
+		if (pairs[i].other == search) {
+			return;
+		}
+	}
+
+	r_chunk.added.push_back(_pair_key(p_id, p_other_id));
+}
+
+void BroadPhase2DHashGrid::_find_pairs(uint32_t p_chunk, void *p_userdata) {
+	PairChunk &chunk = pair_chunks[p_chunk];
+	chunk.added.clear();
+	chunk.removed.clear();
+
+	const uint32_t from = p_chunk * HASH_GRID_CHUNK_SIZE;
+	const uint32_t to = MIN(from + HASH_GRID_CHUNK_SIZE, moved.size());
+
+	for (uint32_t i = from; i < to; i++) {
+		const ID id = moved[i];
+		const Element &e = elements[id - 1];
+		if (!e.owner) {
+			continue;
+		}
+
+		// Pairs that stopped overlapping.
+		for (uint32_t j = 0; j < e.pairs.size(); j++) {
+			const ID other_id = e.pairs[j].other;
+			const Element &other = elements[other_id - 1];
+			if (other.moved && other_id < id) {
+				continue;
+			}
+			if (!_should_pair(e, other)) {
+				chunk.removed.push_back(_pair_key(id, other_id));
+			}
+		}
+
+		// New pairs.
+		if (e.large) {
+			for (uint32_t j = 0; j < elements.size(); j++) {
+				if (elements[j].owner) {
+					_check_new_pair(id, e, j + 1, chunk);
+				}
+			}
+			continue;
+		}
+
+		for (int y = e.cell_from.y; y <= e.cell_to.y; y++) {
+			for (int x = e.cell_from.x; x <= e.cell_to.x; x++) {
+				const LocalVector<ID> *cell = cells.getptr(_cell_key(x, y));
+				ERR_CONTINUE(!cell);
+
+				for (uint32_t j = 0; j < cell->size(); j++) {
+					const ID other_id = (*cell)[j];
+					const Element &other = elements[other_id - 1];
+					// Only check the pair in the first cell both objects cover.
+					if (x != MAX(e.cell_from.x, other.cell_from.x) || y != MAX(e.cell_from.y, other.cell_from.y)) {
+						continue;
+					}
+					_check_new_pair(id, e, other_id, chunk);
+				}
+			}
+		}
+
+		for (uint32_t j = 0; j < large_elements.size(); j++) {
+			_check_new_pair(id, e, large_elements[j], chunk);
+		}
+	}
+}
+
+void BroadPhase2DHashGrid::_pair(ID p_a, ID p_b) {
+	Element &a = elements[p_a - 1];
+	Element &b = elements[p_b - 1];
+
+	void *data = nullptr;
+	if (pair_callback) {
+		data = pair_callback(a.owner, a.subindex, b.owner, b.subindex, pair_userdata);
+	}
+
+	PairData pd;
+	pd.data = data;
+	pd.other = p_b;
+	a.pairs.push_back(pd);
+	pd.other = p_a;
+	b.pairs.push_back(pd);
+}
+
+void BroadPhase2DHashGrid::_unpair(ID p_a, ID p_b) {
+	if (p_a > p_b) {
+		SWAP(p_a, p_b);
+	}
+
+	Element &a = elements[p_a - 1];
+	Element &b = elements[p_b - 1];
+
+	void *data = nullptr;
+	for (uint32_t i = 0; i < a.pairs.size(); i++) {
+		if (a.pairs[i].other == p_b) {
+			data = a.pairs[i].data;
+			a.pairs.remove_unordered(i);
+			break;
+		}
+	}
+	for (uint32_t i = 0; i < b.pairs.size(); i++) {
+		if (b.pairs[i].other == p_a) {
+			b.pairs.remove_unordered(i);
+			break;
+		}
+	}
+
+	if (unpair_callback) {
+		unpair_callback(a.owner, a.subindex, b.owner, b.subindex, data, unpair_userdata);
+	}
+}
+
+void BroadPhase2DHashGrid::set_pair_callback(PairCallback p_pair_callback, void *p_userdata) {
+	pair_callback = p_pair_callback;
+	pair_userdata = p_userdata;
+}
+
+void BroadPhase2DHashGrid::set_unpair_callback(UnpairCallback p_unpair_callback, void *p_userdata) {
+	unpair_callback = p_unpair_callback;
+	unpair_userdata = p_userdata;
+}
+
+void BroadPhase2DHashGrid::update(ThreadWorkPool *p_work_pool) {
+	const uint32_t chunk_count = (moved.size() + HASH_GRID_CHUNK_SIZE - 1) / HASH_GRID_CHUNK_SIZE;
+	if (pair_chunks.size() < chunk_count) {
+		pair_chunks.resize(chunk_count);
+	}
+
+	// The search only reads the grid and the pairs, the callbacks are sent afterwards in chunk order,
+	// so the result is the same with and without the work pool.
+	if (p_work_pool && moved.size() >= HASH_GRID_THREADING_MIN) {
+		p_work_pool->do_work(chunk_count, this, &BroadPhase2DHashGrid::_find_pairs, nullptr);
+	} else {
+		for (uint32_t i = 0; i < chunk_count; i++) {
+			_find_pairs(i, nullptr);
+		}
+	}
+
+	for (uint32_t i = 0; i < chunk_count; i++) {
+		const LocalVector<uint64_t> &removed = pair_chunks[i].removed;
+		for (uint32_t j = 0; j < removed.size(); j++) {
+			_unpair(removed[j] >> 32, removed[j] & 0xFFFFFFFF);
+		}
+	}
+	for (uint32_t i = 0; i < chunk_count; i++) {
+		const LocalVector<uint64_t> &added = pair_chunks[i].added;
+		for (uint32_t j = 0; j < added.size(); j++) {
+			_pair(added[j] >> 32, added[j] & 0xFFFFFFFF);
+		}
+	}
+
+	for (uint32_t i = 0; i < moved.size(); i++) {
+		elements[moved[i] - 1].moved = false;
+	}
+	moved.clear();
+
+	for (uint32_t i = 0; i < pending_free_ids.size(); i++) {
+		free_ids.push_back(pending_free_ids[i]);
+	}
+	pending_free_ids.clear();
+}
+
+BroadPhase2DSW *BroadPhase2DHashGrid::_create() {
+	return memnew(BroadPhase2DHashGrid);
+}
+
+BroadPhase2DHashGrid::BroadPhase2DHashGrid() {
+	cell_size = MAX(1, (int)GLOBAL_DEF("physics/2d/broad_phase_cell_size", 128));
+	ProjectSettings::get_singleton()->set_custom_property_info("physics/2d/broad_phase_cell_size", PropertyInfo(Variant::INT, "physics/2d/broad_phase_cell_size", PROPERTY_HINT_RANGE, "1,512,1,or_greater"));
+	large_object_min_surface = GLOBAL_DEF("physics/2d/large_object_surface_threshold_in_cells", 512);
+	ProjectSettings::get_singleton()->set_custom_property_info("physics/2d/large_object_surface_threshold_in_cells", PropertyInfo(Variant::INT, "physics/2d/large_object_surface_threshold_in_cells", PROPERTY_HINT_RANGE, "0,1024,1,or_greater"));
+}
@@ -0,0 +1,131 @@
+/*************************************************************************/
+/*  broad_phase_2d_hash_grid.h                                           */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef BROAD_PHASE_2D_HASH_GRID_H
+#define BROAD_PHASE_2D_HASH_GRID_H
+
+#include "broad_phase_2d_sw.h"
+#include "core/math/rect2.h"
+#include "core/math/vector2.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
+
+// Uniform grid broad phase, suited to many small objects of similar size that move every step.
+// Objects covering too many cells are kept on a separate list and tested against everything.
+// Pairs are searched only for the objects that moved, optionally on a work pool, and the
+// pair/unpair callbacks are then sent in one batch from update().
+class BroadPhase2DHashGrid : public BroadPhase2DSW {
+	struct PairData {
+		ID other = 0;
+		void *data = nullptr;
+	};
+
+	struct Element {
+		CollisionObject2DSW *owner = nullptr;
+		int subindex = 0;
+		Rect2 aabb;
+		Point2i cell_from; // Inclusive cell range, only valid when not large.
+		Point2i cell_to;
+		bool _static = false;
+		bool large = false;
+		bool moved = false;
+		LocalVector<PairData> pairs;
+	};
+
+	struct PairChunk {
+		LocalVector<uint64_t> added;
+		LocalVector<uint64_t> removed;
+	};
+
+	LocalVector<Element> elements; // Indexed by ID - 1.
+	LocalVector<ID> free_ids;
+	LocalVector<ID> pending_free_ids; // Removed this step, they may still be on the moved list.
+	LocalVector<ID> moved;
+	LocalVector<ID> large_elements;
+	HashMap<uint64_t, LocalVector<ID>> cells;
+	LocalVector<PairChunk> pair_chunks;
+
+	real_t cell_size = 128.0;
+	real_t large_object_min_surface = 512.0;
+
+	PairCallback pair_callback = nullptr;
+	void *pair_userdata = nullptr;
+	UnpairCallback unpair_callback = nullptr;
+	void *unpair_userdata = nullptr;
+
+	_FORCE_INLINE_ static uint64_t _cell_key(int p_x, int p_y) {
+		return (uint64_t(uint32_t(p_x)) << 32) | uint32_t(p_y);
+	}
+
+	_FORCE_INLINE_ static uint64_t _pair_key(ID p_a, ID p_b) {
+		return p_a < p_b ? ((uint64_t(p_a) << 32) | p_b) : ((uint64_t(p_b) << 32) | p_a);
+	}
+
+	_FORCE_INLINE_ static bool _should_pair(const Element &p_a, const Element &p_b) {
+		return p_a.owner != p_b.owner && !(p_a._static && p_b._static) && p_a.aabb.intersects(p_b.aabb);
+	}
+
+	bool _get_cell_range(const Rect2 &p_aabb, Point2i &r_from, Point2i &r_to) const;
+	void _grid_add(ID p_id, Element &p_element);
+	void _grid_remove(ID p_id, Element &p_element);
+	void _mark_moved(ID p_id);
+
+	void _check_new_pair(ID p_id, const Element &p_element, ID p_other_id, PairChunk &r_chunk) const;
+	void _find_pairs(uint32_t p_chunk, void *p_userdata);
+	void _pair(ID p_a, ID p_b);
+	void _unpair(ID p_a, ID p_b);
+
+	template <class T>
+	int _cull(const Rect2 &p_bounds, const T &p_test, CollisionObject2DSW **p_results, int p_max_results, int *p_result_indices) const;
+
+public:
+	// 0 is an invalid ID
+	virtual ID create(CollisionObject2DSW *p_object, int p_subindex = 0, const Rect2 &p_aabb = Rect2(), bool p_static = false);
+	virtual void move(ID p_id, const Rect2 &p_aabb);
+	virtual void set_static(ID p_id, bool p_static);
+	virtual void remove(ID p_id);
+
+	virtual CollisionObject2DSW *get_object(ID p_id) const;
+	virtual bool is_static(ID p_id) const;
+	virtual int get_subindex(ID p_id) const;
+
+	virtual int cull_segment(const Vector2 &p_from, const Vector2 &p_to, CollisionObject2DSW **p_results, int p_max_results, int *p_result_indices = nullptr);
+	virtual int cull_aabb(const Rect2 &p_aabb, CollisionObject2DSW **p_results, int p_max_results, int *p_result_indices = nullptr);
+
+	virtual void set_pair_callback(PairCallback p_pair_callback, void *p_userdata);
+	virtual void set_unpair_callback(UnpairCallback p_unpair_callback, void *p_userdata);
+
+	virtual void update(ThreadWorkPool *p_work_pool = nullptr);
+
+	static BroadPhase2DSW *_create();
+	BroadPhase2DHashGrid();
+};
+
+#endif // BROAD_PHASE_2D_HASH_GRID_H
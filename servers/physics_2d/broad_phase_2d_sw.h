@@ -35,6 +35,7 @@
 #include "core/math/rect2.h"
 
 class CollisionObject2DSW;
+class ThreadWorkPool;
 
 class BroadPhase2DSW {
 public:
@@ -63,7 +64,8 @@ public:
 	virtual void set_pair_callback(PairCallback p_pair_callback, void *p_userdata) = 0;
 	virtual void set_unpair_callback(UnpairCallback p_unpair_callback, void *p_userdata) = 0;
 
-	virtual void update() = 0;
+	// Pairs are only guaranteed to be up to date after this, the work pool is optional.
+	virtual void update(ThreadWorkPool *p_work_pool = nullptr) = 0;
 
 	virtual ~BroadPhase2DSW();
 };
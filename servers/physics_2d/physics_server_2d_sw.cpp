@@ -31,6 +31,7 @@
 #include "physics_server_2d_sw.h"
 
 #include "broad_phase_2d_bvh.h"
+#include "broad_phase_2d_hash_grid.h"
 #include "collision_solver_2d_sw.h"
 #include "core/config/project_settings.h"
 #include "core/debugger/engine_debugger.h"
@@ -1355,7 +1356,13 @@ PhysicsServer2DSW *PhysicsServer2DSW::singletonsw = nullptr;
 
 PhysicsServer2DSW::PhysicsServer2DSW(bool p_using_threads) {
 	singletonsw = this;
-	BroadPhase2DSW::create_func = BroadPhase2DBVH::_create;
+	int broad_phase = GLOBAL_DEF("physics/2d/broad_phase", 0);
+	ProjectSettings::get_singleton()->set_custom_property_info("physics/2d/broad_phase", PropertyInfo(Variant::INT, "physics/2d/broad_phase", PROPERTY_HINT_ENUM, "BVH,Hash Grid"));
+	if (broad_phase == 1) {
+		BroadPhase2DSW::create_func = BroadPhase2DHashGrid::_create;
+	} else {
+		BroadPhase2DSW::create_func = BroadPhase2DBVH::_create;
+	}
 
 	active = true;
 	island_count = 0;
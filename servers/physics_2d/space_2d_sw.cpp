@@ -1302,8 +1302,8 @@ void Space2DSW::setup() {
 	}
 }
 
-void Space2DSW::update() {
-	broadphase->update();
+void Space2DSW::update(ThreadWorkPool *p_work_pool) {
+	broadphase->update(p_work_pool);
 }
 
 void Space2DSW::set_param(PhysicsServer2D::SpaceParameter p_param, real_t p_value) {
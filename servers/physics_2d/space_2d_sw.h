@@ -164,7 +164,7 @@ public:
 	_FORCE_INLINE_ real_t get_body_angular_velocity_sleep_threshold() const { return body_angular_velocity_sleep_threshold; }
 	_FORCE_INLINE_ real_t get_body_time_to_sleep() const { return body_time_to_sleep; }
 
-	void update();
+	void update(ThreadWorkPool *p_work_pool = nullptr);
 	void setup();
 	void call_queries();
 
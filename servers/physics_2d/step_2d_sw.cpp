@@ -288,7 +288,7 @@ void Step2DSW::step(Space2DSW *p_space, real_t p_delta, int p_iterations) {
 
 	all_constraints.clear();
 
-	p_space->update();
+	p_space->update(&work_pool);
 	p_space->unlock();
 	_step++;
 }
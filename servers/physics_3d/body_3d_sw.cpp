@@ -369,6 +369,9 @@ void Body3DSW::set_space(Space3DSW *p_space) {
 		if (direct_state_query_list.in_list()) {
 			get_space()->body_remove_from_state_query_list(&direct_state_query_list);
 		}
+		if (moved_list.in_list()) {
+			get_space()->body_remove_from_moved_list(&moved_list);
+		}
 	}
 
 	_set_space(p_space);
@@ -551,6 +554,10 @@ void Body3DSW::integrate_velocities(real_t p_step) {
 		get_space()->body_add_to_state_query_list(&direct_state_query_list);
 	}
 
+	if (!moved_list.in_list()) {
+		get_space()->body_add_to_moved_list(&moved_list);
+	}
+
 	//apply axis lock linear
 	for (int i = 0; i < 3; i++) {
 		if (is_axis_locked((PhysicsServer3D::BodyAxis)(1 << i))) {
@@ -727,7 +734,8 @@ Body3DSW::Body3DSW() :
 
 		active_list(this),
 		inertia_update_list(this),
-		direct_state_query_list(this) {
+		direct_state_query_list(this),
+		moved_list(this) {
 	mode = PhysicsServer3D::BODY_MODE_RIGID;
 	active = true;
 
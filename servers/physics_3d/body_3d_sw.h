@@ -81,6 +81,7 @@ class Body3DSW : public CollisionObject3DSW {
 	SelfList<Body3DSW> active_list;
 	SelfList<Body3DSW> inertia_update_list;
 	SelfList<Body3DSW> direct_state_query_list;
+	SelfList<Body3DSW> moved_list;
 
 	VSet<RID> exceptions;
 	bool omit_force_integration;
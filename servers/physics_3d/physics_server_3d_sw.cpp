@@ -212,6 +212,68 @@ int PhysicsServer3DSW::space_get_contact_count(RID p_space) const {
 	return space->get_debug_contact_count();
 }
 
+int PhysicsServer3DSW::space_get_moved_body_states(RID p_space, BodyStates &r_states) const {
+	Space3DSW *space = space_owner.getornull(p_space);
+	ERR_FAIL_COND_V(!space, 0);
+	ERR_FAIL_COND_V_MSG((using_threads && !doing_sync) || space->is_locked(), 0, "Body states are inaccessible right now, wait for iteration or physics process notification.");
+
+	const SelfList<Body3DSW>::List &moved_list = space->get_moved_body_list();
+	int count = 0;
+	for (const SelfList<Body3DSW> *E = moved_list.first(); E; E = E->next()) {
+		count++;
+	}
+
+	r_states.bodies.resize(count);
+	r_states.instance_ids.resize(count);
+	r_states.transforms.resize(count * 12);
+	r_states.linear_velocities.resize(count);
+	r_states.angular_velocities.resize(count);
+	r_states.sleeping.resize(count);
+
+	RID *bodies = r_states.bodies.ptrw();
+	ObjectID *instance_ids = r_states.instance_ids.ptrw();
+	float *transforms = r_states.transforms.ptrw();
+	Vector3 *linear_velocities = r_states.linear_velocities.ptrw();
+	Vector3 *angular_velocities = r_states.angular_velocities.ptrw();
+	uint8_t *sleeping = r_states.sleeping.ptrw();
+
+	int idx = 0;
+	for (const SelfList<Body3DSW> *E = moved_list.first(); E; E = E->next()) {
+		const Body3DSW *body = E->self();
+		const Transform &xform = body->get_transform();
+
+		bodies[idx] = body->get_self();
+		instance_ids[idx] = body->get_instance_id();
+
+		float *dataptr = &transforms[idx * 12];
+		dataptr[0] = xform.basis.elements[0][0];
+		dataptr[1] = xform.basis.elements[0][1];
+		dataptr[2] = xform.basis.elements[0][2];
+		dataptr[3] = xform.origin.x;
+		dataptr[4] = xform.basis.elements[1][0];
+		dataptr[5] = xform.basis.elements[1][1];
+		dataptr[6] = xform.basis.elements[1][2];
+		dataptr[7] = xform.origin.y;
+		dataptr[8] = xform.basis.elements[2][0];
+		dataptr[9] = xform.basis.elements[2][1];
+		dataptr[10] = xform.basis.elements[2][2];
+		dataptr[11] = xform.origin.z;
+
+		linear_velocities[idx] = body->get_linear_velocity();
+		angular_velocities[idx] = body->get_angular_velocity();
+		sleeping[idx] = !body->is_active();
+		idx++;
+	}
+
+	return count;
+}
+
+void PhysicsServer3DSW::space_set_body_states_callback(RID p_space, const Callable &p_callable) {
+	Space3DSW *space = space_owner.getornull(p_space);
+	ERR_FAIL_COND(!space);
+	space->set_body_states_callback(p_callable);
+}
+
 RID PhysicsServer3DSW::area_create() {
 	Area3DSW *area = memnew(Area3DSW);
 	RID rid = area_owner.make_rid(area);
@@ -879,6 +941,29 @@ bool PhysicsServer3DSW::body_test_motion(RID p_body, const Transform &p_from, co
 	return body->get_space()->test_body_motion(body, p_from, p_motion, p_infinite_inertia, body->get_kinematic_margin(), r_result, p_exclude_raycast_shapes);
 }
 
+int PhysicsServer3DSW::body_test_motions(const RID *p_bodies, const Transform *p_from, const Vector3 *p_motions, int p_count, bool p_infinite_inertia, MotionResult *r_results, bool *r_collided, bool p_exclude_raycast_shapes) {
+	if (p_count <= 0) {
+		return 0;
+	}
+
+	LocalVector<Body3DSW *> bodies;
+	bodies.resize(p_count);
+	Space3DSW *space = nullptr;
+	for (int i = 0; i < p_count; i++) {
+		Body3DSW *body = body_owner.getornull(p_bodies[i]);
+		ERR_FAIL_COND_V(!body, 0);
+		ERR_FAIL_COND_V(!body->get_space(), 0);
+		ERR_FAIL_COND_V_MSG(space && body->get_space() != space, 0, "All the bodies of a motion batch must be in the same space.");
+		space = body->get_space();
+		bodies[i] = body;
+	}
+	ERR_FAIL_COND_V(space->is_locked(), 0);
+
+	_update_shapes();
+
+	return space->test_body_motions(bodies.ptr(), p_from, p_motions, p_count, p_infinite_inertia, r_results, r_collided, p_exclude_raycast_shapes);
+}
+
 int PhysicsServer3DSW::body_test_ray_separation(RID p_body, const Transform &p_transform, bool p_infinite_inertia, Vector3 &r_recover_motion, SeparationResult *r_results, int p_result_max, real_t p_margin) {
 	Body3DSW *body = body_owner.getornull(p_body);
 	ERR_FAIL_COND_V(!body, false);
@@ -120,6 +120,14 @@ public:
 		return physics_3d_server->space_get_direct_state(p_space);
 	}
 
+	FUNC2(space_set_body_states_callback, RID, const Callable &);
+
+	// this function only works on physics process, errors and returns 0 otherwise
+	virtual int space_get_moved_body_states(RID p_space, BodyStates &r_states) const override {
+		ERR_FAIL_COND_V(main_thread != Thread::get_caller_id(), 0);
+		return physics_3d_server->space_get_moved_body_states(p_space, r_states);
+	}
+
 	FUNC2(space_set_debug_contacts, RID, int);
 	virtual Vector<Vector3> space_get_contacts(RID p_space) const override {
 		ERR_FAIL_COND_V(main_thread != Thread::get_caller_id(), Vector<Vector3>());
@@ -258,6 +266,11 @@ public:
 		return physics_3d_server->body_test_motion(p_body, p_from, p_motion, p_infinite_inertia, r_result, p_exclude_raycast_shapes);
 	}
 
+	int body_test_motions(const RID *p_bodies, const Transform *p_from, const Vector3 *p_motions, int p_count, bool p_infinite_inertia, MotionResult *r_results, bool *r_collided, bool p_exclude_raycast_shapes = true) override {
+		ERR_FAIL_COND_V(main_thread != Thread::get_caller_id(), 0);
+		return physics_3d_server->body_test_motions(p_bodies, p_from, p_motions, p_count, p_infinite_inertia, r_results, r_collided, p_exclude_raycast_shapes);
+	}
+
 	int body_test_ray_separation(RID p_body, const Transform &p_transform, bool p_infinite_inertia, Vector3 &r_recover_motion, SeparationResult *r_results, int p_result_max, real_t p_margin = 0.001) override {
 		ERR_FAIL_COND_V(main_thread != Thread::get_caller_id(), false);
 		return physics_3d_server->body_test_ray_separation(p_body, p_transform, p_infinite_inertia, r_recover_motion, r_results, p_result_max, p_margin);
@@ -33,7 +33,6 @@
 #include "core/io/image.h"
 #include "core/math/geometry_3d.h"
 #include "core/math/quick_hull.h"
-#include "core/templates/sort_array.h"
 
 // HeightMapShape3DSW is based on Bullet btHeightfieldTerrainShape.
 
@@ -1296,46 +1295,31 @@ Vector3 ConcavePolygonShape3DSW::get_support(const Vector3 &p_normal) const {
 	return vptr[vert_support_idx];
 }
 
-void ConcavePolygonShape3DSW::_cull_segment(int p_idx, _SegmentCullParams *p_params) const {
-	const BVH *bvh = &p_params->bvh[p_idx];
+bool ConcavePolygonShape3DSW::_cull_segment_callback(void *p_userdata, uint32_t p_face, real_t &r_max_t) {
+	_SegmentCullParams *params = (_SegmentCullParams *)p_userdata;
 
-	/*
-	if (p_params->dir.dot(bvh->aabb.get_support(-p_params->dir))>p_params->min_d)
-		return; //test against whole AABB, which isn't very costly
-	*/
+	const Face *f = &params->faces[p_face];
+	FaceShape3DSW *face = params->face;
+	face->normal = f->normal;
+	face->vertex[0] = params->vertices[f->indices[0]];
+	face->vertex[1] = params->vertices[f->indices[1]];
+	face->vertex[2] = params->vertices[f->indices[2]];
 
-	//printf("addr: %p\n",bvh);
-	if (!bvh->aabb.intersects_segment(p_params->from, p_params->to)) {
-		return;
-	}
-
-	if (bvh->face_index >= 0) {
-		const Face *f = &p_params->faces[bvh->face_index];
-		FaceShape3DSW *face = p_params->face;
-		face->normal = f->normal;
-		face->vertex[0] = p_params->vertices[f->indices[0]];
-		face->vertex[1] = p_params->vertices[f->indices[1]];
-		face->vertex[2] = p_params->vertices[f->indices[2]];
-
-		Vector3 res;
-		Vector3 normal;
-		if (face->intersect_segment(p_params->from, p_params->to, res, normal)) {
-			real_t d = p_params->dir.dot(res) - p_params->dir.dot(p_params->from);
-			if ((d > 0) && (d < p_params->min_d)) {
-				p_params->min_d = d;
-				p_params->result = res;
-				p_params->normal = normal;
-				p_params->collisions++;
-			}
-		}
-	} else {
-		if (bvh->left >= 0) {
-			_cull_segment(bvh->left, p_params);
-		}
-		if (bvh->right >= 0) {
-			_cull_segment(bvh->right, p_params);
+	Vector3 res;
+	Vector3 normal;
+	if (face->intersect_segment(params->from, params->to, res, normal)) {
+		real_t d = params->dir.dot(res) - params->dir.dot(params->from);
+		if ((d > 0) && (d < params->min_d)) {
+			params->min_d = d;
+			params->result = res;
+			params->normal = normal;
+			params->collisions++;
+			// Nodes farther than this hit can't hold a closer one.
+			r_max_t = d / params->length;
 		}
 	}
+
+	return false;
 }
 
 bool ConcavePolygonShape3DSW::intersect_segment(const Vector3 &p_begin, const Vector3 &p_end, Vector3 &r_result, Vector3 &r_normal) const {
@@ -1346,7 +1330,6 @@ bool ConcavePolygonShape3DSW::intersect_segment(const Vector3 &p_begin, const Ve
 	// unlock data
 	const Face *fr = faces.ptr();
 	const Vector3 *vr = vertices.ptr();
-	const BVH *br = bvh.ptr();
 
 	FaceShape3DSW face;
 	face.backface_collision = backface_collision;
@@ -1355,15 +1338,15 @@ bool ConcavePolygonShape3DSW::intersect_segment(const Vector3 &p_begin, const Ve
 	params.from = p_begin;
 	params.to = p_end;
 	params.dir = (p_end - p_begin).normalized();
+	params.length = (p_end - p_begin).length();
 
 	params.faces = fr;
 	params.vertices = vr;
-	params.bvh = br;
 
 	params.face = &face;
 
 	// cull
-	_cull_segment(0, &params);
+	bvh.cull_segment(p_begin, p_end, _cull_segment_callback, &params);
 
 	if (params.collisions > 0) {
 		r_result = params.result;
@@ -1382,31 +1365,30 @@ Vector3 ConcavePolygonShape3DSW::get_closest_point_to(const Vector3 &p_point) co
 	return Vector3();
 }
 
-void ConcavePolygonShape3DSW::_cull(int p_idx, _CullParams *p_params) const {
-	const BVH *bvh = &p_params->bvh[p_idx];
+bool ConcavePolygonShape3DSW::_cull_callback(void *p_userdata, uint32_t p_face) {
+	_CullParams *params = (_CullParams *)p_userdata;
 
-	if (!p_params->aabb.intersects(bvh->aabb)) {
-		return;
-	}
+	const Face *f = &params->faces[p_face];
+	const Vector3 &v0 = params->vertices[f->indices[0]];
+	const Vector3 &v1 = params->vertices[f->indices[1]];
+	const Vector3 &v2 = params->vertices[f->indices[2]];
 
-	if (bvh->face_index >= 0) {
-		const Face *f = &p_params->faces[bvh->face_index];
-		FaceShape3DSW *face = p_params->face;
-		face->normal = f->normal;
-		face->vertex[0] = p_params->vertices[f->indices[0]];
-		face->vertex[1] = p_params->vertices[f->indices[1]];
-		face->vertex[2] = p_params->vertices[f->indices[2]];
-		p_params->callback(p_params->userdata, face);
+	// Leaves are shared by several faces, test each one on its own.
+	AABB face_aabb(v0, Vector3());
+	face_aabb.expand_to(v1);
+	face_aabb.expand_to(v2);
+	if (!params->aabb.intersects(face_aabb)) {
+		return false;
+	}
 
-	} else {
-		if (bvh->left >= 0) {
-			_cull(bvh->left, p_params);
-		}
+	FaceShape3DSW *face = params->face;
+	face->normal = f->normal;
+	face->vertex[0] = v0;
+	face->vertex[1] = v1;
+	face->vertex[2] = v2;
+	params->callback(params->userdata, face);
 
-		if (bvh->right >= 0) {
-			_cull(bvh->right, p_params);
-		}
-	}
+	return false;
 }
 
 void ConcavePolygonShape3DSW::cull(const AABB &p_local_aabb, Callback p_callback, void *p_userdata) const {
@@ -1420,7 +1402,6 @@ void ConcavePolygonShape3DSW::cull(const AABB &p_local_aabb, Callback p_callback
 	// unlock data
 	const Face *fr = faces.ptr();
 	const Vector3 *vr = vertices.ptr();
-	const BVH *br = bvh.ptr();
 
 	FaceShape3DSW face; // use this to send in the callback
 	face.backface_collision = backface_collision;
@@ -1430,12 +1411,11 @@ void ConcavePolygonShape3DSW::cull(const AABB &p_local_aabb, Callback p_callback
 	params.face = &face;
 	params.faces = fr;
 	params.vertices = vr;
-	params.bvh = br;
 	params.callback = p_callback;
 	params.userdata = p_userdata;
 
 	// cull
-	_cull(0, &params);
+	bvh.cull_aabb(local_aabb, _cull_callback, &params);
 }
 
 Vector3 ConcavePolygonShape3DSW::get_moment_of_inertia(real_t p_mass) const {
@@ -1448,116 +1428,10 @@ Vector3 ConcavePolygonShape3DSW::get_moment_of_inertia(real_t p_mass) const {
 			(p_mass / 3.0) * (extents.x * extents.x + extents.y * extents.y));
 }
 
-struct _VolumeSW_BVH_Element {
-	AABB aabb;
-	Vector3 center;
-	int face_index;
-};
-
-struct _VolumeSW_BVH_CompareX {
-	_FORCE_INLINE_ bool operator()(const _VolumeSW_BVH_Element &a, const _VolumeSW_BVH_Element &b) const {
-		return a.center.x < b.center.x;
-	}
-};
-
-struct _VolumeSW_BVH_CompareY {
-	_FORCE_INLINE_ bool operator()(const _VolumeSW_BVH_Element &a, const _VolumeSW_BVH_Element &b) const {
-		return a.center.y < b.center.y;
-	}
-};
-
-struct _VolumeSW_BVH_CompareZ {
-	_FORCE_INLINE_ bool operator()(const _VolumeSW_BVH_Element &a, const _VolumeSW_BVH_Element &b) const {
-		return a.center.z < b.center.z;
-	}
-};
-
-struct _VolumeSW_BVH {
-	AABB aabb;
-	_VolumeSW_BVH *left;
-	_VolumeSW_BVH *right;
-
-	int face_index;
-};
-
-_VolumeSW_BVH *_volume_sw_build_bvh(_VolumeSW_BVH_Element *p_elements, int p_size, int &count) {
-	_VolumeSW_BVH *bvh = memnew(_VolumeSW_BVH);
-
-	if (p_size == 1) {
-		//leaf
-		bvh->aabb = p_elements[0].aabb;
-		bvh->left = nullptr;
-		bvh->right = nullptr;
-		bvh->face_index = p_elements->face_index;
-		count++;
-		return bvh;
-	} else {
-		bvh->face_index = -1;
-	}
-
-	AABB aabb;
-	for (int i = 0; i < p_size; i++) {
-		if (i == 0) {
-			aabb = p_elements[i].aabb;
-		} else {
-			aabb.merge_with(p_elements[i].aabb);
-		}
-	}
-	bvh->aabb = aabb;
-	switch (aabb.get_longest_axis_index()) {
-		case 0: {
-			SortArray<_VolumeSW_BVH_Element, _VolumeSW_BVH_CompareX> sort_x;
-			sort_x.sort(p_elements, p_size);
-
-		} break;
-		case 1: {
-			SortArray<_VolumeSW_BVH_Element, _VolumeSW_BVH_CompareY> sort_y;
-			sort_y.sort(p_elements, p_size);
-		} break;
-		case 2: {
-			SortArray<_VolumeSW_BVH_Element, _VolumeSW_BVH_CompareZ> sort_z;
-			sort_z.sort(p_elements, p_size);
-		} break;
-	}
-
-	int split = p_size / 2;
-	bvh->left = _volume_sw_build_bvh(p_elements, split, count);
-	bvh->right = _volume_sw_build_bvh(&p_elements[split], p_size - split, count);
-
-	//printf("branch at %p - %i: %i\n",bvh,count,bvh->face_index);
-	count++;
-	return bvh;
-}
-
-void ConcavePolygonShape3DSW::_fill_bvh(_VolumeSW_BVH *p_bvh_tree, BVH *p_bvh_array, int &p_idx) {
-	int idx = p_idx;
-
-	p_bvh_array[idx].aabb = p_bvh_tree->aabb;
-	p_bvh_array[idx].face_index = p_bvh_tree->face_index;
-	//printf("%p - %i: %i(%p)  -- %p:%p\n",%p_bvh_array[idx],p_idx,p_bvh_array[i]->face_index,&p_bvh_tree->face_index,p_bvh_tree->left,p_bvh_tree->right);
-
-	if (p_bvh_tree->left) {
-		p_bvh_array[idx].left = ++p_idx;
-		_fill_bvh(p_bvh_tree->left, p_bvh_array, p_idx);
-
-	} else {
-		p_bvh_array[p_idx].left = -1;
-	}
-
-	if (p_bvh_tree->right) {
-		p_bvh_array[idx].right = ++p_idx;
-		_fill_bvh(p_bvh_tree->right, p_bvh_array, p_idx);
-
-	} else {
-		p_bvh_array[p_idx].right = -1;
-	}
-
-	memdelete(p_bvh_tree);
-}
-
 void ConcavePolygonShape3DSW::_setup(const Vector<Vector3> &p_faces, bool p_backface_collision) {
 	int src_face_count = p_faces.size();
 	if (src_face_count == 0) {
+		bvh.clear();
 		configure(AABB());
 		return;
 	}
@@ -1566,10 +1440,8 @@ void ConcavePolygonShape3DSW::_setup(const Vector<Vector3> &p_faces, bool p_back
 
 	const Vector3 *facesr = p_faces.ptr();
 
-	Vector<_VolumeSW_BVH_Element> bvh_array;
-	bvh_array.resize(src_face_count);
-
-	_VolumeSW_BVH_Element *bvh_arrayw = bvh_array.ptrw();
+	LocalVector<AABB> face_aabbs;
+	face_aabbs.resize(src_face_count);
 
 	faces.resize(src_face_count);
 	Face *facesw = faces.ptrw();
@@ -1583,9 +1455,7 @@ void ConcavePolygonShape3DSW::_setup(const Vector<Vector3> &p_faces, bool p_back
 	for (int i = 0; i < src_face_count; i++) {
 		Face3 face(facesr[i * 3 + 0], facesr[i * 3 + 1], facesr[i * 3 + 2]);
 
-		bvh_arrayw[i].aabb = face.get_aabb();
-		bvh_arrayw[i].center = bvh_arrayw[i].aabb.position + bvh_arrayw[i].aabb.size * 0.5;
-		bvh_arrayw[i].face_index = i;
+		face_aabbs[i] = face.get_aabb();
 		facesw[i].indices[0] = i * 3 + 0;
 		facesw[i].indices[1] = i * 3 + 1;
 		facesw[i].indices[2] = i * 3 + 2;
@@ -1594,21 +1464,13 @@ void ConcavePolygonShape3DSW::_setup(const Vector<Vector3> &p_faces, bool p_back
 		verticesw[i * 3 + 1] = face.vertex[1];
 		verticesw[i * 3 + 2] = face.vertex[2];
 		if (i == 0) {
-			_aabb = bvh_arrayw[i].aabb;
+			_aabb = face_aabbs[i];
 		} else {
-			_aabb.merge_with(bvh_arrayw[i].aabb);
+			_aabb.merge_with(face_aabbs[i]);
 		}
 	}
 
-	int count = 0;
-	_VolumeSW_BVH *bvh_tree = _volume_sw_build_bvh(bvh_arrayw, src_face_count, count);
-
-	bvh.resize(count + 1);
-
-	BVH *bvh_arrayw2 = bvh.ptrw();
-
-	int idx = 0;
-	_fill_bvh(bvh_tree, bvh_arrayw2, idx);
+	bvh.build(face_aabbs.ptr(), src_face_count);
 
 	backface_collision = p_backface_collision;
 
@@ -1702,6 +1564,147 @@ _FORCE_INLINE_ bool _heightmap_cell_cull_segment(_HeightmapSegmentCullParams &p_
 	return false;
 }
 
+struct _HeightmapRayParams {
+	// Ray in grid coordinates, the parameter goes from 0 at the begin point to 1 at the end point.
+	Vector3 begin;
+	Vector3 delta;
+
+	const HeightMapShape3DSW *heightmap = nullptr;
+	_HeightmapSegmentCullParams *segment = nullptr;
+};
+
+struct _HeightmapRayNode {
+	real_t t = 0.0;
+	int x = 0;
+	int z = 0;
+};
+
+// Clips the ray against a rectangle of the grid, returns the range of the ray parameter inside of it.
+_FORCE_INLINE_ bool _heightmap_ray_clip_rect(const _HeightmapRayParams &p_ray, real_t p_min_x, real_t p_max_x, real_t p_min_z, real_t p_max_z, real_t &r_t0, real_t &r_t1) {
+	const real_t rect_min[2] = { p_min_x - (real_t)CMP_EPSILON, p_min_z - (real_t)CMP_EPSILON };
+	const real_t rect_max[2] = { p_max_x + (real_t)CMP_EPSILON, p_max_z + (real_t)CMP_EPSILON };
+	const real_t begin[2] = { p_ray.begin.x, p_ray.begin.z };
+	const real_t delta[2] = { p_ray.delta.x, p_ray.delta.z };
+
+	real_t t0 = 0.0;
+	real_t t1 = 1.0;
+	for (int i = 0; i < 2; i++) {
+		if (Math::abs(delta[i]) < CMP_EPSILON) {
+			if (begin[i] < rect_min[i] || begin[i] > rect_max[i]) {
+				return false;
+			}
+			continue;
+		}
+
+		real_t inv_delta = 1.0 / delta[i];
+		real_t t_enter = (rect_min[i] - begin[i]) * inv_delta;
+		real_t t_exit = (rect_max[i] - begin[i]) * inv_delta;
+		if (t_enter > t_exit) {
+			SWAP(t_enter, t_exit);
+		}
+
+		t0 = MAX(t0, t_enter);
+		t1 = MIN(t1, t_exit);
+		if (t0 > t1) {
+			return false;
+		}
+	}
+
+	r_t0 = t0;
+	r_t1 = t1;
+	return true;
+}
+
+_FORCE_INLINE_ bool _heightmap_ray_overlaps_range(const _HeightmapRayParams &p_ray, real_t p_t0, real_t p_t1, const HeightMapShape3DSW::Range &p_range) {
+	real_t y0 = p_ray.begin.y + p_ray.delta.y * p_t0;
+	real_t y1 = p_ray.begin.y + p_ray.delta.y * p_t1;
+	return MAX(y0, y1) >= p_range.min - CMP_EPSILON && MIN(y0, y1) <= p_range.max + CMP_EPSILON;
+}
+
+// Inserts a node sorted by the ray parameter where the ray enters it.
+_FORCE_INLINE_ void _heightmap_ray_insert_node(_HeightmapRayNode *r_nodes, int &r_count, real_t p_t, int p_x, int p_z) {
+	int i = r_count++;
+	while (i > 0 && r_nodes[i - 1].t > p_t) {
+		r_nodes[i] = r_nodes[i - 1];
+		i--;
+	}
+	r_nodes[i].t = p_t;
+	r_nodes[i].x = p_x;
+	r_nodes[i].z = p_z;
+}
+
+// Visits the nodes of the bounds pyramid the ray goes through, front to back,
+// so the first hit found is the closest one.
+static bool _heightmap_ray_cull_bounds(const _HeightmapRayParams &p_ray, int p_level, int p_x, int p_z) {
+	const HeightMapShape3DSW *heightmap = p_ray.heightmap;
+	const int cells_width = heightmap->width - 1;
+	const int cells_depth = heightmap->depth - 1;
+
+	_HeightmapRayNode nodes[HeightMapShape3DSW::BOUNDS_CHUNK_SIZE * HeightMapShape3DSW::BOUNDS_CHUNK_SIZE];
+	int node_count = 0;
+	real_t t0 = 0.0;
+	real_t t1 = 0.0;
+
+	if (p_level == 0) {
+		// Leaf chunk, test the cells.
+		int start_x = p_x << HeightMapShape3DSW::BOUNDS_CHUNK_SHIFT;
+		int start_z = p_z << HeightMapShape3DSW::BOUNDS_CHUNK_SHIFT;
+		int end_x = MIN(start_x + HeightMapShape3DSW::BOUNDS_CHUNK_SIZE, cells_width);
+		int end_z = MIN(start_z + HeightMapShape3DSW::BOUNDS_CHUNK_SIZE, cells_depth);
+
+		for (int z = start_z; z < end_z; z++) {
+			for (int x = start_x; x < end_x; x++) {
+				if (!_heightmap_ray_clip_rect(p_ray, x, x + 1, z, z + 1, t0, t1)) {
+					continue;
+				}
+				HeightMapShape3DSW::Range range;
+				heightmap->_get_cell_range(x, z, range);
+				if (_heightmap_ray_overlaps_range(p_ray, t0, t1, range)) {
+					_heightmap_ray_insert_node(nodes, node_count, t0, x, z);
+				}
+			}
+		}
+
+		for (int i = 0; i < node_count; i++) {
+			if (_heightmap_cell_cull_segment(*p_ray.segment, nodes[i].x, nodes[i].z)) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	const HeightMapShape3DSW::BoundsLevel &child_level = heightmap->bounds_levels[p_level - 1];
+	const int child_cells = HeightMapShape3DSW::BOUNDS_CHUNK_SIZE << (p_level - 1);
+
+	for (int j = 0; j < 2; j++) {
+		int z = p_z * 2 + j;
+		if (z >= child_level.depth) {
+			break;
+		}
+		for (int i = 0; i < 2; i++) {
+			int x = p_x * 2 + i;
+			if (x >= child_level.width) {
+				break;
+			}
+			int min_x = x * child_cells;
+			int min_z = z * child_cells;
+			if (!_heightmap_ray_clip_rect(p_ray, min_x, MIN(min_x + child_cells, cells_width), min_z, MIN(min_z + child_cells, cells_depth), t0, t1)) {
+				continue;
+			}
+			if (_heightmap_ray_overlaps_range(p_ray, t0, t1, child_level.ranges[z * child_level.width + x])) {
+				_heightmap_ray_insert_node(nodes, node_count, t0, x, z);
+			}
+		}
+	}
+
+	for (int i = 0; i < node_count; i++) {
+		if (_heightmap_ray_cull_bounds(p_ray, p_level - 1, nodes[i].x, nodes[i].z)) {
+			return true;
+		}
+	}
+	return false;
+}
+
 bool HeightMapShape3DSW::intersect_segment(const Vector3 &p_begin, const Vector3 &p_end, Vector3 &r_point, Vector3 &r_normal) const {
 	if (heights.is_empty()) {
 		return false;
@@ -1736,116 +1739,23 @@ bool HeightMapShape3DSW::intersect_segment(const Vector3 &p_begin, const Vector3
 			r_normal = params.normal;
 			return true;
 		}
-	} else {
-		// Perform grid query from projected ray.
-		Vector2 ray_dir_proj(local_end.x - local_begin.x, local_end.z - local_begin.z);
-		real_t ray_dist_proj = ray_dir_proj.length();
-
-		if (ray_dist_proj < CMP_EPSILON) {
-			ray_dir_proj = Vector2();
-		} else {
-			ray_dir_proj /= ray_dist_proj;
-		}
-
-		const int x_step = (ray_dir_proj.x > CMP_EPSILON) ? 1 : ((ray_dir_proj.x < -CMP_EPSILON) ? -1 : 0);
-		const int z_step = (ray_dir_proj.y > CMP_EPSILON) ? 1 : ((ray_dir_proj.y < -CMP_EPSILON) ? -1 : 0);
-
-		const real_t infinite = 1e20;
-		const real_t delta_x = (x_step != 0) ? 1.f / Math::abs(ray_dir_proj.x) : infinite;
-		const real_t delta_z = (z_step != 0) ? 1.f / Math::abs(ray_dir_proj.y) : infinite;
-
-		real_t cross_x; // At which value of `param` we will cross a x-axis lane?
-		real_t cross_z; // At which value of `param` we will cross a z-axis lane?
-
-		// X initialization.
-		if (x_step != 0) {
-			if (x_step == 1) {
-				cross_x = (ceil(local_begin.x) - local_begin.x) * delta_x;
-			} else {
-				cross_x = (local_begin.x - floor(local_begin.x)) * delta_x;
-			}
-		} else {
-			cross_x = infinite; // Will never cross on X.
-		}
-
-		// Z initialization.
-		if (z_step != 0) {
-			if (z_step == 1) {
-				cross_z = (ceil(local_begin.z) - local_begin.z) * delta_z;
-			} else {
-				cross_z = (local_begin.z - floor(local_begin.z)) * delta_z;
-			}
-		} else {
-			cross_z = infinite; // Will never cross on Z.
-		}
-
-		int x = floor(local_begin.x);
-		int z = floor(local_begin.z);
-
-		// Workaround cases where the ray starts at an integer position.
-		if (Math::abs(cross_x) < CMP_EPSILON) {
-			cross_x += delta_x;
-			// If going backwards, we should ignore the position we would get by the above flooring,
-			// because the ray is not heading in that direction.
-			if (x_step == -1) {
-				x -= 1;
-			}
-		}
-
-		if (Math::abs(cross_z) < CMP_EPSILON) {
-			cross_z += delta_z;
-			if (z_step == -1) {
-				z -= 1;
-			}
-		}
-
-		// Start inside the grid.
-		int x_start = CLAMP(x, 0, width - 2);
-		int z_start = CLAMP(z, 0, depth - 2);
-
-		// Adjust initial cross values.
-		cross_x += delta_x * x_step * (x_start - x);
-		cross_z += delta_z * z_step * (z_start - z);
-
-		x = x_start;
-		z = z_start;
-
-		if (_heightmap_cell_cull_segment(params, x, z)) {
-			r_point = params.result;
-			r_normal = params.normal;
-			return true;
-		}
-
-		real_t dist = 0.0;
-		while (true) {
-			if (cross_x < cross_z) {
-				// X lane.
-				x += x_step;
-				// Assign before advancing the param,
-				// to be in sync with the initialization step.
-				dist = cross_x;
-				cross_x += delta_x;
-			} else {
-				// Z lane.
-				z += z_step;
-				dist = cross_z;
-				cross_z += delta_z;
-			}
-
-			// Stop when outside the grid.
-			if ((x < 0) || (z < 0) || (x >= width - 1) || (z >= depth - 1)) {
-				break;
-			}
-
-			if (_heightmap_cell_cull_segment(params, x, z)) {
+	} else if (!bounds_levels.is_empty()) {
+		// Walk down the bounds pyramid, skipping the regions the ray passes above or below.
+		_HeightmapRayParams ray;
+		ray.begin = local_begin;
+		ray.delta = local_end - local_begin;
+		ray.heightmap = this;
+		ray.segment = &params;
+
+		const int root_level = bounds_levels.size() - 1;
+		real_t t0 = 0.0;
+		real_t t1 = 0.0;
+		if (_heightmap_ray_clip_rect(ray, 0, width - 1, 0, depth - 1, t0, t1) && _heightmap_ray_overlaps_range(ray, t0, t1, bounds_levels[root_level].ranges[0])) {
+			if (_heightmap_ray_cull_bounds(ray, root_level, 0, 0)) {
 				r_point = params.result;
 				r_normal = params.normal;
 				return true;
 			}
-
-			if (dist > ray_dist_proj) {
-				break;
-			}
 		}
 	}
 
@@ -1868,7 +1778,7 @@ void HeightMapShape3DSW::_get_cell(const Vector3 &p_point, int &r_x, int &r_y, i
 	Vector3 clamped_point(p_point);
 	clamped_point.x = CLAMP(p_point.x, pos_local.x, pos_local.x + aabb.size.x);
 	clamped_point.y = CLAMP(p_point.y, pos_local.y, pos_local.y + aabb.size.y);
-	clamped_point.z = CLAMP(p_point.z, pos_local.z, pos_local.x + aabb.size.z);
+	clamped_point.z = CLAMP(p_point.z, pos_local.z, pos_local.z + aabb.size.z);
 
 	r_x = (clamped_point.x < 0.0) ? (clamped_point.x - 0.5) : (clamped_point.x + 0.5);
 	r_y = (clamped_point.y < 0.0) ? (clamped_point.y - 0.5) : (clamped_point.y + 0.5);
@@ -1896,16 +1806,51 @@ void HeightMapShape3DSW::cull(const AABB &p_local_aabb, Callback p_callback, voi
 		aabb_max[i]++;
 	}
 
-	int start_x = MAX(0, aabb_min[0]);
-	int end_x = MIN(width - 1, aabb_max[0]);
-	int start_z = MAX(0, aabb_min[2]);
-	int end_z = MIN(depth - 1, aabb_max[2]);
+	const int cells_min[2] = { MAX(0, aabb_min[0]), MAX(0, aabb_min[2]) };
+	const int cells_max[2] = { MIN(width - 1, aabb_max[0]), MIN(depth - 1, aabb_max[2]) };
+	if (bounds_levels.is_empty() || cells_min[0] >= cells_max[0] || cells_min[1] >= cells_max[1]) {
+		return;
+	}
+
+	_cull_bounds(bounds_levels.size() - 1, 0, 0, cells_min, cells_max, local_aabb.position.y, local_aabb.position.y + local_aabb.size.y, p_callback, p_userdata);
+}
+
+void HeightMapShape3DSW::_cull_bounds(int p_level, int p_x, int p_z, const int p_cells_min[2], const int p_cells_max[2], real_t p_min_height, real_t p_max_height, Callback p_callback, void *p_userdata) const {
+	const BoundsLevel &level = bounds_levels[p_level];
+	const Range &range = level.ranges[p_z * level.width + p_x];
+	if (range.max < p_min_height || range.min > p_max_height) {
+		return;
+	}
+
+	const int node_cells = BOUNDS_CHUNK_SIZE << p_level;
+	int start_x = MAX(p_x * node_cells, p_cells_min[0]);
+	int start_z = MAX(p_z * node_cells, p_cells_min[1]);
+	int end_x = MIN((p_x + 1) * node_cells, p_cells_max[0]);
+	int end_z = MIN((p_z + 1) * node_cells, p_cells_max[1]);
+	if (start_x >= end_x || start_z >= end_z) {
+		return;
+	}
+
+	if (p_level > 0) {
+		for (int z = p_z * 2; z < MIN(p_z * 2 + 2, bounds_levels[p_level - 1].depth); z++) {
+			for (int x = p_x * 2; x < MIN(p_x * 2 + 2, bounds_levels[p_level - 1].width); x++) {
+				_cull_bounds(p_level - 1, x, z, p_cells_min, p_cells_max, p_min_height, p_max_height, p_callback, p_userdata);
+			}
+		}
+		return;
+	}
 
 	FaceShape3DSW face;
 	face.backface_collision = true;
 
 	for (int z = start_z; z < end_z; z++) {
 		for (int x = start_x; x < end_x; x++) {
+			Range cell_range;
+			_get_cell_range(x, z, cell_range);
+			if (cell_range.max < p_min_height || cell_range.min > p_max_height) {
+				continue;
+			}
+
 			// First triangle.
 			_get_point(x, z, face.vertex[0]);
 			_get_point(x + 1, z, face.vertex[1]);
@@ -1932,11 +1877,122 @@ Vector3 HeightMapShape3DSW::get_moment_of_inertia(real_t p_mass) const {
 			(p_mass / 3.0) * (extents.x * extents.x + extents.y * extents.y));
 }
 
+void HeightMapShape3DSW::_build_bounds(const Vector<float> &p_previous_heights) {
+	const int cells_width = width - 1;
+	const int cells_depth = depth - 1;
+	if (cells_width <= 0 || cells_depth <= 0) {
+		bounds_levels.clear();
+		return;
+	}
+
+	int chunks_width = (cells_width + BOUNDS_CHUNK_SIZE - 1) >> BOUNDS_CHUNK_SHIFT;
+	int chunks_depth = (cells_depth + BOUNDS_CHUNK_SIZE - 1) >> BOUNDS_CHUNK_SHIFT;
+
+	// When only the heights changed, only the chunks with modified heights and their parents are rebuilt.
+	bool incremental = !bounds_levels.is_empty() && bounds_levels[0].width == chunks_width && bounds_levels[0].depth == chunks_depth && p_previous_heights.size() == heights.size();
+	if (incremental && p_previous_heights.ptr() == heights.ptr()) {
+		return;
+	}
+
+	if (!incremental) {
+		bounds_levels.clear();
+		int level_width = chunks_width;
+		int level_depth = chunks_depth;
+		while (true) {
+			BoundsLevel level;
+			level.width = level_width;
+			level.depth = level_depth;
+			level.ranges.resize(level_width * level_depth);
+			bounds_levels.push_back(level);
+			if (level_width == 1 && level_depth == 1) {
+				break;
+			}
+			level_width = (level_width + 1) / 2;
+			level_depth = (level_depth + 1) / 2;
+		}
+	}
+
+	LocalVector<uint8_t> dirty;
+	LocalVector<uint8_t> parent_dirty;
+	dirty.resize(chunks_width * chunks_depth);
+
+	// Level 0, from the heights.
+	const float *h = heights.ptr();
+	const float *prev_h = p_previous_heights.ptr();
+	BoundsLevel &chunks = bounds_levels[0];
+	for (int cz = 0; cz < chunks_depth; cz++) {
+		for (int cx = 0; cx < chunks_width; cx++) {
+			// Points covered by the chunk, shared with the neighbor chunks at the borders.
+			int start_x = cx << BOUNDS_CHUNK_SHIFT;
+			int start_z = cz << BOUNDS_CHUNK_SHIFT;
+			int end_x = MIN(start_x + BOUNDS_CHUNK_SIZE, cells_width);
+			int end_z = MIN(start_z + BOUNDS_CHUNK_SIZE, cells_depth);
+
+			bool changed = !incremental;
+			for (int z = start_z; z <= end_z && !changed; z++) {
+				changed = memcmp(&h[z * width + start_x], &prev_h[z * width + start_x], sizeof(float) * (end_x - start_x + 1)) != 0;
+			}
+			dirty[cz * chunks_width + cx] = changed;
+			if (!changed) {
+				continue;
+			}
+
+			Range range;
+			range.min = range.max = h[start_z * width + start_x];
+			for (int z = start_z; z <= end_z; z++) {
+				for (int x = start_x; x <= end_x; x++) {
+					float value = h[z * width + x];
+					range.min = MIN(range.min, value);
+					range.max = MAX(range.max, value);
+				}
+			}
+			chunks.ranges[cz * chunks_width + cx] = range;
+		}
+	}
+
+	// Upper levels, merging 2x2 nodes.
+	for (uint32_t i = 1; i < bounds_levels.size(); i++) {
+		const BoundsLevel &children = bounds_levels[i - 1];
+		BoundsLevel &level = bounds_levels[i];
+		parent_dirty.resize(level.width * level.depth);
+
+		for (int z = 0; z < level.depth; z++) {
+			for (int x = 0; x < level.width; x++) {
+				bool changed = false;
+				Range range;
+				range.min = 1e20;
+				range.max = -1e20;
+				for (int cz = z * 2; cz < MIN(z * 2 + 2, children.depth); cz++) {
+					for (int cx = x * 2; cx < MIN(x * 2 + 2, children.width); cx++) {
+						const Range &child = children.ranges[cz * children.width + cx];
+						range.min = MIN(range.min, child.min);
+						range.max = MAX(range.max, child.max);
+						changed = changed || dirty[cz * children.width + cx];
+					}
+				}
+				parent_dirty[z * level.width + x] = changed;
+				if (changed) {
+					level.ranges[z * level.width + x] = range;
+				}
+			}
+		}
+
+		SWAP(dirty, parent_dirty);
+	}
+}
+
 void HeightMapShape3DSW::_setup(const Vector<float> &p_heights, int p_width, int p_depth, real_t p_min_height, real_t p_max_height) {
+	Vector<float> previous_heights = heights;
+	if (p_width != width || p_depth != depth) {
+		previous_heights.clear();
+	}
+
 	heights = p_heights;
 	width = p_width;
 	depth = p_depth;
 
+	_build_bounds(previous_heights);
+
 	// Initialize aabb.
 	AABB aabb;
 	aabb.position = Vector3(0.0, p_min_height, 0.0);
@@ -1996,9 +2052,9 @@ void HeightMapShape3DSW::set_data(const Variant &p_data) {
 		min_height = d["min_height"];
 		max_height = d["max_height"];
 	} else {
-		int heights_size = heights.size();
+		int heights_size = heights_buffer.size();
 		for (int i = 0; i < heights_size; ++i) {
-			float h = heights[i];
+			float h = heights_buffer[i];
 			if (h < min_height) {
 				min_height = h;
 			} else if (h > max_height) {
@@ -32,6 +32,8 @@
 #define SHAPE_SW_H
 
 #include "core/math/geometry_3d.h"
+#include "core/math/triangle_bvh.h"
+#include "core/templates/local_vector.h"
 #include "servers/physics_server_3d.h"
 /*
 
@@ -308,7 +310,6 @@ public:
 	ConvexPolygonShape3DSW();
 };
 
-struct _VolumeSW_BVH;
 struct FaceShape3DSW;
 
 struct ConcavePolygonShape3DSW : public ConcaveShape3DSW {
@@ -322,15 +323,7 @@ struct ConcavePolygonShape3DSW : public ConcaveShape3DSW {
 	Vector<Face> faces;
 	Vector<Vector3> vertices;
 
-	struct BVH {
-		AABB aabb;
-		int left;
-		int right;
-
-		int face_index;
-	};
-
-	Vector<BVH> bvh;
+	TriangleBVH bvh;
 
 	struct _CullParams {
 		AABB aabb;
@@ -338,7 +331,6 @@ struct ConcavePolygonShape3DSW : public ConcaveShape3DSW {
 		void *userdata = nullptr;
 		const Face *faces = nullptr;
 		const Vector3 *vertices = nullptr;
-		const BVH *bvh = nullptr;
 		FaceShape3DSW *face = nullptr;
 	};
 
@@ -346,9 +338,9 @@ struct ConcavePolygonShape3DSW : public ConcaveShape3DSW {
 		Vector3 from;
 		Vector3 to;
 		Vector3 dir;
+		real_t length = 0.0;
 		const Face *faces = nullptr;
 		const Vector3 *vertices = nullptr;
-		const BVH *bvh = nullptr;
 		FaceShape3DSW *face = nullptr;
 
 		Vector3 result;
@@ -359,10 +351,8 @@ struct ConcavePolygonShape3DSW : public ConcaveShape3DSW {
 
 	bool backface_collision = false;
 
-	void _cull_segment(int p_idx, _SegmentCullParams *p_params) const;
-	void _cull(int p_idx, _CullParams *p_params) const;
-
-	void _fill_bvh(_VolumeSW_BVH *p_bvh_tree, BVH *p_bvh_array, int &p_idx);
+	static bool _cull_segment_callback(void *p_userdata, uint32_t p_face, real_t &r_max_t);
+	static bool _cull_callback(void *p_userdata, uint32_t p_face);
 
 	void _setup(const Vector<Vector3> &p_faces, bool p_backface_collision);
 
@@ -394,6 +384,27 @@ struct HeightMapShape3DSW : public ConcaveShape3DSW {
 	int depth = 0;
 	Vector3 local_origin;
 
+	// Min/max heights pyramid, used to skip whole regions in ray and aabb queries.
+	// Level 0 holds the bounds of chunks of BOUNDS_CHUNK_SIZE x BOUNDS_CHUNK_SIZE cells,
+	// each next level merges 2x2 nodes, up to a single root node.
+	enum {
+		BOUNDS_CHUNK_SHIFT = 2,
+		BOUNDS_CHUNK_SIZE = 1 << BOUNDS_CHUNK_SHIFT,
+	};
+
+	struct Range {
+		float min = 0.0;
+		float max = 0.0;
+	};
+
+	struct BoundsLevel {
+		int width = 0;
+		int depth = 0;
+		LocalVector<Range> ranges;
+	};
+
+	LocalVector<BoundsLevel> bounds_levels;
+
 	_FORCE_INLINE_ float _get_height(int p_x, int p_z) const {
 		return heights[(p_z * width) + p_x];
 	}
@@ -404,8 +415,17 @@ struct HeightMapShape3DSW : public ConcaveShape3DSW {
 		r_point.z = p_z - 0.5 * (depth - 1.0);
 	}
 
+	_FORCE_INLINE_ void _get_cell_range(int p_x, int p_z, Range &r_range) const {
+		float h[4] = { _get_height(p_x, p_z), _get_height(p_x + 1, p_z), _get_height(p_x, p_z + 1), _get_height(p_x + 1, p_z + 1) };
+		r_range.min = MIN(MIN(h[0], h[1]), MIN(h[2], h[3]));
+		r_range.max = MAX(MAX(h[0], h[1]), MAX(h[2], h[3]));
+	}
+
 	void _get_cell(const Vector3 &p_point, int &r_x, int &r_y, int &r_z) const;
 
+	void _build_bounds(const Vector<float> &p_previous_heights);
+	void _cull_bounds(int p_level, int p_x, int p_z, const int p_cells_min[2], const int p_cells_max[2], real_t p_min_height, real_t p_max_height, Callback p_callback, void *p_userdata) const;
+
 	void _setup(const Vector<float> &p_heights, int p_width, int p_depth, real_t p_min_height, real_t p_max_height);
 
 public:
@@ -34,6 +34,19 @@
 #include "core/math/geometry_3d.h"
 #include "core/templates/map.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#ifndef REAL_T_IS_DOUBLE
+#define SOFT_BODY_USE_SSE2
+#include <emmintrin.h>
+#endif
+#endif
+
+// Minimum amount of links in a batch to solve it on the worker threads.
+#define SOFT_BODY_LINK_THREADING_MIN 2048
+#define SOFT_BODY_LINK_CHUNK_SIZE 512
+// Batches are tracked with a 64 bit mask per node.
+#define SOFT_BODY_LINK_BATCH_MAX 64
+
 // Based on Bullet soft body.
 
 /*
@@ -52,6 +65,23 @@ subject to the following restrictions:
 */
 ///btSoftBody implementation by Nathanael Presson
 
+void SoftBody3DSW::NodeArrays::resize(uint32_t p_size) {
+	s.resize(p_size);
+	x.resize(p_size);
+	q.resize(p_size);
+	f.resize(p_size);
+	v.resize(p_size);
+	bv.resize(p_size);
+	n.resize(p_size);
+	area.resize(p_size);
+	im.resize(p_size);
+	leaf.resize(p_size);
+}
+
+void SoftBody3DSW::NodeArrays::clear() {
+	resize(0);
+}
+
 SoftBody3DSW::SoftBody3DSW() :
 		CollisionObject3DSW(TYPE_SOFT_BODY),
 		active_list(this) {
@@ -151,15 +181,19 @@ void SoftBody3DSW::update_rendering_server(RenderingServerHandler *p_rendering_s
 		return;
 	}
 
+	if (normals_dirty) {
+		update_normals();
+	}
+
+	const Vector3 *node_positions = nodes.x.ptr();
+	const Vector3 *node_normals = nodes.n.ptr();
+
 	const uint32_t vertex_count = map_visual_to_physics.size();
 	for (uint32_t i = 0; i < vertex_count; ++i) {
 		const uint32_t node_index = map_visual_to_physics[i];
-		const Node &node = nodes[node_index];
-		const Vector3 &vertex_position = node.x;
-		const Vector3 &vertex_normal = node.n;
 
-		p_rendering_server_handler->set_vertex(i, &vertex_position);
-		p_rendering_server_handler->set_normal(i, &vertex_normal);
+		p_rendering_server_handler->set_vertex(i, &node_positions[node_index]);
+		p_rendering_server_handler->set_normal(i, &node_normals[node_index]);
 	}
 
 	p_rendering_server_handler->set_aabb(bounds);
@@ -168,61 +202,72 @@ void SoftBody3DSW::update_rendering_server(RenderingServerHandler *p_rendering_s
 void SoftBody3DSW::update_normals() {
 	uint32_t i, ni;
 
+	const Vector3 *node_positions = nodes.x.ptr();
+	Vector3 *node_normals = nodes.n.ptr();
+
 	for (i = 0, ni = nodes.size(); i < ni; ++i) {
-		nodes[i].n = Vector3();
+		node_normals[i] = Vector3();
 	}
 
 	for (i = 0, ni = faces.size(); i < ni; ++i) {
-		Face &face = faces[i];
-		const Vector3 n = vec3_cross(face.n[0]->x - face.n[2]->x, face.n[0]->x - face.n[1]->x);
-		face.n[0]->n += n;
-		face.n[1]->n += n;
-		face.n[2]->n += n;
-		face.normal = n;
-		face.normal.normalize();
+		const Face &face = faces[i];
+		const Vector3 &x0 = node_positions[face.n[0]];
+		const Vector3 n = vec3_cross(x0 - node_positions[face.n[2]], x0 - node_positions[face.n[1]]);
+		node_normals[face.n[0]] += n;
+		node_normals[face.n[1]] += n;
+		node_normals[face.n[2]] += n;
 	}
 
 	for (i = 0, ni = nodes.size(); i < ni; ++i) {
-		Node &node = nodes[i];
-		real_t len = node.n.length();
+		real_t len = node_normals[i].length();
 		if (len > CMP_EPSILON) {
-			node.n /= len;
+			node_normals[i] /= len;
 		}
 	}
+
+	normals_dirty = false;
 }
 
-void SoftBody3DSW::update_bounds() {
+void SoftBody3DSW::compute_bounds() {
 	AABB prev_bounds = bounds;
 	prev_bounds.grow_by(collision_margin);
 
 	bounds = AABB();
+	bounds_moved = false;
 
 	const uint32_t nodes_count = nodes.size();
 	if (nodes_count == 0) {
-		deinitialize_shape();
 		return;
 	}
 
-	bool first = true;
-	bool moved = false;
+	const Vector3 *node_positions = nodes.x.ptr();
+
+	bounds.position = node_positions[0];
 	for (uint32_t node_index = 0; node_index < nodes_count; ++node_index) {
-		const Node &node = nodes[node_index];
-		if (!prev_bounds.has_point(node.x)) {
-			moved = true;
-		}
-		if (first) {
-			bounds.position = node.x;
-			first = false;
-		} else {
-			bounds.expand_to(node.x);
+		const Vector3 &node_position = node_positions[node_index];
+		if (!prev_bounds.has_point(node_position)) {
+			bounds_moved = true;
 		}
+		bounds.expand_to(node_position);
+	}
+}
+
+void SoftBody3DSW::update_shape() {
+	if (nodes.is_empty()) {
+		deinitialize_shape();
+		return;
 	}
 
 	if (get_space()) {
-		initialize_shape(moved);
+		initialize_shape(bounds_moved);
 	}
 }
 
+void SoftBody3DSW::update_bounds() {
+	compute_bounds();
+	update_shape();
+}
+
 void SoftBody3DSW::update_constants() {
 	reset_link_rest_lengths();
 	update_link_constants();
@@ -236,9 +281,9 @@ void SoftBody3DSW::update_area() {
 	for (i = 0, ni = faces.size(); i < ni; ++i) {
 		Face &face = faces[i];
 
-		const Vector3 &x0 = face.n[0]->x;
-		const Vector3 &x1 = face.n[1]->x;
-		const Vector3 &x2 = face.n[2]->x;
+		const Vector3 &x0 = nodes.x[face.n[0]];
+		const Vector3 &x1 = nodes.x[face.n[1]];
+		const Vector3 &x2 = nodes.x[face.n[2]];
 
 		const Vector3 a = x1 - x0;
 		const Vector3 b = x2 - x0;
@@ -252,23 +297,23 @@ void SoftBody3DSW::update_area() {
 	memset(counts.ptr(), 0, counts.size() * sizeof(int));
 
 	for (i = 0, ni = nodes.size(); i < ni; ++i) {
-		nodes[i].area = 0.0;
+		nodes.area[i] = 0.0;
 	}
 
 	for (i = 0, ni = faces.size(); i < ni; ++i) {
 		const Face &face = faces[i];
 		for (int j = 0; j < 3; ++j) {
-			const int index = (int)(face.n[j] - &nodes[0]);
+			const uint32_t index = face.n[j];
 			counts[index]++;
-			face.n[j]->area += Math::abs(face.ra);
+			nodes.area[index] += Math::abs(face.ra);
 		}
 	}
 
 	for (i = 0, ni = nodes.size(); i < ni; ++i) {
 		if (counts[i] > 0) {
-			nodes[i].area /= (real_t)counts[i];
+			nodes.area[i] /= (real_t)counts[i];
 		} else {
-			nodes[i].area = 0.0;
+			nodes.area[i] = 0.0;
 		}
 	}
 }
@@ -276,7 +321,7 @@ void SoftBody3DSW::update_area() {
 void SoftBody3DSW::reset_link_rest_lengths() {
 	for (uint32_t i = 0, ni = links.size(); i < ni; ++i) {
 		Link &link = links[i];
-		link.rl = (link.n[0]->x - link.n[1]->x).length();
+		link.rl = (nodes.x[link.n[0]] - nodes.x[link.n[1]]).length();
 		link.c1 = link.rl * link.rl;
 	}
 }
@@ -285,7 +330,7 @@ void SoftBody3DSW::update_link_constants() {
 	real_t inv_linear_stiffness = 1.0 / linear_stiffness;
 	for (uint32_t i = 0, ni = links.size(); i < ni; ++i) {
 		Link &link = links[i];
-		link.c0 = (link.n[0]->im + link.n[1]->im) * inv_linear_stiffness;
+		link.c0 = (nodes.im[link.n[0]] + nodes.im[link.n[1]]) * inv_linear_stiffness;
 	}
 }
 
@@ -297,15 +342,15 @@ void SoftBody3DSW::apply_nodes_transform(const Transform &p_transform) {
 	uint32_t node_count = nodes.size();
 	Vector3 leaf_size = Vector3(collision_margin, collision_margin, collision_margin) * 2.0;
 	for (uint32_t node_index = 0; node_index < node_count; ++node_index) {
-		Node &node = nodes[node_index];
+		Vector3 &node_position = nodes.x[node_index];
 
-		node.x = p_transform.xform(node.x);
-		node.q = node.x;
-		node.v = Vector3();
-		node.bv = Vector3();
+		node_position = p_transform.xform(node_position);
+		nodes.q[node_index] = node_position;
+		nodes.v[node_index] = Vector3();
+		nodes.bv[node_index] = Vector3();
 
-		AABB node_aabb(node.x, leaf_size);
-		node_tree.update(node.leaf, node_aabb);
+		AABB node_aabb(node_position, leaf_size);
+		node_tree.update(nodes.leaf[node_index], node_aabb);
 	}
 
 	face_tree.clear();
@@ -324,7 +369,7 @@ Vector3 SoftBody3DSW::get_vertex_position(int p_index) const {
 	uint32_t node_index = map_visual_to_physics[p_index];
 
 	ERR_FAIL_COND_V(node_index >= nodes.size(), Vector3());
-	return nodes[node_index].x;
+	return nodes.x[node_index];
 }
 
 void SoftBody3DSW::set_vertex_position(int p_index, const Vector3 &p_position) {
@@ -336,9 +381,9 @@ void SoftBody3DSW::set_vertex_position(int p_index, const Vector3 &p_position) {
 	uint32_t node_index = map_visual_to_physics[p_index];
 
 	ERR_FAIL_COND(node_index >= nodes.size());
-	Node &node = nodes[node_index];
-	node.q = node.x;
-	node.x = p_position;
+	nodes.q[node_index] = nodes.x[node_index];
+	nodes.x[node_index] = p_position;
+	normals_dirty = true;
 }
 
 void SoftBody3DSW::pin_vertex(int p_index) {
@@ -353,8 +398,7 @@ void SoftBody3DSW::pin_vertex(int p_index) {
 		uint32_t node_index = map_visual_to_physics[p_index];
 
 		ERR_FAIL_COND(node_index >= nodes.size());
-		Node &node = nodes[node_index];
-		node.im = 0.0;
+		nodes.im[node_index] = 0.0;
 	}
 }
 
@@ -371,8 +415,7 @@ void SoftBody3DSW::unpin_vertex(int p_index) {
 				ERR_FAIL_COND(node_index >= nodes.size());
 				real_t inv_node_mass = nodes.size() * inv_total_mass;
 
-				Node &node = nodes[node_index];
-				node.im = inv_node_mass;
+				nodes.im[node_index] = inv_node_mass;
 			}
 
 			return;
@@ -391,8 +434,7 @@ void SoftBody3DSW::unpin_all_vertices() {
 			uint32_t node_index = map_visual_to_physics[vertex_index];
 
 			ERR_CONTINUE(node_index >= nodes.size());
-			Node &node = nodes[node_index];
-			node.im = inv_node_mass;
+			nodes.im[node_index] = inv_node_mass;
 		}
 	}
 
@@ -416,34 +458,32 @@ uint32_t SoftBody3DSW::get_node_count() const {
 
 real_t SoftBody3DSW::get_node_inv_mass(uint32_t p_node_index) const {
 	ERR_FAIL_COND_V(p_node_index >= nodes.size(), 0.0);
-	return nodes[p_node_index].im;
+	return nodes.im[p_node_index];
 }
 
 Vector3 SoftBody3DSW::get_node_position(uint32_t p_node_index) const {
 	ERR_FAIL_COND_V(p_node_index >= nodes.size(), Vector3());
-	return nodes[p_node_index].x;
+	return nodes.x[p_node_index];
 }
 
 Vector3 SoftBody3DSW::get_node_velocity(uint32_t p_node_index) const {
 	ERR_FAIL_COND_V(p_node_index >= nodes.size(), Vector3());
-	return nodes[p_node_index].v;
+	return nodes.v[p_node_index];
 }
 
 Vector3 SoftBody3DSW::get_node_biased_velocity(uint32_t p_node_index) const {
 	ERR_FAIL_COND_V(p_node_index >= nodes.size(), Vector3());
-	return nodes[p_node_index].bv;
+	return nodes.bv[p_node_index];
 }
 
 void SoftBody3DSW::apply_node_impulse(uint32_t p_node_index, const Vector3 &p_impulse) {
 	ERR_FAIL_COND(p_node_index >= nodes.size());
-	Node &node = nodes[p_node_index];
-	node.v += p_impulse * node.im;
+	nodes.v[p_node_index] += p_impulse * nodes.im[p_node_index];
 }
 
 void SoftBody3DSW::apply_node_bias_impulse(uint32_t p_node_index, const Vector3 &p_impulse) {
 	ERR_FAIL_COND(p_node_index >= nodes.size());
-	Node &node = nodes[p_node_index];
-	node.bv += p_impulse * node.im;
+	nodes.bv[p_node_index] += p_impulse * nodes.im[p_node_index];
 }
 
 uint32_t SoftBody3DSW::get_face_count() const {
@@ -453,14 +493,17 @@ uint32_t SoftBody3DSW::get_face_count() const {
 void SoftBody3DSW::get_face_points(uint32_t p_face_index, Vector3 &r_point_1, Vector3 &r_point_2, Vector3 &r_point_3) const {
 	ERR_FAIL_COND(p_face_index >= faces.size());
 	const Face &face = faces[p_face_index];
-	r_point_1 = face.n[0]->x;
-	r_point_2 = face.n[1]->x;
-	r_point_3 = face.n[2]->x;
+	r_point_1 = nodes.x[face.n[0]];
+	r_point_2 = nodes.x[face.n[1]];
+	r_point_3 = nodes.x[face.n[2]];
 }
 
 Vector3 SoftBody3DSW::get_face_normal(uint32_t p_face_index) const {
 	ERR_FAIL_COND_V(p_face_index >= faces.size(), Vector3());
-	return faces[p_face_index].normal;
+	// Computed from the current positions, so it's valid even if normals are out of date.
+	const Face &face = faces[p_face_index];
+	const Vector3 &x0 = nodes.x[face.n[0]];
+	return vec3_cross(x0 - nodes.x[face.n[2]], x0 - nodes.x[face.n[1]]).normalized();
 }
 
 bool SoftBody3DSW::create_from_trimesh(const Vector<int> &p_indices, const Vector<Vector3> &p_vertices) {
@@ -523,32 +566,33 @@ bool SoftBody3DSW::create_from_trimesh(const Vector<int> &p_indices, const Vecto
 	real_t inv_node_mass = node_count * inv_total_mass;
 	Vector3 leaf_size = Vector3(collision_margin, collision_margin, collision_margin) * 2.0;
 	for (uint32_t i = 0; i < node_count; ++i) {
-		Node &node = nodes[i];
-		node.s = vertices[i];
-		node.x = node.s;
-		node.q = node.s;
-		node.im = inv_node_mass;
-
-		AABB node_aabb(node.x, leaf_size);
-		node.leaf = node_tree.insert(node_aabb, &node);
-
-		node.index = i;
+		nodes.s[i] = vertices[i];
+		nodes.x[i] = vertices[i];
+		nodes.q[i] = vertices[i];
+		nodes.f[i] = Vector3();
+		nodes.v[i] = Vector3();
+		nodes.bv[i] = Vector3();
+		nodes.n[i] = Vector3();
+		nodes.area[i] = 0.0;
+		nodes.im[i] = inv_node_mass;
+
+		AABB node_aabb(vertices[i], leaf_size);
+		nodes.leaf[i] = node_tree.insert(node_aabb, (void *)(uintptr_t)i);
 	}
 
 	// Create links and faces from triangles.
-	LocalVector<bool> chks;
-	chks.resize(node_count * node_count);
-	memset(chks.ptr(), 0, chks.size() * sizeof(bool));
+	// Node neighbours are tracked per node, an adjacency matrix doesn't scale with the node count.
+	LocalVector<LocalVector<uint32_t>> node_neighbors;
+	node_neighbors.resize(node_count);
 
 	for (uint32_t i = 0; i < triangle_count * 3; i += 3) {
 		const int idx[] = { triangles[i], triangles[i + 1], triangles[i + 2] };
 
 		for (int j = 2, k = 0; k < 3; j = k++) {
-			int chk = idx[k] * node_count + idx[j];
-			if (!chks[chk]) {
-				chks[chk] = true;
-				int inv_chk = idx[j] * node_count + idx[k];
-				chks[inv_chk] = true;
+			LocalVector<uint32_t> &neighbors = node_neighbors[idx[k]];
+			if (neighbors.find(idx[j]) == -1) {
+				neighbors.push_back(idx[j]);
+				node_neighbors[idx[j]].push_back(idx[k]);
 
 				append_link(idx[j], idx[k]);
 			}
@@ -566,12 +610,11 @@ bool SoftBody3DSW::create_from_trimesh(const Vector<int> &p_indices, const Vecto
 		uint32_t node_index = map_visual_to_physics[pinned_vertex];
 
 		ERR_CONTINUE(node_index >= node_count);
-		Node &node = nodes[node_index];
-		node.im = 0.0;
+		nodes.im[node_index] = 0.0;
 	}
 
 	generate_bending_constraints(2);
-	reoptimize_link_order();
+	update_link_batches();
 
 	update_constants();
 	update_normals();
@@ -583,229 +626,176 @@ bool SoftBody3DSW::create_from_trimesh(const Vector<int> &p_indices, const Vecto
 void SoftBody3DSW::generate_bending_constraints(int p_distance) {
 	uint32_t i, j;
 
-	if (p_distance > 1) {
-		// Build graph.
-		const uint32_t n = nodes.size();
-		const unsigned inf = (~(unsigned)0) >> 1;
-		const uint32_t adj_size = n * n;
-		unsigned *adj = memnew_arr(unsigned, adj_size);
+	if (p_distance < 2) {
+		return;
+	}
+
+	const uint32_t n = nodes.size();
+
+	// Special optimized case for distance == 2, which only needs to look at the neighbours of neighbours.
+	if (p_distance == 2) {
+		LocalVector<LocalVector<uint32_t>> node_links;
+
+		// Build node links.
+		node_links.resize(n);
 
-#define IDX(_x_, _y_) ((_y_)*n + (_x_))
-		for (j = 0; j < n; ++j) {
-			for (i = 0; i < n; ++i) {
-				int idx_ij = j * n + i;
-				int idx_ji = i * n + j;
-				if (i != j) {
-					adj[idx_ij] = adj[idx_ji] = inf;
-				} else {
-					adj[idx_ij] = adj[idx_ji] = 0;
-				}
-			}
-		}
 		for (i = 0; i < links.size(); ++i) {
-			const int ia = (int)(links[i].n[0] - &nodes[0]);
-			const int ib = (int)(links[i].n[1] - &nodes[0]);
-			int idx = ib * n + ia;
-			int idx_inv = ia * n + ib;
-			adj[idx] = 1;
-			adj[idx_inv] = 1;
-		}
+			const uint32_t ia = links[i].n[0];
+			const uint32_t ib = links[i].n[1];
+			if (node_links[ia].find(ib) == -1) {
+				node_links[ia].push_back(ib);
+			}
 
-		// Special optimized case for distance == 2.
-		if (p_distance == 2) {
-			LocalVector<LocalVector<int>> node_links;
+			if (node_links[ib].find(ia) == -1) {
+				node_links[ib].push_back(ia);
+			}
+		}
 
-			// Build node links.
-			node_links.resize(nodes.size());
+		// Nodes marked with the current node are either itself or at distance 1.
+		LocalVector<uint32_t> mark;
+		mark.resize(n);
+		memset(mark.ptr(), 0, n * sizeof(uint32_t));
 
-			for (i = 0; i < links.size(); ++i) {
-				const int ia = (int)(links[i].n[0] - &nodes[0]);
-				const int ib = (int)(links[i].n[1] - &nodes[0]);
-				if (node_links[ia].find(ib) == -1) {
-					node_links[ia].push_back(ib);
-				}
+		LocalVector<uint32_t> found;
+		for (j = 0; j < n; ++j) {
+			const uint32_t stamp = j + 1;
+			const LocalVector<uint32_t> &neighbors = node_links[j];
 
-				if (node_links[ib].find(ia) == -1) {
-					node_links[ib].push_back(ia);
-				}
+			mark[j] = stamp;
+			for (i = 0; i < neighbors.size(); ++i) {
+				mark[neighbors[i]] = stamp;
 			}
-			for (uint32_t ii = 0; ii < node_links.size(); ii++) {
-				for (uint32_t jj = 0; jj < node_links[ii].size(); jj++) {
-					int k = node_links[ii][jj];
-					for (uint32_t kk = 0; kk < node_links[k].size(); kk++) {
-						int l = node_links[k][kk];
-						if ((int)ii != l) {
-							int idx_ik = k * n + ii;
-							int idx_kj = l * n + k;
-							const unsigned sum = adj[idx_ik] + adj[idx_kj];
-							ERR_FAIL_COND(sum != 2);
-							int idx_ij = l * n + ii;
-							if (adj[idx_ij] > sum) {
-								int idx_ji = l * n + ii;
-								adj[idx_ij] = adj[idx_ji] = sum;
-							}
-						}
+
+			found.clear();
+			for (i = 0; i < neighbors.size(); ++i) {
+				const LocalVector<uint32_t> &second_neighbors = node_links[neighbors[i]];
+				for (uint32_t k = 0; k < second_neighbors.size(); ++k) {
+					const uint32_t l = second_neighbors[k];
+					if (l > j && mark[l] != stamp) {
+						mark[l] = stamp;
+						found.push_back(l);
 					}
 				}
 			}
-		} else {
-			// Generic Floyd's algorithm.
-			for (uint32_t k = 0; k < n; ++k) {
-				for (j = 0; j < n; ++j) {
-					for (i = j + 1; i < n; ++i) {
-						int idx_ik = k * n + i;
-						int idx_kj = j * n + k;
-						const unsigned sum = adj[idx_ik] + adj[idx_kj];
-						int idx_ij = j * n + i;
-						if (adj[idx_ij] > sum) {
-							int idx_ji = j * n + i;
-							adj[idx_ij] = adj[idx_ji] = sum;
-						}
-					}
-				}
+
+			// Same order as building the links from a distance matrix.
+			found.sort();
+			for (i = 0; i < found.size(); ++i) {
+				append_link(found[i], j);
 			}
 		}
+		return;
+	}
 
-		// Build links.
+	// Build graph.
+	const unsigned inf = (~(unsigned)0) >> 1;
+	const uint32_t adj_size = n * n;
+	unsigned *adj = memnew_arr(unsigned, adj_size);
+
+	for (j = 0; j < n; ++j) {
+		for (i = 0; i < n; ++i) {
+			int idx_ij = j * n + i;
+			int idx_ji = i * n + j;
+			if (i != j) {
+				adj[idx_ij] = adj[idx_ji] = inf;
+			} else {
+				adj[idx_ij] = adj[idx_ji] = 0;
+			}
+		}
+	}
+	for (i = 0; i < links.size(); ++i) {
+		const uint32_t ia = links[i].n[0];
+		const uint32_t ib = links[i].n[1];
+		int idx = ib * n + ia;
+		int idx_inv = ia * n + ib;
+		adj[idx] = 1;
+		adj[idx_inv] = 1;
+	}
+
+	// Generic Floyd's algorithm.
+	for (uint32_t k = 0; k < n; ++k) {
 		for (j = 0; j < n; ++j) {
 			for (i = j + 1; i < n; ++i) {
+				int idx_ik = k * n + i;
+				int idx_kj = j * n + k;
+				const unsigned sum = adj[idx_ik] + adj[idx_kj];
 				int idx_ij = j * n + i;
-				if (adj[idx_ij] == (unsigned)p_distance) {
-					append_link(i, j);
+				if (adj[idx_ij] > sum) {
+					int idx_ji = j * n + i;
+					adj[idx_ij] = adj[idx_ji] = sum;
 				}
 			}
 		}
-		memdelete_arr(adj);
-	}
-}
-
-//===================================================================
-//
-//
-// This function takes in a list of interdependent Links and tries
-// to maximize the distance between calculation
-// of dependent links.  This increases the amount of parallelism that can
-// be exploited by out-of-order instruction processors with large but
-// (inevitably) finite instruction windows.
-//
-//===================================================================
-
-// A small structure to track lists of dependent link calculations.
-class LinkDeps {
-public:
-	int value; // A link calculation that is dependent on this one
-			// Positive values = "input A" while negative values = "input B"
-	LinkDeps *next; // Next dependence in the list
-};
-typedef LinkDeps *LinkDepsPtr;
-
-void SoftBody3DSW::reoptimize_link_order() {
-	const int reop_not_dependent = -1;
-	const int reop_node_complete = -2;
-
-	uint32_t i, link_count = links.size(), node_count = nodes.size();
-	Link *lr;
-	int ar, br;
-	Node *node0 = &(nodes[0]);
-	Node *node1 = &(nodes[1]);
-	LinkDepsPtr link_dep;
-	int ready_list_head, ready_list_tail, link_num, link_dep_frees, dep_link;
-
-	// Allocate temporary buffers.
-	int *node_written_at = memnew_arr(int, node_count + 1); // What link calculation produced this node's current values?
-	int *link_dep_A = memnew_arr(int, link_count); // Link calculation input is dependent upon prior calculation #N
-	int *link_dep_B = memnew_arr(int, link_count);
-	int *ready_list = memnew_arr(int, link_count); // List of ready-to-process link calculations (# of links, maximum)
-	LinkDeps *link_dep_free_list = memnew_arr(LinkDeps, 2 * link_count); // Dependent-on-me list elements (2x# of links, maximum)
-	LinkDepsPtr *link_dep_list_starts = memnew_arr(LinkDepsPtr, link_count); // Start nodes of dependent-on-me lists, one for each link
-
-	// Copy the original, unsorted links to a side buffer.
-	Link *link_buffer = memnew_arr(Link, link_count);
-	memcpy(link_buffer, &(links[0]), sizeof(Link) * link_count);
-
-	// Clear out the node setup and ready list.
-	for (i = 0; i < node_count + 1; i++) {
-		node_written_at[i] = reop_not_dependent;
-	}
-	for (i = 0; i < link_count; i++) {
-		link_dep_list_starts[i] = nullptr;
-	}
-	ready_list_head = ready_list_tail = link_dep_frees = 0;
-
-	// Initial link analysis to set up data structures.
-	for (i = 0; i < link_count; i++) {
-		// Note which prior link calculations we are dependent upon & build up dependence lists.
-		lr = &(links[i]);
-		ar = (lr->n[0] - node0) / (node1 - node0);
-		br = (lr->n[1] - node0) / (node1 - node0);
-		if (node_written_at[ar] > reop_not_dependent) {
-			link_dep_A[i] = node_written_at[ar];
-			link_dep = &link_dep_free_list[link_dep_frees++];
-			link_dep->value = i;
-			link_dep->next = link_dep_list_starts[node_written_at[ar]];
-			link_dep_list_starts[node_written_at[ar]] = link_dep;
-		} else {
-			link_dep_A[i] = reop_not_dependent;
-		}
-		if (node_written_at[br] > reop_not_dependent) {
-			link_dep_B[i] = node_written_at[br];
-			link_dep = &link_dep_free_list[link_dep_frees++];
-			link_dep->value = -(int)(i + 1);
-			link_dep->next = link_dep_list_starts[node_written_at[br]];
-			link_dep_list_starts[node_written_at[br]] = link_dep;
-		} else {
-			link_dep_B[i] = reop_not_dependent;
-		}
+	}
 
-		// Add this link to the initial ready list, if it is not dependent on any other links.
-		if ((link_dep_A[i] == reop_not_dependent) && (link_dep_B[i] == reop_not_dependent)) {
-			ready_list[ready_list_tail++] = i;
-			link_dep_A[i] = link_dep_B[i] = reop_node_complete; // Probably not needed now.
+	// Build links.
+	for (j = 0; j < n; ++j) {
+		for (i = j + 1; i < n; ++i) {
+			int idx_ij = j * n + i;
+			if (adj[idx_ij] == (unsigned)p_distance) {
+				append_link(i, j);
+			}
 		}
+	}
+	memdelete_arr(adj);
+}
 
-		// Update the nodes to mark which ones are calculated by this link.
-		node_written_at[ar] = node_written_at[br] = i;
-	}
-
-	// Process the ready list and create the sorted list of links:
-	// -- By treating the ready list as a queue, we maximize the distance between any
-	//    inter-dependent node calculations.
-	// -- All other (non-related) nodes in the ready list will automatically be inserted
-	//    in between each set of inter-dependent link calculations by this loop.
-	i = 0;
-	while (ready_list_head != ready_list_tail) {
-		// Use ready list to select the next link to process.
-		link_num = ready_list[ready_list_head++];
-		// Copy the next-to-calculate link back into the original link array.
-		links[i++] = link_buffer[link_num];
-
-		// Free up any link inputs that are dependent on this one.
-		link_dep = link_dep_list_starts[link_num];
-		while (link_dep) {
-			dep_link = link_dep->value;
-			if (dep_link >= 0) {
-				link_dep_A[dep_link] = reop_not_dependent;
-			} else {
-				dep_link = -dep_link - 1;
-				link_dep_B[dep_link] = reop_not_dependent;
-			}
-			// Add this dependent link calculation to the ready list if *both* inputs are clear.
-			if ((link_dep_A[dep_link] == reop_not_dependent) && (link_dep_B[dep_link] == reop_not_dependent)) {
-				ready_list[ready_list_tail++] = dep_link;
-				link_dep_A[dep_link] = link_dep_B[dep_link] = reop_node_complete; // Probably not needed now.
+void SoftBody3DSW::update_link_batches() {
+	// Greedy coloring of the links, so that links within a batch never write to the same node.
+	// Each node keeps a mask of the batches already touching it.
+	const uint32_t link_count = links.size();
+
+	LocalVector<uint64_t> node_batches;
+	node_batches.resize(nodes.size());
+	memset(node_batches.ptr(), 0, nodes.size() * sizeof(uint64_t));
+
+	LocalVector<uint8_t> link_batch;
+	link_batch.resize(link_count);
+
+	uint32_t batch_counts[SOFT_BODY_LINK_BATCH_MAX + 1] = {};
+	uint32_t batch_count = 0;
+
+	for (uint32_t i = 0; i < link_count; ++i) {
+		const Link &link = links[i];
+		const uint64_t used = node_batches[link.n[0]] | node_batches[link.n[1]];
+
+		uint32_t batch = SOFT_BODY_LINK_BATCH_MAX;
+		if (used != ~(uint64_t)0) {
+			batch = 0;
+			while (used & ((uint64_t)1 << batch)) {
+				++batch;
 			}
-			link_dep = link_dep->next;
+			const uint64_t batch_bit = (uint64_t)1 << batch;
+			node_batches[link.n[0]] |= batch_bit;
+			node_batches[link.n[1]] |= batch_bit;
+			batch_count = MAX(batch_count, batch + 1);
 		}
+
+		link_batch[i] = batch;
+		batch_counts[batch]++;
 	}
 
-	// Delete the temporary buffers.
-	memdelete_arr(node_written_at);
-	memdelete_arr(link_dep_A);
-	memdelete_arr(link_dep_B);
-	memdelete_arr(ready_list);
-	memdelete_arr(link_dep_free_list);
-	memdelete_arr(link_dep_list_starts);
-	memdelete_arr(link_buffer);
+	// Sort the links by batch, keeping their relative order. The serial batch always goes last.
+	link_parallel_batch_count = batch_count;
+	link_batch_offsets.resize(batch_count + 2);
+
+	uint32_t offset = 0;
+	for (uint32_t batch = 0; batch < batch_count; ++batch) {
+		link_batch_offsets[batch] = offset;
+		offset += batch_counts[batch];
+	}
+	link_batch_offsets[batch_count] = offset;
+	link_batch_offsets[batch_count + 1] = link_count;
+
+	LocalVector<uint32_t> write_offsets = link_batch_offsets;
+	LocalVector<Link> sorted_links;
+	sorted_links.resize(link_count);
+	for (uint32_t i = 0; i < link_count; ++i) {
+		const uint32_t batch = MIN((uint32_t)link_batch[i], batch_count);
+		sorted_links[write_offsets[batch]++] = links[i];
+	}
+
+	links = sorted_links;
 }
 
 void SoftBody3DSW::append_link(uint32_t p_node1, uint32_t p_node2) {
@@ -813,13 +803,10 @@ void SoftBody3DSW::append_link(uint32_t p_node1, uint32_t p_node2) {
 		return;
 	}
 
-	Node *node1 = &nodes[p_node1];
-	Node *node2 = &nodes[p_node2];
-
 	Link link;
-	link.n[0] = node1;
-	link.n[1] = node2;
-	link.rl = (node1->x - node2->x).length();
+	link.n[0] = p_node1;
+	link.n[1] = p_node2;
+	link.rl = (nodes.x[p_node1] - nodes.x[p_node2]).length();
 
 	links.push_back(link);
 }
@@ -835,16 +822,10 @@ void SoftBody3DSW::append_face(uint32_t p_node1, uint32_t p_node2, uint32_t p_no
 		return;
 	}
 
-	Node *node1 = &nodes[p_node1];
-	Node *node2 = &nodes[p_node2];
-	Node *node3 = &nodes[p_node3];
-
 	Face face;
-	face.n[0] = node1;
-	face.n[1] = node2;
-	face.n[2] = node3;
-
-	face.index = faces.size();
+	face.n[0] = p_node1;
+	face.n[1] = p_node2;
+	face.n[2] = p_node3;
 
 	faces.push_back(face);
 }
@@ -862,8 +843,7 @@ void SoftBody3DSW::set_total_mass(real_t p_val) {
 
 	uint32_t node_count = nodes.size();
 	for (uint32_t node_index = 0; node_index < node_count; ++node_index) {
-		Node &node = nodes[node_index];
-		node.im *= mass_factor;
+		nodes.im[node_index] *= mass_factor;
 	}
 
 	update_constants();
@@ -890,10 +870,11 @@ void SoftBody3DSW::set_drag_coefficient(real_t p_val) {
 }
 
 void SoftBody3DSW::add_velocity(const Vector3 &p_velocity) {
+	const real_t *node_inv_masses = nodes.im.ptr();
+	Vector3 *node_velocities = nodes.v.ptr();
 	for (uint32_t i = 0, ni = nodes.size(); i < ni; ++i) {
-		Node &node = nodes[i];
-		if (node.im > 0) {
-			node.v += p_velocity;
+		if (node_inv_masses[i] > 0) {
+			node_velocities[i] += p_velocity;
 		}
 	}
 }
@@ -907,23 +888,26 @@ void SoftBody3DSW::apply_forces() {
 		return;
 	}
 
+	if (normals_dirty) {
+		update_normals();
+	}
+
 	uint32_t i, ni;
 
 	// Calculate volume.
 	real_t volume = 0.0;
-	const Vector3 &org = nodes[0].x;
+	const Vector3 &org = nodes.x[0];
 	for (i = 0, ni = faces.size(); i < ni; ++i) {
 		const Face &face = faces[i];
-		volume += vec3_dot(face.n[0]->x - org, vec3_cross(face.n[1]->x - org, face.n[2]->x - org));
+		volume += vec3_dot(nodes.x[face.n[0]] - org, vec3_cross(nodes.x[face.n[1]] - org, nodes.x[face.n[2]] - org));
 	}
 	volume /= 6.0;
 
 	// Apply per node forces.
 	real_t ivolumetp = 1.0 / Math::abs(volume) * pressure_coefficient;
 	for (i = 0, ni = nodes.size(); i < ni; ++i) {
-		Node &node = nodes[i];
-		if (node.im > 0) {
-			node.f += node.n * (node.area * ivolumetp);
+		if (nodes.im[i] > 0) {
+			nodes.f[i] += nodes.n[i] * (nodes.area[i] * ivolumetp);
 		}
 	}
 }
@@ -946,32 +930,36 @@ void SoftBody3DSW::predict_motion(real_t p_delta) {
 	const real_t max_displacement = 1000.0;
 	real_t clamp_delta_v = max_displacement * inv_delta;
 
+	Vector3 *node_positions = nodes.x.ptr();
+	Vector3 *node_prev_positions = nodes.q.ptr();
+	Vector3 *node_forces = nodes.f.ptr();
+	Vector3 *node_velocities = nodes.v.ptr();
+	const real_t *node_inv_masses = nodes.im.ptr();
+
 	// Integrate.
 	uint32_t i, ni;
 	for (i = 0, ni = nodes.size(); i < ni; ++i) {
-		Node &node = nodes[i];
-		node.q = node.x;
-		Vector3 delta_v = node.f * node.im * p_delta;
+		node_prev_positions[i] = node_positions[i];
+		Vector3 delta_v = node_forces[i] * node_inv_masses[i] * p_delta;
 		for (int c = 0; c < 3; c++) {
 			delta_v[c] = CLAMP(delta_v[c], -clamp_delta_v, clamp_delta_v);
 		}
-		node.v += delta_v;
-		node.x += node.v * p_delta;
-		node.f = Vector3();
+		node_velocities[i] += delta_v;
+		node_positions[i] += node_velocities[i] * p_delta;
+		node_forces[i] = Vector3();
 	}
+	normals_dirty = true;
 
-	// Bounds and tree update.
-	update_bounds();
+	// Bounds and tree update, the shape is moved to the new bounds in update_shape().
+	compute_bounds();
 
 	// Node tree update.
 	for (i = 0, ni = nodes.size(); i < ni; ++i) {
-		const Node &node = nodes[i];
-
-		AABB node_aabb(node.x, Vector3());
-		node_aabb.expand_to(node.x + node.v * p_delta);
+		AABB node_aabb(node_positions[i], Vector3());
+		node_aabb.expand_to(node_positions[i] + node_velocities[i] * p_delta);
 		node_aabb.grow_by(collision_margin);
 
-		node_tree.update(node.leaf, node_aabb);
+		node_tree.update(nodes.leaf[i], node_aabb);
 	}
 
 	// Face tree update.
@@ -984,55 +972,160 @@ void SoftBody3DSW::predict_motion(real_t p_delta) {
 	face_tree.optimize_incremental(1);
 }
 
-void SoftBody3DSW::solve_constraints(real_t p_delta) {
+void SoftBody3DSW::solve_constraints(real_t p_delta, ThreadWorkPool *p_work_pool) {
 	const real_t inv_delta = 1.0 / p_delta;
 
 	uint32_t i, ni;
 
-	for (i = 0, ni = links.size(); i < ni; ++i) {
-		Link &link = links[i];
-		link.c3 = link.n[1]->q - link.n[0]->q;
-		link.c2 = 1 / (link.c3.length_squared() * link.c0);
-	}
+	Vector3 *node_positions = nodes.x.ptr();
+	Vector3 *node_prev_positions = nodes.q.ptr();
+	Vector3 *node_velocities = nodes.v.ptr();
+	Vector3 *node_biased_velocities = nodes.bv.ptr();
 
 	// Solve velocities.
 	for (i = 0, ni = nodes.size(); i < ni; ++i) {
-		Node &node = nodes[i];
-		node.x = node.q + node.v * p_delta;
+		node_positions[i] = node_prev_positions[i] + node_velocities[i] * p_delta;
 	}
 
 	// Solve positions.
 	for (int isolve = 0; isolve < iteration_count; ++isolve) {
 		const real_t ti = isolve / (real_t)iteration_count;
-		solve_links(1.0, ti);
+		solve_links(1.0, ti, p_work_pool);
 	}
 	const real_t vc = (1.0 - damping_coefficient) * inv_delta;
 	for (i = 0, ni = nodes.size(); i < ni; ++i) {
-		Node &node = nodes[i];
+		node_positions[i] += node_biased_velocities[i] * p_delta;
+		node_biased_velocities[i] = Vector3();
 
-		node.x += node.bv * p_delta;
-		node.bv = Vector3();
+		node_velocities[i] = (node_positions[i] - node_prev_positions[i]) * vc;
 
-		node.v = (node.x - node.q) * vc;
+		node_prev_positions[i] = node_positions[i];
+	}
+
+	normals_dirty = true;
+}
 
-		node.q = node.x;
+void SoftBody3DSW::update_rendering_data() {
+	if (normals_dirty) {
+		update_normals();
 	}
+}
 
-	update_normals();
+void SoftBody3DSW::solve_links(real_t kst, real_t ti, ThreadWorkPool *p_work_pool) {
+	if (link_batch_offsets.is_empty()) {
+		return;
+	}
+
+	const uint32_t batch_count = link_batch_offsets.size() - 1;
+	for (uint32_t batch_index = 0; batch_index < batch_count; ++batch_index) {
+		LinkBatch batch;
+		batch.begin = link_batch_offsets[batch_index];
+		batch.end = link_batch_offsets[batch_index + 1];
+		batch.kst = kst;
+
+		const bool independent = batch_index < link_parallel_batch_count;
+		const uint32_t link_count = batch.end - batch.begin;
+		if (p_work_pool && independent && link_count >= SOFT_BODY_LINK_THREADING_MIN) {
+			const uint32_t chunk_count = (link_count + SOFT_BODY_LINK_CHUNK_SIZE - 1) / SOFT_BODY_LINK_CHUNK_SIZE;
+			p_work_pool->do_work(chunk_count, this, &SoftBody3DSW::_solve_link_chunk, &batch);
+		} else {
+			_solve_link_range(batch.begin, batch.end, kst, independent);
+		}
+	}
 }
 
-void SoftBody3DSW::solve_links(real_t kst, real_t ti) {
-	for (uint32_t i = 0, ni = links.size(); i < ni; ++i) {
-		Link &link = links[i];
+void SoftBody3DSW::_solve_link_chunk(uint32_t p_chunk_index, LinkBatch *p_batch) {
+	const uint32_t begin = p_batch->begin + p_chunk_index * SOFT_BODY_LINK_CHUNK_SIZE;
+	const uint32_t end = MIN(begin + SOFT_BODY_LINK_CHUNK_SIZE, p_batch->end);
+	_solve_link_range(begin, end, p_batch->kst, true);
+}
+
+void SoftBody3DSW::_solve_link_range(uint32_t p_begin, uint32_t p_end, real_t p_kst, bool p_independent) {
+	const Link *link_array = links.ptr();
+	Vector3 *node_positions = nodes.x.ptr();
+	const real_t *node_inv_masses = nodes.im.ptr();
+
+	uint32_t i = p_begin;
+
+#ifdef SOFT_BODY_USE_SSE2
+	// Links in an independent batch don't share nodes, so four of them can be solved at once.
+	if (p_independent) {
+		const __m128 kst = _mm_set1_ps(p_kst);
+		const __m128 zero = _mm_setzero_ps();
+		const __m128 epsilon = _mm_set1_ps(CMP_EPSILON);
+
+		for (; i + 4 <= p_end; i += 4) {
+			const Link &l0 = link_array[i];
+			const Link &l1 = link_array[i + 1];
+			const Link &l2 = link_array[i + 2];
+			const Link &l3 = link_array[i + 3];
+
+			Vector3 &a0 = node_positions[l0.n[0]];
+			Vector3 &a1 = node_positions[l1.n[0]];
+			Vector3 &a2 = node_positions[l2.n[0]];
+			Vector3 &a3 = node_positions[l3.n[0]];
+			Vector3 &b0 = node_positions[l0.n[1]];
+			Vector3 &b1 = node_positions[l1.n[1]];
+			Vector3 &b2 = node_positions[l2.n[1]];
+			Vector3 &b3 = node_positions[l3.n[1]];
+
+			const __m128 ax = _mm_setr_ps(a0.x, a1.x, a2.x, a3.x);
+			const __m128 ay = _mm_setr_ps(a0.y, a1.y, a2.y, a3.y);
+			const __m128 az = _mm_setr_ps(a0.z, a1.z, a2.z, a3.z);
+			const __m128 bx = _mm_setr_ps(b0.x, b1.x, b2.x, b3.x);
+			const __m128 by = _mm_setr_ps(b0.y, b1.y, b2.y, b3.y);
+			const __m128 bz = _mm_setr_ps(b0.z, b1.z, b2.z, b3.z);
+
+			const __m128 c0 = _mm_setr_ps(l0.c0, l1.c0, l2.c0, l3.c0);
+			const __m128 c1 = _mm_setr_ps(l0.c1, l1.c1, l2.c1, l3.c1);
+			const __m128 ima = _mm_setr_ps(node_inv_masses[l0.n[0]], node_inv_masses[l1.n[0]], node_inv_masses[l2.n[0]], node_inv_masses[l3.n[0]]);
+			const __m128 imb = _mm_setr_ps(node_inv_masses[l0.n[1]], node_inv_masses[l1.n[1]], node_inv_masses[l2.n[1]], node_inv_masses[l3.n[1]]);
+
+			const __m128 dx = _mm_sub_ps(bx, ax);
+			const __m128 dy = _mm_sub_ps(by, ay);
+			const __m128 dz = _mm_sub_ps(bz, az);
+			const __m128 len = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+			const __m128 c1_len = _mm_add_ps(c1, len);
+
+			// Same conditions as the scalar version, links that fail them get no correction.
+			const __m128 mask = _mm_and_ps(_mm_cmpgt_ps(c0, zero), _mm_cmpgt_ps(c1_len, epsilon));
+			const __m128 denominator = _mm_or_ps(_mm_and_ps(mask, _mm_mul_ps(c0, c1_len)), _mm_andnot_ps(mask, _mm_set1_ps(1.0f)));
+			const __m128 k = _mm_and_ps(mask, _mm_mul_ps(_mm_div_ps(_mm_sub_ps(c1, len), denominator), kst));
+
+			const __m128 ka = _mm_mul_ps(k, ima);
+			const __m128 kb = _mm_mul_ps(k, imb);
+
+			float rax[4], ray[4], raz[4], rbx[4], rby[4], rbz[4];
+			_mm_storeu_ps(rax, _mm_sub_ps(ax, _mm_mul_ps(dx, ka)));
+			_mm_storeu_ps(ray, _mm_sub_ps(ay, _mm_mul_ps(dy, ka)));
+			_mm_storeu_ps(raz, _mm_sub_ps(az, _mm_mul_ps(dz, ka)));
+			_mm_storeu_ps(rbx, _mm_add_ps(bx, _mm_mul_ps(dx, kb)));
+			_mm_storeu_ps(rby, _mm_add_ps(by, _mm_mul_ps(dy, kb)));
+			_mm_storeu_ps(rbz, _mm_add_ps(bz, _mm_mul_ps(dz, kb)));
+
+			a0 = Vector3(rax[0], ray[0], raz[0]);
+			a1 = Vector3(rax[1], ray[1], raz[1]);
+			a2 = Vector3(rax[2], ray[2], raz[2]);
+			a3 = Vector3(rax[3], ray[3], raz[3]);
+			b0 = Vector3(rbx[0], rby[0], rbz[0]);
+			b1 = Vector3(rbx[1], rby[1], rbz[1]);
+			b2 = Vector3(rbx[2], rby[2], rbz[2]);
+			b3 = Vector3(rbx[3], rby[3], rbz[3]);
+		}
+	}
+#endif
+
+	for (; i < p_end; ++i) {
+		const Link &link = link_array[i];
 		if (link.c0 > 0) {
-			Node &node_a = *link.n[0];
-			Node &node_b = *link.n[1];
-			const Vector3 del = node_b.x - node_a.x;
+			Vector3 &node_a = node_positions[link.n[0]];
+			Vector3 &node_b = node_positions[link.n[1]];
+			const Vector3 del = node_b - node_a;
 			const real_t len = del.length_squared();
 			if (link.c1 + len > CMP_EPSILON) {
-				const real_t k = ((link.c1 - len) / (link.c0 * (link.c1 + len))) * kst;
-				node_a.x -= del * (k * node_a.im);
-				node_b.x += del * (k * node_b.im);
+				const real_t k = ((link.c1 - len) / (link.c0 * (link.c1 + len))) * p_kst;
+				node_a -= del * (k * node_inv_masses[link.n[0]]);
+				node_b += del * (k * node_inv_masses[link.n[1]]);
 			}
 		}
 	}
@@ -1087,33 +1180,36 @@ void SoftBody3DSW::initialize_face_tree() {
 
 		AABB face_aabb;
 
-		face_aabb.position = face.n[0]->x;
-		face_aabb.expand_to(face.n[1]->x);
-		face_aabb.expand_to(face.n[2]->x);
+		face_aabb.position = nodes.x[face.n[0]];
+		face_aabb.expand_to(nodes.x[face.n[1]]);
+		face_aabb.expand_to(nodes.x[face.n[2]]);
 
 		face_aabb.grow_by(collision_margin);
 
-		face.leaf = face_tree.insert(face_aabb, &face);
+		face.leaf = face_tree.insert(face_aabb, (void *)(uintptr_t)i);
 	}
 }
 
 void SoftBody3DSW::update_face_tree(real_t p_delta) {
+	const Vector3 *node_positions = nodes.x.ptr();
+	const Vector3 *node_velocities = nodes.v.ptr();
+
 	for (uint32_t i = 0; i < faces.size(); ++i) {
 		const Face &face = faces[i];
 
 		AABB face_aabb;
 
-		const Node *node0 = face.n[0];
-		face_aabb.position = node0->x;
-		face_aabb.expand_to(node0->x + node0->v * p_delta);
+		const uint32_t node0 = face.n[0];
+		face_aabb.position = node_positions[node0];
+		face_aabb.expand_to(node_positions[node0] + node_velocities[node0] * p_delta);
 
-		const Node *node1 = face.n[1];
-		face_aabb.expand_to(node1->x);
-		face_aabb.expand_to(node1->x + node1->v * p_delta);
+		const uint32_t node1 = face.n[1];
+		face_aabb.expand_to(node_positions[node1]);
+		face_aabb.expand_to(node_positions[node1] + node_velocities[node1] * p_delta);
 
-		const Node *node2 = face.n[2];
-		face_aabb.expand_to(node2->x);
-		face_aabb.expand_to(node2->x + node2->v * p_delta);
+		const uint32_t node2 = face.n[2];
+		face_aabb.expand_to(node_positions[node2]);
+		face_aabb.expand_to(node_positions[node2] + node_velocities[node2] * p_delta);
 
 		face_aabb.grow_by(collision_margin);
 
@@ -1149,6 +1245,10 @@ void SoftBody3DSW::destroy() {
 	links.clear();
 	faces.clear();
 
+	link_batch_offsets.clear();
+	link_parallel_batch_count = 0;
+	normals_dirty = false;
+
 	bounds = AABB();
 	deinitialize_shape();
 }
@@ -38,6 +38,7 @@
 #include "core/math/vector3.h"
 #include "core/templates/local_vector.h"
 #include "core/templates/set.h"
+#include "core/templates/thread_work_pool.h"
 #include "core/templates/vset.h"
 #include "scene/resources/mesh.h"
 
@@ -46,47 +47,63 @@ class Constraint3DSW;
 class SoftBody3DSW : public CollisionObject3DSW {
 	Ref<Mesh> soft_mesh;
 
-	struct Node {
-		Vector3 s; // Source position
-		Vector3 x; // Position
-		Vector3 q; // Previous step position/Test position
-		Vector3 f; // Force accumulator
-		Vector3 v; // Velocity
-		Vector3 bv; // Biased Velocity
-		Vector3 n; // Normal
-		real_t area = 0.0; // Area
-		real_t im = 0.0; // 1/mass
-		DynamicBVH::ID leaf; // Leaf data
-		uint32_t index = 0;
+	// Nodes are stored as a structure of arrays, all indexed by node.
+	struct NodeArrays {
+		LocalVector<Vector3> s; // Source position
+		LocalVector<Vector3> x; // Position
+		LocalVector<Vector3> q; // Previous step position/Test position
+		LocalVector<Vector3> f; // Force accumulator
+		LocalVector<Vector3> v; // Velocity
+		LocalVector<Vector3> bv; // Biased Velocity
+		LocalVector<Vector3> n; // Normal
+		LocalVector<real_t> area; // Area
+		LocalVector<real_t> im; // 1/mass
+		LocalVector<DynamicBVH::ID> leaf; // Leaf data
+
+		_FORCE_INLINE_ uint32_t size() const { return x.size(); }
+		_FORCE_INLINE_ bool is_empty() const { return x.is_empty(); }
+		void resize(uint32_t p_size);
+		void clear();
 	};
 
 	struct Link {
-		Vector3 c3; // gradient
-		Node *n[2] = { nullptr, nullptr }; // Node pointers
+		uint32_t n[2] = { 0, 0 }; // Node indices
 		real_t rl = 0.0; // Rest length
 		real_t c0 = 0.0; // (ima+imb)*kLST
 		real_t c1 = 0.0; // rl^2
-		real_t c2 = 0.0; // |gradient|^2/c0
 	};
 
 	struct Face {
-		Node *n[3] = { nullptr, nullptr, nullptr }; // Node pointers
-		Vector3 normal; // Normal
+		uint32_t n[3] = { 0, 0, 0 }; // Node indices
 		real_t ra = 0.0; // Rest area
 		DynamicBVH::ID leaf; // Leaf data
-		uint32_t index = 0;
 	};
 
-	LocalVector<Node> nodes;
+	NodeArrays nodes;
 	LocalVector<Link> links;
 	LocalVector<Face> faces;
 
+	// Links are sorted in batches whose links never share a node, so each batch can be solved in parallel.
+	// Links that don't fit in any of those go to a last batch which is solved serially.
+	LocalVector<uint32_t> link_batch_offsets;
+	uint32_t link_parallel_batch_count = 0;
+
+	struct LinkBatch {
+		uint32_t begin = 0;
+		uint32_t end = 0;
+		real_t kst = 0.0;
+	};
+
+	// Normals are only needed for rendering and pressure, so they're updated on demand.
+	bool normals_dirty = false;
+
 	DynamicBVH node_tree;
 	DynamicBVH face_tree;
 
 	LocalVector<uint32_t> map_visual_to_physics;
 
 	AABB bounds;
+	bool bounds_moved = false;
 
 	real_t collision_margin = 0.05;
 
@@ -177,11 +194,20 @@ public:
 	void set_drag_coefficient(real_t p_val);
 	_FORCE_INLINE_ real_t get_drag_coefficient() const { return drag_coefficient; }
 
+	bool create_from_trimesh(const Vector<int> &p_indices, const Vector<Vector3> &p_vertices);
+
+	// Doesn't touch the space, so several soft bodies can predict their motion in parallel.
+	// Their shape must then be moved to the new bounds with update_shape(), as the broadphase isn't thread safe.
 	void predict_motion(real_t p_delta);
-	void solve_constraints(real_t p_delta);
+	void update_shape();
+	// Solves links on the work pool when given, it must not be in use by the caller.
+	void solve_constraints(real_t p_delta, ThreadWorkPool *p_work_pool = nullptr);
+	// Called by the step after solving, so update_rendering_server() only has to copy the nodes.
+	void update_rendering_data();
 
-	_FORCE_INLINE_ uint32_t get_node_index(void *p_node) const { return ((Node *)p_node)->index; }
-	_FORCE_INLINE_ uint32_t get_face_index(void *p_face) const { return ((Face *)p_face)->index; }
+	// Tree leaves store node and face indices.
+	_FORCE_INLINE_ uint32_t get_node_index(void *p_node) const { return (uint32_t)(uintptr_t)p_node; }
+	_FORCE_INLINE_ uint32_t get_face_index(void *p_face) const { return (uint32_t)(uintptr_t)p_face; }
 
 	// Return true to stop the query.
 	// p_index is the node index for AABB query, face index for Ray query.
@@ -195,6 +221,7 @@ protected:
 
 private:
 	void update_normals();
+	void compute_bounds();
 	void update_bounds();
 	void update_constants();
 	void update_area();
@@ -207,13 +234,14 @@ private:
 
 	void apply_forces();
 
-	bool create_from_trimesh(const Vector<int> &p_indices, const Vector<Vector3> &p_vertices);
 	void generate_bending_constraints(int p_distance);
-	void reoptimize_link_order();
+	void update_link_batches();
 	void append_link(uint32_t p_node1, uint32_t p_node2);
 	void append_face(uint32_t p_node1, uint32_t p_node2, uint32_t p_node3);
 
-	void solve_links(real_t kst, real_t ti);
+	void solve_links(real_t kst, real_t ti, ThreadWorkPool *p_work_pool);
+	void _solve_link_range(uint32_t p_begin, uint32_t p_end, real_t p_kst, bool p_independent);
+	void _solve_link_chunk(uint32_t p_chunk_index, LinkBatch *p_batch);
 
 	void initialize_face_tree();
 	void update_face_tree(real_t p_delta);
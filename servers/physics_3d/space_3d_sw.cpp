@@ -32,6 +32,7 @@
 
 #include "collision_solver_3d_sw.h"
 #include "core/config/project_settings.h"
+#include "core/os/os.h"
 #include "physics_server_3d_sw.h"
 
 _FORCE_INLINE_ static bool _can_collide_with(CollisionObject3DSW *p_object, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
@@ -239,6 +240,209 @@ int PhysicsDirectSpaceState3DSW::intersect_shape(const RID &p_shape, const Trans
 	return cc;
 }
 
+_FORCE_INLINE_ static bool _is_excluded(const RID *p_exclude, int p_exclude_count, const RID &p_rid) {
+	// Binary search, the exclusion list is sorted.
+	int low = 0;
+	int high = p_exclude_count - 1;
+	while (low <= high) {
+		int middle = (low + high) / 2;
+		if (p_exclude[middle] == p_rid) {
+			return true;
+		} else if (p_exclude[middle] < p_rid) {
+			low = middle + 1;
+		} else {
+			high = middle - 1;
+		}
+	}
+	return false;
+}
+
+// Minimum amount of queries in a batch to run their narrowphase on the worker threads.
+#define SPACE_QUERY_BATCH_THREADING_MIN 64
+
+void PhysicsDirectSpaceState3DSW::_add_query_candidates(QueryBatch &r_batch, int p_amount, const RID *p_exclude, int p_exclude_count, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
+	for (int i = 0; i < p_amount; i++) {
+		const CollisionObject3DSW *col_obj = space->intersection_query_results[i];
+		if (!_can_collide_with(space->intersection_query_results[i], p_collision_mask, p_collide_with_bodies, p_collide_with_areas)) {
+			continue;
+		}
+
+		if (p_exclude_count && _is_excluded(p_exclude, p_exclude_count, col_obj->get_self())) {
+			continue;
+		}
+
+		r_batch.candidate_objects.push_back(col_obj);
+		r_batch.candidate_shapes.push_back(space->intersection_query_subindex_results[i]);
+	}
+	r_batch.candidate_offsets.push_back(r_batch.candidate_objects.size());
+}
+
+void PhysicsDirectSpaceState3DSW::_run_query_batch(QueryBatch &r_batch, int p_query_count, void (PhysicsDirectSpaceState3DSW::*p_method)(uint32_t, QueryBatch *)) {
+	if (p_query_count >= SPACE_QUERY_BATCH_THREADING_MIN && OS::get_singleton()->get_processor_count() > 1) {
+		if (PhysicsServer3DSW::singletonsw->stepper->try_do_work(p_query_count, this, p_method, &r_batch)) {
+			return;
+		}
+	}
+
+	for (int i = 0; i < p_query_count; i++) {
+		(this->*p_method)(i, &r_batch);
+	}
+}
+
+void PhysicsDirectSpaceState3DSW::_intersect_rays_query(uint32_t p_index, QueryBatch *p_batch) {
+	const Vector3 &begin = p_batch->from[p_index];
+	const Vector3 &end = p_batch->to[p_index];
+	Vector3 normal = (end - begin).normalized();
+
+	bool collided = false;
+	Vector3 res_point, res_normal;
+	int res_shape = 0;
+	const CollisionObject3DSW *res_obj = nullptr;
+	real_t min_d = 1e10;
+
+	for (uint32_t i = p_batch->candidate_offsets[p_index]; i < p_batch->candidate_offsets[p_index + 1]; i++) {
+		const CollisionObject3DSW *col_obj = p_batch->candidate_objects[i];
+		int shape_idx = p_batch->candidate_shapes[i];
+
+		Transform inv_xform = col_obj->get_shape_inv_transform(shape_idx) * col_obj->get_inv_transform();
+
+		Vector3 local_from = inv_xform.xform(begin);
+		Vector3 local_to = inv_xform.xform(end);
+
+		Vector3 shape_point, shape_normal;
+		if (col_obj->get_shape(shape_idx)->intersect_segment(local_from, local_to, shape_point, shape_normal)) {
+			Transform xform = col_obj->get_transform() * col_obj->get_shape_transform(shape_idx);
+			shape_point = xform.xform(shape_point);
+
+			real_t ld = normal.dot(shape_point);
+
+			if (ld < min_d) {
+				min_d = ld;
+				res_point = shape_point;
+				res_normal = inv_xform.basis.xform_inv(shape_normal).normalized();
+				res_shape = shape_idx;
+				res_obj = col_obj;
+				collided = true;
+			}
+		}
+	}
+
+	p_batch->hits[p_index] = collided;
+	if (!collided) {
+		return;
+	}
+
+	RayResult &r_result = p_batch->ray_results[p_index];
+	r_result.collider_id = res_obj->get_instance_id();
+	if (r_result.collider_id.is_valid()) {
+		r_result.collider = ObjectDB::get_instance(r_result.collider_id);
+	} else {
+		r_result.collider = nullptr;
+	}
+	r_result.normal = res_normal;
+	r_result.position = res_point;
+	r_result.rid = res_obj->get_self();
+	r_result.shape = res_shape;
+}
+
+int PhysicsDirectSpaceState3DSW::intersect_rays(const Vector3 *p_from, const Vector3 *p_to, int p_ray_count, RayResult *r_results, bool *r_hits, const RID *p_exclude, int p_exclude_count, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
+	ERR_FAIL_COND_V(space->locked, 0);
+	if (p_ray_count <= 0) {
+		return 0;
+	}
+
+	QueryBatch batch;
+	batch.from = p_from;
+	batch.to = p_to;
+	batch.ray_results = r_results;
+	batch.hits = r_hits;
+
+	batch.candidate_offsets.reserve(p_ray_count + 1);
+	batch.candidate_offsets.push_back(0);
+	for (int i = 0; i < p_ray_count; i++) {
+		int amount = space->broadphase->cull_segment(p_from[i], p_to[i], space->intersection_query_results, Space3DSW::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+		_add_query_candidates(batch, amount, p_exclude, p_exclude_count, p_collision_mask, p_collide_with_bodies, p_collide_with_areas);
+	}
+
+	_run_query_batch(batch, p_ray_count, &PhysicsDirectSpaceState3DSW::_intersect_rays_query);
+
+	int hit_count = 0;
+	for (int i = 0; i < p_ray_count; i++) {
+		hit_count += r_hits[i];
+	}
+	return hit_count;
+}
+
+void PhysicsDirectSpaceState3DSW::_intersect_shapes_query(uint32_t p_index, QueryBatch *p_batch) {
+	const Transform &xform = p_batch->xforms[p_index];
+	ShapeResult *results = &p_batch->shape_results[p_index * p_batch->result_max];
+	int cc = 0;
+
+	for (uint32_t i = p_batch->candidate_offsets[p_index]; i < p_batch->candidate_offsets[p_index + 1]; i++) {
+		if (cc >= p_batch->result_max) {
+			break;
+		}
+
+		const CollisionObject3DSW *col_obj = p_batch->candidate_objects[i];
+		int shape_idx = p_batch->candidate_shapes[i];
+
+		if (col_obj->is_shape_set_as_disabled(shape_idx)) {
+			continue;
+		}
+
+		if (!CollisionSolver3DSW::solve_static(p_batch->shape, xform, col_obj->get_shape(shape_idx), col_obj->get_transform() * col_obj->get_shape_transform(shape_idx), nullptr, nullptr, nullptr, p_batch->margin, 0)) {
+			continue;
+		}
+
+		results[cc].collider_id = col_obj->get_instance_id();
+		if (results[cc].collider_id.is_valid()) {
+			results[cc].collider = ObjectDB::get_instance(results[cc].collider_id);
+		} else {
+			results[cc].collider = nullptr;
+		}
+		results[cc].rid = col_obj->get_self();
+		results[cc].shape = shape_idx;
+
+		cc++;
+	}
+
+	p_batch->result_counts[p_index] = cc;
+}
+
+int PhysicsDirectSpaceState3DSW::intersect_shapes(const RID &p_shape, const Transform *p_xforms, int p_query_count, real_t p_margin, ShapeResult *r_results, int p_result_max, int *r_result_counts, const RID *p_exclude, int p_exclude_count, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
+	ERR_FAIL_COND_V(space->locked, 0);
+	if (p_query_count <= 0 || p_result_max <= 0) {
+		return 0;
+	}
+
+	Shape3DSW *shape = PhysicsServer3DSW::singletonsw->shape_owner.getornull(p_shape);
+	ERR_FAIL_COND_V(!shape, 0);
+
+	QueryBatch batch;
+	batch.shape = shape;
+	batch.xforms = p_xforms;
+	batch.margin = p_margin;
+	batch.shape_results = r_results;
+	batch.result_max = p_result_max;
+	batch.result_counts = r_result_counts;
+
+	batch.candidate_offsets.reserve(p_query_count + 1);
+	batch.candidate_offsets.push_back(0);
+	for (int i = 0; i < p_query_count; i++) {
+		AABB aabb = p_xforms[i].xform(shape->get_aabb());
+		int amount = space->broadphase->cull_aabb(aabb, space->intersection_query_results, Space3DSW::INTERSECTION_QUERY_MAX, space->intersection_query_subindex_results);
+		_add_query_candidates(batch, amount, p_exclude, p_exclude_count, p_collision_mask, p_collide_with_bodies, p_collide_with_areas);
+	}
+
+	_run_query_batch(batch, p_query_count, &PhysicsDirectSpaceState3DSW::_intersect_shapes_query);
+
+	int result_count = 0;
+	for (int i = 0; i < p_query_count; i++) {
+		result_count += r_result_counts[i];
+	}
+	return result_count;
+}
+
 bool PhysicsDirectSpaceState3DSW::cast_motion(const RID &p_shape, const Transform &p_xform, const Vector3 &p_motion, real_t p_margin, real_t &p_closest_safe, real_t &p_closest_unsafe, const Set<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas, ShapeRestInfo *r_info) {
 	Shape3DSW *shape = PhysicsServer3DSW::singletonsw->shape_owner.getornull(p_shape);
 	ERR_FAIL_COND_V(!shape, false);
@@ -539,30 +743,49 @@ PhysicsDirectSpaceState3DSW::PhysicsDirectSpaceState3DSW() {
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-int Space3DSW::_cull_aabb_for_body(Body3DSW *p_body, const AABB &p_aabb) {
-	int amount = broadphase->cull_aabb(p_aabb, intersection_query_results, INTERSECTION_QUERY_MAX, intersection_query_subindex_results);
+int Space3DSW::_cull_aabb_for_body(Body3DSW *p_body, const AABB &p_aabb, BodyCull &r_cull) {
+	if (r_cull.use_candidates) {
+		// The candidates already passed the checks below.
+		if (!r_cull.candidate_bounds.encloses(p_aabb)) {
+			r_cull.out_of_bounds = true;
+		}
+
+		int amount = 0;
+		for (int i = 0; i < r_cull.candidate_count; i++) {
+			if (p_aabb.intersects(r_cull.candidates[i]->get_shape_aabb(r_cull.candidate_subindices[i]))) {
+				r_cull.results[amount] = r_cull.candidates[i];
+				r_cull.subindex_results[amount] = r_cull.candidate_subindices[i];
+				amount++;
+			}
+		}
+		return amount;
+	}
+
+	CollisionObject3DSW **results = r_cull.results;
+	int *subindex_results = r_cull.subindex_results;
+	int amount = broadphase->cull_aabb(p_aabb, results, INTERSECTION_QUERY_MAX, subindex_results);
 
 	for (int i = 0; i < amount; i++) {
 		bool keep = true;
 
-		if (intersection_query_results[i] == p_body) {
+		if (results[i] == p_body) {
 			keep = false;
-		} else if (intersection_query_results[i]->get_type() == CollisionObject3DSW::TYPE_AREA) {
+		} else if (results[i]->get_type() == CollisionObject3DSW::TYPE_AREA) {
 			keep = false;
-		} else if (intersection_query_results[i]->get_type() == CollisionObject3DSW::TYPE_SOFT_BODY) {
+		} else if (results[i]->get_type() == CollisionObject3DSW::TYPE_SOFT_BODY) {
 			keep = false;
-		} else if ((static_cast<Body3DSW *>(intersection_query_results[i])->test_collision_mask(p_body)) == 0) {
+		} else if ((static_cast<Body3DSW *>(results[i])->test_collision_mask(p_body)) == 0) {
 			keep = false;
-		} else if (static_cast<Body3DSW *>(intersection_query_results[i])->has_exception(p_body->get_self()) || p_body->has_exception(intersection_query_results[i]->get_self())) {
+		} else if (static_cast<Body3DSW *>(results[i])->has_exception(p_body->get_self()) || p_body->has_exception(results[i]->get_self())) {
 			keep = false;
-		} else if (static_cast<Body3DSW *>(intersection_query_results[i])->is_shape_set_as_disabled(intersection_query_subindex_results[i])) {
+		} else if (static_cast<Body3DSW *>(results[i])->is_shape_set_as_disabled(subindex_results[i])) {
 			keep = false;
 		}
 
 		if (!keep) {
 			if (i < amount - 1) {
-				SWAP(intersection_query_results[i], intersection_query_results[amount - 1]);
-				SWAP(intersection_query_subindex_results[i], intersection_query_subindex_results[amount - 1]);
+				SWAP(results[i], results[amount - 1]);
+				SWAP(subindex_results[i], subindex_results[amount - 1]);
 			}
 
 			amount--;
@@ -623,7 +846,10 @@ int Space3DSW::test_body_ray_separation(Body3DSW *p_body, const Transform &p_tra
 
 			bool collided = false;
 
-			int amount = _cull_aabb_for_body(p_body, body_aabb);
+			BodyCull cull;
+			cull.results = intersection_query_results;
+			cull.subindex_results = intersection_query_subindex_results;
+			int amount = _cull_aabb_for_body(p_body, body_aabb, cull);
 
 			for (int j = 0; j < p_body->get_shape_count(); j++) {
 				if (p_body->is_shape_set_as_disabled(j)) {
@@ -725,6 +951,13 @@ int Space3DSW::test_body_ray_separation(Body3DSW *p_body, const Transform &p_tra
 }
 
 bool Space3DSW::test_body_motion(Body3DSW *p_body, const Transform &p_from, const Vector3 &p_motion, bool p_infinite_inertia, real_t p_margin, PhysicsServer3D::MotionResult *r_result, bool p_exclude_raycast_shapes) {
+	BodyCull cull;
+	cull.results = intersection_query_results;
+	cull.subindex_results = intersection_query_subindex_results;
+	return _test_body_motion(p_body, p_from, p_motion, p_infinite_inertia, p_margin, r_result, p_exclude_raycast_shapes, cull);
+}
+
+bool Space3DSW::_test_body_motion(Body3DSW *p_body, const Transform &p_from, const Vector3 &p_motion, bool p_infinite_inertia, real_t p_margin, PhysicsServer3D::MotionResult *r_result, bool p_exclude_raycast_shapes, BodyCull &r_cull) {
 	//give me back regular physics engine logic
 	//this is madness
 	//and most people using this function will think
@@ -790,7 +1023,7 @@ bool Space3DSW::test_body_motion(Body3DSW *p_body, const Transform &p_from, cons
 
 			bool collided = false;
 
-			int amount = _cull_aabb_for_body(p_body, body_aabb);
+			int amount = _cull_aabb_for_body(p_body, body_aabb, r_cull);
 
 			for (int j = 0; j < p_body->get_shape_count(); j++) {
 				if (p_body->is_shape_set_as_disabled(j)) {
@@ -804,8 +1037,8 @@ bool Space3DSW::test_body_motion(Body3DSW *p_body, const Transform &p_from, cons
 				}
 
 				for (int i = 0; i < amount; i++) {
-					const CollisionObject3DSW *col_obj = intersection_query_results[i];
-					int shape_idx = intersection_query_subindex_results[i];
+					const CollisionObject3DSW *col_obj = r_cull.results[i];
+					int shape_idx = r_cull.subindex_results[i];
 
 					if (CollisionSolver3DSW::solve_static(body_shape, body_shape_xform, col_obj->get_shape(shape_idx), col_obj->get_transform() * col_obj->get_shape_transform(shape_idx), cbkres, cbkptr, nullptr, p_margin)) {
 						collided = cbk.amount > 0;
@@ -861,7 +1094,7 @@ bool Space3DSW::test_body_motion(Body3DSW *p_body, const Transform &p_from, cons
 		motion_aabb.position += p_motion;
 		motion_aabb = motion_aabb.merge(body_aabb);
 
-		int amount = _cull_aabb_for_body(p_body, motion_aabb);
+		int amount = _cull_aabb_for_body(p_body, motion_aabb, r_cull);
 
 		for (int j = 0; j < p_body->get_shape_count(); j++) {
 			if (p_body->is_shape_set_as_disabled(j)) {
@@ -886,8 +1119,8 @@ bool Space3DSW::test_body_motion(Body3DSW *p_body, const Transform &p_from, cons
 			real_t best_unsafe = 1;
 
 			for (int i = 0; i < amount; i++) {
-				const CollisionObject3DSW *col_obj = intersection_query_results[i];
-				int shape_idx = intersection_query_subindex_results[i];
+				const CollisionObject3DSW *col_obj = r_cull.results[i];
+				int shape_idx = r_cull.subindex_results[i];
 
 				//test initial overlap, does it collide if going all the way?
 				Vector3 point_A, point_B;
@@ -988,11 +1221,11 @@ bool Space3DSW::test_body_motion(Body3DSW *p_body, const Transform &p_from, cons
 
 			body_aabb.position += p_motion * unsafe;
 
-			int amount = _cull_aabb_for_body(p_body, body_aabb);
+			int amount = _cull_aabb_for_body(p_body, body_aabb, r_cull);
 
 			for (int i = 0; i < amount; i++) {
-				const CollisionObject3DSW *col_obj = intersection_query_results[i];
-				int shape_idx = intersection_query_subindex_results[i];
+				const CollisionObject3DSW *col_obj = r_cull.results[i];
+				int shape_idx = r_cull.subindex_results[i];
 
 				rcd.object = col_obj;
 				rcd.shape = shape_idx;
@@ -1036,6 +1269,109 @@ bool Space3DSW::test_body_motion(Body3DSW *p_body, const Transform &p_from, cons
 	return collided;
 }
 
+// Minimum amount of motions in a batch to test them on the worker threads.
+#define SPACE_MOTION_BATCH_THREADING_MIN 16
+
+void Space3DSW::_test_body_motion_batch(uint32_t p_index, MotionBatch *p_batch) {
+	const uint32_t candidate_offset = p_batch->candidate_offsets[p_index];
+
+	BodyCull cull;
+	cull.results = p_batch->cull_objects.ptr() + candidate_offset;
+	cull.subindex_results = p_batch->cull_shapes.ptr() + candidate_offset;
+	cull.use_candidates = true;
+	cull.candidates = p_batch->candidate_objects.ptr() + candidate_offset;
+	cull.candidate_subindices = p_batch->candidate_shapes.ptr() + candidate_offset;
+	cull.candidate_count = p_batch->candidate_offsets[p_index + 1] - candidate_offset;
+	cull.candidate_bounds = p_batch->candidate_bounds[p_index];
+
+	Body3DSW *body = p_batch->bodies[p_index];
+	p_batch->collided[p_index] = _test_body_motion(body, p_batch->from[p_index], p_batch->motions[p_index], p_batch->infinite_inertia, body->get_kinematic_margin(), &p_batch->results[p_index], p_batch->exclude_raycast_shapes, cull);
+	p_batch->out_of_bounds[p_index] = cull.out_of_bounds;
+}
+
+int Space3DSW::test_body_motions(Body3DSW *const *p_bodies, const Transform *p_from, const Vector3 *p_motions, int p_count, bool p_infinite_inertia, PhysicsServer3D::MotionResult *r_results, bool *r_collided, bool p_exclude_raycast_shapes) {
+	if (p_count <= 0) {
+		return 0;
+	}
+
+	MotionBatch batch;
+	batch.bodies = p_bodies;
+	batch.from = p_from;
+	batch.motions = p_motions;
+	batch.infinite_inertia = p_infinite_inertia;
+	batch.exclude_raycast_shapes = p_exclude_raycast_shapes;
+	batch.results = r_results;
+	batch.collided = r_collided;
+
+	// Cull the broadphase once per motion on this thread, with room for the recovery of the body.
+	// Each test then only filters its candidates.
+	batch.candidate_offsets.reserve(p_count + 1);
+	batch.candidate_offsets.push_back(0);
+	batch.candidate_bounds.resize(p_count);
+	for (int i = 0; i < p_count; i++) {
+		Body3DSW *body = p_bodies[i];
+
+		AABB body_aabb;
+		bool shapes_found = false;
+		for (int j = 0; j < body->get_shape_count(); j++) {
+			if (body->is_shape_set_as_disabled(j)) {
+				continue;
+			}
+
+			if (!shapes_found) {
+				body_aabb = body->get_shape_aabb(j);
+				shapes_found = true;
+			} else {
+				body_aabb = body_aabb.merge(body->get_shape_aabb(j));
+			}
+		}
+
+		if (shapes_found) {
+			body_aabb = p_from[i].xform(body->get_inv_transform().xform(body_aabb));
+			body_aabb = body_aabb.grow(body->get_kinematic_margin());
+
+			AABB bounds = body_aabb.merge(AABB(body_aabb.position + p_motions[i], body_aabb.size));
+			bounds = bounds.grow(body_aabb.get_longest_axis_size() * 0.5);
+			batch.candidate_bounds[i] = bounds;
+
+			BodyCull cull;
+			cull.results = intersection_query_results;
+			cull.subindex_results = intersection_query_subindex_results;
+			int amount = _cull_aabb_for_body(body, bounds, cull);
+			for (int j = 0; j < amount; j++) {
+				batch.candidate_objects.push_back(intersection_query_results[j]);
+				batch.candidate_shapes.push_back(intersection_query_subindex_results[j]);
+			}
+		}
+
+		batch.candidate_offsets.push_back(batch.candidate_objects.size());
+	}
+
+	batch.cull_objects.resize(batch.candidate_objects.size());
+	batch.cull_shapes.resize(batch.candidate_shapes.size());
+	batch.out_of_bounds.resize(p_count);
+
+	bool threaded = false;
+	if (p_count >= SPACE_MOTION_BATCH_THREADING_MIN && OS::get_singleton()->get_processor_count() > 1) {
+		threaded = PhysicsServer3DSW::singletonsw->stepper->try_do_work(p_count, this, &Space3DSW::_test_body_motion_batch, &batch);
+	}
+	if (!threaded) {
+		for (int i = 0; i < p_count; i++) {
+			_test_body_motion_batch(i, &batch);
+		}
+	}
+
+	int collided_count = 0;
+	for (int i = 0; i < p_count; i++) {
+		if (batch.out_of_bounds[i]) {
+			// The body recovered further than expected, test again against the broadphase.
+			r_collided[i] = test_body_motion(p_bodies[i], p_from[i], p_motions[i], p_infinite_inertia, p_bodies[i]->get_kinematic_margin(), &r_results[i], p_exclude_raycast_shapes);
+		}
+		collided_count += r_collided[i];
+	}
+	return collided_count;
+}
+
 void *Space3DSW::_broadphase_pair(CollisionObject3DSW *A, int p_subindex_A, CollisionObject3DSW *B, int p_subindex_B, void *p_self) {
 	if (!A->test_collision_mask(B)) {
 		return nullptr;
@@ -1138,6 +1474,18 @@ void Space3DSW::body_remove_from_state_query_list(SelfList<Body3DSW> *p_body) {
 	state_query_list.remove(p_body);
 }
 
+void Space3DSW::body_add_to_moved_list(SelfList<Body3DSW> *p_body) {
+	body_moved_list.add(p_body);
+}
+
+void Space3DSW::body_remove_from_moved_list(SelfList<Body3DSW> *p_body) {
+	body_moved_list.remove(p_body);
+}
+
+const SelfList<Body3DSW>::List &Space3DSW::get_moved_body_list() const {
+	return body_moved_list;
+}
+
 void Space3DSW::area_add_to_monitor_query_list(SelfList<Area3DSW> *p_area) {
 	monitor_query_list.add(p_area);
 }
@@ -1177,6 +1525,12 @@ void Space3DSW::call_queries() {
 		b->call_queries();
 	}
 
+	if (body_moved_list.first() && !body_states_callback.is_null()) {
+		Callable::CallError ce;
+		Variant rv;
+		body_states_callback.call(nullptr, 0, rv, ce);
+	}
+
 	while (monitor_query_list.first()) {
 		Area3DSW *a = monitor_query_list.first()->self();
 		monitor_query_list.remove(monitor_query_list.first());
@@ -1186,6 +1540,9 @@ void Space3DSW::call_queries() {
 
 void Space3DSW::setup() {
 	contact_debug_count = 0;
+	while (body_moved_list.first()) {
+		body_moved_list.remove(body_moved_list.first());
+	}
 	while (inertia_update_list.first()) {
 		inertia_update_list.first()->self()->update_inertias();
 		inertia_update_list.remove(inertia_update_list.first());
@@ -39,12 +39,40 @@
 #include "collision_object_3d_sw.h"
 #include "core/config/project_settings.h"
 #include "core/templates/hash_map.h"
+#include "core/templates/local_vector.h"
 #include "core/typedefs.h"
 #include "soft_body_3d_sw.h"
 
 class PhysicsDirectSpaceState3DSW : public PhysicsDirectSpaceState3D {
 	GDCLASS(PhysicsDirectSpaceState3DSW, PhysicsDirectSpaceState3D);
 
+	// Batched queries run the broadphase serially, as it shares its cull buffers,
+	// then the narrowphase of each query in parallel on the stepper's pool.
+	struct QueryBatch {
+		LocalVector<uint32_t> candidate_offsets; // candidates of query i are in [candidate_offsets[i], candidate_offsets[i + 1]).
+		LocalVector<const CollisionObject3DSW *> candidate_objects;
+		LocalVector<int> candidate_shapes;
+
+		// Rays.
+		const Vector3 *from = nullptr;
+		const Vector3 *to = nullptr;
+		RayResult *ray_results = nullptr;
+		bool *hits = nullptr;
+
+		// Shapes.
+		const Shape3DSW *shape = nullptr;
+		const Transform *xforms = nullptr;
+		real_t margin = 0.0;
+		ShapeResult *shape_results = nullptr;
+		int result_max = 0;
+		int *result_counts = nullptr;
+	};
+
+	void _add_query_candidates(QueryBatch &r_batch, int p_amount, const RID *p_exclude, int p_exclude_count, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas);
+	void _run_query_batch(QueryBatch &r_batch, int p_query_count, void (PhysicsDirectSpaceState3DSW::*p_method)(uint32_t, QueryBatch *));
+	void _intersect_rays_query(uint32_t p_index, QueryBatch *p_batch);
+	void _intersect_shapes_query(uint32_t p_index, QueryBatch *p_batch);
+
 public:
 	Space3DSW *space;
 
@@ -56,6 +84,9 @@ public:
 	virtual bool rest_info(RID p_shape, const Transform &p_shape_xform, real_t p_margin, ShapeRestInfo *r_info, const Set<RID> &p_exclude = Set<RID>(), uint32_t p_collision_mask = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false) override;
 	virtual Vector3 get_closest_point_to_object_volume(RID p_object, const Vector3 p_point) const override;
 
+	virtual int intersect_rays(const Vector3 *p_from, const Vector3 *p_to, int p_ray_count, RayResult *r_results, bool *r_hits, const RID *p_exclude = nullptr, int p_exclude_count = 0, uint32_t p_collision_mask = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false) override;
+	virtual int intersect_shapes(const RID &p_shape, const Transform *p_xforms, int p_query_count, real_t p_margin, ShapeResult *r_results, int p_result_max, int *r_result_counts, const RID *p_exclude = nullptr, int p_exclude_count = 0, uint32_t p_collision_mask = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false) override;
+
 	PhysicsDirectSpaceState3DSW();
 };
 
@@ -81,6 +112,7 @@ private:
 	SelfList<Body3DSW>::List active_list;
 	SelfList<Body3DSW>::List inertia_update_list;
 	SelfList<Body3DSW>::List state_query_list;
+	SelfList<Body3DSW>::List body_moved_list;
 	SelfList<Area3DSW>::List monitor_query_list;
 	SelfList<Area3DSW>::List area_moved_list;
 	SelfList<SoftBody3DSW>::List active_soft_body_list;
@@ -121,9 +153,45 @@ private:
 	Vector<Vector3> contact_debug;
 	int contact_debug_count;
 
+	Callable body_states_callback;
+
 	friend class PhysicsDirectSpaceState3DSW;
 
-	int _cull_aabb_for_body(Body3DSW *p_body, const AABB &p_aabb);
+	// Where the culls for a body go. Without candidates the broadphase is used,
+	// otherwise the candidates are filtered, which doesn't touch the space and can run on any thread.
+	struct BodyCull {
+		CollisionObject3DSW **results = nullptr;
+		int *subindex_results = nullptr;
+
+		bool use_candidates = false;
+		CollisionObject3DSW *const *candidates = nullptr;
+		const int *candidate_subindices = nullptr;
+		int candidate_count = 0;
+		AABB candidate_bounds;
+		bool out_of_bounds = false; // A cull went outside of the candidate bounds, so it may have missed objects.
+	};
+
+	struct MotionBatch {
+		Body3DSW *const *bodies = nullptr;
+		const Transform *from = nullptr;
+		const Vector3 *motions = nullptr;
+		bool infinite_inertia = false;
+		bool exclude_raycast_shapes = true;
+		PhysicsServer3D::MotionResult *results = nullptr;
+		bool *collided = nullptr;
+
+		LocalVector<uint32_t> candidate_offsets; // candidates of motion i are in [candidate_offsets[i], candidate_offsets[i + 1]).
+		LocalVector<CollisionObject3DSW *> candidate_objects;
+		LocalVector<int> candidate_shapes;
+		LocalVector<AABB> candidate_bounds;
+		LocalVector<CollisionObject3DSW *> cull_objects;
+		LocalVector<int> cull_shapes;
+		LocalVector<uint8_t> out_of_bounds;
+	};
+
+	int _cull_aabb_for_body(Body3DSW *p_body, const AABB &p_aabb, BodyCull &r_cull);
+	bool _test_body_motion(Body3DSW *p_body, const Transform &p_from, const Vector3 &p_motion, bool p_infinite_inertia, real_t p_margin, PhysicsServer3D::MotionResult *r_result, bool p_exclude_raycast_shapes, BodyCull &r_cull);
+	void _test_body_motion_batch(uint32_t p_index, MotionBatch *p_batch);
 
 public:
 	_FORCE_INLINE_ void set_self(const RID &p_self) { self = p_self; }
@@ -140,6 +208,11 @@ public:
 
 	void body_add_to_state_query_list(SelfList<Body3DSW> *p_body);
 	void body_remove_from_state_query_list(SelfList<Body3DSW> *p_body);
+	void body_add_to_moved_list(SelfList<Body3DSW> *p_body);
+	void body_remove_from_moved_list(SelfList<Body3DSW> *p_body);
+	const SelfList<Body3DSW>::List &get_moved_body_list() const;
+
+	void set_body_states_callback(const Callable &p_callable) { body_states_callback = p_callable; }
 
 	void area_add_to_monitor_query_list(SelfList<Area3DSW> *p_area);
 	void area_remove_from_monitor_query_list(SelfList<Area3DSW> *p_area);
@@ -205,6 +278,8 @@ public:
 
 	int test_body_ray_separation(Body3DSW *p_body, const Transform &p_transform, bool p_infinite_inertia, Vector3 &r_recover_motion, PhysicsServer3D::SeparationResult *r_results, int p_result_max, real_t p_margin);
 	bool test_body_motion(Body3DSW *p_body, const Transform &p_from, const Vector3 &p_motion, bool p_infinite_inertia, real_t p_margin, PhysicsServer3D::MotionResult *r_result, bool p_exclude_raycast_shapes);
+	// Tests the motions of many bodies at once, each one against the current state of the space.
+	int test_body_motions(Body3DSW *const *p_bodies, const Transform *p_from, const Vector3 *p_motions, int p_count, bool p_infinite_inertia, PhysicsServer3D::MotionResult *r_results, bool *r_collided, bool p_exclude_raycast_shapes);
 
 	Space3DSW();
 	~Space3DSW();
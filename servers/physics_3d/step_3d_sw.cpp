@@ -156,6 +156,15 @@ void Step3DSW::_solve_island(uint32_t p_island_index, void *p_userdata) {
 	}
 }
 
+void Step3DSW::_predict_soft_body_motion(uint32_t p_soft_body_index, void *p_userdata) {
+	active_soft_bodies[p_soft_body_index]->predict_motion(delta);
+}
+
+void Step3DSW::_solve_soft_body(uint32_t p_soft_body_index, void *p_userdata) {
+	active_soft_bodies[p_soft_body_index]->solve_constraints(delta);
+	active_soft_bodies[p_soft_body_index]->update_rendering_data();
+}
+
 void Step3DSW::_check_suspend(const LocalVector<Body3DSW *> &p_body_island) const {
 	bool can_sleep = true;
 
@@ -181,6 +190,8 @@ void Step3DSW::_check_suspend(const LocalVector<Body3DSW *> &p_body_island) cons
 }
 
 void Step3DSW::step(Space3DSW *p_space, real_t p_delta, int p_iterations) {
+	MutexLock work_pool_lock(work_pool_mutex);
+
 	p_space->lock(); // can't access space during this
 
 	p_space->setup(); //update inertias, etc
@@ -210,11 +221,23 @@ void Step3DSW::step(Space3DSW *p_space, real_t p_delta, int p_iterations) {
 
 	const SelfList<SoftBody3DSW> *sb = soft_body_list->first();
 	while (sb) {
-		sb->self()->predict_motion(p_delta);
+		active_soft_bodies.push_back(sb->self());
 		sb = sb->next();
 		active_count++;
 	}
 
+	if (active_soft_bodies.size() > 1) {
+		work_pool.do_work(active_soft_bodies.size(), this, &Step3DSW::_predict_soft_body_motion, nullptr);
+	} else if (active_soft_bodies.size() > 0) {
+		active_soft_bodies[0]->predict_motion(p_delta);
+	}
+
+	// The broadphase is only updated from this thread.
+	for (uint32_t i = 0; i < active_soft_bodies.size(); i++) {
+		active_soft_bodies[i]->update_shape();
+	}
+	active_soft_bodies.clear();
+
 	p_space->set_active_objects(active_count);
 
 	{ //profile
@@ -387,10 +410,20 @@ void Step3DSW::step(Space3DSW *p_space, real_t p_delta, int p_iterations) {
 
 	sb = soft_body_list->first();
 	while (sb) {
-		sb->self()->solve_constraints(p_delta);
+		active_soft_bodies.push_back(sb->self());
 		sb = sb->next();
 	}
 
+	// A single soft body solves its own links on the pool instead.
+	const uint32_t soft_body_count = active_soft_bodies.size();
+	if (soft_body_count > 1) {
+		work_pool.do_work(soft_body_count, this, &Step3DSW::_solve_soft_body, nullptr);
+	} else if (soft_body_count > 0) {
+		active_soft_bodies[0]->solve_constraints(p_delta, &work_pool);
+		active_soft_bodies[0]->update_rendering_data();
+	}
+	active_soft_bodies.clear();
+
 	{ //profile
 		profile_endtime = OS::get_singleton()->get_ticks_usec();
 		p_space->set_elapsed_time(Space3DSW::ELAPSED_TIME_INTEGRATE_VELOCITIES, profile_endtime - profile_begtime);
@@ -43,20 +43,36 @@ class Step3DSW {
 	real_t delta = 0.0;
 
 	ThreadWorkPool work_pool;
+	BinaryMutex work_pool_mutex;
 
 	LocalVector<LocalVector<Body3DSW *>> body_islands;
 	LocalVector<LocalVector<Constraint3DSW *>> constraint_islands;
 	LocalVector<Constraint3DSW *> all_constraints;
+	LocalVector<SoftBody3DSW *> active_soft_bodies;
 
 	void _populate_island(Body3DSW *p_body, LocalVector<Body3DSW *> &p_body_island, LocalVector<Constraint3DSW *> &p_constraint_island);
 	void _populate_island_soft_body(SoftBody3DSW *p_soft_body, LocalVector<Body3DSW *> &p_body_island, LocalVector<Constraint3DSW *> &p_constraint_island);
 	void _setup_contraint(uint32_t p_constraint_index, void *p_userdata = nullptr);
 	void _pre_solve_island(LocalVector<Constraint3DSW *> &p_constraint_island) const;
 	void _solve_island(uint32_t p_island_index, void *p_userdata = nullptr);
+	void _predict_soft_body_motion(uint32_t p_soft_body_index, void *p_userdata = nullptr);
+	void _solve_soft_body(uint32_t p_soft_body_index, void *p_userdata = nullptr);
 	void _check_suspend(const LocalVector<Body3DSW *> &p_body_island) const;
 
 public:
 	void step(Space3DSW *p_space, real_t p_delta, int p_iterations);
+
+	// Lends the pool to space queries, returns false if it's busy with a step or another query.
+	template <class C, class M, class U>
+	bool try_do_work(uint32_t p_elements, C *p_instance, M p_method, U p_userdata) {
+		if (work_pool_mutex.try_lock() != OK) {
+			return false;
+		}
+		work_pool.do_work(p_elements, p_instance, p_method, p_userdata);
+		work_pool_mutex.unlock();
+		return true;
+	}
+
 	Step3DSW();
 	~Step3DSW();
 };
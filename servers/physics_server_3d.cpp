@@ -192,7 +192,7 @@ Vector<RID> PhysicsShapeQueryParameters3D::get_exclude() const {
 	ret.resize(exclude.size());
 	int idx = 0;
 	for (Set<RID>::Element *E = exclude.front(); E; E = E->next()) {
-		ret.write[idx] = E->get();
+		ret.write[idx++] = E->get();
 	}
 	return ret;
 }
@@ -354,6 +354,132 @@ Dictionary PhysicsDirectSpaceState3D::_get_rest_info(const Ref<PhysicsShapeQuery
 	return r;
 }
 
+int PhysicsDirectSpaceState3D::intersect_rays(const Vector3 *p_from, const Vector3 *p_to, int p_ray_count, RayResult *r_results, bool *r_hits, const RID *p_exclude, int p_exclude_count, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
+	Set<RID> exclude;
+	for (int i = 0; i < p_exclude_count; i++) {
+		exclude.insert(p_exclude[i]);
+	}
+
+	int hit_count = 0;
+	for (int i = 0; i < p_ray_count; i++) {
+		r_hits[i] = intersect_ray(p_from[i], p_to[i], r_results[i], exclude, p_collision_mask, p_collide_with_bodies, p_collide_with_areas);
+		hit_count += r_hits[i];
+	}
+
+	return hit_count;
+}
+
+int PhysicsDirectSpaceState3D::intersect_shapes(const RID &p_shape, const Transform *p_xforms, int p_query_count, real_t p_margin, ShapeResult *r_results, int p_result_max, int *r_result_counts, const RID *p_exclude, int p_exclude_count, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
+	Set<RID> exclude;
+	for (int i = 0; i < p_exclude_count; i++) {
+		exclude.insert(p_exclude[i]);
+	}
+
+	int result_count = 0;
+	for (int i = 0; i < p_query_count; i++) {
+		r_result_counts[i] = intersect_shape(p_shape, p_xforms[i], p_margin, &r_results[i * p_result_max], p_result_max, exclude, p_collision_mask, p_collide_with_bodies, p_collide_with_areas);
+		result_count += r_result_counts[i];
+	}
+
+	return result_count;
+}
+
+Dictionary PhysicsDirectSpaceState3D::_intersect_rays(const PackedVector3Array &p_from, const PackedVector3Array &p_to, const Vector<RID> &p_exclude, uint32_t p_collision_mask, bool p_collide_with_bodies, bool p_collide_with_areas) {
+	ERR_FAIL_COND_V(p_from.size() != p_to.size(), Dictionary());
+
+	int ray_count = p_from.size();
+	Vector<RayResult> results;
+	results.resize(ray_count);
+	Vector<bool> hits;
+	hits.resize(ray_count);
+
+	Vector<RID> exclude = p_exclude;
+	exclude.sort();
+
+	intersect_rays(p_from.ptr(), p_to.ptr(), ray_count, results.ptrw(), hits.ptrw(), exclude.ptr(), exclude.size(), p_collision_mask, p_collide_with_bodies, p_collide_with_areas);
+
+	PackedVector3Array positions;
+	PackedVector3Array normals;
+	PackedInt64Array collider_ids;
+	PackedInt32Array shapes;
+	positions.resize(ray_count);
+	normals.resize(ray_count);
+	collider_ids.resize(ray_count);
+	shapes.resize(ray_count);
+
+	Vector3 *positions_ptr = positions.ptrw();
+	Vector3 *normals_ptr = normals.ptrw();
+	int64_t *collider_ids_ptr = collider_ids.ptrw();
+	int32_t *shapes_ptr = shapes.ptrw();
+	for (int i = 0; i < ray_count; i++) {
+		if (hits[i]) {
+			positions_ptr[i] = results[i].position;
+			normals_ptr[i] = results[i].normal;
+			collider_ids_ptr[i] = int64_t(results[i].collider_id);
+			shapes_ptr[i] = results[i].shape;
+		} else {
+			positions_ptr[i] = p_to[i];
+			normals_ptr[i] = Vector3();
+			collider_ids_ptr[i] = 0;
+			shapes_ptr[i] = -1;
+		}
+	}
+
+	Dictionary d;
+	d["position"] = positions;
+	d["normal"] = normals;
+	d["collider_id"] = collider_ids;
+	d["shape"] = shapes;
+
+	return d;
+}
+
+Dictionary PhysicsDirectSpaceState3D::_intersect_shapes(const Ref<PhysicsShapeQueryParameters3D> &p_shape_query, const Array &p_transforms, int p_max_results) {
+	ERR_FAIL_COND_V(!p_shape_query.is_valid(), Dictionary());
+	ERR_FAIL_COND_V(p_max_results <= 0, Dictionary());
+
+	int query_count = p_transforms.size();
+	Vector<Transform> xforms;
+	xforms.resize(query_count);
+	for (int i = 0; i < query_count; i++) {
+		xforms.write[i] = p_transforms[i];
+	}
+
+	Vector<ShapeResult> sr;
+	sr.resize(query_count * p_max_results);
+	Vector<int> counts;
+	counts.resize(query_count);
+
+	// The exclusion set is already sorted.
+	Vector<RID> exclude = p_shape_query->get_exclude();
+	int rc = intersect_shapes(p_shape_query->shape, xforms.ptr(), query_count, p_shape_query->margin, sr.ptrw(), p_max_results, counts.ptrw(), exclude.ptr(), exclude.size(), p_shape_query->collision_mask, p_shape_query->collide_with_bodies, p_shape_query->collide_with_areas);
+
+	PackedInt32Array queries;
+	PackedInt64Array collider_ids;
+	PackedInt32Array shapes;
+	queries.resize(rc);
+	collider_ids.resize(rc);
+	shapes.resize(rc);
+
+	int idx = 0;
+	for (int i = 0; i < query_count; i++) {
+		for (int j = 0; j < counts[i]; j++) {
+			const ShapeResult &result = sr[i * p_max_results + j];
+			queries.write[idx] = i;
+			collider_ids.write[idx] = int64_t(result.collider_id);
+			shapes.write[idx] = result.shape;
+			idx++;
+		}
+	}
+
+	Dictionary d;
+	d["query"] = queries;
+	d["collider_id"] = collider_ids;
+	d["shape"] = shapes;
+
+	return d;
+}
+
 PhysicsDirectSpaceState3D::PhysicsDirectSpaceState3D() {
 }
 
@@ -363,6 +489,8 @@ void PhysicsDirectSpaceState3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("cast_motion", "shape", "motion"), &PhysicsDirectSpaceState3D::_cast_motion);
 	ClassDB::bind_method(D_METHOD("collide_shape", "shape", "max_results"), &PhysicsDirectSpaceState3D::_collide_shape, DEFVAL(32));
 	ClassDB::bind_method(D_METHOD("get_rest_info", "shape"), &PhysicsDirectSpaceState3D::_get_rest_info);
+	ClassDB::bind_method(D_METHOD("intersect_rays", "from", "to", "exclude", "collision_mask", "collide_with_bodies", "collide_with_areas"), &PhysicsDirectSpaceState3D::_intersect_rays, DEFVAL(Array()), DEFVAL(0x7FFFFFFF), DEFVAL(true), DEFVAL(false));
+	ClassDB::bind_method(D_METHOD("intersect_shapes", "shape", "transforms", "max_results"), &PhysicsDirectSpaceState3D::_intersect_shapes, DEFVAL(32));
 }
 
 int PhysicsShapeQueryResult3D::get_result_count() const {
@@ -425,6 +553,103 @@ RID PhysicsServer3D::shape_create(ShapeType p_shape) {
 	}
 }
 
+Dictionary PhysicsServer3D::_space_get_moved_body_states(RID p_space) const {
+	BodyStates states;
+	int count = space_get_moved_body_states(p_space, states);
+
+	Array bodies;
+	bodies.resize(count);
+	PackedInt64Array instance_ids;
+	instance_ids.resize(count);
+	for (int i = 0; i < count; i++) {
+		bodies[i] = states.bodies[i];
+		instance_ids.write[i] = int64_t(states.instance_ids[i]);
+	}
+
+	Dictionary d;
+	d["rid"] = bodies;
+	d["instance_id"] = instance_ids;
+	d["transform"] = states.transforms;
+	d["linear_velocity"] = states.linear_velocities;
+	d["angular_velocity"] = states.angular_velocities;
+	d["sleeping"] = states.sleeping;
+
+	return d;
+}
+
+int PhysicsServer3D::body_test_motions(const RID *p_bodies, const Transform *p_from, const Vector3 *p_motions, int p_count, bool p_infinite_inertia, MotionResult *r_results, bool *r_collided, bool p_exclude_raycast_shapes) {
+	int collided_count = 0;
+	for (int i = 0; i < p_count; i++) {
+		r_collided[i] = body_test_motion(p_bodies[i], p_from[i], p_motions[i], p_infinite_inertia, &r_results[i], p_exclude_raycast_shapes);
+		collided_count += r_collided[i];
+	}
+
+	return collided_count;
+}
+
+Dictionary PhysicsServer3D::_body_test_motions(const Vector<RID> &p_bodies, const Array &p_from, const PackedVector3Array &p_motions, bool p_infinite_inertia, bool p_exclude_raycast_shapes) {
+	ERR_FAIL_COND_V(p_bodies.size() != p_from.size() || p_bodies.size() != p_motions.size(), Dictionary());
+
+	int count = p_bodies.size();
+	Vector<Transform> from;
+	from.resize(count);
+	for (int i = 0; i < count; i++) {
+		from.write[i] = p_from[i];
+	}
+
+	Vector<MotionResult> results;
+	results.resize(count);
+	Vector<bool> collided;
+	collided.resize(count);
+
+	body_test_motions(p_bodies.ptr(), from.ptr(), p_motions.ptr(), count, p_infinite_inertia, results.ptrw(), collided.ptrw(), p_exclude_raycast_shapes);
+
+	PackedByteArray collisions;
+	PackedVector3Array motions;
+	PackedVector3Array remainders;
+	PackedVector3Array points;
+	PackedVector3Array normals;
+	PackedInt64Array collider_ids;
+	collisions.resize(count);
+	motions.resize(count);
+	remainders.resize(count);
+	points.resize(count);
+	normals.resize(count);
+	collider_ids.resize(count);
+
+	uint8_t *collisions_ptr = collisions.ptrw();
+	Vector3 *motions_ptr = motions.ptrw();
+	Vector3 *remainders_ptr = remainders.ptrw();
+	Vector3 *points_ptr = points.ptrw();
+	Vector3 *normals_ptr = normals.ptrw();
+	int64_t *collider_ids_ptr = collider_ids.ptrw();
+	for (int i = 0; i < count; i++) {
+		const MotionResult &result = results[i];
+		collisions_ptr[i] = collided[i];
+		motions_ptr[i] = result.motion;
+		remainders_ptr[i] = result.remainder;
+		if (collided[i]) {
+			points_ptr[i] = result.collision_point;
+			normals_ptr[i] = result.collision_normal;
+			collider_ids_ptr[i] = int64_t(result.collider_id);
+		} else {
+			points_ptr[i] = Vector3();
+			normals_ptr[i] = Vector3();
+			collider_ids_ptr[i] = 0;
+		}
+	}
+
+	Dictionary d;
+	d["collided"] = collisions;
+	d["motion"] = motions;
+	d["remainder"] = remainders;
+	d["collision_point"] = points;
+	d["collision_normal"] = normals;
+	d["collider_id"] = collider_ids;
+
+	return d;
+}
+
 void PhysicsServer3D::_bind_methods() {
 #ifndef _3D_DISABLED
 
@@ -450,6 +675,8 @@ void PhysicsServer3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("space_set_param", "space", "param", "value"), &PhysicsServer3D::space_set_param);
 	ClassDB::bind_method(D_METHOD("space_get_param", "space", "param"), &PhysicsServer3D::space_get_param);
 	ClassDB::bind_method(D_METHOD("space_get_direct_state", "space"), &PhysicsServer3D::space_get_direct_state);
+	ClassDB::bind_method(D_METHOD("space_get_moved_body_states", "space"), &PhysicsServer3D::_space_get_moved_body_states);
+	ClassDB::bind_method(D_METHOD("space_set_body_states_callback", "space", "callable"), &PhysicsServer3D::space_set_body_states_callback);
 
 	ClassDB::bind_method(D_METHOD("area_create"), &PhysicsServer3D::area_create);
 	ClassDB::bind_method(D_METHOD("area_set_space", "area", "space"), &PhysicsServer3D::area_set_space);
@@ -555,6 +782,7 @@ void PhysicsServer3D::_bind_methods() {
 	ClassDB::bind_method(D_METHOD("body_set_ray_pickable", "body", "enable"), &PhysicsServer3D::body_set_ray_pickable);
 
 	ClassDB::bind_method(D_METHOD("body_get_direct_state", "body"), &PhysicsServer3D::body_get_direct_state);
+	ClassDB::bind_method(D_METHOD("body_test_motions", "bodies", "from", "motions", "infinite_inertia", "exclude_raycast_shapes"), &PhysicsServer3D::_body_test_motions, DEFVAL(true));
 
 	/* SOFT BODY API */
 
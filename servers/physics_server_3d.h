@@ -149,6 +149,8 @@ private:
 	Array _cast_motion(const Ref<PhysicsShapeQueryParameters3D> &p_shape_query, const Vector3 &p_motion);
 	Array _collide_shape(const Ref<PhysicsShapeQueryParameters3D> &p_shape_query, int p_max_results = 32);
 	Dictionary _get_rest_info(const Ref<PhysicsShapeQueryParameters3D> &p_shape_query);
+	Dictionary _intersect_rays(const PackedVector3Array &p_from, const PackedVector3Array &p_to, const Vector<RID> &p_exclude = Vector<RID>(), uint32_t p_collision_mask = 0, bool p_collide_with_bodies = true, bool p_collide_with_areas = false);
+	Dictionary _intersect_shapes(const Ref<PhysicsShapeQueryParameters3D> &p_shape_query, const Array &p_transforms, int p_max_results = 32);
 
 protected:
 	static void _bind_methods();
@@ -193,6 +195,11 @@ public:
 
 	virtual Vector3 get_closest_point_to_object_volume(RID p_object, const Vector3 p_point) const = 0;
 
+	// Batched queries, the exclusion list must be sorted (as Vector<RID>::sort() does).
+	// A ray result is only valid if r_hits is true for it, shape results are stored in blocks of p_result_max per query.
+	virtual int intersect_rays(const Vector3 *p_from, const Vector3 *p_to, int p_ray_count, RayResult *r_results, bool *r_hits, const RID *p_exclude = nullptr, int p_exclude_count = 0, uint32_t p_collision_mask = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false);
+	virtual int intersect_shapes(const RID &p_shape, const Transform *p_xforms, int p_query_count, real_t p_margin, ShapeResult *r_results, int p_result_max, int *r_result_counts, const RID *p_exclude = nullptr, int p_exclude_count = 0, uint32_t p_collision_mask = 0xFFFFFFFF, bool p_collide_with_bodies = true, bool p_collide_with_areas = false);
+
 	PhysicsDirectSpaceState3D();
 };
 
@@ -230,6 +237,9 @@ class PhysicsServer3D : public Object {
 
 	static PhysicsServer3D *singleton;
 
+	Dictionary _space_get_moved_body_states(RID p_space) const;
+	Dictionary _body_test_motions(const Vector<RID> &p_bodies, const Array &p_from, const PackedVector3Array &p_motions, bool p_infinite_inertia, bool p_exclude_raycast_shapes = true);
+
 protected:
 	static void _bind_methods();
 
@@ -302,6 +312,20 @@ public:
 	virtual Vector<Vector3> space_get_contacts(RID p_space) const = 0;
 	virtual int space_get_contact_count(RID p_space) const = 0;
 
+	struct BodyStates {
+		Vector<RID> bodies;
+		Vector<ObjectID> instance_ids;
+		Vector<float> transforms; // 12 floats per body, in the same layout as MultiMesh buffers.
+		Vector<Vector3> linear_velocities;
+		Vector<Vector3> angular_velocities;
+		Vector<uint8_t> sleeping;
+	};
+
+	// Bulk readback of the bodies moved by the last step, only works on physics process.
+	// The callback is called once per step, instead of once per body, when there are moved bodies.
+	virtual int space_get_moved_body_states(RID p_space, BodyStates &r_states) const = 0;
+	virtual void space_set_body_states_callback(RID p_space, const Callable &p_callable) = 0;
+
 	//missing space parameters
 
 	/* AREA API */
@@ -514,6 +538,10 @@ public:
 
 	virtual bool body_test_motion(RID p_body, const Transform &p_from, const Vector3 &p_motion, bool p_infinite_inertia, MotionResult *r_result = nullptr, bool p_exclude_raycast_shapes = true) = 0;
 
+	// Batched body_test_motion, each motion is tested against the current state of the space, without seeing the other motions.
+	// r_results and r_collided hold one entry per motion, returns the amount of motions that collided.
+	virtual int body_test_motions(const RID *p_bodies, const Transform *p_from, const Vector3 *p_motions, int p_count, bool p_infinite_inertia, MotionResult *r_results, bool *r_collided, bool p_exclude_raycast_shapes = true);
+
 	struct SeparationResult {
 		real_t collision_depth;
 		Vector3 collision_point;
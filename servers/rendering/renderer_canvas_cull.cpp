@@ -467,9 +467,44 @@ void RendererCanvasCull::canvas_item_set_transform(RID p_item, const Transform2D
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
 
+	if (canvas_item->interpolated) {
+		canvas_item->interpolation.curr = p_transform;
+		if (!canvas_item->on_interpolate_list) {
+			canvas_item->on_interpolate_list = true;
+			item_interpolate_list.push_back(p_item);
+		}
+		return;
+	}
+
 	canvas_item->xform = p_transform;
 }
 
+void RendererCanvasCull::canvas_item_set_interpolated(RID p_item, bool p_interpolated) {
+	Item *canvas_item = canvas_item_owner.getornull(p_item);
+	ERR_FAIL_COND(!canvas_item);
+
+	if (canvas_item->interpolated == p_interpolated) {
+		return;
+	}
+
+	canvas_item->interpolated = p_interpolated;
+	if (p_interpolated) {
+		canvas_item->interpolation.reset(canvas_item->xform);
+	} else {
+		canvas_item->xform = canvas_item->interpolation.curr;
+	}
+}
+
+void RendererCanvasCull::canvas_item_reset_physics_interpolation(RID p_item) {
+	Item *canvas_item = canvas_item_owner.getornull(p_item);
+	ERR_FAIL_COND(!canvas_item);
+
+	if (canvas_item->interpolated) {
+		canvas_item->interpolation.reset(canvas_item->interpolation.curr);
+		canvas_item->xform = canvas_item->interpolation.curr;
+	}
+}
+
 void RendererCanvasCull::canvas_item_set_clip(RID p_item, bool p_clip) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
@@ -817,6 +852,41 @@ void RendererCanvasCull::canvas_item_add_texture_rect_region(RID p_item, const R
 	}
 }
 
+void RendererCanvasCull::canvas_item_add_msdf_texture_rect_region(RID p_item, const Rect2 &p_rect, RID p_texture, const Rect2 &p_src_rect, const Color &p_modulate, float p_outline_size, float p_px_range) {
+	Item *canvas_item = canvas_item_owner.getornull(p_item);
+	ERR_FAIL_COND(!canvas_item);
+
+	Item::CommandRect *rect = canvas_item->alloc_command<Item::CommandRect>();
+	ERR_FAIL_COND(!rect);
+	rect->modulate = p_modulate;
+	rect->rect = p_rect;
+
+	rect->texture = p_texture;
+
+	rect->source = p_src_rect;
+	rect->flags = RendererCanvasRender::CANVAS_RECT_REGION | RendererCanvasRender::CANVAS_RECT_MSDF;
+
+	if (p_rect.size.x < 0) {
+		rect->flags |= RendererCanvasRender::CANVAS_RECT_FLIP_H;
+		rect->rect.size.x = -rect->rect.size.x;
+	}
+	if (p_src_rect.size.x < 0) {
+		rect->flags ^= RendererCanvasRender::CANVAS_RECT_FLIP_H;
+		rect->source.size.x = -rect->source.size.x;
+	}
+	if (p_rect.size.y < 0) {
+		rect->flags |= RendererCanvasRender::CANVAS_RECT_FLIP_V;
+		rect->rect.size.y = -rect->rect.size.y;
+	}
+	if (p_src_rect.size.y < 0) {
+		rect->flags ^= RendererCanvasRender::CANVAS_RECT_FLIP_V;
+		rect->source.size.y = -rect->source.size.y;
+	}
+
+	rect->px_range = p_px_range;
+	rect->outline = p_outline_size;
+}
+
 void RendererCanvasCull::canvas_item_add_nine_patch(RID p_item, const Rect2 &p_rect, const Rect2 &p_source, RID p_texture, const Vector2 &p_topleft, const Vector2 &p_bottomright, RS::NinePatchAxisMode p_x_axis_mode, RS::NinePatchAxisMode p_y_axis_mode, bool p_draw_center, const Color &p_modulate) {
 	Item *canvas_item = canvas_item_owner.getornull(p_item);
 	ERR_FAIL_COND(!canvas_item);
@@ -1466,6 +1536,32 @@ void RendererCanvasCull::canvas_item_set_default_texture_repeat(RID p_item, RS::
 	ci->texture_repeat = p_repeat;
 }
 
+void RendererCanvasCull::tick() {
+	// The last tick becomes the start of the interpolation, items that didn't move during it are settled.
+	for (uint32_t i = 0; i < item_interpolate_list.size(); i++) {
+		Item *canvas_item = canvas_item_owner.getornull(item_interpolate_list[i]);
+		if (!canvas_item) {
+			continue;
+		}
+
+		canvas_item->on_interpolate_list = false;
+		if (canvas_item->interpolated) {
+			canvas_item->interpolation.tick();
+			canvas_item->xform = canvas_item->interpolation.curr;
+		}
+	}
+	item_interpolate_list.clear();
+}
+
+void RendererCanvasCull::update_interpolation(float p_fraction) {
+	for (uint32_t i = 0; i < item_interpolate_list.size(); i++) {
+		Item *canvas_item = canvas_item_owner.getornull(item_interpolate_list[i]);
+		if (canvas_item && canvas_item->interpolated) {
+			canvas_item->xform = canvas_item->interpolation.interpolate(p_fraction);
+		}
+	}
+}
+
 bool RendererCanvasCull::free(RID p_rid) {
 	if (canvas_owner.owns(p_rid)) {
 		Canvas *canvas = canvas_owner.getornull(p_rid);
@@ -512,6 +512,12 @@ void RendererCanvasRenderRD::_render_item(RD::DrawListID p_draw_list, const Item
 						push_constant.flags |= FLAGS_CLIP_RECT_UV;
 					}
 
+					if (rect->flags & CANVAS_RECT_MSDF) {
+						push_constant.flags |= FLAGS_USE_MSDF;
+						push_constant.ninepatch_margins[0] = rect->px_range;
+						push_constant.ninepatch_margins[1] = rect->outline;
+					}
+
 				} else {
 					dst_rect = Rect2(rect->rect.position, rect->rect.size);
 
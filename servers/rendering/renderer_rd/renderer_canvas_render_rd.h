@@ -84,7 +84,9 @@ class RendererCanvasRenderRD : public RendererCanvasRender {
 		FLAGS_LIGHT_COUNT_SHIFT = 20,
 
 		FLAGS_DEFAULT_NORMAL_MAP_USED = (1 << 26),
-		FLAGS_DEFAULT_SPECULAR_MAP_USED = (1 << 27)
+		FLAGS_DEFAULT_SPECULAR_MAP_USED = (1 << 27),
+
+		FLAGS_USE_MSDF = (1 << 28),
 
 	};
 
@@ -460,6 +460,10 @@ void light_blend_compute(uint light_base, vec4 light_color, inout vec3 color) {
 
 #endif
 
+float msdf_median(float r, float g, float b) {
+	return max(min(r, g), min(max(r, g), b));
+}
+
 void main() {
 	vec4 color = color_interp;
 	vec2 uv = uv_interp;
@@ -487,7 +491,30 @@ void main() {
 
 #endif
 
-	color *= texture(sampler2D(color_texture, texture_sampler), uv);
+#if !defined(USE_ATTRIBUTES) && !defined(USE_PRIMITIVE)
+	if (bool(draw_data.flags & FLAGS_USE_MSDF)) {
+		// Signed distance field glyphs, the median of the channels is the distance to the outline.
+		float px_range = draw_data.ninepatch_margins.x;
+		float outline_thickness = draw_data.ninepatch_margins.y;
+
+		vec4 msdf_sample = texture(sampler2D(color_texture, texture_sampler), uv);
+		vec2 msdf_size = vec2(textureSize(sampler2D(color_texture, texture_sampler), 0));
+		vec2 dest_size = vec2(1.0) / fwidth(uv);
+		float px_size = max(0.5 * dot((vec2(px_range) / msdf_size), dest_size), 1.0);
+		float d = msdf_median(msdf_sample.r, msdf_sample.g, msdf_sample.b) - 0.5;
+
+		if (outline_thickness > 0.0) {
+			float cr = clamp(outline_thickness, 0.0, px_range / 2.0) / px_range;
+			color.a *= clamp((d + cr) * px_size, 0.0, 1.0);
+		} else {
+			color.a *= clamp(d * px_size + 0.5, 0.0, 1.0);
+		}
+	} else {
+#else
+	{
+#endif
+		color *= texture(sampler2D(color_texture, texture_sampler), uv);
+	}
 
 	uint light_count = (draw_data.flags >> FLAGS_LIGHT_COUNT_SHIFT) & 0xF; //max 16 lights
 	bool using_light = light_count > 0 || canvas_data.directional_light_count > 0;
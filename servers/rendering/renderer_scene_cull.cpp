@@ -77,9 +77,45 @@ void RendererSceneCull::camera_set_frustum(RID p_camera, float p_size, Vector2 p
 void RendererSceneCull::camera_set_transform(RID p_camera, const Transform &p_transform) {
 	Camera *camera = camera_owner.getornull(p_camera);
 	ERR_FAIL_COND(!camera);
+
+	if (camera->interpolated) {
+		camera->interpolation.curr = p_transform.orthonormalized();
+		if (!camera->on_interpolate_list) {
+			camera->on_interpolate_list = true;
+			camera_interpolate_list.push_back(p_camera);
+		}
+		return;
+	}
+
 	camera->transform = p_transform.orthonormalized();
 }
 
+void RendererSceneCull::camera_set_interpolated(RID p_camera, bool p_interpolated) {
+	Camera *camera = camera_owner.getornull(p_camera);
+	ERR_FAIL_COND(!camera);
+
+	if (camera->interpolated == p_interpolated) {
+		return;
+	}
+
+	camera->interpolated = p_interpolated;
+	if (p_interpolated) {
+		camera->interpolation.reset(camera->transform);
+	} else {
+		camera->transform = camera->interpolation.curr;
+	}
+}
+
+void RendererSceneCull::camera_reset_physics_interpolation(RID p_camera) {
+	Camera *camera = camera_owner.getornull(p_camera);
+	ERR_FAIL_COND(!camera);
+
+	if (camera->interpolated) {
+		camera->interpolation.reset(camera->interpolation.curr);
+		camera->transform = camera->interpolation.curr;
+	}
+}
+
 void RendererSceneCull::camera_set_cull_mask(RID p_camera, uint32_t p_layers) {
 	Camera *camera = camera_owner.getornull(p_camera);
 	ERR_FAIL_COND(!camera);
@@ -750,7 +786,7 @@ void RendererSceneCull::instance_set_transform(RID p_instance, const Transform &
 	Instance *instance = instance_owner.getornull(p_instance);
 	ERR_FAIL_COND(!instance);
 
-	if (instance->transform == p_transform) {
+	if (!instance->interpolated && instance->transform == p_transform) {
 		return; //must be checked to avoid worst evil
 	}
 
@@ -767,10 +803,57 @@ void RendererSceneCull::instance_set_transform(RID p_instance, const Transform &
 	}
 
 #endif
+
+	if (instance->interpolated) {
+		// The rendered transform is updated by tick() and update_interpolation().
+		if (instance->interpolation.curr == p_transform) {
+			return;
+		}
+
+		instance->interpolation.curr = p_transform;
+		if (!instance->on_interpolate_list) {
+			instance->on_interpolate_list = true;
+			instance_interpolate_list.push_back(p_instance);
+		}
+		return;
+	}
+
 	instance->transform = p_transform;
 	_instance_queue_update(instance, true);
 }
 
+void RendererSceneCull::instance_set_interpolated(RID p_instance, bool p_interpolated) {
+	Instance *instance = instance_owner.getornull(p_instance);
+	ERR_FAIL_COND(!instance);
+
+	if (instance->interpolated == p_interpolated) {
+		return;
+	}
+
+	instance->interpolated = p_interpolated;
+	if (p_interpolated) {
+		instance->interpolation.reset(instance->transform);
+	} else if (instance->transform != instance->interpolation.curr) {
+		instance->transform = instance->interpolation.curr;
+		_instance_queue_update(instance, true);
+	}
+}
+
+void RendererSceneCull::instance_reset_physics_interpolation(RID p_instance) {
+	Instance *instance = instance_owner.getornull(p_instance);
+	ERR_FAIL_COND(!instance);
+
+	if (!instance->interpolated) {
+		return;
+	}
+
+	instance->interpolation.reset(instance->interpolation.curr);
+	if (instance->transform != instance->interpolation.curr) {
+		instance->transform = instance->interpolation.curr;
+		_instance_queue_update(instance, true);
+	}
+}
+
 void RendererSceneCull::instance_attach_object_instance_id(RID p_instance, ObjectID p_id) {
 	Instance *instance = instance_owner.getornull(p_instance);
 	ERR_FAIL_COND(!instance);
@@ -3532,6 +3615,64 @@ void RendererSceneCull::update() {
 	render_particle_colliders();
 }
 
+void RendererSceneCull::tick() {
+	// The last tick becomes the start of the interpolation, objects that didn't move during it are settled.
+	for (uint32_t i = 0; i < instance_interpolate_list.size(); i++) {
+		Instance *instance = instance_owner.getornull(instance_interpolate_list[i]);
+		if (!instance) {
+			continue;
+		}
+
+		instance->on_interpolate_list = false;
+		if (!instance->interpolated) {
+			continue;
+		}
+
+		instance->interpolation.tick();
+		if (instance->transform != instance->interpolation.curr) {
+			instance->transform = instance->interpolation.curr;
+			_instance_queue_update(instance, true);
+		}
+	}
+	instance_interpolate_list.clear();
+
+	for (uint32_t i = 0; i < camera_interpolate_list.size(); i++) {
+		Camera *camera = camera_owner.getornull(camera_interpolate_list[i]);
+		if (!camera) {
+			continue;
+		}
+
+		camera->on_interpolate_list = false;
+		if (camera->interpolated) {
+			camera->interpolation.tick();
+			camera->transform = camera->interpolation.curr;
+		}
+	}
+	camera_interpolate_list.clear();
+}
+
+void RendererSceneCull::update_interpolation(float p_fraction) {
+	for (uint32_t i = 0; i < instance_interpolate_list.size(); i++) {
+		Instance *instance = instance_owner.getornull(instance_interpolate_list[i]);
+		if (!instance || !instance->interpolated) {
+			continue;
+		}
+
+		Transform transform = instance->interpolation.interpolate(p_fraction);
+		if (instance->transform != transform) {
+			instance->transform = transform;
+			_instance_queue_update(instance, true);
+		}
+	}
+
+	for (uint32_t i = 0; i < camera_interpolate_list.size(); i++) {
+		Camera *camera = camera_owner.getornull(camera_interpolate_list[i]);
+		if (camera && camera->interpolated) {
+			camera->transform = camera->interpolation.interpolate(p_fraction);
+		}
+	}
+}
+
 bool RendererSceneCull::free(RID p_rid) {
 	if (scene_render->free(p_rid)) {
 		return true;
@@ -36,6 +36,7 @@
 
 #include "core/math/dynamic_bvh.h"
 #include "core/math/geometry_3d.h"
+#include "core/math/interpolated_transform.h"
 #include "core/math/octree.h"
 #include "core/os/semaphore.h"
 #include "core/os/thread.h"
@@ -84,6 +85,11 @@ public:
 
 		Transform transform;
 
+		// Physics interpolation, transform is between the last two physics ticks.
+		InterpolatedTransform<Transform> interpolation;
+		bool interpolated = false;
+		bool on_interpolate_list = false;
+
 		Camera() {
 			visible_layers = 0xFFFFFFFF;
 			fov = 75;
@@ -109,6 +115,8 @@ public:
 	virtual void camera_set_environment(RID p_camera, RID p_env);
 	virtual void camera_set_camera_effects(RID p_camera, RID p_fx);
 	virtual void camera_set_use_vertical_aspect(RID p_camera, bool p_enable);
+	virtual void camera_set_interpolated(RID p_camera, bool p_interpolated);
+	virtual void camera_reset_physics_interpolation(RID p_camera);
 	virtual bool is_camera(RID p_camera) const;
 
 	/* OCCLUDER API */
@@ -355,6 +363,11 @@ public:
 
 		Transform transform;
 
+		// Physics interpolation, transform is between the last two physics ticks.
+		InterpolatedTransform<Transform> interpolation;
+		bool interpolated = false;
+		bool on_interpolate_list = false;
+
 		float lod_bias;
 
 		bool ignore_occlusion_culling;
@@ -858,6 +871,8 @@ public:
 	virtual void instance_set_blend_shape_weight(RID p_instance, int p_shape, float p_weight);
 	virtual void instance_set_surface_override_material(RID p_instance, int p_surface, RID p_material);
 	virtual void instance_set_visible(RID p_instance, bool p_visible);
+	virtual void instance_set_interpolated(RID p_instance, bool p_interpolated);
+	virtual void instance_reset_physics_interpolation(RID p_instance);
 
 	virtual void instance_set_custom_aabb(RID p_instance, AABB p_aabb);
 
@@ -1066,6 +1081,13 @@ public:
 
 	virtual void update();
 
+	// Instances and cameras whose transform changed during the current physics tick.
+	LocalVector<RID> instance_interpolate_list;
+	LocalVector<RID> camera_interpolate_list;
+
+	virtual void tick();
+	virtual void update_interpolation(float p_fraction);
+
 	bool free(RID p_rid);
 
 	void set_scene_render(RendererSceneRender *p_scene_render);
@@ -30,6 +30,7 @@
 
 #include "rendering_server_default.h"
 
+#include "core/config/engine.h"
 #include "core/config/project_settings.h"
 #include "core/io/marshalls.h"
 #include "core/os/os.h"
@@ -338,6 +339,16 @@ void RenderingServerDefault::_thread_draw(bool p_swap_buffers, double frame_step
 	}
 }
 
+void RenderingServerDefault::_tick() {
+	RSG::scene->tick();
+	RSG::canvas->tick();
+}
+
+void RenderingServerDefault::_update_interpolation(float p_fraction) {
+	RSG::scene->update_interpolation(p_fraction);
+	RSG::canvas->update_interpolation(p_fraction);
+}
+
 void RenderingServerDefault::_thread_flush() {
 	draw_pending.decrement();
 }
@@ -386,6 +397,28 @@ void RenderingServerDefault::draw(bool p_swap_buffers, double frame_step) {
 	}
 }
 
+void RenderingServerDefault::tick() {
+	if (create_thread) {
+		command_queue.push(this, &RenderingServerDefault::_tick);
+	} else {
+		_tick();
+	}
+}
+
+void RenderingServerDefault::pre_draw(bool p_will_draw) {
+	if (!p_will_draw) {
+		return;
+	}
+
+	// The fraction is only valid on the main thread, so it is read here and queued with the update.
+	float fraction = Engine::get_singleton()->get_physics_interpolation_fraction();
+	if (create_thread) {
+		command_queue.push(this, &RenderingServerDefault::_update_interpolation, fraction);
+	} else {
+		_update_interpolation(fraction);
+	}
+}
+
 RenderingServerDefault::RenderingServerDefault(bool p_create_thread) :
 		command_queue(p_create_thread) {
 	create_thread = p_create_thread;
@@ -292,6 +292,8 @@ public:
 	virtual Vector2 font_draw_glyph(RID p_font, RID p_canvas, int p_size, const Vector2 &p_pos, uint32_t p_index, const Color &p_color = Color(1, 1, 1)) const = 0;
 	virtual Vector2 font_draw_glyph_outline(RID p_font, RID p_canvas, int p_size, int p_outline_size, const Vector2 &p_pos, uint32_t p_index, const Color &p_color = Color(1, 1, 1)) const = 0;
 
+	virtual uint64_t font_get_glyph_cache_memory(RID p_font) const { return 0; } // Bytes used by rasterized glyph textures.
+
 	virtual bool font_get_glyph_contours(RID p_font, int p_size, uint32_t p_index, Vector<Vector3> &r_points, Vector<int32_t> &r_contours, bool &r_orientation) const = 0;
 
 	virtual float font_get_oversampling() const = 0;
@@ -302,6 +304,14 @@ public:
 
 	virtual Vector<String> get_system_fonts() const = 0;
 
+	/* Shaped text cache */
+
+	// Servers that keep a cache of shaping results shared between text buffers override these.
+	virtual void shaped_text_cache_set_capacity(int p_capacity) {}
+	virtual int shaped_text_cache_get_capacity() const { return 0; }
+	virtual void shaped_text_cache_clear() {}
+	virtual Dictionary shaped_text_cache_get_stats() const { return Dictionary(); } // "size", "hits" and "misses" counters.
+
 	/* Shaped text buffer interface */
 
 	virtual RID create_shaped_text(Direction p_direction = DIRECTION_AUTO, Orientation p_orientation = ORIENTATION_HORIZONTAL) = 0;
@@ -32,6 +32,7 @@
 #define TEST_ASTAR_H
 
 #include "core/math/a_star.h"
+#include "core/math/a_star_grid_2d.h"
 #include "core/math/math_funcs.h"
 #include "core/os/os.h"
 
@@ -362,6 +363,317 @@ TEST_CASE("[Stress][AStar] Find paths") {
 		CHECK_MESSAGE(match, "Found all paths.");
 	}
 }
+
+static real_t _grid_path_length(const Vector<Vector2i> &p_path) {
+	real_t length = 0;
+	for (int i = 1; i < p_path.size(); i++) {
+		length += Vector2(p_path[i] - p_path[i - 1]).length();
+	}
+	return length;
+}
+
+// Checks that each step moves to an adjacent walkable cell and only cuts
+// corners when the diagonal mode allows it.
+static bool _is_valid_grid_path(const AStarGrid2D &p_grid, const Vector<Vector2i> &p_path) {
+	for (int i = 0; i < p_path.size(); i++) {
+		if (!p_grid.is_in_boundsv(p_path[i]) || (i > 0 && p_grid.is_point_solid(p_path[i]))) {
+			return false;
+		}
+		if (i == 0) {
+			continue;
+		}
+		Vector2i step = p_path[i] - p_path[i - 1];
+		if (step == Vector2i() || ABS(step.x) > 1 || ABS(step.y) > 1) {
+			return false;
+		}
+		if (step.x != 0 && step.y != 0) {
+			bool walk_x = !p_grid.is_point_solid(p_path[i - 1] + Vector2i(step.x, 0));
+			bool walk_y = !p_grid.is_point_solid(p_path[i - 1] + Vector2i(0, step.y));
+			switch (p_grid.get_diagonal_mode()) {
+				case AStarGrid2D::DIAGONAL_MODE_NEVER:
+					return false;
+				case AStarGrid2D::DIAGONAL_MODE_AT_LEAST_ONE_WALKABLE:
+					if (!walk_x && !walk_y) {
+						return false;
+					}
+					break;
+				case AStarGrid2D::DIAGONAL_MODE_ONLY_IF_NO_OBSTACLES:
+					if (!walk_x || !walk_y) {
+						return false;
+					}
+					break;
+				default:
+					break;
+			}
+		}
+	}
+	return true;
+}
+
+TEST_CASE("[AStarGrid2D] Open grid and walls") {
+	AStarGrid2D grid;
+	grid.set_size(Vector2i(5, 5));
+	grid.set_offset(Vector2(8, 8));
+	grid.set_cell_size(Vector2(16, 16));
+
+	Vector<Vector2i> path = grid.find_path(Vector2i(0, 0), Vector2i(4, 4));
+	CHECK(path.size() == 5);
+	CHECK(path[0] == Vector2i(0, 0));
+	CHECK(path[4] == Vector2i(4, 4));
+	CHECK(_grid_path_length(path) == doctest::Approx(4 * Math_SQRT2));
+	CHECK(grid.get_point_position(Vector2i(1, 2)) == Vector2(24, 40));
+
+	grid.set_diagonal_mode(AStarGrid2D::DIAGONAL_MODE_NEVER);
+	path = grid.find_path(Vector2i(0, 0), Vector2i(4, 4));
+	CHECK(path.size() == 9);
+	CHECK(_is_valid_grid_path(grid, path));
+
+	// A wall with a single gap at the bottom.
+	grid.set_diagonal_mode(AStarGrid2D::DIAGONAL_MODE_ONLY_IF_NO_OBSTACLES);
+	grid.fill_solid_region(Rect2i(2, 0, 1, 4));
+	path = grid.find_path(Vector2i(0, 0), Vector2i(4, 0));
+	CHECK(path.find(Vector2i(2, 4)) >= 0);
+	CHECK(_is_valid_grid_path(grid, path));
+
+	// Closing the gap leaves no path, and solid targets can't be reached.
+	grid.set_point_solid(Vector2i(2, 4));
+	CHECK(grid.find_path(Vector2i(0, 0), Vector2i(4, 0)).is_empty());
+	CHECK(grid.find_path(Vector2i(0, 0), Vector2i(2, 2)).is_empty());
+
+	grid.clear();
+	CHECK_FALSE(grid.is_point_solid(Vector2i(2, 2)));
+	CHECK(grid.find_path(Vector2i(3, 3), Vector2i(3, 3)).size() == 1);
+}
+
+TEST_CASE("[AStarGrid2D] Regions and weights") {
+	AStarGrid2D grid;
+	grid.set_size(Vector2i(8, 4));
+	grid.set_diagonal_mode(AStarGrid2D::DIAGONAL_MODE_NEVER);
+	grid.set_default_heuristic(AStarGrid2D::HEURISTIC_MANHATTAN);
+
+	// Regions are clipped to the grid.
+	grid.fill_solid_region(Rect2i(6, -2, 10, 4));
+	CHECK(grid.is_point_solid(Vector2i(6, 0)));
+	CHECK(grid.is_point_solid(Vector2i(7, 1)));
+	CHECK_FALSE(grid.is_point_solid(Vector2i(5, 1)));
+	CHECK_FALSE(grid.is_point_solid(Vector2i(6, 2)));
+	grid.fill_solid_region(Rect2i(0, 0, 8, 4), false);
+
+	// An expensive strip on the straight line makes the path go around it.
+	grid.fill_weight_scale_region(Rect2i(2, 0, 4, 3), 10);
+	CHECK(grid.get_point_weight_scale(Vector2i(3, 1)) == doctest::Approx(10));
+	Vector<Vector2i> path = grid.find_path(Vector2i(0, 1), Vector2i(7, 1));
+	CHECK(path.find(Vector2i(3, 3)) >= 0);
+	CHECK(_is_valid_grid_path(grid, path));
+
+	// Jump point search ignores weights and takes the straight line.
+	grid.set_jumping_enabled(true);
+	path = grid.find_path(Vector2i(0, 1), Vector2i(7, 1));
+	CHECK(path.size() == 8);
+	CHECK(path.find(Vector2i(3, 1)) >= 0);
+}
+
+TEST_CASE("[Stress][AStarGrid2D] Jump point search matches A*") {
+	Math::seed(0);
+
+	for (int test = 0; test < 200; test++) {
+		AStarGrid2D grid;
+		grid.set_size(Vector2i(4 + Math::rand() % 28, 4 + Math::rand() % 28));
+		AStarGrid2D::DiagonalMode mode = AStarGrid2D::DiagonalMode(test % AStarGrid2D::DIAGONAL_MODE_MAX);
+		grid.set_diagonal_mode(mode);
+		grid.set_default_heuristic(mode == AStarGrid2D::DIAGONAL_MODE_NEVER ? AStarGrid2D::HEURISTIC_MANHATTAN : AStarGrid2D::HEURISTIC_OCTILE);
+
+		int density = Math::rand() % 40;
+		for (int y = 0; y < grid.get_size().y; y++) {
+			for (int x = 0; x < grid.get_size().x; x++) {
+				grid.set_point_solid(Vector2i(x, y), int(Math::rand() % 100) < density);
+			}
+		}
+
+		Vector<Vector2i> from_ids;
+		Vector<Vector2i> to_ids;
+		for (int i = 0; i < 16; i++) {
+			from_ids.push_back(Vector2i(Math::rand() % grid.get_size().x, Math::rand() % grid.get_size().y));
+			to_ids.push_back(Vector2i(Math::rand() % grid.get_size().x, Math::rand() % grid.get_size().y));
+		}
+
+		Vector<Vector2i> astar_paths[16];
+		grid.set_jumping_enabled(false);
+		for (int i = 0; i < 16; i++) {
+			astar_paths[i] = grid.find_path(from_ids[i], to_ids[i]);
+		}
+
+		Vector<Vector<Vector2i>> jump_paths;
+		grid.set_jumping_enabled(true);
+		grid.find_paths(from_ids, to_ids, jump_paths);
+		REQUIRE(jump_paths.size() == 16);
+
+		bool match = true;
+		for (int i = 0; i < 16; i++) {
+			const Vector<Vector2i> &jump_path = jump_paths[i];
+			if (astar_paths[i].is_empty() != jump_path.is_empty()) {
+				print_verbose(vformat("Test #%d, from %s to %s: only one of A* and JPS found a path.", test, from_ids[i], to_ids[i]));
+				match = false;
+				break;
+			}
+			if (!_is_valid_grid_path(grid, astar_paths[i]) || !_is_valid_grid_path(grid, jump_path)) {
+				print_verbose(vformat("Test #%d, from %s to %s: invalid path.", test, from_ids[i], to_ids[i]));
+				match = false;
+				break;
+			}
+			if (!Math::is_equal_approx(_grid_path_length(astar_paths[i]), _grid_path_length(jump_path))) {
+				print_verbose(vformat("Test #%d, from %s to %s: A* gives %f, JPS gives %f.", test, from_ids[i], to_ids[i], _grid_path_length(astar_paths[i]), _grid_path_length(jump_path)));
+				match = false;
+				break;
+			}
+		}
+		CHECK_MESSAGE(match, "Jump point search finds paths as short as A*.");
+	}
+}
+
+static void _bench_fill_grid(AStarGrid2D &r_grid, int p_size, int p_density) {
+	r_grid.set_size(Vector2i(p_size, p_size));
+	for (int y = 0; y < p_size; y++) {
+		for (int x = 0; x < p_size; x++) {
+			r_grid.set_point_solid(Vector2i(x, y), int(Math::rand() % 100) < p_density);
+		}
+	}
+}
+
+static void _bench_pick_queries(const AStarGrid2D &p_grid, int p_count, Vector<Vector2i> &r_from_ids, Vector<Vector2i> &r_to_ids) {
+	Vector2i size = p_grid.get_size();
+	while (r_from_ids.size() < p_count) {
+		Vector2i from = Vector2i(Math::rand() % size.x, Math::rand() % size.y);
+		Vector2i to = Vector2i(Math::rand() % size.x, Math::rand() % size.y);
+		if (!p_grid.is_point_solid(from) && !p_grid.is_point_solid(to)) {
+			r_from_ids.push_back(from);
+			r_to_ids.push_back(to);
+		}
+	}
+}
+
+// Times the three ways of querying the grid, returns the summed path lengths.
+static real_t _bench_grid_queries(AStarGrid2D &p_grid, const Vector<Vector2i> &p_from_ids, const Vector<Vector2i> &p_to_ids) {
+	int count = p_from_ids.size();
+	real_t length = 0;
+
+	p_grid.set_jumping_enabled(false);
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < count; i++) {
+		length += _grid_path_length(p_grid.find_path(p_from_ids[i], p_to_ids[i]));
+	}
+	uint64_t astar_usec = bench_usec(begin);
+
+	p_grid.set_jumping_enabled(true);
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < count; i++) {
+		p_grid.find_path(p_from_ids[i], p_to_ids[i]);
+	}
+	uint64_t jump_usec = bench_usec(begin);
+
+	Vector<Vector<Vector2i>> paths;
+	begin = OS::get_singleton()->get_ticks_usec();
+	p_grid.find_paths(p_from_ids, p_to_ids, paths);
+	uint64_t batch_usec = bench_usec(begin);
+
+	print_line(vformat("  AStarGrid2D queries: A*: %d usec, JPS: %d usec, batched JPS: %d usec per path.", (int64_t)(astar_usec / count), (int64_t)(jump_usec / count), (int64_t)(batch_usec / count)));
+	return length;
+}
+
+// Builds a 256x256 grid with 20% obstacles as an AStar2D and as an
+// AStarGrid2D and compares their memory use and query times, then repeats
+// the AStarGrid2D part on a 1024x1024 grid.
+static void bench_astar_grid() {
+	const int size = 256;
+	const int density = 20;
+	const int queries = 200;
+	Math::seed(0);
+
+	AStarGrid2D *grid = memnew(AStarGrid2D);
+	uint64_t mem_begin = Memory::get_mem_usage();
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	_bench_fill_grid(*grid, size, density);
+	uint64_t grid_build_usec = bench_usec(begin);
+	uint64_t grid_mem = Memory::get_mem_usage() - mem_begin;
+
+	// The same grid as an AStar2D, with the diagonal connections of DIAGONAL_MODE_ALWAYS.
+	AStar2D *astar = memnew(AStar2D);
+	mem_begin = Memory::get_mem_usage();
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			if (!grid->is_point_solid(Vector2i(x, y))) {
+				astar->add_point(y * size + x, Vector2(x, y));
+			}
+		}
+	}
+	const Vector2i forward[4] = { Vector2i(1, 0), Vector2i(-1, 1), Vector2i(0, 1), Vector2i(1, 1) };
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			if (grid->is_point_solid(Vector2i(x, y))) {
+				continue;
+			}
+			for (int i = 0; i < 4; i++) {
+				Vector2i other = Vector2i(x, y) + forward[i];
+				if (grid->is_in_boundsv(other) && !grid->is_point_solid(other)) {
+					astar->connect_points(y * size + x, other.y * size + other.x);
+				}
+			}
+		}
+	}
+	uint64_t astar_build_usec = bench_usec(begin);
+	uint64_t astar_mem = Memory::get_mem_usage() - mem_begin;
+
+	Vector<Vector2i> from_ids;
+	Vector<Vector2i> to_ids;
+	_bench_pick_queries(*grid, queries, from_ids, to_ids);
+
+	real_t astar_length = 0;
+	mem_begin = Memory::get_mem_usage();
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < queries; i++) {
+		Vector<Vector2> path = astar->get_point_path(from_ids[i].y * size + from_ids[i].x, to_ids[i].y * size + to_ids[i].x);
+		for (int j = 1; j < path.size(); j++) {
+			astar_length += path[j].distance_to(path[j - 1]);
+		}
+	}
+	uint64_t astar_usec = bench_usec(begin);
+	astar_mem += Memory::get_mem_usage() - mem_begin;
+
+	// Memory is measured after the queries, so it includes the search state they keep.
+	print_line(vformat("%dx%d grid, %d%% obstacles, %d queries.", size, size, density, queries));
+	print_line(vformat("  AStar2D: %d KiB, built in %d msec, %d usec per path.", (int64_t)(astar_mem / 1024), (int64_t)(astar_build_usec / 1000), (int64_t)(astar_usec / queries)));
+	mem_begin = Memory::get_mem_usage();
+	real_t grid_length = _bench_grid_queries(*grid, from_ids, to_ids);
+	grid_mem += Memory::get_mem_usage() - mem_begin;
+	print_line(vformat("  AStarGrid2D: %d KiB, built in %d msec.", (int64_t)(grid_mem / 1024), (int64_t)(grid_build_usec / 1000)));
+	print_line(vformat("  Total path length: AStar2D %f, AStarGrid2D %f.", astar_length, grid_length));
+
+	memdelete(astar);
+	memdelete(grid);
+
+	// Too large to build as an AStar2D in a reasonable time.
+	const int large_size = 1024;
+	grid = memnew(AStarGrid2D);
+	mem_begin = Memory::get_mem_usage();
+	_bench_fill_grid(*grid, large_size, density);
+	grid_mem = Memory::get_mem_usage() - mem_begin;
+
+	from_ids.clear();
+	to_ids.clear();
+	_bench_pick_queries(*grid, queries, from_ids, to_ids);
+
+	print_line(vformat("%dx%d grid, %d%% obstacles, %d queries.", large_size, large_size, density, queries));
+	mem_begin = Memory::get_mem_usage();
+	_bench_grid_queries(*grid, from_ids, to_ids);
+	grid_mem += Memory::get_mem_usage() - mem_begin;
+	print_line(vformat("  AStarGrid2D: %d KiB.", (int64_t)(grid_mem / 1024)));
+
+	memdelete(grid);
+}
+
+REGISTER_TEST_COMMAND("astar-grid-bench", &bench_astar_grid);
+
 } // namespace TestAStar
 
 #endif // TEST_ASTAR_H
@@ -278,7 +278,10 @@ TEST_CASE("[CommandQueue] Test Queue Basics") {
 
 TEST_CASE("[CommandQueue] Test Waiting at Queue Full") {
 	const char *COMMAND_QUEUE_SETTING = "memory/limits/command_queue/multithreading_queue_size_kb";
+	const char *COMMAND_QUEUE_MAX_SETTING = "memory/limits/command_queue/multithreading_queue_max_size_kb";
 	ProjectSettings::get_singleton()->set_setting(COMMAND_QUEUE_SETTING, 1);
+	// Don't let the queue grow, so the writer has to wait.
+	ProjectSettings::get_singleton()->set_setting(COMMAND_QUEUE_MAX_SETTING, 1);
 	SharedThreadState sts;
 	sts.init_threads();
 
@@ -318,6 +321,50 @@ TEST_CASE("[CommandQueue] Test Waiting at Queue Full") {
 			"Reader should have read no additional messages after join");
 	ProjectSettings::get_singleton()->set_setting(COMMAND_QUEUE_SETTING,
 			ProjectSettings::get_singleton()->property_get_revert(COMMAND_QUEUE_SETTING));
+	ProjectSettings::get_singleton()->set_setting(COMMAND_QUEUE_MAX_SETTING,
+			ProjectSettings::get_singleton()->property_get_revert(COMMAND_QUEUE_MAX_SETTING));
+}
+
+TEST_CASE("[CommandQueue] Test Queue Growing") {
+	const char *COMMAND_QUEUE_SETTING = "memory/limits/command_queue/multithreading_queue_size_kb";
+	ProjectSettings::get_singleton()->set_setting(COMMAND_QUEUE_SETTING, 1);
+	SharedThreadState sts;
+	sts.init_threads();
+
+	int msgs_to_add = 64; // Far more than fits in the initial 1kB.
+	for (int i = 0; i < msgs_to_add; i++) {
+		sts.add_msg_to_write(i % 2 ? SharedThreadState::TEST_MSG_FUNC3_TRANSFORMx6 : SharedThreadState::TEST_MSG_FUNC1_TRANSFORM);
+	}
+	sts.writer_threadwork.main_start_work();
+	sts.writer_threadwork.main_wait_for_done();
+	CHECK_MESSAGE(sts.func1_count == 0,
+			"Writer should not need the reader to make room.");
+
+	sts.message_count_to_read = 5;
+	sts.reader_threadwork.main_start_work();
+	sts.reader_threadwork.main_wait_for_done();
+	CHECK_MESSAGE(sts.func1_count == 5,
+			"Reader should have read exactly the requested messages");
+
+	// Writing again while the reader is mid-way reuses the chunks it left.
+	for (int i = 0; i < msgs_to_add; i++) {
+		sts.add_msg_to_write(SharedThreadState::TEST_MSG_FUNC2_TRANSFORM_FLOAT);
+	}
+	sts.writer_threadwork.main_start_work();
+	sts.writer_threadwork.main_wait_for_done();
+
+	sts.message_count_to_read = -1;
+	sts.reader_threadwork.main_start_work();
+	sts.reader_threadwork.main_wait_for_done();
+	CHECK_MESSAGE(sts.func1_count == msgs_to_add * 2,
+			"Reader should have read all messages");
+
+	sts.destroy_threads();
+
+	CHECK_MESSAGE(sts.func1_count == msgs_to_add * 2,
+			"Reader should have read no additional messages after join");
+	ProjectSettings::get_singleton()->set_setting(COMMAND_QUEUE_SETTING,
+			ProjectSettings::get_singleton()->property_get_revert(COMMAND_QUEUE_SETTING));
 }
 
 TEST_CASE("[CommandQueue] Test Queue Wrapping to same spot.") {
@@ -470,6 +517,71 @@ TEST_CASE("[Stress][CommandQueue] Stress test command queue") {
 	ProjectSettings::get_singleton()->set_setting(COMMAND_QUEUE_SETTING,
 			ProjectSettings::get_singleton()->property_get_revert(COMMAND_QUEUE_SETTING));
 }
+class BenchQueueState {
+public:
+	CommandQueueMT command_queue = CommandQueueMT(true);
+	Thread thread;
+	bool exit = false;
+	uint64_t count = 0;
+
+	void func_int(int p_value) {
+		count += p_value;
+	}
+	void func_transform(Transform p_transform) {
+		count++;
+	}
+	void func_exit() {
+		exit = true;
+	}
+
+	static void thread_loop(void *p_ud) {
+		BenchQueueState *bqs = static_cast<BenchQueueState *>(p_ud);
+		while (!bqs->exit) {
+			bqs->command_queue.wait_and_flush_one();
+		}
+	}
+};
+
+// One thread pushes commands while a server-like thread flushes them,
+// reporting how many commands per second go through the queue.
+static void bench_command_queue() {
+	BenchQueueState bqs;
+	bqs.thread.start(&BenchQueueState::thread_loop, &bqs);
+
+	const int count = 2000000;
+	Transform transform;
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < count; i++) {
+		bqs.command_queue.push(&bqs, &BenchQueueState::func_int, 1);
+	}
+	bqs.command_queue.push_and_sync(&bqs, &BenchQueueState::func_int, 0);
+	uint64_t int_usec = bench_usec(begin);
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < count; i++) {
+		bqs.command_queue.push(&bqs, &BenchQueueState::func_transform, transform);
+	}
+	bqs.command_queue.push_and_sync(&bqs, &BenchQueueState::func_int, 0);
+	uint64_t transform_usec = bench_usec(begin);
+
+	const int sync_count = count / 20;
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < sync_count; i++) {
+		bqs.command_queue.push_and_sync(&bqs, &BenchQueueState::func_int, 1);
+	}
+	uint64_t sync_usec = bench_usec(begin);
+
+	bqs.command_queue.push(&bqs, &BenchQueueState::func_exit);
+	bqs.thread.wait_to_finish();
+
+	print_line(vformat("Command queue: %d commands executed, %d expected.", (int64_t)bqs.count, (int64_t)count * 2 + sync_count));
+	print_line(vformat("push(int): %d commands per second.", (int64_t)(count * 1000000ULL / int_usec)));
+	print_line(vformat("push(Transform): %d commands per second.", (int64_t)(count * 1000000ULL / transform_usec)));
+	print_line(vformat("push_and_sync(int): %d commands per second.", (int64_t)(sync_count * 1000000ULL / sync_usec)));
+}
+
+REGISTER_TEST_COMMAND("command-queue-bench", &bench_command_queue);
 } // namespace TestCommandQueue
 
 #endif // !defined(NO_THREADS)
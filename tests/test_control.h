@@ -0,0 +1,333 @@
+/*************************************************************************/
+/*  test_control.h                                                       */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_CONTROL_H
+#define TEST_CONTROL_H
+
+#include "core/object/message_queue.h"
+#include "core/os/os.h"
+#include "scene/gui/control.h"
+#include "scene/resources/theme.h"
+
+#include "tests/test_dummy_rendering_server.h"
+#include "tests/test_macros.h"
+#include "tests/test_scene_tree_environment.h"
+
+namespace TestControl {
+
+// Controls allocate canvas items, so they need a rendering server.
+struct ControlEnvironment {
+	DummyRenderingServer rendering_server;
+	MessageQueue *message_queue = nullptr;
+	Ref<Theme> previous_default_theme;
+
+	ControlEnvironment() {
+		if (!MessageQueue::get_singleton()) {
+			message_queue = memnew(MessageQueue);
+		}
+
+		// Lookups end at the default theme, which is only made when there is a rendering server.
+		previous_default_theme = Theme::get_default();
+		Ref<Theme> default_theme;
+		default_theme.instance();
+		default_theme->set_color("font_color", "Control", Color(0, 0, 0));
+		Theme::set_default(default_theme);
+	}
+
+	~ControlEnvironment() {
+		Theme::set_default(previous_default_theme);
+		if (message_queue) {
+			message_queue->flush();
+			memdelete(message_queue);
+		}
+	}
+};
+
+class ThemeChangedCounter : public Object {
+public:
+	int count = 0;
+
+	void _on_theme_changed() {
+		count++;
+	}
+};
+
+static Ref<Theme> _create_theme(const Color &p_font_color) {
+	Ref<Theme> theme;
+	theme.instance();
+	theme->set_color("font_color", "Control", p_font_color);
+	return theme;
+}
+
+TEST_CASE("[Control] Theme items follow edits of the theme resource") {
+	ControlEnvironment environment;
+	Ref<Theme> theme = _create_theme(Color(1, 0, 0));
+	Control *owner = memnew(Control);
+	owner->set_theme(theme);
+	Control *child = memnew(Control);
+	owner->add_child(child);
+	// A themed control without the item resolves it through the owner above.
+	Control *themed = memnew(Control);
+	themed->set_theme(_create_theme(Color(0, 0, 1)));
+	themed->get_theme()->clear_color("font_color", "Control");
+	child->add_child(themed);
+	Control *leaf = memnew(Control);
+	themed->add_child(leaf);
+
+	CHECK(child->get_theme_color("font_color") == Color(1, 0, 0));
+	CHECK(leaf->get_theme_color("font_color") == Color(1, 0, 0));
+
+	ThemeChangedCounter counter;
+	child->connect("theme_changed", callable_mp(&counter, &ThemeChangedCounter::_on_theme_changed));
+
+	theme->set_color("font_color", "Control", Color(0, 1, 0));
+	CHECK_MESSAGE(
+			child->get_theme_color("font_color") == Color(0, 1, 0),
+			"Lookups should see the edit before the theme change is propagated.");
+	CHECK_MESSAGE(
+			leaf->get_theme_color("font_color") == Color(0, 1, 0),
+			"Controls under another themed control should see the edit too.");
+
+	theme->set_color("font_color", "Control", Color(0, 1, 1));
+	theme->set_constant("separation", "Control", 4);
+	CHECK(child->get_theme_color("font_color") == Color(0, 1, 1));
+	CHECK(child->get_theme_constant("separation") == 4);
+
+	MessageQueue::get_singleton()->flush();
+	CHECK_MESSAGE(counter.count == 1, "Several edits in a row should notify the controls once.");
+
+	memdelete(owner);
+}
+
+TEST_CASE("[Control] Theme items follow set_theme() on an ancestor") {
+	ControlEnvironment environment;
+	Control *ancestor = memnew(Control);
+	Control *parent = memnew(Control);
+	ancestor->add_child(parent);
+	Control *child = memnew(Control);
+	parent->add_child(child);
+
+	CHECK(child->get_theme_color("font_color") == Color(0, 0, 0));
+
+	ancestor->set_theme(_create_theme(Color(1, 0, 0)));
+	CHECK(child->get_theme_color("font_color") == Color(1, 0, 0));
+
+	parent->set_theme(_create_theme(Color(0, 1, 0)));
+	CHECK(child->get_theme_color("font_color") == Color(0, 1, 0));
+
+	parent->set_theme(Ref<Theme>());
+	CHECK(child->get_theme_color("font_color") == Color(1, 0, 0));
+
+	ancestor->set_theme(Ref<Theme>());
+	CHECK(child->get_theme_color("font_color") == Color(0, 0, 0));
+
+	memdelete(ancestor);
+}
+
+TEST_CASE("[Control] Theme items follow reparenting under another theme owner") {
+	ControlEnvironment environment;
+	Control *red = memnew(Control);
+	red->set_theme(_create_theme(Color(1, 0, 0)));
+	Control *green = memnew(Control);
+	green->set_theme(_create_theme(Color(0, 1, 0)));
+
+	Control *child = memnew(Control);
+	red->add_child(child);
+	Control *grandchild = memnew(Control);
+	child->add_child(grandchild);
+	CHECK(grandchild->get_theme_color("font_color") == Color(1, 0, 0));
+
+	red->remove_child(child);
+	CHECK(grandchild->get_theme_color("font_color") == Color(0, 0, 0));
+	green->add_child(child);
+	CHECK(grandchild->get_theme_color("font_color") == Color(0, 1, 0));
+
+	// The theme owner of a themed control doesn't change, but what its theme lacks now resolves elsewhere.
+	Control *themed = memnew(Control);
+	themed->set_theme(_create_theme(Color(0, 0, 1)));
+	themed->get_theme()->clear_color("font_color", "Control");
+	Control *leaf = memnew(Control);
+	themed->add_child(leaf);
+	red->add_child(themed);
+	CHECK(leaf->get_theme_color("font_color") == Color(1, 0, 0));
+	red->remove_child(themed);
+	green->add_child(themed);
+	CHECK(leaf->get_theme_color("font_color") == Color(0, 1, 0));
+
+	memdelete(red);
+	memdelete(green);
+}
+
+TEST_CASE("[Control] Theme overrides take precedence over cached items") {
+	ControlEnvironment environment;
+	Ref<Theme> theme = _create_theme(Color(1, 0, 0));
+	theme->set_constant("separation", "Control", 4);
+	Control *owner = memnew(Control);
+	owner->set_theme(theme);
+	Control *child = memnew(Control);
+	owner->add_child(child);
+
+	CHECK(child->get_theme_color("font_color") == Color(1, 0, 0));
+	CHECK(child->get_theme_constant("separation") == 4);
+
+	child->add_theme_color_override("font_color", Color(0, 0, 1));
+	child->add_theme_constant_override("separation", 8);
+	CHECK(child->get_theme_color("font_color") == Color(0, 0, 1));
+	CHECK(child->get_theme_constant("separation") == 8);
+	CHECK_MESSAGE(
+			owner->get_theme_color("font_color") == Color(1, 0, 0),
+			"Overrides should not leak to the theme owner.");
+
+	// Edited while overridden, the theme value must not come back stale.
+	theme->set_color("font_color", "Control", Color(0, 1, 0));
+	child->remove_theme_color_override("font_color");
+	child->remove_theme_constant_override("separation");
+	CHECK(child->get_theme_color("font_color") == Color(0, 1, 0));
+	CHECK(child->get_theme_constant("separation") == 4);
+
+	memdelete(owner);
+}
+
+TEST_CASE("[Control] Theme items follow changes of the default themes") {
+	// Only controls in the scene tree are reached when the default themes change.
+	SceneTreeEnvironment scene_tree_environment;
+	ControlEnvironment environment;
+	Control *control = memnew(Control);
+	scene_tree_environment.tree->get_root()->add_child(control);
+
+	CHECK(control->get_theme_color("font_color") == Color(0, 0, 0));
+
+	Theme::set_default(_create_theme(Color(1, 0, 0)));
+	CHECK(control->get_theme_color("font_color") == Color(1, 0, 0));
+
+	Theme::get_default()->set_color("font_color", "Control", Color(0, 1, 0));
+	CHECK_MESSAGE(
+			control->get_theme_color("font_color") == Color(0, 1, 0),
+			"Lookups should see edits of the default theme.");
+
+	Ref<Theme> project_theme = _create_theme(Color(0, 0, 1));
+	Theme::set_project_default(project_theme);
+	CHECK(control->get_theme_color("font_color") == Color(0, 0, 1));
+
+	project_theme->set_color("font_color", "Control", Color(1, 1, 0));
+	CHECK_MESSAGE(
+			control->get_theme_color("font_color") == Color(1, 1, 0),
+			"Lookups should see edits of the project theme.");
+
+	Theme::set_project_default(Ref<Theme>());
+	CHECK(control->get_theme_color("font_color") == Color(0, 1, 0));
+
+	// Items missing from every theme fall back to the default values.
+	const int previous_font_size = control->get_theme_font_size("font_size");
+	Theme::set_default_font_size(previous_font_size + 10);
+	CHECK(control->get_theme_font_size("font_size") == previous_font_size + 10);
+	Theme::set_default_font_size(previous_font_size);
+	CHECK(control->get_theme_font_size("font_size") == previous_font_size);
+
+	memdelete(control);
+}
+
+// Resolves theme items on a themed hierarchy of Controls, comparing the first
+// lookup (which fills the per-control cache) with cached lookups, and with the
+// lookups after an edit of the theme.
+static void bench_gui_theme() {
+	ControlEnvironment environment;
+	const int branch_count = 100;
+	const int leaf_count = 200;
+	const int rounds = 10;
+	const StringName names[4] = { "font_color", "font_outline_color", "icon_color", "selection_color" };
+
+	Ref<Theme> theme;
+	theme.instance();
+	for (int i = 0; i < 4; i++) {
+		theme->set_color(names[i], "Control", Color(i * 0.25, 0.5, 0.5));
+	}
+	Control *root = memnew(Control);
+	root->set_theme(theme);
+
+	Vector<Control *> controls;
+	for (int i = 0; i < branch_count; i++) {
+		Control *branch = memnew(Control);
+		root->add_child(branch);
+		controls.push_back(branch);
+		for (int j = 0; j < leaf_count; j++) {
+			Control *leaf = memnew(Control);
+			branch->add_child(leaf);
+			controls.push_back(leaf);
+		}
+	}
+
+	float sink = 0;
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < controls.size(); i++) {
+		for (int j = 0; j < 4; j++) {
+			sink += controls[i]->get_theme_color(names[j]).r;
+		}
+	}
+	uint64_t cold_usec = bench_usec(begin);
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int r = 0; r < rounds; r++) {
+		for (int i = 0; i < controls.size(); i++) {
+			for (int j = 0; j < 4; j++) {
+				sink += controls[i]->get_theme_color(names[j]).r;
+			}
+		}
+	}
+	uint64_t warm_usec = bench_usec(begin);
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	theme->set_color(names[0], "Control", Color(1, 0, 0));
+	uint64_t edit_usec = bench_usec(begin);
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < controls.size(); i++) {
+		for (int j = 0; j < 4; j++) {
+			sink += controls[i]->get_theme_color(names[j]).r;
+		}
+	}
+	uint64_t edited_usec = bench_usec(begin);
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	MessageQueue::get_singleton()->flush();
+	uint64_t notify_usec = bench_usec(begin);
+
+	const uint64_t lookups = (uint64_t)controls.size() * 4;
+	print_line(vformat("%d controls, %d lookups each (checksum %f).", controls.size(), 4, sink));
+	print_line(vformat("First lookup: %d ns, cached: %d ns, after theme edit: %d ns.", (int64_t)(cold_usec * 1000 / lookups), (int64_t)(warm_usec * 1000 / (lookups * rounds)), (int64_t)(edited_usec * 1000 / lookups)));
+	print_line(vformat("Theme edit: %d usec to invalidate, %d usec to notify.", (int64_t)edit_usec, (int64_t)notify_usec));
+
+	memdelete(root);
+}
+
+REGISTER_TEST_COMMAND("gui-theme-bench", &bench_gui_theme);
+} // namespace TestControl
+
+#endif // TEST_CONTROL_H
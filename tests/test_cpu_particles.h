@@ -0,0 +1,222 @@
+/*************************************************************************/
+/*  test_cpu_particles.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+#ifndef TEST_CPU_PARTICLES_H
+#define TEST_CPU_PARTICLES_H
+
+#include "core/config/project_settings.h"
+#include "core/os/os.h"
+#include "scene/2d/cpu_particles_2d.h"
+#include "scene/3d/cpu_particles_3d.h"
+#include "scene/resources/curve.h"
+#include "scene/resources/gradient.h"
+
+#include "tests/test_macros.h"
+#include "tests/test_scene_tree_environment.h"
+
+namespace TestCPUParticles {
+
+// The dummy rasterizer drops instance buffers, this keeps the last one the
+// emitters hand over, to compare the simulation results.
+class BufferRecordingRenderingServer : public RenderingServerDefault {
+public:
+	Vector<float> last_buffer;
+
+	virtual void multimesh_set_buffer(RID p_multimesh, const Vector<float> &p_buffer) override {
+		last_buffer = p_buffer;
+	}
+
+	BufferRecordingRenderingServer() :
+			RenderingServerDefault(false) {}
+};
+
+// Made before the SceneTreeEnvironment, so its DummyRenderingServer uses this one.
+struct BufferRecordingEnvironment {
+	BufferRecordingRenderingServer *rendering_server = nullptr;
+
+	BufferRecordingEnvironment() {
+		if (!RenderingServer::get_singleton()) {
+			RasterizerDummy::make_current();
+			rendering_server = memnew(BufferRecordingRenderingServer);
+			rendering_server->init();
+		}
+	}
+
+	~BufferRecordingEnvironment() {
+		if (rendering_server) {
+			rendering_server->finish();
+			memdelete(rendering_server);
+		}
+	}
+};
+
+static const char *THREADED_MINIMUM_SETTING = "rendering/limits/cpu_particles/threaded_process_minimum_particles";
+
+// The SceneTree reads the minimum emitter size for its work pool when it is
+// made, 0 keeps every emitter on the calling thread.
+struct ThreadedMinimumOverride {
+	Variant previous;
+
+	ThreadedMinimumOverride(int p_minimum) {
+		previous = ProjectSettings::get_singleton()->get(THREADED_MINIMUM_SETTING);
+		ProjectSettings::get_singleton()->set_setting(THREADED_MINIMUM_SETTING, p_minimum);
+	}
+
+	~ThreadedMinimumOverride() {
+		ProjectSettings::get_singleton()->set_setting(THREADED_MINIMUM_SETTING, previous);
+	}
+};
+
+static Ref<Curve> _create_curve(float p_begin, float p_middle, float p_end) {
+	Ref<Curve> curve;
+	curve.instance();
+	curve->add_point(Vector2(0, p_begin));
+	curve->add_point(Vector2(0.5, p_middle));
+	curve->add_point(Vector2(1, p_end));
+	return curve;
+}
+
+static Ref<Gradient> _create_ramp() {
+	Ref<Gradient> ramp;
+	ramp.instance();
+	ramp->add_point(0.5, Color(1, 0.5, 0));
+	return ramp;
+}
+
+// Emitters with scale, angular velocity and color ramp curves, also used by
+// the cpu-particles-bench benchmark.
+static CPUParticles3D *create_emitter_3d(int p_amount) {
+	CPUParticles3D *emitter = memnew(CPUParticles3D);
+	emitter->set_amount(p_amount);
+	emitter->set_lifetime(0.25);
+	emitter->set_emission_shape(CPUParticles3D::EMISSION_SHAPE_SPHERE);
+	emitter->set_param(CPUParticles3D::PARAM_ANGULAR_VELOCITY, 90);
+	emitter->set_param(CPUParticles3D::PARAM_HUE_VARIATION, 0.5);
+	emitter->set_param_curve(CPUParticles3D::PARAM_SCALE, _create_curve(0.2, 1, 0));
+	emitter->set_param_curve(CPUParticles3D::PARAM_ANGULAR_VELOCITY, _create_curve(1, 0.5, 0));
+	emitter->set_color_ramp(_create_ramp());
+	emitter->set_emitting(true);
+	return emitter;
+}
+
+static CPUParticles2D *create_emitter_2d(int p_amount) {
+	CPUParticles2D *emitter = memnew(CPUParticles2D);
+	emitter->set_amount(p_amount);
+	emitter->set_lifetime(0.25);
+	emitter->set_emission_shape(CPUParticles2D::EMISSION_SHAPE_SPHERE);
+	emitter->set_param(CPUParticles2D::PARAM_ANGULAR_VELOCITY, 90);
+	emitter->set_param(CPUParticles2D::PARAM_HUE_VARIATION, 0.5);
+	emitter->set_param_curve(CPUParticles2D::PARAM_SCALE, _create_curve(0.2, 1, 0));
+	emitter->set_param_curve(CPUParticles2D::PARAM_ANGULAR_VELOCITY, _create_curve(1, 0.5, 0));
+	emitter->set_color_ramp(_create_ramp());
+	emitter->set_emitting(true);
+	return emitter;
+}
+
+// Runs an emitter in a scene tree for a fixed seed, and returns the instance
+// buffer (transforms, colors and custom data) of the last frame.
+static Vector<float> _simulate(Node *p_emitter, int p_threaded_minimum) {
+	const int frames = 30;
+
+	ThreadedMinimumOverride threaded_minimum(p_threaded_minimum);
+	SceneTreeEnvironment environment;
+	// Emission draws from the global random generator, which the tree randomizes.
+	Math::seed(42);
+	environment.tree->get_root()->add_child(p_emitter);
+	for (int i = 0; i < frames; i++) {
+		environment.tree->process(1.0 / 60.0);
+	}
+	RenderingServer::get_singleton()->emit_signal("frame_pre_draw");
+
+	memdelete(p_emitter);
+	return static_cast<BufferRecordingRenderingServer *>(RenderingServer::get_singleton())->last_buffer;
+}
+
+TEST_CASE("[CPUParticles3D] Pooled simulation matches the serial simulation") {
+	BufferRecordingEnvironment recording;
+	REQUIRE_MESSAGE(recording.rendering_server, "The test needs to make its own rendering server.");
+
+	const int amount = 4096;
+	Vector<float> serial = _simulate(create_emitter_3d(amount), 0);
+	Vector<float> pooled = _simulate(create_emitter_3d(amount), 1);
+	REQUIRE(serial.size() == amount * (12 + 4 + 4));
+	CHECK_MESSAGE(pooled == serial, "Instance buffers should be the same with and without the work pool.");
+}
+
+TEST_CASE("[CPUParticles2D] Pooled simulation matches the serial simulation") {
+	BufferRecordingEnvironment recording;
+	REQUIRE_MESSAGE(recording.rendering_server, "The test needs to make its own rendering server.");
+
+	const int amount = 4096;
+	Vector<float> serial = _simulate(create_emitter_2d(amount), 0);
+	Vector<float> pooled = _simulate(create_emitter_2d(amount), 1);
+	REQUIRE(serial.size() == amount * (8 + 4 + 4));
+	CHECK_MESSAGE(pooled == serial, "Instance buffers should be the same with and without the work pool.");
+}
+
+// Simulates 20 emitters of 5000 particles in a scene tree, once on the calling
+// thread and once on the tree's work pool, and reports simulated particles
+// per millisecond for both. That both give the same result is checked by the
+// CPUParticles3D test.
+static void bench_cpu_particles() {
+	const int emitter_count = 20;
+	const int amount = 5000;
+	const int frames = 120;
+	const struct {
+		const char *name;
+		int threaded_minimum;
+	} modes[] = {
+		{ "serial", 0 },
+		{ "pooled", 1 },
+	};
+
+	for (int m = 0; m < 2; m++) {
+		ThreadedMinimumOverride threaded_minimum(modes[m].threaded_minimum);
+		SceneTreeEnvironment environment;
+		for (int i = 0; i < emitter_count; i++) {
+			environment.tree->get_root()->add_child(create_emitter_3d(amount));
+		}
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int f = 0; f < frames; f++) {
+			environment.tree->process(1.0 / 60.0);
+		}
+		uint64_t usec = bench_usec(begin);
+
+		// Without a fixed FPS, each frame runs one step.
+		const uint64_t particle_steps = (uint64_t)emitter_count * amount * frames;
+		print_line(vformat("%s: %d emitters of %d particles: %d us per frame, %d particles simulated per ms.", modes[m].name, emitter_count, amount, (int64_t)(usec / frames), (int64_t)(particle_steps * 1000 / usec)));
+	}
+}
+
+REGISTER_TEST_COMMAND("cpu-particles-bench", &bench_cpu_particles);
+
+} // namespace TestCPUParticles
+
+#endif // TEST_CPU_PARTICLES_H
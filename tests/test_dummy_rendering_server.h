@@ -0,0 +1,58 @@
+/*************************************************************************/
+/*  test_dummy_rendering_server.h                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_DUMMY_RENDERING_SERVER_H
+#define TEST_DUMMY_RENDERING_SERVER_H
+
+#include "drivers/dummy/rasterizer_dummy.h"
+#include "servers/rendering/rendering_server_default.h"
+
+// The test setup has no rendering server, this makes one on the dummy rasterizer
+// for the lifetime of a test. Nothing is drawn, but resources can be allocated.
+struct DummyRenderingServer {
+	RenderingServer *rendering_server = nullptr;
+
+	DummyRenderingServer() {
+		if (!RenderingServer::get_singleton()) {
+			RasterizerDummy::make_current();
+			rendering_server = memnew(RenderingServerDefault(false));
+			rendering_server->init();
+		}
+	}
+
+	~DummyRenderingServer() {
+		if (rendering_server) {
+			rendering_server->finish();
+			memdelete(rendering_server);
+		}
+	}
+};
+
+#endif // TEST_DUMMY_RENDERING_SERVER_H
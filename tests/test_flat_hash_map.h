@@ -0,0 +1,268 @@
+/*************************************************************************/
+/*  test_flat_hash_map.h                                                 */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_FLAT_HASH_MAP_H
+#define TEST_FLAT_HASH_MAP_H
+
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+#include "core/templates/flat_hash_map.h"
+#include "core/templates/hash_map.h"
+#include "core/templates/oa_hash_map.h"
+
+#include "tests/test_macros.h"
+
+namespace TestFlatHashMap {
+
+TEST_CASE("[FlatHashMap] Set, get and overwrite") {
+	FlatHashMap<int, int> map;
+	CHECK(map.is_empty());
+	CHECK(map.getptr(42) == nullptr);
+
+	map.set(42, 1337);
+	map.set(1337, 21);
+	map.set(42, 11880);
+
+	CHECK(map.size() == 2);
+	CHECK(map.get(42) == 11880);
+	CHECK(map[1337] == 21);
+	CHECK_FALSE(map.has(7));
+
+	map[7] = 3;
+	CHECK(map.has(7));
+	CHECK(map.size() == 3);
+}
+
+TEST_CASE("[FlatHashMap] Growing and erasing") {
+	FlatHashMap<int, int> map;
+	for (int i = 0; i < 1000; i++) {
+		map.set(i, i * 2);
+	}
+	for (int i = 0; i < 1000; i += 2) {
+		CHECK(map.erase(i));
+	}
+	CHECK_FALSE(map.erase(0));
+	CHECK(map.size() == 500);
+
+	int found = 0;
+	for (int i = 0; i < 1000; i++) {
+		const int *value = map.getptr(i);
+		if (value) {
+			CHECK(*value == i * 2);
+			found++;
+		}
+	}
+	CHECK(found == 500);
+
+	// Reinserting reuses the erased slots.
+	for (int i = 0; i < 1000; i += 2) {
+		map.set(i, -i);
+	}
+	CHECK(map.size() == 1000);
+	CHECK(map.get(998) == -998);
+	CHECK(map.get(999) == 1998);
+}
+
+TEST_CASE("[FlatHashMap] Iteration and copy") {
+	FlatHashMap<String, int> map;
+	map.set("Hello", 1);
+	map.set("World", 2);
+	map.set("Godot rocks", 42);
+
+	FlatHashMap<String, int> copy = map;
+	map.erase("World");
+
+	int sum = 0;
+	int count = 0;
+	const String *key = nullptr;
+	while ((key = copy.next(key))) {
+		sum += copy[*key];
+		count++;
+	}
+	CHECK(count == 3);
+	CHECK(sum == 45);
+
+	List<String> keys;
+	map.get_key_list(&keys);
+	CHECK(keys.size() == 2);
+
+	// Erasing while restarting iteration, as Object does for its signals.
+	while ((key = copy.next(nullptr))) {
+		copy.erase(*key);
+	}
+	CHECK(copy.is_empty());
+}
+
+TEST_CASE("[FlatHashMap] Random operations match HashMap") {
+	FlatHashMap<uint32_t, uint32_t> map;
+	HashMap<uint32_t, uint32_t> reference;
+	RandomPCG rng(1234);
+
+	int mismatches = 0;
+	for (int i = 0; i < 20000; i++) {
+		uint32_t key = rng.rand() % 512;
+		switch (rng.rand() % 3) {
+			case 0:
+				map.set(key, i);
+				reference.set(key, i);
+				break;
+			case 1:
+				if (map.erase(key) != reference.erase(key)) {
+					mismatches++;
+				}
+				break;
+			default: {
+				const uint32_t *a = map.getptr(key);
+				const uint32_t *b = reference.getptr(key);
+				if ((a == nullptr) != (b == nullptr) || (a && *a != *b)) {
+					mismatches++;
+				}
+			} break;
+		}
+	}
+	CHECK(mismatches == 0);
+	CHECK(map.size() == reference.size());
+}
+
+TEST_CASE("[FlatHashMap] Word-at-a-time hash") {
+	// Reference values of MurmurHash3_x86_32.
+	CHECK(hash_murmur3_buffer("", 0, 0) == 0);
+	CHECK(hash_murmur3_buffer("hello", 5, 0) == 0x248bfa47);
+	CHECK(hash_murmur3_buffer("Hello, world!", 13, 1234) == 0xfaf6cdb3);
+
+	// Unaligned input hashes the same as aligned input.
+	char buffer[20] = "xabcdefghijk";
+	CHECK(hash_murmur3_buffer(buffer + 1, 11) == hash_murmur3_buffer("abcdefghijk", 11));
+}
+
+template <class M>
+static void _bench_insert(M &p_map, const LocalVector<StringName> &p_keys) {
+	for (uint32_t i = 0; i < p_keys.size(); i++) {
+		p_map.set(p_keys[i], i);
+	}
+}
+
+static uint64_t _bench_lookup(const HashMap<StringName, uint32_t> &p_map, const LocalVector<StringName> &p_keys, int p_rounds, uint64_t &r_sum) {
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int r = 0; r < p_rounds; r++) {
+		for (uint32_t i = 0; i < p_keys.size(); i++) {
+			const uint32_t *v = p_map.getptr(p_keys[i]);
+			r_sum += v ? *v : 1;
+		}
+	}
+	return OS::get_singleton()->get_ticks_usec() - begin;
+}
+
+static uint64_t _bench_lookup(const FlatHashMap<StringName, uint32_t> &p_map, const LocalVector<StringName> &p_keys, int p_rounds, uint64_t &r_sum) {
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int r = 0; r < p_rounds; r++) {
+		for (uint32_t i = 0; i < p_keys.size(); i++) {
+			const uint32_t *v = p_map.getptr(p_keys[i]);
+			r_sum += v ? *v : 1;
+		}
+	}
+	return OS::get_singleton()->get_ticks_usec() - begin;
+}
+
+static uint64_t _bench_lookup(const OAHashMap<StringName, uint32_t> &p_map, const LocalVector<StringName> &p_keys, int p_rounds, uint64_t &r_sum) {
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int r = 0; r < p_rounds; r++) {
+		for (uint32_t i = 0; i < p_keys.size(); i++) {
+			uint32_t v = 1;
+			p_map.lookup(p_keys[i], v);
+			r_sum += v;
+		}
+	}
+	return OS::get_singleton()->get_ticks_usec() - begin;
+}
+
+template <class M>
+static void _bench_map(const char *p_name, const LocalVector<StringName> &p_keys, const LocalVector<StringName> &p_missing, int p_rounds, uint64_t &r_sum) {
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	M map;
+	_bench_insert(map, p_keys);
+	uint64_t insert_usec = OS::get_singleton()->get_ticks_usec() - begin;
+
+	uint64_t hit_usec = _bench_lookup(map, p_keys, p_rounds, r_sum);
+	uint64_t miss_usec = _bench_lookup(map, p_missing, p_rounds, r_sum);
+
+	print_line(vformat("  %s: insert %d usec, hit lookups %d usec, missed lookups %d usec.", p_name, (int64_t)insert_usec, (int64_t)hit_usec, (int64_t)miss_usec));
+}
+
+// StringName keyed maps of the sizes found in ClassDB and Object signal maps,
+// then hashing of byte buffers.
+static void bench_hash_map() {
+	uint64_t sum = 0;
+	const int sizes[] = { 16, 256, 100000 };
+	for (int s = 0; s < 3; s++) {
+		LocalVector<StringName> keys;
+		LocalVector<StringName> missing;
+		for (int i = 0; i < sizes[s]; i++) {
+			keys.push_back(StringName("key_" + itos(i)));
+			missing.push_back(StringName("missing_" + itos(i)));
+		}
+		const int rounds = MAX(1, 2000000 / sizes[s]);
+
+		print_line(vformat("%d StringName keys, %d lookups of each kind:", sizes[s], rounds * sizes[s]));
+		_bench_map<HashMap<StringName, uint32_t>>("HashMap", keys, missing, rounds, sum);
+		_bench_map<OAHashMap<StringName, uint32_t>>("OAHashMap", keys, missing, rounds, sum);
+		_bench_map<FlatHashMap<StringName, uint32_t>>("FlatHashMap", keys, missing, rounds, sum);
+	}
+
+	const int buffer_size = 4096;
+	const int buffer_rounds = 20000;
+	LocalVector<uint8_t> buffer;
+	buffer.resize(buffer_size);
+	RandomPCG rng(0);
+	for (int i = 0; i < buffer_size; i++) {
+		buffer[i] = rng.rand();
+	}
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < buffer_rounds; i++) {
+		sum += hash_djb2_buffer(buffer.ptr(), buffer_size, i);
+	}
+	uint64_t djb2_usec = bench_usec(begin);
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < buffer_rounds; i++) {
+		sum += hash_murmur3_buffer(buffer.ptr(), buffer_size, i);
+	}
+	uint64_t murmur3_usec = bench_usec(begin);
+
+	const uint64_t bytes = (uint64_t)buffer_size * buffer_rounds;
+	print_line(vformat("Buffer hashing: djb2 %d MB/s, murmur3 %d MB/s.", (int64_t)(bytes / djb2_usec), (int64_t)(bytes / murmur3_usec)));
+	print_line(vformat("(checksum %d)", (int64_t)(sum & 0xFFFF)));
+}
+
+REGISTER_TEST_COMMAND("hash-map-bench", &bench_hash_map);
+} // namespace TestFlatHashMap
+
+#endif // TEST_FLAT_HASH_MAP_H
@@ -33,6 +33,8 @@
 
 #include "core/io/file_access_pack.h"
 #include "core/io/image.h"
+#include "core/os/os.h"
+#include "tests/test_macros.h"
 #include "test_utils.h"
 
 #include "thirdparty/doctest/doctest.h"
@@ -255,5 +257,217 @@ TEST_CASE("[Image] Modifying pixels of an image") {
 			image3->get_pixel(1, 0).is_equal_approx(Color(0, 0, 0, 0)),
 			"flip_y() should not leave old pixels behind.");
 }
+
+static Ref<Image> _make_noise_image(int p_width, int p_height, Image::Format p_format) {
+	Ref<Image> image = memnew(Image(p_width, p_height, false, p_format));
+	uint32_t seed = 1;
+	for (int y = 0; y < p_height; y++) {
+		for (int x = 0; x < p_width; x++) {
+			seed = seed * 1103515245 + 12345;
+			image->set_pixel(x, y, Color((seed >> 8) % 256 / 255.0, (seed >> 16) % 256 / 255.0, (x ^ y) % 256 / 255.0, (seed >> 24) / 255.0));
+		}
+	}
+	return image;
+}
+
+TEST_CASE("[Image] Threaded processing matches serial processing") {
+	// Large enough to be split across the worker pool.
+	const Image::Format formats[] = { Image::FORMAT_RGB8, Image::FORMAT_RGBA8, Image::FORMAT_RGBAF, Image::FORMAT_RGBAH };
+
+	for (uint32_t i = 0; i < sizeof(formats) / sizeof(formats[0]); i++) {
+		Ref<Image> source = _make_noise_image(1021, 517, formats[i]);
+
+		Vector<Ref<Image>> results[2];
+		for (int pass = 0; pass < 2; pass++) {
+			Image::set_threaded_processing_enabled(pass == 1);
+
+			for (int interpolation = 0; interpolation < 5; interpolation++) {
+				Ref<Image> resized = source->duplicate();
+				resized->resize(1200, 900, Image::Interpolation(interpolation));
+				results[pass].push_back(resized);
+			}
+
+			Ref<Image> mipmapped = source->duplicate();
+			mipmapped->resize(1024, 512);
+			mipmapped->generate_mipmaps();
+			results[pass].push_back(mipmapped);
+
+			Ref<Image> shrunk = mipmapped->duplicate();
+			shrunk->clear_mipmaps();
+			shrunk->shrink_x2();
+			results[pass].push_back(shrunk);
+
+			Ref<Image> converted = source->duplicate();
+			converted->convert(formats[i] == Image::FORMAT_RGBA8 ? Image::FORMAT_RGB8 : Image::FORMAT_RGBA8);
+			results[pass].push_back(converted);
+		}
+		Image::set_threaded_processing_enabled(true);
+
+		for (int j = 0; j < results[0].size(); j++) {
+			CHECK_MESSAGE(
+					results[0][j]->get_data() == results[1][j]->get_data(),
+					vformat("Threaded result %d for format %s should be identical to the serial one.", j, Image::get_format_name(formats[i])));
+		}
+	}
+}
+
+TEST_CASE("[Image] Mipmap generation") {
+	// Odd sized rows exercise both the vectorized and the scalar tail of the averaging loop.
+	Ref<Image> image = memnew(Image(22, 6, false, Image::FORMAT_RGBA8));
+	for (int y = 0; y < 6; y++) {
+		for (int x = 0; x < 22; x++) {
+			image->set_pixel(x, y, Color((x * 11) / 255.0, (y * 40) / 255.0, (x + y) % 2, (255 - x) / 255.0));
+		}
+	}
+	image->generate_mipmaps();
+	CHECK(image->get_mipmap_count() == 4);
+
+	Vector<uint8_t> data = image->get_data();
+	int mip_ofs = image->get_mipmap_offset(1);
+	for (int y = 0; y < 3; y++) {
+		for (int x = 0; x < 11; x++) {
+			for (int c = 0; c < 4; c++) {
+				int sum = 0;
+				for (int k = 0; k < 4; k++) {
+					sum += data[((y * 2 + k / 2) * 22 + x * 2 + k % 2) * 4 + c];
+				}
+				CHECK(data[mip_ofs + (y * 11 + x) * 4 + c] == (sum + 2) >> 2);
+			}
+		}
+	}
+
+	Ref<Image> image_f = memnew(Image());
+	image_f->copy_internals_from(image);
+	image_f->clear_mipmaps();
+	image_f->convert(Image::FORMAT_RGBAF);
+	image_f->shrink_x2();
+	CHECK(image_f->get_size() == Vector2(11, 3));
+	CHECK(image_f->get_pixel(3, 1).is_equal_approx((image->get_pixel(6, 2) + image->get_pixel(7, 2) + image->get_pixel(6, 3) + image->get_pixel(7, 3)) * 0.25));
+}
+
+static bool _is_compress_mode_available(Image::CompressMode p_mode) {
+	switch (p_mode) {
+		case Image::COMPRESS_S3TC:
+			return Image::_image_compress_bc_func != nullptr;
+		case Image::COMPRESS_ETC:
+			return Image::_image_compress_etc1_func != nullptr;
+		case Image::COMPRESS_ETC2:
+			return Image::_image_compress_etc2_func != nullptr;
+		case Image::COMPRESS_BPTC:
+			return Image::_image_compress_bptc_func != nullptr;
+		default:
+			return false;
+	}
+}
+
+TEST_CASE("[Image] Threaded block compression matches serial compression") {
+	const Image::CompressMode modes[] = { Image::COMPRESS_S3TC, Image::COMPRESS_ETC, Image::COMPRESS_ETC2, Image::COMPRESS_BPTC };
+
+	Ref<Image> source = _make_noise_image(512, 384, Image::FORMAT_RGBA8);
+	source->generate_mipmaps();
+
+	for (uint32_t i = 0; i < sizeof(modes) / sizeof(modes[0]); i++) {
+		if (!_is_compress_mode_available(modes[i])) {
+			continue;
+		}
+
+		Ref<Image> results[2];
+		for (int pass = 0; pass < 2; pass++) {
+			Image::set_threaded_processing_enabled(pass == 1);
+			results[pass] = source->duplicate();
+			results[pass]->compress(modes[i], Image::COMPRESS_SOURCE_GENERIC, 0.0);
+		}
+
+		CHECK(results[0]->get_format() == results[1]->get_format());
+		CHECK(results[1]->is_compressed());
+		CHECK_MESSAGE(
+				results[0]->get_data() == results[1]->get_data(),
+				vformat("Threaded compression to %s should be identical to the serial one.", Image::get_format_name(results[1]->get_format())));
+
+		for (int pass = 0; pass < 2; pass++) {
+			Image::set_threaded_processing_enabled(pass == 1);
+			results[pass]->decompress();
+		}
+		CHECK_MESSAGE(
+				results[0]->get_data() == results[1]->get_data(),
+				"Threaded decompression should be identical to the serial one.");
+	}
+	Image::set_threaded_processing_enabled(true);
+}
+
+// Compares serial and threaded resize, convert and mipmap generation on large images.
+void bench_image() {
+	const Image::Format formats[] = { Image::FORMAT_RGBA8, Image::FORMAT_RGBAF };
+	const int size = 4096;
+
+	for (uint32_t i = 0; i < sizeof(formats) / sizeof(formats[0]); i++) {
+		Ref<Image> source = _make_noise_image(size, size, formats[i]);
+
+		for (int pass = 0; pass < 2; pass++) {
+			Image::set_threaded_processing_enabled(pass == 1);
+			String mode = pass == 1 ? "threaded" : "serial";
+
+			for (int interpolation = 0; interpolation < 5; interpolation++) {
+				Ref<Image> image = source->duplicate();
+				uint64_t t = OS::get_singleton()->get_ticks_usec();
+				image->resize(size * 3 / 4, size * 3 / 4, Image::Interpolation(interpolation));
+				t = OS::get_singleton()->get_ticks_usec() - t;
+				print_line(vformat("%s %s: resize (interpolation %d) in %d usec.", Image::get_format_name(formats[i]), mode, interpolation, t));
+			}
+
+			Ref<Image> image = source->duplicate();
+			uint64_t t = OS::get_singleton()->get_ticks_usec();
+			image->generate_mipmaps();
+			t = OS::get_singleton()->get_ticks_usec() - t;
+			print_line(vformat("%s %s: generate_mipmaps in %d usec.", Image::get_format_name(formats[i]), mode, t));
+
+			image = source->duplicate();
+			t = OS::get_singleton()->get_ticks_usec();
+			image->shrink_x2();
+			t = OS::get_singleton()->get_ticks_usec() - t;
+			print_line(vformat("%s %s: shrink_x2 in %d usec.", Image::get_format_name(formats[i]), mode, t));
+
+			image = source->duplicate();
+			t = OS::get_singleton()->get_ticks_usec();
+			image->convert(formats[i] == Image::FORMAT_RGBA8 ? Image::FORMAT_RGB8 : Image::FORMAT_RGBAH);
+			t = OS::get_singleton()->get_ticks_usec() - t;
+			print_line(vformat("%s %s: convert in %d usec.", Image::get_format_name(formats[i]), mode, t));
+		}
+	}
+	Image::set_threaded_processing_enabled(true);
+}
+REGISTER_TEST_COMMAND("image-bench", &bench_image);
+
+// Reports block compression throughput per format, serial and threaded.
+void bench_image_compress() {
+	const Image::CompressMode modes[] = { Image::COMPRESS_S3TC, Image::COMPRESS_ETC, Image::COMPRESS_ETC2, Image::COMPRESS_BPTC };
+
+	Ref<Image> source = _make_noise_image(2048, 2048, Image::FORMAT_RGBA8);
+	source->generate_mipmaps();
+	double megapixels = source->get_data().size() / 4 / 1000000.0;
+
+	for (uint32_t i = 0; i < sizeof(modes) / sizeof(modes[0]); i++) {
+		if (!_is_compress_mode_available(modes[i])) {
+			continue;
+		}
+
+		for (int pass = 0; pass < 2; pass++) {
+			Image::set_threaded_processing_enabled(pass == 1);
+
+			Ref<Image> image = source->duplicate();
+			uint64_t t = OS::get_singleton()->get_ticks_usec();
+			image->compress(modes[i], Image::COMPRESS_SOURCE_GENERIC, 0.7);
+			t = bench_usec(t);
+			print_line(vformat("%s %s: compressed in %d usec, %s MP/s.", Image::get_format_name(image->get_format()), pass == 1 ? "threaded" : "serial", t, rtos(megapixels * 1000000.0 / t)));
+
+			t = OS::get_singleton()->get_ticks_usec();
+			image->decompress();
+			t = bench_usec(t);
+			print_line(vformat("%s %s: decompressed in %d usec, %s MP/s.", Image::get_format_name(image->get_format()), pass == 1 ? "threaded" : "serial", t, rtos(megapixels * 1000000.0 / t)));
+		}
+	}
+	Image::set_threaded_processing_enabled(true);
+}
+REGISTER_TEST_COMMAND("image-compress-bench", &bench_image_compress);
 } // namespace TestImage
 #endif // TEST_IMAGE_H
@@ -0,0 +1,109 @@
+/*************************************************************************/
+/*  test_interpolated_transform.h                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_INTERPOLATED_TRANSFORM_H
+#define TEST_INTERPOLATED_TRANSFORM_H
+
+#include "core/math/interpolated_transform.h"
+#include "core/math/transform.h"
+#include "core/math/transform_2d.h"
+
+#include "thirdparty/doctest/doctest.h"
+
+namespace TestInterpolatedTransform {
+
+TEST_CASE("[InterpolatedTransform] Transform at fractions 0, 0.5 and 1") {
+	InterpolatedTransform<Transform> interpolation;
+	interpolation.reset(Transform(Basis(), Vector3(0, 0, 0)));
+	interpolation.curr = Transform(Basis(Vector3(0, 1, 0), Math_PI / 2), Vector3(2, 4, -6));
+
+	CHECK_MESSAGE(
+			interpolation.interpolate(0).is_equal_approx(interpolation.prev),
+			"Fraction 0 should give the transform of the previous tick.");
+	CHECK_MESSAGE(
+			interpolation.interpolate(0.5).is_equal_approx(Transform(Basis(Vector3(0, 1, 0), Math_PI / 4), Vector3(1, 2, -3))),
+			"Fraction 0.5 should give the rotation and origin halfway between both ticks.");
+	CHECK_MESSAGE(
+			interpolation.interpolate(1).is_equal_approx(interpolation.curr),
+			"Fraction 1 should give the transform of the current tick.");
+}
+
+TEST_CASE("[InterpolatedTransform] Transform2D at fractions 0, 0.5 and 1") {
+	InterpolatedTransform<Transform2D> interpolation;
+	interpolation.reset(Transform2D(0, Vector2(0, 0)));
+	interpolation.curr = Transform2D(Math_PI / 2, Vector2(10, -20));
+
+	CHECK_MESSAGE(
+			interpolation.interpolate(0).is_equal_approx(interpolation.prev),
+			"Fraction 0 should give the transform of the previous tick.");
+	CHECK_MESSAGE(
+			interpolation.interpolate(0.5).is_equal_approx(Transform2D(Math_PI / 4, Vector2(5, -10))),
+			"Fraction 0.5 should give the rotation and origin halfway between both ticks.");
+	CHECK_MESSAGE(
+			interpolation.interpolate(1).is_equal_approx(interpolation.curr),
+			"Fraction 1 should give the transform of the current tick.");
+}
+
+TEST_CASE("[InterpolatedTransform] Tick and reset") {
+	const Transform2D first = Transform2D(0, Vector2(1, 1));
+	const Transform2D second = Transform2D(Math_PI / 2, Vector2(3, 3));
+	const Transform2D third = Transform2D(Math_PI, Vector2(5, 5));
+
+	InterpolatedTransform<Transform2D> interpolation;
+	interpolation.reset(first);
+	CHECK_MESSAGE(
+			interpolation.interpolate(0.5).is_equal_approx(first),
+			"After a reset there should be nothing to blend.");
+
+	interpolation.curr = second;
+	interpolation.tick();
+	CHECK_MESSAGE(
+			interpolation.prev == second,
+			"A tick should make the current transform the start of the next blend.");
+	interpolation.curr = third;
+	CHECK_MESSAGE(
+			interpolation.interpolate(0.5).is_equal_approx(second.interpolate_with(third, 0.5)),
+			"After a tick the blend should start from the transform of the last tick.");
+
+	interpolation.reset(third);
+	CHECK_MESSAGE(
+			interpolation.prev == third,
+			"A reset should drop the transform of the previous tick.");
+	CHECK_MESSAGE(
+			interpolation.interpolate(0).is_equal_approx(third),
+			"After a reset the transform should not be blended from the old position.");
+	CHECK_MESSAGE(
+			interpolation.interpolate(1).is_equal_approx(third),
+			"After a reset the transform should not be blended from the old position.");
+}
+
+} // namespace TestInterpolatedTransform
+
+#endif // TEST_INTERPOLATED_TRANSFORM_H
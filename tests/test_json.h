@@ -31,9 +31,11 @@
 #ifndef TEST_JSON_H
 #define TEST_JSON_H
 
+#include "core/io/file_access_memory.h"
 #include "core/io/json.h"
+#include "core/os/os.h"
 
-#include "thirdparty/doctest/doctest.h"
+#include "tests/test_macros.h"
 
 namespace TestJSON {
 
@@ -161,6 +163,199 @@ TEST_CASE("[JSON] Parsing objects (dictionaries)") {
 			dictionary["empty_object"].hash() == Dictionary().hash(),
 			"The parsed JSON should contain the expected values.");
 }
+
+static Variant _parse_utf8(const String &p_json, String &r_err_str, int &r_err_line) {
+	CharString utf8 = p_json.utf8();
+	Variant result;
+	JSON::parse_utf8((const uint8_t *)utf8.get_data(), utf8.length(), result, r_err_str, r_err_line);
+	return result;
+}
+
+static Variant _parse_file(const CharString &p_json, String &r_err_str, int &r_err_line) {
+	FileAccessMemory file;
+	file.open_custom((const uint8_t *)p_json.get_data(), p_json.length());
+	Variant result;
+	JSON::parse_file(&file, result, r_err_str, r_err_line);
+	return result;
+}
+
+static String _print_utf8(const Variant &p_var, const String &p_indent = "") {
+	LocalVector<uint8_t> buffer;
+	JSON::print_utf8(p_var, buffer, p_indent);
+	String str;
+	str.parse_utf8((const char *)buffer.ptr(), buffer.size());
+	return str;
+}
+
+TEST_CASE("[JSON] Parsing UTF-8 buffers") {
+	String err_str;
+	int err_line = -1;
+
+	const String json = String::utf8(R"({"name": "Godot Engine", "is_free": true, "bugs": null, "apples": {"red": 500, "green": 0, "blue": -20.5e1}, "list": [1, [], {}, "\u00e9\ud83d\ude00", "tab\tquote\"slash\\"], "unicode": "日本語"})");
+	Variant expected;
+	String expected_err_str;
+	int expected_err_line = -1;
+	JSON::parse(json, expected, expected_err_str, expected_err_line);
+
+	Variant result = _parse_utf8(json, err_str, err_line);
+	CHECK_MESSAGE(
+			err_line == 0,
+			"Parsing a UTF-8 buffer should parse successfully.");
+	CHECK_MESSAGE(
+			result.hash() == expected.hash(),
+			"Parsing a UTF-8 buffer should give the same result as parsing a String.");
+
+	const Dictionary dictionary = result;
+	CHECK(dictionary["unicode"] == String::utf8("日本語"));
+	CHECK(Array(dictionary["list"])[3] == String::utf8("é😀"));
+	CHECK(Array(dictionary["list"])[4] == "tab\tquote\"slash\\");
+	CHECK(Math::is_equal_approx(Dictionary(dictionary["apples"])["blue"], -205));
+
+	// A leading byte order mark is skipped.
+	const uint8_t bom[] = { 0xEF, 0xBB, 0xBF, '[', '1', ']' };
+	JSON::parse_utf8(bom, sizeof(bom), result, err_str, err_line);
+	CHECK(err_line == 0);
+	CHECK(Array(result).size() == 1);
+}
+
+TEST_CASE("[JSON] Parsing UTF-8 buffers reports errors") {
+	String err_str;
+	int err_line = -1;
+
+	Variant result = _parse_utf8("[1,\n2,\n\"unterminated]", err_str, err_line);
+	CHECK(err_str == "Unterminated String");
+	CHECK(err_line == 2);
+
+	result = _parse_utf8("{\"key\" 1}", err_str, err_line);
+	CHECK(err_str == "Expected ':'");
+
+	result = _parse_utf8("[nope]", err_str, err_line);
+	CHECK(err_str == "Expected 'true','false' or 'null', got 'nope'.");
+
+	result = _parse_utf8("[1] 2", err_str, err_line);
+	CHECK(err_str == "Expected 'EOF'");
+	CHECK(result == Variant());
+
+	result = _parse_utf8("\"\\uZZZZ\"", err_str, err_line);
+	CHECK(err_str == "Malformed hex constant in string");
+}
+
+TEST_CASE("[JSON] Parsing files in chunks") {
+	// Larger than the chunk size, so tokens and strings cross chunk boundaries.
+	String json = "[\n";
+	for (int i = 0; i < 20000; i++) {
+		json += vformat("{\"id\": %d, \"name\": \"item \\\"%d\\\" \\u00f1\", \"value\": %f},\n", i, i, i * 0.25);
+	}
+	json += "null\n]";
+
+	Variant expected;
+	String err_str;
+	int expected_err_line = -1;
+	JSON::parse(json, expected, err_str, expected_err_line);
+
+	int err_line = -1;
+	Variant result = _parse_file(json.utf8(), err_str, err_line);
+	CHECK_MESSAGE(
+			err_line == expected_err_line,
+			"Parsing a file should count lines like parsing a String.");
+	CHECK_MESSAGE(
+			result.hash() == expected.hash(),
+			"Parsing a file should give the same result as parsing a String.");
+	CHECK(Array(result).size() == 20001);
+}
+
+TEST_CASE("[JSON] Printing to UTF-8 buffers") {
+	Dictionary dictionary;
+	dictionary["name"] = String::utf8("Godot «Engine»\n");
+	dictionary["int"] = INT64_MIN;
+	dictionary["float"] = 0.5;
+	dictionary["empty"] = Array();
+	Array list;
+	list.push_back(true);
+	list.push_back(false);
+	list.push_back(Variant());
+	list.push_back(Vector2(1, 2));
+	list.push_back(42);
+	dictionary["list"] = list;
+
+	CHECK(_print_utf8(dictionary) == JSON::print(dictionary));
+	CHECK(_print_utf8(dictionary, "\t") == JSON::print(dictionary, "\t"));
+	CHECK(_print_utf8(String::utf8("😀\"\\")) == JSON::print(String::utf8("😀\"\\")));
+}
+
+// Parses and prints a glTF-like document through String and through
+// UTF-8 buffers, reporting throughput in MB/s of UTF-8 text.
+static void bench_json() {
+	Array nodes;
+	for (int i = 0; i < 20000; i++) {
+		Dictionary node;
+		node["name"] = "Node_" + itos(i);
+		Array translation;
+		translation.push_back(i * 0.5);
+		translation.push_back(-i * 0.25);
+		translation.push_back(1.0);
+		node["translation"] = translation;
+		Array children;
+		children.push_back(i + 1);
+		children.push_back(i + 2);
+		node["children"] = children;
+		node["extras"] = String::utf8("Ünïcödé \"quoted\" text");
+		nodes.push_back(node);
+	}
+	Dictionary document;
+	document["nodes"] = nodes;
+
+	const String text = JSON::print(document, "\t");
+	const CharString utf8 = text.utf8();
+	const uint64_t bytes = utf8.length();
+	const int rounds = 5;
+
+	Variant result;
+	String err_str;
+	int err_line = 0;
+
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < rounds; i++) {
+		String str;
+		str.parse_utf8(utf8.get_data(), utf8.length());
+		JSON::parse(str, result, err_str, err_line);
+	}
+	uint64_t string_usec = bench_usec(begin);
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < rounds; i++) {
+		JSON::parse_utf8((const uint8_t *)utf8.get_data(), utf8.length(), result, err_str, err_line);
+	}
+	uint64_t utf8_usec = bench_usec(begin);
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < rounds; i++) {
+		FileAccessMemory file;
+		file.open_custom((const uint8_t *)utf8.get_data(), utf8.length());
+		JSON::parse_file(&file, result, err_str, err_line);
+	}
+	uint64_t file_usec = bench_usec(begin);
+
+	print_line(vformat("Parsing %d KB: String %d MB/s, parse_utf8 %d MB/s, parse_file %d MB/s.", (int64_t)(bytes / 1024), (int64_t)(bytes * rounds / string_usec), (int64_t)(bytes * rounds / utf8_usec), (int64_t)(bytes * rounds / file_usec)));
+
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < rounds; i++) {
+		CharString printed = JSON::print(document, "\t").utf8();
+	}
+	string_usec = bench_usec(begin);
+
+	LocalVector<uint8_t> buffer;
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < rounds; i++) {
+		buffer.clear();
+		JSON::print_utf8(document, buffer, "\t");
+	}
+	utf8_usec = bench_usec(begin);
+
+	print_line(vformat("Printing: String %d MB/s, print_utf8 %d MB/s.", (int64_t)(bytes * rounds / string_usec), (int64_t)(bytes * rounds / utf8_usec)));
+}
+
+REGISTER_TEST_COMMAND("json-bench", &bench_json);
 } // namespace TestJSON
 
 #endif // TEST_JSON_H
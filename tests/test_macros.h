@@ -31,6 +31,7 @@
 #ifndef TEST_MACROS_H
 #define TEST_MACROS_H
 
+#include "core/os/os.h"
 #include "core/templates/map.h"
 #include "core/variant/variant.h"
 
@@ -129,4 +130,12 @@ int register_test_command(String p_command, TestFunc p_function);
 			register_test_command(m_command, m_function);               \
 	DOCTEST_GLOBAL_NO_WARNINGS_END()
 
+// Benchmarks are registered as test commands named "*-bench", e.g. `godot --test json-bench`.
+// They print their timings, the matching test cases check the results.
+
+// Microseconds elapsed since p_begin, never zero so rates can be divided by it.
+inline uint64_t bench_usec(uint64_t p_begin) {
+	return MAX(OS::get_singleton()->get_ticks_usec() - p_begin, (uint64_t)1);
+}
+
 #endif // TEST_MACROS_H
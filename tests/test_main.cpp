@@ -40,17 +40,21 @@
 #include "test_color.h"
 #include "test_command_queue.h"
 #include "test_config_file.h"
+#include "test_control.h"
+#include "test_cpu_particles.h"
 #include "test_crypto.h"
 #include "test_curve.h"
 #include "test_dictionary.h"
 #include "test_expression.h"
 #include "test_file_access.h"
+#include "test_flat_hash_map.h"
 #include "test_geometry_2d.h"
 #include "test_geometry_3d.h"
 #include "test_gradient.h"
 #include "test_gui.h"
 #include "test_hashing_context.h"
 #include "test_image.h"
+#include "test_interpolated_transform.h"
 #include "test_json.h"
 #include "test_list.h"
 #include "test_local_vector.h"
@@ -58,6 +62,8 @@
 #include "test_marshalls.h"
 #include "test_math.h"
 #include "test_method_bind.h"
+#include "test_multiplayer_api.h"
+#include "test_net_socket_reactor.h"
 #include "test_node_path.h"
 #include "test_oa_hash_map.h"
 #include "test_object.h"
@@ -67,6 +73,9 @@
 #include "test_pck_packer.h"
 #include "test_physics_2d.h"
 #include "test_physics_3d.h"
+#include "test_physics_interpolation.h"
+#include "test_physics_server_2d.h"
+#include "test_physics_server_3d.h"
 #include "test_random_number_generator.h"
 #include "test_rect2.h"
 #include "test_render.h"
@@ -74,6 +83,9 @@
 #include "test_shader_lang.h"
 #include "test_string.h"
 #include "test_text_server.h"
+#include "test_tile_map.h"
+#include "test_timer_wheel.h"
+#include "test_transform_hierarchy_3d.h"
 #include "test_translation.h"
 #include "test_validate_testing.h"
 #include "test_variant.h"
@@ -0,0 +1,493 @@
+/*************************************************************************/
+/*  test_multiplayer_api.h                                               */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_MULTIPLAYER_API_H
+#define TEST_MULTIPLAYER_API_H
+
+#include "core/io/marshalls.h"
+#include "core/io/multiplayer_api.h"
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+#include "scene/main/node.h"
+
+#include "tests/test_macros.h"
+#include "thirdparty/doctest/doctest.h"
+
+namespace TestMultiplayerAPI {
+
+class LoopbackMultiplayerPeer;
+
+// Routes packets between loopback peers, counting and optionally dropping them.
+struct LoopbackHub {
+	Map<int, LoopbackMultiplayerPeer *> peers;
+	Map<int, uint64_t> bytes_sent;
+	int drop_unreliable_every = 0; // 1 drops all unreliable packets, N every Nth.
+	int unreliable_count = 0;
+};
+
+// Not registered in ClassDB, so signals resolve on NetworkedMultiplayerPeer.
+class LoopbackMultiplayerPeer : public NetworkedMultiplayerPeer {
+	struct Packet {
+		int from = 0;
+		Vector<uint8_t> data;
+	};
+
+	LoopbackHub *hub = nullptr;
+	int id = 0;
+	int target = 0;
+	TransferMode transfer_mode = TRANSFER_MODE_RELIABLE;
+	List<Packet> incoming;
+	Vector<uint8_t> current;
+
+public:
+	Set<int> links;
+
+	virtual void set_transfer_mode(TransferMode p_mode) override { transfer_mode = p_mode; }
+	virtual TransferMode get_transfer_mode() const override { return transfer_mode; }
+	virtual void set_target_peer(int p_peer_id) override { target = p_peer_id; }
+	virtual int get_packet_peer() const override { return incoming.size() ? incoming.front()->get().from : 0; }
+	virtual bool is_server() const override { return id == 1; }
+	virtual void poll() override {}
+	virtual int get_unique_id() const override { return id; }
+	virtual void set_refuse_new_connections(bool p_enable) override {}
+	virtual bool is_refusing_new_connections() const override { return false; }
+	virtual ConnectionStatus get_connection_status() const override { return CONNECTION_CONNECTED; }
+
+	virtual int get_available_packet_count() const override { return incoming.size(); }
+	virtual int get_max_packet_size() const override { return 1 << 24; }
+
+	virtual Error get_packet(const uint8_t **r_buffer, int &r_buffer_size) override {
+		ERR_FAIL_COND_V(incoming.is_empty(), ERR_UNAVAILABLE);
+		current = incoming.front()->get().data;
+		incoming.pop_front();
+		*r_buffer = current.ptr();
+		r_buffer_size = current.size();
+		return OK;
+	}
+
+	virtual Error put_packet(const uint8_t *p_buffer, int p_buffer_size) override {
+		for (Set<int>::Element *E = links.front(); E; E = E->next()) {
+			if ((target > 0 && E->get() != target) || (target < 0 && E->get() == -target)) {
+				continue;
+			}
+			hub->bytes_sent[id] += p_buffer_size;
+			if (transfer_mode != TRANSFER_MODE_RELIABLE && hub->drop_unreliable_every > 0 && ++hub->unreliable_count % hub->drop_unreliable_every == 0) {
+				continue;
+			}
+			Packet packet;
+			packet.from = id;
+			packet.data.resize(p_buffer_size);
+			memcpy(packet.data.ptrw(), p_buffer, p_buffer_size);
+			hub->peers[E->get()]->incoming.push_back(packet);
+		}
+		return OK;
+	}
+
+	void link(LoopbackMultiplayerPeer *p_other) {
+		links.insert(p_other->id);
+		p_other->links.insert(id);
+		emit_signal("peer_connected", p_other->id);
+		p_other->emit_signal("peer_connected", id);
+	}
+
+	LoopbackMultiplayerPeer(LoopbackHub *p_hub, int p_id) {
+		hub = p_hub;
+		id = p_id;
+		hub->peers[id] = this;
+	}
+};
+
+class ReplicatedNode : public Node {
+public:
+	Vector3 position;
+	Quat rotation;
+	int health = 0;
+
+protected:
+	virtual bool _setv(const StringName &p_name, const Variant &p_value) override {
+		if (p_name == "position") {
+			position = p_value;
+		} else if (p_name == "rotation") {
+			rotation = p_value;
+		} else if (p_name == "health") {
+			health = p_value;
+		} else {
+			return Node::_setv(p_name, p_value);
+		}
+		return true;
+	}
+
+	virtual bool _getv(const StringName &p_name, Variant &r_ret) const override {
+		if (p_name == "position") {
+			r_ret = position;
+		} else if (p_name == "rotation") {
+			r_ret = rotation;
+		} else if (p_name == "health") {
+			r_ret = health;
+		} else {
+			return Node::_getv(p_name, r_ret);
+		}
+		return true;
+	}
+};
+
+// A server (peer 1) connected to some clients, each with the same replicated
+// nodes under its multiplayer root.
+struct ReplicationWorld {
+	LoopbackHub hub;
+	Vector<Ref<MultiplayerAPI>> apis;
+	Vector<Ref<LoopbackMultiplayerPeer>> peers;
+	Vector<Node *> roots;
+	Vector<Vector<ReplicatedNode *>> nodes;
+
+	Ref<MultiplayerAPI> server() { return apis[0]; }
+	ReplicatedNode *node(int p_peer, int p_index) { return nodes[p_peer][p_index]; }
+
+	// Sends the server state, then lets everyone process what they received.
+	uint64_t tick() {
+		hub.bytes_sent[1] = 0;
+		server()->replication_send();
+		for (int i = 1; i < apis.size(); i++) {
+			apis.write[i]->poll();
+		}
+		apis.write[0]->poll();
+		return hub.bytes_sent[1];
+	}
+
+	ReplicationWorld(int p_clients, int p_entities, real_t p_step = 0.01) {
+		for (int i = 0; i <= p_clients; i++) {
+			Ref<LoopbackMultiplayerPeer> peer = memnew(LoopbackMultiplayerPeer(&hub, i + 1));
+			Ref<MultiplayerAPI> api;
+			api.instance();
+			Node *root = memnew(Node);
+			api->set_root_node(root);
+			api->set_network_peer(peer);
+
+			Vector<ReplicatedNode *> entities;
+			for (int j = 0; j < p_entities; j++) {
+				ReplicatedNode *entity = memnew(ReplicatedNode);
+				entity->set_name("Entity" + itos(j));
+				root->add_child(entity);
+				api->replication_add_property(entity, "position", MultiplayerAPI::REPLICATION_HINT_VECTOR3, p_step);
+				api->replication_add_property(entity, "rotation", MultiplayerAPI::REPLICATION_HINT_QUAT);
+				api->replication_add_property(entity, "health");
+				entities.push_back(entity);
+			}
+
+			peers.push_back(peer);
+			apis.push_back(api);
+			roots.push_back(root);
+			nodes.push_back(entities);
+		}
+		for (int i = 1; i <= p_clients; i++) {
+			peers.write[0]->link(peers.write[i].ptr());
+		}
+	}
+
+	~ReplicationWorld() {
+		for (int i = 0; i < apis.size(); i++) {
+			apis.write[i]->set_network_peer(Ref<NetworkedMultiplayerPeer>());
+			memdelete(roots[i]);
+		}
+	}
+};
+
+TEST_CASE("[MultiplayerAPI] Replication sends the full state once, then only changes") {
+	ReplicationWorld world(1, 3);
+	for (int i = 0; i < 3; i++) {
+		world.node(0, i)->position = Vector3(i, 2, 3);
+		world.node(0, i)->health = 100 + i;
+	}
+
+	// The first tick only sends the paths to the client.
+	world.tick();
+	CHECK(world.node(1, 0)->health == 0);
+
+	const uint64_t full = world.tick();
+	for (int i = 0; i < 3; i++) {
+		CHECK(world.node(1, i)->position.is_equal_approx(Vector3(i, 2, 3)));
+		CHECK(world.node(1, i)->health == 100 + i);
+	}
+
+	const uint64_t idle = world.tick();
+	CHECK_MESSAGE(idle == 10, "Nothing changed, only the header and the two end bits should be sent.");
+
+	world.node(0, 1)->health = 50;
+	const uint64_t delta = world.tick();
+	CHECK(world.node(1, 1)->health == 50);
+	CHECK(world.node(1, 0)->health == 100);
+	CHECK(delta > idle);
+	CHECK(delta < full);
+
+	// Clients only accept state from the network master of each node.
+	world.node(1, 2)->set_network_master(2);
+	world.node(0, 2)->health = 1;
+	world.tick();
+	CHECK(world.node(1, 2)->health == 102);
+}
+
+TEST_CASE("[MultiplayerAPI] Replication quantization") {
+	const int count = 64;
+	ReplicationWorld world(1, count, 0.01);
+	RandomPCG rng(1234);
+	for (int i = 0; i < count; i++) {
+		ReplicatedNode *node = world.node(0, i);
+		node->position = Vector3(rng.randf() - 0.5, rng.randf() - 0.5, rng.randf() - 0.5) * 2000;
+		node->rotation = Quat(Vector3(rng.randf() - 0.5, rng.randf() - 0.5, rng.randf() - 0.5).normalized(), (rng.randf() - 0.5) * Math_TAU);
+	}
+	world.node(0, 0)->rotation = Quat(0, 0, 0, -1);
+	world.node(0, 1)->rotation = Quat(0, 1, 0, 0);
+	world.tick();
+	world.tick();
+
+	for (int i = 0; i < count; i++) {
+		const ReplicatedNode *sent = world.node(0, i);
+		const ReplicatedNode *received = world.node(1, i);
+		for (int k = 0; k < 3; k++) {
+			CHECK(Math::abs(received->position[k] - sent->position[k]) <= 0.0051);
+		}
+		CHECK(received->rotation.is_normalized());
+		CHECK(Math::abs(received->rotation.dot(sent->rotation)) > 0.99999);
+	}
+}
+
+TEST_CASE("[MultiplayerAPI] Replication recovers from packet loss") {
+	ReplicationWorld world(1, 4);
+	world.tick();
+	world.tick();
+
+	// Nothing gets through, including acknowledgements.
+	world.hub.drop_unreliable_every = 1;
+	world.node(0, 0)->health = 10;
+	world.tick();
+	world.tick();
+	CHECK(world.node(1, 0)->health == 0);
+	world.hub.drop_unreliable_every = 0;
+	world.tick();
+	CHECK(world.node(1, 0)->health == 10);
+
+	// Every other packet is lost while the state keeps changing.
+	world.hub.drop_unreliable_every = 2;
+	for (int t = 0; t < 40; t++) {
+		world.node(0, t % 4)->position += Vector3(1, 0, 0);
+		world.node(0, (t + 1) % 4)->health = t;
+		world.tick();
+	}
+	// Longer than the history, the server falls back to sending everything.
+	world.hub.drop_unreliable_every = 1;
+	for (int t = 0; t < REPLICATION_HISTORY_SIZE + 4; t++) {
+		world.node(0, 3)->health = 1000 + t;
+		world.tick();
+	}
+	world.hub.drop_unreliable_every = 0;
+	world.tick();
+
+	for (int i = 0; i < 4; i++) {
+		CHECK(world.node(1, i)->position.is_equal_approx(world.node(0, i)->position));
+		CHECK(world.node(1, i)->health == world.node(0, i)->health);
+	}
+}
+
+TEST_CASE("[MultiplayerAPI] Replication skips nodes the receiver doesn't know") {
+	ReplicationWorld world(1, 3);
+	for (int i = 0; i < 3; i++) {
+		world.node(0, i)->position = Vector3(i, 0, 0);
+	}
+	world.tick();
+	world.tick();
+	CHECK(world.node(1, 1)->position.is_equal_approx(Vector3(1, 0, 0)));
+
+	// The client loses one node, the others must keep updating.
+	memdelete(world.node(1, 1));
+	world.nodes.write[1].write[1] = nullptr;
+	for (int i = 0; i < 3; i++) {
+		world.node(0, i)->position += Vector3(0, 10, 0);
+		world.node(0, i)->health = 10 + i;
+	}
+	world.tick();
+	world.tick();
+	CHECK(world.node(1, 0)->health == 10);
+	CHECK(world.node(1, 2)->health == 12);
+	CHECK(world.node(1, 2)->position.is_equal_approx(Vector3(2, 10, 0)));
+
+	// Once the node is back, it gets the full state rather than a delta against values it never had.
+	ReplicatedNode *entity = memnew(ReplicatedNode);
+	entity->set_name("Entity1");
+	world.roots[1]->add_child(entity);
+	world.apis.write[1]->replication_add_property(entity, "position", MultiplayerAPI::REPLICATION_HINT_VECTOR3, 0.01);
+	world.apis.write[1]->replication_add_property(entity, "rotation", MultiplayerAPI::REPLICATION_HINT_QUAT);
+	world.apis.write[1]->replication_add_property(entity, "health");
+	world.nodes.write[1].write[1] = entity;
+	world.node(0, 1)->position += Vector3(0, 0, 5);
+	world.tick();
+	CHECK(entity->position.is_equal_approx(Vector3(1, 10, 5)));
+	CHECK(entity->health == 11);
+}
+
+TEST_CASE("[MultiplayerAPI] Replication of far away positions") {
+	ReplicationWorld world(1, 1, 0.001);
+	world.node(0, 0)->position = Vector3(-1000000, 0, 0);
+	world.tick();
+	world.tick();
+	CHECK(world.node(1, 0)->position.is_equal_approx(Vector3(-1000000, 0, 0)));
+
+	// The delta is close to the int32 range, adding it to the baseline must not wrap.
+	world.node(0, 0)->position = Vector3(1000000, 0, 0);
+	world.tick();
+	CHECK(world.node(1, 0)->position.is_equal_approx(Vector3(1000000, 0, 0)));
+}
+
+TEST_CASE("[MultiplayerAPI] Replication interest management") {
+	ReplicationWorld world(2, 2);
+	world.node(0, 1)->position = Vector3(100, 0, 0);
+	world.node(0, 0)->health = 1;
+	world.node(0, 1)->health = 2;
+	world.server()->replication_set_peer_interest(3, Vector3(), 10);
+	world.tick();
+	world.tick();
+
+	CHECK(world.node(1, 0)->health == 1);
+	CHECK(world.node(1, 1)->health == 2);
+	CHECK(world.node(2, 0)->health == 1);
+	CHECK_MESSAGE(world.node(2, 1)->health == 0, "Nodes out of the interest radius should not be sent.");
+
+	world.node(0, 1)->position = Vector3(5, 0, 0);
+	world.tick();
+	CHECK(world.node(2, 1)->health == 2);
+	CHECK(world.node(2, 1)->position.is_equal_approx(Vector3(5, 0, 0)));
+
+	// Leaving and entering again sends the full state.
+	world.node(0, 1)->position = Vector3(50, 0, 0);
+	world.tick();
+	world.node(0, 1)->health = 3;
+	world.tick();
+	CHECK(world.node(2, 1)->health == 2);
+	world.node(0, 1)->position = Vector3(0, 5, 0);
+	world.tick();
+	CHECK(world.node(2, 1)->health == 3);
+	CHECK(world.node(2, 1)->position.is_equal_approx(Vector3(0, 5, 0)));
+
+	// Explicit visibility overrides the radius.
+	world.server()->replication_set_visibility(world.node(0, 0), 2, false);
+	world.server()->replication_set_visibility(world.node(0, 1), 3, true);
+	world.node(0, 0)->health = 4;
+	world.node(0, 1)->position = Vector3(0, 500, 0);
+	world.tick();
+	CHECK(world.node(1, 0)->health == 1);
+	CHECK(world.node(2, 0)->health == 4);
+	CHECK(world.node(2, 1)->position.is_equal_approx(Vector3(0, 500, 0)));
+}
+
+// A server replicating moving entities to many clients at 30 Hz, compared to
+// the size of sending the same changes as unreliable rset() calls.
+static void bench_replication(const char *p_name, int p_clients, int p_entities, real_t p_interest_radius) {
+	const int ticks = 90;
+	const real_t world_size = 200;
+	ReplicationWorld world(p_clients, p_entities);
+	RandomPCG rng(0);
+	for (int i = 0; i < p_entities; i++) {
+		world.node(0, i)->position = Vector3(rng.randf(), 0, rng.randf()) * world_size;
+	}
+	Vector<Vector3> origins;
+	for (int i = 1; i <= p_clients; i++) {
+		origins.push_back(Vector3(rng.randf(), 0, rng.randf()) * world_size);
+		if (p_interest_radius > 0) {
+			world.server()->replication_set_peer_interest(i + 1, origins[i - 1], p_interest_radius);
+		}
+	}
+	world.tick();
+	world.tick();
+
+	// Each rset() sends the command, a 16-bit node id, an 8-bit property id and
+	// the compressed variant, which has a one byte header instead of four.
+	int vector3_len = 0;
+	int quat_len = 0;
+	encode_variant(Vector3(), nullptr, vector3_len);
+	encode_variant(Quat(), nullptr, quat_len);
+	const int rset_len = (4 + vector3_len - 3) + (4 + quat_len - 3);
+
+	uint64_t bytes = 0;
+	uint64_t rset_bytes = 0;
+	uint64_t usec = 0;
+	for (int t = 0; t < ticks; t++) {
+		// A quarter of the entities move each tick.
+		for (int i = 0; i < p_entities; i++) {
+			if (rng.rand() % 4) {
+				continue;
+			}
+			ReplicatedNode *node = world.node(0, i);
+			node->position += Vector3(rng.randf() - 0.5, 0, rng.randf() - 0.5);
+			node->rotation = node->rotation * Quat(Vector3(0, 1, 0), rng.randf() * 0.1);
+			for (int j = 0; j < p_clients; j++) {
+				if (p_interest_radius <= 0 || node->position.distance_to(origins[j]) <= p_interest_radius) {
+					rset_bytes += rset_len;
+				}
+			}
+		}
+
+		world.hub.bytes_sent[1] = 0;
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		world.server()->replication_send();
+		usec += OS::get_singleton()->get_ticks_usec() - begin;
+		bytes += world.hub.bytes_sent[1];
+		for (int j = 1; j <= p_clients; j++) {
+			world.apis.write[j]->poll();
+		}
+		world.server()->poll();
+	}
+
+	// Every client should see the latest state of the entities it is interested in.
+	int mismatches = 0;
+	for (int j = 1; j <= p_clients; j++) {
+		for (int i = 0; i < p_entities; i++) {
+			const ReplicatedNode *sent = world.node(0, i);
+			const ReplicatedNode *received = world.node(j, i);
+			if (p_interest_radius > 0 && sent->position.distance_to(origins[j - 1]) > p_interest_radius) {
+				continue;
+			}
+			if (received->position.distance_to(sent->position) > 0.01 || Math::abs(received->rotation.dot(sent->rotation)) < 0.9999) {
+				mismatches++;
+			}
+		}
+	}
+
+	print_line(vformat("%s: %d entities to %d peers, %d usec per tick.", p_name, p_entities, p_clients, (int64_t)(usec / ticks)));
+	print_line(vformat("%s: %d bytes per tick, rset() estimate %d bytes per tick (%.1fx).", p_name, (int64_t)(bytes / ticks), (int64_t)(rset_bytes / ticks), (double)rset_bytes / MAX(bytes, (uint64_t)1)));
+	print_line(vformat("%s: %d mismatches.", p_name, mismatches));
+}
+
+static void bench_replication() {
+	bench_replication("Replication", 64, 500, 0);
+	bench_replication("Replication with interest", 64, 500, 50);
+}
+REGISTER_TEST_COMMAND("replication-bench", &bench_replication);
+} // namespace TestMultiplayerAPI
+
+#endif // TEST_MULTIPLAYER_API_H
@@ -0,0 +1,224 @@
+/*************************************************************************/
+/*  test_net_socket_reactor.h                                            */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_NET_SOCKET_REACTOR_H
+#define TEST_NET_SOCKET_REACTOR_H
+
+#include "core/io/net_socket_reactor.h"
+#include "core/io/stream_peer_tcp.h"
+#include "core/io/tcp_server.h"
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+
+#include "tests/test_macros.h"
+
+namespace TestNetSocketReactor {
+
+// Connects up to p_count loopback clients to p_server, stopping early if the
+// process runs out of file descriptors.
+static int connect_loopback(Ref<TCPServer> p_server, int p_count, Vector<Ref<StreamPeerTCP>> &r_clients, Vector<Ref<StreamPeerTCP>> &r_accepted) {
+	for (int i = 0; i < p_count; i++) {
+		Ref<StreamPeerTCP> client;
+		client.instance();
+		if (client->connect_to_host(IPAddress("127.0.0.1"), p_server->get_local_port()) != OK) {
+			break;
+		}
+
+		const uint64_t deadline = OS::get_singleton()->get_ticks_msec() + 1000;
+		Ref<StreamPeerTCP> conn;
+		while (conn.is_null() && OS::get_singleton()->get_ticks_msec() < deadline) {
+			conn = p_server->take_connection();
+			if (conn.is_null()) {
+				OS::get_singleton()->delay_usec(100);
+			}
+		}
+		while (client->get_status() == StreamPeerTCP::STATUS_CONNECTING && OS::get_singleton()->get_ticks_msec() < deadline) {
+			OS::get_singleton()->delay_usec(100);
+		}
+		if (conn.is_null() || client->get_status() != StreamPeerTCP::STATUS_CONNECTED) {
+			break;
+		}
+
+		r_clients.push_back(client);
+		r_accepted.push_back(conn);
+	}
+	return r_accepted.size();
+}
+
+TEST_CASE("[NetSocketReactor] Reports sockets with new events") {
+	Ref<NetSocketReactor> reactor = Ref<NetSocketReactor>(NetSocketReactor::create());
+	if (reactor.is_null()) {
+		MESSAGE("No socket reactor on this platform.");
+		return;
+	}
+
+	Ref<TCPServer> server;
+	server.instance();
+	REQUIRE(server->listen(0, IPAddress("127.0.0.1")) == OK);
+	CHECK(server->add_to_reactor(reactor, 100) == OK);
+
+	Vector<Ref<StreamPeerTCP>> clients;
+	Vector<Ref<StreamPeerTCP>> accepted;
+	REQUIRE(connect_loopback(server, 3, clients, accepted) == 3);
+	for (int i = 0; i < 3; i++) {
+		CHECK(accepted.write[i]->add_to_reactor(reactor, i) == OK);
+	}
+
+	// Newly added sockets are reported once, as they are writable.
+	LocalVector<uint64_t> ready;
+	CHECK(reactor->wait(100, ready) == OK);
+	ready.clear();
+	CHECK(reactor->wait(0, ready) == OK);
+	CHECK_MESSAGE(ready.size() == 0, "Idle sockets should not be reported.");
+
+	uint8_t data[4] = { 1, 2, 3, 4 };
+	uint8_t buffer[4] = {};
+	int received = 0;
+	REQUIRE(clients.write[1]->put_data(data, 4) == OK);
+	ready.clear();
+	CHECK(reactor->wait(1000, ready) == OK);
+	REQUIRE(ready.size() == 1);
+	CHECK(ready[0] == 1);
+	CHECK(accepted.write[1]->get_partial_data(buffer, 4, received) == OK);
+	CHECK(received == 4);
+
+	REQUIRE(clients.write[1]->put_data(data, 4) == OK);
+	ready.clear();
+	CHECK(reactor->wait(1000, ready) == OK);
+	CHECK_MESSAGE(ready.find(1) != -1, "New data should be reported again.");
+
+	clients.write[2]->disconnect_from_host();
+	ready.clear();
+	CHECK(reactor->wait(1000, ready) == OK);
+	CHECK_MESSAGE(ready.find(2) != -1, "Disconnections should be reported.");
+
+	Ref<StreamPeerTCP> extra;
+	extra.instance();
+	REQUIRE(extra->connect_to_host(IPAddress("127.0.0.1"), server->get_local_port()) == OK);
+	ready.clear();
+	CHECK(reactor->wait(1000, ready) == OK);
+	CHECK_MESSAGE(ready.find(100) != -1, "Pending connections should be reported on the listening socket.");
+	CHECK(server->take_connection().is_valid());
+}
+
+// Many idle loopback connections with a few active ones each tick, serviced by
+// polling every connection or by waiting on the reactor.
+static void bench_net_socket_reactor() {
+	Ref<NetSocketReactor> reactor = Ref<NetSocketReactor>(NetSocketReactor::create());
+	if (reactor.is_null()) {
+		print_line("No socket reactor on this platform.");
+		return;
+	}
+
+	Ref<TCPServer> server;
+	server.instance();
+	ERR_FAIL_COND(server->listen(0, IPAddress("127.0.0.1")) != OK);
+
+	Vector<Ref<StreamPeerTCP>> clients;
+	Vector<Ref<StreamPeerTCP>> accepted;
+	const int count = connect_loopback(server, 4000, clients, accepted);
+	ERR_FAIL_COND(count == 0);
+	for (int i = 0; i < count; i++) {
+		accepted.write[i]->add_to_reactor(reactor, i);
+	}
+
+	const int ticks = 100;
+	const int active = MAX(1, count / 100);
+	LocalVector<uint64_t> ready;
+	uint8_t data[64] = {};
+	uint8_t buffer[1024];
+	RandomPCG rng(0);
+	uint64_t sent = 0;
+	uint64_t received = 0;
+
+	uint64_t poll_usec = 0;
+	for (int t = 0; t < ticks; t++) {
+		for (int i = 0; i < active; i++) {
+			clients.write[rng.rand() % count]->put_data(data, sizeof(data));
+			sent += sizeof(data);
+		}
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < count; i++) {
+			if (accepted[i]->get_available_bytes() > 0) {
+				int read = 0;
+				accepted.write[i]->get_partial_data(buffer, sizeof(buffer), read);
+				received += read;
+			}
+		}
+		poll_usec += OS::get_singleton()->get_ticks_usec() - begin;
+	}
+
+	// Forget the events from the previous run.
+	reactor->wait(100, ready);
+
+	uint64_t reactor_usec = 0;
+	for (int t = 0; t < ticks; t++) {
+		for (int i = 0; i < active; i++) {
+			clients.write[rng.rand() % count]->put_data(data, sizeof(data));
+			sent += sizeof(data);
+		}
+
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		ready.clear();
+		reactor->wait(0, ready);
+		for (uint32_t i = 0; i < ready.size(); i++) {
+			int read = 1;
+			while (read > 0) {
+				accepted.write[ready[i]]->get_partial_data(buffer, sizeof(buffer), read);
+				received += read;
+			}
+		}
+		reactor_usec += OS::get_singleton()->get_ticks_usec() - begin;
+	}
+
+	// Data still in flight.
+	ready.clear();
+	reactor->wait(100, ready);
+	for (uint32_t i = 0; i < ready.size(); i++) {
+		int read = 1;
+		while (read > 0) {
+			accepted.write[ready[i]]->get_partial_data(buffer, sizeof(buffer), read);
+			received += read;
+		}
+	}
+
+	poll_usec = MAX(poll_usec / ticks, (uint64_t)1);
+	reactor_usec = MAX(reactor_usec / ticks, (uint64_t)1);
+	print_line(vformat("Socket reactor: %d loopback connections, %d active per tick, %d bytes sent, %d received.", count, active, (int64_t)sent, (int64_t)received));
+	print_line(vformat("Polling every connection: %d usec per tick.", (int64_t)poll_usec));
+	print_line(vformat("Reactor: %d usec per tick.", (int64_t)reactor_usec));
+	// Assumes the cost grows with the connection count, with the same share of active ones.
+	print_line(vformat("Connections per core at 60 ticks per second: polling %d, reactor %d.", (int64_t)(count * 16666 / poll_usec), (int64_t)(count * 16666 / reactor_usec)));
+}
+REGISTER_TEST_COMMAND("net-reactor-bench", &bench_net_socket_reactor);
+} // namespace TestNetSocketReactor
+
+#endif // TEST_NET_SOCKET_REACTOR_H
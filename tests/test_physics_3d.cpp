@@ -32,13 +32,21 @@
 
 #include "core/math/math_funcs.h"
 #include "core/math/quick_hull.h"
+#include "core/math/triangle_bvh.h"
+#include "core/math/triangle_mesh.h"
 #include "core/os/main_loop.h"
 #include "core/os/os.h"
 #include "core/string/print_string.h"
 #include "core/templates/map.h"
+#include "core/templates/thread_work_pool.h"
 #include "servers/display_server.h"
+#include "servers/physics_3d/physics_server_3d_sw.h"
+#include "servers/physics_3d/shape_3d_sw.h"
+#include "servers/physics_3d/soft_body_3d_sw.h"
 #include "servers/physics_server_3d.h"
 #include "servers/rendering_server.h"
+#include "tests/test_macros.h"
+#include "tests/test_physics_server_3d.h"
 
 class TestPhysics3DMainLoop : public MainLoop {
 	GDCLASS(TestPhysics3DMainLoop, MainLoop);
@@ -412,4 +420,204 @@ namespace TestPhysics3D {
 MainLoop *test() {
 	return memnew(TestPhysics3DMainLoop);
 }
+
+// Measures long and short ray casts and height edits on a large map.
+void bench_heightmap_raycast() {
+	Math::seed(7);
+
+	const int size = 4096;
+	const real_t half_size = (size - 1) * 0.5;
+	HeightMapShape3DSW shape;
+
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+	TestPhysicsServer3D::make_heightmap(shape, size, 0);
+	t = OS::get_singleton()->get_ticks_usec() - t;
+	print_line(vformat("HeightMapShape3D: %dx%d generated and set up in %d usec.", size, size, t));
+
+	// Line of sight rays, a couple of units above the ground across the map.
+	const int rays = 10000;
+	int hits = 0;
+	t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < rays; i++) {
+		Vector3 begin(Math::random(-half_size, half_size), 30.0, Math::random(-half_size, half_size));
+		Vector3 end(Math::random(-half_size, half_size), 25.0, Math::random(-half_size, half_size));
+		Vector3 point, normal;
+		hits += shape.intersect_segment(begin, end, point, normal);
+	}
+	t = OS::get_singleton()->get_ticks_usec() - t;
+	print_line(vformat("HeightMapShape3D: %d long rays (%d hits) in %d usec.", rays, hits, t));
+
+	// Short rays, like bullets.
+	hits = 0;
+	t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < rays; i++) {
+		Vector3 begin(Math::random(-half_size, half_size), Math::random(0.0, 30.0), Math::random(-half_size, half_size));
+		Vector3 end = begin + Vector3(Math::random(-20.0, 20.0), Math::random(-20.0, 5.0), Math::random(-20.0, 20.0));
+		Vector3 point, normal;
+		hits += shape.intersect_segment(begin, end, point, normal);
+	}
+	t = OS::get_singleton()->get_ticks_usec() - t;
+	print_line(vformat("HeightMapShape3D: %d short rays (%d hits) in %d usec.", rays, hits, t));
+
+	// Terrain edit, only a small patch of the heights changes.
+	Dictionary d = shape.get_data();
+	Vector<float> heights = d["heights"];
+	float *w = heights.ptrw();
+	for (int z = 1000; z < 1064; z++) {
+		for (int x = 2000; x < 2064; x++) {
+			w[z * size + x] -= 2.0;
+		}
+	}
+	d["heights"] = heights;
+	t = OS::get_singleton()->get_ticks_usec();
+	shape.set_data(d);
+	t = OS::get_singleton()->get_ticks_usec() - t;
+	print_line(vformat("HeightMapShape3D: 64x64 edit applied in %d usec.", t));
+}
+REGISTER_TEST_COMMAND("heightmap-raycast-bench", &bench_heightmap_raycast);
+
+// Measures BVH build, memory use, ray casts and AABB culling on 2M triangles.
+// The queries are checked against a brute force search by the PhysicsServer3D concave test.
+void bench_concave_bvh() {
+	Math::seed(7);
+
+	const int size = 1000;
+	const real_t half_size = size * 0.5;
+	Vector<Vector3> faces = TestPhysicsServer3D::make_concave_faces(size);
+	const int face_count = faces.size() / 3;
+
+	LocalVector<AABB> face_aabbs;
+	face_aabbs.resize(face_count);
+	for (int i = 0; i < face_count; i++) {
+		face_aabbs[i] = Face3(faces[i * 3 + 0], faces[i * 3 + 1], faces[i * 3 + 2]).get_aabb();
+	}
+
+	TriangleBVH bvh;
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+	bvh.build(face_aabbs.ptr(), face_count, false);
+	t = OS::get_singleton()->get_ticks_usec() - t;
+	print_line(vformat("TriangleBVH: %d triangles built in %d usec on one thread.", face_count, t));
+
+	t = OS::get_singleton()->get_ticks_usec();
+	bvh.build(face_aabbs.ptr(), face_count, true);
+	t = OS::get_singleton()->get_ticks_usec() - t;
+	print_line(vformat("TriangleBVH: %d triangles built in %d usec on a work pool.", face_count, t));
+
+	// The binary tree it replaces had 2N - 1 nodes of a full AABB and three indices each.
+	uint64_t previous_memory = uint64_t(face_count * 2 - 1) * (sizeof(AABB) + sizeof(int) * 3);
+	print_line(vformat("TriangleBVH: %d nodes, %d bytes (binary float tree: %d bytes).", bvh.get_node_count(), uint64_t(bvh.get_memory_usage()), previous_memory));
+
+	ConcavePolygonShape3DSW shape;
+	Dictionary d;
+	d["faces"] = faces;
+	d["backface_collision"] = false;
+	t = OS::get_singleton()->get_ticks_usec();
+	shape.set_data(d);
+	t = OS::get_singleton()->get_ticks_usec() - t;
+	print_line(vformat("ConcavePolygonShape3D: %d faces set up in %d usec.", face_count, t));
+
+	// Line of sight rays, a few units above the ground across the mesh.
+	const int rays = 10000;
+	int hits = 0;
+	t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < rays; i++) {
+		Vector3 begin(Math::random(-(double)half_size, (double)half_size), 30.0, Math::random(-(double)half_size, (double)half_size));
+		Vector3 end(Math::random(-(double)half_size, (double)half_size), 25.0, Math::random(-(double)half_size, (double)half_size));
+		Vector3 point, normal;
+		hits += shape.intersect_segment(begin, end, point, normal);
+	}
+	t = OS::get_singleton()->get_ticks_usec() - t;
+	print_line(vformat("ConcavePolygonShape3D: %d long rays (%d hits) in %d usec.", rays, hits, t));
+
+	// Short rays, like bullets.
+	hits = 0;
+	t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < rays; i++) {
+		Vector3 begin(Math::random(-(double)half_size, (double)half_size), Math::random(0.0, 30.0), Math::random(-(double)half_size, (double)half_size));
+		Vector3 end = begin + Vector3(Math::random(-20.0, 20.0), Math::random(-20.0, 5.0), Math::random(-20.0, 20.0));
+		Vector3 point, normal;
+		hits += shape.intersect_segment(begin, end, point, normal);
+	}
+	t = OS::get_singleton()->get_ticks_usec() - t;
+	print_line(vformat("ConcavePolygonShape3D: %d short rays (%d hits) in %d usec.", rays, hits, t));
+
+	// Body sized boxes, like the broad phase would send for the narrow phase.
+	int culled = 0;
+	t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < rays; i++) {
+		shape.cull(TestPhysicsServer3D::random_concave_aabb(half_size), TestPhysicsServer3D::count_concave_cull, &culled);
+	}
+	t = OS::get_singleton()->get_ticks_usec() - t;
+	print_line(vformat("ConcavePolygonShape3D: %d AABB culls (%d faces) in %d usec.", rays, culled, t));
+
+	Ref<TriangleMesh> triangle_mesh;
+	triangle_mesh.instance();
+	t = OS::get_singleton()->get_ticks_usec();
+	triangle_mesh->create(faces);
+	t = OS::get_singleton()->get_ticks_usec() - t;
+	print_line(vformat("TriangleMesh: %d faces created in %d usec.", face_count, t));
+
+	hits = 0;
+	t = OS::get_singleton()->get_ticks_usec();
+	for (int i = 0; i < rays; i++) {
+		// Picking rays, straight down from above the mesh.
+		Vector3 begin(Math::random(-(double)half_size, (double)half_size), 100.0, Math::random(-(double)half_size, (double)half_size));
+		Vector3 dir = Vector3(Math::random(-0.2, 0.2), -1.0, Math::random(-0.2, 0.2)).normalized();
+		Vector3 point, normal;
+		hits += triangle_mesh->intersect_ray(begin, dir, point, normal);
+	}
+	t = OS::get_singleton()->get_ticks_usec() - t;
+	print_line(vformat("TriangleMesh: %d picking rays (%d hits) in %d usec.", rays, hits, t));
+}
+REGISTER_TEST_COMMAND("concave-bvh-bench", &bench_concave_bvh);
+
+// Builds square cloth grids of about 1k, 10k and 50k nodes and measures creation and
+// constraint solving, serially and with the links solved on a work pool.
+// Both solves giving the same result is checked by the PhysicsServer3D soft body test.
+void bench_soft_body() {
+	// Needed for the shape updates of the soft bodies.
+	PhysicsServer3DSW *physics_server = memnew(PhysicsServer3DSW(false));
+
+	ThreadWorkPool work_pool;
+	work_pool.init();
+
+	const int sizes[3] = { 32, 100, 224 };
+	const int steps = 20;
+	const real_t delta = 1.0 / 60.0;
+
+	for (int i = 0; i < 3; i++) {
+		SoftBody3DSW *serial_body = memnew(SoftBody3DSW);
+		SoftBody3DSW *parallel_body = memnew(SoftBody3DSW);
+
+		uint64_t t = OS::get_singleton()->get_ticks_usec();
+		TestPhysicsServer3D::make_soft_body_grid(*serial_body, sizes[i]);
+		t = OS::get_singleton()->get_ticks_usec() - t;
+		TestPhysicsServer3D::make_soft_body_grid(*parallel_body, sizes[i]);
+		print_line(vformat("SoftBody3D: %d nodes, %d faces created in %d usec.", serial_body->get_node_count(), serial_body->get_face_count(), t));
+
+		TestPhysicsServer3D::perturb_soft_body(*serial_body);
+		TestPhysicsServer3D::perturb_soft_body(*parallel_body);
+
+		t = OS::get_singleton()->get_ticks_usec();
+		for (int step = 0; step < steps; step++) {
+			serial_body->solve_constraints(delta);
+		}
+		t = OS::get_singleton()->get_ticks_usec() - t;
+		print_line(vformat("SoftBody3D: %d serial steps in %d usec.", steps, t));
+
+		t = OS::get_singleton()->get_ticks_usec();
+		for (int step = 0; step < steps; step++) {
+			parallel_body->solve_constraints(delta, &work_pool);
+		}
+		t = OS::get_singleton()->get_ticks_usec() - t;
+		print_line(vformat("SoftBody3D: %d steps on the work pool in %d usec.", steps, t));
+
+		memdelete(serial_body);
+		memdelete(parallel_body);
+	}
+
+	work_pool.finish();
+	memdelete(physics_server);
+}
+REGISTER_TEST_COMMAND("soft-body-bench", &bench_soft_body);
 } // namespace TestPhysics3D
@@ -0,0 +1,165 @@
+/*************************************************************************/
+/*  test_physics_interpolation.h                                         */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_PHYSICS_INTERPOLATION_H
+#define TEST_PHYSICS_INTERPOLATION_H
+
+#include "servers/rendering/renderer_canvas_cull.h"
+#include "servers/rendering/renderer_scene_cull.h"
+#include "servers/rendering/rendering_server_globals.h"
+
+#include "tests/test_dummy_rendering_server.h"
+#include "tests/test_macros.h"
+
+namespace TestPhysicsInterpolation {
+
+// The transforms that get drawn, the server has no getters for them.
+static Transform _get_instance_transform(RID p_instance) {
+	return static_cast<RendererSceneCull *>(RSG::scene)->instance_owner.getornull(p_instance)->transform;
+}
+
+static Transform _get_camera_transform(RID p_camera) {
+	return static_cast<RendererSceneCull *>(RSG::scene)->camera_owner.getornull(p_camera)->transform;
+}
+
+static Transform2D _get_canvas_item_transform(RID p_item) {
+	return RSG::canvas->canvas_item_owner.getornull(p_item)->xform;
+}
+
+TEST_CASE("[PhysicsInterpolation] Instances are drawn between the last two ticks") {
+	DummyRenderingServer rendering_server;
+	RenderingServer *rs = RenderingServer::get_singleton();
+
+	RID instance = rs->instance_create();
+	rs->instance_set_interpolated(instance, true);
+	rs->instance_set_transform(instance, Transform(Basis(), Vector3(0, 0, 0)));
+	rs->tick();
+	rs->instance_set_transform(instance, Transform(Basis(), Vector3(4, 0, -2)));
+
+	CHECK_MESSAGE(
+			_get_instance_transform(instance).origin.is_equal_approx(Vector3(0, 0, 0)),
+			"Setting the transform during a tick should not move the drawn instance yet.");
+
+	RSG::scene->update_interpolation(0.5);
+	CHECK_MESSAGE(
+			_get_instance_transform(instance).origin.is_equal_approx(Vector3(2, 0, -1)),
+			"Halfway through the tick the instance should be drawn halfway between both ticks.");
+	RSG::scene->update_interpolation(1);
+	CHECK(_get_instance_transform(instance).origin.is_equal_approx(Vector3(4, 0, -2)));
+
+	// Nothing moved during this tick, the instance settles on the last transform.
+	rs->tick();
+	RSG::scene->update_interpolation(0.5);
+	CHECK_MESSAGE(
+			_get_instance_transform(instance).origin.is_equal_approx(Vector3(4, 0, -2)),
+			"An instance that didn't move during the last tick should stay where it is.");
+
+	// A teleport skips the blend.
+	rs->instance_set_transform(instance, Transform(Basis(), Vector3(10, 0, 0)));
+	rs->instance_reset_physics_interpolation(instance);
+	CHECK(_get_instance_transform(instance).origin.is_equal_approx(Vector3(10, 0, 0)));
+	RSG::scene->update_interpolation(0.5);
+	CHECK_MESSAGE(
+			_get_instance_transform(instance).origin.is_equal_approx(Vector3(10, 0, 0)),
+			"A reset instance should not blend from its previous transform.");
+
+	// Without interpolation the transform is drawn as soon as it is set.
+	rs->tick();
+	rs->instance_set_transform(instance, Transform(Basis(), Vector3(12, 0, 0)));
+	rs->instance_set_interpolated(instance, false);
+	CHECK(_get_instance_transform(instance).origin.is_equal_approx(Vector3(12, 0, 0)));
+	rs->instance_set_transform(instance, Transform(Basis(), Vector3(14, 0, 0)));
+	CHECK(_get_instance_transform(instance).origin.is_equal_approx(Vector3(14, 0, 0)));
+
+	rs->free(instance);
+}
+
+TEST_CASE("[PhysicsInterpolation] Cameras are drawn between the last two ticks") {
+	DummyRenderingServer rendering_server;
+	RenderingServer *rs = RenderingServer::get_singleton();
+
+	RID camera = rs->camera_create();
+	rs->camera_set_interpolated(camera, true);
+	rs->camera_set_transform(camera, Transform(Basis(), Vector3(0, 2, 0)));
+	rs->tick();
+	rs->camera_set_transform(camera, Transform(Basis(Vector3(0, 1, 0), Math_PI / 2), Vector3(0, 2, 8)));
+
+	RSG::scene->update_interpolation(0.5);
+	CHECK_MESSAGE(
+			_get_camera_transform(camera).is_equal_approx(Transform(Basis(Vector3(0, 1, 0), Math_PI / 4), Vector3(0, 2, 4))),
+			"Halfway through the tick the camera should be drawn halfway between both ticks.");
+
+	rs->tick();
+	RSG::scene->update_interpolation(0.5);
+	CHECK_MESSAGE(
+			_get_camera_transform(camera).is_equal_approx(Transform(Basis(Vector3(0, 1, 0), Math_PI / 2), Vector3(0, 2, 8))),
+			"A camera that didn't move during the last tick should stay where it is.");
+
+	rs->free(camera);
+}
+
+TEST_CASE("[PhysicsInterpolation] Canvas items are drawn between the last two ticks") {
+	DummyRenderingServer rendering_server;
+	RenderingServer *rs = RenderingServer::get_singleton();
+
+	RID item = rs->canvas_item_create();
+	rs->canvas_item_set_interpolated(item, true);
+	rs->canvas_item_set_transform(item, Transform2D(0, Vector2(0, 0)));
+	rs->tick();
+	rs->canvas_item_set_transform(item, Transform2D(0, Vector2(8, -4)));
+
+	CHECK_MESSAGE(
+			_get_canvas_item_transform(item).get_origin().is_equal_approx(Vector2(0, 0)),
+			"Setting the transform during a tick should not move the drawn item yet.");
+
+	RSG::canvas->update_interpolation(0.25);
+	CHECK_MESSAGE(
+			_get_canvas_item_transform(item).get_origin().is_equal_approx(Vector2(2, -1)),
+			"A quarter through the tick the item should be drawn a quarter of the way between both ticks.");
+
+	rs->tick();
+	RSG::canvas->update_interpolation(0.25);
+	CHECK_MESSAGE(
+			_get_canvas_item_transform(item).get_origin().is_equal_approx(Vector2(8, -4)),
+			"An item that didn't move during the last tick should stay where it is.");
+
+	rs->canvas_item_set_transform(item, Transform2D(0, Vector2(20, 0)));
+	rs->canvas_item_reset_physics_interpolation(item);
+	RSG::canvas->update_interpolation(0.25);
+	CHECK_MESSAGE(
+			_get_canvas_item_transform(item).get_origin().is_equal_approx(Vector2(20, 0)),
+			"A reset item should not blend from its previous transform.");
+
+	rs->free(item);
+}
+
+} // namespace TestPhysicsInterpolation
+
+#endif // TEST_PHYSICS_INTERPOLATION_H
@@ -0,0 +1,179 @@
+/*************************************************************************/
+/*  test_physics_server_2d.h                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_PHYSICS_SERVER_2D_H
+#define TEST_PHYSICS_SERVER_2D_H
+
+#include "core/math/math_funcs.h"
+#include "core/templates/local_vector.h"
+#include "core/templates/set.h"
+#include "core/templates/thread_work_pool.h"
+#include "servers/physics_2d/body_2d_sw.h"
+#include "servers/physics_2d/broad_phase_2d_hash_grid.h"
+
+#include "tests/test_macros.h"
+
+namespace TestPhysicsServer2D {
+
+struct BroadPhasePairs {
+	Set<uint64_t> live; // Keyed by the subindices, which are the object indices here.
+	int paired = 0;
+	int unpaired = 0;
+
+	static uint64_t key(int p_a, int p_b) {
+		return p_a < p_b ? ((uint64_t(p_a) << 32) | uint32_t(p_b)) : ((uint64_t(p_b) << 32) | uint32_t(p_a));
+	}
+
+	static void *pair(CollisionObject2DSW *p_a, int p_subindex_a, CollisionObject2DSW *p_b, int p_subindex_b, void *p_self) {
+		BroadPhasePairs *self = (BroadPhasePairs *)p_self;
+		self->live.insert(key(p_subindex_a, p_subindex_b));
+		self->paired++;
+		return p_self;
+	}
+
+	static void unpair(CollisionObject2DSW *p_a, int p_subindex_a, CollisionObject2DSW *p_b, int p_subindex_b, void *p_data, void *p_self) {
+		BroadPhasePairs *self = (BroadPhasePairs *)p_self;
+		self->live.erase(key(p_subindex_a, p_subindex_b));
+		self->unpaired++;
+	}
+};
+
+// Small objects drifting around, like bullets. One in 16 is static.
+// Also used by the broad phase benchmark.
+struct BroadPhaseBenchScene {
+	LocalVector<Body2DSW *> bodies;
+	LocalVector<Rect2> aabbs;
+	LocalVector<Vector2> velocities;
+	real_t extent = 0.0;
+
+	void create(int p_count) {
+		extent = Math::sqrt(real_t(p_count)) * 24.0;
+		bodies.resize(p_count);
+		aabbs.resize(p_count);
+		velocities.resize(p_count);
+		for (int i = 0; i < p_count; i++) {
+			bodies[i] = memnew(Body2DSW);
+			aabbs[i] = Rect2(Math::random(0.0, (double)extent), Math::random(0.0, (double)extent), 8.0, 8.0);
+			velocities[i] = is_static(i) ? Vector2() : Vector2(Math::random(-4.0, 4.0), Math::random(-4.0, 4.0));
+		}
+	}
+
+	static bool is_static(int p_index) {
+		return p_index % 16 == 0;
+	}
+
+	void step() {
+		for (uint32_t i = 0; i < aabbs.size(); i++) {
+			aabbs[i].position += velocities[i];
+		}
+	}
+
+	int count_brute_force_mismatches(const BroadPhasePairs &p_pairs) const {
+		int mismatches = 0;
+		int pairs = 0;
+		for (uint32_t i = 0; i < aabbs.size(); i++) {
+			for (uint32_t j = i + 1; j < aabbs.size(); j++) {
+				if ((is_static(i) && is_static(j)) || !aabbs[i].intersects(aabbs[j])) {
+					continue;
+				}
+				pairs++;
+				if (!p_pairs.live.has(BroadPhasePairs::key(i, j))) {
+					mismatches++;
+				}
+			}
+		}
+		return mismatches + ABS(p_pairs.live.size() - pairs);
+	}
+
+	void clear() {
+		for (uint32_t i = 0; i < bodies.size(); i++) {
+			memdelete(bodies[i]);
+		}
+		bodies.clear();
+	}
+};
+
+// Moves the scene for p_steps steps and counts the pairs that differ from brute force after each one.
+static int _count_broad_phase_mismatches(BroadPhase2DSW *p_broad_phase, const BroadPhaseBenchScene &p_scene_start, int p_steps, ThreadWorkPool *p_work_pool) {
+	BroadPhaseBenchScene scene = p_scene_start;
+	BroadPhasePairs pairs;
+	p_broad_phase->set_pair_callback(BroadPhasePairs::pair, &pairs);
+	p_broad_phase->set_unpair_callback(BroadPhasePairs::unpair, &pairs);
+
+	const int count = scene.aabbs.size();
+	LocalVector<BroadPhase2DSW::ID> ids;
+	ids.resize(count);
+	for (int i = 0; i < count; i++) {
+		ids[i] = p_broad_phase->create(scene.bodies[i], i, scene.aabbs[i], BroadPhaseBenchScene::is_static(i));
+	}
+	p_broad_phase->update(p_work_pool);
+
+	int mismatches = scene.count_brute_force_mismatches(pairs);
+	for (int step = 0; step < p_steps; step++) {
+		scene.step();
+		for (int i = 0; i < count; i++) {
+			p_broad_phase->move(ids[i], scene.aabbs[i]);
+		}
+		p_broad_phase->update(p_work_pool);
+		mismatches += scene.count_brute_force_mismatches(pairs);
+	}
+
+	for (int i = 0; i < count; i++) {
+		p_broad_phase->remove(ids[i]);
+	}
+	return mismatches;
+}
+
+TEST_CASE("[PhysicsServer2D] Hash grid pairs match a brute force search") {
+	Math::seed(11);
+	BroadPhaseBenchScene scene;
+	scene.create(2000);
+
+	BroadPhase2DHashGrid *serial_grid = memnew(BroadPhase2DHashGrid);
+	CHECK_MESSAGE(
+			_count_broad_phase_mismatches(serial_grid, scene, 30, nullptr) == 0,
+			"The hash grid should report the same pairs as a brute force search.");
+	memdelete(serial_grid);
+
+	ThreadWorkPool work_pool;
+	work_pool.init();
+	BroadPhase2DHashGrid *pooled_grid = memnew(BroadPhase2DHashGrid);
+	CHECK_MESSAGE(
+			_count_broad_phase_mismatches(pooled_grid, scene, 30, &work_pool) == 0,
+			"The hash grid should report the same pairs as a brute force search when updated on a work pool.");
+	memdelete(pooled_grid);
+	work_pool.finish();
+
+	scene.clear();
+}
+
+} // namespace TestPhysicsServer2D
+
+#endif // TEST_PHYSICS_SERVER_2D_H
@@ -0,0 +1,611 @@
+/*************************************************************************/
+/*  test_physics_server_3d.h                                             */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_PHYSICS_SERVER_3D_H
+#define TEST_PHYSICS_SERVER_3D_H
+
+#include "core/math/random_number_generator.h"
+#include "core/math/triangle_mesh.h"
+#include "core/templates/thread_work_pool.h"
+#include "servers/physics_3d/physics_server_3d_sw.h"
+#include "servers/physics_3d/shape_3d_sw.h"
+#include "servers/physics_3d/soft_body_3d_sw.h"
+
+#include "tests/test_macros.h"
+
+namespace TestPhysicsServer3D {
+
+// A SW physics server with a floor and static boxes and spheres scattered over it.
+// The server isn't running under --test, so the tests create their own.
+struct StaticScene {
+	PhysicsServer3DSW *server = nullptr;
+	RID space;
+	RID box_shape;
+	RID sphere_shape;
+	RID floor_shape;
+	LocalVector<RID> bodies;
+
+	RID add_static_body(RID p_shape, const Transform &p_transform) {
+		RID body = server->body_create();
+		server->body_set_mode(body, PhysicsServer3D::BODY_MODE_STATIC);
+		server->body_add_shape(body, p_shape);
+		server->body_set_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM, p_transform);
+		server->body_set_space(body, space);
+		bodies.push_back(body);
+		return body;
+	}
+
+	StaticScene() {
+		server = memnew(PhysicsServer3DSW(false));
+		server->init();
+
+		space = server->space_create();
+		server->space_set_active(space, true);
+
+		box_shape = server->box_shape_create();
+		server->shape_set_data(box_shape, Vector3(1, 1, 1));
+		sphere_shape = server->sphere_shape_create();
+		server->shape_set_data(sphere_shape, 0.75);
+
+		floor_shape = server->box_shape_create();
+		server->shape_set_data(floor_shape, Vector3(50, 1, 50));
+		add_static_body(floor_shape, Transform(Basis(), Vector3(0, -1, 0)));
+
+		Ref<RandomNumberGenerator> rng;
+		rng.instance();
+		rng->set_seed(0);
+		for (int i = 0; i < 200; i++) {
+			Basis basis(Vector3(0, 1, 0), rng->randf_range(0, Math_TAU));
+			Vector3 origin(rng->randf_range(-40, 40), rng->randf_range(0.5, 6), rng->randf_range(-40, 40));
+			add_static_body(i % 2 ? box_shape : sphere_shape, Transform(basis, origin));
+		}
+	}
+
+	~StaticScene() {
+		for (uint32_t i = 0; i < bodies.size(); i++) {
+			server->free(bodies[i]);
+		}
+		server->free(box_shape);
+		server->free(sphere_shape);
+		server->free(floor_shape);
+		server->free(space);
+		server->finish();
+		memdelete(server);
+	}
+};
+
+TEST_CASE("[PhysicsServer3D] Batched ray queries match single ray queries") {
+	StaticScene scene;
+	PhysicsDirectSpaceState3D *state = scene.server->space_get_direct_state(scene.space);
+	REQUIRE(state != nullptr);
+
+	// Below and above the amount of queries run on the work pool.
+	const int counts[2] = { 16, 512 };
+	for (int i = 0; i < 2; i++) {
+		const int count = counts[i];
+
+		Ref<RandomNumberGenerator> rng;
+		rng.instance();
+		rng->set_seed(count);
+		LocalVector<Vector3> from;
+		LocalVector<Vector3> to;
+		for (int j = 0; j < count; j++) {
+			from.push_back(Vector3(rng->randf_range(-45, 45), rng->randf_range(1, 10), rng->randf_range(-45, 45)));
+			to.push_back(from[j] + Vector3(rng->randf_range(-20, 20), rng->randf_range(-15, 2), rng->randf_range(-20, 20)));
+		}
+
+		// The exclusion list must be sorted.
+		RID exclude[2] = { scene.bodies[1], scene.bodies[2] };
+		if (exclude[1] < exclude[0]) {
+			SWAP(exclude[0], exclude[1]);
+		}
+		Set<RID> exclude_set;
+		exclude_set.insert(exclude[0]);
+		exclude_set.insert(exclude[1]);
+
+		LocalVector<PhysicsDirectSpaceState3D::RayResult> results;
+		results.resize(count);
+		LocalVector<bool> hits;
+		hits.resize(count);
+		int hit_count = state->intersect_rays(from.ptr(), to.ptr(), count, results.ptr(), hits.ptr(), exclude, 2);
+
+		int expected_hit_count = 0;
+		for (int j = 0; j < count; j++) {
+			PhysicsDirectSpaceState3D::RayResult expected;
+			bool expected_hit = state->intersect_ray(from[j], to[j], expected, exclude_set);
+			expected_hit_count += expected_hit;
+
+			REQUIRE(hits[j] == expected_hit);
+			if (expected_hit) {
+				CHECK(results[j].rid == expected.rid);
+				CHECK(results[j].shape == expected.shape);
+				CHECK(results[j].position == expected.position);
+				CHECK(results[j].normal == expected.normal);
+			}
+		}
+		CHECK(hit_count == expected_hit_count);
+		CHECK_MESSAGE(hit_count > 0, "Some rays should hit the scene.");
+		CHECK_MESSAGE(hit_count < count, "Some rays should miss the scene.");
+	}
+}
+
+TEST_CASE("[PhysicsServer3D] Batched shape queries match single shape queries") {
+	StaticScene scene;
+	PhysicsDirectSpaceState3D *state = scene.server->space_get_direct_state(scene.space);
+	REQUIRE(state != nullptr);
+
+	const int result_max = 8;
+	const int counts[2] = { 16, 512 };
+	for (int i = 0; i < 2; i++) {
+		const int count = counts[i];
+
+		Ref<RandomNumberGenerator> rng;
+		rng.instance();
+		rng->set_seed(count);
+		LocalVector<Transform> xforms;
+		for (int j = 0; j < count; j++) {
+			xforms.push_back(Transform(Basis(), Vector3(rng->randf_range(-45, 45), rng->randf_range(-0.5, 7), rng->randf_range(-45, 45))));
+		}
+
+		RID exclude = scene.bodies[3];
+		Set<RID> exclude_set;
+		exclude_set.insert(exclude);
+
+		LocalVector<PhysicsDirectSpaceState3D::ShapeResult> results;
+		results.resize(count * result_max);
+		LocalVector<int> result_counts;
+		result_counts.resize(count);
+		int result_count = state->intersect_shapes(scene.sphere_shape, xforms.ptr(), count, 0.0, results.ptr(), result_max, result_counts.ptr(), &exclude, 1);
+
+		int expected_result_count = 0;
+		for (int j = 0; j < count; j++) {
+			PhysicsDirectSpaceState3D::ShapeResult expected[result_max];
+			int expected_count = state->intersect_shape(scene.sphere_shape, xforms[j], 0.0, expected, result_max, exclude_set);
+			expected_result_count += expected_count;
+
+			REQUIRE(result_counts[j] == expected_count);
+			for (int k = 0; k < expected_count; k++) {
+				CHECK(results[j * result_max + k].rid == expected[k].rid);
+				CHECK(results[j * result_max + k].shape == expected[k].shape);
+			}
+		}
+		CHECK(result_count == expected_result_count);
+		CHECK_MESSAGE(result_count > 0, "Some shapes should overlap the scene.");
+	}
+}
+
+class BodyStatesReceiver : public Object {
+public:
+	int calls = 0;
+
+	void states_moved() {
+		calls++;
+	}
+};
+
+TEST_CASE("[PhysicsServer3D] Moved body states") {
+	StaticScene scene;
+	BodyStatesReceiver *receiver = memnew(BodyStatesReceiver);
+	scene.server->space_set_body_states_callback(scene.space, callable_mp(receiver, &BodyStatesReceiver::states_moved));
+
+	// Nothing moves in a static scene, so there is nothing to report.
+	const real_t delta = 1.0 / 60.0;
+	scene.server->step(delta);
+	scene.server->flush_queries();
+	PhysicsServer3D::BodyStates states;
+	CHECK(scene.server->space_get_moved_body_states(scene.space, states) == 0);
+	CHECK(receiver->calls == 0);
+
+	// A falling body is reported once per step.
+	RID body = scene.server->body_create();
+	scene.server->body_add_shape(body, scene.sphere_shape);
+	scene.server->body_set_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM, Transform(Basis(), Vector3(0, 20, 0)));
+	scene.server->body_set_space(body, scene.space);
+	scene.bodies.push_back(body);
+
+	for (int step = 1; step <= 3; step++) {
+		scene.server->step(delta);
+		scene.server->flush_queries();
+		CHECK(receiver->calls == step);
+
+		REQUIRE(scene.server->space_get_moved_body_states(scene.space, states) == 1);
+		CHECK(states.bodies[0] == body);
+		CHECK(states.transforms.size() == 12);
+		Transform xform = scene.server->body_get_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM);
+		CHECK(Vector3(states.transforms[3], states.transforms[7], states.transforms[11]).is_equal_approx(xform.origin));
+		CHECK(xform.origin.y < 20);
+		CHECK(states.linear_velocities[0].y < 0);
+		CHECK(states.sleeping[0] == 0);
+	}
+
+	memdelete(receiver);
+}
+
+static void check_motion_results_equal(const PhysicsServer3D::MotionResult &p_a, const PhysicsServer3D::MotionResult &p_b) {
+	CHECK(p_a.motion.is_equal_approx(p_b.motion));
+	CHECK(p_a.remainder.is_equal_approx(p_b.remainder));
+	CHECK(p_a.collision_point.is_equal_approx(p_b.collision_point));
+	CHECK(p_a.collision_normal.is_equal_approx(p_b.collision_normal));
+	CHECK(p_a.collider == p_b.collider);
+	CHECK(p_a.collider_shape == p_b.collider_shape);
+	CHECK(p_a.collision_local_shape == p_b.collision_local_shape);
+}
+
+TEST_CASE("[PhysicsServer3D] Batched body motions match single body motions") {
+	StaticScene scene;
+
+	Ref<RandomNumberGenerator> rng;
+	rng.instance();
+	rng->set_seed(1);
+
+	// Kinematic boxes moving around the scene, some of them into each other.
+	const int count = 64;
+	LocalVector<RID> bodies;
+	LocalVector<Transform> from;
+	LocalVector<Vector3> motions;
+	for (int i = 0; i < count; i++) {
+		Transform xform(Basis(), Vector3(rng->randf_range(-40, 40), rng->randf_range(1.5, 8), rng->randf_range(-40, 40)));
+		RID body = scene.server->body_create();
+		scene.server->body_set_mode(body, PhysicsServer3D::BODY_MODE_KINEMATIC);
+		scene.server->body_add_shape(body, scene.box_shape);
+		scene.server->body_set_state(body, PhysicsServer3D::BODY_STATE_TRANSFORM, xform);
+		scene.server->body_set_space(body, scene.space);
+		scene.bodies.push_back(body);
+
+		bodies.push_back(body);
+		from.push_back(xform);
+		motions.push_back(Vector3(rng->randf_range(-8, 8), rng->randf_range(-6, 2), rng->randf_range(-8, 8)));
+	}
+
+	// Below and above the amount of motions tested on the work pool.
+	const int batch_sizes[2] = { 8, count };
+	for (int i = 0; i < 2; i++) {
+		const int batch_size = batch_sizes[i];
+
+		LocalVector<PhysicsServer3D::MotionResult> results;
+		results.resize(batch_size);
+		LocalVector<bool> collided;
+		collided.resize(batch_size);
+		int collided_count = scene.server->body_test_motions(bodies.ptr(), from.ptr(), motions.ptr(), batch_size, false, results.ptr(), collided.ptr());
+
+		int expected_collided_count = 0;
+		for (int j = 0; j < batch_size; j++) {
+			PhysicsServer3D::MotionResult expected;
+			bool expected_collided = scene.server->body_test_motion(bodies[j], from[j], motions[j], false, &expected);
+			expected_collided_count += expected_collided;
+
+			REQUIRE(collided[j] == expected_collided);
+			check_motion_results_equal(results[j], expected);
+		}
+		CHECK(collided_count == expected_collided_count);
+		CHECK_MESSAGE((batch_size < count || collided_count > 0), "Some motions should collide.");
+
+		// Running the same batch again gives the same results, whatever thread tested each motion.
+		LocalVector<PhysicsServer3D::MotionResult> repeated_results;
+		repeated_results.resize(batch_size);
+		LocalVector<bool> repeated_collided;
+		repeated_collided.resize(batch_size);
+		CHECK(scene.server->body_test_motions(bodies.ptr(), from.ptr(), motions.ptr(), batch_size, false, repeated_results.ptr(), repeated_collided.ptr()) == collided_count);
+		for (int j = 0; j < batch_size; j++) {
+			CHECK(repeated_collided[j] == collided[j]);
+			CHECK(repeated_results[j].motion == results[j].motion);
+			CHECK(repeated_results[j].remainder == results[j].remainder);
+			CHECK(repeated_results[j].collision_point == results[j].collision_point);
+			CHECK(repeated_results[j].collision_normal == results[j].collision_normal);
+			CHECK(repeated_results[j].collider == results[j].collider);
+		}
+	}
+}
+
+// A bumpy p_size * p_size heightmap, also used by the heightmap benchmark.
+static void make_heightmap(HeightMapShape3DSW &r_shape, int p_size, int p_seed) {
+	Vector<float> heights;
+	heights.resize(p_size * p_size);
+	float *w = heights.ptrw();
+	float min_height = 1e20;
+	float max_height = -1e20;
+	for (int z = 0; z < p_size; z++) {
+		for (int x = 0; x < p_size; x++) {
+			float h = 20.0 * Math::sin((x + p_seed) * 0.013) * Math::cos(z * 0.017) + 4.0 * Math::sin(x * 0.21 + z * 0.13) + (Math::rand() % 100) * 0.01;
+			w[z * p_size + x] = h;
+			min_height = MIN(min_height, h);
+			max_height = MAX(max_height, h);
+		}
+	}
+
+	Dictionary d;
+	d["width"] = p_size;
+	d["depth"] = p_size;
+	d["heights"] = heights;
+	d["min_height"] = min_height;
+	d["max_height"] = max_height;
+	r_shape.set_data(d);
+}
+
+static bool intersect_heightmap_brute_force(const HeightMapShape3DSW &p_shape, const Vector3 &p_begin, const Vector3 &p_end, Vector3 &r_point) {
+	FaceShape3DSW face;
+	face.backface_collision = false;
+	bool found = false;
+	real_t closest = 1e20;
+
+	for (int z = 0; z < p_shape.get_depth() - 1; z++) {
+		for (int x = 0; x < p_shape.get_width() - 1; x++) {
+			const Vector2i triangles[2][3] = { { Vector2i(x, z), Vector2i(x + 1, z), Vector2i(x, z + 1) }, { Vector2i(x + 1, z), Vector2i(x + 1, z + 1), Vector2i(x, z + 1) } };
+			for (int i = 0; i < 2; i++) {
+				for (int j = 0; j < 3; j++) {
+					p_shape._get_point(triangles[i][j].x, triangles[i][j].y, face.vertex[j]);
+				}
+				face.normal = Plane(face.vertex[0], face.vertex[1], face.vertex[2]).normal;
+				Vector3 point, normal;
+				if (face.intersect_segment(p_begin, p_end, point, normal) && p_begin.distance_to(point) < closest) {
+					closest = p_begin.distance_to(point);
+					r_point = point;
+					found = true;
+				}
+			}
+		}
+	}
+
+	return found;
+}
+
+// Casts random rays through a map of 65x65 heights, returns how many differ from a brute force search.
+static int count_heightmap_ray_mismatches(HeightMapShape3DSW &p_shape, int p_rays) {
+	int mismatches = 0;
+	for (int i = 0; i < p_rays; i++) {
+		Vector3 begin(Math::random(-32.0, 32.0), Math::random(-5.0, 40.0), Math::random(-32.0, 32.0));
+		Vector3 end(Math::random(-40.0, 40.0), Math::random(-40.0, 30.0), Math::random(-40.0, 40.0));
+		Vector3 point, normal, expected;
+		bool hit = p_shape.intersect_segment(begin, end, point, normal);
+		bool expected_hit = intersect_heightmap_brute_force(p_shape, begin, end, expected);
+		if (hit != expected_hit || (hit && !point.is_equal_approx(expected))) {
+			mismatches++;
+		}
+	}
+	return mismatches;
+}
+
+TEST_CASE("[PhysicsServer3D] Heightmap ray casts match a brute force search") {
+	Math::seed(7);
+	HeightMapShape3DSW shape;
+	make_heightmap(shape, 65, 0);
+	CHECK_MESSAGE(count_heightmap_ray_mismatches(shape, 200) == 0, "Ray casts should hit the same points as a brute force search.");
+
+	// A crater below the lowest point, so the height ranges must be rebuilt.
+	Dictionary d = shape.get_data();
+	Vector<float> heights = d["heights"];
+	float *w = heights.ptrw();
+	float min_height = d["min_height"];
+	for (int z = 20; z < 36; z++) {
+		for (int x = 10; x < 26; x++) {
+			w[z * 65 + x] -= 30.0;
+			min_height = MIN(min_height, w[z * 65 + x]);
+		}
+	}
+	d["heights"] = heights;
+	d["min_height"] = min_height;
+	shape.set_data(d);
+	CHECK_MESSAGE(count_heightmap_ray_mismatches(shape, 200) == 0, "Ray casts should hit the same points as a brute force search after editing the heights.");
+}
+
+static real_t concave_height(int p_x, int p_z) {
+	return 20.0 * Math::sin(p_x * 0.013) * Math::cos(p_z * 0.017) + 4.0 * Math::sin(p_x * 0.21 + p_z * 0.13);
+}
+
+// A bumpy grid centered on the origin, two triangles per cell, also used by the concave BVH benchmark.
+static Vector<Vector3> make_concave_faces(int p_size) {
+	Vector<Vector3> faces;
+	faces.resize(p_size * p_size * 6);
+	Vector3 *w = faces.ptrw();
+	const real_t half_size = p_size * 0.5;
+	for (int z = 0; z < p_size; z++) {
+		for (int x = 0; x < p_size; x++) {
+			Vector3 corners[4];
+			for (int i = 0; i < 4; i++) {
+				int cx = x + (i & 1);
+				int cz = z + (i >> 1);
+				corners[i] = Vector3(cx - half_size, concave_height(cx, cz), cz - half_size);
+			}
+			Vector3 *cell = &w[(z * p_size + x) * 6];
+			cell[0] = corners[0];
+			cell[1] = corners[1];
+			cell[2] = corners[2];
+			cell[3] = corners[1];
+			cell[4] = corners[3];
+			cell[5] = corners[2];
+		}
+	}
+	return faces;
+}
+
+static bool intersect_faces_brute_force(const Vector<Vector3> &p_faces, const Vector3 &p_begin, const Vector3 &p_end, bool p_backface_collision, Vector3 &r_point) {
+	FaceShape3DSW face;
+	face.backface_collision = p_backface_collision;
+	bool found = false;
+	real_t closest = 1e20;
+
+	for (int i = 0; i < p_faces.size(); i += 3) {
+		for (int j = 0; j < 3; j++) {
+			face.vertex[j] = p_faces[i + j];
+		}
+		face.normal = Plane(face.vertex[0], face.vertex[1], face.vertex[2]).normal;
+		Vector3 point, normal;
+		if (face.intersect_segment(p_begin, p_end, point, normal) && p_begin.distance_to(point) < closest) {
+			closest = p_begin.distance_to(point);
+			r_point = point;
+			found = true;
+		}
+	}
+
+	return found;
+}
+
+static int cull_faces_brute_force(const Vector<Vector3> &p_faces, const AABB &p_aabb) {
+	int count = 0;
+	for (int i = 0; i < p_faces.size(); i += 3) {
+		if (Face3(p_faces[i], p_faces[i + 1], p_faces[i + 2]).get_aabb().intersects(p_aabb)) {
+			count++;
+		}
+	}
+	return count;
+}
+
+static void count_concave_cull(void *p_userdata, Shape3DSW *p_convex) {
+	(*(int *)p_userdata)++;
+}
+
+static AABB random_concave_aabb(real_t p_half_size) {
+	Vector3 position(Math::random(-(double)p_half_size, (double)p_half_size), Math::random(-25.0, 20.0), Math::random(-(double)p_half_size, (double)p_half_size));
+	return AABB(position, Vector3(Math::random(0.5, 4.0), Math::random(0.5, 4.0), Math::random(0.5, 4.0)));
+}
+
+TEST_CASE("[PhysicsServer3D] Concave shape and triangle mesh queries match a brute force search") {
+	Math::seed(7);
+	const int size = 32;
+	Vector<Vector3> faces = make_concave_faces(size);
+	ConcavePolygonShape3DSW shape;
+	Dictionary d;
+	d["faces"] = faces;
+	d["backface_collision"] = false;
+	shape.set_data(d);
+	Ref<TriangleMesh> triangle_mesh;
+	triangle_mesh.instance();
+	triangle_mesh->create(faces);
+
+	int shape_mismatches = 0;
+	int mesh_mismatches = 0;
+	for (int i = 0; i < 200; i++) {
+		Vector3 begin(Math::random(-16.0, 16.0), Math::random(-5.0, 40.0), Math::random(-16.0, 16.0));
+		Vector3 end(Math::random(-20.0, 20.0), Math::random(-40.0, 30.0), Math::random(-20.0, 20.0));
+		Vector3 point, normal, expected;
+		bool expected_hit = intersect_faces_brute_force(faces, begin, end, false, expected);
+		bool hit = shape.intersect_segment(begin, end, point, normal);
+		if (hit != expected_hit || (hit && !point.is_equal_approx(expected))) {
+			shape_mismatches++;
+		}
+		// TriangleMesh reports back faces too, and snaps its vertices.
+		expected_hit = intersect_faces_brute_force(faces, begin, end, true, expected);
+		hit = triangle_mesh->intersect_segment(begin, end, point, normal);
+		if (hit != expected_hit || (hit && point.distance_to(expected) > 0.01)) {
+			mesh_mismatches++;
+		}
+	}
+	CHECK_MESSAGE(shape_mismatches == 0, "ConcavePolygonShape3D ray casts should hit the same points as a brute force search.");
+	CHECK_MESSAGE(mesh_mismatches == 0, "TriangleMesh ray casts should hit the same points as a brute force search.");
+
+	int cull_mismatches = 0;
+	for (int i = 0; i < 200; i++) {
+		AABB aabb = random_concave_aabb(size * 0.5);
+		int count = 0;
+		shape.cull(aabb, count_concave_cull, &count);
+		if (count != cull_faces_brute_force(faces, aabb)) {
+			cull_mismatches++;
+		}
+	}
+	CHECK_MESSAGE(cull_mismatches == 0, "ConcavePolygonShape3D should cull the same faces as a brute force search.");
+}
+
+// A square cloth of p_size * p_size nodes, also used by the soft body benchmark.
+static void make_soft_body_grid(SoftBody3DSW &r_soft_body, int p_size) {
+	Vector<Vector3> vertices;
+	vertices.resize(p_size * p_size);
+	Vector3 *wv = vertices.ptrw();
+	for (int z = 0; z < p_size; z++) {
+		for (int x = 0; x < p_size; x++) {
+			wv[z * p_size + x] = Vector3(x * 0.1, 0.0, z * 0.1);
+		}
+	}
+
+	Vector<int> indices;
+	indices.resize((p_size - 1) * (p_size - 1) * 6);
+	int *wi = indices.ptrw();
+	for (int z = 0; z < p_size - 1; z++) {
+		for (int x = 0; x < p_size - 1; x++) {
+			const int i = z * p_size + x;
+			const int quad[6] = { i, i + 1, i + p_size, i + 1, i + p_size + 1, i + p_size };
+			for (int j = 0; j < 6; j++) {
+				*wi++ = quad[j];
+			}
+		}
+	}
+
+	r_soft_body.create_from_trimesh(indices, vertices);
+}
+
+static void perturb_soft_body(SoftBody3DSW &r_soft_body) {
+	const int node_count = r_soft_body.get_node_count();
+	for (int i = 0; i < node_count; i++) {
+		r_soft_body.apply_node_impulse(i, Vector3(Math::sin(i * 0.37), Math::cos(i * 0.11), Math::sin(i * 0.05)) * 0.01);
+	}
+}
+
+TEST_CASE("[PhysicsServer3D] Soft body links solve the same on a work pool") {
+	// Needed for the shape updates of the soft bodies.
+	PhysicsServer3DSW *physics_server = memnew(PhysicsServer3DSW(false));
+
+	ThreadWorkPool work_pool;
+	work_pool.init();
+
+	// Same sizes as the soft body benchmark, the larger grids have enough links per batch to solve them on the pool.
+	const int sizes[3] = { 32, 100, 224 };
+	const real_t delta = 1.0 / 60.0;
+	for (int i = 0; i < 3; i++) {
+		SoftBody3DSW *serial_body = memnew(SoftBody3DSW);
+		SoftBody3DSW *parallel_body = memnew(SoftBody3DSW);
+		make_soft_body_grid(*serial_body, sizes[i]);
+		make_soft_body_grid(*parallel_body, sizes[i]);
+		REQUIRE(serial_body->get_node_count() == parallel_body->get_node_count());
+
+		perturb_soft_body(*serial_body);
+		perturb_soft_body(*parallel_body);
+		for (int step = 0; step < 10; step++) {
+			serial_body->solve_constraints(delta);
+			parallel_body->solve_constraints(delta, &work_pool);
+		}
+
+		int mismatches = 0;
+		for (uint32_t node_index = 0; node_index < serial_body->get_node_count(); node_index++) {
+			if (serial_body->get_node_position(node_index) != parallel_body->get_node_position(node_index)) {
+				mismatches++;
+			}
+		}
+		REQUIRE_MESSAGE(mismatches == 0, "Solving the links on the work pool should give the same node positions.");
+
+		memdelete(serial_body);
+		memdelete(parallel_body);
+	}
+
+	work_pool.finish();
+	memdelete(physics_server);
+}
+
+} // namespace TestPhysicsServer3D
+
+#endif // TEST_PHYSICS_SERVER_3D_H
@@ -0,0 +1,184 @@
+/*************************************************************************/
+/*  test_scene_tree_environment.h                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_SCENE_TREE_ENVIRONMENT_H
+#define TEST_SCENE_TREE_ENVIRONMENT_H
+
+#include "core/object/message_queue.h"
+#include "scene/main/scene_tree.h"
+#include "scene/main/window.h"
+#include "servers/display_server.h"
+#include "servers/navigation_server_2d.h"
+#include "servers/navigation_server_3d.h"
+#include "servers/physics_2d/physics_server_2d_sw.h"
+#include "servers/physics_3d/physics_server_3d_sw.h"
+
+#include "tests/test_dummy_rendering_server.h"
+
+// A display server with a single window that is never shown, for the root window.
+class DummyDisplayServer : public DisplayServer {
+	ObjectID window_instance_id;
+	Size2i window_size = Size2i(1024, 600);
+
+public:
+	virtual bool has_feature(Feature p_feature) const override { return false; }
+	virtual String get_name() const override { return "Dummy"; }
+
+	virtual void alert(const String &p_alert, const String &p_title = "ALERT!") override {}
+
+	virtual int get_screen_count() const override { return 1; }
+	virtual Point2i screen_get_position(int p_screen = SCREEN_OF_MAIN_WINDOW) const override { return Point2i(); }
+	virtual Size2i screen_get_size(int p_screen = SCREEN_OF_MAIN_WINDOW) const override { return window_size; }
+	virtual Rect2i screen_get_usable_rect(int p_screen = SCREEN_OF_MAIN_WINDOW) const override { return Rect2i(Point2i(), window_size); }
+	virtual int screen_get_dpi(int p_screen = SCREEN_OF_MAIN_WINDOW) const override { return 96; }
+
+	virtual Vector<DisplayServer::WindowID> get_window_list() const override {
+		Vector<DisplayServer::WindowID> windows;
+		windows.push_back(MAIN_WINDOW_ID);
+		return windows;
+	}
+	virtual WindowID get_window_at_screen_position(const Point2i &p_position) const override { return MAIN_WINDOW_ID; }
+
+	virtual void window_attach_instance_id(ObjectID p_instance, WindowID p_window = MAIN_WINDOW_ID) override { window_instance_id = p_instance; }
+	virtual ObjectID window_get_attached_instance_id(WindowID p_window = MAIN_WINDOW_ID) const override { return window_instance_id; }
+
+	virtual void window_set_rect_changed_callback(const Callable &p_callable, WindowID p_window = MAIN_WINDOW_ID) override {}
+	virtual void window_set_window_event_callback(const Callable &p_callable, WindowID p_window = MAIN_WINDOW_ID) override {}
+	virtual void window_set_input_event_callback(const Callable &p_callable, WindowID p_window = MAIN_WINDOW_ID) override {}
+	virtual void window_set_input_text_callback(const Callable &p_callable, WindowID p_window = MAIN_WINDOW_ID) override {}
+	virtual void window_set_drop_files_callback(const Callable &p_callable, WindowID p_window = MAIN_WINDOW_ID) override {}
+
+	virtual void window_set_title(const String &p_title, WindowID p_window = MAIN_WINDOW_ID) override {}
+
+	virtual int window_get_current_screen(WindowID p_window = MAIN_WINDOW_ID) const override { return 0; }
+	virtual void window_set_current_screen(int p_screen, WindowID p_window = MAIN_WINDOW_ID) override {}
+
+	virtual Point2i window_get_position(WindowID p_window = MAIN_WINDOW_ID) const override { return Point2i(); }
+	virtual void window_set_position(const Point2i &p_position, WindowID p_window = MAIN_WINDOW_ID) override {}
+
+	virtual void window_set_transient(WindowID p_window, WindowID p_parent) override {}
+
+	virtual void window_set_max_size(const Size2i p_size, WindowID p_window = MAIN_WINDOW_ID) override {}
+	virtual Size2i window_get_max_size(WindowID p_window = MAIN_WINDOW_ID) const override { return Size2i(); }
+	virtual void window_set_min_size(const Size2i p_size, WindowID p_window = MAIN_WINDOW_ID) override {}
+	virtual Size2i window_get_min_size(WindowID p_window = MAIN_WINDOW_ID) const override { return Size2i(); }
+
+	virtual void window_set_size(const Size2i p_size, WindowID p_window = MAIN_WINDOW_ID) override { window_size = p_size; }
+	virtual Size2i window_get_size(WindowID p_window = MAIN_WINDOW_ID) const override { return window_size; }
+	virtual Size2i window_get_real_size(WindowID p_window = MAIN_WINDOW_ID) const override { return window_size; }
+
+	virtual void window_set_mode(WindowMode p_mode, WindowID p_window = MAIN_WINDOW_ID) override {}
+	virtual WindowMode window_get_mode(WindowID p_window = MAIN_WINDOW_ID) const override { return WINDOW_MODE_WINDOWED; }
+	virtual bool window_is_maximize_allowed(WindowID p_window = MAIN_WINDOW_ID) const override { return false; }
+
+	virtual void window_set_flag(WindowFlags p_flag, bool p_enabled, WindowID p_window = MAIN_WINDOW_ID) override {}
+	virtual bool window_get_flag(WindowFlags p_flag, WindowID p_window = MAIN_WINDOW_ID) const override { return false; }
+
+	virtual void window_request_attention(WindowID p_window = MAIN_WINDOW_ID) override {}
+	virtual void window_move_to_foreground(WindowID p_window = MAIN_WINDOW_ID) override {}
+
+	virtual bool window_can_draw(WindowID p_window = MAIN_WINDOW_ID) const override { return false; }
+	virtual bool can_any_window_draw() const override { return false; }
+
+	virtual void process_events() override {}
+};
+
+// Everything a SceneTree needs to be created and run frames under --test: the
+// dummy rendering and display servers, the physics and navigation servers, and a
+// MessageQueue. Servers that already exist are kept. The tree is initialized, so
+// nodes added to its root enter it. Frames are run by calling process() and
+// physics_process() on the tree.
+struct SceneTreeEnvironment {
+	DummyRenderingServer rendering_server;
+	DisplayServer *display_server = nullptr;
+	PhysicsServer3D *physics_server_3d = nullptr;
+	PhysicsServer2D *physics_server_2d = nullptr;
+	NavigationServer3D *navigation_server_3d = nullptr;
+	NavigationServer2D *navigation_server_2d = nullptr;
+	MessageQueue *message_queue = nullptr;
+	SceneTree *tree = nullptr;
+
+	SceneTreeEnvironment() {
+		if (!MessageQueue::get_singleton()) {
+			message_queue = memnew(MessageQueue);
+		}
+		if (!DisplayServer::get_singleton()) {
+			display_server = memnew(DummyDisplayServer);
+		}
+		if (!PhysicsServer3D::get_singleton()) {
+			physics_server_3d = memnew(PhysicsServer3DSW(false));
+			physics_server_3d->init();
+		}
+		if (!PhysicsServer2D::get_singleton()) {
+			physics_server_2d = memnew(PhysicsServer2DSW(false));
+			physics_server_2d->init();
+		}
+		if (!NavigationServer3D::get_singleton()) {
+			navigation_server_3d = NavigationServer3DManager::new_default_server();
+		}
+		if (!NavigationServer2D::get_singleton()) {
+			navigation_server_2d = memnew(NavigationServer2D);
+		}
+
+		tree = memnew(SceneTree);
+		// Picking reads the mouse from Input, which the test setup doesn't have.
+		tree->get_root()->set_physics_object_picking(false);
+		tree->initialize();
+	}
+
+	~SceneTreeEnvironment() {
+		tree->finalize();
+		memdelete(tree);
+
+		if (message_queue) {
+			message_queue->flush();
+			memdelete(message_queue);
+		}
+		if (navigation_server_2d) {
+			memdelete(navigation_server_2d);
+		}
+		if (navigation_server_3d) {
+			memdelete(navigation_server_3d);
+		}
+		if (physics_server_2d) {
+			physics_server_2d->finish();
+			memdelete(physics_server_2d);
+		}
+		if (physics_server_3d) {
+			physics_server_3d->finish();
+			memdelete(physics_server_3d);
+		}
+		if (display_server) {
+			memdelete(display_server);
+		}
+	}
+};
+
+#endif // TEST_SCENE_TREE_ENVIRONMENT_H
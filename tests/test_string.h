@@ -184,6 +184,79 @@ TEST_CASE("[String] Invalid UTF16") {
 	ERR_PRINT_ON
 }
 
+TEST_CASE("[String] UTF8 and UTF16 of long strings") {
+	// Long enough to go through the 16 character fast paths, with multi-byte
+	// characters landing at every offset within a block.
+	static const char32_t pieces[] = { 'a', 0xE9, 0x304A, 0x1F3A4 };
+	for (int p = 0; p < 4; p++) {
+		for (int offset = 0; offset < 20; offset++) {
+			Vector<char32_t> chars;
+			for (int i = 0; i < 50; i++) {
+				chars.push_back(i == offset || i == offset + 17 ? pieces[p] : char32_t('A' + i % 26));
+			}
+			chars.push_back(0);
+			const String s = chars.ptr();
+
+			String t;
+			CHECK(!t.parse_utf8(s.utf8().get_data()));
+			CHECK(t == s);
+			CHECK(!t.parse_utf16(s.utf16().get_data()));
+			CHECK(t == s);
+		}
+	}
+
+	// Byte swapped UTF-16 with a BOM.
+	Char16String swapped;
+	swapped.resize(42);
+	swapped[0] = 0xFFFE;
+	for (int i = 1; i < 41; i++) {
+		swapped[i] = BSWAP16(char16_t(i % 3 ? 'a' + i : 0x3046));
+	}
+	swapped[41] = 0;
+	String t;
+	CHECK(!t.parse_utf16(swapped.get_data()));
+	CHECK(t.length() == 40);
+	CHECK(t[2] == 0x3046);
+	CHECK(t[3] == 'a' + 4);
+
+	// Parsing stops at a NUL, even within the given length.
+	static const char text[] = "0123456789abcdefghij\0klmnopqrstuvwxyz";
+	CHECK(!t.parse_utf8(text, sizeof(text)));
+	CHECK(t == "0123456789abcdefghij");
+}
+
+TEST_CASE("[String] Invalid UTF8 and UTF16 in long strings") {
+	ERR_PRINT_OFF
+	CharString cs = String("0123456789abcdef0123456789abcdef").utf8();
+	cs[20] = 0xE3; // Lead byte followed by ASCII.
+	String s = "unchanged";
+	CHECK(s.parse_utf8(cs.get_data()));
+	// Like the two-pass decoder before the fast path, the string is sized from the
+	// lead bytes and keeps the characters decoded before the error.
+	CHECK(s.length() == 30);
+	CHECK(s.substr(0, 20) == "0123456789abcdef0123");
+
+	s = "unchanged";
+	cs[20] = 0xC0; // Overlong.
+	CHECK(s.parse_utf8(cs.get_data()));
+	CHECK(s == "unchanged");
+
+	Char16String cs16 = String("0123456789abcdef0123456789abcdef").utf16();
+	cs16[20] = 0xDFA4; // Unpaired trail surrogate.
+	CHECK(s.parse_utf16(cs16.get_data()));
+	CHECK(s == "unchanged");
+
+	Vector<char32_t> chars;
+	for (int i = 0; i < 40; i++) {
+		chars.push_back(i == 30 ? 0xD812 : 'a');
+	}
+	chars.push_back(0);
+	s = chars.ptr();
+	CHECK(s.utf8().length() == 0);
+	CHECK(s.utf16().length() == 0);
+	ERR_PRINT_ON
+}
+
 TEST_CASE("[String] ASCII") {
 	String s = U"Primero Leche";
 	String t = s.ascii(false).get_data();
@@ -1343,6 +1416,56 @@ TEST_CASE("[String] validate_node_name") {
 	String name_with_invalid_chars = "Name with invalid characters :.@removed!";
 	CHECK(name_with_invalid_chars.validate_node_name() == "Name with invalid characters removed!");
 }
+
+// UTF-8 and UTF-16 encoding and decoding of 1 MB texts, in MB/s of UTF-8.
+static void bench_string_utf() {
+	const char *names[] = { "ASCII", "Latin", "CJK" };
+	const String samples[] = {
+		"The quick brown fox jumps over the lazy dog. ",
+		String::utf8("Le cœur déçu mais l'âme plutôt naïve, Louÿs rêva. "),
+		String::utf8("日本語のテキストと中文文本，한국어 텍스트。"),
+	};
+	const int rounds = 20;
+
+	for (int t = 0; t < 3; t++) {
+		String text;
+		while (text.length() < 1 << 20) {
+			text += samples[t];
+		}
+		const CharString utf8 = text.utf8();
+		const Char16String utf16 = text.utf16();
+		const uint64_t bytes = (uint64_t)utf8.length() * rounds;
+
+		String s;
+		uint64_t begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < rounds; i++) {
+			s.parse_utf8(utf8.get_data(), utf8.length());
+		}
+		uint64_t parse_utf8_usec = bench_usec(begin);
+
+		begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < rounds; i++) {
+			CharString cs = text.utf8();
+		}
+		uint64_t utf8_usec = bench_usec(begin);
+
+		begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < rounds; i++) {
+			s.parse_utf16(utf16.get_data(), utf16.length());
+		}
+		uint64_t parse_utf16_usec = bench_usec(begin);
+
+		begin = OS::get_singleton()->get_ticks_usec();
+		for (int i = 0; i < rounds; i++) {
+			Char16String cs = text.utf16();
+		}
+		uint64_t utf16_usec = bench_usec(begin);
+
+		print_line(vformat("%s: parse_utf8 %d MB/s, utf8 %d MB/s, parse_utf16 %d MB/s, utf16 %d MB/s.", names[t], (int64_t)(bytes / parse_utf8_usec), (int64_t)(bytes / utf8_usec), (int64_t)(bytes / parse_utf16_usec), (int64_t)(bytes / utf16_usec)));
+	}
+}
+
+REGISTER_TEST_COMMAND("string-utf-bench", &bench_string_utf);
 } // namespace TestString
 
 #endif // TEST_STRING_H
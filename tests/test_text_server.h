@@ -33,6 +33,7 @@
 #ifndef TEST_TEXT_SERVER_H
 #define TEST_TEXT_SERVER_H
 
+#include "core/os/os.h"
 #include "editor/builtin_fonts.gen.h"
 #include "servers/text_server.h"
 #include "tests/test_macros.h"
@@ -243,9 +244,165 @@ TEST_SUITE("[[TextServer]") {
 			}
 		}
 
+		SUBCASE("[TextServer] Text layout: Shaping cache") {
+			for (int i = 0; i < TextServerManager::get_interface_count(); i++) {
+				TextServer *ts = TextServerManager::initialize(i, err);
+
+				Vector<RID> font;
+				font.push_back(ts->create_font_memory(_font_NotoSansUI_Regular, _font_NotoSansUI_Regular_size, "ttf"));
+
+				String test = U"Identical rows share one shaping pass";
+
+				RID ctx_1 = ts->create_shaped_text();
+				RID ctx_2 = ts->create_shaped_text();
+				ts->shaped_text_add_string(ctx_1, test, font, 16);
+				ts->shaped_text_add_string(ctx_2, test, font, 16);
+
+				Vector<TextServer::Glyph> glyphs_1 = ts->shaped_text_get_glyphs(ctx_1);
+				Vector<TextServer::Glyph> glyphs_2 = ts->shaped_text_get_glyphs(ctx_2);
+				TEST_FAIL_COND(glyphs_1.size() == 0, "Shaping failed.");
+				TEST_FAIL_COND(glyphs_1 != glyphs_2, "Cached shaping result differs.");
+				TEST_FAIL_COND(ts->shaped_text_get_width(ctx_1) != ts->shaped_text_get_width(ctx_2), "Cached width differs.");
+
+				if (ts->shaped_text_cache_get_capacity() > 0) {
+					Dictionary stats = ts->shaped_text_cache_get_stats();
+					TEST_FAIL_COND((int)stats["hits"] < 1, "Identical text was shaped twice.");
+
+					// Different size must not hit the cached entry.
+					RID ctx_3 = ts->create_shaped_text();
+					ts->shaped_text_add_string(ctx_3, test, font, 20);
+					TEST_FAIL_COND(ts->shaped_text_get_width(ctx_3) <= ts->shaped_text_get_width(ctx_1), "Cached result reused for a different font size.");
+					ts->free(ctx_3);
+
+					// Line breaking of cached text still works.
+					Vector<Vector2i> lines = ts->shaped_text_get_line_breaks(ctx_2, 100);
+					TEST_FAIL_COND(lines.size() < 2, "Line breaking of cached text failed.");
+				}
+
+				ts->free(ctx_1);
+				ts->free(ctx_2);
+
+				for (int j = 0; j < font.size(); j++) {
+					ts->free(font[j]);
+				}
+				font.clear();
+			}
+		}
+
+		SUBCASE("[TextServer] Fonts: Distance field glyphs") {
+			for (int i = 0; i < TextServerManager::get_interface_count(); i++) {
+				TextServer *ts = TextServerManager::initialize(i, err);
+
+				RID font = ts->create_font_memory(_font_NotoSansUI_Regular, _font_NotoSansUI_Regular_size, "ttf");
+				uint32_t index = ts->font_get_glyph_index(font, 'A');
+				Vector2 advance = ts->font_get_glyph_advance(font, index, 32);
+
+				ts->font_set_distance_field_hint(font, true);
+				if (ts->font_get_distance_field_hint(font)) {
+					TEST_FAIL_COND(ts->font_draw_glyph(font, RID(), 32, Vector2(), index) != advance, "Distance field glyph advance differs.");
+					uint64_t mem = ts->font_get_glyph_cache_memory(font);
+					ts->font_draw_glyph(font, RID(), 64, Vector2(), index);
+					ts->font_draw_glyph(font, RID(), 12, Vector2(), index);
+					TEST_FAIL_COND(ts->font_get_glyph_cache_memory(font) != mem, "Distance field glyph rasterized per size.");
+				}
+				ts->free(font);
+			}
+		}
+
 		memdelete(tsman);
 	}
 }
+
+// Shapes many rows of text, most of them repeated, with each text server.
+void bench_shaping() {
+	TextServerManager *tsman = memnew(TextServerManager);
+	Error err = OK;
+
+	const int rows = 10000;
+	const int unique_rows = 100;
+
+	for (int i = 0; i < TextServerManager::get_interface_count(); i++) {
+		TextServer *ts = TextServerManager::initialize(i, err);
+		if (err != OK || ts == nullptr) {
+			continue;
+		}
+
+		Vector<RID> font;
+		font.push_back(ts->create_font_memory(_font_NotoSansUI_Regular, _font_NotoSansUI_Regular_size, "ttf"));
+
+		for (int pass = 0; pass < 2; pass++) {
+			int capacity = ts->shaped_text_cache_get_capacity();
+			if (pass == 0) {
+				ts->shaped_text_cache_set_capacity(0);
+			}
+			ts->shaped_text_cache_clear();
+
+			Vector<RID> bufs;
+			uint64_t t = OS::get_singleton()->get_ticks_usec();
+			for (int j = 0; j < rows; j++) {
+				RID ctx = ts->create_shaped_text();
+				ts->shaped_text_add_string(ctx, vformat("Tree item %d, column text", j % unique_rows), font, 16);
+				ts->shaped_text_shape(ctx);
+				bufs.push_back(ctx);
+			}
+			t = OS::get_singleton()->get_ticks_usec() - t;
+
+			Dictionary stats = ts->shaped_text_cache_get_stats();
+			print_line(vformat("%s, cache %s: %d rows shaped in %d usec.", TextServerManager::get_interface_name(i), (pass == 0) ? "off" : "on", rows, t));
+			print_line(vformat("    hits: %s, misses: %s.", stats.get("hits", 0), stats.get("misses", 0)));
+
+			for (int j = 0; j < bufs.size(); j++) {
+				ts->free(bufs[j]);
+			}
+			if (pass == 0) {
+				ts->shaped_text_cache_set_capacity(capacity);
+			}
+		}
+
+		for (int j = 0; j < font.size(); j++) {
+			ts->free(font[j]);
+		}
+	}
+
+	memdelete(tsman);
+}
+
+REGISTER_TEST_COMMAND("text-server-shaping-bench", &bench_shaping);
+
+// Compares per-size rasterized glyph caches with the distance field atlas when drawing at many sizes.
+void bench_glyph_cache() {
+	TextServerManager *tsman = memnew(TextServerManager);
+	Error err = OK;
+
+	const String text = U"The quick brown fox jumps over the lazy dog 0123456789";
+
+	for (int i = 0; i < TextServerManager::get_interface_count(); i++) {
+		TextServer *ts = TextServerManager::initialize(i, err);
+		if (err != OK || ts == nullptr) {
+			continue;
+		}
+
+		for (int pass = 0; pass < 2; pass++) {
+			RID font = ts->create_font_memory(_font_NotoSansUI_Regular, _font_NotoSansUI_Regular_size, "ttf");
+			ts->font_set_distance_field_hint(font, pass == 1);
+
+			uint64_t t = OS::get_singleton()->get_ticks_usec();
+			for (int size = 8; size <= 96; size += 2) {
+				for (int j = 0; j < text.length(); j++) {
+					ts->font_draw_glyph(font, RID(), size, Vector2(), ts->font_get_glyph_index(font, text[j]));
+				}
+			}
+			t = OS::get_singleton()->get_ticks_usec() - t;
+
+			print_line(vformat("%s, %s: 45 sizes rasterized in %d usec, %d KiB of glyph textures.", TextServerManager::get_interface_name(i), (pass == 0) ? "per-size cache" : "distance field atlas", t, ts->font_get_glyph_cache_memory(font) / 1024));
+			ts->free(font);
+		}
+	}
+
+	memdelete(tsman);
+}
+
+REGISTER_TEST_COMMAND("text-server-glyph-cache-bench", &bench_glyph_cache);
 }; // namespace TestTextServer
 
 #endif // TEST_TEXT_SERVER_H
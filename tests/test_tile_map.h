@@ -0,0 +1,349 @@
+/*************************************************************************/
+/*  test_tile_map.h                                                      */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+
+#ifndef TEST_TILE_MAP_H
+#define TEST_TILE_MAP_H
+
+#include "core/math/random_number_generator.h"
+#include "core/os/os.h"
+#include "scene/2d/tile_map.h"
+#include "scene/resources/texture.h"
+#include "scene/resources/tile_set.h"
+
+#include "tests/test_macros.h"
+#include "thirdparty/doctest/doctest.h"
+
+namespace TestTileMap {
+
+TEST_CASE("[TileMap] Cell storage") {
+	TileMapCellStorage storage;
+	CHECK(storage.size() == 0);
+	CHECK(storage.getptr(Vector2i()) == nullptr);
+
+	// Cells on both sides of the chunk boundaries, including negative coords.
+	const Vector2i coords[] = { Vector2i(0, 0), Vector2i(-1, -1), Vector2i(31, 0), Vector2i(32, 0), Vector2i(-33, 5), Vector2i(5, -32), Vector2i(1000, -1000) };
+	const int count = sizeof(coords) / sizeof(coords[0]);
+	for (int i = 0; i < count; i++) {
+		storage.insert(coords[i], TileMapCell(i, Vector2i(i, -i), 0));
+	}
+	CHECK(storage.size() == count);
+
+	for (int i = 0; i < count; i++) {
+		const TileMapCell *cell = storage.getptr(coords[i]);
+		REQUIRE(cell != nullptr);
+		CHECK(cell->source_id == i);
+		CHECK(cell->get_atlas_coords() == Vector2i(i, -i));
+	}
+	CHECK_MESSAGE(storage.getptr(Vector2i(1, 0)) == nullptr, "Neighbors of a used cell in the same chunk should be empty.");
+	CHECK_MESSAGE(storage.getptr(Vector2i(-32, 5)) == nullptr, "Neighbors of a used cell in the same chunk should be empty.");
+
+	// Overwriting a cell doesn't change the count.
+	storage.insert(Vector2i(32, 0), TileMapCell(7, Vector2i(1, 1), 2));
+	CHECK(storage.size() == count);
+	CHECK(storage.getptr(Vector2i(32, 0))->alternative_tile == 2);
+
+	LocalVector<Vector2i> used;
+	storage.get_used_coords(used);
+	REQUIRE(used.size() == (uint32_t)count);
+	for (uint32_t i = 1; i < used.size(); i++) {
+		CHECK_MESSAGE(used[i - 1] < used[i], "Used cells should be sorted.");
+	}
+
+	storage.erase(Vector2i(-1, -1));
+	storage.erase(Vector2i(-1, -1));
+	storage.erase(Vector2i(2, 2));
+	CHECK(storage.size() == count - 1);
+	CHECK(storage.getptr(Vector2i(-1, -1)) == nullptr);
+	CHECK(storage.getptr(Vector2i(0, 0)) != nullptr);
+
+	storage.clear();
+	CHECK(storage.size() == 0);
+	CHECK(storage.getptr(Vector2i(1000, -1000)) == nullptr);
+}
+
+TEST_CASE("[TileMap] Setting cells outside of the tree") {
+	TileMap *tile_map = memnew(TileMap);
+
+	tile_map->set_cell(Vector2i(-3, 4), 1, Vector2i(2, 3), 0);
+	tile_map->set_cell(Vector2i(40, -2), 2, Vector2i(0, 0), 1);
+	tile_map->set_cell(Vector2i(5, 5), 0, Vector2i(1, 1), 0);
+	CHECK(tile_map->get_cell_source_id(Vector2i(-3, 4)) == 1);
+	CHECK(tile_map->get_cell_atlas_coords(Vector2i(-3, 4)) == Vector2i(2, 3));
+	CHECK(tile_map->get_cell_alternative_tile(Vector2i(40, -2)) == 1);
+	CHECK(tile_map->get_cell_source_id(Vector2i(0, 0)) == -1);
+
+	tile_map->set_cell(Vector2i(5, 5));
+	CHECK(tile_map->get_cell_source_id(Vector2i(5, 5)) == -1);
+
+	TypedArray<Vector2i> used_cells = tile_map->get_used_cells();
+	REQUIRE(used_cells.size() == 2);
+	CHECK(Vector2i(used_cells[0]) == Vector2i(-3, 4));
+	CHECK(Vector2i(used_cells[1]) == Vector2i(40, -2));
+	CHECK(tile_map->get_used_rect() == Rect2(-3, -2, 44, 7));
+
+	memdelete(tile_map);
+}
+
+TEST_CASE("[TileMap] Used rect across chunks") {
+	TileMap *tile_map = memnew(TileMap);
+	CHECK(tile_map->get_used_rect() == Rect2());
+
+	tile_map->set_cell(Vector2i(5, 7), 0, Vector2i(), 0);
+	CHECK(tile_map->get_used_rect() == Rect2(5, 7, 1, 1));
+
+	// Cells in other chunks, on both sides of the origin.
+	tile_map->set_cell(Vector2i(-70, 31), 0, Vector2i(), 0);
+	tile_map->set_cell(Vector2i(100, -33), 0, Vector2i(), 0);
+	tile_map->set_cell(Vector2i(32, 64), 0, Vector2i(), 0);
+	CHECK(tile_map->get_used_rect() == Rect2(-70, -33, 171, 98));
+
+	// Removing the cells on the border shrinks the rect, empty chunks don't count.
+	tile_map->set_cell(Vector2i(-70, 31));
+	tile_map->set_cell(Vector2i(32, 64));
+	CHECK(tile_map->get_used_rect() == Rect2(5, -33, 96, 41));
+
+	tile_map->clear();
+	CHECK(tile_map->get_used_rect() == Rect2());
+
+	memdelete(tile_map);
+}
+
+// Creates a tileset made of a 4x4 atlas, that doesn't need the servers.
+static Ref<TileSet> _create_tile_set() {
+	Ref<TileSet> tile_set;
+	tile_set.instance();
+
+	Ref<AtlasTexture> texture;
+	texture.instance();
+	texture->set_region(Rect2(0, 0, 64, 64));
+
+	Ref<TileSetAtlasSource> atlas_source;
+	atlas_source.instance();
+	atlas_source->set_texture(texture);
+	atlas_source->set_texture_region_size(Vector2i(16, 16));
+	tile_set->add_source(atlas_source, 0);
+	for (int y = 0; y < 4; y++) {
+		for (int x = 0; x < 4; x++) {
+			atlas_source->create_tile(Vector2i(x, y));
+		}
+	}
+
+	// Tiles that split the canvas items of a quadrant, or change the drawing.
+	Object::cast_to<TileData>(atlas_source->get_tile_data(Vector2i(1, 0), 0))->set_z_index(1);
+	Object::cast_to<TileData>(atlas_source->get_tile_data(Vector2i(2, 0), 0))->set_modulate(Color(1, 0, 0));
+	Object::cast_to<TileData>(atlas_source->get_tile_data(Vector2i(3, 0), 0))->set_flip_h(true);
+
+	return tile_set;
+}
+
+// Groups cells into quadrants the way TileMap does it once inside the tree.
+static void _create_quadrants(TileMap *p_tile_map, const LocalVector<Vector2i> &p_coords, Map<Vector2i, TileMapQuadrant> &r_quadrants, LocalVector<TileMapQuadrant *> &r_quadrant_ptrs) {
+	int quadrant_size = p_tile_map->get_effective_quadrant_size();
+	for (uint32_t i = 0; i < p_coords.size(); i++) {
+		Vector2i pk = p_coords[i];
+		Vector2i qk = Vector2i(
+				pk.x > 0 ? pk.x / quadrant_size : (pk.x - (quadrant_size - 1)) / quadrant_size,
+				pk.y > 0 ? pk.y / quadrant_size : (pk.y - (quadrant_size - 1)) / quadrant_size);
+		Map<Vector2i, TileMapQuadrant>::Element *Q = r_quadrants.find(qk);
+		if (!Q) {
+			Q = r_quadrants.insert(qk, TileMapQuadrant());
+			Q->get().coords = qk;
+			r_quadrant_ptrs.push_back(&Q->get());
+		}
+		Q->get().cells.insert(pk);
+	}
+}
+
+TEST_CASE("[TileMap] Preparing quadrants on worker threads") {
+	TileMap *tile_map = memnew(TileMap);
+	tile_map->set_tileset(_create_tile_set());
+
+	// Enough cells to prepare the quadrants on the work pool.
+	const int size = 160;
+	for (int y = -size / 2; y < size / 2; y++) {
+		for (int x = -size / 2; x < size / 2; x++) {
+			tile_map->set_cell(Vector2i(x, y), 0, Vector2i((x * 7 + y) & 3, (x + y * 3) & 3), 0);
+		}
+	}
+	LocalVector<Vector2i> coords;
+	TypedArray<Vector2i> used_cells = tile_map->get_used_cells();
+	for (int i = 0; i < used_cells.size(); i++) {
+		coords.push_back(used_cells[i]);
+	}
+
+	Map<Vector2i, TileMapQuadrant> serial_quadrants;
+	LocalVector<TileMapQuadrant *> serial;
+	_create_quadrants(tile_map, coords, serial_quadrants, serial);
+	tile_map->prepare_quadrants(serial.ptr(), serial.size(), false);
+
+	Map<Vector2i, TileMapQuadrant> threaded_quadrants;
+	LocalVector<TileMapQuadrant *> threaded;
+	_create_quadrants(tile_map, coords, threaded_quadrants, threaded);
+	tile_map->prepare_quadrants(threaded.ptr(), threaded.size(), true);
+
+	REQUIRE(serial.size() == threaded.size());
+	uint32_t tile_count = 0;
+	for (uint32_t i = 0; i < serial.size(); i++) {
+		const TileMapQuadrant &a = *serial[i];
+		const TileMapQuadrant &b = *threaded[i];
+		REQUIRE(a.coords == b.coords);
+		CHECK(a.world_to_map.size() == a.cells.size());
+		CHECK(b.world_to_map.size() == b.cells.size());
+
+		REQUIRE(a.prepared_canvas_items.size() == b.prepared_canvas_items.size());
+		uint32_t canvas_item_tiles = 0;
+		for (uint32_t j = 0; j < a.prepared_canvas_items.size(); j++) {
+			CHECK(a.prepared_canvas_items[j].z_index == b.prepared_canvas_items[j].z_index);
+			CHECK(a.prepared_canvas_items[j].material == b.prepared_canvas_items[j].material);
+			CHECK(a.prepared_canvas_items[j].tile_count == b.prepared_canvas_items[j].tile_count);
+			canvas_item_tiles += a.prepared_canvas_items[j].tile_count;
+		}
+		CHECK(canvas_item_tiles == a.prepared_tiles.size());
+
+		REQUIRE(a.prepared_tiles.size() == b.prepared_tiles.size());
+		for (uint32_t j = 0; j < a.prepared_tiles.size(); j++) {
+			CHECK(a.prepared_tiles[j].texture == b.prepared_tiles[j].texture);
+			CHECK(a.prepared_tiles[j].dest_rect == b.prepared_tiles[j].dest_rect);
+			CHECK(a.prepared_tiles[j].source_rect == b.prepared_tiles[j].source_rect);
+			CHECK(a.prepared_tiles[j].modulate == b.prepared_tiles[j].modulate);
+			CHECK(a.prepared_tiles[j].transpose == b.prepared_tiles[j].transpose);
+		}
+		tile_count += a.prepared_tiles.size();
+	}
+	CHECK_MESSAGE(tile_count == coords.size(), "Every cell should be prepared for drawing.");
+
+	memdelete(tile_map);
+}
+
+TEST_CASE("[TileMap] Preparing the same quadrant twice is rejected") {
+	TileMap *tile_map = memnew(TileMap);
+	tile_map->set_tileset(_create_tile_set());
+
+	const int size = 160;
+	LocalVector<Vector2i> coords;
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			tile_map->set_cell(Vector2i(x, y), 0, Vector2i(x & 3, y & 3), 0);
+			coords.push_back(Vector2i(x, y));
+		}
+	}
+
+	Map<Vector2i, TileMapQuadrant> quadrants;
+	LocalVector<TileMapQuadrant *> quadrant_ptrs;
+	_create_quadrants(tile_map, coords, quadrants, quadrant_ptrs);
+	REQUIRE(quadrant_ptrs.size() > 2);
+	quadrant_ptrs.push_back(quadrant_ptrs[1]);
+
+	ERR_PRINT_OFF;
+	tile_map->prepare_quadrants(quadrant_ptrs.ptr(), quadrant_ptrs.size(), true);
+	ERR_PRINT_ON;
+
+	CHECK_MESSAGE(quadrant_ptrs[0]->prepared_tiles.is_empty(), "No quadrant should be prepared when one is listed twice.");
+	CHECK(quadrant_ptrs[1]->prepared_tiles.is_empty());
+
+	memdelete(tile_map);
+}
+
+// Measures cell edits on a large map, then preparing the rendering data of its quadrants on the calling thread and on the work pool.
+// The quadrants are built by hand, as the servers aren't available when running tests.
+void bench_tile_map() {
+	const int size = 1024;
+	const int frames = 100;
+	const int edits_per_frame = 4096;
+	const int quadrants_per_frame = 64;
+
+	TileMap *tile_map = memnew(TileMap);
+	tile_map->set_tileset(_create_tile_set());
+
+	uint64_t t = OS::get_singleton()->get_ticks_usec();
+	for (int y = 0; y < size; y++) {
+		for (int x = 0; x < size; x++) {
+			tile_map->set_cell(Vector2i(x, y), 0, Vector2i(x & 3, y & 3), 0);
+		}
+	}
+	t = OS::get_singleton()->get_ticks_usec() - t;
+	print_line(vformat("TileMap: bulk set_cell of %dx%d cells in %d usec.", size, size, t));
+
+	Ref<RandomNumberGenerator> rng;
+	rng.instance();
+	rng->set_seed(0);
+	t = OS::get_singleton()->get_ticks_usec();
+	for (int frame = 0; frame < frames; frame++) {
+		for (int i = 0; i < edits_per_frame; i++) {
+			Vector2i coords(rng->randi() % size, rng->randi() % size);
+			tile_map->set_cell(coords, 0, Vector2i(rng->randi() & 3, rng->randi() & 3), 0);
+		}
+	}
+	t = OS::get_singleton()->get_ticks_usec() - t;
+	print_line(vformat("TileMap: %d frames of %d random edits in %d usec (%d usec per frame).", frames, edits_per_frame, t, t / frames));
+
+	t = OS::get_singleton()->get_ticks_usec();
+	Rect2 used_rect = tile_map->get_used_rect();
+	t = OS::get_singleton()->get_ticks_usec() - t;
+	print_line(vformat("TileMap: get_used_rect %s in %d usec.", used_rect, t));
+
+	LocalVector<Vector2i> coords;
+	TypedArray<Vector2i> used_cells = tile_map->get_used_cells();
+	for (int i = 0; i < used_cells.size(); i++) {
+		coords.push_back(used_cells[i]);
+	}
+	Map<Vector2i, TileMapQuadrant> quadrants;
+	LocalVector<TileMapQuadrant *> quadrant_ptrs;
+	_create_quadrants(tile_map, coords, quadrants, quadrant_ptrs);
+
+	for (int threaded = 0; threaded < 2; threaded++) {
+		const char *mode = threaded ? "work pool" : "serial";
+
+		t = OS::get_singleton()->get_ticks_usec();
+		tile_map->prepare_quadrants(quadrant_ptrs.ptr(), quadrant_ptrs.size(), threaded);
+		t = OS::get_singleton()->get_ticks_usec() - t;
+		print_line(vformat("TileMap (%s): prepared all %d quadrants in %d usec.", mode, quadrant_ptrs.size(), t));
+
+		// Each frame, a few distinct random quadrants are dirty. They are shuffled to the front of the list.
+		LocalVector<TileMapQuadrant *> dirty = quadrant_ptrs;
+		rng->set_seed(0);
+		t = OS::get_singleton()->get_ticks_usec();
+		for (int frame = 0; frame < frames; frame++) {
+			for (uint32_t i = 0; i < (uint32_t)quadrants_per_frame; i++) {
+				uint32_t j = i + rng->randi() % (dirty.size() - i);
+				SWAP(dirty[i], dirty[j]);
+			}
+			tile_map->prepare_quadrants(dirty.ptr(), quadrants_per_frame, threaded);
+		}
+		t = OS::get_singleton()->get_ticks_usec() - t;
+		print_line(vformat("TileMap (%s): %d frames of %d dirty quadrants prepared in %d usec (%d usec per frame).", mode, frames, quadrants_per_frame, t, t / frames));
+	}
+
+	memdelete(tile_map);
+}
+REGISTER_TEST_COMMAND("tile-map-bench", &bench_tile_map);
+} // namespace TestTileMap
+#endif // TEST_TILE_MAP_H
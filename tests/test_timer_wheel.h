@@ -0,0 +1,306 @@
+/*************************************************************************/
+/*  test_timer_wheel.h                                                   */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_TIMER_WHEEL_H
+#define TEST_TIMER_WHEEL_H
+
+#include "core/math/random_pcg.h"
+#include "core/os/os.h"
+#include "scene/main/timer.h"
+#include "scene/main/timer_wheel.h"
+
+#include "tests/test_macros.h"
+#include "tests/test_scene_tree_environment.h"
+
+namespace TestTimerWheel {
+
+TEST_CASE("[TimerWheel] Expiration and order") {
+	TimerWheel wheel;
+	LocalVector<TimerWheel::Expired> expired;
+
+	wheel.schedule(0.5, 1);
+	wheel.schedule(0.25, 2);
+	wheel.schedule(0.25, 3);
+	uint32_t cancelled = wheel.schedule(0.1, 4);
+	CHECK(wheel.get_count() == 4);
+	CHECK(wheel.get_time_left(cancelled) == doctest::Approx(0.1));
+
+	wheel.cancel(cancelled);
+	CHECK(wheel.get_count() == 3);
+
+	wheel.advance(0.25, expired);
+	CHECK_MESSAGE(expired.size() == 0, "Timers expire once their time left is negative, not zero.");
+
+	wheel.advance(0.125, expired);
+	REQUIRE(expired.size() == 2);
+	CHECK(expired[0].userdata == 2);
+	CHECK(expired[1].userdata == 3);
+	CHECK(expired[0].time_left == doctest::Approx(-0.125));
+
+	wheel.advance(1.0, expired);
+	REQUIRE(expired.size() == 1);
+	CHECK(expired[0].userdata == 1);
+	CHECK(wheel.get_count() == 0);
+}
+
+TEST_CASE("[TimerWheel] Negative, zero and far away deadlines") {
+	TimerWheel wheel;
+	LocalVector<TimerWheel::Expired> expired;
+
+	wheel.schedule(-1.0, 1);
+	wheel.advance(0.0, expired);
+	REQUIRE(expired.size() == 1);
+	CHECK(expired[0].userdata == 1);
+
+	wheel.schedule(0.0, 2);
+	wheel.advance(0.0, expired);
+	CHECK(expired.size() == 0);
+	wheel.advance(0.001, expired);
+	REQUIRE(expired.size() == 1);
+	CHECK(expired[0].userdata == 2);
+
+	// A day is past the last level of the wheel.
+	uint32_t day = wheel.schedule(86400.0, 3);
+	wheel.advance(86399.0, expired);
+	CHECK(expired.size() == 0);
+	CHECK(wheel.get_time_left(day) == doctest::Approx(1.0));
+	wheel.advance(2.0, expired);
+	REQUIRE(expired.size() == 1);
+	CHECK(expired[0].userdata == 3);
+
+	// Deadlines too far away for a tick never expire.
+	uint32_t huge = wheel.schedule(1e30, 4);
+	uint32_t infinite = wheel.schedule(Math_INF, 5);
+	wheel.advance(3600.0, expired);
+	CHECK(expired.size() == 0);
+	CHECK(wheel.get_time_left(huge) == doctest::Approx(1e30));
+	CHECK(wheel.get_time_left(infinite) == Math_INF);
+	wheel.cancel(huge);
+	wheel.cancel(infinite);
+	CHECK(wheel.get_count() == 0);
+}
+
+class TimeoutCounter : public Object {
+public:
+	int count = 0;
+
+	void _on_timeout() {
+		count++;
+	}
+};
+
+TEST_CASE("[Timer] Paused trees and process modes stop Timer nodes") {
+	SceneTreeEnvironment environment;
+	SceneTree *tree = environment.tree;
+	Timer *timer = memnew(Timer);
+	TimeoutCounter counter;
+	timer->connect("timeout", callable_mp(&counter, &TimeoutCounter::_on_timeout));
+	tree->get_root()->add_child(timer);
+	timer->start(1.0);
+
+	tree->process(0.5);
+	CHECK(timer->get_time_left() == doctest::Approx(0.5));
+
+	tree->set_pause(true);
+	tree->process(1.0);
+	CHECK(counter.count == 0);
+	CHECK(timer->get_time_left() == doctest::Approx(0.5));
+
+	timer->set_process_mode(Node::PROCESS_MODE_ALWAYS);
+	tree->process(0.25);
+	CHECK_MESSAGE(timer->get_time_left() == doctest::Approx(0.25), "Timers processing always should run while paused.");
+	timer->set_process_mode(Node::PROCESS_MODE_INHERIT);
+	tree->process(1.0);
+	CHECK(counter.count == 0);
+
+	tree->set_pause(false);
+	tree->process(0.5);
+	CHECK(counter.count == 1);
+	CHECK_MESSAGE(timer->get_time_left() == doctest::Approx(0.75), "Repeating timers should keep the time they were late by.");
+
+	timer->set_process_mode(Node::PROCESS_MODE_DISABLED);
+	tree->process(1.0);
+	CHECK(counter.count == 1);
+	timer->set_process_mode(Node::PROCESS_MODE_INHERIT);
+
+	timer->set_paused(true);
+	tree->process(1.0);
+	CHECK(counter.count == 1);
+	CHECK(timer->get_time_left() == doctest::Approx(0.75));
+	timer->set_paused(false);
+
+	// Physics timers only run in physics frames.
+	timer->set_timer_process_callback(Timer::TIMER_PROCESS_PHYSICS);
+	tree->process(1.0);
+	CHECK(counter.count == 1);
+	tree->physics_process(1.0);
+	CHECK(counter.count == 2);
+
+	memdelete(timer);
+}
+
+TEST_CASE("[SceneTreeTimer] Pausable timers stop while the tree is paused") {
+	SceneTreeEnvironment environment;
+	SceneTree *tree = environment.tree;
+	TimeoutCounter always_counter;
+	TimeoutCounter pausable_counter;
+	Ref<SceneTreeTimer> always = tree->create_timer(1.0, true);
+	Ref<SceneTreeTimer> pausable = tree->create_timer(1.0, false);
+	always->connect("timeout", callable_mp(&always_counter, &TimeoutCounter::_on_timeout));
+	pausable->connect("timeout", callable_mp(&pausable_counter, &TimeoutCounter::_on_timeout));
+
+	tree->set_pause(true);
+	tree->process(1.5);
+	CHECK(always_counter.count == 1);
+	CHECK(pausable_counter.count == 0);
+	CHECK(pausable->get_time_left() == doctest::Approx(1.0));
+
+	tree->set_pause(false);
+	tree->process(0.5);
+	CHECK(pausable_counter.count == 0);
+	CHECK(pausable->get_time_left() == doctest::Approx(0.5));
+	tree->process(1.0);
+	CHECK(pausable_counter.count == 1);
+	CHECK(always_counter.count == 1);
+}
+
+TEST_CASE("[TimerWheel] Matches counting down every timer") {
+	// Times are multiples of 1/64 so both sides compute exactly.
+	struct Countdown {
+		uint64_t id;
+		double time_left;
+		uint32_t entry;
+	};
+
+	RandomPCG rng(4321);
+	TimerWheel wheel;
+	LocalVector<TimerWheel::Expired> expired;
+	LocalVector<Countdown> countdowns;
+	uint64_t next_id = 1;
+
+	for (int frame = 0; frame < 4000; frame++) {
+		int new_timers = rng.random(0, 8);
+		for (int i = 0; i < new_timers; i++) {
+			Countdown c;
+			c.id = next_id++;
+			c.time_left = rng.random(-4, 64 * 600) / 64.0;
+			c.entry = wheel.schedule(c.time_left, c.id);
+			countdowns.push_back(c);
+		}
+		if (countdowns.size() && rng.random(0, 3) == 0) {
+			uint32_t index = rng.random(0, int(countdowns.size()) - 1);
+			wheel.cancel(countdowns[index].entry);
+			countdowns.remove_unordered(index);
+		}
+
+		double delta = rng.random(0, 64 * 2) / 64.0;
+		wheel.advance(delta, expired);
+
+		LocalVector<uint64_t> fired;
+		for (uint32_t i = 0; i < countdowns.size();) {
+			countdowns[i].time_left -= delta;
+			if (countdowns[i].time_left < 0) {
+				fired.push_back(countdowns[i].id);
+				countdowns.remove_unordered(i);
+			} else {
+				i++;
+			}
+		}
+
+		REQUIRE(expired.size() == fired.size());
+		fired.sort();
+		LocalVector<uint64_t> wheel_fired;
+		for (uint32_t i = 0; i < expired.size(); i++) {
+			wheel_fired.push_back(expired[i].userdata);
+			if (i > 0) {
+				CHECK(expired[i - 1].time_left <= expired[i].time_left);
+			}
+		}
+		wheel_fired.sort();
+		for (uint32_t i = 0; i < fired.size(); i++) {
+			CHECK(wheel_fired[i] == fired[i]);
+		}
+	}
+	CHECK(wheel.get_count() == countdowns.size());
+}
+
+// Keeps 40000 cooldowns of up to a minute pending, restarting each one as
+// it expires, and compares a minute of 60 FPS frames against counting every
+// timer down each frame.
+static void bench_timer_wheel() {
+	const int timer_count = 40000;
+	const int frames = 3600;
+	const double delta = 1.0 / 60.0;
+
+	RandomPCG rng(0);
+	LocalVector<double> cooldowns;
+	for (int i = 0; i < timer_count; i++) {
+		cooldowns.push_back(rng.randf() * 60.0);
+	}
+
+	LocalVector<double> time_left = cooldowns;
+	uint64_t countdown_fired = 0;
+	uint64_t begin = OS::get_singleton()->get_ticks_usec();
+	for (int f = 0; f < frames; f++) {
+		for (int i = 0; i < timer_count; i++) {
+			time_left[i] -= delta;
+			if (time_left[i] < 0) {
+				time_left[i] += cooldowns[i];
+				countdown_fired++;
+			}
+		}
+	}
+	uint64_t countdown_usec = bench_usec(begin);
+
+	TimerWheel wheel;
+	LocalVector<TimerWheel::Expired> expired;
+	for (int i = 0; i < timer_count; i++) {
+		wheel.schedule(cooldowns[i], i);
+	}
+	uint64_t wheel_fired = 0;
+	begin = OS::get_singleton()->get_ticks_usec();
+	for (int f = 0; f < frames; f++) {
+		wheel.advance(delta, expired);
+		for (uint32_t i = 0; i < expired.size(); i++) {
+			wheel.schedule(expired[i].time_left + cooldowns[expired[i].userdata], expired[i].userdata);
+		}
+		wheel_fired += expired.size();
+	}
+	uint64_t wheel_usec = bench_usec(begin);
+
+	print_line(vformat("%d timers, %d frames: countdown %d expirations, wheel %d expirations.", timer_count, frames, (int64_t)countdown_fired, (int64_t)wheel_fired));
+	print_line(vformat("Per frame: countdown %d us, wheel %d us.", (int64_t)(countdown_usec / frames), (int64_t)(wheel_usec / frames)));
+}
+
+REGISTER_TEST_COMMAND("timer-wheel-bench", &bench_timer_wheel);
+
+} // namespace TestTimerWheel
+
+#endif // TEST_TIMER_WHEEL_H
@@ -0,0 +1,407 @@
+/*************************************************************************/
+/*  test_transform_hierarchy_3d.h                                        */
+/*************************************************************************/
+/*                       This file is part of:                           */
+/*                           GODOT ENGINE                                */
+/*                      https://godotengine.org                          */
+/*************************************************************************/
+/* Copyright (c) 2007-2021 Juan Linietsky, Ariel Manzur.                 */
+/* Copyright (c) 2014-2021 Godot Engine contributors (cf. AUTHORS.md).   */
+/*                                                                       */
+/* Permission is hereby granted, free of charge, to any person obtaining */
+/* a copy of this software and associated documentation files (the       */
+/* "Software"), to deal in the Software without restriction, including   */
+/* without limitation the rights to use, copy, modify, merge, publish,   */
+/* distribute, sublicense, and/or sell copies of the Software, and to    */
+/* permit persons to whom the Software is furnished to do so, subject to */
+/* the following conditions:                                             */
+/*                                                                       */
+/* The above copyright notice and this permission notice shall be        */
+/* included in all copies or substantial portions of the Software.       */
+/*                                                                       */
+/* THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND,       */
+/* EXPRESS OR IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF    */
+/* MERCHANTABILITY, FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT.*/
+/* IN NO EVENT SHALL THE AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY  */
+/* CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER IN AN ACTION OF CONTRACT,  */
+/* TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN CONNECTION WITH THE     */
+/* SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.                */
+/*************************************************************************/
+
+#ifndef TEST_TRANSFORM_HIERARCHY_3D_H
+#define TEST_TRANSFORM_HIERARCHY_3D_H
+
+#include "core/os/os.h"
+#include "scene/3d/node_3d.h"
+#include "scene/3d/transform_hierarchy_3d.h"
+
+#include "tests/test_macros.h"
+#include "tests/test_scene_tree_environment.h"
+
+// Declared in global namespace because of GDCLASS macro warning (Windows):
+// "Unqualified friend declaration referring to type outside of the nearest enclosing namespace
+// is a Microsoft extension; add a nested name specifier".
+class _TestTransformNotified3D : public Node3D {
+	GDCLASS(_TestTransformNotified3D, Node3D);
+
+protected:
+	void _notification(int p_what) {
+		if (p_what == NOTIFICATION_TRANSFORM_CHANGED) {
+			count++;
+			notified_origin = get_global_transform().origin;
+		}
+	}
+
+public:
+	int count = 0;
+	Vector3 notified_origin;
+
+	_TestTransformNotified3D() {
+		set_notify_transform(true);
+	}
+};
+
+namespace TestTransformHierarchy3D {
+
+TEST_CASE("[TransformHierarchy3D] Global transforms follow the parents") {
+	TransformHierarchy3D hierarchy;
+	Node3D *root = memnew(Node3D);
+	Node3D *child = memnew(Node3D);
+	Node3D *grandchild = memnew(Node3D);
+	root->set_translation(Vector3(1, 0, 0));
+	child->set_translation(Vector3(0, 2, 0));
+	grandchild->set_translation(Vector3(0, 0, 3));
+
+	uint32_t root_slot = hierarchy.insert(root, TransformHierarchy3D::INVALID_SLOT, root->get_transform(), 0);
+	uint32_t child_slot = hierarchy.insert(child, root_slot, child->get_transform(), 0);
+	uint32_t grandchild_slot = hierarchy.insert(grandchild, child_slot, grandchild->get_transform(), 0);
+
+	CHECK(hierarchy.get_global(grandchild_slot).origin.is_equal_approx(Vector3(1, 2, 3)));
+	CHECK(hierarchy.get_global(child_slot).origin.is_equal_approx(Vector3(1, 2, 0)));
+
+	// Changing the root is visible from the subtree before any update.
+	root->set_translation(Vector3(5, 0, 0));
+	hierarchy.invalidate(root_slot);
+	CHECK(hierarchy.has_flag(grandchild_slot, TransformHierarchy3D::FLAG_DIRTY));
+	CHECK(hierarchy.get_global(grandchild_slot).origin.is_equal_approx(Vector3(5, 2, 3)));
+
+	// Changing a child after its parent in the same frame, and the other way around.
+	child->set_translation(Vector3(0, 4, 0));
+	hierarchy.invalidate(child_slot);
+	root->set_rotation(Vector3(0, Math_PI, 0));
+	hierarchy.invalidate(root_slot);
+	hierarchy.update();
+	CHECK_FALSE(hierarchy.has_flag(grandchild_slot, TransformHierarchy3D::FLAG_DIRTY));
+	CHECK(hierarchy.get_changed_count() == 0);
+	CHECK(hierarchy.get_global(grandchild_slot).origin.is_equal_approx(Vector3(5, 4, -3)));
+
+	memdelete(grandchild);
+	memdelete(child);
+	memdelete(root);
+}
+
+TEST_CASE("[TransformHierarchy3D] Top level and disabled scale") {
+	TransformHierarchy3D hierarchy;
+	Node3D *root = memnew(Node3D);
+	Node3D *top_level = memnew(Node3D);
+	Node3D *unscaled = memnew(Node3D);
+	root->set_scale(Vector3(2, 2, 2));
+	top_level->set_translation(Vector3(1, 1, 1));
+	unscaled->set_translation(Vector3(1, 0, 0));
+
+	uint32_t root_slot = hierarchy.insert(root, TransformHierarchy3D::INVALID_SLOT, root->get_transform(), 0);
+	uint32_t top_level_slot = hierarchy.insert(top_level, root_slot, top_level->get_transform(), TransformHierarchy3D::FLAG_TOP_LEVEL);
+	uint32_t unscaled_slot = hierarchy.insert(unscaled, root_slot, unscaled->get_transform(), TransformHierarchy3D::FLAG_DISABLE_SCALE);
+	hierarchy.update();
+
+	CHECK(hierarchy.get_global(top_level_slot).origin.is_equal_approx(Vector3(1, 1, 1)));
+	CHECK(hierarchy.get_global(unscaled_slot).origin.is_equal_approx(Vector3(2, 0, 0)));
+	CHECK(hierarchy.get_global(unscaled_slot).basis.get_scale().is_equal_approx(Vector3(1, 1, 1)));
+
+	// Top level branches are not invalidated by their parent.
+	root->set_translation(Vector3(0, 10, 0));
+	hierarchy.invalidate(root_slot);
+	CHECK_FALSE(hierarchy.has_flag(top_level_slot, TransformHierarchy3D::FLAG_DIRTY));
+	CHECK(hierarchy.has_flag(unscaled_slot, TransformHierarchy3D::FLAG_DIRTY));
+	CHECK(hierarchy.get_global(unscaled_slot).origin.is_equal_approx(Vector3(2, 10, 0)));
+
+	memdelete(unscaled);
+	memdelete(top_level);
+	memdelete(root);
+}
+
+TEST_CASE("[TransformHierarchy3D] Removed slots are reused") {
+	TransformHierarchy3D hierarchy;
+	Node3D *root = memnew(Node3D);
+	Node3D *first = memnew(Node3D);
+	Node3D *second = memnew(Node3D);
+	root->set_translation(Vector3(1, 0, 0));
+	second->set_translation(Vector3(0, 1, 0));
+
+	uint32_t root_slot = hierarchy.insert(root, TransformHierarchy3D::INVALID_SLOT, root->get_transform(), 0);
+	uint32_t first_slot = hierarchy.insert(first, root_slot, first->get_transform(), 0);
+	hierarchy.remove(first_slot);
+	uint32_t second_slot = hierarchy.insert(second, root_slot, second->get_transform(), 0);
+	CHECK(second_slot == first_slot);
+	CHECK(hierarchy.get_owner(second_slot) == second);
+
+	// The reused slot was listed twice, it must only be updated once.
+	hierarchy.update();
+	CHECK(hierarchy.get_changed_count() == 0);
+	CHECK(hierarchy.get_global(second_slot).origin.is_equal_approx(Vector3(1, 1, 0)));
+
+	memdelete(second);
+	memdelete(first);
+	memdelete(root);
+}
+
+TEST_CASE("[TransformHierarchy3D] Slots read since they changed are listed again") {
+	TransformHierarchy3D hierarchy;
+	Node3D *root = memnew(Node3D);
+	Node3D *child = memnew(Node3D);
+	uint32_t root_slot = hierarchy.insert(root, TransformHierarchy3D::INVALID_SLOT, root->get_transform(), 0);
+	uint32_t child_slot = hierarchy.insert(child, root_slot, child->get_transform(), 0);
+	hierarchy.update();
+
+	hierarchy.invalidate(root_slot);
+	CHECK(hierarchy.get_changed_count() == 2);
+	hierarchy.invalidate(root_slot);
+	CHECK_MESSAGE(hierarchy.get_changed_count() == 2, "A dirty subtree should not be listed again.");
+
+	hierarchy.get_global(child_slot);
+	root->set_translation(Vector3(1, 0, 0));
+	hierarchy.invalidate(root_slot);
+	CHECK_MESSAGE(hierarchy.get_changed_count() == 4, "Slots read in between should be listed again.");
+	CHECK(hierarchy.get_changed(2) == root_slot);
+	CHECK(hierarchy.get_changed(3) == child_slot);
+
+	hierarchy.update();
+	CHECK(hierarchy.get_changed_count() == 0);
+	CHECK(hierarchy.get_global(child_slot).origin.is_equal_approx(Vector3(1, 0, 0)));
+
+	memdelete(child);
+	memdelete(root);
+}
+
+TEST_CASE("[Node3D] Transform notifications are coalesced until the flush") {
+	SceneTreeEnvironment environment;
+	Node3D *parent = memnew(Node3D);
+	_TestTransformNotified3D *child = memnew(_TestTransformNotified3D);
+	child->set_translation(Vector3(0, 1, 0));
+	parent->add_child(child);
+	environment.tree->get_root()->add_child(parent);
+	environment.tree->flush_transform_notifications();
+	CHECK(child->count == 1);
+	CHECK(child->notified_origin.is_equal_approx(Vector3(0, 1, 0)));
+
+	parent->set_translation(Vector3(1, 0, 0));
+	parent->set_translation(Vector3(2, 0, 0));
+	child->set_translation(Vector3(0, 2, 0));
+	parent->set_translation(Vector3(3, 0, 0));
+	environment.tree->flush_transform_notifications();
+	CHECK_MESSAGE(child->count == 2, "Moves in the same frame should notify once.");
+	CHECK(child->notified_origin.is_equal_approx(Vector3(3, 2, 0)));
+
+	// Notified and read in between, the child must be notified of the second move too.
+	parent->set_translation(Vector3(4, 0, 0));
+	child->force_update_transform();
+	CHECK(child->count == 3);
+	CHECK(child->notified_origin.is_equal_approx(Vector3(4, 2, 0)));
+	parent->set_translation(Vector3(5, 0, 0));
+	environment.tree->flush_transform_notifications();
+	CHECK_MESSAGE(child->count == 4, "Moving the parent again should queue another notification.");
+	CHECK(child->notified_origin.is_equal_approx(Vector3(5, 2, 0)));
+
+	memdelete(parent);
+}
+
+TEST_CASE("[Node3D] Top level nodes ignore the moves of their parent") {
+	SceneTreeEnvironment environment;
+	Node3D *parent = memnew(Node3D);
+	_TestTransformNotified3D *child = memnew(_TestTransformNotified3D);
+	parent->set_translation(Vector3(1, 0, 0));
+	child->set_translation(Vector3(0, 1, 0));
+	parent->add_child(child);
+	environment.tree->get_root()->add_child(parent);
+
+	child->set_as_top_level(true);
+	CHECK(child->get_global_transform().origin.is_equal_approx(Vector3(1, 1, 0)));
+	environment.tree->flush_transform_notifications();
+	child->count = 0;
+
+	parent->set_translation(Vector3(5, 0, 0));
+	environment.tree->flush_transform_notifications();
+	CHECK(child->count == 0);
+	CHECK(child->get_global_transform().origin.is_equal_approx(Vector3(1, 1, 0)));
+
+	child->set_as_top_level(false);
+	CHECK(child->get_global_transform().origin.is_equal_approx(Vector3(1, 1, 0)));
+	CHECK(child->get_transform().origin.is_equal_approx(Vector3(-4, 1, 0)));
+	parent->set_translation(Vector3(6, 0, 0));
+	environment.tree->flush_transform_notifications();
+	CHECK(child->count == 1);
+	CHECK(child->notified_origin.is_equal_approx(Vector3(2, 1, 0)));
+
+	memdelete(parent);
+}
+
+TEST_CASE("[Node3D] Reparented nodes follow their new parent") {
+	SceneTreeEnvironment environment;
+	Node3D *first = memnew(Node3D);
+	Node3D *second = memnew(Node3D);
+	_TestTransformNotified3D *child = memnew(_TestTransformNotified3D);
+	first->set_translation(Vector3(1, 0, 0));
+	second->set_translation(Vector3(0, 0, 1));
+	child->set_translation(Vector3(0, 1, 0));
+	first->add_child(child);
+	environment.tree->get_root()->add_child(first);
+	environment.tree->get_root()->add_child(second);
+	CHECK(child->get_global_transform().origin.is_equal_approx(Vector3(1, 1, 0)));
+
+	first->remove_child(child);
+	second->add_child(child);
+	CHECK(child->get_global_transform().origin.is_equal_approx(Vector3(0, 1, 1)));
+	environment.tree->flush_transform_notifications();
+	child->count = 0;
+
+	first->set_translation(Vector3(5, 0, 0));
+	environment.tree->flush_transform_notifications();
+	CHECK(child->count == 0);
+
+	second->set_translation(Vector3(0, 0, 2));
+	environment.tree->flush_transform_notifications();
+	CHECK(child->count == 1);
+	CHECK(child->notified_origin.is_equal_approx(Vector3(0, 1, 2)));
+
+	memdelete(second);
+	memdelete(first);
+}
+
+// Inserts a root with p_parts children, each carrying p_attachments children,
+// into every given hierarchy, sharing the same nodes.
+static void _build_vehicle(TransformHierarchy3D **p_hierarchies, int p_hierarchy_count, int p_parts, int p_attachments, LocalVector<Node3D *> &r_nodes, LocalVector<uint32_t> &r_slots) {
+	Node3D *root = memnew(Node3D);
+	root->set_translation(Vector3(1, 2, 3));
+	r_nodes.push_back(root);
+	uint32_t root_slot = TransformHierarchy3D::INVALID_SLOT;
+	for (int h = 0; h < p_hierarchy_count; h++) {
+		root_slot = p_hierarchies[h]->insert(root, TransformHierarchy3D::INVALID_SLOT, root->get_transform(), 0);
+	}
+	r_slots.push_back(root_slot);
+
+	for (int i = 0; i < p_parts; i++) {
+		Node3D *part = memnew(Node3D);
+		part->set_translation(Vector3(i % 7, i % 5, i % 3));
+		part->set_rotation(Vector3(0, i * 0.1, 0));
+		part->set_scale(Vector3(1, 1 + (i % 4) * 0.25, 1));
+		r_nodes.push_back(part);
+		uint32_t part_slot = TransformHierarchy3D::INVALID_SLOT;
+		for (int h = 0; h < p_hierarchy_count; h++) {
+			part_slot = p_hierarchies[h]->insert(part, root_slot, part->get_transform(), 0);
+		}
+		r_slots.push_back(part_slot);
+
+		for (int j = 0; j < p_attachments; j++) {
+			Node3D *attachment = memnew(Node3D);
+			attachment->set_translation(Vector3(0, j, 1));
+			attachment->set_rotation(Vector3(j * 0.2, 0, 0));
+			r_nodes.push_back(attachment);
+			uint32_t flags = (j % 3 == 0) ? TransformHierarchy3D::FLAG_DISABLE_SCALE : 0;
+			uint32_t attachment_slot = TransformHierarchy3D::INVALID_SLOT;
+			for (int h = 0; h < p_hierarchy_count; h++) {
+				attachment_slot = p_hierarchies[h]->insert(attachment, part_slot, attachment->get_transform(), flags);
+			}
+			r_slots.push_back(attachment_slot);
+		}
+	}
+}
+
+TEST_CASE("[TransformHierarchy3D] Threaded updates match serial updates") {
+	TransformHierarchy3D serial;
+	TransformHierarchy3D threaded;
+	threaded.set_use_threads(true);
+	TransformHierarchy3D *hierarchies[2] = { &serial, &threaded };
+
+	// Both levels below the root are large enough to be split across threads.
+	LocalVector<Node3D *> nodes;
+	LocalVector<uint32_t> slots;
+	_build_vehicle(hierarchies, 2, 1500, 1, nodes, slots);
+
+	bool all_equal = true;
+	serial.update();
+	threaded.update();
+	for (uint32_t i = 0; i < slots.size(); i++) {
+		CHECK_FALSE(threaded.has_flag(slots[i], TransformHierarchy3D::FLAG_DIRTY));
+		all_equal = all_equal && serial.get_global(slots[i]) == threaded.get_global(slots[i]);
+	}
+	CHECK_MESSAGE(all_equal, "Global transforms after the first update should be the same.");
+
+	// Move the root and some parts, as a frame would.
+	nodes[0]->set_rotation(Vector3(0, 1, 0));
+	for (int h = 0; h < 2; h++) {
+		hierarchies[h]->invalidate(slots[0]);
+	}
+	for (uint32_t i = 1; i < slots.size(); i += 10) {
+		nodes[i]->set_translation(nodes[i]->get_translation() + Vector3(0, 1, 0));
+		for (int h = 0; h < 2; h++) {
+			hierarchies[h]->invalidate(slots[i]);
+		}
+	}
+
+	all_equal = true;
+	serial.update();
+	threaded.update();
+	for (uint32_t i = 0; i < slots.size(); i++) {
+		CHECK_FALSE(threaded.has_flag(slots[i], TransformHierarchy3D::FLAG_DIRTY));
+		all_equal = all_equal && serial.get_global(slots[i]) == threaded.get_global(slots[i]);
+	}
+	CHECK_MESSAGE(all_equal, "Global transforms after moving the root should be the same.");
+	const uint32_t last_part = slots.size() - 2;
+	CHECK(threaded.get_global(slots[last_part]).is_equal_approx(nodes[0]->get_transform() * nodes[last_part]->get_transform()));
+
+	for (uint32_t i = 0; i < nodes.size(); i++) {
+		memdelete(nodes[i]);
+	}
+}
+
+// Moves the root of a 2000 node "vehicle" every frame, and updates the
+// global transforms of the hierarchy, serially and with threads.
+static void bench_transform_hierarchy_3d() {
+	const int frames = 1000;
+	const struct {
+		const char *name;
+		int parts;
+		int attachments;
+	} shapes[2] = { { "flat", 2000, 0 }, { "nested", 100, 19 } };
+
+	for (int s = 0; s < 2; s++) {
+		uint64_t usec[2];
+		for (int t = 0; t < 2; t++) {
+			TransformHierarchy3D hierarchy;
+			hierarchy.set_use_threads(t == 1);
+			TransformHierarchy3D *hierarchies[1] = { &hierarchy };
+			LocalVector<Node3D *> nodes;
+			LocalVector<uint32_t> slots;
+			_build_vehicle(hierarchies, 1, shapes[s].parts, shapes[s].attachments, nodes, slots);
+			hierarchy.update();
+
+			uint64_t begin = OS::get_singleton()->get_ticks_usec();
+			for (int f = 0; f < frames; f++) {
+				nodes[0]->set_translation(Vector3(f * 0.01, 0, 0));
+				hierarchy.invalidate(slots[0]);
+				hierarchy.update();
+			}
+			usec[t] = bench_usec(begin);
+
+			for (uint32_t i = 0; i < nodes.size(); i++) {
+				memdelete(nodes[i]);
+			}
+		}
+		print_line(vformat("%s, %d nodes: %d usec per frame serial, %d usec per frame threaded.", shapes[s].name, 1 + shapes[s].parts * (1 + shapes[s].attachments), (int64_t)(usec[0] / frames), (int64_t)(usec[1] / frames)));
+	}
+}
+
+REGISTER_TEST_COMMAND("transform-hierarchy-3d-bench", &bench_transform_hierarchy_3d);
+} // namespace TestTransformHierarchy3D
+
+#endif // TEST_TRANSFORM_HIERARCHY_3D_H